@@ -0,0 +1,859 @@
+/*++
+
+Copyright (c) 1997-1998 Microsoft Corporation
+
+Module Name:
+
+    BANDWIDTH.C
+
+Abstract:
+
+    This source file contains the periodic bandwidth calculator, see
+    USB_BANDWIDTH in USBVIEW.H.  It runs over a snapshot once enumeration
+    is done.  Every interrupt and isochronous endpoint of the alternate
+    settings in use is reserved in a schedule of 32 frames of 8
+    microframes each, the longest period host controllers schedule.  An
+    endpoint goes in the slots of its period which are least busy so far,
+    as a host controller would place it, and the busiest frame and
+    microframe are what is reported.
+
+    Full and low speed endpoints behind a high speed hub use the frames of
+    the transaction translator of that hub, and split transactions in the
+    microframes of the high speed bus.  Elsewhere they use the frames of
+    the full speed bus of the host controller.
+
+    The open pipes of each host controller are also put in an occupancy
+    map, see USB_SCHEDULE_MAP, in the slots the USB stack reports it gave
+    them.  Those say which frames and microframes are shared by several
+    pipes or close to full, whatever the calculation above would make of
+    them.  Full and low speed pipes behind a high speed hub are in the map
+    by their split transactions, in microframes, since the frames of the
+    map are those of the full speed bus of the host controller.
+
+    Bus times are those of USB 2.0 section 5.11.3, without the host and
+    hub delays, which depend on the implementation.
+
+Environment:
+
+    user mode
+
+Revision History:
+
+    10-16-26 : created
+
+--*/
+
+//*****************************************************************************
+// I N C L U D E S
+//*****************************************************************************
+
+#include <windows.h>
+#include <basetyps.h>
+#include <winioctl.h>
+#include <string.h>
+#include <tchar.h>
+#include "usbview.h"
+
+//*****************************************************************************
+// D E F I N E S
+//*****************************************************************************
+
+// Bit times of a data packet of Bytes bytes with worst case bit stuffing,
+// Floor(3.167 + BitStuffTime(Bytes))
+//
+#define DATA_BIT_TIMES(Bytes)   ((19002 + (Bytes) * 56000) / 6000)
+
+//*****************************************************************************
+// T Y P E D E F S
+//*****************************************************************************
+
+// What is reserved below a host controller or hub.  The scopes of the hubs
+// a device is behind are chained up to the one of its host controller.
+//
+typedef struct _BANDWIDTH_SCOPE
+{
+    struct _BANDWIDTH_SCOPE    *Up;     // NULL for the host controller
+
+    PUSB_SCHEDULE_MAP           ScheduleMap;    // of the host controller only
+
+    ULONG                       Frames[SCHEDULE_FRAMES];            // ns
+    ULONG                       Microframes[SCHEDULE_MICROFRAMES];  // ns
+    ULONG                       PeriodicEndpoints;
+
+} BANDWIDTH_SCOPE, *PBANDWIDTH_SCOPE;
+
+//*****************************************************************************
+// L O C A L    F U N C T I O N    P R O T O T Y P E S
+//*****************************************************************************
+
+VOID
+ScheduleHubPorts (
+    PUSBTREENODE        HubNode,
+    PBANDWIDTH_SCOPE    Scope,
+    PBANDWIDTH_SCOPE    FrameOwner,
+    BOOL                Translated,
+    ULONG               Threshold
+);
+
+VOID
+ScheduleDevice (
+    PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfo,
+    __in_opt PUSB_DESCRIPTOR_REQUEST    ConfigDesc,
+    PBANDWIDTH_SCOPE                    Scope,
+    PBANDWIDTH_SCOPE                    FrameOwner,
+    BOOL                                Translated
+);
+
+VOID
+ScheduleEndpoint (
+    PUSB_ENDPOINT_DESCRIPTOR    EndpointDesc,
+    UCHAR                       Speed,
+    PBANDWIDTH_SCOPE            Scope,
+    PBANDWIDTH_SCOPE            FrameOwner,
+    BOOL                        Translated
+);
+
+VOID
+MapPipe (
+    PUSB_SCHEDULE_MAP   ScheduleMap,
+    PUSB_PIPE_INFO      PipeInfo,
+    UCHAR               Speed,
+    BOOL                Translated
+);
+
+VOID
+PlaceEndpoint (
+    PULONG              Slots,
+    ULONG               NumSlots,
+    SIZE_T              SlotsOffset,
+    PBANDWIDTH_SCOPE    Scope,
+    PBANDWIDTH_SCOPE    Owner,
+    ULONG               Period,
+    ULONG               Cost
+);
+
+ULONG
+EndpointPeriod (
+    PUSB_ENDPOINT_DESCRIPTOR    EndpointDesc,
+    UCHAR                       Speed
+);
+
+ULONG
+EndpointTime (
+    PUSB_ENDPOINT_DESCRIPTOR    EndpointDesc,
+    UCHAR                       Speed
+);
+
+ULONG
+HighSpeedTime (
+    UCHAR   Type,
+    ULONG   Bytes
+);
+
+ULONG
+FullSpeedTime (
+    UCHAR   Type,
+    BOOL    In,
+    BOOL    LowSpeed,
+    ULONG   Bytes
+);
+
+VOID
+SummarizeScope (
+    PBANDWIDTH_SCOPE    Scope,
+    ULONG               Threshold,
+    PUSB_BANDWIDTH      Bandwidth
+);
+
+VOID
+SummarizeScheduleMap (
+    PUSB_SCHEDULE_MAP   ScheduleMap,
+    ULONG               Threshold
+);
+
+
+//*****************************************************************************
+//
+// ComputeBandwidth()
+//
+// Snapshot - A complete tree.  The Bandwidth of the info of each host
+// controller, root hub and external hub is filled in, as well as the
+// ScheduleMap of each host controller, and Snapshot->BandwidthWarnings
+// counts the host controllers over Threshold.
+//
+// Threshold - Percent of the periodic time of a frame or microframe, 90%
+// and 80% of it, which may be used before a warning.  Slots of the
+// schedule map over it are hot.
+//
+//*****************************************************************************
+
+VOID
+ComputeBandwidth (
+    PUSB_SNAPSHOT   Snapshot,
+    ULONG           Threshold
+)
+{
+    PUSBTREENODE            hcNode;
+    PUSBTREENODE            hubNode;
+    PUSBHOSTCONTROLLERINFO  hcInfo;
+    PUSBROOTHUBINFO         hubInfo;
+    BANDWIDTH_SCOPE         scope;
+    USB_BANDWIDTH           bandwidth;
+
+    Snapshot->BandwidthWarnings = 0;
+
+    for (hcNode = Snapshot->Root.FirstChild;
+         hcNode != NULL;
+         hcNode = hcNode->NextSibling)
+    {
+        memset(&scope, 0, sizeof(scope));
+
+        hcInfo = (PUSBHOSTCONTROLLERINFO)hcNode->Info;
+
+        if (hcInfo != NULL && hcInfo->DeviceInfoType == HostControllerInfo)
+        {
+            memset(&hcInfo->ScheduleMap, 0, sizeof(USB_SCHEDULE_MAP));
+
+            scope.ScheduleMap = &hcInfo->ScheduleMap;
+        }
+        else
+        {
+            hcInfo = NULL;
+        }
+
+        // The root hub is the only child of a host controller, the bus of
+        // both is the same
+        //
+        for (hubNode = hcNode->FirstChild;
+             hubNode != NULL;
+             hubNode = hubNode->NextSibling)
+        {
+            ScheduleHubPorts(hubNode, &scope, &scope, FALSE, Threshold);
+        }
+
+        SummarizeScope(&scope, Threshold, &bandwidth);
+
+        if (bandwidth.OverThreshold)
+        {
+            Snapshot->BandwidthWarnings++;
+        }
+
+        if (hcInfo != NULL)
+        {
+            hcInfo->Bandwidth = bandwidth;
+
+            SummarizeScheduleMap(&hcInfo->ScheduleMap, Threshold);
+        }
+
+        for (hubNode = hcNode->FirstChild;
+             hubNode != NULL;
+             hubNode = hubNode->NextSibling)
+        {
+            hubInfo = (PUSBROOTHUBINFO)hubNode->Info;
+
+            if (hubInfo != NULL && hubInfo->DeviceInfoType == RootHubInfo)
+            {
+                hubInfo->Bandwidth = bandwidth;
+            }
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// ScheduleHubPorts()
+//
+// HubNode - A hub, whose ports are reserved in Scope.
+//
+// FrameOwner - The scope whose frames the full and low speed devices below
+// use, that of the nearest high speed hub or of the host controller.
+//
+// Translated - There is a high speed hub above, so full and low speed
+// devices need split transactions.
+//
+//*****************************************************************************
+
+VOID
+ScheduleHubPorts (
+    PUSBTREENODE        HubNode,
+    PBANDWIDTH_SCOPE    Scope,
+    PBANDWIDTH_SCOPE    FrameOwner,
+    BOOL                Translated,
+    ULONG               Threshold
+)
+{
+    PUSBTREENODE        node;
+    PUSBDEVICEINFO      deviceInfo;
+    PUSBEXTERNALHUBINFO hubInfo;
+    BANDWIDTH_SCOPE     hubScope;
+    BOOL                highSpeed;
+
+    for (node = HubNode->FirstChild; node != NULL; node = node->NextSibling)
+    {
+        if (node->Info == NULL)
+        {
+            continue;
+        }
+
+        switch (*(PUSBDEVICEINFOTYPE)node->Info)
+        {
+            case DeviceInfo:
+                deviceInfo = (PUSBDEVICEINFO)node->Info;
+
+                ScheduleDevice(deviceInfo->ConnectionInfo,
+                               deviceInfo->ConfigDesc,
+                               Scope,
+                               FrameOwner,
+                               Translated);
+                break;
+
+            case ExternalHubInfo:
+                hubInfo = (PUSBEXTERNALHUBINFO)node->Info;
+
+                // The status change endpoint of the hub is on this bus
+                //
+                ScheduleDevice(hubInfo->ConnectionInfo,
+                               hubInfo->ConfigDesc,
+                               Scope,
+                               FrameOwner,
+                               Translated);
+
+                memset(&hubScope, 0, sizeof(hubScope));
+
+                hubScope.Up = Scope;
+
+                highSpeed = hubInfo->ConnectionInfo != NULL &&
+                            hubInfo->ConnectionInfo->Speed == UsbHighSpeed;
+
+                ScheduleHubPorts(node,
+                                 &hubScope,
+                                 highSpeed ? &hubScope : FrameOwner,
+                                 highSpeed || Translated,
+                                 Threshold);
+
+                SummarizeScope(&hubScope, Threshold, &hubInfo->Bandwidth);
+                break;
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// ScheduleDevice()
+//
+// The open pipes of a device are the endpoints of the alternate settings
+// it uses.  Without them, as for captured descriptors, those of alternate
+// setting 0 of each interface are taken, which is what a device starts
+// with once configured.
+//
+//*****************************************************************************
+
+VOID
+ScheduleDevice (
+    PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfo,
+    __in_opt PUSB_DESCRIPTOR_REQUEST    ConfigDesc,
+    PBANDWIDTH_SCOPE                    Scope,
+    PBANDWIDTH_SCOPE                    FrameOwner,
+    BOOL                                Translated
+)
+{
+    PBANDWIDTH_SCOPE            root;
+    PCONFIG_DESC_INDEX          index;
+    PCONFIG_DESC_ENTRY          entry;
+    PUSB_INTERFACE_DESCRIPTOR   interfaceDesc;
+    ULONG                       i;
+
+    if (ConnectionInfo == NULL ||
+        ConnectionInfo->ConnectionStatus != DeviceConnected)
+    {
+        return;
+    }
+
+    if (ConnectionInfo->NumberOfOpenPipes != 0)
+    {
+        for (root = Scope; root->Up != NULL; root = root->Up)
+        {
+        }
+
+        for (i = 0; i < ConnectionInfo->NumberOfOpenPipes; i++)
+        {
+            ScheduleEndpoint(&ConnectionInfo->PipeList[i].EndpointDescriptor,
+                             ConnectionInfo->Speed,
+                             Scope,
+                             FrameOwner,
+                             Translated);
+
+            if (root->ScheduleMap != NULL)
+            {
+                MapPipe(root->ScheduleMap,
+                        &ConnectionInfo->PipeList[i],
+                        ConnectionInfo->Speed,
+                        Translated);
+            }
+        }
+
+        return;
+    }
+
+    if (ConfigDesc == NULL || ConnectionInfo->CurrentConfigurationValue == 0)
+    {
+        return;
+    }
+
+    index = GetConfigDescIndex(ConfigDesc);
+
+    for (entry = index->Entries;
+         entry < index->Entries + index->NumEntries;
+         entry++)
+    {
+        if (entry->Kind != ConfigDescEndpoint ||
+            entry->InterfaceEntry == NO_CONFIG_ENTRY)
+        {
+            continue;
+        }
+
+        interfaceDesc = (PUSB_INTERFACE_DESCRIPTOR)
+            CONFIG_ENTRY_DESC(ConfigDesc, &index->Entries[entry->InterfaceEntry]);
+
+        if (interfaceDesc->bAlternateSetting == 0)
+        {
+            ScheduleEndpoint((PUSB_ENDPOINT_DESCRIPTOR)CONFIG_ENTRY_DESC(ConfigDesc, entry),
+                             ConnectionInfo->Speed,
+                             Scope,
+                             FrameOwner,
+                             Translated);
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// ScheduleEndpoint()
+//
+// Reserves an interrupt or isochronous endpoint of a device running at
+// Speed, anything else takes no periodic time.
+//
+//*****************************************************************************
+
+VOID
+ScheduleEndpoint (
+    PUSB_ENDPOINT_DESCRIPTOR    EndpointDesc,
+    UCHAR                       Speed,
+    PBANDWIDTH_SCOPE            Scope,
+    PBANDWIDTH_SCOPE            FrameOwner,
+    BOOL                        Translated
+)
+{
+    PBANDWIDTH_SCOPE    scope;
+    PBANDWIDTH_SCOPE    root;
+    UCHAR               type;
+    ULONG               period;
+
+    type = EndpointDesc->bmAttributes & USB_ENDPOINT_TYPE_MASK;
+
+    if (type != USB_ENDPOINT_TYPE_ISOCHRONOUS &&
+        type != USB_ENDPOINT_TYPE_INTERRUPT)
+    {
+        return;
+    }
+
+    for (root = Scope; root->Up != NULL; root = root->Up)
+    {
+    }
+
+    period = EndpointPeriod(EndpointDesc, Speed);
+
+    if (Speed == UsbHighSpeed)
+    {
+        PlaceEndpoint(root->Microframes,
+                      SCHEDULE_MICROFRAMES,
+                      FIELD_OFFSET(BANDWIDTH_SCOPE, Microframes),
+                      Scope,
+                      root,
+                      period,
+                      EndpointTime(EndpointDesc, Speed));
+    }
+    else
+    {
+        PlaceEndpoint(FrameOwner->Frames,
+                      SCHEDULE_FRAMES,
+                      FIELD_OFFSET(BANDWIDTH_SCOPE, Frames),
+                      Scope,
+                      FrameOwner,
+                      period,
+                      EndpointTime(EndpointDesc, Speed));
+
+        // The split transactions of the translator carry the same data on
+        // the high speed bus, in one microframe of each of those frames
+        //
+        if (Translated)
+        {
+            PlaceEndpoint(root->Microframes,
+                          SCHEDULE_MICROFRAMES,
+                          FIELD_OFFSET(BANDWIDTH_SCOPE, Microframes),
+                          Scope,
+                          root,
+                          period * 8,
+                          HighSpeedTime(type, EndpointDesc->wMaxPacketSize & 0x07FF));
+        }
+    }
+
+    for (scope = Scope; scope != NULL; scope = scope->Up)
+    {
+        scope->PeriodicEndpoints++;
+    }
+}
+
+//*****************************************************************************
+//
+// MapPipe()
+//
+// Adds an open pipe to the occupancy map of its host controller, in the
+// slots the USB stack gave it.  ScheduleOffset is taken in the unit of the
+// period of the pipe, microframes at high speed and frames otherwise.
+//
+// Translated - The pipe is full or low speed behind a high speed hub.  Its
+// full speed bus is that of the transaction translator, and what it takes
+// of the host controller are its split transactions, as ScheduleEndpoint()
+// reserves them.  The stack does not say which microframe of its frames
+// those start in, so they are put in the first one.
+//
+//*****************************************************************************
+
+VOID
+MapPipe (
+    PUSB_SCHEDULE_MAP   ScheduleMap,
+    PUSB_PIPE_INFO      PipeInfo,
+    UCHAR               Speed,
+    BOOL                Translated
+)
+{
+    PUSB_SCHEDULE_SLOT  slots;
+    ULONG               numSlots;
+    ULONG               period;
+    ULONG               cost;
+    ULONG               first;
+    ULONG               slot;
+    UCHAR               type;
+
+    type = PipeInfo->EndpointDescriptor.bmAttributes & USB_ENDPOINT_TYPE_MASK;
+
+    if (type != USB_ENDPOINT_TYPE_ISOCHRONOUS &&
+        type != USB_ENDPOINT_TYPE_INTERRUPT)
+    {
+        return;
+    }
+
+    period = EndpointPeriod(&PipeInfo->EndpointDescriptor, Speed);
+    first = PipeInfo->ScheduleOffset % period;
+
+    if (Speed == UsbHighSpeed)
+    {
+        slots = ScheduleMap->Microframes;
+        numSlots = SCHEDULE_MICROFRAMES;
+        cost = EndpointTime(&PipeInfo->EndpointDescriptor, Speed);
+    }
+    else if (Translated)
+    {
+        slots = ScheduleMap->Microframes;
+        numSlots = SCHEDULE_MICROFRAMES;
+        first *= 8;
+        period *= 8;
+        cost = HighSpeedTime(type, PipeInfo->EndpointDescriptor.wMaxPacketSize & 0x07FF);
+    }
+    else
+    {
+        slots = ScheduleMap->Frames;
+        numSlots = SCHEDULE_FRAMES;
+        cost = EndpointTime(&PipeInfo->EndpointDescriptor, Speed);
+    }
+
+    for (slot = first; slot < numSlots; slot += period)
+    {
+        slots[slot].Pipes++;
+        slots[slot].Ns += cost;
+    }
+
+    ScheduleMap->PeriodicPipes++;
+}
+
+//*****************************************************************************
+//
+// PlaceEndpoint()
+//
+// Slots - The schedule of Owner the endpoint is placed in, NumSlots long.
+//
+// SlotsOffset - Where that schedule is in a BANDWIDTH_SCOPE, the same slots
+// are reserved in each scope from Scope up to Owner.
+//
+// Period - In slots, a power of 2 no larger than NumSlots.
+//
+// Cost - ns reserved in each slot used.
+//
+//*****************************************************************************
+
+VOID
+PlaceEndpoint (
+    PULONG              Slots,
+    ULONG               NumSlots,
+    SIZE_T              SlotsOffset,
+    PBANDWIDTH_SCOPE    Scope,
+    PBANDWIDTH_SCOPE    Owner,
+    ULONG               Period,
+    ULONG               Cost
+)
+{
+    PBANDWIDTH_SCOPE    scope;
+    PULONG              slots;
+    ULONG               offset;
+    ULONG               bestOffset;
+    ULONG               bestLoad;
+    ULONG               load;
+    ULONG               slot;
+
+    // The offset whose busiest slot is the least busy
+    //
+    bestOffset = 0;
+    bestLoad = MAXULONG;
+
+    for (offset = 0; offset < Period && bestLoad != 0; offset++)
+    {
+        load = 0;
+
+        for (slot = offset; slot < NumSlots; slot += Period)
+        {
+            load = max(load, Slots[slot]);
+        }
+
+        if (load < bestLoad)
+        {
+            bestLoad = load;
+            bestOffset = offset;
+        }
+    }
+
+    for (scope = Scope; scope != NULL; scope = scope->Up)
+    {
+        slots = (PULONG)((PUCHAR)scope + SlotsOffset);
+
+        for (slot = bestOffset; slot < NumSlots; slot += Period)
+        {
+            slots[slot] += Cost;
+        }
+
+        if (scope == Owner)
+        {
+            break;
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// EndpointPeriod()
+//
+// Returns how far apart the transactions of a periodic endpoint of a
+// device running at Speed are, in microframes at high speed and frames
+// otherwise, no further than the schedule is long.
+//
+//*****************************************************************************
+
+ULONG
+EndpointPeriod (
+    PUSB_ENDPOINT_DESCRIPTOR    EndpointDesc,
+    UCHAR                       Speed
+)
+{
+    ULONG   interval;
+    ULONG   period;
+
+    interval = max(EndpointDesc->bInterval, 1);
+
+    // High speed endpoints and full speed isochronous ones are
+    // 2^(bInterval-1) microframes or frames apart.  Full and low speed
+    // interrupt endpoints are bInterval frames apart at most, taken down
+    // to a power of 2 as host controllers do.
+    //
+    if (Speed == UsbHighSpeed)
+    {
+        return 1 << min(interval - 1, 8);
+    }
+
+    if ((EndpointDesc->bmAttributes & USB_ENDPOINT_TYPE_MASK) ==
+        USB_ENDPOINT_TYPE_ISOCHRONOUS)
+    {
+        return 1 << min(interval - 1, 5);
+    }
+
+    for (period = 1; period * 2 <= interval && period < SCHEDULE_FRAMES; period *= 2)
+    {
+    }
+
+    return period;
+}
+
+//*****************************************************************************
+//
+// EndpointTime()
+//
+// Returns the bus time in ns a periodic endpoint of a device running at
+// Speed takes in each microframe or frame it is scheduled in.  Up to 3
+// transactions a microframe may be made at high speed.
+//
+//*****************************************************************************
+
+ULONG
+EndpointTime (
+    PUSB_ENDPOINT_DESCRIPTOR    EndpointDesc,
+    UCHAR                       Speed
+)
+{
+    UCHAR   type;
+    ULONG   bytes;
+
+    type = EndpointDesc->bmAttributes & USB_ENDPOINT_TYPE_MASK;
+    bytes = EndpointDesc->wMaxPacketSize & 0x07FF;
+
+    if (Speed == UsbHighSpeed)
+    {
+        return HighSpeedTime(type, bytes) *
+               (((EndpointDesc->wMaxPacketSize >> 11) & 0x03) + 1);
+    }
+
+    return FullSpeedTime(type,
+                         (EndpointDesc->bEndpointAddress &
+                          USB_ENDPOINT_DIRECTION_MASK) != 0,
+                         Speed == UsbLowSpeed,
+                         bytes);
+}
+
+//*****************************************************************************
+//
+// HighSpeedTime()
+// FullSpeedTime()
+//
+// Return the bus time in ns of one transaction of Bytes bytes.
+//
+//*****************************************************************************
+
+ULONG
+HighSpeedTime (
+    UCHAR   Type,
+    ULONG   Bytes
+)
+{
+    // (38 * 8 * 2.083) or (55 * 8 * 2.083) + 2.083 * bit times
+    //
+    return (Type == USB_ENDPOINT_TYPE_ISOCHRONOUS ? 633 : 917) +
+           DATA_BIT_TIMES(Bytes) * 2083 / 1000;
+}
+
+ULONG
+FullSpeedTime (
+    UCHAR   Type,
+    BOOL    In,
+    BOOL    LowSpeed,
+    ULONG   Bytes
+)
+{
+    if (LowSpeed)
+    {
+        return In ? 64060 + DATA_BIT_TIMES(Bytes) * 67667 / 100 :
+                    64107 + DATA_BIT_TIMES(Bytes) * 667;
+    }
+
+    if (Type == USB_ENDPOINT_TYPE_ISOCHRONOUS)
+    {
+        return (In ? 7268 : 6265) + DATA_BIT_TIMES(Bytes) * 8354 / 100;
+    }
+
+    return 9107 + DATA_BIT_TIMES(Bytes) * 8354 / 100;
+}
+
+//*****************************************************************************
+//
+// SummarizeScope()
+//
+//*****************************************************************************
+
+VOID
+SummarizeScope (
+    PBANDWIDTH_SCOPE    Scope,
+    ULONG               Threshold,
+    PUSB_BANDWIDTH      Bandwidth
+)
+{
+    ULONG   i;
+
+    memset(Bandwidth, 0, sizeof(USB_BANDWIDTH));
+
+    Bandwidth->PeriodicEndpoints = Scope->PeriodicEndpoints;
+
+    for (i = 0; i < SCHEDULE_FRAMES; i++)
+    {
+        Bandwidth->FrameNs = max(Bandwidth->FrameNs, Scope->Frames[i]);
+    }
+
+    for (i = 0; i < SCHEDULE_MICROFRAMES; i++)
+    {
+        Bandwidth->MicroframeNs = max(Bandwidth->MicroframeNs, Scope->Microframes[i]);
+    }
+
+    Bandwidth->FramePercent =
+        (ULONG)((ULONGLONG)Bandwidth->FrameNs * 100 / FRAME_PERIODIC_NS);
+
+    Bandwidth->MicroframePercent =
+        (ULONG)((ULONGLONG)Bandwidth->MicroframeNs * 100 / MICROFRAME_PERIODIC_NS);
+
+    Bandwidth->OverThreshold = Bandwidth->FramePercent > Threshold ||
+                               Bandwidth->MicroframePercent > Threshold;
+}
+
+//*****************************************************************************
+//
+// SummarizeScheduleMap()
+//
+// Counts the slots of ScheduleMap shared by more than one pipe, and those
+// using more than Threshold percent of their periodic time.
+//
+//*****************************************************************************
+
+VOID
+SummarizeScheduleMap (
+    PUSB_SCHEDULE_MAP   ScheduleMap,
+    ULONG               Threshold
+)
+{
+    ULONG   i;
+
+    ScheduleMap->Collisions = 0;
+    ScheduleMap->HotSlots = 0;
+
+    for (i = 0; i < SCHEDULE_FRAMES; i++)
+    {
+        if (ScheduleMap->Frames[i].Pipes > 1)
+        {
+            ScheduleMap->Collisions++;
+        }
+
+        if ((ULONGLONG)ScheduleMap->Frames[i].Ns * 100 >
+            (ULONGLONG)FRAME_PERIODIC_NS * Threshold)
+        {
+            ScheduleMap->HotSlots++;
+        }
+    }
+
+    for (i = 0; i < SCHEDULE_MICROFRAMES; i++)
+    {
+        if (ScheduleMap->Microframes[i].Pipes > 1)
+        {
+            ScheduleMap->Collisions++;
+        }
+
+        if ((ULONGLONG)ScheduleMap->Microframes[i].Ns * 100 >
+            (ULONGLONG)MICROFRAME_PERIODIC_NS * Threshold)
+        {
+            ScheduleMap->HotSlots++;
+        }
+    }
+}
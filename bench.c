@@ -0,0 +1,2190 @@
+/*++
+
+Copyright (c) 1997-1998 Microsoft Corporation
+
+Module Name:
+
+    BENCH.C
+
+Abstract:
+
+    This source file contains the enumeration benchmark.  It enumerates the
+    current device access backend (normally the simulated topology from
+    DEVSIM.C) a few times with different numbers of worker threads, with
+    and without overlapped port queries, and writes the timings and the
+    number of requests sent to a text file.  Configuration and string
+    descriptors are always fetched during the enumeration, and the
+    descriptor cache is flushed before each one.  Every tree is diffed with
+    the first one, enumerated inline and serially, and the run fails if
+    any other gives a different tree or order.
+
+    It then times the tree diff of TREEDIFF.C on synthetic trees, with and
+    without differences between the two, the formatting of the details
+    of a synthetic composite device by DISPLAY.C, and moving the selection
+    over a tree of synthetic devices with and without the render cache of
+    RENDCACHE.C, the vendor name lookup, writing a tree of synthetic
+    devices as JSON and in the binary format of SERIAL.C, and the periodic
+    bandwidth calculation of BANDWIDTH.C over such a tree, none of which
+    needs any devices at all.
+
+    The results of the tree diff and of the bandwidth calculation are also
+    checked against fixed trees whose results are worked out by hand, and
+    the refresh scheduler of REFSCHED.C against bursts of notifications on
+    a simulated clock.  The run fails if any of them is off.
+
+Environment:
+
+    user mode
+
+Revision History:
+
+    10-16-26 : created
+
+--*/
+
+//*****************************************************************************
+// I N C L U D E S
+//*****************************************************************************
+
+#include <windows.h>
+#include <basetyps.h>
+#include <winioctl.h>
+#include <stdio.h>
+#include <tchar.h>
+#include "usbview.h"
+
+//*****************************************************************************
+// D E F I N E S
+//*****************************************************************************
+
+#define BENCH_REPETITIONS   3
+
+#define DIFF_BENCH_NODES    1000
+#define DIFF_BENCH_PORTS    7       // ports per synthetic hub
+#define DIFF_BENCH_HUB_PORT 3       // ports below this one are hubs
+
+// Which ports of the synthetic tree differ, by the order they are made in
+//
+#define DIFF_BENCH_REMOVED(n)   ((n) % 97 == 0)     // only in the old tree
+#define DIFF_BENCH_INSERTED(n)  ((n) % 89 == 0)     // only in the new tree
+#define DIFF_BENCH_CHANGED(n)   ((n) % 31 == 0)     // text differs
+
+#define RENDER_BENCH_INTERFACES 64
+#define RENDER_BENCH_ENDPOINTS  4       // per interface
+#define RENDER_BENCH_PASSES     100     // renders per repetition
+
+#define SELECT_BENCH_DEVICES    300
+#define SELECT_BENCH_PASSES     10      // times over all devices per repetition
+#define SELECT_BENCH_CACHE      (4096 * 1024)
+
+#define VENDOR_BENCH_PASSES     100     // times over all Vendor IDs per repetition
+
+#define SERIAL_BENCH_DEVICES    256     // spread over the root hubs
+#define SERIAL_BENCH_INTERFACES 8
+#define SERIAL_BENCH_PASSES     10      // trees written per repetition
+
+#define BANDWIDTH_BENCH_PASSES  100     // calculations per repetition
+
+#ifdef UNICODE
+#define BENCH_TSTR          "%S"
+#else
+#define BENCH_TSTR          "%s"
+#endif
+
+//*****************************************************************************
+// L O C A L    F U N C T I O N    P R O T O T Y P E S
+//*****************************************************************************
+
+BOOL
+TimeEnumeration (
+    HANDLE          hFile,
+    ULONG           Workers,
+    BOOL            Overlapped,
+    BOOL            DevNodeIndex,
+    PUSBTREENODE    Reference,
+    PBOOL           Same
+);
+
+BOOL
+TimeTreeDiff (
+    HANDLE  hFile,
+    BOOL    Differences
+);
+
+BOOL
+TimeRender (
+    HANDLE  hFile
+);
+
+BOOL
+TimeSelection (
+    HANDLE  hFile,
+    ULONG   CacheBudget
+);
+
+BOOL
+TimeVendorLookup (
+    HANDLE  hFile
+);
+
+BOOL
+TimeSerialize (
+    HANDLE          hFile,
+    SERIAL_FORMAT   Format
+);
+
+BOOL
+TimeBandwidth (
+    HANDLE  hFile
+);
+
+BOOL
+CheckTreeDiff (
+    HANDLE  hFile
+);
+
+BOOL
+CheckTreeDiffCase (
+    HANDLE  hFile,
+    BOOL    Differences,
+    ULONG   Inserted,
+    ULONG   Removed,
+    ULONG   Changed,
+    ULONG   Unchanged
+);
+
+BOOL
+CheckBandwidth (
+    HANDLE  hFile
+);
+
+BOOL
+CheckRefreshScheduler (
+    HANDLE  hFile
+);
+
+BOOL
+CheckRefreshCase (
+    HANDLE  hFile,
+    PCSTR   Name,
+    ULONG   QuietPeriod,
+    ULONG   MaxDelay,
+    ULONG   Notifications,
+    ULONG   Interval,
+    ULONG   RefreshMs,
+    ULONG   Folded,
+    ULONG   Refreshes,
+    ULONG   FirstRefresh
+);
+
+ULONG
+GetSimulatedTicks (
+    PVOID   Context
+);
+
+BOOL
+CheckBandwidthCase (
+    HANDLE          hFile,
+    PCSTR           Name,
+    PUSB_BANDWIDTH  Bandwidth,
+    ULONG           PeriodicEndpoints,
+    ULONG           FrameNs,
+    ULONG           MicroframeNs,
+    BOOL            OverThreshold
+);
+
+PUSBTREENODE
+BuildBandwidthSnapshot (
+    PUSB_SNAPSHOT   Snapshot
+);
+
+PUSBTREENODE
+AddBandwidthDevice (
+    PUSBTREENODE    Parent,
+    BOOL            Hub,
+    UCHAR           Speed,
+    UCHAR           EndpointAddress,
+    UCHAR           Type,
+    USHORT          MaxPacketSize,
+    UCHAR           Interval
+);
+
+PUSBDEVICEINFO
+BuildSyntheticDevice (
+    ULONG   NumInterfaces,
+    ULONG   NumEndpoints
+);
+
+VOID
+BuildSyntheticTree (
+    PUSBTREENODE    Root,
+    ULONG           NumNodes,
+    BOOL            Differences,
+    BOOL            NewTree
+);
+
+BOOL
+BuildSyntheticSnapshot (
+    PUSB_SNAPSHOT   Snapshot,
+    ULONG           NumDevices
+);
+
+BOOL
+InsertSyntheticNode (
+    PVOID           Context,
+    PUSBTREENODE    Parent,
+    PUSBTREENODE    After,
+    PUSBTREENODE    Node
+);
+
+VOID
+RemoveSyntheticNode (
+    PVOID           Context,
+    PUSBTREENODE    Node
+);
+
+VOID
+UpdateSyntheticNode (
+    PVOID           Context,
+    PUSBTREENODE    Node,
+    PUSBTREENODE    NewNode,
+    BOOL            Changed
+);
+
+BOOL
+WriteBenchLine (
+    HANDLE  hFile,
+    PCSTR   Format,
+    ...
+);
+
+//*****************************************************************************
+// G L O B A L S    P R I V A T E    T O    T H I S    F I L E
+//*****************************************************************************
+
+PCTSTR SyntheticDriverKeys[] =
+{
+    _T("{36fc9e60-c465-11cf-8056-444553540000}\\0000"),
+    _T("{36fc9e60-c465-11cf-8056-444553540000}\\0001"),
+    _T("{36fc9e60-c465-11cf-8056-444553540000}\\0002"),
+    _T("{36fc9e60-c465-11cf-8056-444553540000}\\0003")
+};
+
+
+//*****************************************************************************
+//
+// RunEnumerationBenchmark()
+//
+// FileName - Text file the results are written to.
+//
+// MaxWorkers - The run is repeated for 0 (inline), 1, 2, 4, ... workers up
+// to twice this many, each with serial and with overlapped port queries.
+// The first and the last of those are then run once more walking the
+// devnode tree for each lookup instead of indexing it.  Each tree must be
+// the same as the one of the first, inline and serial, enumeration.
+//
+// Returns FALSE if the file cannot be written, a tree differs from the
+// first one, or a tree diff, bandwidth or refresh case fails, see
+// CheckTreeDiff(), CheckBandwidth() and CheckRefreshScheduler().
+//
+//*****************************************************************************
+
+BOOL
+RunEnumerationBenchmark (
+    __in PCTSTR FileName,
+    ULONG       MaxWorkers
+)
+{
+    HANDLE          hFile;
+    USBTREENODE     reference;
+    ULONG           workers;
+    ULONG           limit;
+    BOOL            same;
+    BOOL            success;
+
+    hFile = CreateFile(FileName,
+                       GENERIC_WRITE,
+                       0,
+                       NULL,
+                       CREATE_ALWAYS,
+                       FILE_ATTRIBUTE_NORMAL,
+                       NULL);
+
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    WriteBenchLine(hFile,
+                   "backend " BENCH_TSTR ", %u repetitions\r\n"
+                   "workers  overlapped  index    best ms     avg ms    devices  hubs    ioctls  cm calls  same\r\n",
+                   GetDeviceBackend()->Name,
+                   BENCH_REPETITIONS);
+
+    memset(&reference, 0, sizeof(reference));
+
+    same = TRUE;
+
+    limit = max(MaxWorkers * 2, 1);
+
+    for (workers = 0; workers <= limit; workers = workers ? workers * 2 : 1)
+    {
+        if (!TimeEnumeration(hFile, workers, FALSE, TRUE, &reference, &same) ||
+            !TimeEnumeration(hFile, workers, TRUE, TRUE, &reference, &same))
+        {
+            break;
+        }
+    }
+
+    TimeEnumeration(hFile, 0, FALSE, FALSE, &reference, &same);
+    TimeEnumeration(hFile, limit, TRUE, FALSE, &reference, &same);
+
+    FreeTreeNodes(&reference, TRUE);
+
+    success = same;
+
+    WriteBenchLine(hFile,
+                   "\r\ntree diff, %u nodes, %u repetitions\r\n"
+                   "differences    best ms     avg ms  inserted   removed   changed unchanged\r\n",
+                   DIFF_BENCH_NODES,
+                   BENCH_REPETITIONS);
+
+    TimeTreeDiff(hFile, FALSE);
+    TimeTreeDiff(hFile, TRUE);
+
+    WriteBenchLine(hFile,
+                   "\r\ntree diff cases\r\n"
+                   "differences  inserted   removed   changed unchanged\r\n");
+
+    if (!CheckTreeDiff(hFile))
+    {
+        success = FALSE;
+    }
+
+    WriteBenchLine(hFile,
+                   "\r\nrender, %u interfaces of %u endpoints, %u renders, %u repetitions\r\n"
+                   "   best ms     avg ms     chars\r\n",
+                   RENDER_BENCH_INTERFACES,
+                   RENDER_BENCH_ENDPOINTS,
+                   RENDER_BENCH_PASSES,
+                   BENCH_REPETITIONS);
+
+    TimeRender(hFile);
+
+    WriteBenchLine(hFile,
+                   "\r\nselection, %u devices of %u interfaces, %u passes, %u repetitions\r\n"
+                   "  cache KB    best ms     avg ms\r\n",
+                   SELECT_BENCH_DEVICES,
+                   RENDER_BENCH_ENDPOINTS,
+                   SELECT_BENCH_PASSES,
+                   BENCH_REPETITIONS);
+
+    TimeSelection(hFile, 0);
+    TimeSelection(hFile, SELECT_BENCH_CACHE);
+
+    WriteBenchLine(hFile,
+                   "\r\nvendor lookup, all 65536 IDs, %u passes, %u repetitions\r\n"
+                   "   best ms     avg ms  ns/lookup     found\r\n",
+                   VENDOR_BENCH_PASSES,
+                   BENCH_REPETITIONS);
+
+    TimeVendorLookup(hFile);
+
+    WriteBenchLine(hFile,
+                   "\r\nserialize, %u devices of %u interfaces, %u trees, %u repetitions\r\n"
+                   "format    best ms     avg ms     bytes     MB/s\r\n",
+                   SERIAL_BENCH_DEVICES,
+                   SERIAL_BENCH_INTERFACES,
+                   SERIAL_BENCH_PASSES,
+                   BENCH_REPETITIONS);
+
+    TimeSerialize(hFile, SerialFormatJson);
+    TimeSerialize(hFile, SerialFormatBinary);
+
+    WriteBenchLine(hFile,
+                   "\r\nbandwidth, %u devices of %u interfaces, %u passes, %u repetitions\r\n"
+                   "   best ms     avg ms  endpoints  warnings\r\n",
+                   SERIAL_BENCH_DEVICES,
+                   SERIAL_BENCH_INTERFACES,
+                   BANDWIDTH_BENCH_PASSES,
+                   BENCH_REPETITIONS);
+
+    TimeBandwidth(hFile);
+
+    WriteBenchLine(hFile,
+                   "\r\nbandwidth cases\r\n"
+                   "case              endpoints   frame ns  uframe ns  over\r\n");
+
+    if (!CheckBandwidth(hFile))
+    {
+        success = FALSE;
+    }
+
+    WriteBenchLine(hFile,
+                   "\r\nrefresh cases\r\n"
+                   "case              notifications  folded  refreshes  first ms\r\n");
+
+    if (!CheckRefreshScheduler(hFile))
+    {
+        success = FALSE;
+    }
+
+    CloseHandle(hFile);
+
+    return success;
+}
+
+//*****************************************************************************
+//
+// TimeEnumeration()
+//
+// Enumerates BENCH_REPETITIONS times with the given settings and writes
+// one line of results.  Every descriptor is fetched during enumeration,
+// whatever the options of the program are.
+//
+// Reference - Tree the enumerated ones are diffed with.  The first time,
+// when it has no children yet, it gets the tree of the first repetition.
+//
+// Same - Set to FALSE if any tree differs from Reference, in its nodes or
+// in their order, which the diff reports as removed and inserted.
+//
+//*****************************************************************************
+
+BOOL
+TimeEnumeration (
+    HANDLE          hFile,
+    ULONG           Workers,
+    BOOL            Overlapped,
+    BOOL            DevNodeIndex,
+    PUSBTREENODE    Reference,
+    PBOOL           Same
+)
+{
+    LARGE_INTEGER       frequency;
+    LARGE_INTEGER       start;
+    LARGE_INTEGER       stop;
+    USB_SNAPSHOT        snapshot;
+    ENUM_CONTEXT        context;
+    TREE_DIFF_CALLBACKS callbacks;
+    TREE_DIFF_STATS     stats;
+    PUSBTREENODE        node;
+    BOOL                same;
+    ULONG               i;
+    double              elapsed;
+    double              best;
+    double              total;
+
+    if (!WorkPoolCreate(Workers))
+    {
+        return FALSE;
+    }
+
+    QueryPerformanceFrequency(&frequency);
+
+    callbacks.Context = NULL;
+    callbacks.InsertNode = InsertSyntheticNode;
+    callbacks.RemoveNode = RemoveSyntheticNode;
+    callbacks.UpdateNode = UpdateSyntheticNode;
+
+    same = TRUE;
+
+    best = 0;
+    total = 0;
+
+    for (i = 0; i < BENCH_REPETITIONS; i++)
+    {
+        memset(&snapshot, 0, sizeof(snapshot));
+
+        InitEnumContext(&context, &snapshot);
+
+        context.DoConfigDesc = TRUE;
+        context.DoLazyDesc = FALSE;
+        context.DoOverlapped = Overlapped;
+        context.DoDevNodeIndex = DevNodeIndex;
+
+        // Every repetition is a cold enumeration
+        //
+        FreeDescriptorCache();
+
+        QueryPerformanceCounter(&start);
+
+        EnumerateHostControllers(&context);
+
+        QueryPerformanceCounter(&stop);
+
+        if (Reference->FirstChild == NULL)
+        {
+            // The first tree is what all the others must be
+            //
+            Reference->FirstChild = snapshot.Root.FirstChild;
+            Reference->LastChild = snapshot.Root.LastChild;
+
+            for (node = Reference->FirstChild; node != NULL; node = node->NextSibling)
+            {
+                node->Parent = Reference;
+            }
+
+            snapshot.Root.FirstChild = NULL;
+            snapshot.Root.LastChild = NULL;
+        }
+        else
+        {
+            // Reference ends up with the new tree, which is the same one
+            // unless this fails
+            //
+            memset(&stats, 0, sizeof(stats));
+
+            DiffTreeNodes(Reference, &snapshot.Root, &callbacks, &stats);
+
+            if (stats.Inserted != 0 || stats.Removed != 0 || stats.Changed != 0)
+            {
+                same = FALSE;
+            }
+        }
+
+        FreeTreeNodes(&snapshot.Root, TRUE);
+
+        elapsed = (double)(stop.QuadPart - start.QuadPart) * 1000.0 /
+                  (double)frequency.QuadPart;
+
+        if (i == 0 || elapsed < best)
+        {
+            best = elapsed;
+        }
+
+        total += elapsed;
+    }
+
+    WorkPoolDestroy();
+
+    if (!same)
+    {
+        *Same = FALSE;
+    }
+
+    return WriteBenchLine(hFile,
+                          "%7u %11s %6s %10.1f %10.1f %10u %5d %9d %9d %5s\r\n",
+                          Workers,
+                          Overlapped ? "yes" : "no",
+                          DevNodeIndex ? "yes" : "no",
+                          best,
+                          total / BENCH_REPETITIONS,
+                          snapshot.DevicesConnected,
+                          snapshot.Hubs,
+                          snapshot.Counters.IoControls,
+                          snapshot.Counters.DevNodeCalls,
+                          same ? "yes" : "NO");
+}
+
+//*****************************************************************************
+//
+// TimeTreeDiff()
+//
+// Differences - FALSE to diff two identical trees, as for a refresh where
+// nothing changed, TRUE to have some ports come, go and change.
+//
+//*****************************************************************************
+
+BOOL
+TimeTreeDiff (
+    HANDLE  hFile,
+    BOOL    Differences
+)
+{
+    LARGE_INTEGER       frequency;
+    LARGE_INTEGER       start;
+    LARGE_INTEGER       stop;
+    USBTREENODE         oldRoot;
+    USBTREENODE         newRoot;
+    TREE_DIFF_CALLBACKS callbacks;
+    TREE_DIFF_STATS     stats;
+    ULONG               i;
+    double              elapsed;
+    double              best;
+    double              total;
+
+    QueryPerformanceFrequency(&frequency);
+
+    callbacks.Context = NULL;
+    callbacks.InsertNode = InsertSyntheticNode;
+    callbacks.RemoveNode = RemoveSyntheticNode;
+    callbacks.UpdateNode = UpdateSyntheticNode;
+
+    best = 0;
+    total = 0;
+
+    for (i = 0; i < BENCH_REPETITIONS; i++)
+    {
+        memset(&oldRoot, 0, sizeof(oldRoot));
+        memset(&newRoot, 0, sizeof(newRoot));
+        memset(&stats, 0, sizeof(stats));
+
+        BuildSyntheticTree(&oldRoot, DIFF_BENCH_NODES, Differences, FALSE);
+        BuildSyntheticTree(&newRoot, DIFF_BENCH_NODES, Differences, TRUE);
+
+        QueryPerformanceCounter(&start);
+
+        DiffTreeNodes(&oldRoot, &newRoot, &callbacks, &stats);
+
+        QueryPerformanceCounter(&stop);
+
+        FreeTreeNodes(&oldRoot, TRUE);
+        FreeTreeNodes(&newRoot, TRUE);
+
+        elapsed = (double)(stop.QuadPart - start.QuadPart) * 1000.0 /
+                  (double)frequency.QuadPart;
+
+        if (i == 0 || elapsed < best)
+        {
+            best = elapsed;
+        }
+
+        total += elapsed;
+    }
+
+    return WriteBenchLine(hFile,
+                          "%11s %10.3f %10.3f %9u %9u %9u %9u\r\n",
+                          Differences ? "yes" : "no",
+                          best,
+                          total / BENCH_REPETITIONS,
+                          stats.Inserted,
+                          stats.Removed,
+                          stats.Changed,
+                          stats.Unchanged);
+}
+
+//*****************************************************************************
+//
+// TimeRender()
+//
+// Formats the details of a synthetic composite device RENDER_BENCH_PASSES
+// times per repetition, the same path UpdateEditControl() takes, but
+// without a window.
+//
+//*****************************************************************************
+
+BOOL
+TimeRender (
+    HANDLE  hFile
+)
+{
+    LARGE_INTEGER   frequency;
+    LARGE_INTEGER   start;
+    LARGE_INTEGER   stop;
+    PUSBDEVICEINFO  info;
+    PCTSTR          text;
+    ULONG           i;
+    ULONG           pass;
+    double          elapsed;
+    double          best;
+    double          total;
+    BOOL            success;
+
+    info = BuildSyntheticDevice(RENDER_BENCH_INTERFACES,
+                                RENDER_BENCH_ENDPOINTS);
+
+    if (info == NULL)
+    {
+        return FALSE;
+    }
+
+    if (!CreateTextBuffer())
+    {
+        FreeDeviceInfo(info);
+        return FALSE;
+    }
+
+    QueryPerformanceFrequency(&frequency);
+
+    text = NULL;
+    best = 0;
+    total = 0;
+
+    for (i = 0; i < BENCH_REPETITIONS; i++)
+    {
+        QueryPerformanceCounter(&start);
+
+        for (pass = 0; pass < RENDER_BENCH_PASSES; pass++)
+        {
+            text = RenderDeviceInfo(info);
+        }
+
+        QueryPerformanceCounter(&stop);
+
+        elapsed = (double)(stop.QuadPart - start.QuadPart) * 1000.0 /
+                  (double)frequency.QuadPart;
+
+        if (i == 0 || elapsed < best)
+        {
+            best = elapsed;
+        }
+
+        total += elapsed;
+    }
+
+    success = WriteBenchLine(hFile,
+                             "%10.3f %10.3f %9u\r\n",
+                             best,
+                             total / BENCH_REPETITIONS,
+                             text ? (ULONG)_tcslen(text) : 0);
+
+    DestroyTextBuffer();
+
+    FreeDeviceInfo(info);
+
+    return success;
+}
+
+//*****************************************************************************
+//
+// TimeSelection()
+//
+// Selects each of SELECT_BENCH_DEVICES synthetic devices in turn,
+// SELECT_BENCH_PASSES times per repetition, the way UpdateEditControl()
+// does when the arrow keys are held down in the tree, with a render cache
+// of CacheBudget bytes.
+//
+//*****************************************************************************
+
+BOOL
+TimeSelection (
+    HANDLE  hFile,
+    ULONG   CacheBudget
+)
+{
+    LARGE_INTEGER   frequency;
+    LARGE_INTEGER   start;
+    LARGE_INTEGER   stop;
+    PUSBDEVICEINFO  info[SELECT_BENCH_DEVICES];
+    PCTSTR          text;
+    ULONG           i;
+    ULONG           pass;
+    ULONG           device;
+    double          elapsed;
+    double          best;
+    double          total;
+    BOOL            success;
+
+    memset(info, 0, sizeof(info));
+
+    success = CreateTextBuffer();
+
+    for (device = 0; success && device < SELECT_BENCH_DEVICES; device++)
+    {
+        info[device] = BuildSyntheticDevice(RENDER_BENCH_ENDPOINTS,
+                                            RENDER_BENCH_ENDPOINTS);
+
+        success = info[device] != NULL;
+    }
+
+    if (!success)
+    {
+        for (device = 0; device < SELECT_BENCH_DEVICES; device++)
+        {
+            FreeDeviceInfo(info[device]);
+        }
+
+        DestroyTextBuffer();
+
+        return FALSE;
+    }
+
+    SetRenderCacheBudget(CacheBudget);
+
+    QueryPerformanceFrequency(&frequency);
+
+    best = 0;
+    total = 0;
+
+    for (i = 0; i < BENCH_REPETITIONS; i++)
+    {
+        QueryPerformanceCounter(&start);
+
+        for (pass = 0; pass < SELECT_BENCH_PASSES; pass++)
+        {
+            for (device = 0; device < SELECT_BENCH_DEVICES; device++)
+            {
+                // The info stands in for the TreeView item
+                //
+                if (LookupRenderCache(info[device]) != NULL)
+                {
+                    continue;
+                }
+
+                text = RenderDeviceInfo(info[device]);
+
+                if (text != NULL)
+                {
+                    AddRenderCache(info[device], text, (ULONG)_tcslen(text));
+                }
+            }
+        }
+
+        QueryPerformanceCounter(&stop);
+
+        elapsed = (double)(stop.QuadPart - start.QuadPart) * 1000.0 /
+                  (double)frequency.QuadPart;
+
+        if (i == 0 || elapsed < best)
+        {
+            best = elapsed;
+        }
+
+        total += elapsed;
+    }
+
+    success = WriteBenchLine(hFile,
+                             "%10u %10.3f %10.3f\r\n",
+                             CacheBudget / 1024,
+                             best,
+                             total / BENCH_REPETITIONS);
+
+    FreeRenderCache();
+
+    SetRenderCacheBudget(0);
+
+    for (device = 0; device < SELECT_BENCH_DEVICES; device++)
+    {
+        FreeDeviceInfo(info[device]);
+    }
+
+    DestroyTextBuffer();
+
+    return success;
+}
+
+//*****************************************************************************
+//
+// TimeVendorLookup()
+//
+// Looks up the name of every possible Vendor ID VENDOR_BENCH_PASSES times
+// per repetition.
+//
+//*****************************************************************************
+
+BOOL
+TimeVendorLookup (
+    HANDLE  hFile
+)
+{
+    LARGE_INTEGER   frequency;
+    LARGE_INTEGER   start;
+    LARGE_INTEGER   stop;
+    ULONG           i;
+    ULONG           pass;
+    ULONG           idVendor;
+    ULONG           found;
+    double          elapsed;
+    double          best;
+    double          total;
+
+    QueryPerformanceFrequency(&frequency);
+
+    found = 0;
+    best = 0;
+    total = 0;
+
+    for (i = 0; i < BENCH_REPETITIONS; i++)
+    {
+        found = 0;
+
+        QueryPerformanceCounter(&start);
+
+        for (pass = 0; pass < VENDOR_BENCH_PASSES; pass++)
+        {
+            for (idVendor = 0; idVendor <= 0xFFFF; idVendor++)
+            {
+                if (GetVendorString((USHORT)idVendor) != NULL)
+                {
+                    found++;
+                }
+            }
+        }
+
+        QueryPerformanceCounter(&stop);
+
+        elapsed = (double)(stop.QuadPart - start.QuadPart) * 1000.0 /
+                  (double)frequency.QuadPart;
+
+        if (i == 0 || elapsed < best)
+        {
+            best = elapsed;
+        }
+
+        total += elapsed;
+    }
+
+    return WriteBenchLine(hFile,
+                          "%10.3f %10.3f %10.2f %9u\r\n",
+                          best,
+                          total / BENCH_REPETITIONS,
+                          best * 1000000.0 / (VENDOR_BENCH_PASSES * 65536.0),
+                          found / VENDOR_BENCH_PASSES);
+}
+
+//*****************************************************************************
+//
+// TimeSerialize()
+//
+// Writes a tree of SERIAL_BENCH_DEVICES synthetic devices in Format
+// SERIAL_BENCH_PASSES times per repetition.  The output is produced but
+// not written anywhere, so only the formatting is timed.
+//
+//*****************************************************************************
+
+BOOL
+TimeSerialize (
+    HANDLE          hFile,
+    SERIAL_FORMAT   Format
+)
+{
+    LARGE_INTEGER   frequency;
+    LARGE_INTEGER   start;
+    LARGE_INTEGER   stop;
+    USB_SNAPSHOT    snapshot;
+    ULONG           bytes;
+    ULONG           i;
+    ULONG           pass;
+    double          elapsed;
+    double          best;
+    double          total;
+    BOOL            success;
+
+    if (!BuildSyntheticSnapshot(&snapshot, SERIAL_BENCH_DEVICES))
+    {
+        return FALSE;
+    }
+
+    QueryPerformanceFrequency(&frequency);
+
+    bytes = 0;
+    best = 0;
+    total = 0;
+
+    for (i = 0; i < BENCH_REPETITIONS; i++)
+    {
+        QueryPerformanceCounter(&start);
+
+        for (pass = 0; pass < SERIAL_BENCH_PASSES; pass++)
+        {
+            bytes = SerializeSnapshot(&snapshot, Format, NULL);
+        }
+
+        QueryPerformanceCounter(&stop);
+
+        elapsed = (double)(stop.QuadPart - start.QuadPart) * 1000.0 /
+                  (double)frequency.QuadPart;
+
+        if (i == 0 || elapsed < best)
+        {
+            best = elapsed;
+        }
+
+        total += elapsed;
+    }
+
+    success = WriteBenchLine(hFile,
+                             "%-6s %10.3f %10.3f %9u %8.1f\r\n",
+                             Format == SerialFormatJson ? "json" : "binary",
+                             best / SERIAL_BENCH_PASSES,
+                             total / (BENCH_REPETITIONS * SERIAL_BENCH_PASSES),
+                             bytes,
+                             best > 0 ?
+                                 (double)bytes * SERIAL_BENCH_PASSES / (best * 1000.0) :
+                                 0.0);
+
+    FreeTreeNodes(&snapshot.Root, TRUE);
+
+    return success;
+}
+
+//*****************************************************************************
+//
+// TimeBandwidth()
+//
+// Computes the periodic bandwidth of a tree of synthetic devices
+// BANDWIDTH_BENCH_PASSES times per repetition.  The devices are made low,
+// full and high speed in turn, and their endpoints interrupt and
+// isochronous ones.
+//
+//*****************************************************************************
+
+BOOL
+TimeBandwidth (
+    HANDLE  hFile
+)
+{
+    LARGE_INTEGER               frequency;
+    LARGE_INTEGER               start;
+    LARGE_INTEGER               stop;
+    USB_SNAPSHOT                snapshot;
+    PUSBTREENODE                hcNode;
+    PUSBTREENODE                node;
+    PUSBDEVICEINFO              info;
+    PCONFIG_DESC_INDEX          index;
+    PCONFIG_DESC_ENTRY          entry;
+    PUSB_ENDPOINT_DESCRIPTOR    endpointDesc;
+    ULONG                       endpoints;
+    ULONG                       device;
+    ULONG                       i;
+    ULONG                       pass;
+    double                      elapsed;
+    double                      best;
+    double                      total;
+    BOOL                        success;
+
+    if (!BuildSyntheticSnapshot(&snapshot, SERIAL_BENCH_DEVICES))
+    {
+        return FALSE;
+    }
+
+    device = 0;
+
+    for (hcNode = snapshot.Root.FirstChild; hcNode != NULL; hcNode = hcNode->NextSibling)
+    {
+        for (node = hcNode->FirstChild->FirstChild; node != NULL; node = node->NextSibling)
+        {
+            info = (PUSBDEVICEINFO)node->Info;
+            index = GetConfigDescIndex(info->ConfigDesc);
+
+            info->ConnectionInfo->Speed = (UCHAR)(device++ % 3);
+
+            for (entry = index->Entries;
+                 entry < index->Entries + index->NumEntries;
+                 entry++)
+            {
+                if (entry->Kind == ConfigDescEndpoint)
+                {
+                    endpointDesc = (PUSB_ENDPOINT_DESCRIPTOR)
+                        CONFIG_ENTRY_DESC(info->ConfigDesc, entry);
+
+                    endpointDesc->bmAttributes = (endpointDesc->bEndpointAddress & 0x01) ?
+                                                 USB_ENDPOINT_TYPE_INTERRUPT :
+                                                 USB_ENDPOINT_TYPE_ISOCHRONOUS;
+                    endpointDesc->wMaxPacketSize = 8;
+                    endpointDesc->bInterval = 4;
+                }
+            }
+        }
+    }
+
+    QueryPerformanceFrequency(&frequency);
+
+    best = 0;
+    total = 0;
+
+    for (i = 0; i < BENCH_REPETITIONS; i++)
+    {
+        QueryPerformanceCounter(&start);
+
+        for (pass = 0; pass < BANDWIDTH_BENCH_PASSES; pass++)
+        {
+            ComputeBandwidth(&snapshot, DEFAULT_BANDWIDTH_THRESHOLD);
+        }
+
+        QueryPerformanceCounter(&stop);
+
+        elapsed = (double)(stop.QuadPart - start.QuadPart) * 1000.0 /
+                  (double)frequency.QuadPart;
+
+        if (i == 0 || elapsed < best)
+        {
+            best = elapsed;
+        }
+
+        total += elapsed;
+    }
+
+    endpoints = 0;
+
+    for (hcNode = snapshot.Root.FirstChild; hcNode != NULL; hcNode = hcNode->NextSibling)
+    {
+        endpoints += ((PUSBHOSTCONTROLLERINFO)hcNode->Info)->Bandwidth.PeriodicEndpoints;
+    }
+
+    success = WriteBenchLine(hFile,
+                             "%10.3f %10.3f %10u %9d\r\n",
+                             best / BANDWIDTH_BENCH_PASSES,
+                             total / (BENCH_REPETITIONS * BANDWIDTH_BENCH_PASSES),
+                             endpoints,
+                             snapshot.BandwidthWarnings);
+
+    FreeTreeNodes(&snapshot.Root, TRUE);
+
+    return success;
+}
+
+//*****************************************************************************
+//
+// CheckTreeDiff()
+//
+// Diffs the synthetic trees of TimeTreeDiff() once more and compares what
+// is found with what BuildSyntheticTree() makes of them.  Returns FALSE if
+// any count differs.
+//
+//*****************************************************************************
+
+BOOL
+CheckTreeDiff (
+    HANDLE  hFile
+)
+{
+    BOOL    success;
+
+    success = TRUE;
+
+    // Without differences, all the nodes are unchanged
+    //
+    if (!CheckTreeDiffCase(hFile, FALSE, 0, 0, 0, DIFF_BENCH_NODES))
+    {
+        success = FALSE;
+    }
+
+    // Of the ports, those of devices numbered by DIFF_BENCH_REMOVED() are
+    // only in the old tree and those by DIFF_BENCH_INSERTED() only in the
+    // new one, 8 each.  Those numbered by DIFF_BENCH_CHANGED() change,
+    // hubs included, and the rest are unchanged.
+    //
+    if (!CheckTreeDiffCase(hFile, TRUE, 8, 8, 32, DIFF_BENCH_NODES - 8 - 8 - 32))
+    {
+        success = FALSE;
+    }
+
+    return success;
+}
+
+//*****************************************************************************
+//
+// CheckTreeDiffCase()
+//
+// Writes the line of one tree diff case, and returns FALSE if the diff
+// does not find the changes expected.
+//
+//*****************************************************************************
+
+BOOL
+CheckTreeDiffCase (
+    HANDLE  hFile,
+    BOOL    Differences,
+    ULONG   Inserted,
+    ULONG   Removed,
+    ULONG   Changed,
+    ULONG   Unchanged
+)
+{
+    USBTREENODE         oldRoot;
+    USBTREENODE         newRoot;
+    TREE_DIFF_CALLBACKS callbacks;
+    TREE_DIFF_STATS     stats;
+    BOOL                match;
+
+    callbacks.Context = NULL;
+    callbacks.InsertNode = InsertSyntheticNode;
+    callbacks.RemoveNode = RemoveSyntheticNode;
+    callbacks.UpdateNode = UpdateSyntheticNode;
+
+    memset(&oldRoot, 0, sizeof(oldRoot));
+    memset(&newRoot, 0, sizeof(newRoot));
+    memset(&stats, 0, sizeof(stats));
+
+    BuildSyntheticTree(&oldRoot, DIFF_BENCH_NODES, Differences, FALSE);
+    BuildSyntheticTree(&newRoot, DIFF_BENCH_NODES, Differences, TRUE);
+
+    DiffTreeNodes(&oldRoot, &newRoot, &callbacks, &stats);
+
+    FreeTreeNodes(&oldRoot, TRUE);
+    FreeTreeNodes(&newRoot, TRUE);
+
+    match = stats.Inserted == Inserted &&
+            stats.Removed == Removed &&
+            stats.Changed == Changed &&
+            stats.Unchanged == Unchanged;
+
+    WriteBenchLine(hFile,
+                   "%11s %9u %9u %9u %9u%s\r\n",
+                   Differences ? "yes" : "no",
+                   stats.Inserted,
+                   stats.Removed,
+                   stats.Changed,
+                   stats.Unchanged,
+                   match ? "" : "  MISMATCH");
+
+    if (!match)
+    {
+        WriteBenchLine(hFile,
+                       "%11s %9u %9u %9u %9u  expected\r\n",
+                       "",
+                       Inserted,
+                       Removed,
+                       Changed,
+                       Unchanged);
+    }
+
+    return match;
+}
+
+//*****************************************************************************
+//
+// CheckBandwidth()
+//
+// Computes the periodic bandwidth of a few fixed trees and compares it with
+// what USB 2.0 section 5.11.3 gives for them, one line per host controller
+// or hub checked.  Returns FALSE if any of them differs.
+//
+//*****************************************************************************
+
+BOOL
+CheckBandwidth (
+    HANDLE  hFile
+)
+{
+    USB_SNAPSHOT    snapshot;
+    PUSBTREENODE    rootHub;
+    PUSBTREENODE    hub;
+    PUSBTREENODE    fullSpeedHub;
+    BOOL            built;
+    BOOL            success;
+
+    hub = NULL;
+    fullSpeedHub = NULL;
+
+    success = TRUE;
+
+    // A full speed interrupt IN endpoint of 8 bytes takes 15539 ns, a low
+    // speed one 116163 ns.  Both are every 8 frames, so they are placed in
+    // different frames, and the bulk endpoint takes no periodic time.
+    //
+    rootHub = BuildBandwidthSnapshot(&snapshot);
+
+    built = rootHub != NULL &&
+            AddBandwidthDevice(rootHub, FALSE, UsbFullSpeed, 0x81,
+                               USB_ENDPOINT_TYPE_INTERRUPT, 8, 10) != NULL &&
+            AddBandwidthDevice(rootHub, FALSE, UsbFullSpeed, 0x02,
+                               USB_ENDPOINT_TYPE_BULK, 64, 0) != NULL &&
+            AddBandwidthDevice(rootHub, FALSE, UsbLowSpeed, 0x81,
+                               USB_ENDPOINT_TYPE_INTERRUPT, 8, 10) != NULL;
+
+    if (built)
+    {
+        ComputeBandwidth(&snapshot, DEFAULT_BANDWIDTH_THRESHOLD);
+
+        if (!CheckBandwidthCase(hFile,
+                                "low/full speed",
+                                &((PUSBHOSTCONTROLLERINFO)snapshot.Root.FirstChild->Info)->Bandwidth,
+                                2, 116163, 0, FALSE))
+        {
+            success = FALSE;
+        }
+    }
+
+    FreeTreeNodes(&snapshot.Root, TRUE);
+
+    if (!built)
+    {
+        return FALSE;
+    }
+
+    // A high speed isochronous IN endpoint of 3 x 1024 bytes every
+    // microframe takes 61638 ns of each, 61% of its periodic time.  A
+    // second one makes it 123276 ns, over the threshold.
+    //
+    rootHub = BuildBandwidthSnapshot(&snapshot);
+
+    built = rootHub != NULL &&
+            AddBandwidthDevice(rootHub, FALSE, UsbHighSpeed, 0x81,
+                               USB_ENDPOINT_TYPE_ISOCHRONOUS, 0x1000 | 1024, 1) != NULL;
+
+    if (built)
+    {
+        ComputeBandwidth(&snapshot, DEFAULT_BANDWIDTH_THRESHOLD);
+
+        if (!CheckBandwidthCase(hFile,
+                                "high speed iso",
+                                &((PUSBHOSTCONTROLLERINFO)snapshot.Root.FirstChild->Info)->Bandwidth,
+                                1, 0, 61638, FALSE))
+        {
+            success = FALSE;
+        }
+
+        built = AddBandwidthDevice(rootHub, FALSE, UsbHighSpeed, 0x82,
+                                   USB_ENDPOINT_TYPE_ISOCHRONOUS, 0x1000 | 1024, 1) != NULL;
+    }
+
+    if (built)
+    {
+        ComputeBandwidth(&snapshot, DEFAULT_BANDWIDTH_THRESHOLD);
+
+        if (!CheckBandwidthCase(hFile,
+                                "high speed iso x2",
+                                &((PUSBHOSTCONTROLLERINFO)snapshot.Root.FirstChild->Info)->Bandwidth,
+                                2, 0, 123276, TRUE) ||
+            snapshot.BandwidthWarnings != 1)
+        {
+            success = FALSE;
+        }
+    }
+
+    FreeTreeNodes(&snapshot.Root, TRUE);
+
+    if (!built)
+    {
+        return FALSE;
+    }
+
+    // Split transactions: a high speed hub with a full speed interrupt
+    // endpoint of 64 bytes every frame, 59231 ns, and a full speed hub
+    // with another one.  Both are in the frames of the transaction
+    // translator, with the 10109 ns of the status change endpoint of the
+    // full speed hub, and none in those of the host controller.  On the
+    // high speed bus each split takes 2166 ns every 8 microframes, in
+    // different microframes.
+    //
+    rootHub = BuildBandwidthSnapshot(&snapshot);
+
+    built = rootHub != NULL &&
+            (hub = AddBandwidthDevice(rootHub, TRUE, UsbHighSpeed, 0x81,
+                                      USB_ENDPOINT_TYPE_INTERRUPT, 1, 12)) != NULL &&
+            AddBandwidthDevice(hub, FALSE, UsbFullSpeed, 0x81,
+                               USB_ENDPOINT_TYPE_INTERRUPT, 64, 1) != NULL &&
+            (fullSpeedHub = AddBandwidthDevice(hub, TRUE, UsbFullSpeed, 0x81,
+                                               USB_ENDPOINT_TYPE_INTERRUPT, 1, 255)) != NULL &&
+            AddBandwidthDevice(fullSpeedHub, FALSE, UsbFullSpeed, 0x81,
+                               USB_ENDPOINT_TYPE_INTERRUPT, 64, 1) != NULL;
+
+    if (built)
+    {
+        ComputeBandwidth(&snapshot, DEFAULT_BANDWIDTH_THRESHOLD);
+
+        if (!CheckBandwidthCase(hFile,
+                                "split, controller",
+                                &((PUSBHOSTCONTROLLERINFO)snapshot.Root.FirstChild->Info)->Bandwidth,
+                                4, 0, 2166, FALSE) ||
+            !CheckBandwidthCase(hFile,
+                                "split, tt hub",
+                                &((PUSBEXTERNALHUBINFO)hub->Info)->Bandwidth,
+                                3, 128571, 2166, FALSE) ||
+            !CheckBandwidthCase(hFile,
+                                "split, fs hub",
+                                &((PUSBEXTERNALHUBINFO)fullSpeedHub->Info)->Bandwidth,
+                                1, 59231, 2166, FALSE))
+        {
+            success = FALSE;
+        }
+    }
+
+    FreeTreeNodes(&snapshot.Root, TRUE);
+
+    return built && success;
+}
+
+//*****************************************************************************
+//
+// CheckBandwidthCase()
+//
+// Writes the line of one host controller or hub of a bandwidth case, and
+// returns FALSE if Bandwidth is not what is expected.
+//
+//*****************************************************************************
+
+BOOL
+CheckBandwidthCase (
+    HANDLE          hFile,
+    PCSTR           Name,
+    PUSB_BANDWIDTH  Bandwidth,
+    ULONG           PeriodicEndpoints,
+    ULONG           FrameNs,
+    ULONG           MicroframeNs,
+    BOOL            OverThreshold
+)
+{
+    BOOL    match;
+
+    match = Bandwidth->PeriodicEndpoints == PeriodicEndpoints &&
+            Bandwidth->FrameNs == FrameNs &&
+            Bandwidth->MicroframeNs == MicroframeNs &&
+            !Bandwidth->OverThreshold == !OverThreshold;
+
+    WriteBenchLine(hFile,
+                   "%-17s %9u %10u %10u %5s%s\r\n",
+                   Name,
+                   Bandwidth->PeriodicEndpoints,
+                   Bandwidth->FrameNs,
+                   Bandwidth->MicroframeNs,
+                   Bandwidth->OverThreshold ? "yes" : "no",
+                   match ? "" : "  MISMATCH");
+
+    if (!match)
+    {
+        WriteBenchLine(hFile,
+                       "%-17s %9u %10u %10u %5s  expected\r\n",
+                       "",
+                       PeriodicEndpoints,
+                       FrameNs,
+                       MicroframeNs,
+                       OverThreshold ? "yes" : "no");
+    }
+
+    return match;
+}
+
+//*****************************************************************************
+//
+// BuildBandwidthSnapshot()
+//
+// Snapshot - Gets one host controller with a root hub and nothing else.
+//
+// Returns the root hub node, NULL if it could not be built.  Free the
+// snapshot with FreeTreeNodes() either way.
+//
+//*****************************************************************************
+
+PUSBTREENODE
+BuildBandwidthSnapshot (
+    PUSB_SNAPSHOT   Snapshot
+)
+{
+    PUSBHOSTCONTROLLERINFO  hcInfo;
+    PUSBROOTHUBINFO         hubInfo;
+    PUSBTREENODE            node;
+
+    memset(Snapshot, 0, sizeof(USB_SNAPSHOT));
+
+    hcInfo = (PUSBHOSTCONTROLLERINFO)ALLOC(sizeof(USBHOSTCONTROLLERINFO));
+
+    if (hcInfo == NULL)
+    {
+        OOPS();
+        return NULL;
+    }
+
+    hcInfo->DeviceInfoType = HostControllerInfo;
+
+    node = AddTreeNode(&Snapshot->Root, hcInfo, _T("Controller"), GoodDeviceIcon);
+
+    if (node == NULL)
+    {
+        FreeDeviceInfo(hcInfo);
+        return NULL;
+    }
+
+    hubInfo = (PUSBROOTHUBINFO)ALLOC(sizeof(USBROOTHUBINFO));
+
+    if (hubInfo == NULL)
+    {
+        OOPS();
+        return NULL;
+    }
+
+    hubInfo->DeviceInfoType = RootHubInfo;
+
+    node = AddTreeNode(node, hubInfo, _T("RootHub"), HubIcon);
+
+    if (node == NULL)
+    {
+        FreeDeviceInfo(hubInfo);
+    }
+
+    return node;
+}
+
+//*****************************************************************************
+//
+// AddBandwidthDevice()
+//
+// Parent - Hub the device is connected to.
+//
+// Hub - Whether the device is an external hub, in which case the endpoint
+// is its status change endpoint.
+//
+// The device runs at Speed and has a single open pipe, of the endpoint
+// described by the rest.  Returns its node, NULL if it could not be added.
+//
+//*****************************************************************************
+
+PUSBTREENODE
+AddBandwidthDevice (
+    PUSBTREENODE    Parent,
+    BOOL            Hub,
+    UCHAR           Speed,
+    UCHAR           EndpointAddress,
+    UCHAR           Type,
+    USHORT          MaxPacketSize,
+    UCHAR           Interval
+)
+{
+    PUSB_NODE_CONNECTION_INFORMATION_EX connectionInfo;
+    PUSB_ENDPOINT_DESCRIPTOR            endpointDesc;
+    PVOID                               info;
+    PUSBTREENODE                        node;
+
+    connectionInfo = (PUSB_NODE_CONNECTION_INFORMATION_EX)
+        ALLOC(sizeof(USB_NODE_CONNECTION_INFORMATION_EX) + sizeof(USB_PIPE_INFO));
+
+    if (connectionInfo == NULL)
+    {
+        OOPS();
+        return NULL;
+    }
+
+    connectionInfo->ConnectionStatus = DeviceConnected;
+    connectionInfo->Speed = Speed;
+    connectionInfo->CurrentConfigurationValue = 1;
+    connectionInfo->NumberOfOpenPipes = 1;
+
+    endpointDesc = &connectionInfo->PipeList[0].EndpointDescriptor;
+
+    endpointDesc->bLength = sizeof(USB_ENDPOINT_DESCRIPTOR);
+    endpointDesc->bDescriptorType = USB_ENDPOINT_DESCRIPTOR_TYPE;
+    endpointDesc->bEndpointAddress = EndpointAddress;
+    endpointDesc->bmAttributes = Type;
+    endpointDesc->wMaxPacketSize = MaxPacketSize;
+    endpointDesc->bInterval = Interval;
+
+    if (Hub)
+    {
+        info = ALLOC(sizeof(USBEXTERNALHUBINFO));
+
+        if (info != NULL)
+        {
+            ((PUSBEXTERNALHUBINFO)info)->DeviceInfoType = ExternalHubInfo;
+            ((PUSBEXTERNALHUBINFO)info)->ConnectionInfo = connectionInfo;
+        }
+    }
+    else
+    {
+        info = ALLOC(sizeof(USBDEVICEINFO));
+
+        if (info != NULL)
+        {
+            ((PUSBDEVICEINFO)info)->DeviceInfoType = DeviceInfo;
+            ((PUSBDEVICEINFO)info)->ConnectionInfo = connectionInfo;
+        }
+    }
+
+    if (info == NULL)
+    {
+        OOPS();
+        FREE(connectionInfo);
+        return NULL;
+    }
+
+    node = AddTreeNode(Parent,
+                       info,
+                       Hub ? _T("Hub") : _T("Device"),
+                       Hub ? HubIcon : GoodDeviceIcon);
+
+    if (node == NULL)
+    {
+        FreeDeviceInfo(info);
+    }
+
+    return node;
+}
+
+//*****************************************************************************
+//
+// CheckRefreshScheduler()
+//
+// Drives the refresh scheduler through bursts of notifications on a
+// simulated clock, as the UI would.  Returns FALSE if it does not fold
+// them into the refreshes expected.
+//
+//*****************************************************************************
+
+BOOL
+CheckRefreshScheduler (
+    HANDLE  hFile
+)
+{
+    BOOL    success;
+
+    success = TRUE;
+
+    // 5 notifications 100 ms apart, each within the quiet period of the
+    // last, fold into one refresh the quiet period after the last one
+    //
+    if (!CheckRefreshCase(hFile, "burst", 500, 2000, 5, 100, 100,
+                          4, 1, 900))
+    {
+        success = FALSE;
+    }
+
+    // A notification every 100 ms for 5 s never leaves the quiet period.
+    // The maximum delay brings a refresh 2 s after the first notification
+    // still waiting, at 2000 and 4100 ms, and the last one comes the
+    // quiet period after the stream ends
+    //
+    if (!CheckRefreshCase(hFile, "continuous", 500, 2000, 51, 100, 100,
+                          48, 3, 2000))
+    {
+        success = FALSE;
+    }
+
+    // The refresh of the first notification runs for 1 s.  The 3 which
+    // come meanwhile leave a single one pending, run as soon as the first
+    // is over
+    //
+    if (!CheckRefreshCase(hFile, "while running", 50, 2000, 4, 100, 1000,
+                          2, 2, 50))
+    {
+        success = FALSE;
+    }
+
+    return success;
+}
+
+//*****************************************************************************
+//
+// CheckRefreshCase()
+//
+// Notifications - How many notifications are sent, Interval ms apart from
+// time 0 on.  Refreshes are started once due, and each ends RefreshMs
+// later, until no more are pending.
+//
+// Folded, Refreshes - What the scheduler is expected to count by then.
+//
+// FirstRefresh - When the first refresh is expected to start.
+//
+// Writes the line of the case, and returns FALSE if any of it differs.
+//
+//*****************************************************************************
+
+BOOL
+CheckRefreshCase (
+    HANDLE  hFile,
+    PCSTR   Name,
+    ULONG   QuietPeriod,
+    ULONG   MaxDelay,
+    ULONG   Notifications,
+    ULONG   Interval,
+    ULONG   RefreshMs,
+    ULONG   Folded,
+    ULONG   Refreshes,
+    ULONG   FirstRefresh
+)
+{
+    REFRESH_SCHEDULER   scheduler;
+    ULONG               clock;
+    ULONG               sent;
+    ULONG               request;
+    ULONG               refreshEnd;
+    ULONG               firstRefresh;
+    BOOL                match;
+
+    clock = 0;
+
+    InitRefreshScheduler(&scheduler,
+                         QuietPeriod,
+                         MaxDelay,
+                         GetSimulatedTicks,
+                         &clock);
+
+    sent = 0;
+    request = 0;
+    refreshEnd = 0;
+    firstRefresh = INFINITE;
+
+    // One ms at a time: notify, end the running refresh, start a due one
+    //
+    for (clock = 0; clock < (Notifications + 1) * Interval + 2 * MaxDelay + RefreshMs; clock++)
+    {
+        if (sent < Notifications && clock == sent * Interval)
+        {
+            RequestRefresh(&scheduler);
+            sent++;
+        }
+
+        if (scheduler.Running && clock == refreshEnd)
+        {
+            EndScheduledRefresh(&scheduler, request);
+        }
+
+        if (GetRefreshDelay(&scheduler) == 0)
+        {
+            BeginScheduledRefresh(&scheduler, ++request);
+
+            refreshEnd = clock + RefreshMs;
+
+            if (firstRefresh == INFINITE)
+            {
+                firstRefresh = clock;
+            }
+        }
+
+        if (sent == Notifications && !scheduler.Pending && !scheduler.Running)
+        {
+            break;
+        }
+    }
+
+    match = !scheduler.Pending &&
+            !scheduler.Running &&
+            scheduler.Notifications == Notifications &&
+            scheduler.Folded == Folded &&
+            scheduler.Refreshes == Refreshes &&
+            firstRefresh == FirstRefresh;
+
+    WriteBenchLine(hFile,
+                   "%-17s %13u %7u %10u %9u%s\r\n",
+                   Name,
+                   scheduler.Notifications,
+                   scheduler.Folded,
+                   scheduler.Refreshes,
+                   firstRefresh,
+                   match ? "" : "  MISMATCH");
+
+    if (!match)
+    {
+        WriteBenchLine(hFile,
+                       "%-17s %13u %7u %10u %9u  expected\r\n",
+                       "",
+                       Notifications,
+                       Folded,
+                       Refreshes,
+                       FirstRefresh);
+    }
+
+    return match;
+}
+
+//*****************************************************************************
+//
+// GetSimulatedTicks()
+//
+// The LPFNGETTICKS of the refresh cases, Context is the clock.
+//
+//*****************************************************************************
+
+ULONG
+GetSimulatedTicks (
+    PVOID   Context
+)
+{
+    return *(PULONG)Context;
+}
+
+//*****************************************************************************
+//
+// BuildSyntheticDevice()
+//
+// Returns the info of a connected full speed device with one configuration
+// of NumInterfaces interfaces, each with NumEndpoints bulk endpoints, and
+// no strings.  Free it with FreeDeviceInfo().
+//
+//*****************************************************************************
+
+PUSBDEVICEINFO
+BuildSyntheticDevice (
+    ULONG   NumInterfaces,
+    ULONG   NumEndpoints
+)
+{
+    PUSBDEVICEINFO                  info;
+    PUSB_CONFIGURATION_DESCRIPTOR   configDesc;
+    PUSB_INTERFACE_DESCRIPTOR       interfaceDesc;
+    PUSB_ENDPOINT_DESCRIPTOR        endpointDesc;
+    PUCHAR                          next;
+    ULONG                           totalLength;
+    ULONG                           i;
+    ULONG                           j;
+
+    totalLength = sizeof(USB_CONFIGURATION_DESCRIPTOR) +
+                  NumInterfaces * (sizeof(USB_INTERFACE_DESCRIPTOR) +
+                                   NumEndpoints * sizeof(USB_ENDPOINT_DESCRIPTOR));
+
+    info = (PUSBDEVICEINFO)ALLOC(sizeof(USBDEVICEINFO));
+
+    if (info == NULL)
+    {
+        OOPS();
+        return NULL;
+    }
+
+    info->DeviceInfoType = DeviceInfo;
+
+    info->ConnectionInfo = (PUSB_NODE_CONNECTION_INFORMATION_EX)
+        ALLOC(sizeof(USB_NODE_CONNECTION_INFORMATION_EX));
+
+    info->ConfigDesc = (PUSB_DESCRIPTOR_REQUEST)
+        ALLOC(sizeof(USB_DESCRIPTOR_REQUEST) + totalLength);
+
+    if (info->ConnectionInfo == NULL || info->ConfigDesc == NULL)
+    {
+        OOPS();
+        FreeDeviceInfo(info);
+        return NULL;
+    }
+
+    info->ConnectionInfo->ConnectionIndex = 1;
+    info->ConnectionInfo->ConnectionStatus = DeviceConnected;
+    info->ConnectionInfo->Speed = UsbFullSpeed;
+    info->ConnectionInfo->DeviceAddress = 1;
+    info->ConnectionInfo->CurrentConfigurationValue = 1;
+
+    info->ConnectionInfo->DeviceDescriptor.bLength =
+        sizeof(USB_DEVICE_DESCRIPTOR);
+    info->ConnectionInfo->DeviceDescriptor.bDescriptorType =
+        USB_DEVICE_DESCRIPTOR_TYPE;
+    info->ConnectionInfo->DeviceDescriptor.bcdUSB = 0x0200;
+    info->ConnectionInfo->DeviceDescriptor.bMaxPacketSize0 = 64;
+    info->ConnectionInfo->DeviceDescriptor.idVendor = 0x045E;
+    info->ConnectionInfo->DeviceDescriptor.idProduct = 0x0001;
+    info->ConnectionInfo->DeviceDescriptor.bNumConfigurations = 1;
+
+    configDesc = (PUSB_CONFIGURATION_DESCRIPTOR)(info->ConfigDesc + 1);
+
+    configDesc->bLength = sizeof(USB_CONFIGURATION_DESCRIPTOR);
+    configDesc->bDescriptorType = USB_CONFIGURATION_DESCRIPTOR_TYPE;
+    configDesc->wTotalLength = (USHORT)totalLength;
+    configDesc->bNumInterfaces = (UCHAR)NumInterfaces;
+    configDesc->bConfigurationValue = 1;
+    configDesc->bmAttributes = 0x80;
+    configDesc->MaxPower = 50;
+
+    next = (PUCHAR)(configDesc + 1);
+
+    for (i = 0; i < NumInterfaces; i++)
+    {
+        interfaceDesc = (PUSB_INTERFACE_DESCRIPTOR)next;
+
+        interfaceDesc->bLength = sizeof(USB_INTERFACE_DESCRIPTOR);
+        interfaceDesc->bDescriptorType = USB_INTERFACE_DESCRIPTOR_TYPE;
+        interfaceDesc->bInterfaceNumber = (UCHAR)i;
+        interfaceDesc->bNumEndpoints = (UCHAR)NumEndpoints;
+        interfaceDesc->bInterfaceClass = 0xFF;
+
+        next += sizeof(USB_INTERFACE_DESCRIPTOR);
+
+        for (j = 0; j < NumEndpoints; j++)
+        {
+            endpointDesc = (PUSB_ENDPOINT_DESCRIPTOR)next;
+
+            endpointDesc->bLength = sizeof(USB_ENDPOINT_DESCRIPTOR);
+            endpointDesc->bDescriptorType = USB_ENDPOINT_DESCRIPTOR_TYPE;
+            endpointDesc->bEndpointAddress = (UCHAR)(((j & 1) ? 0x80 : 0x00) |
+                                                     (j / 2 + 1));
+            endpointDesc->bmAttributes = USB_ENDPOINT_TYPE_BULK;
+            endpointDesc->wMaxPacketSize = 64;
+
+            next += sizeof(USB_ENDPOINT_DESCRIPTOR);
+        }
+    }
+
+    if (!IndexConfigDesc(&info->ConfigDesc))
+    {
+        FreeDeviceInfo(info);
+        return NULL;
+    }
+
+    return info;
+}
+
+//*****************************************************************************
+//
+// BuildSyntheticTree()
+//
+// Root - Gets host controllers with a root hub each, and below those hubs
+// of DIFF_BENCH_PORTS ports, breadth first, until there are about NumNodes
+// nodes.  The nodes have no Info.
+//
+// Differences, NewTree - With Differences, the old and the new tree are
+// made to differ as DIFF_BENCH_REMOVED() and so on say.
+//
+//*****************************************************************************
+
+VOID
+BuildSyntheticTree (
+    PUSBTREENODE    Root,
+    ULONG           NumNodes,
+    BOOL            Differences,
+    BOOL            NewTree
+)
+{
+    PUSBTREENODE    hubs[DIFF_BENCH_NODES];
+    PUSBTREENODE    node;
+    ULONG           numHubs;
+    ULONG           nextHub;
+    ULONG           numNodes;
+    ULONG           numPorts;
+    ULONG           port;
+    ULONG           i;
+    TCHAR           text[64];
+
+    numHubs = 0;
+    numNodes = 0;
+    numPorts = 0;
+
+    for (i = 0; i < sizeof(SyntheticDriverKeys) / sizeof(SyntheticDriverKeys[0]); i++)
+    {
+        node = AddTreeNode(Root, NULL, SyntheticDriverKeys[i], GoodDeviceIcon);
+
+        if (node == NULL)
+        {
+            return;
+        }
+
+        node->Key = SyntheticDriverKeys[i];
+
+        node = AddTreeNode(node, NULL, _T("RootHub"), HubIcon);
+
+        if (node == NULL)
+        {
+            return;
+        }
+
+        hubs[numHubs++] = node;
+        numNodes += 2;
+    }
+
+    for (nextHub = 0; nextHub < numHubs && numNodes < NumNodes; nextHub++)
+    {
+        for (port = 1; port <= DIFF_BENCH_PORTS && numNodes < NumNodes; port++)
+        {
+            numPorts++;
+            numNodes++;
+
+            // Only devices come and go, so both trees have the same hubs
+            //
+            if (Differences &&
+                port >= DIFF_BENCH_HUB_PORT &&
+                ((DIFF_BENCH_REMOVED(numPorts) && NewTree) ||
+                 (DIFF_BENCH_INSERTED(numPorts) && !NewTree)))
+            {
+                continue;
+            }
+
+            _stprintf_s(text, sizeof(text)/sizeof(text[0]),
+                        _T("[Port%d] DeviceConnected :  Device %u%s"),
+                        port,
+                        numPorts,
+                        Differences && NewTree && DIFF_BENCH_CHANGED(numPorts) ?
+                            _T(" (changed)") : _T(""));
+
+            node = AddTreeNode(hubs[nextHub],
+                               NULL,
+                               text,
+                               port < DIFF_BENCH_HUB_PORT ? HubIcon : GoodDeviceIcon);
+
+            if (node == NULL)
+            {
+                return;
+            }
+
+            node->Id = port;
+
+            if (port < DIFF_BENCH_HUB_PORT && numHubs < DIFF_BENCH_NODES)
+            {
+                hubs[numHubs++] = node;
+            }
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// BuildSyntheticSnapshot()
+//
+// Snapshot - Gets host controllers with a root hub each, and NumDevices
+// synthetic devices spread over the ports of those hubs, all with their
+// Info as enumeration would have built it.  Free it with FreeTreeNodes().
+//
+//*****************************************************************************
+
+BOOL
+BuildSyntheticSnapshot (
+    PUSB_SNAPSHOT   Snapshot,
+    ULONG           NumDevices
+)
+{
+    PUSBTREENODE            hubs[sizeof(SyntheticDriverKeys) / sizeof(SyntheticDriverKeys[0])];
+    PUSBTREENODE            node;
+    PUSBHOSTCONTROLLERINFO  hcInfo;
+    PUSBROOTHUBINFO         hubInfo;
+    PUSBDEVICEINFO          info;
+    ULONG                   numHubs;
+    ULONG                   numPorts;
+    ULONG                   device;
+    ULONG                   i;
+    TCHAR                   text[64];
+
+    memset(Snapshot, 0, sizeof(USB_SNAPSHOT));
+
+    numHubs = sizeof(SyntheticDriverKeys) / sizeof(SyntheticDriverKeys[0]);
+    numPorts = (NumDevices + numHubs - 1) / numHubs;
+
+    for (i = 0; i < numHubs; i++)
+    {
+        hcInfo = (PUSBHOSTCONTROLLERINFO)ALLOC(sizeof(USBHOSTCONTROLLERINFO));
+        hubInfo = (PUSBROOTHUBINFO)ALLOC(sizeof(USBROOTHUBINFO));
+
+        if (hcInfo != NULL)
+        {
+            hcInfo->DeviceInfoType = HostControllerInfo;
+            hcInfo->DriverKey = (PTSTR)ALLOC((ULONG)(_tcslen(SyntheticDriverKeys[i]) + 1) * sizeof(TCHAR));
+            hcInfo->VendorID = 0x8086;
+            hcInfo->DeviceID = 0x293A;
+            hcInfo->Revision = 2;
+        }
+
+        if (hubInfo != NULL)
+        {
+            hubInfo->DeviceInfoType = RootHubInfo;
+            hubInfo->HubInfo = (PUSB_NODE_INFORMATION)ALLOC(sizeof(USB_NODE_INFORMATION));
+        }
+
+        node = NULL;
+
+        if (hcInfo != NULL && hcInfo->DriverKey != NULL &&
+            hubInfo != NULL && hubInfo->HubInfo != NULL)
+        {
+            _tcscpy_s(hcInfo->DriverKey, _tcslen(SyntheticDriverKeys[i]) + 1,
+                      SyntheticDriverKeys[i]);
+
+            hubInfo->HubInfo->NodeType = UsbHub;
+            hubInfo->HubInfo->u.HubInformation.HubDescriptor.bNumberOfPorts =
+                (UCHAR)min(numPorts, 255);
+
+            node = AddTreeNode(&Snapshot->Root, hcInfo, hcInfo->DriverKey, GoodDeviceIcon);
+        }
+
+        if (node == NULL)
+        {
+            FreeDeviceInfo(hcInfo);
+            FreeDeviceInfo(hubInfo);
+            FreeTreeNodes(&Snapshot->Root, TRUE);
+            return FALSE;
+        }
+
+        node->Key = hcInfo->DriverKey;
+
+        hubs[i] = AddTreeNode(node, hubInfo, _T("RootHub"), HubIcon);
+
+        if (hubs[i] == NULL)
+        {
+            FreeDeviceInfo(hubInfo);
+            FreeTreeNodes(&Snapshot->Root, TRUE);
+            return FALSE;
+        }
+    }
+
+    for (device = 0; device < NumDevices; device++)
+    {
+        info = BuildSyntheticDevice(SERIAL_BENCH_INTERFACES,
+                                    RENDER_BENCH_ENDPOINTS);
+
+        if (info == NULL)
+        {
+            FreeTreeNodes(&Snapshot->Root, TRUE);
+            return FALSE;
+        }
+
+        info->ConnectionInfo->ConnectionIndex = device / numHubs + 1;
+
+        _stprintf_s(text, sizeof(text)/sizeof(text[0]),
+                    _T("[Port%d] DeviceConnected :  Device %u"),
+                    info->ConnectionInfo->ConnectionIndex,
+                    device);
+
+        node = AddTreeNode(hubs[device % numHubs], info, text, GoodDeviceIcon);
+
+        if (node == NULL)
+        {
+            FreeDeviceInfo(info);
+            FreeTreeNodes(&Snapshot->Root, TRUE);
+            return FALSE;
+        }
+
+        node->Id = info->ConnectionInfo->ConnectionIndex;
+
+        Snapshot->DevicesConnected++;
+    }
+
+    Snapshot->Hubs = numHubs;
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// InsertSyntheticNode(), RemoveSyntheticNode(), UpdateSyntheticNode()
+//
+// The tree diff callbacks for the benchmark, without any UI.
+//
+//*****************************************************************************
+
+BOOL
+InsertSyntheticNode (
+    PVOID           Context,
+    PUSBTREENODE    Parent,
+    PUSBTREENODE    After,
+    PUSBTREENODE    Node
+)
+{
+    UNREFERENCED_PARAMETER(Context);
+    UNREFERENCED_PARAMETER(Parent);
+    UNREFERENCED_PARAMETER(After);
+    UNREFERENCED_PARAMETER(Node);
+
+    return TRUE;
+}
+
+VOID
+RemoveSyntheticNode (
+    PVOID           Context,
+    PUSBTREENODE    Node
+)
+{
+    UNREFERENCED_PARAMETER(Context);
+
+    FreeTreeNodes(Node, TRUE);
+    FreeDeviceInfo(Node->Info);
+    Node->Info = NULL;
+}
+
+VOID
+UpdateSyntheticNode (
+    PVOID           Context,
+    PUSBTREENODE    Node,
+    PUSBTREENODE    NewNode,
+    BOOL            Changed
+)
+{
+    UNREFERENCED_PARAMETER(Context);
+    UNREFERENCED_PARAMETER(NewNode);
+    UNREFERENCED_PARAMETER(Changed);
+
+    FreeDeviceInfo(Node->Info);
+}
+
+//*****************************************************************************
+//
+// WriteBenchLine()
+//
+//*****************************************************************************
+
+BOOL
+WriteBenchLine (
+    HANDLE  hFile,
+    PCSTR   Format,
+    ...
+)
+{
+    CHAR    line[256];
+    DWORD   bytesWritten;
+    int     length;
+    va_list list;
+
+    va_start(list, Format);
+
+    length = _vsnprintf_s(line, sizeof(line), _TRUNCATE, Format, list);
+
+    va_end(list);
+
+    if (length < 0)
+    {
+        length = (int)strlen(line);
+    }
+
+    return WriteFile(hFile, line, length, &bytesWritten, NULL);
+}
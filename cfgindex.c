@@ -0,0 +1,260 @@
+/*++
+
+Copyright (c) 1997-1998 Microsoft Corporation
+
+Module Name:
+
+    CFGINDEX.C
+
+Abstract:
+
+    This source file contains the index of a Configuration Descriptor, see
+    CONFIG_DESC_INDEX in USBVIEW.H.  A Configuration Descriptor is parsed
+    once, right after it was fetched, and the index is appended to the same
+    allocation.  Everything that looks at the descriptors of a device later,
+    the string fetch and the detail view, goes by the index and never walks
+    or checks the raw bytes again.
+
+Environment:
+
+    user mode
+
+Revision History:
+
+    10-16-26 : created
+
+--*/
+
+//*****************************************************************************
+// I N C L U D E S
+//*****************************************************************************
+
+#include <windows.h>
+#include <basetyps.h>
+#include <winioctl.h>
+#include <string.h>
+#include <tchar.h>
+#include "usbview.h"
+
+//*****************************************************************************
+// D E F I N E S
+//*****************************************************************************
+
+// Where the index starts, after the descriptors
+//
+#define CONFIG_INDEX_OFFSET(ConfigDesc) \
+    ((sizeof(USB_DESCRIPTOR_REQUEST) + \
+      ((PUSB_CONFIGURATION_DESCRIPTOR)((ConfigDesc) + 1))->wTotalLength + \
+      sizeof(ULONG) - 1) & ~(sizeof(ULONG) - 1))
+
+//*****************************************************************************
+// L O C A L    F U N C T I O N    P R O T O T Y P E S
+//*****************************************************************************
+
+CONFIG_DESC_KIND
+ClassifyDescriptor (
+    PUSB_COMMON_DESCRIPTOR  CommonDesc
+);
+
+
+//*****************************************************************************
+//
+// IndexConfigDesc()
+//
+// ConfigDesc - Request holding a complete Configuration Descriptor, whose
+// wTotalLength must not change afterwards.  It is reallocated with the
+// index appended, and stays as it was if that fails.
+//
+// Returns FALSE if there was not enough memory.
+//
+//*****************************************************************************
+
+BOOL
+IndexConfigDesc (
+    PUSB_DESCRIPTOR_REQUEST *ConfigDesc
+)
+{
+    PUSB_DESCRIPTOR_REQUEST configDescReq;
+    PUCHAR                  descStart;
+    PUCHAR                  descEnd;
+    PUSB_COMMON_DESCRIPTOR  commonDesc;
+    PCONFIG_DESC_INDEX      index;
+    PCONFIG_DESC_ENTRY      entry;
+    ULONG                   numEntries;
+    ULONG                   indexOffset;
+    ULONG                   indexSize;
+    USHORT                  interfaceEntry;
+
+    configDescReq = *ConfigDesc;
+
+    descStart = (PUCHAR)(configDescReq + 1);
+    descEnd = descStart + ((PUSB_CONFIGURATION_DESCRIPTOR)descStart)->wTotalLength;
+
+    // Count the descriptors first, then fill in one entry for each
+    //
+    numEntries = 0;
+
+    for (commonDesc = (PUSB_COMMON_DESCRIPTOR)descStart;
+         (PUCHAR)commonDesc + sizeof(USB_COMMON_DESCRIPTOR) <= descEnd &&
+         commonDesc->bLength >= sizeof(USB_COMMON_DESCRIPTOR) &&
+         (PUCHAR)commonDesc + commonDesc->bLength <= descEnd;
+         commonDesc = (PUSB_COMMON_DESCRIPTOR)((PUCHAR)commonDesc + commonDesc->bLength))
+    {
+        numEntries++;
+    }
+
+    indexOffset = CONFIG_INDEX_OFFSET(configDescReq);
+    indexSize = sizeof(CONFIG_DESC_INDEX) + numEntries * sizeof(CONFIG_DESC_ENTRY);
+
+    configDescReq = (PUSB_DESCRIPTOR_REQUEST)REALLOC(configDescReq,
+                                                     indexOffset + indexSize);
+
+    if (configDescReq == NULL)
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    *ConfigDesc = configDescReq;
+
+    descStart = (PUCHAR)(configDescReq + 1);
+
+    index = (PCONFIG_DESC_INDEX)((PUCHAR)configDescReq + indexOffset);
+
+    memset(index, 0, indexSize);
+
+    index->Size = indexSize;
+    index->NumEntries = (USHORT)numEntries;
+
+    interfaceEntry = NO_CONFIG_ENTRY;
+
+    commonDesc = (PUSB_COMMON_DESCRIPTOR)descStart;
+
+    for (entry = index->Entries; entry < index->Entries + numEntries; entry++)
+    {
+        entry->Offset = (USHORT)((PUCHAR)commonDesc - descStart);
+        entry->Kind = (UCHAR)ClassifyDescriptor(commonDesc);
+
+        switch (entry->Kind)
+        {
+            case ConfigDescConfiguration:
+                if (((PUSB_CONFIGURATION_DESCRIPTOR)commonDesc)->iConfiguration)
+                {
+                    index->HasStrings = TRUE;
+                }
+                break;
+
+            case ConfigDescInterface:
+                interfaceEntry = (USHORT)(entry - index->Entries);
+                index->NumInterfaces++;
+
+                if (((PUSB_INTERFACE_DESCRIPTOR)commonDesc)->iInterface)
+                {
+                    index->HasStrings = TRUE;
+                }
+                break;
+
+            case ConfigDescEndpoint:
+                index->NumEndpoints++;
+                break;
+
+            case ConfigDescInvalid:
+                OOPS();
+                break;
+        }
+
+        // The Interface Descriptor itself belongs to the one before it, so
+        // a class specific descriptor is decoded in the right class
+        //
+        entry->InterfaceEntry = (entry->Kind == ConfigDescInterface) ?
+                                (USHORT)(entry - index->Entries) :
+                                interfaceEntry;
+
+        commonDesc = (PUSB_COMMON_DESCRIPTOR)((PUCHAR)commonDesc + commonDesc->bLength);
+    }
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// GetConfigDescIndex()
+//
+// Returns the index appended to ConfigDesc by IndexConfigDesc().
+//
+//*****************************************************************************
+
+PCONFIG_DESC_INDEX
+GetConfigDescIndex (
+    PUSB_DESCRIPTOR_REQUEST ConfigDesc
+)
+{
+    return (PCONFIG_DESC_INDEX)((PUCHAR)ConfigDesc + CONFIG_INDEX_OFFSET(ConfigDesc));
+}
+
+//*****************************************************************************
+//
+// GetConfigDescSize()
+//
+// Returns the size of the whole allocation, request, descriptors and index.
+//
+//*****************************************************************************
+
+ULONG
+GetConfigDescSize (
+    PUSB_DESCRIPTOR_REQUEST ConfigDesc
+)
+{
+    return CONFIG_INDEX_OFFSET(ConfigDesc) + GetConfigDescIndex(ConfigDesc)->Size;
+}
+
+//*****************************************************************************
+//
+// ClassifyDescriptor()
+//
+// Returns what a descriptor of the configuration is, after checking that
+// a standard descriptor has its proper length.
+//
+//*****************************************************************************
+
+CONFIG_DESC_KIND
+ClassifyDescriptor (
+    PUSB_COMMON_DESCRIPTOR  CommonDesc
+)
+{
+    switch (CommonDesc->bDescriptorType)
+    {
+        case USB_CONFIGURATION_DESCRIPTOR_TYPE:
+            if (CommonDesc->bLength != sizeof(USB_CONFIGURATION_DESCRIPTOR))
+            {
+                return ConfigDescInvalid;
+            }
+            return ConfigDescConfiguration;
+
+        case USB_INTERFACE_DESCRIPTOR_TYPE:
+            if (CommonDesc->bLength != sizeof(USB_INTERFACE_DESCRIPTOR) &&
+                CommonDesc->bLength != sizeof(USB_INTERFACE_DESCRIPTOR2))
+            {
+                return ConfigDescInvalid;
+            }
+            return ConfigDescInterface;
+
+        case USB_ENDPOINT_DESCRIPTOR_TYPE:
+            if (CommonDesc->bLength != sizeof(USB_ENDPOINT_DESCRIPTOR) &&
+                CommonDesc->bLength != sizeof(USB_ENDPOINT_DESCRIPTOR2))
+            {
+                return ConfigDescInvalid;
+            }
+            return ConfigDescEndpoint;
+
+        case USB_HID_DESCRIPTOR_TYPE:
+            if (CommonDesc->bLength < sizeof(USB_HID_DESCRIPTOR))
+            {
+                return ConfigDescInvalid;
+            }
+            return ConfigDescHid;
+
+        default:
+            return ConfigDescOther;
+    }
+}
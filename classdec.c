@@ -0,0 +1,240 @@
+/*++
+
+Copyright (c) 1997-1998 Microsoft Corporation
+
+Module Name:
+
+    CLASSDEC.C
+
+Abstract:
+
+    This source file contains the registry of decoders for class specific
+    descriptors, see CLASS_DESC_DECODER in USBVIEW.H.  The tables of the
+    display modules are hashed once at startup by (interface class,
+    subclass, descriptor type, subtype), so that finding the decoder of a
+    descriptor takes at most four probes however many decoders there are.
+
+    A decoder may leave the subclass or the subtype open.  The most
+    specific decoder wins: an exact match first, then any subtype, then
+    any subclass, then both.
+
+Environment:
+
+    user mode
+
+Revision History:
+
+    10-16-26 : created
+
+--*/
+
+//*****************************************************************************
+// I N C L U D E S
+//*****************************************************************************
+
+#include <windows.h>
+#include <basetyps.h>
+#include <winioctl.h>
+#include <string.h>
+#include <tchar.h>
+#include "usbview.h"
+
+//*****************************************************************************
+// D E F I N E S
+//*****************************************************************************
+
+#define CLASS_DECODER_BITS      8
+#define CLASS_DECODER_SLOTS     (1 << CLASS_DECODER_BITS)   // at least twice the decoders
+
+#define ANY_SUBCLASS            0x01
+#define ANY_SUBTYPE             0x02
+
+#define CLASS_DESC_KEY(Class, SubClass, Type, Subtype) \
+    (((ULONG)(Class) << 24) | ((ULONG)(SubClass) << 16) | \
+     ((ULONG)(Type) << 8) | (ULONG)(Subtype))
+
+//*****************************************************************************
+// T Y P E D E F S
+//*****************************************************************************
+
+typedef struct _CLASS_DECODER_SLOT
+{
+    ULONG                   Key;        // wildcard fields are 0
+    UCHAR                   Any;        // ANY_SUBCLASS, ANY_SUBTYPE
+    LPFNDISPLAYCLASSDESC    Display;    // NULL if the slot is free
+} CLASS_DECODER_SLOT, *PCLASS_DECODER_SLOT;
+
+//*****************************************************************************
+// L O C A L    F U N C T I O N    P R O T O T Y P E S
+//*****************************************************************************
+
+PCLASS_DECODER_SLOT
+FindClassDecoderSlot (
+    ULONG   Key,
+    UCHAR   Any
+);
+
+//*****************************************************************************
+// G L O B A L S    P R I V A T E    T O    T H I S    F I L E
+//*****************************************************************************
+
+PCLASS_DESC_DECODER ClassDecoderTables[] =
+{
+    AudioClassDecoders,
+    CdcClassDecoders,
+    VideoClassDecoders,
+    StorageClassDecoders,
+    HubClassDecoders
+};
+
+CLASS_DECODER_SLOT  ClassDecoderSlots[CLASS_DECODER_SLOTS];
+
+
+//*****************************************************************************
+//
+// BuildClassDecoders()
+//
+// Hashes the decoder tables, called once before anything is displayed.
+//
+//*****************************************************************************
+
+VOID
+BuildClassDecoders (
+    VOID
+)
+{
+    PCLASS_DESC_DECODER decoder;
+    PCLASS_DECODER_SLOT slot;
+    ULONG               key;
+    UCHAR               any;
+    ULONG               i;
+
+    memset(ClassDecoderSlots, 0, sizeof(ClassDecoderSlots));
+
+    for (i = 0; i < sizeof(ClassDecoderTables) / sizeof(ClassDecoderTables[0]); i++)
+    {
+        for (decoder = ClassDecoderTables[i]; decoder->Display != NULL; decoder++)
+        {
+            any = 0;
+
+            if (decoder->InterfaceSubClass == CLASS_DESC_ANY)
+            {
+                any |= ANY_SUBCLASS;
+            }
+
+            if (decoder->DescriptorSubtype == CLASS_DESC_ANY)
+            {
+                any |= ANY_SUBTYPE;
+            }
+
+            key = CLASS_DESC_KEY(decoder->InterfaceClass,
+                                 (any & ANY_SUBCLASS) ? 0 : decoder->InterfaceSubClass,
+                                 decoder->DescriptorType,
+                                 (any & ANY_SUBTYPE) ? 0 : decoder->DescriptorSubtype);
+
+            slot = FindClassDecoderSlot(key, any);
+
+            // A full table or a decoder registered twice is a bug in the
+            // tables, the first one is kept
+            //
+            if (slot == NULL || slot->Display != NULL)
+            {
+                OOPS();
+                continue;
+            }
+
+            slot->Key = key;
+            slot->Any = any;
+            slot->Display = decoder->Display;
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// DisplayClassDescriptor()
+//
+// CommonDesc - A descriptor following the Interface Descriptor of
+// InterfaceDesc which is not one of the standard ones.
+//
+// Returns FALSE if there is no decoder for the descriptor, or the decoder
+// found it to be bad.  Nothing was displayed then.
+//
+//*****************************************************************************
+
+BOOL
+DisplayClassDescriptor (
+    PUSB_COMMON_DESCRIPTOR      CommonDesc,
+    PUSB_INTERFACE_DESCRIPTOR   InterfaceDesc
+)
+{
+    static const UCHAR  anyOrder[] = {0, ANY_SUBTYPE, ANY_SUBCLASS, ANY_SUBCLASS | ANY_SUBTYPE};
+    PCLASS_DECODER_SLOT slot;
+    UCHAR               subtype;
+    UCHAR               any;
+    ULONG               i;
+
+    // A descriptor too short for a subtype only matches decoders taking
+    // any subtype
+    //
+    subtype = CommonDesc->bLength > 2 ? ((PUCHAR)CommonDesc)[2] : 0;
+
+    for (i = 0; i < sizeof(anyOrder) / sizeof(anyOrder[0]); i++)
+    {
+        any = anyOrder[i];
+
+        if (CommonDesc->bLength <= 2 && !(any & ANY_SUBTYPE))
+        {
+            continue;
+        }
+
+        slot = FindClassDecoderSlot(
+                   CLASS_DESC_KEY(InterfaceDesc->bInterfaceClass,
+                                  (any & ANY_SUBCLASS) ? 0 : InterfaceDesc->bInterfaceSubClass,
+                                  CommonDesc->bDescriptorType,
+                                  (any & ANY_SUBTYPE) ? 0 : subtype),
+                   any);
+
+        if (slot != NULL && slot->Display != NULL)
+        {
+            return slot->Display(CommonDesc);
+        }
+    }
+
+    return FALSE;
+}
+
+//*****************************************************************************
+//
+// FindClassDecoderSlot()
+//
+// Returns the slot holding Key and Any, or the free slot where they go, or
+// NULL if the table is full.
+//
+//*****************************************************************************
+
+PCLASS_DECODER_SLOT
+FindClassDecoderSlot (
+    ULONG   Key,
+    UCHAR   Any
+)
+{
+    PCLASS_DECODER_SLOT slot;
+    ULONG               hash;
+    ULONG               i;
+
+    hash = ((Key ^ ((ULONG)Any << 30)) * 0x9E3779B1) >> (32 - CLASS_DECODER_BITS);
+
+    for (i = 0; i < CLASS_DECODER_SLOTS; i++)
+    {
+        slot = &ClassDecoderSlots[(hash + i) & (CLASS_DECODER_SLOTS - 1)];
+
+        if (slot->Display == NULL ||
+            (slot->Key == Key && slot->Any == Any))
+        {
+            return slot;
+        }
+    }
+
+    return NULL;
+}
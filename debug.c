@@ -57,6 +57,58 @@ LIST_ENTRY AllocListHead =
     &AllocListHead
 };
 
+// Enumeration allocates from several threads, so the list needs a lock.
+// It is set up on first use, 0 = not yet, 1 = being set up, 2 = ready.
+//
+CRITICAL_SECTION AllocListLock;
+LONG             AllocListLockState;
+
+
+//*****************************************************************************
+//
+// LockAllocList()
+//
+//*****************************************************************************
+
+VOID
+LockAllocList (
+    VOID
+)
+{
+    if (AllocListLockState != 2)
+    {
+        if (InterlockedCompareExchange(&AllocListLockState, 1, 0) == 0)
+        {
+            InitializeCriticalSection(&AllocListLock);
+
+            InterlockedExchange(&AllocListLockState, 2);
+        }
+        else
+        {
+            while (AllocListLockState != 2)
+            {
+                Sleep(0);
+            }
+        }
+    }
+
+    EnterCriticalSection(&AllocListLock);
+}
+
+//*****************************************************************************
+//
+// UnlockAllocList()
+//
+//*****************************************************************************
+
+VOID
+UnlockAllocList (
+    VOID
+)
+{
+    LeaveCriticalSection(&AllocListLock);
+}
+
 
 //*****************************************************************************
 //
@@ -81,7 +133,9 @@ MyAlloc (
 
         if (header != NULL)
         {
+            LockAllocList();
             InsertTailList(&AllocListHead, &header->ListEntry);
+            UnlockAllocList();
 
             header->File = File;
             header->Line = Line;
@@ -116,7 +170,9 @@ MyReAlloc (
 
         // Remove the old address from the allocation list
         //
+        LockAllocList();
         RemoveEntryList(&header->ListEntry);
+        UnlockAllocList();
 
         headerNew = GlobalReAlloc((HGLOBAL)header, dwBytes, GMEM_MOVEABLE|GMEM_ZEROINIT);
 
@@ -124,7 +180,9 @@ MyReAlloc (
         {
             // Add the new address to the allocation list
             //
+            LockAllocList();
             InsertTailList(&AllocListHead, &headerNew->ListEntry);
+            UnlockAllocList();
 
             return (HGLOBAL)(headerNew + 1);
         }
@@ -134,7 +192,9 @@ MyReAlloc (
             // and the original handle and pointer are still valid.
             // Add the old address back to the allocation list.
             //
+            LockAllocList();
             InsertTailList(&AllocListHead, &header->ListEntry);
+            UnlockAllocList();
         }
 
     }
@@ -162,7 +222,9 @@ MyFree (
 
         header--;
 
+        LockAllocList();
         RemoveEntryList(&header->ListEntry);
+        UnlockAllocList();
 
         return GlobalFree((HGLOBAL)header);
     }
@@ -0,0 +1,679 @@
+/*++
+
+Copyright (c) 1997-1998 Microsoft Corporation
+
+Module Name:
+
+    DESCCACHE.C
+
+Abstract:
+
+    This source file contains the descriptor cache, which keeps what was
+    fetched for each connected device from one refresh to the next.
+
+    An entry is keyed by the name of the hub, the port, the Device
+    Descriptor and the DeviceAddress, all of which are in the connection
+    information the hub driver returns without any bus traffic.  A device
+    which is unplugged and plugged in again gets a new address, so its old
+    entry is not used.  Entries which were not used by a refresh are
+    dropped at its end.
+
+    The cache keeps its own copies of the driver key name, Configuration
+    Descriptor, String Descriptors, Device Qualifier Descriptor and
+    external hub name.  Callers get copies as well, which they own.  A
+    device found without a Device Qualifier Descriptor is not asked for
+    it again until it gets a new entry.
+
+Environment:
+
+    user mode
+
+Revision History:
+
+    10-16-26 : created
+
+--*/
+
+//*****************************************************************************
+// I N C L U D E S
+//*****************************************************************************
+
+#include <windows.h>
+#include <basetyps.h>
+#include <winioctl.h>
+#include <string.h>
+#include <tchar.h>
+#include "usbview.h"
+
+#if _MSC_VER >= 1200
+#pragma warning(push)
+#endif
+#pragma warning(disable:4200) // named type definition in parentheses
+
+//*****************************************************************************
+// D E F I N E S
+//*****************************************************************************
+
+#define DESC_CACHE_BUCKETS  256     // power of 2
+
+//*****************************************************************************
+// T Y P E D E F S
+//*****************************************************************************
+
+typedef struct _DESC_CACHE_ENTRY
+{
+    struct _DESC_CACHE_ENTRY   *Next;
+    ULONG                       Hash;
+    ULONG                       Generation;     // last refresh which used it
+    ULONG                       ConnectionIndex;
+    USHORT                      DeviceAddress;
+    USB_DEVICE_DESCRIPTOR       DeviceDescriptor;
+    PTSTR                       DriverKeyName;
+    PUSB_DESCRIPTOR_REQUEST     ConfigDesc;
+    PSTRING_DESCRIPTORS         StringDescs;
+    PUSB_DEVICE_QUALIFIER_DESCRIPTOR QualifierDesc;
+    PTSTR                       ExtHubName;
+    TCHAR                       HubName[0];
+} DESC_CACHE_ENTRY, *PDESC_CACHE_ENTRY;
+
+//*****************************************************************************
+// L O C A L    F U N C T I O N    P R O T O T Y P E S
+//*****************************************************************************
+
+ULONG
+HashDescriptorCacheKey (
+    PCTSTR                              HubName,
+    PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfo
+);
+
+PDESC_CACHE_ENTRY
+FindDescriptorCacheEntry (
+    PCTSTR                              HubName,
+    PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfo,
+    ULONG                               Hash
+);
+
+VOID
+FreeDescriptorCacheEntry (
+    PDESC_CACHE_ENTRY   Entry
+);
+
+PTSTR
+CopyCachedString (
+    __in_opt PCTSTR String
+);
+
+PUSB_DESCRIPTOR_REQUEST
+CopyConfigDesc (
+    __in_opt PUSB_DESCRIPTOR_REQUEST ConfigDesc
+);
+
+PUSB_DEVICE_QUALIFIER_DESCRIPTOR
+CopyQualifierDesc (
+    __in_opt PUSB_DEVICE_QUALIFIER_DESCRIPTOR QualifierDesc
+);
+
+//*****************************************************************************
+// G L O B A L S    P R I V A T E    T O    T H I S    F I L E
+//*****************************************************************************
+
+PDESC_CACHE_ENTRY   DescCacheBuckets[DESC_CACHE_BUCKETS];
+CRITICAL_SECTION    DescCacheLock;
+volatile LONG       DescCacheLockState;
+ULONG               DescCacheGeneration;
+
+
+//*****************************************************************************
+//
+// BeginDescriptorCacheRefresh()
+//
+// Called by EnumerateHostControllers() before it starts.
+//
+//*****************************************************************************
+
+VOID
+BeginDescriptorCacheRefresh (
+    VOID
+)
+{
+    InitLockOnce(&DescCacheLock, &DescCacheLockState);
+
+    EnterCriticalSection(&DescCacheLock);
+
+    DescCacheGeneration++;
+
+    LeaveCriticalSection(&DescCacheLock);
+}
+
+//*****************************************************************************
+//
+// EndDescriptorCacheRefresh()
+//
+// Drops the entries of devices the refresh that just finished did not
+// find again.  If another refresh began in the meantime, the entries are
+// only kept if that one found them, the others are simply fetched again.
+//
+//*****************************************************************************
+
+VOID
+EndDescriptorCacheRefresh (
+    VOID
+)
+{
+    PDESC_CACHE_ENTRY   *link;
+    PDESC_CACHE_ENTRY   entry;
+    ULONG               i;
+
+    EnterCriticalSection(&DescCacheLock);
+
+    for (i = 0; i < DESC_CACHE_BUCKETS; i++)
+    {
+        link = &DescCacheBuckets[i];
+
+        while ((entry = *link) != NULL)
+        {
+            if (entry->Generation != DescCacheGeneration)
+            {
+                *link = entry->Next;
+
+                FreeDescriptorCacheEntry(entry);
+            }
+            else
+            {
+                link = &entry->Next;
+            }
+        }
+    }
+
+    LeaveCriticalSection(&DescCacheLock);
+}
+
+//*****************************************************************************
+//
+// LookupDescriptorCache()
+//
+// HubName - Name of the hub the device is connected to, or NULL.
+//
+// ConnectionInfo - Connection information of the port, just fetched.
+//
+// NeedConfigDesc - Whether the entry is only good enough if it holds the
+// Configuration Descriptor.
+//
+// DriverKeyName, ConfigDesc, StringDescs, QualifierDesc, ExtHubName -
+// Receive copies of what was cached, which the caller owns.  Only set if
+// this returns TRUE.
+//
+// Counters - The hit or miss is counted in these.
+//
+// Returns TRUE on a hit, in which case none of these need to be fetched.
+//
+//*****************************************************************************
+
+BOOL
+LookupDescriptorCache (
+    __in_opt PCTSTR                     HubName,
+    PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfo,
+    BOOL                                NeedConfigDesc,
+    PTSTR                               *DriverKeyName,
+    PUSB_DESCRIPTOR_REQUEST             *ConfigDesc,
+    PSTRING_DESCRIPTORS                 *StringDescs,
+    PUSB_DEVICE_QUALIFIER_DESCRIPTOR    *QualifierDesc,
+    PTSTR                               *ExtHubName,
+    PENUM_COUNTERS                      Counters
+)
+{
+    PDESC_CACHE_ENTRY   entry;
+    PTSTR               driverKeyName;
+    PUSB_DESCRIPTOR_REQUEST configDesc;
+    PSTRING_DESCRIPTORS stringDescs;
+    PUSB_DEVICE_QUALIFIER_DESCRIPTOR qualifierDesc;
+    PTSTR               extHubName;
+    BOOL                hit;
+
+    if (HubName == NULL ||
+        DescCacheLockState != LOCK_READY ||
+        ConnectionInfo->ConnectionStatus != DeviceConnected)
+    {
+        return FALSE;
+    }
+
+    driverKeyName = NULL;
+    configDesc = NULL;
+    stringDescs = NULL;
+    qualifierDesc = NULL;
+    extHubName = NULL;
+
+    EnterCriticalSection(&DescCacheLock);
+
+    entry = FindDescriptorCacheEntry(HubName,
+                                     ConnectionInfo,
+                                     HashDescriptorCacheKey(HubName,
+                                                            ConnectionInfo));
+
+    hit = entry != NULL &&
+          entry->DriverKeyName != NULL &&
+          (entry->ConfigDesc != NULL || !NeedConfigDesc) &&
+          (entry->ExtHubName != NULL || !ConnectionInfo->DeviceIsHub);
+
+    if (hit)
+    {
+        entry->Generation = DescCacheGeneration;
+
+        driverKeyName = CopyCachedString(entry->DriverKeyName);
+        configDesc = CopyConfigDesc(entry->ConfigDesc);
+        stringDescs = CopyStringDescriptors(entry->StringDescs);
+        qualifierDesc = CopyQualifierDesc(entry->QualifierDesc);
+        extHubName = CopyCachedString(entry->ExtHubName);
+
+        // A copy which failed is simply fetched again
+        //
+        hit = driverKeyName != NULL &&
+              (configDesc != NULL || entry->ConfigDesc == NULL) &&
+              (stringDescs != NULL || entry->StringDescs == NULL) &&
+              (qualifierDesc != NULL || entry->QualifierDesc == NULL) &&
+              (extHubName != NULL || entry->ExtHubName == NULL);
+    }
+
+    LeaveCriticalSection(&DescCacheLock);
+
+    if (!hit)
+    {
+        InterlockedIncrement(&Counters->CacheMisses);
+
+        if (driverKeyName)
+        {
+            FREE(driverKeyName);
+        }
+
+        if (configDesc)
+        {
+            FREE(configDesc);
+        }
+
+        FreeStringDescriptors(stringDescs);
+
+        if (qualifierDesc)
+        {
+            FREE(qualifierDesc);
+        }
+
+        if (extHubName)
+        {
+            FREE(extHubName);
+        }
+
+        return FALSE;
+    }
+
+    InterlockedIncrement(&Counters->CacheHits);
+
+    *DriverKeyName = driverKeyName;
+    *ConfigDesc = configDesc;
+    *StringDescs = stringDescs;
+    *QualifierDesc = qualifierDesc;
+    *ExtHubName = extHubName;
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// UpdateDescriptorCache()
+//
+// HubName - Name of the hub the device is connected to, or NULL.
+//
+// ConnectionInfo - Connection information of the port.
+//
+// DriverKeyName, ConfigDesc, StringDescs, QualifierDesc, ExtHubName -
+// What was fetched for the device, any of which may be NULL.  They are
+// copied, the caller keeps them.  What is NULL leaves the cached copy, if
+// any, in place.
+//
+//*****************************************************************************
+
+VOID
+UpdateDescriptorCache (
+    __in_opt PCTSTR                     HubName,
+    PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfo,
+    __in_opt PCTSTR                     DriverKeyName,
+    __in_opt PUSB_DESCRIPTOR_REQUEST    ConfigDesc,
+    __in_opt PSTRING_DESCRIPTORS        StringDescs,
+    __in_opt PUSB_DEVICE_QUALIFIER_DESCRIPTOR QualifierDesc,
+    __in_opt PCTSTR                     ExtHubName
+)
+{
+    PDESC_CACHE_ENTRY   entry;
+    ULONG               hash;
+    size_t              hubNameLength;
+
+    if (HubName == NULL ||
+        DescCacheLockState != LOCK_READY ||
+        ConnectionInfo->ConnectionStatus != DeviceConnected)
+    {
+        return;
+    }
+
+    hash = HashDescriptorCacheKey(HubName, ConnectionInfo);
+
+    EnterCriticalSection(&DescCacheLock);
+
+    entry = FindDescriptorCacheEntry(HubName, ConnectionInfo, hash);
+
+    if (entry == NULL)
+    {
+        hubNameLength = _tcslen(HubName) + 1;
+
+        entry = (PDESC_CACHE_ENTRY)ALLOC(sizeof(DESC_CACHE_ENTRY) +
+                                         hubNameLength * sizeof(TCHAR));
+
+        if (entry == NULL)
+        {
+            OOPS();
+            LeaveCriticalSection(&DescCacheLock);
+            return;
+        }
+
+        entry->Hash = hash;
+        entry->ConnectionIndex = ConnectionInfo->ConnectionIndex;
+        entry->DeviceAddress = ConnectionInfo->DeviceAddress;
+        entry->DeviceDescriptor = ConnectionInfo->DeviceDescriptor;
+
+        _tcscpy_s(entry->HubName, hubNameLength, HubName);
+
+        entry->Next = DescCacheBuckets[hash & (DESC_CACHE_BUCKETS - 1)];
+        DescCacheBuckets[hash & (DESC_CACHE_BUCKETS - 1)] = entry;
+    }
+
+    entry->Generation = DescCacheGeneration;
+
+    if (DriverKeyName != NULL)
+    {
+        if (entry->DriverKeyName)
+        {
+            FREE(entry->DriverKeyName);
+        }
+        entry->DriverKeyName = CopyCachedString(DriverKeyName);
+    }
+
+    if (ConfigDesc != NULL)
+    {
+        if (entry->ConfigDesc)
+        {
+            FREE(entry->ConfigDesc);
+        }
+        entry->ConfigDesc = CopyConfigDesc(ConfigDesc);
+    }
+
+    if (StringDescs != NULL)
+    {
+        FreeStringDescriptors(entry->StringDescs);
+        entry->StringDescs = CopyStringDescriptors(StringDescs);
+    }
+
+    if (QualifierDesc != NULL)
+    {
+        if (entry->QualifierDesc)
+        {
+            FREE(entry->QualifierDesc);
+        }
+        entry->QualifierDesc = CopyQualifierDesc(QualifierDesc);
+    }
+
+    if (ExtHubName != NULL)
+    {
+        if (entry->ExtHubName)
+        {
+            FREE(entry->ExtHubName);
+        }
+        entry->ExtHubName = CopyCachedString(ExtHubName);
+    }
+
+    LeaveCriticalSection(&DescCacheLock);
+}
+
+//*****************************************************************************
+//
+// FreeDescriptorCache()
+//
+// Drops every entry, for a cold enumeration or before exiting.
+//
+//*****************************************************************************
+
+VOID
+FreeDescriptorCache (
+    VOID
+)
+{
+    PDESC_CACHE_ENTRY   entry;
+    ULONG               i;
+
+    if (DescCacheLockState != LOCK_READY)
+    {
+        return;
+    }
+
+    EnterCriticalSection(&DescCacheLock);
+
+    for (i = 0; i < DESC_CACHE_BUCKETS; i++)
+    {
+        while ((entry = DescCacheBuckets[i]) != NULL)
+        {
+            DescCacheBuckets[i] = entry->Next;
+
+            FreeDescriptorCacheEntry(entry);
+        }
+    }
+
+    LeaveCriticalSection(&DescCacheLock);
+}
+
+//*****************************************************************************
+//
+// HashDescriptorCacheKey()
+//
+// FNV-1a over the hub name, port, address and Device Descriptor.
+//
+//*****************************************************************************
+
+ULONG
+HashDescriptorCacheKey (
+    PCTSTR                              HubName,
+    PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfo
+)
+{
+    ULONG   hash;
+    PUCHAR  bytes;
+    ULONG   i;
+
+    hash = 2166136261;
+
+    for (bytes = (PUCHAR)HubName; *HubName != 0; HubName++)
+    {
+        for (i = 0; i < sizeof(TCHAR); i++)
+        {
+            hash = (hash ^ *bytes++) * 16777619;
+        }
+    }
+
+    hash = (hash ^ ConnectionInfo->ConnectionIndex) * 16777619;
+    hash = (hash ^ ConnectionInfo->DeviceAddress) * 16777619;
+
+    bytes = (PUCHAR)&ConnectionInfo->DeviceDescriptor;
+
+    for (i = 0; i < sizeof(USB_DEVICE_DESCRIPTOR); i++)
+    {
+        hash = (hash ^ bytes[i]) * 16777619;
+    }
+
+    return hash;
+}
+
+//*****************************************************************************
+//
+// FindDescriptorCacheEntry()
+//
+// Called with DescCacheLock held.
+//
+//*****************************************************************************
+
+PDESC_CACHE_ENTRY
+FindDescriptorCacheEntry (
+    PCTSTR                              HubName,
+    PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfo,
+    ULONG                               Hash
+)
+{
+    PDESC_CACHE_ENTRY   entry;
+
+    for (entry = DescCacheBuckets[Hash & (DESC_CACHE_BUCKETS - 1)];
+         entry != NULL;
+         entry = entry->Next)
+    {
+        if (entry->Hash == Hash &&
+            entry->ConnectionIndex == ConnectionInfo->ConnectionIndex &&
+            entry->DeviceAddress == ConnectionInfo->DeviceAddress &&
+            memcmp(&entry->DeviceDescriptor,
+                   &ConnectionInfo->DeviceDescriptor,
+                   sizeof(USB_DEVICE_DESCRIPTOR)) == 0 &&
+            _tcscmp(entry->HubName, HubName) == 0)
+        {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+//*****************************************************************************
+//
+// FreeDescriptorCacheEntry()
+//
+//*****************************************************************************
+
+VOID
+FreeDescriptorCacheEntry (
+    PDESC_CACHE_ENTRY   Entry
+)
+{
+    if (Entry->DriverKeyName)
+    {
+        FREE(Entry->DriverKeyName);
+    }
+
+    if (Entry->ConfigDesc)
+    {
+        FREE(Entry->ConfigDesc);
+    }
+
+    FreeStringDescriptors(Entry->StringDescs);
+
+    if (Entry->QualifierDesc)
+    {
+        FREE(Entry->QualifierDesc);
+    }
+
+    if (Entry->ExtHubName)
+    {
+        FREE(Entry->ExtHubName);
+    }
+
+    FREE(Entry);
+}
+
+//*****************************************************************************
+//
+// CopyCachedString()
+//
+//*****************************************************************************
+
+PTSTR
+CopyCachedString (
+    __in_opt PCTSTR String
+)
+{
+    PTSTR   copy;
+    size_t  length;
+
+    if (String == NULL)
+    {
+        return NULL;
+    }
+
+    length = _tcslen(String) + 1;
+
+    copy = (PTSTR)ALLOC(length * sizeof(TCHAR));
+
+    if (copy != NULL)
+    {
+        _tcscpy_s(copy, length, String);
+    }
+
+    return copy;
+}
+
+//*****************************************************************************
+//
+// CopyConfigDesc()
+//
+// Copies a Configuration Descriptor request as GetConfigDescriptor()
+// returns it, the USB_DESCRIPTOR_REQUEST followed by wTotalLength bytes
+// and the index of the descriptors.
+//
+//*****************************************************************************
+
+PUSB_DESCRIPTOR_REQUEST
+CopyConfigDesc (
+    __in_opt PUSB_DESCRIPTOR_REQUEST ConfigDesc
+)
+{
+    PUSB_DESCRIPTOR_REQUEST copy;
+    ULONG                   size;
+
+    if (ConfigDesc == NULL)
+    {
+        return NULL;
+    }
+
+    size = GetConfigDescSize(ConfigDesc);
+
+    copy = (PUSB_DESCRIPTOR_REQUEST)ALLOC(size);
+
+    if (copy != NULL)
+    {
+        memcpy(copy, ConfigDesc, size);
+    }
+
+    return copy;
+}
+
+//*****************************************************************************
+//
+// CopyQualifierDesc()
+//
+//*****************************************************************************
+
+PUSB_DEVICE_QUALIFIER_DESCRIPTOR
+CopyQualifierDesc (
+    __in_opt PUSB_DEVICE_QUALIFIER_DESCRIPTOR QualifierDesc
+)
+{
+    PUSB_DEVICE_QUALIFIER_DESCRIPTOR copy;
+
+    if (QualifierDesc == NULL)
+    {
+        return NULL;
+    }
+
+    copy = (PUSB_DEVICE_QUALIFIER_DESCRIPTOR)ALLOC(sizeof(USB_DEVICE_QUALIFIER_DESCRIPTOR));
+
+    if (copy != NULL)
+    {
+        memcpy(copy, QualifierDesc, sizeof(USB_DEVICE_QUALIFIER_DESCRIPTOR));
+    }
+
+    return copy;
+}
+
+#if _MSC_VER >= 1200
+#pragma warning(pop)
+#endif
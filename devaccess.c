@@ -0,0 +1,816 @@
+/*++
+
+Copyright (c) 1997-1998 Microsoft Corporation
+
+Module Name:
+
+    DEVACCESS.C
+
+Abstract:
+
+    This source file contains the device access backend used by the
+    enumeration code.  Every call that enumeration makes into the USB stack
+    (CreateFile, DeviceIoControl, SetupDi) or into the configuration
+    manager (CM_Xxx) is routed through the currently selected backend, so
+    that a walk can be recorded to a trace file and replayed later without
+    the hardware being present.
+
+    The native backend defined here simply forwards to the system.  The
+    recording and replay backends live in DEVTRACE.C.
+
+Environment:
+
+    user mode
+
+Revision History:
+
+    10-16-26 : created
+
+--*/
+
+//*****************************************************************************
+// I N C L U D E S
+//*****************************************************************************
+
+#include <windows.h>
+#include <basetyps.h>
+#include <winioctl.h>
+#include <setupapi.h>
+#include <tchar.h>
+#include "usbview.h"
+
+#if _MSC_VER >= 1200
+#pragma warning(push)
+#endif
+#pragma warning(disable:4200) // named type definition in parentheses
+
+//*****************************************************************************
+// D E F I N E S
+//*****************************************************************************
+
+// Counts a call in the counters of the enumeration running on this
+// thread, if any.  A single expression, so that it can go anywhere a
+// statement can.
+//
+#define COUNT_BACKEND_CALL(Counter)                             \
+    CountBackendCall(BackendCounters != NULL ?                  \
+                     &BackendCounters->Counter : NULL)
+
+//*****************************************************************************
+// T Y P E D E F S
+//*****************************************************************************
+
+// A request completed later by CompleteEmulatedRequest()
+//
+typedef struct _EMULATED_COMPLETION
+{
+    LPOVERLAPPED    Overlapped;
+    DWORD           Status;
+    ULONG           DelayMs;
+} EMULATED_COMPLETION, *PEMULATED_COMPLETION;
+
+//*****************************************************************************
+// L O C A L    F U N C T I O N    P R O T O T Y P E S
+//*****************************************************************************
+
+VOID
+CountBackendCall (
+    __in_opt PLONG  Counter
+);
+
+HANDLE
+NativeOpenDevice (
+    PCTSTR  DevicePath,
+    DWORD   FlagsAndAttributes
+);
+
+BOOL
+NativeCloseDevice (
+    HANDLE  hDevice
+);
+
+BOOL
+NativeDeviceIoControl (
+    HANDLE          hDevice,
+    DWORD           IoControlCode,
+    PVOID           InBuffer,
+    DWORD           InBufferSize,
+    PVOID           OutBuffer,
+    DWORD           OutBufferSize,
+    PDWORD          BytesReturned,
+    LPOVERLAPPED    Overlapped
+);
+
+BOOL
+NativeGetOverlappedResult (
+    HANDLE          hDevice,
+    LPOVERLAPPED    Overlapped,
+    PDWORD          BytesReturned,
+    BOOL            Wait
+);
+
+BOOL
+NativeEnumInterfaces (
+    LPGUID                  InterfaceGuid,
+    LPFNINTERFACECALLBACK   Callback,
+    PVOID                   Context
+);
+
+CONFIGRET
+NativeLocateDevNode (
+    PDEVINST    DevInst
+);
+
+CONFIGRET
+NativeGetChild (
+    PDEVINST    DevInstChild,
+    DEVINST     DevInst
+);
+
+CONFIGRET
+NativeGetSibling (
+    PDEVINST    DevInstSibling,
+    DEVINST     DevInst
+);
+
+CONFIGRET
+NativeGetParent (
+    PDEVINST    DevInstParent,
+    DEVINST     DevInst
+);
+
+CONFIGRET
+NativeGetDevNodeProperty (
+    DEVINST     DevInst,
+    ULONG       Property,
+    PVOID       Buffer,
+    PULONG      Length
+);
+
+CONFIGRET
+NativeGetDeviceId (
+    DEVINST     DevInst,
+    PTSTR       Buffer,
+    ULONG       Length
+);
+
+//*****************************************************************************
+// G L O B A L S    P R I V A T E    T O    T H I S    F I L E
+//*****************************************************************************
+
+DEVICE_ACCESS_BACKEND NativeBackend =
+{
+    _T("Native"),
+    NativeOpenDevice,
+    NativeCloseDevice,
+    NativeDeviceIoControl,
+    NativeGetOverlappedResult,
+    NativeEnumInterfaces,
+    NativeLocateDevNode,
+    NativeGetChild,
+    NativeGetSibling,
+    NativeGetParent,
+    NativeGetDevNodeProperty,
+    NativeGetDeviceId
+};
+
+PDEVICE_ACCESS_BACKEND CurrentBackend = &NativeBackend;
+
+// Per thread, each thread works for one enumeration at a time
+//
+__declspec(thread) PENUM_COUNTERS BackendCounters;
+
+
+//*****************************************************************************
+//
+// GetNativeBackend()
+//
+//*****************************************************************************
+
+PDEVICE_ACCESS_BACKEND
+GetNativeBackend (
+    VOID
+)
+{
+    return &NativeBackend;
+}
+
+//*****************************************************************************
+//
+// GetDeviceBackend()
+//
+//*****************************************************************************
+
+PDEVICE_ACCESS_BACKEND
+GetDeviceBackend (
+    VOID
+)
+{
+    return CurrentBackend;
+}
+
+//*****************************************************************************
+//
+// SetDeviceBackend()
+//
+// Backend - The backend all further device access should go through, or
+// NULL to go back to the native backend.  Returns the previous backend.
+//
+// This must not be called while an enumeration is in progress.
+//
+//*****************************************************************************
+
+PDEVICE_ACCESS_BACKEND
+SetDeviceBackend (
+    PDEVICE_ACCESS_BACKEND Backend
+)
+{
+    PDEVICE_ACCESS_BACKEND previous;
+
+    previous = CurrentBackend;
+
+    CurrentBackend = (Backend != NULL) ? Backend : &NativeBackend;
+
+    return previous;
+}
+
+//*****************************************************************************
+//
+// SetBackendCounters()
+//
+// Counters - Where the calls made on this thread from now on are counted,
+// or NULL to not count them.  Returns the previous counters, which should
+// be put back once the calling work is done.
+//
+//*****************************************************************************
+
+PENUM_COUNTERS
+SetBackendCounters (
+    __in_opt PENUM_COUNTERS Counters
+)
+{
+    PENUM_COUNTERS previous;
+
+    previous = BackendCounters;
+
+    BackendCounters = Counters;
+
+    return previous;
+}
+
+//*****************************************************************************
+//
+// BackendOpenDevice() etc.
+//
+// Thin wrappers which dispatch to the current backend.  The enumeration
+// code calls these instead of the system routines.
+//
+//*****************************************************************************
+
+HANDLE
+BackendOpenDevice (
+    PCTSTR  DevicePath,
+    DWORD   FlagsAndAttributes
+)
+{
+    return CurrentBackend->OpenDevice(DevicePath, FlagsAndAttributes);
+}
+
+BOOL
+BackendCloseDevice (
+    HANDLE  hDevice
+)
+{
+    return CurrentBackend->CloseDevice(hDevice);
+}
+
+BOOL
+BackendDeviceIoControl (
+    HANDLE          hDevice,
+    DWORD           IoControlCode,
+    PVOID           InBuffer,
+    DWORD           InBufferSize,
+    PVOID           OutBuffer,
+    DWORD           OutBufferSize,
+    PDWORD          BytesReturned,
+    LPOVERLAPPED    Overlapped
+)
+{
+    COUNT_BACKEND_CALL(IoControls);
+
+    return CurrentBackend->IoControl(hDevice,
+                                     IoControlCode,
+                                     InBuffer,
+                                     InBufferSize,
+                                     OutBuffer,
+                                     OutBufferSize,
+                                     BytesReturned,
+                                     Overlapped);
+}
+
+BOOL
+BackendGetOverlappedResult (
+    HANDLE          hDevice,
+    LPOVERLAPPED    Overlapped,
+    PDWORD          BytesReturned,
+    BOOL            Wait
+)
+{
+    return CurrentBackend->OverlappedResult(hDevice,
+                                            Overlapped,
+                                            BytesReturned,
+                                            Wait);
+}
+
+BOOL
+BackendEnumInterfaces (
+    LPGUID                  InterfaceGuid,
+    LPFNINTERFACECALLBACK   Callback,
+    PVOID                   Context
+)
+{
+    return CurrentBackend->EnumInterfaces(InterfaceGuid, Callback, Context);
+}
+
+CONFIGRET
+BackendLocateDevNode (
+    PDEVINST    DevInst
+)
+{
+    COUNT_BACKEND_CALL(DevNodeCalls);
+
+    return CurrentBackend->LocateDevNode(DevInst);
+}
+
+CONFIGRET
+BackendGetChild (
+    PDEVINST    DevInstChild,
+    DEVINST     DevInst
+)
+{
+    COUNT_BACKEND_CALL(DevNodeCalls);
+
+    return CurrentBackend->GetChild(DevInstChild, DevInst);
+}
+
+CONFIGRET
+BackendGetSibling (
+    PDEVINST    DevInstSibling,
+    DEVINST     DevInst
+)
+{
+    COUNT_BACKEND_CALL(DevNodeCalls);
+
+    return CurrentBackend->GetSibling(DevInstSibling, DevInst);
+}
+
+CONFIGRET
+BackendGetParent (
+    PDEVINST    DevInstParent,
+    DEVINST     DevInst
+)
+{
+    COUNT_BACKEND_CALL(DevNodeCalls);
+
+    return CurrentBackend->GetParent(DevInstParent, DevInst);
+}
+
+CONFIGRET
+BackendGetDevNodeProperty (
+    DEVINST     DevInst,
+    ULONG       Property,
+    PVOID       Buffer,
+    PULONG      Length
+)
+{
+    COUNT_BACKEND_CALL(DevNodeCalls);
+
+    return CurrentBackend->GetDevNodeProperty(DevInst, Property, Buffer, Length);
+}
+
+CONFIGRET
+BackendGetDeviceId (
+    DEVINST     DevInst,
+    PTSTR       Buffer,
+    ULONG       Length
+)
+{
+    COUNT_BACKEND_CALL(DevNodeCalls);
+
+    return CurrentBackend->GetDeviceId(DevInst, Buffer, Length);
+}
+
+//*****************************************************************************
+//
+// CountBackendCall()
+//
+// Counter - In the counters of the enumeration running on this thread,
+// NULL if there is none.
+//
+//*****************************************************************************
+
+VOID
+CountBackendCall (
+    __in_opt PLONG  Counter
+)
+{
+    if (Counter != NULL)
+    {
+        InterlockedIncrement(Counter);
+    }
+}
+
+
+//*****************************************************************************
+//
+// NativeOpenDevice()
+//
+//*****************************************************************************
+
+HANDLE
+NativeOpenDevice (
+    PCTSTR  DevicePath,
+    DWORD   FlagsAndAttributes
+)
+{
+    return CreateFile(DevicePath,
+                      GENERIC_WRITE,
+                      FILE_SHARE_WRITE,
+                      NULL,
+                      OPEN_EXISTING,
+                      FlagsAndAttributes,
+                      NULL);
+}
+
+//*****************************************************************************
+//
+// NativeCloseDevice()
+//
+//*****************************************************************************
+
+BOOL
+NativeCloseDevice (
+    HANDLE  hDevice
+)
+{
+    return CloseHandle(hDevice);
+}
+
+//*****************************************************************************
+//
+// NativeDeviceIoControl()
+//
+//*****************************************************************************
+
+BOOL
+NativeDeviceIoControl (
+    HANDLE          hDevice,
+    DWORD           IoControlCode,
+    PVOID           InBuffer,
+    DWORD           InBufferSize,
+    PVOID           OutBuffer,
+    DWORD           OutBufferSize,
+    PDWORD          BytesReturned,
+    LPOVERLAPPED    Overlapped
+)
+{
+    return DeviceIoControl(hDevice,
+                           IoControlCode,
+                           InBuffer,
+                           InBufferSize,
+                           OutBuffer,
+                           OutBufferSize,
+                           BytesReturned,
+                           Overlapped);
+}
+
+//*****************************************************************************
+//
+// NativeGetOverlappedResult()
+//
+//*****************************************************************************
+
+BOOL
+NativeGetOverlappedResult (
+    HANDLE          hDevice,
+    LPOVERLAPPED    Overlapped,
+    PDWORD          BytesReturned,
+    BOOL            Wait
+)
+{
+    return GetOverlappedResult(hDevice,
+                               Overlapped,
+                               BytesReturned,
+                               Wait);
+}
+
+//*****************************************************************************
+//
+// NativeEnumInterfaces()
+//
+// InterfaceGuid - Device interface class to enumerate.
+//
+// Callback - Called with the device path of each present interface.  The
+// path is only valid for the duration of the call.  Returning FALSE stops
+// the enumeration.
+//
+//*****************************************************************************
+
+BOOL
+NativeEnumInterfaces (
+    LPGUID                  InterfaceGuid,
+    LPFNINTERFACECALLBACK   Callback,
+    PVOID                   Context
+)
+{
+    HDEVINFO                         deviceInfo;
+    SP_DEVICE_INTERFACE_DATA         deviceInfoData;
+    PSP_DEVICE_INTERFACE_DETAIL_DATA deviceDetailData;
+    ULONG                            index;
+    ULONG                            requiredLength;
+    BOOL                             keepGoing;
+
+    deviceInfo = SetupDiGetClassDevs(InterfaceGuid,
+                                     NULL,
+                                     NULL,
+                                     (DIGCF_PRESENT | DIGCF_DEVICEINTERFACE));
+
+    if (deviceInfo == INVALID_HANDLE_VALUE)
+    {
+        return FALSE;
+    }
+
+    deviceInfoData.cbSize = sizeof(SP_DEVICE_INTERFACE_DATA);
+
+    keepGoing = TRUE;
+
+    for (index=0;
+         keepGoing &&
+         SetupDiEnumDeviceInterfaces(deviceInfo,
+                                     0,
+                                     InterfaceGuid,
+                                     index,
+                                     &deviceInfoData);
+         index++)
+    {
+        SetupDiGetDeviceInterfaceDetail(deviceInfo,
+                                        &deviceInfoData,
+                                        NULL,
+                                        0,
+                                        &requiredLength,
+                                        NULL);
+
+        deviceDetailData = GlobalAlloc(GPTR, requiredLength);
+
+        if (deviceDetailData == NULL)
+        {
+            OOPS();
+            break;
+        }
+
+        deviceDetailData->cbSize = sizeof(SP_DEVICE_INTERFACE_DETAIL_DATA);
+
+        if (SetupDiGetDeviceInterfaceDetail(deviceInfo,
+                                            &deviceInfoData,
+                                            deviceDetailData,
+                                            requiredLength,
+                                            &requiredLength,
+                                            NULL))
+        {
+            keepGoing = (*Callback)(Context, deviceDetailData->DevicePath);
+        }
+
+        GlobalFree(deviceDetailData);
+    }
+
+    SetupDiDestroyDeviceInfoList(deviceInfo);
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// NativeLocateDevNode() etc.
+//
+//*****************************************************************************
+
+CONFIGRET
+NativeLocateDevNode (
+    PDEVINST    DevInst
+)
+{
+    return CM_Locate_DevNode(DevInst, NULL, 0);
+}
+
+CONFIGRET
+NativeGetChild (
+    PDEVINST    DevInstChild,
+    DEVINST     DevInst
+)
+{
+    return CM_Get_Child(DevInstChild, DevInst, 0);
+}
+
+CONFIGRET
+NativeGetSibling (
+    PDEVINST    DevInstSibling,
+    DEVINST     DevInst
+)
+{
+    return CM_Get_Sibling(DevInstSibling, DevInst, 0);
+}
+
+CONFIGRET
+NativeGetParent (
+    PDEVINST    DevInstParent,
+    DEVINST     DevInst
+)
+{
+    return CM_Get_Parent(DevInstParent, DevInst, 0);
+}
+
+CONFIGRET
+NativeGetDevNodeProperty (
+    DEVINST     DevInst,
+    ULONG       Property,
+    PVOID       Buffer,
+    PULONG      Length
+)
+{
+    return CM_Get_DevNode_Registry_Property(DevInst,
+                                            Property,
+                                            NULL,
+                                            Buffer,
+                                            Length,
+                                            0);
+}
+
+CONFIGRET
+NativeGetDeviceId (
+    DEVINST     DevInst,
+    PTSTR       Buffer,
+    ULONG       Length
+)
+{
+    return CM_Get_Device_ID(DevInst, Buffer, Length, 0);
+}
+
+
+//*****************************************************************************
+//
+// EmulatedCompletionRoutine()
+//
+// Thread pool routine which completes a request queued by
+// CompleteEmulatedRequest() once its latency has passed.
+//
+//*****************************************************************************
+
+DWORD WINAPI
+EmulatedCompletionRoutine (
+    LPVOID Context
+)
+{
+    PEMULATED_COMPLETION completion;
+
+    completion = (PEMULATED_COMPLETION)Context;
+
+    Sleep(completion->DelayMs);
+
+    completion->Overlapped->Internal = completion->Status;
+
+    if (completion->Overlapped->hEvent != NULL)
+    {
+        SetEvent(completion->Overlapped->hEvent);
+    }
+
+    FREE(completion);
+
+    return 0;
+}
+
+//*****************************************************************************
+//
+// CompleteEmulatedRequest()
+//
+// Completes a request for a backend which does not talk to a real device.
+// The response must already be in the caller's buffer.
+//
+// Overlapped - NULL for a synchronous request, which is simply delayed.
+// Otherwise the request completes DelayMs later on a thread pool thread
+// and ERROR_IO_PENDING is returned, so that overlapped callers see the
+// latency without being blocked by it.  Internal holds the Win32 error code
+// of the request, ERROR_IO_PENDING until it has completed.
+//
+// Returns the same way DeviceIoControl() does.
+//
+//*****************************************************************************
+
+BOOL
+CompleteEmulatedRequest (
+    LPOVERLAPPED    Overlapped,
+    BOOL            Success,
+    DWORD           LastError,
+    DWORD           BytesReturned,
+    ULONG           DelayMs
+)
+{
+    PEMULATED_COMPLETION completion;
+
+    if (Success)
+    {
+        LastError = ERROR_SUCCESS;
+    }
+
+    if (Overlapped != NULL)
+    {
+        Overlapped->InternalHigh = BytesReturned;
+
+        if (DelayMs != 0)
+        {
+            completion = (PEMULATED_COMPLETION)ALLOC(sizeof(EMULATED_COMPLETION));
+
+            if (completion != NULL)
+            {
+                completion->Overlapped = Overlapped;
+                completion->Status     = LastError;
+                completion->DelayMs    = DelayMs;
+
+                Overlapped->Internal = ERROR_IO_PENDING;
+
+                if (QueueUserWorkItem(EmulatedCompletionRoutine,
+                                      completion,
+                                      WT_EXECUTELONGFUNCTION))
+                {
+                    SetLastError(ERROR_IO_PENDING);
+                    return FALSE;
+                }
+
+                FREE(completion);
+            }
+
+            // Could not complete it later, complete it now instead
+            //
+            OOPS();
+        }
+    }
+
+    if (DelayMs != 0)
+    {
+        Sleep(DelayMs);
+    }
+
+    if (Overlapped != NULL)
+    {
+        Overlapped->Internal = LastError;
+
+        if (Overlapped->hEvent != NULL)
+        {
+            SetEvent(Overlapped->hEvent);
+        }
+    }
+
+    SetLastError(LastError);
+
+    return Success;
+}
+
+//*****************************************************************************
+//
+// GetEmulatedOverlappedResult()
+//
+// GetOverlappedResult() for requests completed by CompleteEmulatedRequest().
+//
+//*****************************************************************************
+
+BOOL
+GetEmulatedOverlappedResult (
+    LPOVERLAPPED    Overlapped,
+    PDWORD          BytesReturned,
+    BOOL            Wait
+)
+{
+    if (Overlapped->Internal == ERROR_IO_PENDING)
+    {
+        if (!Wait || Overlapped->hEvent == NULL)
+        {
+            SetLastError(ERROR_IO_INCOMPLETE);
+            return FALSE;
+        }
+
+        WaitForSingleObject(Overlapped->hEvent, INFINITE);
+    }
+
+    *BytesReturned = (DWORD)Overlapped->InternalHigh;
+
+    if (Overlapped->Internal != ERROR_SUCCESS)
+    {
+        SetLastError((DWORD)Overlapped->Internal);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+#if _MSC_VER >= 1200
+#pragma warning(pop)
+#endif
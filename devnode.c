@@ -6,6 +6,17 @@ Module Name:
 
     DEVNODE.C
 
+Abstract:
+
+    This source file finds the devnode of a driver key, for its Device
+    Description and Device ID.  The strings are returned in buffers of the
+    caller, so lookups may run on several threads at once.
+
+    Each enumeration walks the devnode tree once and indexes the devnodes
+    by driver key, so a lookup is a hash lookup and one config manager call
+    rather than a walk of the whole tree.  Lookups without an index walk
+    the tree as before.
+
 --*/
 
 //*****************************************************************************
@@ -14,45 +25,406 @@ Module Name:
 
 #include <windows.h>
 #include <basetyps.h>
+#include <winioctl.h>
 #include <cfgmgr32.h>
 
 #include <string.h>
 #include <tchar.h>
+#include "usbview.h"
+
+#if _MSC_VER >= 1200
+#pragma warning(push)
+#endif
+#pragma warning(disable:4200) // named type definition in parentheses
+
+//*****************************************************************************
+// D E F I N E S
+//*****************************************************************************
+
+#define DEVNODE_INDEX_BUCKETS   4096    // power of 2
+
+//*****************************************************************************
+// T Y P E D E F S
+//*****************************************************************************
+
+typedef struct _DEVNODE_INDEX_ENTRY
+{
+    struct _DEVNODE_INDEX_ENTRY    *Next;
+    ULONG                           Hash;
+    DEVINST                         DevInst;
+    TCHAR                           DriverKey[0];
+} DEVNODE_INDEX_ENTRY, *PDEVNODE_INDEX_ENTRY;
+
+typedef struct _DEVNODE_INDEX
+{
+    PDEVNODE_INDEX_ENTRY   *Buckets;    // DEVNODE_INDEX_BUCKETS of them
+    ULONG                   Entries;
+} DEVNODE_INDEX;
+
+//*****************************************************************************
+// L O C A L    F U N C T I O N    P R O T O T Y P E S
+//*****************************************************************************
+
+BOOL
+InitDevNodeIndex (
+    PDEVNODE_INDEX  Index
+);
+
+VOID
+CleanupDevNodeIndex (
+    PDEVNODE_INDEX  Index
+);
+
+BOOL
+LookupDevNodeIndex (
+    PDEVNODE_INDEX  Index,
+    __in PCTSTR     DriverName,
+    PDEVINST        DevInst
+);
+
+BOOL
+FindDevNode (
+    __in_opt PDEVNODE_INDEX Index,
+    __in PCTSTR             DriverName,
+    PDEVINST                DevInst
+);
+
+BOOL
+WalkDevNodes (
+    __in_opt PCTSTR         DriverName,
+    __in_opt PDEVINST       DevInst,
+    __in_opt PDEVNODE_INDEX Index
+);
+
+BOOL
+GetDevNodeStringFromDevInst (
+    DEVINST     DevInst,
+    BOOLEAN     DeviceId,
+    __out_ecount(Length) PTSTR Buffer,
+    ULONG       Length
+);
+
+ULONG
+HashDriverKey (
+    __in PCTSTR DriverKey
+);
+
+//*****************************************************************************
+//
+// GetDevNodeString()
+//
+// Index - Index built by BuildDevNodeIndex(), or NULL to walk the tree.
+//
+// Returns the Device Description, or the Device ID if DeviceId is TRUE, of
+// the DevNode with the matching DriverName in Buffer, which is Length
+// characters.  Returns FALSE, with Buffer empty, if there is no such
+// DevNode or it has no such string.
+//
+// Nothing is shared between callers, so this may be called on several
+// threads at once.
+//
+//*****************************************************************************
+
+BOOL
+GetDevNodeString (
+    __in_opt PDEVNODE_INDEX Index,
+    __in PCTSTR DriverName,
+    BOOLEAN     DeviceId,
+    __out_ecount(Length) PTSTR Buffer,
+    ULONG       Length
+)
+{
+    DEVINST devInst;
+
+    Buffer[0] = 0;
+
+    if (!FindDevNode(Index, DriverName, &devInst))
+    {
+        return FALSE;
+    }
+
+    return GetDevNodeStringFromDevInst(devInst, DeviceId, Buffer, Length);
+}
+
+//*****************************************************************************
+//
+// GetDevNodeStrings()
+//
+// Strings, Count - For each DriverKey, fills in Found and both the Device
+// Description and the Device ID of its DevNode.  Strings which could not
+// be read are left empty.
+//
+// Returns how many DevNodes were found.  Without an Index the tree is
+// walked once for the whole batch.  This may be called on several threads
+// at once, like GetDevNodeString().
+//
+//*****************************************************************************
+
+ULONG
+GetDevNodeStrings (
+    __in_opt PDEVNODE_INDEX Index,
+    __inout_ecount(Count) PDEVNODE_STRINGS Strings,
+    ULONG   Count
+)
+{
+    DEVNODE_INDEX   batchIndex;
+    PDEVNODE_INDEX  index;
+    DEVINST         devInst;
+    ULONG           found;
+    ULONG           i;
+
+    index = Index;
+    batchIndex.Buckets = NULL;
+
+    // A walk per DriverKey costs more than indexing the tree once
+    //
+    if (index == NULL && Count > 1)
+    {
+        if (InitDevNodeIndex(&batchIndex))
+        {
+            WalkDevNodes(NULL, NULL, &batchIndex);
+
+            index = &batchIndex;
+        }
+    }
+
+    found = 0;
+
+    for (i = 0; i < Count; i++)
+    {
+        Strings[i].DeviceDesc[0] = 0;
+        Strings[i].DeviceId[0] = 0;
+
+        Strings[i].Found = FindDevNode(index, Strings[i].DriverKey, &devInst);
+
+        if (Strings[i].Found)
+        {
+            GetDevNodeStringFromDevInst(devInst,
+                                        FALSE,
+                                        Strings[i].DeviceDesc,
+                                        sizeof(Strings[i].DeviceDesc) /
+                                        sizeof(Strings[i].DeviceDesc[0]));
+
+            GetDevNodeStringFromDevInst(devInst,
+                                        TRUE,
+                                        Strings[i].DeviceId,
+                                        sizeof(Strings[i].DeviceId) /
+                                        sizeof(Strings[i].DeviceId[0]));
+
+            found++;
+        }
+    }
+
+    CleanupDevNodeIndex(&batchIndex);
+
+    return found;
+}
+
+//*****************************************************************************
+//
+// BuildDevNodeIndex()
+//
+// Walks the devnode tree once and indexes every devnode which has a driver
+// key.  Called at the start of an enumeration, before any hub is queued.
+// Nothing changes the index afterwards, so it may be read on several
+// threads at once without a lock.  Returns NULL if it could not be built.
+//
+//*****************************************************************************
+
+PDEVNODE_INDEX
+BuildDevNodeIndex (
+    VOID
+)
+{
+    PDEVNODE_INDEX index;
+
+    index = (PDEVNODE_INDEX)ALLOC(sizeof(DEVNODE_INDEX));
+
+    if (index == NULL)
+    {
+        OOPS();
+        return NULL;
+    }
+
+    if (!InitDevNodeIndex(index))
+    {
+        FREE(index);
+        return NULL;
+    }
+
+    WalkDevNodes(NULL, NULL, index);
+
+    return index;
+}
+
+//*****************************************************************************
+//
+// FreeDevNodeIndex()
+//
+//*****************************************************************************
+
+VOID
+FreeDevNodeIndex (
+    __in_opt PDEVNODE_INDEX Index
+)
+{
+    if (Index != NULL)
+    {
+        CleanupDevNodeIndex(Index);
+
+        FREE(Index);
+    }
+}
+
+//*****************************************************************************
+//
+// InitDevNodeIndex()
+//
+//*****************************************************************************
+
+BOOL
+InitDevNodeIndex (
+    PDEVNODE_INDEX  Index
+)
+{
+    Index->Entries = 0;
+
+    Index->Buckets = (PDEVNODE_INDEX_ENTRY *)ALLOC(DEVNODE_INDEX_BUCKETS *
+                                                   sizeof(PDEVNODE_INDEX_ENTRY));
+
+    if (Index->Buckets == NULL)
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    return TRUE;
+}
 
 //*****************************************************************************
-// G L O B A L S
+//
+// CleanupDevNodeIndex()
+//
 //*****************************************************************************
 
-TCHAR buf[MAX_DEVICE_ID_LEN];  // (Dynamically size this instead?)
+VOID
+CleanupDevNodeIndex (
+    PDEVNODE_INDEX  Index
+)
+{
+    PDEVNODE_INDEX_ENTRY    entry;
+    ULONG                   i;
+
+    if (Index->Buckets == NULL)
+    {
+        return;
+    }
+
+    for (i = 0; i < DEVNODE_INDEX_BUCKETS; i++)
+    {
+        while ((entry = Index->Buckets[i]) != NULL)
+        {
+            Index->Buckets[i] = entry->Next;
+
+            FREE(entry);
+        }
+    }
+
+    FREE(Index->Buckets);
+
+    Index->Buckets = NULL;
+    Index->Entries = 0;
+}
 
 //*****************************************************************************
 //
-// DriverNameToDeviceDesc()
+// LookupDevNodeIndex()
 //
-// Returns the Device Description of the DevNode with the matching DriverName.
-// Returns NULL if the matching DevNode is not found.
+//*****************************************************************************
+
+BOOL
+LookupDevNodeIndex (
+    PDEVNODE_INDEX  Index,
+    __in PCTSTR     DriverName,
+    PDEVINST        DevInst
+)
+{
+    PDEVNODE_INDEX_ENTRY    entry;
+    ULONG                   hash;
+
+    hash = HashDriverKey(DriverName);
+
+    for (entry = Index->Buckets[hash & (DEVNODE_INDEX_BUCKETS - 1)];
+         entry != NULL;
+         entry = entry->Next)
+    {
+        if (entry->Hash == hash && _tcsicmp(DriverName, entry->DriverKey) == 0)
+        {
+            *DevInst = entry->DevInst;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+//*****************************************************************************
 //
-// The caller should copy the returned string buffer instead of just saving
-// the pointer value.  (Dynamically allocate return buffer instead?)
+// FindDevNode()
+//
+// Finds the devnode with the matching DriverName, in Index if there is
+// one.
 //
 //*****************************************************************************
 
-PTSTR DriverNameToDeviceDesc (__in PCTSTR DriverName, BOOLEAN DeviceId)
+BOOL
+FindDevNode (
+    __in_opt PDEVNODE_INDEX Index,
+    __in PCTSTR             DriverName,
+    PDEVINST                DevInst
+)
+{
+    if (Index == NULL)
+    {
+        return WalkDevNodes(DriverName, DevInst, NULL);
+    }
+
+    return LookupDevNodeIndex(Index, DriverName, DevInst);
+}
+
+//*****************************************************************************
+//
+// WalkDevNodes()
+//
+// DriverName - Driver key to look for, returning its devnode in DevInst.
+//
+// Index - If not NULL, every devnode with a driver key is added to it
+// instead and the walk goes on to the end.
+//
+//*****************************************************************************
+
+BOOL
+WalkDevNodes (
+    __in_opt PCTSTR         DriverName,
+    __in_opt PDEVINST       DevInst,
+    __in_opt PDEVNODE_INDEX Index
+)
 {
     DEVINST     devInst;
     DEVINST     devInstNext;
     CONFIGRET   cr;
     ULONG       walkDone = 0;
     ULONG       len;
+    size_t      keyLength;
+    PDEVNODE_INDEX_ENTRY entry;
+    TCHAR       driverKey[MAX_DEVICE_ID_LEN];
 
     // ȡ豸ڵ
-    cr = CM_Locate_DevNode(&devInst,
-                           NULL,
-                           0);
+    cr = BackendLocateDevNode(&devInst);
 
     if (cr != CR_SUCCESS)
     {
-        return NULL;
+        return FALSE;
     }
 
     // Do a depth first search for the DevNode with a matching
@@ -62,52 +434,48 @@ PTSTR DriverNameToDeviceDesc (__in PCTSTR DriverName, BOOLEAN DeviceId)
     {
         // Get the DriverName value
         //
-        len = sizeof(buf) / sizeof(buf[0]);
-        cr = CM_Get_DevNode_Registry_Property(devInst,
-                                              CM_DRP_DRIVER,
-                                              NULL,
-                                              buf,
-                                              &len,
-                                              0);
-
-        // If the DriverName value matches, return the DeviceDescription
-        //
-        if (cr == CR_SUCCESS && _tcsicmp(DriverName, buf) == 0)
+        len = sizeof(driverKey);
+        cr = BackendGetDevNodeProperty(devInst,
+                                       CM_DRP_DRIVER,
+                                       driverKey,
+                                       &len);
+
+        if (cr == CR_SUCCESS && Index != NULL)
         {
-            len = sizeof(buf) / sizeof(buf[0]);
+            keyLength = _tcslen(driverKey) + 1;
 
-            if (DeviceId)
-            {
-                cr = CM_Get_Device_ID(devInst,
-                                      buf,
-                                      len,
-                                      0);
-            }
-            else
-            {
-                cr = CM_Get_DevNode_Registry_Property(devInst,
-                                                      CM_DRP_DEVICEDESC,
-                                                      NULL,
-                                                      buf,
-                                                      &len,
-                                                      0);
-            }
+            entry = (PDEVNODE_INDEX_ENTRY)ALLOC(sizeof(DEVNODE_INDEX_ENTRY) +
+                                                keyLength * sizeof(TCHAR));
 
-            if (cr == CR_SUCCESS)
+            if (entry != NULL)
             {
-                return buf;
+                entry->Hash = HashDriverKey(driverKey);
+                entry->DevInst = devInst;
+                _tcscpy_s(entry->DriverKey, keyLength, driverKey);
+
+                entry->Next = Index->Buckets[entry->Hash & (DEVNODE_INDEX_BUCKETS - 1)];
+                Index->Buckets[entry->Hash & (DEVNODE_INDEX_BUCKETS - 1)] = entry;
+
+                Index->Entries++;
             }
             else
             {
-                return NULL;
+                OOPS();
             }
         }
 
+        // If the DriverName value matches, that is the DevNode
+        //
+        else if (cr == CR_SUCCESS && _tcsicmp(DriverName, driverKey) == 0)
+        {
+            *DevInst = devInst;
+            return TRUE;
+        }
+
         // This DevNode didn't match, go down a level to the first child.
         //
-        cr = CM_Get_Child(&devInstNext,
-                          devInst,
-                          0);
+        cr = BackendGetChild(&devInstNext,
+                             devInst);
 
         if (cr == CR_SUCCESS)
         {
@@ -122,9 +490,8 @@ PTSTR DriverNameToDeviceDesc (__in PCTSTR DriverName, BOOLEAN DeviceId)
         //
         for (;;)
         {
-            cr = CM_Get_Sibling(&devInstNext,
-                                devInst,
-                                0);
+            cr = BackendGetSibling(&devInstNext,
+                                   devInst);
 
             if (cr == CR_SUCCESS)
             {
@@ -132,9 +499,8 @@ PTSTR DriverNameToDeviceDesc (__in PCTSTR DriverName, BOOLEAN DeviceId)
                 break;
             }
 
-            cr = CM_Get_Parent(&devInstNext,
-                               devInst,
-                               0);
+            cr = BackendGetParent(&devInstNext,
+                                  devInst);
 
 
             if (cr == CR_SUCCESS)
@@ -149,6 +515,76 @@ PTSTR DriverNameToDeviceDesc (__in PCTSTR DriverName, BOOLEAN DeviceId)
         }
     }
 
-    return NULL;
+    return FALSE;
+}
+
+//*****************************************************************************
+//
+// GetDevNodeStringFromDevInst()
+//
+//*****************************************************************************
+
+BOOL
+GetDevNodeStringFromDevInst (
+    DEVINST     DevInst,
+    BOOLEAN     DeviceId,
+    __out_ecount(Length) PTSTR Buffer,
+    ULONG       Length
+)
+{
+    CONFIGRET   cr;
+    ULONG       len;
+
+    if (DeviceId)
+    {
+        cr = BackendGetDeviceId(DevInst,
+                                Buffer,
+                                Length);
+    }
+    else
+    {
+        len = Length * sizeof(TCHAR);
+
+        cr = BackendGetDevNodeProperty(DevInst,
+                                       CM_DRP_DEVICEDESC,
+                                       Buffer,
+                                       &len);
+    }
+
+    if (cr != CR_SUCCESS)
+    {
+        Buffer[0] = 0;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// HashDriverKey()
+//
+// FNV-1a, case insensitive as driver keys are compared with _tcsicmp().
+//
+//*****************************************************************************
+
+ULONG
+HashDriverKey (
+    __in PCTSTR DriverKey
+)
+{
+    ULONG hash;
+
+    hash = 2166136261;
+
+    for (; *DriverKey != 0; DriverKey++)
+    {
+        hash = (hash ^ (ULONG)_totupper(*DriverKey)) * 16777619;
+    }
+
+    return hash;
 }
 
+#if _MSC_VER >= 1200
+#pragma warning(pop)
+#endif
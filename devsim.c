@@ -0,0 +1,1205 @@
+/*++
+
+Copyright (c) 1997-1998 Microsoft Corporation
+
+Module Name:
+
+    DEVSIM.C
+
+Abstract:
+
+    This source file contains a device access backend which simulates a
+    USB topology, so that enumeration can be exercised and timed without
+    the hardware being present.
+
+    The simulated machine has a number of host controllers.  Every hub,
+    root or external, has SIM_PORTS ports.  The first SIM_HUB_PORTS ports
+    have an external hub attached until the requested depth is reached,
+    and a device after that.  The next port has a device attached and the
+    remaining ports are empty.  Every IOCTL takes the requested latency,
+    overlapped IOCTLs complete that much later without blocking the caller.
+
+Environment:
+
+    user mode
+
+Revision History:
+
+    10-16-26 : created
+
+--*/
+
+//*****************************************************************************
+// I N C L U D E S
+//*****************************************************************************
+
+#include <windows.h>
+#include <basetyps.h>
+#include <winioctl.h>
+#include <string.h>
+#include <stdio.h>
+#include <tchar.h>
+#include "usbview.h"
+
+#if _MSC_VER >= 1200
+#pragma warning(push)
+#endif
+#pragma warning(disable:4200) // named type definition in parentheses
+
+//*****************************************************************************
+// D E F I N E S
+//*****************************************************************************
+
+#define SIM_PORTS               4
+#define SIM_HUB_PORTS           2
+#define SIM_MAX_CONTROLLERS     64
+#define SIM_MAX_HUBS            4096
+
+#define SIM_HANDLE_SIGNATURE    0x4D495348  // 'HSIM'
+
+#define SIM_ROOT_DEVINST        1
+
+#define SIM_NO_HUB              ((ULONG)-1)
+
+//*****************************************************************************
+// T Y P E D E F S
+//*****************************************************************************
+
+typedef struct _SIM_HUB
+{
+    ULONG   Controller;
+    ULONG   Depth;
+    ULONG   ChildHub[SIM_PORTS];    // SIM_NO_HUB if not a hub
+} SIM_HUB, *PSIM_HUB;
+
+typedef struct _SIM_HANDLE
+{
+    ULONG   Signature;
+    BOOL    IsController;
+    ULONG   Index;                  // controller or hub index
+} SIM_HANDLE, *PSIM_HANDLE;
+
+//*****************************************************************************
+// L O C A L    F U N C T I O N    P R O T O T Y P E S
+//*****************************************************************************
+
+HANDLE
+SimOpenDevice (
+    PCTSTR  DevicePath,
+    DWORD   FlagsAndAttributes
+);
+
+BOOL
+SimCloseDevice (
+    HANDLE  hDevice
+);
+
+BOOL
+SimDeviceIoControl (
+    HANDLE          hDevice,
+    DWORD           IoControlCode,
+    PVOID           InBuffer,
+    DWORD           InBufferSize,
+    PVOID           OutBuffer,
+    DWORD           OutBufferSize,
+    PDWORD          BytesReturned,
+    LPOVERLAPPED    Overlapped
+);
+
+BOOL
+SimGetOverlappedResult (
+    HANDLE          hDevice,
+    LPOVERLAPPED    Overlapped,
+    PDWORD          BytesReturned,
+    BOOL            Wait
+);
+
+BOOL
+SimEnumInterfaces (
+    LPGUID                  InterfaceGuid,
+    LPFNINTERFACECALLBACK   Callback,
+    PVOID                   Context
+);
+
+CONFIGRET
+SimLocateDevNode (
+    PDEVINST    DevInst
+);
+
+CONFIGRET
+SimGetChild (
+    PDEVINST    DevInstChild,
+    DEVINST     DevInst
+);
+
+CONFIGRET
+SimGetSibling (
+    PDEVINST    DevInstSibling,
+    DEVINST     DevInst
+);
+
+CONFIGRET
+SimGetParent (
+    PDEVINST    DevInstParent,
+    DEVINST     DevInst
+);
+
+CONFIGRET
+SimGetDevNodeProperty (
+    DEVINST     DevInst,
+    ULONG       Property,
+    PVOID       Buffer,
+    PULONG      Length
+);
+
+CONFIGRET
+SimGetDeviceId (
+    DEVINST     DevInst,
+    PTSTR       Buffer,
+    ULONG       Length
+);
+
+//*****************************************************************************
+// G L O B A L S    P R I V A T E    T O    T H I S    F I L E
+//*****************************************************************************
+
+DEVICE_ACCESS_BACKEND SimBackend =
+{
+    _T("Simulation"),
+    SimOpenDevice,
+    SimCloseDevice,
+    SimDeviceIoControl,
+    SimGetOverlappedResult,
+    SimEnumInterfaces,
+    SimLocateDevNode,
+    SimGetChild,
+    SimGetSibling,
+    SimGetParent,
+    SimGetDevNodeProperty,
+    SimGetDeviceId
+};
+
+PDEVICE_ACCESS_BACKEND  SimPrevious;
+PSIM_HUB                SimHubs;
+ULONG                   SimNumHubs;
+ULONG                   SimNumControllers;
+ULONG                   SimLatency;
+
+
+//*****************************************************************************
+//
+// AddSimHub()
+//
+// Adds a hub and, recursively, the hubs below it.  Returns the index of the
+// new hub or SIM_NO_HUB if the table is full.
+//
+//*****************************************************************************
+
+ULONG
+AddSimHub (
+    ULONG   Controller,
+    ULONG   Depth,
+    ULONG   MaxDepth
+)
+{
+    ULONG hub;
+    ULONG port;
+
+    if (SimNumHubs == SIM_MAX_HUBS)
+    {
+        return SIM_NO_HUB;
+    }
+
+    hub = SimNumHubs++;
+
+    SimHubs[hub].Controller = Controller;
+    SimHubs[hub].Depth = Depth;
+
+    for (port = 0; port < SIM_PORTS; port++)
+    {
+        SimHubs[hub].ChildHub[port] = SIM_NO_HUB;
+
+        if (port < SIM_HUB_PORTS && Depth < MaxDepth)
+        {
+            SimHubs[hub].ChildHub[port] = AddSimHub(Controller,
+                                                    Depth + 1,
+                                                    MaxDepth);
+        }
+    }
+
+    return hub;
+}
+
+//*****************************************************************************
+//
+// StartSimulation()
+//
+// Controllers - Number of simulated host controllers.
+//
+// Depth - Levels of external hubs below each root hub.
+//
+// LatencyMs - Time every IOCTL takes.
+//
+//*****************************************************************************
+
+BOOL
+StartSimulation (
+    ULONG   Controllers,
+    ULONG   Depth,
+    ULONG   LatencyMs
+)
+{
+    ULONG i;
+
+    if (SimHubs != NULL || Controllers == 0)
+    {
+        return FALSE;
+    }
+
+    if (Controllers > SIM_MAX_CONTROLLERS)
+    {
+        Controllers = SIM_MAX_CONTROLLERS;
+    }
+
+    SimHubs = (PSIM_HUB)ALLOC(SIM_MAX_HUBS * sizeof(SIM_HUB));
+
+    if (SimHubs == NULL)
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    // The root hub of controller i is hub i, so build all root hubs first
+    // and then the external hubs below each of them.
+    //
+    SimNumHubs = Controllers;
+    SimNumControllers = Controllers;
+    SimLatency = LatencyMs;
+
+    for (i = 0; i < Controllers; i++)
+    {
+        ULONG port;
+
+        SimHubs[i].Controller = i;
+        SimHubs[i].Depth = 0;
+
+        for (port = 0; port < SIM_PORTS; port++)
+        {
+            SimHubs[i].ChildHub[port] = SIM_NO_HUB;
+
+            if (port < SIM_HUB_PORTS && Depth > 0)
+            {
+                SimHubs[i].ChildHub[port] = AddSimHub(i, 1, Depth);
+            }
+        }
+    }
+
+    SimPrevious = SetDeviceBackend(&SimBackend);
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// StopSimulation()
+//
+//*****************************************************************************
+
+VOID
+StopSimulation (
+    VOID
+)
+{
+    if (SimHubs == NULL)
+    {
+        return;
+    }
+
+    if (GetDeviceBackend() == &SimBackend)
+    {
+        SetDeviceBackend(SimPrevious);
+    }
+
+    FREE(SimHubs);
+
+    SimHubs = NULL;
+    SimNumHubs = 0;
+    SimNumControllers = 0;
+}
+
+//*****************************************************************************
+//
+// SimPortNumber()
+//
+// Returns a number unique to a hub port, used to name the device on it.
+//
+//*****************************************************************************
+
+ULONG
+SimPortNumber (
+    ULONG   Hub,
+    ULONG   ConnectionIndex
+)
+{
+    return Hub * SIM_PORTS + ConnectionIndex - 1;
+}
+
+//*****************************************************************************
+//
+// SimPortStatus()
+//
+// Every simulated hub has the same ports connected, Hub is only there for
+// a topology which would differ.
+//
+//*****************************************************************************
+
+USB_CONNECTION_STATUS
+SimPortStatus (
+    ULONG   Hub,
+    ULONG   ConnectionIndex
+)
+{
+    UNREFERENCED_PARAMETER(Hub);
+
+    return (ConnectionIndex <= SIM_HUB_PORTS + 1) ? DeviceConnected
+                                                  : NoDeviceConnected;
+}
+
+//*****************************************************************************
+//
+// SimReturnName()
+//
+// Fills in one of the IOCTL_USB_GET_XXX_NAME structures, which all end in
+// an ActualLength followed by the name.
+//
+// NameOffset - Offset of the name within the structure.
+//
+//*****************************************************************************
+
+BOOL
+SimReturnName (
+    PVOID   OutBuffer,
+    DWORD   OutBufferSize,
+    ULONG   NameOffset,
+    PCWSTR  Name,
+    PDWORD  BytesReturned
+)
+{
+    ULONG nameBytes;
+    ULONG copyBytes;
+
+    if (OutBufferSize < NameOffset + sizeof(WCHAR))
+    {
+        SetLastError(ERROR_INSUFFICIENT_BUFFER);
+        return FALSE;
+    }
+
+    nameBytes = (ULONG)(wcslen(Name) + 1) * sizeof(WCHAR);
+
+    *(PULONG)((PUCHAR)OutBuffer + NameOffset - sizeof(ULONG)) =
+        NameOffset + nameBytes;
+
+    copyBytes = min(nameBytes, OutBufferSize - NameOffset);
+
+    memcpy((PUCHAR)OutBuffer + NameOffset, Name, copyBytes);
+
+    *BytesReturned = NameOffset + copyBytes;
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// SimDeviceDescriptor()
+//
+//*****************************************************************************
+
+VOID
+SimDeviceDescriptor (
+    ULONG                   Hub,
+    ULONG                   ConnectionIndex,
+    PUSB_DEVICE_DESCRIPTOR  DeviceDesc
+)
+{
+    BOOL isHub;
+
+    isHub = SimHubs[Hub].ChildHub[ConnectionIndex - 1] != SIM_NO_HUB;
+
+    memset(DeviceDesc, 0, sizeof(USB_DEVICE_DESCRIPTOR));
+
+    DeviceDesc->bLength            = sizeof(USB_DEVICE_DESCRIPTOR);
+    DeviceDesc->bDescriptorType    = USB_DEVICE_DESCRIPTOR_TYPE;
+    DeviceDesc->bcdUSB             = 0x0200;
+    DeviceDesc->bDeviceClass       = isHub ? USB_DEVICE_CLASS_HUB : 0;
+    DeviceDesc->bMaxPacketSize0    = 64;
+    DeviceDesc->idVendor           = isHub ? 0x0451 : 0x045E;
+    DeviceDesc->idProduct          = (USHORT)(0x1000 +
+                                              SimPortNumber(Hub, ConnectionIndex));
+    DeviceDesc->bcdDevice          = 0x0100;
+    DeviceDesc->iManufacturer      = 1;
+    DeviceDesc->iProduct           = 2;
+    DeviceDesc->iSerialNumber      = 3;
+    DeviceDesc->bNumConfigurations = 1;
+}
+
+//*****************************************************************************
+//
+// SimGetDescriptor()
+//
+// Builds the descriptor asked for by Request in Buffer and returns its
+// length, or zero if there is no such descriptor.
+//
+//*****************************************************************************
+
+ULONG
+SimGetDescriptor (
+    ULONG                   Hub,
+    PUSB_DESCRIPTOR_REQUEST Request,
+    PUCHAR                  Buffer
+)
+{
+    UCHAR   descType;
+    UCHAR   descIndex;
+    BOOL    isHub;
+    WCHAR   string[64];
+    ULONG   length;
+
+    descType  = (UCHAR)(Request->SetupPacket.wValue >> 8);
+    descIndex = (UCHAR)(Request->SetupPacket.wValue & 0xFF);
+
+    isHub = SimHubs[Hub].ChildHub[Request->ConnectionIndex - 1] != SIM_NO_HUB;
+
+    switch (descType)
+    {
+        case USB_DEVICE_DESCRIPTOR_TYPE:
+
+            SimDeviceDescriptor(Hub,
+                                Request->ConnectionIndex,
+                                (PUSB_DEVICE_DESCRIPTOR)Buffer);
+
+            return sizeof(USB_DEVICE_DESCRIPTOR);
+
+        case USB_CONFIGURATION_DESCRIPTOR_TYPE:
+        {
+            PUSB_CONFIGURATION_DESCRIPTOR   configDesc;
+            PUSB_INTERFACE_DESCRIPTOR       interfaceDesc;
+            PUSB_ENDPOINT_DESCRIPTOR        endpointDesc;
+            UCHAR                           numEndpoints;
+            UCHAR                           i;
+
+            if (descIndex != 0)
+            {
+                return 0;
+            }
+
+            numEndpoints = isHub ? 1 : 2;
+
+            configDesc = (PUSB_CONFIGURATION_DESCRIPTOR)Buffer;
+            interfaceDesc = (PUSB_INTERFACE_DESCRIPTOR)(configDesc + 1);
+            endpointDesc = (PUSB_ENDPOINT_DESCRIPTOR)(interfaceDesc + 1);
+
+            length = sizeof(USB_CONFIGURATION_DESCRIPTOR) +
+                     sizeof(USB_INTERFACE_DESCRIPTOR) +
+                     numEndpoints * sizeof(USB_ENDPOINT_DESCRIPTOR);
+
+            memset(Buffer, 0, length);
+
+            configDesc->bLength             = sizeof(USB_CONFIGURATION_DESCRIPTOR);
+            configDesc->bDescriptorType     = USB_CONFIGURATION_DESCRIPTOR_TYPE;
+            configDesc->wTotalLength        = (USHORT)length;
+            configDesc->bNumInterfaces      = 1;
+            configDesc->bConfigurationValue = 1;
+            configDesc->bmAttributes        = USB_CONFIG_BUS_POWERED;
+            configDesc->MaxPower            = 50;
+
+            interfaceDesc->bLength            = sizeof(USB_INTERFACE_DESCRIPTOR);
+            interfaceDesc->bDescriptorType    = USB_INTERFACE_DESCRIPTOR_TYPE;
+            interfaceDesc->bNumEndpoints      = numEndpoints;
+            interfaceDesc->bInterfaceClass    = isHub ? USB_DEVICE_CLASS_HUB : 0xFF;
+
+            for (i = 0; i < numEndpoints; i++)
+            {
+                endpointDesc[i].bLength          = sizeof(USB_ENDPOINT_DESCRIPTOR);
+                endpointDesc[i].bDescriptorType  = USB_ENDPOINT_DESCRIPTOR_TYPE;
+
+                if (isHub)
+                {
+                    endpointDesc[i].bEndpointAddress = 0x81;
+                    endpointDesc[i].bmAttributes     = USB_ENDPOINT_TYPE_INTERRUPT;
+                    endpointDesc[i].wMaxPacketSize   = 1;
+                    endpointDesc[i].bInterval        = 12;
+                }
+                else
+                {
+                    endpointDesc[i].bEndpointAddress = (UCHAR)(i ? 0x02 : 0x81);
+                    endpointDesc[i].bmAttributes     = USB_ENDPOINT_TYPE_BULK;
+                    endpointDesc[i].wMaxPacketSize   = 512;
+                }
+            }
+
+            return length;
+        }
+
+        case USB_STRING_DESCRIPTOR_TYPE:
+        {
+            PUSB_STRING_DESCRIPTOR stringDesc;
+
+            stringDesc = (PUSB_STRING_DESCRIPTOR)Buffer;
+
+            switch (descIndex)
+            {
+                case 0:
+                    stringDesc->bLength = 4;
+                    stringDesc->bDescriptorType = USB_STRING_DESCRIPTOR_TYPE;
+                    stringDesc->bString[0] = 0x0409;
+                    return 4;
+
+                case 1:
+                    wcscpy_s(string, sizeof(string)/sizeof(string[0]),
+                             L"USBView Simulation");
+                    break;
+
+                case 2:
+                    wcscpy_s(string, sizeof(string)/sizeof(string[0]),
+                             isHub ? L"Simulated Hub" : L"Simulated Device");
+                    break;
+
+                case 3:
+                    swprintf_s(string, sizeof(string)/sizeof(string[0]),
+                               L"SIM%08u",
+                               SimPortNumber(Hub, Request->ConnectionIndex));
+                    break;
+
+                default:
+                    return 0;
+            }
+
+            length = (ULONG)wcslen(string) * sizeof(WCHAR);
+
+            stringDesc->bLength = (UCHAR)(2 + length);
+            stringDesc->bDescriptorType = USB_STRING_DESCRIPTOR_TYPE;
+
+            memcpy(stringDesc->bString, string, length);
+
+            return stringDesc->bLength;
+        }
+    }
+
+    return 0;
+}
+
+//*****************************************************************************
+//
+// SimOpenDevice()
+//
+//*****************************************************************************
+
+HANDLE
+SimOpenDevice (
+    PCTSTR  DevicePath,
+    DWORD   FlagsAndAttributes
+)
+{
+    PSIM_HANDLE simHandle;
+    ULONG       index;
+    BOOL        isController;
+
+    UNREFERENCED_PARAMETER(FlagsAndAttributes);
+
+    if (_stscanf_s(DevicePath, _T("\\\\?\\SIMHC#%u"), &index) == 1 &&
+        index < SimNumControllers)
+    {
+        isController = TRUE;
+    }
+    else if (_stscanf_s(DevicePath, _T("\\\\.\\SIMHUB#%u"), &index) == 1 &&
+             index < SimNumHubs)
+    {
+        isController = FALSE;
+    }
+    else
+    {
+        SetLastError(ERROR_FILE_NOT_FOUND);
+        return INVALID_HANDLE_VALUE;
+    }
+
+    simHandle = (PSIM_HANDLE)ALLOC(sizeof(SIM_HANDLE));
+
+    if (simHandle == NULL)
+    {
+        SetLastError(ERROR_NOT_ENOUGH_MEMORY);
+        return INVALID_HANDLE_VALUE;
+    }
+
+    simHandle->Signature    = SIM_HANDLE_SIGNATURE;
+    simHandle->IsController = isController;
+    simHandle->Index        = index;
+
+    return (HANDLE)simHandle;
+}
+
+//*****************************************************************************
+//
+// SimCloseDevice()
+//
+//*****************************************************************************
+
+BOOL
+SimCloseDevice (
+    HANDLE  hDevice
+)
+{
+    PSIM_HANDLE simHandle;
+
+    simHandle = (PSIM_HANDLE)hDevice;
+
+    if (simHandle == NULL || simHandle->Signature != SIM_HANDLE_SIGNATURE)
+    {
+        SetLastError(ERROR_INVALID_HANDLE);
+        return FALSE;
+    }
+
+    simHandle->Signature = 0;
+
+    FREE(simHandle);
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// SimDeviceIoControl()
+//
+//*****************************************************************************
+
+BOOL
+SimDeviceIoControl (
+    HANDLE          hDevice,
+    DWORD           IoControlCode,
+    PVOID           InBuffer,
+    DWORD           InBufferSize,
+    PVOID           OutBuffer,
+    DWORD           OutBufferSize,
+    PDWORD          BytesReturned,
+    LPOVERLAPPED    Overlapped
+)
+{
+    PSIM_HANDLE simHandle;
+    ULONG       hub;
+    ULONG       connectionIndex;
+    WCHAR       name[64];
+    BOOL        success;
+
+    simHandle = (PSIM_HANDLE)hDevice;
+
+    if (simHandle == NULL || simHandle->Signature != SIM_HANDLE_SIGNATURE)
+    {
+        SetLastError(ERROR_INVALID_HANDLE);
+        return FALSE;
+    }
+
+    hub = simHandle->Index;
+    success = FALSE;
+
+    *BytesReturned = 0;
+
+    SetLastError(ERROR_INVALID_FUNCTION);
+
+    if (simHandle->IsController)
+    {
+        switch (IoControlCode)
+        {
+            case IOCTL_GET_HCD_DRIVERKEY_NAME:
+
+                swprintf_s(name, sizeof(name)/sizeof(name[0]),
+                           L"{SIMHC}\\%04u", hub);
+
+                success = SimReturnName(OutBuffer,
+                                        OutBufferSize,
+                                        FIELD_OFFSET(USB_HCD_DRIVERKEY_NAME,
+                                                     DriverKeyName),
+                                        name,
+                                        BytesReturned);
+                break;
+
+            case IOCTL_USB_GET_ROOT_HUB_NAME:
+
+                // The root hub of controller n is hub n
+                //
+                swprintf_s(name, sizeof(name)/sizeof(name[0]),
+                           L"SIMHUB#%04u", hub);
+
+                success = SimReturnName(OutBuffer,
+                                        OutBufferSize,
+                                        FIELD_OFFSET(USB_ROOT_HUB_NAME,
+                                                     RootHubName),
+                                        name,
+                                        BytesReturned);
+                break;
+        }
+
+        goto SimDeviceIoControlDone;
+    }
+
+    switch (IoControlCode)
+    {
+        case IOCTL_USB_GET_NODE_INFORMATION:
+        {
+            PUSB_NODE_INFORMATION nodeInfo;
+
+            if (OutBufferSize < sizeof(USB_NODE_INFORMATION))
+            {
+                SetLastError(ERROR_INSUFFICIENT_BUFFER);
+                break;
+            }
+
+            nodeInfo = (PUSB_NODE_INFORMATION)OutBuffer;
+
+            memset(nodeInfo, 0, sizeof(USB_NODE_INFORMATION));
+
+            nodeInfo->NodeType = UsbHub;
+            nodeInfo->u.HubInformation.HubDescriptor.bDescriptorLength = 9;
+            nodeInfo->u.HubInformation.HubDescriptor.bDescriptorType = 0x29;
+            nodeInfo->u.HubInformation.HubDescriptor.bNumberOfPorts = SIM_PORTS;
+            nodeInfo->u.HubInformation.HubDescriptor.bPowerOnToPowerGood = 50;
+
+            *BytesReturned = sizeof(USB_NODE_INFORMATION);
+            success = TRUE;
+            break;
+        }
+
+        case IOCTL_USB_GET_HUB_CAPABILITIES:
+        {
+            PUSB_HUB_CAPABILITIES hubCaps;
+
+            if (OutBufferSize < sizeof(USB_HUB_CAPABILITIES))
+            {
+                SetLastError(ERROR_INSUFFICIENT_BUFFER);
+                break;
+            }
+
+            hubCaps = (PUSB_HUB_CAPABILITIES)OutBuffer;
+
+            memset(hubCaps, 0, sizeof(USB_HUB_CAPABILITIES));
+
+            hubCaps->HubIs2xCapable = 1;
+
+            *BytesReturned = sizeof(USB_HUB_CAPABILITIES);
+            success = TRUE;
+            break;
+        }
+
+        case IOCTL_USB_GET_NODE_CONNECTION_INFORMATION_EX:
+        {
+            PUSB_NODE_CONNECTION_INFORMATION_EX connectionInfo;
+
+            if (OutBufferSize < sizeof(USB_NODE_CONNECTION_INFORMATION_EX))
+            {
+                SetLastError(ERROR_INSUFFICIENT_BUFFER);
+                break;
+            }
+
+            connectionInfo = (PUSB_NODE_CONNECTION_INFORMATION_EX)OutBuffer;
+            connectionIndex = connectionInfo->ConnectionIndex;
+
+            if (connectionIndex < 1 || connectionIndex > SIM_PORTS)
+            {
+                SetLastError(ERROR_INVALID_PARAMETER);
+                break;
+            }
+
+            memset(connectionInfo, 0, sizeof(USB_NODE_CONNECTION_INFORMATION_EX));
+
+            connectionInfo->ConnectionIndex = connectionIndex;
+            connectionInfo->ConnectionStatus = SimPortStatus(hub, connectionIndex);
+
+            if (connectionInfo->ConnectionStatus == DeviceConnected)
+            {
+                SimDeviceDescriptor(hub,
+                                    connectionIndex,
+                                    &connectionInfo->DeviceDescriptor);
+
+                connectionInfo->CurrentConfigurationValue = 1;
+                connectionInfo->Speed = UsbHighSpeed;
+                connectionInfo->DeviceIsHub =
+                    SimHubs[hub].ChildHub[connectionIndex - 1] != SIM_NO_HUB;
+                connectionInfo->DeviceAddress =
+                    (USHORT)(SimPortNumber(hub, connectionIndex) % 127 + 1);
+            }
+
+            *BytesReturned = sizeof(USB_NODE_CONNECTION_INFORMATION_EX);
+            success = TRUE;
+            break;
+        }
+
+        case IOCTL_USB_GET_NODE_CONNECTION_DRIVERKEY_NAME:
+        case IOCTL_USB_GET_NODE_CONNECTION_NAME:
+        {
+            if (InBufferSize < sizeof(ULONG))
+            {
+                SetLastError(ERROR_INVALID_PARAMETER);
+                break;
+            }
+
+            connectionIndex = *(PULONG)InBuffer;
+
+            if (connectionIndex < 1 || connectionIndex > SIM_PORTS ||
+                SimPortStatus(hub, connectionIndex) != DeviceConnected)
+            {
+                SetLastError(ERROR_INVALID_PARAMETER);
+                break;
+            }
+
+            if (IoControlCode == IOCTL_USB_GET_NODE_CONNECTION_NAME)
+            {
+                if (SimHubs[hub].ChildHub[connectionIndex - 1] == SIM_NO_HUB)
+                {
+                    SetLastError(ERROR_INVALID_PARAMETER);
+                    break;
+                }
+
+                swprintf_s(name, sizeof(name)/sizeof(name[0]),
+                           L"SIMHUB#%04u",
+                           SimHubs[hub].ChildHub[connectionIndex - 1]);
+            }
+            else
+            {
+                swprintf_s(name, sizeof(name)/sizeof(name[0]),
+                           L"{SIMUSB}\\%04u",
+                           SimPortNumber(hub, connectionIndex));
+            }
+
+            // Both structures start with ConnectionIndex, ActualLength
+            //
+            success = SimReturnName(OutBuffer,
+                                    OutBufferSize,
+                                    FIELD_OFFSET(USB_NODE_CONNECTION_NAME,
+                                                 NodeName),
+                                    name,
+                                    BytesReturned);
+            break;
+        }
+
+        case IOCTL_USB_GET_DESCRIPTOR_FROM_NODE_CONNECTION:
+        {
+            PUSB_DESCRIPTOR_REQUEST request;
+            UCHAR                   descriptor[256];
+            ULONG                   length;
+
+            request = (PUSB_DESCRIPTOR_REQUEST)InBuffer;
+
+            if (InBufferSize < sizeof(USB_DESCRIPTOR_REQUEST) ||
+                OutBufferSize < sizeof(USB_DESCRIPTOR_REQUEST) ||
+                request->ConnectionIndex < 1 ||
+                request->ConnectionIndex > SIM_PORTS ||
+                SimPortStatus(hub, request->ConnectionIndex) != DeviceConnected)
+            {
+                SetLastError(ERROR_INVALID_PARAMETER);
+                break;
+            }
+
+            length = SimGetDescriptor(hub, request, descriptor);
+
+            if (length == 0)
+            {
+                SetLastError(ERROR_GEN_FAILURE);
+                break;
+            }
+
+            length = min(length, request->SetupPacket.wLength);
+            length = min(length, OutBufferSize - sizeof(USB_DESCRIPTOR_REQUEST));
+
+            if (OutBuffer != InBuffer)
+            {
+                memcpy(OutBuffer, InBuffer, sizeof(USB_DESCRIPTOR_REQUEST));
+            }
+
+            memcpy((PUSB_DESCRIPTOR_REQUEST)OutBuffer + 1, descriptor, length);
+
+            *BytesReturned = sizeof(USB_DESCRIPTOR_REQUEST) + length;
+            success = TRUE;
+            break;
+        }
+    }
+
+SimDeviceIoControlDone:
+
+    return CompleteEmulatedRequest(Overlapped,
+                                   success,
+                                   GetLastError(),
+                                   *BytesReturned,
+                                   SimLatency);
+}
+
+//*****************************************************************************
+//
+// SimGetOverlappedResult()
+//
+//*****************************************************************************
+
+BOOL
+SimGetOverlappedResult (
+    HANDLE          hDevice,
+    LPOVERLAPPED    Overlapped,
+    PDWORD          BytesReturned,
+    BOOL            Wait
+)
+{
+    UNREFERENCED_PARAMETER(hDevice);
+
+    return GetEmulatedOverlappedResult(Overlapped, BytesReturned, Wait);
+}
+
+//*****************************************************************************
+//
+// SimEnumInterfaces()
+//
+//*****************************************************************************
+
+BOOL
+SimEnumInterfaces (
+    LPGUID                  InterfaceGuid,
+    LPFNINTERFACECALLBACK   Callback,
+    PVOID                   Context
+)
+{
+    TCHAR devicePath[32];
+    ULONG i;
+
+    if (memcmp(InterfaceGuid,
+               &GUID_CLASS_USB_HOST_CONTROLLER,
+               sizeof(GUID)) != 0)
+    {
+        return TRUE;
+    }
+
+    for (i = 0; i < SimNumControllers; i++)
+    {
+        _stprintf_s(devicePath, sizeof(devicePath)/sizeof(devicePath[0]),
+                    _T("\\\\?\\SIMHC#%04u"), i);
+
+        if (!(*Callback)(Context, devicePath))
+        {
+            break;
+        }
+    }
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// SimLocateDevNode() etc.
+//
+// The simulated devnode tree is flat.  Below the root are the host
+// controllers, DevInst 2 and up, followed by one devnode per hub port.
+//
+//*****************************************************************************
+
+DEVINST
+SimLastDevInst (
+    VOID
+)
+{
+    return SIM_ROOT_DEVINST + SimNumControllers + SimNumHubs * SIM_PORTS;
+}
+
+CONFIGRET
+SimLocateDevNode (
+    PDEVINST    DevInst
+)
+{
+    *DevInst = SIM_ROOT_DEVINST;
+
+    return CR_SUCCESS;
+}
+
+CONFIGRET
+SimGetChild (
+    PDEVINST    DevInstChild,
+    DEVINST     DevInst
+)
+{
+    if (DevInst != SIM_ROOT_DEVINST || SimLastDevInst() == SIM_ROOT_DEVINST)
+    {
+        return CR_NO_SUCH_DEVNODE;
+    }
+
+    *DevInstChild = SIM_ROOT_DEVINST + 1;
+
+    return CR_SUCCESS;
+}
+
+CONFIGRET
+SimGetSibling (
+    PDEVINST    DevInstSibling,
+    DEVINST     DevInst
+)
+{
+    if (DevInst == SIM_ROOT_DEVINST || DevInst >= SimLastDevInst())
+    {
+        return CR_NO_SUCH_DEVNODE;
+    }
+
+    *DevInstSibling = DevInst + 1;
+
+    return CR_SUCCESS;
+}
+
+CONFIGRET
+SimGetParent (
+    PDEVINST    DevInstParent,
+    DEVINST     DevInst
+)
+{
+    if (DevInst == SIM_ROOT_DEVINST)
+    {
+        return CR_NO_SUCH_DEVNODE;
+    }
+
+    *DevInstParent = SIM_ROOT_DEVINST;
+
+    return CR_SUCCESS;
+}
+
+//*****************************************************************************
+//
+// SimDevNodeString()
+//
+// Formats the driver key, description or device id of a devnode.
+//
+//*****************************************************************************
+
+BOOL
+SimDevNodeString (
+    DEVINST     DevInst,
+    ULONG       Property,
+    PTSTR       Buffer,
+    ULONG       Length
+)
+{
+    ULONG index;
+    ULONG hub;
+    BOOL  isHub;
+
+    if (DevInst <= SIM_ROOT_DEVINST || DevInst > SimLastDevInst())
+    {
+        return FALSE;
+    }
+
+    index = DevInst - SIM_ROOT_DEVINST - 1;
+
+    if (index < SimNumControllers)
+    {
+        switch (Property)
+        {
+            case CM_DRP_DRIVER:
+                _stprintf_s(Buffer, Length, _T("{SIMHC}\\%04u"), index);
+                return TRUE;
+
+            case CM_DRP_DEVICEDESC:
+                _stprintf_s(Buffer, Length,
+                            _T("Simulated USB Host Controller %u"), index);
+                return TRUE;
+
+            default:
+                _stprintf_s(Buffer, Length,
+                            _T("PCI\\VEN_8086&DEV_%04X&SUBSYS_00000000&REV_01"),
+                            0x3A30 + index);
+                return TRUE;
+        }
+    }
+
+    index -= SimNumControllers;
+    hub = index / SIM_PORTS;
+
+    if (SimPortStatus(hub, index % SIM_PORTS + 1) != DeviceConnected)
+    {
+        return FALSE;
+    }
+
+    isHub = SimHubs[hub].ChildHub[index % SIM_PORTS] != SIM_NO_HUB;
+
+    switch (Property)
+    {
+        case CM_DRP_DRIVER:
+            _stprintf_s(Buffer, Length, _T("{SIMUSB}\\%04u"), index);
+            return TRUE;
+
+        case CM_DRP_DEVICEDESC:
+            _stprintf_s(Buffer, Length,
+                        isHub ? _T("Simulated USB Hub") :
+                                _T("Simulated USB Device"));
+            return TRUE;
+
+        default:
+            _stprintf_s(Buffer, Length, _T("USB\\VID_%04X&PID_%04X\\SIM%08u"),
+                        isHub ? 0x0451 : 0x045E, 0x1000 + index, index);
+            return TRUE;
+    }
+}
+
+CONFIGRET
+SimGetDevNodeProperty (
+    DEVINST     DevInst,
+    ULONG       Property,
+    PVOID       Buffer,
+    PULONG      Length
+)
+{
+    TCHAR   string[MAX_DEVICE_ID_LEN];
+    ULONG   size;
+
+    if ((Property != CM_DRP_DRIVER && Property != CM_DRP_DEVICEDESC) ||
+        !SimDevNodeString(DevInst,
+                          Property,
+                          string,
+                          sizeof(string)/sizeof(string[0])))
+    {
+        return CR_NO_SUCH_VALUE;
+    }
+
+    size = (ULONG)(_tcslen(string) + 1) * sizeof(TCHAR);
+
+    if (size > *Length)
+    {
+        *Length = size;
+        return CR_BUFFER_SMALL;
+    }
+
+    memcpy(Buffer, string, size);
+
+    *Length = size;
+
+    return CR_SUCCESS;
+}
+
+CONFIGRET
+SimGetDeviceId (
+    DEVINST     DevInst,
+    PTSTR       Buffer,
+    ULONG       Length
+)
+{
+    TCHAR string[MAX_DEVICE_ID_LEN];
+
+    if (!SimDevNodeString(DevInst,
+                          0,
+                          string,
+                          sizeof(string)/sizeof(string[0])))
+    {
+        return CR_NO_SUCH_DEVNODE;
+    }
+
+    if (_tcslen(string) + 1 > Length)
+    {
+        return CR_BUFFER_SMALL;
+    }
+
+    _tcscpy_s(Buffer, Length, string);
+
+    return CR_SUCCESS;
+}
+
+#if _MSC_VER >= 1200
+#pragma warning(pop)
+#endif
@@ -0,0 +1,2152 @@
+/*++
+
+Copyright (c) 1997-1998 Microsoft Corporation
+
+Module Name:
+
+    DEVTRACE.C
+
+Abstract:
+
+    This source file contains the recording and replay device access
+    backends.
+
+    The recording backend wraps another backend (normally the native one)
+    and writes every device open, IOCTL request and response, interface
+    enumeration and configuration manager call to a trace file, together
+    with how long the call took.
+
+    The replay backend loads such a trace file and serves the recorded
+    responses back, optionally sleeping for the recorded latency.  Replayed
+    requests are matched by device path, IOCTL code and the leading part of
+    the request buffer (connection index and setup packet, but not
+    wLength), so a replay keeps working when the caller changes buffer
+    sizes or issues requests in a different order.
+
+Environment:
+
+    user mode
+
+Revision History:
+
+    10-16-26 : created
+
+--*/
+
+//*****************************************************************************
+// I N C L U D E S
+//*****************************************************************************
+
+#include <windows.h>
+#include <basetyps.h>
+#include <winioctl.h>
+#include <string.h>
+#include <tchar.h>
+#include "usbview.h"
+
+#if _MSC_VER >= 1200
+#pragma warning(push)
+#endif
+#pragma warning(disable:4200) // named type definition in parentheses
+
+//*****************************************************************************
+// D E F I N E S
+//*****************************************************************************
+
+#define TRACE_SIGNATURE         0x52545655  // 'UVTR'
+#define TRACE_VERSION           1
+
+// Number of leading request bytes used to match a replayed IOCTL.  This
+// covers USB_DESCRIPTOR_REQUEST.ConnectionIndex and the setup packet up to,
+// but not including, wLength.
+//
+#define TRACE_KEY_BYTES         10
+
+#define REPLAY_HASH_BUCKETS     1024
+
+#define REPLAY_HANDLE_SIGNATURE 0x444E4852  // 'RHND'
+
+//*****************************************************************************
+// T Y P E D E F S
+//*****************************************************************************
+
+typedef enum _TRACE_RECORD_TYPE
+{
+    TraceRecordOpen = 1,
+
+    TraceRecordIoctl,
+
+    TraceRecordInterface,
+
+    TraceRecordDevNode
+
+} TRACE_RECORD_TYPE;
+
+typedef enum _TRACE_DEVNODE_OP
+{
+    TraceLocateDevNode = 1,
+
+    TraceGetChild,
+
+    TraceGetSibling,
+
+    TraceGetParent,
+
+    TraceGetProperty,
+
+    TraceGetDeviceId
+
+} TRACE_DEVNODE_OP;
+
+#include <pshpack1.h>
+
+typedef struct _TRACE_FILE_HEADER
+{
+    ULONG   Signature;
+    USHORT  Version;
+    USHORT  CharSize;       // sizeof(TCHAR) of the recording build
+} TRACE_FILE_HEADER, *PTRACE_FILE_HEADER;
+
+// Every record starts with this header.  Length covers the whole record
+// and is always a multiple of sizeof(ULONG).
+//
+typedef struct _TRACE_RECORD
+{
+    USHORT  Type;
+    USHORT  Reserved;
+    ULONG   Length;
+    ULONG   LatencyUs;
+    ULONG   HandleId;
+} TRACE_RECORD, *PTRACE_RECORD;
+
+typedef struct _TRACE_OPEN_RECORD
+{
+    TRACE_RECORD    Header;
+    ULONG           Success;
+    TCHAR           DevicePath[0];
+} TRACE_OPEN_RECORD, *PTRACE_OPEN_RECORD;
+
+typedef struct _TRACE_IOCTL_RECORD
+{
+    TRACE_RECORD    Header;
+    ULONG           IoControlCode;
+    ULONG           Success;
+    ULONG           LastError;
+    ULONG           InSize;
+    ULONG           OutSize;
+    ULONG           Returned;
+    UCHAR           Data[0];    // InSize request bytes, Returned response bytes
+} TRACE_IOCTL_RECORD, *PTRACE_IOCTL_RECORD;
+
+typedef struct _TRACE_INTERFACE_RECORD
+{
+    TRACE_RECORD    Header;
+    GUID            InterfaceGuid;
+    TCHAR           DevicePath[0];
+} TRACE_INTERFACE_RECORD, *PTRACE_INTERFACE_RECORD;
+
+typedef struct _TRACE_DEVNODE_RECORD
+{
+    TRACE_RECORD    Header;
+    ULONG           Operation;
+    ULONG           DevInst;
+    ULONG           Property;
+    ULONG           Result;
+    ULONG           DevInstOut;
+    ULONG           DataSize;
+    UCHAR           Data[0];
+} TRACE_DEVNODE_RECORD, *PTRACE_DEVNODE_RECORD;
+
+#include <poppack.h>
+
+// Maps a live handle to the id written in the trace file
+//
+typedef struct _TRACE_HANDLE_ENTRY
+{
+    HANDLE  Handle;
+    ULONG   HandleId;
+} TRACE_HANDLE_ENTRY, *PTRACE_HANDLE_ENTRY;
+
+typedef struct _RECORD_INTERFACE_CONTEXT
+{
+    LPGUID                  InterfaceGuid;
+    LPFNINTERFACECALLBACK   Callback;
+    PVOID                   Context;
+} RECORD_INTERFACE_CONTEXT, *PRECORD_INTERFACE_CONTEXT;
+
+// One replayable response, hashed by what the caller will ask for
+//
+typedef struct _REPLAY_ENTRY
+{
+    struct _REPLAY_ENTRY   *Next;
+    ULONG                   Type;
+    ULONG                   Key1;   // path index or DevInst
+    ULONG                   Key2;   // IOCTL code or devnode operation
+    ULONG                   Key3;   // devnode property
+    ULONG                   KeySize;
+    UCHAR                   KeyBytes[TRACE_KEY_BYTES];
+    PTRACE_RECORD           Record;
+} REPLAY_ENTRY, *PREPLAY_ENTRY;
+
+typedef struct _REPLAY_HANDLE
+{
+    ULONG   Signature;
+    ULONG   PathIndex;
+} REPLAY_HANDLE, *PREPLAY_HANDLE;
+
+//*****************************************************************************
+// L O C A L    F U N C T I O N    P R O T O T Y P E S
+//*****************************************************************************
+
+HANDLE
+RecordOpenDevice (
+    PCTSTR  DevicePath,
+    DWORD   FlagsAndAttributes
+);
+
+BOOL
+RecordCloseDevice (
+    HANDLE  hDevice
+);
+
+BOOL
+RecordDeviceIoControl (
+    HANDLE          hDevice,
+    DWORD           IoControlCode,
+    PVOID           InBuffer,
+    DWORD           InBufferSize,
+    PVOID           OutBuffer,
+    DWORD           OutBufferSize,
+    PDWORD          BytesReturned,
+    LPOVERLAPPED    Overlapped
+);
+
+BOOL
+RecordGetOverlappedResult (
+    HANDLE          hDevice,
+    LPOVERLAPPED    Overlapped,
+    PDWORD          BytesReturned,
+    BOOL            Wait
+);
+
+BOOL
+RecordEnumInterfaces (
+    LPGUID                  InterfaceGuid,
+    LPFNINTERFACECALLBACK   Callback,
+    PVOID                   Context
+);
+
+CONFIGRET
+RecordLocateDevNode (
+    PDEVINST    DevInst
+);
+
+CONFIGRET
+RecordGetChild (
+    PDEVINST    DevInstChild,
+    DEVINST     DevInst
+);
+
+CONFIGRET
+RecordGetSibling (
+    PDEVINST    DevInstSibling,
+    DEVINST     DevInst
+);
+
+CONFIGRET
+RecordGetParent (
+    PDEVINST    DevInstParent,
+    DEVINST     DevInst
+);
+
+CONFIGRET
+RecordGetDevNodeProperty (
+    DEVINST     DevInst,
+    ULONG       Property,
+    PVOID       Buffer,
+    PULONG      Length
+);
+
+CONFIGRET
+RecordGetDeviceId (
+    DEVINST     DevInst,
+    PTSTR       Buffer,
+    ULONG       Length
+);
+
+HANDLE
+ReplayOpenDevice (
+    PCTSTR  DevicePath,
+    DWORD   FlagsAndAttributes
+);
+
+BOOL
+ReplayCloseDevice (
+    HANDLE  hDevice
+);
+
+BOOL
+ReplayDeviceIoControl (
+    HANDLE          hDevice,
+    DWORD           IoControlCode,
+    PVOID           InBuffer,
+    DWORD           InBufferSize,
+    PVOID           OutBuffer,
+    DWORD           OutBufferSize,
+    PDWORD          BytesReturned,
+    LPOVERLAPPED    Overlapped
+);
+
+BOOL
+ReplayGetOverlappedResult (
+    HANDLE          hDevice,
+    LPOVERLAPPED    Overlapped,
+    PDWORD          BytesReturned,
+    BOOL            Wait
+);
+
+BOOL
+ReplayEnumInterfaces (
+    LPGUID                  InterfaceGuid,
+    LPFNINTERFACECALLBACK   Callback,
+    PVOID                   Context
+);
+
+CONFIGRET
+ReplayLocateDevNode (
+    PDEVINST    DevInst
+);
+
+CONFIGRET
+ReplayGetChild (
+    PDEVINST    DevInstChild,
+    DEVINST     DevInst
+);
+
+CONFIGRET
+ReplayGetSibling (
+    PDEVINST    DevInstSibling,
+    DEVINST     DevInst
+);
+
+CONFIGRET
+ReplayGetParent (
+    PDEVINST    DevInstParent,
+    DEVINST     DevInst
+);
+
+CONFIGRET
+ReplayGetDevNodeProperty (
+    DEVINST     DevInst,
+    ULONG       Property,
+    PVOID       Buffer,
+    PULONG      Length
+);
+
+CONFIGRET
+ReplayGetDeviceId (
+    DEVINST     DevInst,
+    PTSTR       Buffer,
+    ULONG       Length
+);
+
+//*****************************************************************************
+// G L O B A L S    P R I V A T E    T O    T H I S    F I L E
+//*****************************************************************************
+
+DEVICE_ACCESS_BACKEND RecordBackend =
+{
+    _T("Record"),
+    RecordOpenDevice,
+    RecordCloseDevice,
+    RecordDeviceIoControl,
+    RecordGetOverlappedResult,
+    RecordEnumInterfaces,
+    RecordLocateDevNode,
+    RecordGetChild,
+    RecordGetSibling,
+    RecordGetParent,
+    RecordGetDevNodeProperty,
+    RecordGetDeviceId
+};
+
+DEVICE_ACCESS_BACKEND ReplayBackend =
+{
+    _T("Replay"),
+    ReplayOpenDevice,
+    ReplayCloseDevice,
+    ReplayDeviceIoControl,
+    ReplayGetOverlappedResult,
+    ReplayEnumInterfaces,
+    ReplayLocateDevNode,
+    ReplayGetChild,
+    ReplayGetSibling,
+    ReplayGetParent,
+    ReplayGetDevNodeProperty,
+    ReplayGetDeviceId
+};
+
+LARGE_INTEGER           TraceFrequency;
+
+// Recording state
+//
+PDEVICE_ACCESS_BACKEND  RecordTarget;
+HANDLE                  RecordFile = INVALID_HANDLE_VALUE;
+CRITICAL_SECTION        RecordLock;
+PTRACE_HANDLE_ENTRY     RecordHandles;
+ULONG                   RecordHandleCount;
+ULONG                   RecordHandleMax;
+ULONG                   RecordNextHandleId;
+
+// Replay state
+//
+PUCHAR                  ReplayImage;
+ULONG                   ReplayImageSize;
+PTRACE_OPEN_RECORD     *ReplayPaths;
+ULONG                   ReplayPathCount;
+PREPLAY_ENTRY           ReplayEntries;
+PREPLAY_ENTRY           ReplayBuckets[REPLAY_HASH_BUCKETS];
+BOOL                    ReplayEmulateLatency;
+PDEVICE_ACCESS_BACKEND  ReplayPrevious;
+LONG                    ReplayMisses;
+
+
+//*****************************************************************************
+//
+// TraceTimestamp() / TraceElapsedUs()
+//
+//*****************************************************************************
+
+LONGLONG
+TraceTimestamp (
+    VOID
+)
+{
+    LARGE_INTEGER now;
+
+    QueryPerformanceCounter(&now);
+
+    return now.QuadPart;
+}
+
+ULONG
+TraceElapsedUs (
+    LONGLONG Start
+)
+{
+    LONGLONG elapsed;
+
+    if (TraceFrequency.QuadPart == 0)
+    {
+        return 0;
+    }
+
+    elapsed = TraceTimestamp() - Start;
+
+    return (ULONG)((elapsed * 1000000) / TraceFrequency.QuadPart);
+}
+
+//*****************************************************************************
+//
+// TraceRecordSize()
+//
+// Rounds a record size up so the next record stays ULONG aligned.
+//
+//*****************************************************************************
+
+ULONG
+TraceRecordSize (
+    ULONG Size
+)
+{
+    return (Size + sizeof(ULONG) - 1) & ~(sizeof(ULONG) - 1);
+}
+
+//*****************************************************************************
+//
+// HashReplayKey()
+//
+//*****************************************************************************
+
+ULONG
+HashReplayKey (
+    ULONG   Type,
+    ULONG   Key1,
+    ULONG   Key2,
+    ULONG   Key3,
+    PUCHAR  KeyBytes,
+    ULONG   KeySize
+)
+{
+    ULONG hash;
+    ULONG i;
+
+    // FNV-1a over the key fields
+    //
+    hash = 2166136261U;
+
+    hash = (hash ^ Type) * 16777619U;
+    hash = (hash ^ Key1) * 16777619U;
+    hash = (hash ^ Key2) * 16777619U;
+    hash = (hash ^ Key3) * 16777619U;
+
+    for (i = 0; i < KeySize; i++)
+    {
+        hash = (hash ^ KeyBytes[i]) * 16777619U;
+    }
+
+    return hash % REPLAY_HASH_BUCKETS;
+}
+
+
+//*****************************************************************************
+//
+// R E C O R D I N G
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// StartTraceRecording()
+//
+// FileName - Trace file to create.  Recording wraps whatever backend is
+// current at the time of the call.
+//
+//*****************************************************************************
+
+BOOL
+StartTraceRecording (
+    __in PCTSTR FileName
+)
+{
+    TRACE_FILE_HEADER   header;
+    DWORD               nBytes;
+
+    if (RecordFile != INVALID_HANDLE_VALUE)
+    {
+        return FALSE;
+    }
+
+    RecordFile = CreateFile(FileName,
+                            GENERIC_WRITE,
+                            0,
+                            NULL,
+                            CREATE_ALWAYS,
+                            FILE_ATTRIBUTE_NORMAL,
+                            NULL);
+
+    if (RecordFile == INVALID_HANDLE_VALUE)
+    {
+        return FALSE;
+    }
+
+    header.Signature = TRACE_SIGNATURE;
+    header.Version   = TRACE_VERSION;
+    header.CharSize  = sizeof(TCHAR);
+
+    if (!WriteFile(RecordFile, &header, sizeof(header), &nBytes, NULL))
+    {
+        CloseHandle(RecordFile);
+        RecordFile = INVALID_HANDLE_VALUE;
+        return FALSE;
+    }
+
+    QueryPerformanceFrequency(&TraceFrequency);
+
+    InitializeCriticalSection(&RecordLock);
+
+    RecordHandles      = NULL;
+    RecordHandleCount  = 0;
+    RecordHandleMax    = 0;
+    RecordNextHandleId = 0;
+
+    RecordTarget = SetDeviceBackend(&RecordBackend);
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// StopTraceRecording()
+//
+//*****************************************************************************
+
+VOID
+StopTraceRecording (
+    VOID
+)
+{
+    if (RecordFile == INVALID_HANDLE_VALUE)
+    {
+        return;
+    }
+
+    SetDeviceBackend(RecordTarget);
+
+    CloseHandle(RecordFile);
+    RecordFile = INVALID_HANDLE_VALUE;
+
+    if (RecordHandles != NULL)
+    {
+        FREE(RecordHandles);
+        RecordHandles = NULL;
+    }
+
+    DeleteCriticalSection(&RecordLock);
+}
+
+//*****************************************************************************
+//
+// WriteTraceRecord()
+//
+// Record - Fully formatted record, Record->Length bytes long.  The caller
+// must hold RecordLock.
+//
+//*****************************************************************************
+
+VOID
+WriteTraceRecord (
+    PTRACE_RECORD Record
+)
+{
+    DWORD nBytes;
+
+    if (!WriteFile(RecordFile, Record, Record->Length, &nBytes, NULL))
+    {
+        OOPS();
+    }
+}
+
+//*****************************************************************************
+//
+// LookupRecordHandle()
+//
+// Returns the trace id of an open handle, or zero.  The caller must hold
+// RecordLock.
+//
+//*****************************************************************************
+
+ULONG
+LookupRecordHandle (
+    HANDLE hDevice
+)
+{
+    ULONG i;
+
+    for (i = 0; i < RecordHandleCount; i++)
+    {
+        if (RecordHandles[i].Handle == hDevice)
+        {
+            return RecordHandles[i].HandleId;
+        }
+    }
+
+    return 0;
+}
+
+//*****************************************************************************
+//
+// RecordOpenDevice()
+//
+//*****************************************************************************
+
+HANDLE
+RecordOpenDevice (
+    PCTSTR  DevicePath,
+    DWORD   FlagsAndAttributes
+)
+{
+    HANDLE              hDevice;
+    LONGLONG            start;
+    ULONG               latency;
+    ULONG               pathSize;
+    ULONG               recordSize;
+    PTRACE_OPEN_RECORD  record;
+
+    start = TraceTimestamp();
+
+    hDevice = RecordTarget->OpenDevice(DevicePath, FlagsAndAttributes);
+
+    latency = TraceElapsedUs(start);
+
+    pathSize = (ULONG)(_tcslen(DevicePath) + 1) * sizeof(TCHAR);
+
+    recordSize = TraceRecordSize(sizeof(TRACE_OPEN_RECORD) + pathSize);
+
+    record = ALLOC(recordSize);
+
+    if (record == NULL)
+    {
+        OOPS();
+        return hDevice;
+    }
+
+    record->Header.Type      = TraceRecordOpen;
+    record->Header.Length    = recordSize;
+    record->Header.LatencyUs = latency;
+    record->Success          = (hDevice != INVALID_HANDLE_VALUE);
+
+    memcpy(record->DevicePath, DevicePath, pathSize);
+
+    EnterCriticalSection(&RecordLock);
+
+    if (hDevice != INVALID_HANDLE_VALUE)
+    {
+        if (RecordHandleCount == RecordHandleMax)
+        {
+            PTRACE_HANDLE_ENTRY newHandles;
+            ULONG               newMax;
+
+            newMax = RecordHandleMax ? RecordHandleMax * 2 : 16;
+
+            newHandles = ALLOC(newMax * sizeof(TRACE_HANDLE_ENTRY));
+
+            if (newHandles != NULL)
+            {
+                if (RecordHandles != NULL)
+                {
+                    memcpy(newHandles,
+                           RecordHandles,
+                           RecordHandleCount * sizeof(TRACE_HANDLE_ENTRY));
+
+                    FREE(RecordHandles);
+                }
+
+                RecordHandles = newHandles;
+                RecordHandleMax = newMax;
+            }
+        }
+
+        if (RecordHandleCount < RecordHandleMax)
+        {
+            record->Header.HandleId = ++RecordNextHandleId;
+
+            RecordHandles[RecordHandleCount].Handle = hDevice;
+            RecordHandles[RecordHandleCount].HandleId = record->Header.HandleId;
+            RecordHandleCount++;
+        }
+    }
+
+    WriteTraceRecord(&record->Header);
+
+    LeaveCriticalSection(&RecordLock);
+
+    FREE(record);
+
+    return hDevice;
+}
+
+//*****************************************************************************
+//
+// RecordCloseDevice()
+//
+//*****************************************************************************
+
+BOOL
+RecordCloseDevice (
+    HANDLE  hDevice
+)
+{
+    ULONG i;
+
+    EnterCriticalSection(&RecordLock);
+
+    for (i = 0; i < RecordHandleCount; i++)
+    {
+        if (RecordHandles[i].Handle == hDevice)
+        {
+            RecordHandles[i] = RecordHandles[--RecordHandleCount];
+            break;
+        }
+    }
+
+    LeaveCriticalSection(&RecordLock);
+
+    return RecordTarget->CloseDevice(hDevice);
+}
+
+//*****************************************************************************
+//
+// RecordDeviceIoControl()
+//
+//*****************************************************************************
+
+BOOL
+RecordDeviceIoControl (
+    HANDLE          hDevice,
+    DWORD           IoControlCode,
+    PVOID           InBuffer,
+    DWORD           InBufferSize,
+    PVOID           OutBuffer,
+    DWORD           OutBufferSize,
+    PDWORD          BytesReturned,
+    LPOVERLAPPED    Overlapped
+)
+{
+    PTRACE_IOCTL_RECORD record;
+    ULONG               recordSize;
+    LONGLONG            start;
+    BOOL                success;
+    DWORD               lastError;
+    DWORD               returned;
+
+    if (InBuffer == NULL)
+    {
+        InBufferSize = 0;
+    }
+
+    // The request and response buffers are usually the same memory, so
+    // the request has to be captured before the call.  Size the record
+    // for the largest possible response now.
+    //
+    recordSize = TraceRecordSize(sizeof(TRACE_IOCTL_RECORD) +
+                                 InBufferSize +
+                                 OutBufferSize);
+
+    record = ALLOC(recordSize);
+
+    if (record != NULL && InBufferSize != 0)
+    {
+        memcpy(record->Data, InBuffer, InBufferSize);
+    }
+
+    start = TraceTimestamp();
+
+    success = RecordTarget->IoControl(hDevice,
+                                      IoControlCode,
+                                      InBuffer,
+                                      InBufferSize,
+                                      OutBuffer,
+                                      OutBufferSize,
+                                      BytesReturned,
+                                      Overlapped);
+
+    lastError = GetLastError();
+
+    // Wait for an overlapped request here, the response has to be in the
+    // buffer before it can be written to the trace.
+    //
+    if (!success && lastError == ERROR_IO_PENDING)
+    {
+        success = RecordTarget->OverlappedResult(hDevice,
+                                                 Overlapped,
+                                                 BytesReturned,
+                                                 TRUE);
+
+        lastError = GetLastError();
+    }
+
+    returned = success ? *BytesReturned : 0;
+
+    if (record == NULL)
+    {
+        OOPS();
+        SetLastError(lastError);
+        return success;
+    }
+
+    if (returned > OutBufferSize)
+    {
+        returned = OutBufferSize;
+    }
+
+    record->Header.Type      = TraceRecordIoctl;
+    record->Header.Length    = TraceRecordSize(sizeof(TRACE_IOCTL_RECORD) +
+                                               InBufferSize +
+                                               returned);
+    record->Header.LatencyUs = TraceElapsedUs(start);
+    record->IoControlCode    = IoControlCode;
+    record->Success          = success;
+    record->LastError        = success ? ERROR_SUCCESS : lastError;
+    record->InSize           = InBufferSize;
+    record->OutSize          = OutBufferSize;
+    record->Returned         = returned;
+
+    if (returned != 0)
+    {
+        memcpy(record->Data + InBufferSize, OutBuffer, returned);
+    }
+
+    EnterCriticalSection(&RecordLock);
+
+    record->Header.HandleId = LookupRecordHandle(hDevice);
+
+    WriteTraceRecord(&record->Header);
+
+    LeaveCriticalSection(&RecordLock);
+
+    FREE(record);
+
+    SetLastError(lastError);
+
+    return success;
+}
+
+//*****************************************************************************
+//
+// RecordGetOverlappedResult()
+//
+// Recorded requests have always completed by the time RecordDeviceIoControl()
+// returns, so this only fetches the result.
+//
+//*****************************************************************************
+
+BOOL
+RecordGetOverlappedResult (
+    HANDLE          hDevice,
+    LPOVERLAPPED    Overlapped,
+    PDWORD          BytesReturned,
+    BOOL            Wait
+)
+{
+    return RecordTarget->OverlappedResult(hDevice,
+                                          Overlapped,
+                                          BytesReturned,
+                                          Wait);
+}
+
+//*****************************************************************************
+//
+// RecordInterfaceCallback()
+//
+//*****************************************************************************
+
+BOOL
+RecordInterfaceCallback (
+    PVOID   Context,
+    PCTSTR  DevicePath
+)
+{
+    PRECORD_INTERFACE_CONTEXT   recordContext;
+    PTRACE_INTERFACE_RECORD     record;
+    ULONG                       pathSize;
+    ULONG                       recordSize;
+
+    recordContext = (PRECORD_INTERFACE_CONTEXT)Context;
+
+    pathSize = (ULONG)(_tcslen(DevicePath) + 1) * sizeof(TCHAR);
+
+    recordSize = TraceRecordSize(sizeof(TRACE_INTERFACE_RECORD) + pathSize);
+
+    record = ALLOC(recordSize);
+
+    if (record != NULL)
+    {
+        record->Header.Type   = TraceRecordInterface;
+        record->Header.Length = recordSize;
+        record->InterfaceGuid = *recordContext->InterfaceGuid;
+
+        memcpy(record->DevicePath, DevicePath, pathSize);
+
+        EnterCriticalSection(&RecordLock);
+        WriteTraceRecord(&record->Header);
+        LeaveCriticalSection(&RecordLock);
+
+        FREE(record);
+    }
+    else
+    {
+        OOPS();
+    }
+
+    return (*recordContext->Callback)(recordContext->Context, DevicePath);
+}
+
+//*****************************************************************************
+//
+// RecordEnumInterfaces()
+//
+//*****************************************************************************
+
+BOOL
+RecordEnumInterfaces (
+    LPGUID                  InterfaceGuid,
+    LPFNINTERFACECALLBACK   Callback,
+    PVOID                   Context
+)
+{
+    RECORD_INTERFACE_CONTEXT recordContext;
+
+    recordContext.InterfaceGuid = InterfaceGuid;
+    recordContext.Callback      = Callback;
+    recordContext.Context       = Context;
+
+    return RecordTarget->EnumInterfaces(InterfaceGuid,
+                                        RecordInterfaceCallback,
+                                        &recordContext);
+}
+
+//*****************************************************************************
+//
+// RecordDevNodeCall()
+//
+// Writes one configuration manager call to the trace.
+//
+//*****************************************************************************
+
+VOID
+RecordDevNodeCall (
+    ULONG       Operation,
+    DEVINST     DevInst,
+    ULONG       Property,
+    CONFIGRET   Result,
+    DEVINST     DevInstOut,
+    PVOID       Data,
+    ULONG       DataSize,
+    ULONG       LatencyUs
+)
+{
+    PTRACE_DEVNODE_RECORD   record;
+    ULONG                   recordSize;
+
+    recordSize = TraceRecordSize(sizeof(TRACE_DEVNODE_RECORD) + DataSize);
+
+    record = ALLOC(recordSize);
+
+    if (record == NULL)
+    {
+        OOPS();
+        return;
+    }
+
+    record->Header.Type      = TraceRecordDevNode;
+    record->Header.Length    = recordSize;
+    record->Header.LatencyUs = LatencyUs;
+    record->Operation        = Operation;
+    record->DevInst          = DevInst;
+    record->Property         = Property;
+    record->Result           = Result;
+    record->DevInstOut       = DevInstOut;
+    record->DataSize         = DataSize;
+
+    if (DataSize != 0)
+    {
+        memcpy(record->Data, Data, DataSize);
+    }
+
+    EnterCriticalSection(&RecordLock);
+    WriteTraceRecord(&record->Header);
+    LeaveCriticalSection(&RecordLock);
+
+    FREE(record);
+}
+
+//*****************************************************************************
+//
+// RecordLocateDevNode() etc.
+//
+//*****************************************************************************
+
+CONFIGRET
+RecordLocateDevNode (
+    PDEVINST    DevInst
+)
+{
+    CONFIGRET   cr;
+    LONGLONG    start;
+
+    start = TraceTimestamp();
+
+    cr = RecordTarget->LocateDevNode(DevInst);
+
+    RecordDevNodeCall(TraceLocateDevNode, 0, 0, cr,
+                      (cr == CR_SUCCESS) ? *DevInst : 0,
+                      NULL, 0, TraceElapsedUs(start));
+
+    return cr;
+}
+
+CONFIGRET
+RecordGetChild (
+    PDEVINST    DevInstChild,
+    DEVINST     DevInst
+)
+{
+    CONFIGRET   cr;
+    LONGLONG    start;
+
+    start = TraceTimestamp();
+
+    cr = RecordTarget->GetChild(DevInstChild, DevInst);
+
+    RecordDevNodeCall(TraceGetChild, DevInst, 0, cr,
+                      (cr == CR_SUCCESS) ? *DevInstChild : 0,
+                      NULL, 0, TraceElapsedUs(start));
+
+    return cr;
+}
+
+CONFIGRET
+RecordGetSibling (
+    PDEVINST    DevInstSibling,
+    DEVINST     DevInst
+)
+{
+    CONFIGRET   cr;
+    LONGLONG    start;
+
+    start = TraceTimestamp();
+
+    cr = RecordTarget->GetSibling(DevInstSibling, DevInst);
+
+    RecordDevNodeCall(TraceGetSibling, DevInst, 0, cr,
+                      (cr == CR_SUCCESS) ? *DevInstSibling : 0,
+                      NULL, 0, TraceElapsedUs(start));
+
+    return cr;
+}
+
+CONFIGRET
+RecordGetParent (
+    PDEVINST    DevInstParent,
+    DEVINST     DevInst
+)
+{
+    CONFIGRET   cr;
+    LONGLONG    start;
+
+    start = TraceTimestamp();
+
+    cr = RecordTarget->GetParent(DevInstParent, DevInst);
+
+    RecordDevNodeCall(TraceGetParent, DevInst, 0, cr,
+                      (cr == CR_SUCCESS) ? *DevInstParent : 0,
+                      NULL, 0, TraceElapsedUs(start));
+
+    return cr;
+}
+
+CONFIGRET
+RecordGetDevNodeProperty (
+    DEVINST     DevInst,
+    ULONG       Property,
+    PVOID       Buffer,
+    PULONG      Length
+)
+{
+    CONFIGRET   cr;
+    LONGLONG    start;
+
+    start = TraceTimestamp();
+
+    cr = RecordTarget->GetDevNodeProperty(DevInst, Property, Buffer, Length);
+
+    RecordDevNodeCall(TraceGetProperty, DevInst, Property, cr, 0,
+                      Buffer, (cr == CR_SUCCESS) ? *Length : 0,
+                      TraceElapsedUs(start));
+
+    return cr;
+}
+
+CONFIGRET
+RecordGetDeviceId (
+    DEVINST     DevInst,
+    PTSTR       Buffer,
+    ULONG       Length
+)
+{
+    CONFIGRET   cr;
+    LONGLONG    start;
+
+    start = TraceTimestamp();
+
+    cr = RecordTarget->GetDeviceId(DevInst, Buffer, Length);
+
+    RecordDevNodeCall(TraceGetDeviceId, DevInst, 0, cr, 0,
+                      Buffer,
+                      (cr == CR_SUCCESS) ?
+                          (ULONG)(_tcslen(Buffer) + 1) * sizeof(TCHAR) : 0,
+                      TraceElapsedUs(start));
+
+    return cr;
+}
+
+
+//*****************************************************************************
+//
+// R E P L A Y
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// AddReplayEntry()
+//
+//*****************************************************************************
+
+VOID
+AddReplayEntry (
+    PREPLAY_ENTRY   Entry,
+    ULONG           Type,
+    ULONG           Key1,
+    ULONG           Key2,
+    ULONG           Key3,
+    PUCHAR          KeyBytes,
+    ULONG           KeySize,
+    PTRACE_RECORD   Record
+)
+{
+    ULONG bucket;
+
+    if (KeySize > TRACE_KEY_BYTES)
+    {
+        KeySize = TRACE_KEY_BYTES;
+    }
+
+    Entry->Type    = Type;
+    Entry->Key1    = Key1;
+    Entry->Key2    = Key2;
+    Entry->Key3    = Key3;
+    Entry->KeySize = KeySize;
+    Entry->Record  = Record;
+
+    if (KeySize != 0)
+    {
+        memcpy(Entry->KeyBytes, KeyBytes, KeySize);
+    }
+
+    bucket = HashReplayKey(Type, Key1, Key2, Key3, Entry->KeyBytes, KeySize);
+
+    Entry->Next = ReplayBuckets[bucket];
+    ReplayBuckets[bucket] = Entry;
+}
+
+//*****************************************************************************
+//
+// FindReplayPath()
+//
+// Returns the index of the recorded open of DevicePath, or -1.
+//
+//*****************************************************************************
+
+LONG
+FindReplayPath (
+    PCTSTR DevicePath
+)
+{
+    ULONG i;
+
+    for (i = 0; i < ReplayPathCount; i++)
+    {
+        if (_tcsicmp(ReplayPaths[i]->DevicePath, DevicePath) == 0)
+        {
+            return (LONG)i;
+        }
+    }
+
+    return -1;
+}
+
+//*****************************************************************************
+//
+// CheckTracePath()
+//
+// Returns TRUE if the path starting at Path ends with a NUL within Size
+// bytes.
+//
+//*****************************************************************************
+
+BOOL
+CheckTracePath (
+    PCTSTR  Path,
+    ULONG   Size
+)
+{
+    ULONG i;
+
+    for (i = 0; i < Size / sizeof(TCHAR); i++)
+    {
+        if (Path[i] == 0)
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+//*****************************************************************************
+//
+// CheckTraceRecord()
+//
+// Record - A record whose Length is known to fit in the trace.  Returns
+// TRUE if what replay reads from it stays within Length: the fixed part of
+// its type, the request and response bytes of an IOCTL, the data of a
+// devnode call and the NUL of a path.
+//
+//*****************************************************************************
+
+BOOL
+CheckTraceRecord (
+    PTRACE_RECORD   Record
+)
+{
+    ULONG   size;
+
+    switch (Record->Type)
+    {
+        case TraceRecordOpen:
+        {
+            PTRACE_OPEN_RECORD openRecord;
+
+            openRecord = (PTRACE_OPEN_RECORD)Record;
+
+            if (Record->Length < FIELD_OFFSET(TRACE_OPEN_RECORD, DevicePath))
+            {
+                return FALSE;
+            }
+
+            size = Record->Length - FIELD_OFFSET(TRACE_OPEN_RECORD, DevicePath);
+
+            return CheckTracePath(openRecord->DevicePath, size);
+        }
+
+        case TraceRecordIoctl:
+        {
+            PTRACE_IOCTL_RECORD ioctlRecord;
+
+            ioctlRecord = (PTRACE_IOCTL_RECORD)Record;
+
+            if (Record->Length < FIELD_OFFSET(TRACE_IOCTL_RECORD, Data))
+            {
+                return FALSE;
+            }
+
+            size = Record->Length - FIELD_OFFSET(TRACE_IOCTL_RECORD, Data);
+
+            return ioctlRecord->InSize <= size &&
+                   ioctlRecord->Returned <= size - ioctlRecord->InSize;
+        }
+
+        case TraceRecordInterface:
+        {
+            PTRACE_INTERFACE_RECORD interfaceRecord;
+
+            interfaceRecord = (PTRACE_INTERFACE_RECORD)Record;
+
+            if (Record->Length < FIELD_OFFSET(TRACE_INTERFACE_RECORD, DevicePath))
+            {
+                return FALSE;
+            }
+
+            size = Record->Length - FIELD_OFFSET(TRACE_INTERFACE_RECORD, DevicePath);
+
+            return CheckTracePath(interfaceRecord->DevicePath, size);
+        }
+
+        case TraceRecordDevNode:
+        {
+            PTRACE_DEVNODE_RECORD devNodeRecord;
+
+            devNodeRecord = (PTRACE_DEVNODE_RECORD)Record;
+
+            if (Record->Length < FIELD_OFFSET(TRACE_DEVNODE_RECORD, Data))
+            {
+                return FALSE;
+            }
+
+            size = Record->Length - FIELD_OFFSET(TRACE_DEVNODE_RECORD, Data);
+
+            return devNodeRecord->DataSize <= size;
+        }
+
+        default:
+            // Not replayed
+            //
+            return TRUE;
+    }
+}
+
+//*****************************************************************************
+//
+// StartTraceReplay()
+//
+// FileName - Trace file written by StartTraceRecording().
+//
+// EmulateLatency - If TRUE each replayed call sleeps for the latency that
+// was recorded for it, so that timing comparisons are meaningful.
+//
+//*****************************************************************************
+
+BOOL
+StartTraceReplay (
+    __in PCTSTR FileName,
+    BOOL        EmulateLatency
+)
+{
+    HANDLE              hFile;
+    DWORD               nBytes;
+    PTRACE_FILE_HEADER  header;
+    PTRACE_RECORD       record;
+    ULONG               offset;
+    ULONG               numRecords;
+    ULONG               numOpens;
+    ULONG               *handlePaths;
+    ULONG               maxHandleId;
+    ULONG               i;
+
+    if (ReplayImage != NULL)
+    {
+        return FALSE;
+    }
+
+    hFile = CreateFile(FileName,
+                       GENERIC_READ,
+                       FILE_SHARE_READ,
+                       NULL,
+                       OPEN_EXISTING,
+                       FILE_FLAG_SEQUENTIAL_SCAN,
+                       NULL);
+
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        return FALSE;
+    }
+
+    ReplayImageSize = GetFileSize(hFile, NULL);
+
+    if (ReplayImageSize < sizeof(TRACE_FILE_HEADER) ||
+        ReplayImageSize == INVALID_FILE_SIZE)
+    {
+        CloseHandle(hFile);
+        return FALSE;
+    }
+
+    ReplayImage = ALLOC(ReplayImageSize);
+
+    if (ReplayImage == NULL)
+    {
+        CloseHandle(hFile);
+        return FALSE;
+    }
+
+    if (!ReadFile(hFile, ReplayImage, ReplayImageSize, &nBytes, NULL) ||
+        nBytes != ReplayImageSize)
+    {
+        goto StartTraceReplayError;
+    }
+
+    CloseHandle(hFile);
+    hFile = INVALID_HANDLE_VALUE;
+
+    header = (PTRACE_FILE_HEADER)ReplayImage;
+
+    if (header->Signature != TRACE_SIGNATURE ||
+        header->Version != TRACE_VERSION ||
+        header->CharSize != sizeof(TCHAR))
+    {
+        goto StartTraceReplayError;
+    }
+
+    // First pass, validate the record chain and each record, and count
+    // things so the tables can be allocated in one go.  Nothing from a
+    // trace which fails is replayed.
+    //
+    numRecords  = 0;
+    numOpens    = 0;
+    maxHandleId = 0;
+
+    for (offset = sizeof(TRACE_FILE_HEADER);
+         offset + sizeof(TRACE_RECORD) <= ReplayImageSize;
+         offset += record->Length)
+    {
+        record = (PTRACE_RECORD)(ReplayImage + offset);
+
+        if (record->Length < sizeof(TRACE_RECORD) ||
+            record->Length > ReplayImageSize - offset ||
+            !CheckTraceRecord(record))
+        {
+            goto StartTraceReplayError;
+        }
+
+        numRecords++;
+
+        if (record->Type == TraceRecordOpen)
+        {
+            numOpens++;
+
+            if (record->HandleId > maxHandleId)
+            {
+                maxHandleId = record->HandleId;
+            }
+        }
+    }
+
+    // Handle ids are given out one per successful open
+    //
+    if (maxHandleId > numOpens)
+    {
+        goto StartTraceReplayError;
+    }
+
+    ReplayPaths   = ALLOC((numOpens + 1) * sizeof(PTRACE_OPEN_RECORD));
+    ReplayEntries = ALLOC((numRecords + 1) * sizeof(REPLAY_ENTRY));
+    handlePaths   = ALLOC((maxHandleId + 1) * sizeof(ULONG));
+
+    if (ReplayPaths == NULL || ReplayEntries == NULL || handlePaths == NULL)
+    {
+        if (handlePaths != NULL)
+        {
+            FREE(handlePaths);
+        }
+        goto StartTraceReplayError;
+    }
+
+    ReplayPathCount = 0;
+    memset(ReplayBuckets, 0, sizeof(ReplayBuckets));
+
+    // Second pass, build the path table and the hash of responses.
+    //
+    i = 0;
+
+    for (offset = sizeof(TRACE_FILE_HEADER);
+         offset + sizeof(TRACE_RECORD) <= ReplayImageSize;
+         offset += record->Length)
+    {
+        record = (PTRACE_RECORD)(ReplayImage + offset);
+
+        switch (record->Type)
+        {
+            case TraceRecordOpen:
+            {
+                PTRACE_OPEN_RECORD  openRecord;
+                LONG                pathIndex;
+
+                openRecord = (PTRACE_OPEN_RECORD)record;
+
+                pathIndex = FindReplayPath(openRecord->DevicePath);
+
+                if (pathIndex < 0)
+                {
+                    pathIndex = ReplayPathCount++;
+                    ReplayPaths[pathIndex] = openRecord;
+                }
+                else if (openRecord->Success)
+                {
+                    // Prefer a successful open if the path was seen before
+                    //
+                    ReplayPaths[pathIndex] = openRecord;
+                }
+
+                if (record->HandleId != 0)
+                {
+                    handlePaths[record->HandleId] = pathIndex;
+                }
+                break;
+            }
+
+            case TraceRecordIoctl:
+            {
+                PTRACE_IOCTL_RECORD ioctlRecord;
+
+                ioctlRecord = (PTRACE_IOCTL_RECORD)record;
+
+                if (record->HandleId == 0 || record->HandleId > maxHandleId)
+                {
+                    break;
+                }
+
+                AddReplayEntry(&ReplayEntries[i++],
+                               TraceRecordIoctl,
+                               handlePaths[record->HandleId],
+                               ioctlRecord->IoControlCode,
+                               0,
+                               ioctlRecord->Data,
+                               ioctlRecord->InSize,
+                               record);
+                break;
+            }
+
+            case TraceRecordDevNode:
+            {
+                PTRACE_DEVNODE_RECORD devNodeRecord;
+
+                devNodeRecord = (PTRACE_DEVNODE_RECORD)record;
+
+                AddReplayEntry(&ReplayEntries[i++],
+                               TraceRecordDevNode,
+                               devNodeRecord->DevInst,
+                               devNodeRecord->Operation,
+                               devNodeRecord->Property,
+                               NULL,
+                               0,
+                               record);
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+
+    FREE(handlePaths);
+
+    QueryPerformanceFrequency(&TraceFrequency);
+
+    ReplayEmulateLatency = EmulateLatency;
+    ReplayMisses = 0;
+
+    ReplayPrevious = SetDeviceBackend(&ReplayBackend);
+
+    return TRUE;
+
+StartTraceReplayError:
+
+    if (hFile != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(hFile);
+    }
+
+    StopTraceReplay();
+
+    return FALSE;
+}
+
+//*****************************************************************************
+//
+// StopTraceReplay()
+//
+//*****************************************************************************
+
+VOID
+StopTraceReplay (
+    VOID
+)
+{
+    if (GetDeviceBackend() == &ReplayBackend)
+    {
+        SetDeviceBackend(ReplayPrevious);
+    }
+
+    if (ReplayEntries != NULL)
+    {
+        FREE(ReplayEntries);
+        ReplayEntries = NULL;
+    }
+
+    if (ReplayPaths != NULL)
+    {
+        FREE(ReplayPaths);
+        ReplayPaths = NULL;
+    }
+
+    if (ReplayImage != NULL)
+    {
+        FREE(ReplayImage);
+        ReplayImage = NULL;
+    }
+
+    ReplayPathCount = 0;
+    memset(ReplayBuckets, 0, sizeof(ReplayBuckets));
+}
+
+//*****************************************************************************
+//
+// GetTraceReplayMisses()
+//
+// Number of replayed requests which had no matching recorded response.
+//
+//*****************************************************************************
+
+ULONG
+GetTraceReplayMisses (
+    VOID
+)
+{
+    return (ULONG)ReplayMisses;
+}
+
+//*****************************************************************************
+//
+// ReplayDelayMs()
+//
+// Returns how long the replay of Record should take, in milliseconds.
+//
+//*****************************************************************************
+
+ULONG
+ReplayDelayMs (
+    PTRACE_RECORD Record
+)
+{
+    if (ReplayEmulateLatency && Record->LatencyUs >= 500)
+    {
+        return (Record->LatencyUs + 500) / 1000;
+    }
+
+    return 0;
+}
+
+//*****************************************************************************
+//
+// ReplayDelay()
+//
+//*****************************************************************************
+
+VOID
+ReplayDelay (
+    PTRACE_RECORD Record
+)
+{
+    ULONG delay;
+
+    delay = ReplayDelayMs(Record);
+
+    if (delay != 0)
+    {
+        Sleep(delay);
+    }
+}
+
+//*****************************************************************************
+//
+// ReplayOpenDevice()
+//
+//*****************************************************************************
+
+HANDLE
+ReplayOpenDevice (
+    PCTSTR  DevicePath,
+    DWORD   FlagsAndAttributes
+)
+{
+    PREPLAY_HANDLE  replayHandle;
+    LONG            pathIndex;
+
+    UNREFERENCED_PARAMETER(FlagsAndAttributes);
+
+    pathIndex = FindReplayPath(DevicePath);
+
+    if (pathIndex < 0 || !ReplayPaths[pathIndex]->Success)
+    {
+        SetLastError(ERROR_FILE_NOT_FOUND);
+        return INVALID_HANDLE_VALUE;
+    }
+
+    ReplayDelay(&ReplayPaths[pathIndex]->Header);
+
+    replayHandle = ALLOC(sizeof(REPLAY_HANDLE));
+
+    if (replayHandle == NULL)
+    {
+        SetLastError(ERROR_NOT_ENOUGH_MEMORY);
+        return INVALID_HANDLE_VALUE;
+    }
+
+    replayHandle->Signature = REPLAY_HANDLE_SIGNATURE;
+    replayHandle->PathIndex = (ULONG)pathIndex;
+
+    return (HANDLE)replayHandle;
+}
+
+//*****************************************************************************
+//
+// ReplayCloseDevice()
+//
+//*****************************************************************************
+
+BOOL
+ReplayCloseDevice (
+    HANDLE  hDevice
+)
+{
+    PREPLAY_HANDLE replayHandle;
+
+    replayHandle = (PREPLAY_HANDLE)hDevice;
+
+    if (replayHandle == NULL ||
+        replayHandle->Signature != REPLAY_HANDLE_SIGNATURE)
+    {
+        SetLastError(ERROR_INVALID_HANDLE);
+        return FALSE;
+    }
+
+    replayHandle->Signature = 0;
+
+    FREE(replayHandle);
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// ReplayDeviceIoControl()
+//
+// Serves the best recorded response: the largest one that fits the
+// caller's buffer.  If none does, the request fails as it would on a real
+// device, with ERROR_MORE_DATA and what fits of the smallest one, or with
+// ERROR_INSUFFICIENT_BUFFER if there is no buffer at all.
+//
+//*****************************************************************************
+
+BOOL
+ReplayDeviceIoControl (
+    HANDLE          hDevice,
+    DWORD           IoControlCode,
+    PVOID           InBuffer,
+    DWORD           InBufferSize,
+    PVOID           OutBuffer,
+    DWORD           OutBufferSize,
+    PDWORD          BytesReturned,
+    LPOVERLAPPED    Overlapped
+)
+{
+    PREPLAY_HANDLE      replayHandle;
+    PREPLAY_ENTRY       entry;
+    PTRACE_IOCTL_RECORD best;
+    PTRACE_IOCTL_RECORD candidate;
+    ULONG               keySize;
+    ULONG               returned;
+    BOOL                success;
+    DWORD               lastError;
+
+    replayHandle = (PREPLAY_HANDLE)hDevice;
+
+    if (replayHandle == NULL ||
+        replayHandle->Signature != REPLAY_HANDLE_SIGNATURE)
+    {
+        SetLastError(ERROR_INVALID_HANDLE);
+        return FALSE;
+    }
+
+    keySize = (InBuffer != NULL) ? min(InBufferSize, TRACE_KEY_BYTES) : 0;
+
+    best = NULL;
+
+    for (entry = ReplayBuckets[HashReplayKey(TraceRecordIoctl,
+                                             replayHandle->PathIndex,
+                                             IoControlCode,
+                                             0,
+                                             (PUCHAR)InBuffer,
+                                             keySize)];
+         entry != NULL;
+         entry = entry->Next)
+    {
+        if (entry->Type != TraceRecordIoctl ||
+            entry->Key1 != replayHandle->PathIndex ||
+            entry->Key2 != IoControlCode ||
+            entry->KeySize != keySize ||
+            (keySize != 0 && memcmp(entry->KeyBytes, InBuffer, keySize) != 0))
+        {
+            continue;
+        }
+
+        candidate = (PTRACE_IOCTL_RECORD)entry->Record;
+
+        if (best == NULL)
+        {
+            best = candidate;
+        }
+        else if (candidate->Returned <= OutBufferSize)
+        {
+            if (best->Returned > OutBufferSize ||
+                candidate->Returned > best->Returned)
+            {
+                best = candidate;
+            }
+        }
+        else if (best->Returned > OutBufferSize &&
+                 candidate->Returned < best->Returned)
+        {
+            best = candidate;
+        }
+    }
+
+    if (best == NULL)
+    {
+        InterlockedIncrement(&ReplayMisses);
+        SetLastError(ERROR_NOT_FOUND);
+        return FALSE;
+    }
+
+    if (best->Returned <= OutBufferSize)
+    {
+        success = best->Success;
+        lastError = best->LastError;
+        returned = best->Returned;
+    }
+    else
+    {
+        success = FALSE;
+        lastError = (OutBufferSize != 0) ? ERROR_MORE_DATA :
+                                           ERROR_INSUFFICIENT_BUFFER;
+        returned = OutBufferSize;
+    }
+
+    if (returned != 0)
+    {
+        memcpy(OutBuffer, best->Data + best->InSize, returned);
+    }
+
+    if (BytesReturned != NULL)
+    {
+        *BytesReturned = returned;
+    }
+
+    // With latency emulation an overlapped request completes later, as
+    // the recorded one did.
+    //
+    return CompleteEmulatedRequest(Overlapped,
+                                   success,
+                                   lastError,
+                                   returned,
+                                   ReplayDelayMs(&best->Header));
+}
+
+//*****************************************************************************
+//
+// ReplayGetOverlappedResult()
+//
+//*****************************************************************************
+
+BOOL
+ReplayGetOverlappedResult (
+    HANDLE          hDevice,
+    LPOVERLAPPED    Overlapped,
+    PDWORD          BytesReturned,
+    BOOL            Wait
+)
+{
+    UNREFERENCED_PARAMETER(hDevice);
+
+    return GetEmulatedOverlappedResult(Overlapped, BytesReturned, Wait);
+}
+
+//*****************************************************************************
+//
+// ReplayEnumInterfaces()
+//
+//*****************************************************************************
+
+BOOL
+ReplayEnumInterfaces (
+    LPGUID                  InterfaceGuid,
+    LPFNINTERFACECALLBACK   Callback,
+    PVOID                   Context
+)
+{
+    PTRACE_RECORD           record;
+    PTRACE_INTERFACE_RECORD interfaceRecord;
+    ULONG                   offset;
+
+    for (offset = sizeof(TRACE_FILE_HEADER);
+         offset + sizeof(TRACE_RECORD) <= ReplayImageSize;
+         offset += record->Length)
+    {
+        record = (PTRACE_RECORD)(ReplayImage + offset);
+
+        if (record->Type != TraceRecordInterface)
+        {
+            continue;
+        }
+
+        interfaceRecord = (PTRACE_INTERFACE_RECORD)record;
+
+        if (memcmp(&interfaceRecord->InterfaceGuid,
+                   InterfaceGuid,
+                   sizeof(GUID)) != 0)
+        {
+            continue;
+        }
+
+        if (!(*Callback)(Context, interfaceRecord->DevicePath))
+        {
+            break;
+        }
+    }
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// FindDevNodeRecord()
+//
+//*****************************************************************************
+
+PTRACE_DEVNODE_RECORD
+FindDevNodeRecord (
+    ULONG   Operation,
+    DEVINST DevInst,
+    ULONG   Property
+)
+{
+    PREPLAY_ENTRY entry;
+
+    for (entry = ReplayBuckets[HashReplayKey(TraceRecordDevNode,
+                                             DevInst,
+                                             Operation,
+                                             Property,
+                                             NULL,
+                                             0)];
+         entry != NULL;
+         entry = entry->Next)
+    {
+        if (entry->Type == TraceRecordDevNode &&
+            entry->Key1 == DevInst &&
+            entry->Key2 == Operation &&
+            entry->Key3 == Property)
+        {
+            ReplayDelay(entry->Record);
+
+            return (PTRACE_DEVNODE_RECORD)entry->Record;
+        }
+    }
+
+    InterlockedIncrement(&ReplayMisses);
+
+    return NULL;
+}
+
+//*****************************************************************************
+//
+// ReplayDevNodeLink()
+//
+// Common code for the devnode tree navigation calls.
+//
+//*****************************************************************************
+
+CONFIGRET
+ReplayDevNodeLink (
+    ULONG       Operation,
+    PDEVINST    DevInstOut,
+    DEVINST     DevInst
+)
+{
+    PTRACE_DEVNODE_RECORD record;
+
+    record = FindDevNodeRecord(Operation, DevInst, 0);
+
+    if (record == NULL)
+    {
+        return CR_NO_SUCH_DEVNODE;
+    }
+
+    if (record->Result == CR_SUCCESS)
+    {
+        *DevInstOut = record->DevInstOut;
+    }
+
+    return record->Result;
+}
+
+CONFIGRET
+ReplayLocateDevNode (
+    PDEVINST    DevInst
+)
+{
+    return ReplayDevNodeLink(TraceLocateDevNode, DevInst, 0);
+}
+
+CONFIGRET
+ReplayGetChild (
+    PDEVINST    DevInstChild,
+    DEVINST     DevInst
+)
+{
+    return ReplayDevNodeLink(TraceGetChild, DevInstChild, DevInst);
+}
+
+CONFIGRET
+ReplayGetSibling (
+    PDEVINST    DevInstSibling,
+    DEVINST     DevInst
+)
+{
+    return ReplayDevNodeLink(TraceGetSibling, DevInstSibling, DevInst);
+}
+
+CONFIGRET
+ReplayGetParent (
+    PDEVINST    DevInstParent,
+    DEVINST     DevInst
+)
+{
+    return ReplayDevNodeLink(TraceGetParent, DevInstParent, DevInst);
+}
+
+//*****************************************************************************
+//
+// ReplayGetDevNodeProperty()
+//
+// Length - In and out, in bytes.
+//
+//*****************************************************************************
+
+CONFIGRET
+ReplayGetDevNodeProperty (
+    DEVINST     DevInst,
+    ULONG       Property,
+    PVOID       Buffer,
+    PULONG      Length
+)
+{
+    PTRACE_DEVNODE_RECORD record;
+
+    record = FindDevNodeRecord(TraceGetProperty, DevInst, Property);
+
+    if (record == NULL)
+    {
+        return CR_NO_SUCH_VALUE;
+    }
+
+    if (record->Result != CR_SUCCESS)
+    {
+        return record->Result;
+    }
+
+    if (record->DataSize > *Length)
+    {
+        *Length = record->DataSize;
+        return CR_BUFFER_SMALL;
+    }
+
+    memcpy(Buffer, record->Data, record->DataSize);
+
+    *Length = record->DataSize;
+
+    return CR_SUCCESS;
+}
+
+//*****************************************************************************
+//
+// ReplayGetDeviceId()
+//
+// Length - In characters.
+//
+//*****************************************************************************
+
+CONFIGRET
+ReplayGetDeviceId (
+    DEVINST     DevInst,
+    PTSTR       Buffer,
+    ULONG       Length
+)
+{
+    PTRACE_DEVNODE_RECORD record;
+
+    record = FindDevNodeRecord(TraceGetDeviceId, DevInst, 0);
+
+    if (record == NULL)
+    {
+        return CR_NO_SUCH_DEVNODE;
+    }
+
+    if (record->Result != CR_SUCCESS)
+    {
+        return record->Result;
+    }
+
+    if (record->DataSize > Length * sizeof(TCHAR))
+    {
+        return CR_BUFFER_SMALL;
+    }
+
+    memcpy(Buffer, record->Data, record->DataSize);
+
+    return CR_SUCCESS;
+}
+
+#if _MSC_VER >= 1200
+#pragma warning(pop)
+#endif
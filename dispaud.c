@@ -11,6 +11,8 @@ Abstract:
 This source file contains routines which update the edit control
 to display information about USB Audio descriptors.
 
+The routines are found through AudioClassDecoders, see CLASSDEC.C.
+
 Environment:
 
 user mode
@@ -269,96 +271,76 @@ FormatTypeCodeToName (
 
 
 //*****************************************************************************
-// L O C A L    F U N C T I O N S
+// G L O B A L S
 //*****************************************************************************
 
-
-
-//*****************************************************************************
-//
-// DisplayAudioDescriptor()
-//
-// CommonDesc - An Audio Class Descriptor
-//
-// bInterfaceSubClass - The SubClass of the Interface containing the descriptor
-//
-//*****************************************************************************
-
-BOOL
-DisplayAudioDescriptor (
-    PUSB_AUDIO_COMMON_DESCRIPTOR CommonDesc,
-    UCHAR                        bInterfaceSubClass
-)
+CLASS_DESC_DECODER AudioClassDecoders[] =
 {
-    switch (CommonDesc->bDescriptorType)
-    {
-        case USB_AUDIO_CS_INTERFACE:
-            switch (bInterfaceSubClass)
-            {
-                case USB_AUDIO_SUBCLASS_AUDIOCONTROL:
-                    switch (CommonDesc->bDescriptorSubtype)
-                    {
-                        case USB_AUDIO_AC_HEADER:
-                            return DisplayACHeader((PUSB_AUDIO_AC_INTERFACE_HEADER_DESCRIPTOR)CommonDesc);
-
-                        case USB_AUDIO_AC_INPUT_TERMINAL:
-                            return DisplayACInputTerminal((PUSB_AUDIO_INPUT_TERMINAL_DESCRIPTOR)CommonDesc);
-
-                        case USB_AUDIO_AC_OUTPUT_TERMINAL:
-                            return DisplayACOutputTerminal((PUSB_AUDIO_OUTPUT_TERMINAL_DESCRIPTOR)CommonDesc);
-
-                        case USB_AUDIO_AC_MIXER_UNIT:
-                            return DisplayACMixerUnit((PUSB_AUDIO_MIXER_UNIT_DESCRIPTOR)CommonDesc);
-
-                        case USB_AUDIO_AC_SELECTOR_UNIT:
-                            return DisplayACSelectorUnit((PUSB_AUDIO_SELECTOR_UNIT_DESCRIPTOR)CommonDesc);
+    //
+    // Audio Control Interface
+    //
+    {USB_DEVICE_CLASS_AUDIO, USB_AUDIO_SUBCLASS_AUDIOCONTROL,
+     USB_AUDIO_CS_INTERFACE, USB_AUDIO_AC_HEADER,
+     (LPFNDISPLAYCLASSDESC)DisplayACHeader},
 
-                        case USB_AUDIO_AC_FEATURE_UNIT:
-                            return DisplayACFeatureUnit((PUSB_AUDIO_FEATURE_UNIT_DESCRIPTOR)CommonDesc);
+    {USB_DEVICE_CLASS_AUDIO, USB_AUDIO_SUBCLASS_AUDIOCONTROL,
+     USB_AUDIO_CS_INTERFACE, USB_AUDIO_AC_INPUT_TERMINAL,
+     (LPFNDISPLAYCLASSDESC)DisplayACInputTerminal},
 
-                        case USB_AUDIO_AC_PROCESSING_UNIT:
-                            return DisplayACProcessingUnit((PUSB_AUDIO_PROCESSING_UNIT_DESCRIPTOR)CommonDesc);
+    {USB_DEVICE_CLASS_AUDIO, USB_AUDIO_SUBCLASS_AUDIOCONTROL,
+     USB_AUDIO_CS_INTERFACE, USB_AUDIO_AC_OUTPUT_TERMINAL,
+     (LPFNDISPLAYCLASSDESC)DisplayACOutputTerminal},
 
-                        case USB_AUDIO_AC_EXTENSION_UNIT:
-                            return DisplayACExtensionUnit((PUSB_AUDIO_EXTENSION_UNIT_DESCRIPTOR)CommonDesc);
+    {USB_DEVICE_CLASS_AUDIO, USB_AUDIO_SUBCLASS_AUDIOCONTROL,
+     USB_AUDIO_CS_INTERFACE, USB_AUDIO_AC_MIXER_UNIT,
+     (LPFNDISPLAYCLASSDESC)DisplayACMixerUnit},
 
-                        default:
-                            break;
-                    }
-                    break;
+    {USB_DEVICE_CLASS_AUDIO, USB_AUDIO_SUBCLASS_AUDIOCONTROL,
+     USB_AUDIO_CS_INTERFACE, USB_AUDIO_AC_SELECTOR_UNIT,
+     (LPFNDISPLAYCLASSDESC)DisplayACSelectorUnit},
 
-                case USB_AUDIO_SUBCLASS_AUDIOSTREAMING:
-                    switch (CommonDesc->bDescriptorSubtype)
-                    {
-                        case USB_AUDIO_AS_GENERAL:
-                            return DisplayASGeneral((PUSB_AUDIO_GENERAL_DESCRIPTOR)CommonDesc);
+    {USB_DEVICE_CLASS_AUDIO, USB_AUDIO_SUBCLASS_AUDIOCONTROL,
+     USB_AUDIO_CS_INTERFACE, USB_AUDIO_AC_FEATURE_UNIT,
+     (LPFNDISPLAYCLASSDESC)DisplayACFeatureUnit},
 
-                        case USB_AUDIO_AS_FORMAT_TYPE:
-                            return DisplayASFormatType((PUSB_AUDIO_COMMON_FORMAT_DESCRIPTOR)CommonDesc);
-                            break;
+    {USB_DEVICE_CLASS_AUDIO, USB_AUDIO_SUBCLASS_AUDIOCONTROL,
+     USB_AUDIO_CS_INTERFACE, USB_AUDIO_AC_PROCESSING_UNIT,
+     (LPFNDISPLAYCLASSDESC)DisplayACProcessingUnit},
 
-                        case USB_AUDIO_AS_FORMAT_SPECIFIC:
-                            return DisplayASFormatSpecific(CommonDesc);
+    {USB_DEVICE_CLASS_AUDIO, USB_AUDIO_SUBCLASS_AUDIOCONTROL,
+     USB_AUDIO_CS_INTERFACE, USB_AUDIO_AC_EXTENSION_UNIT,
+     (LPFNDISPLAYCLASSDESC)DisplayACExtensionUnit},
+    //
+    // Audio Streaming Interface
+    //
+    {USB_DEVICE_CLASS_AUDIO, USB_AUDIO_SUBCLASS_AUDIOSTREAMING,
+     USB_AUDIO_CS_INTERFACE, USB_AUDIO_AS_GENERAL,
+     (LPFNDISPLAYCLASSDESC)DisplayASGeneral},
 
-                        default:
-                            break;
-                    }
-                    break;
+    {USB_DEVICE_CLASS_AUDIO, USB_AUDIO_SUBCLASS_AUDIOSTREAMING,
+     USB_AUDIO_CS_INTERFACE, USB_AUDIO_AS_FORMAT_TYPE,
+     (LPFNDISPLAYCLASSDESC)DisplayASFormatType},
 
-                default:
-                    break;
-            }
-            break;
+    {USB_DEVICE_CLASS_AUDIO, USB_AUDIO_SUBCLASS_AUDIOSTREAMING,
+     USB_AUDIO_CS_INTERFACE, USB_AUDIO_AS_FORMAT_SPECIFIC,
+     (LPFNDISPLAYCLASSDESC)DisplayASFormatSpecific},
+    //
+    // Audio Data Endpoint, in any subclass
+    //
+    {USB_DEVICE_CLASS_AUDIO, CLASS_DESC_ANY,
+     USB_AUDIO_CS_ENDPOINT, CLASS_DESC_ANY,
+     (LPFNDISPLAYCLASSDESC)DisplayCSEndpoint},
+    //
+    // Terminate List
+    //
+    {0, 0, 0, 0, NULL}
+};
 
-        case USB_AUDIO_CS_ENDPOINT:
-            return DisplayCSEndpoint((PUSB_AUDIO_ENDPOINT_DESCRIPTOR)CommonDesc);
 
-        default:
-            break;
-    }
+//*****************************************************************************
+// L O C A L    F U N C T I O N S
+//*****************************************************************************
 
-    return FALSE;
-}
 
 
 //*****************************************************************************
@@ -380,25 +362,25 @@ DisplayACHeader (
         return FALSE;
     }
 
-    AppendTextBuffer(_T("\r\nAudio Control Interface Header Descriptor:\r\n"));
+    AppendTextString(_T("\r\nAudio Control Interface Header Descriptor:\r\n"));
 
-    AppendTextBuffer(_T("bLength:              0x%02X\r\n"),
-                     HeaderDesc->bLength);
+    AppendTextHex(_T("bLength:              "),
+                  HeaderDesc->bLength, 2);
 
-    AppendTextBuffer(_T("bDescriptorType:      0x%02X\r\n"),
-                     HeaderDesc->bDescriptorType);
+    AppendTextHex(_T("bDescriptorType:      "),
+                  HeaderDesc->bDescriptorType, 2);
 
-    AppendTextBuffer(_T("bDescriptorSubtype:   0x%02X\r\n"),
-                     HeaderDesc->bDescriptorSubtype);
+    AppendTextHex(_T("bDescriptorSubtype:   "),
+                  HeaderDesc->bDescriptorSubtype, 2);
 
-    AppendTextBuffer(_T("bcdADC:             0x%04X\r\n"),
-                     HeaderDesc->bcdADC);
+    AppendTextHex(_T("bcdADC:             "),
+                  HeaderDesc->bcdADC, 4);
 
-    AppendTextBuffer(_T("wTotalLength:       0x%04X\r\n"),
-                     HeaderDesc->wTotalLength);
+    AppendTextHex(_T("wTotalLength:       "),
+                  HeaderDesc->wTotalLength, 4);
 
-    AppendTextBuffer(_T("bInCollection:        0x%02X\r\n"),
-                     HeaderDesc->bInCollection);
+    AppendTextHex(_T("bInCollection:        "),
+                  HeaderDesc->bInCollection, 2);
 
     for (i=0; i<HeaderDesc->bInCollection; i++)
     {
@@ -430,19 +412,19 @@ DisplayACInputTerminal (
         return FALSE;
     }
 
-    AppendTextBuffer(_T("\r\nAudio Control Input Terminal Descriptor:\r\n"));
+    AppendTextString(_T("\r\nAudio Control Input Terminal Descriptor:\r\n"));
 
-    AppendTextBuffer(_T("bLength:              0x%02X\r\n"),
-                     ITDesc->bLength);
+    AppendTextHex(_T("bLength:              "),
+                  ITDesc->bLength, 2);
 
-    AppendTextBuffer(_T("bDescriptorType:      0x%02X\r\n"),
-                     ITDesc->bDescriptorType);
+    AppendTextHex(_T("bDescriptorType:      "),
+                  ITDesc->bDescriptorType, 2);
 
-    AppendTextBuffer(_T("bDescriptorSubtype:   0x%02X\r\n"),
-                     ITDesc->bDescriptorSubtype);
+    AppendTextHex(_T("bDescriptorSubtype:   "),
+                  ITDesc->bDescriptorSubtype, 2);
 
-    AppendTextBuffer(_T("bTerminalID:          0x%02X\r\n"),
-                     ITDesc->bTerminalID);
+    AppendTextHex(_T("bTerminalID:          "),
+                  ITDesc->bTerminalID, 2);
 
     AppendTextBuffer(_T("wTerminalType:      0x%04X"),
                      ITDesc->wTerminalType);
@@ -456,23 +438,23 @@ DisplayACInputTerminal (
     }
     else
     {
-        AppendTextBuffer(_T("\r\n"));
+        AppendTextString(_T("\r\n"));
     }
 
-    AppendTextBuffer(_T("bAssocTerminal:       0x%02X\r\n"),
-                     ITDesc->bAssocTerminal);
+    AppendTextHex(_T("bAssocTerminal:       "),
+                  ITDesc->bAssocTerminal, 2);
 
-    AppendTextBuffer(_T("bNrChannels:          0x%02X\r\n"),
-                     ITDesc->bNrChannels);
+    AppendTextHex(_T("bNrChannels:          "),
+                  ITDesc->bNrChannels, 2);
 
-    AppendTextBuffer(_T("wChannelConfig:     0x%04X\r\n"),
-                     ITDesc->wChannelConfig);
+    AppendTextHex(_T("wChannelConfig:     "),
+                  ITDesc->wChannelConfig, 4);
 
-    AppendTextBuffer(_T("iChannelNames:        0x%02X\r\n"),
-                     ITDesc->iChannelNames);
+    AppendTextHex(_T("iChannelNames:        "),
+                  ITDesc->iChannelNames, 2);
 
-    AppendTextBuffer(_T("iTerminal:            0x%02X\r\n"),
-                     ITDesc->iTerminal);
+    AppendTextHex(_T("iTerminal:            "),
+                  ITDesc->iTerminal, 2);
 
 
     return TRUE;
@@ -498,19 +480,19 @@ DisplayACOutputTerminal (
         return FALSE;
     }
 
-    AppendTextBuffer(_T("\r\nAudio Control Output Terminal Descriptor:\r\n"));
+    AppendTextString(_T("\r\nAudio Control Output Terminal Descriptor:\r\n"));
 
-    AppendTextBuffer(_T("bLength:              0x%02X\r\n"),
-                     OTDesc->bLength);
+    AppendTextHex(_T("bLength:              "),
+                  OTDesc->bLength, 2);
 
-    AppendTextBuffer(_T("bDescriptorType:      0x%02X\r\n"),
-                     OTDesc->bDescriptorType);
+    AppendTextHex(_T("bDescriptorType:      "),
+                  OTDesc->bDescriptorType, 2);
 
-    AppendTextBuffer(_T("bDescriptorSubtype:   0x%02X\r\n"),
-                     OTDesc->bDescriptorSubtype);
+    AppendTextHex(_T("bDescriptorSubtype:   "),
+                  OTDesc->bDescriptorSubtype, 2);
 
-    AppendTextBuffer(_T("bTerminalID:          0x%02X\r\n"),
-                     OTDesc->bTerminalID);
+    AppendTextHex(_T("bTerminalID:          "),
+                  OTDesc->bTerminalID, 2);
 
     AppendTextBuffer(_T("wTerminalType:      0x%04X"),
                      OTDesc->wTerminalType);
@@ -524,17 +506,17 @@ DisplayACOutputTerminal (
     }
     else
     {
-        AppendTextBuffer(_T("\r\n"));
+        AppendTextString(_T("\r\n"));
     }
 
-    AppendTextBuffer(_T("bAssocTerminal:       0x%02X\r\n"),
-                     OTDesc->bAssocTerminal);
+    AppendTextHex(_T("bAssocTerminal:       "),
+                  OTDesc->bAssocTerminal, 2);
 
-    AppendTextBuffer(_T("bSoruceID:            0x%02X\r\n"),
-                     OTDesc->bSoruceID);
+    AppendTextHex(_T("bSoruceID:            "),
+                  OTDesc->bSoruceID, 2);
 
-    AppendTextBuffer(_T("iTerminal:            0x%02X\r\n"),
-                     OTDesc->iTerminal);
+    AppendTextHex(_T("iTerminal:            "),
+                  OTDesc->iTerminal, 2);
 
 
     return TRUE;
@@ -561,22 +543,22 @@ DisplayACMixerUnit (
         return FALSE;
     }
 
-    AppendTextBuffer(_T("\r\nAudio Control Mixer Unit Descriptor:\r\n"));
+    AppendTextString(_T("\r\nAudio Control Mixer Unit Descriptor:\r\n"));
 
-    AppendTextBuffer(_T("bLength:              0x%02X\r\n"),
-                     MixerDesc->bLength);
+    AppendTextHex(_T("bLength:              "),
+                  MixerDesc->bLength, 2);
 
-    AppendTextBuffer(_T("bDescriptorType:      0x%02X\r\n"),
-                     MixerDesc->bDescriptorType);
+    AppendTextHex(_T("bDescriptorType:      "),
+                  MixerDesc->bDescriptorType, 2);
 
-    AppendTextBuffer(_T("bDescriptorSubtype:   0x%02X\r\n"),
-                     MixerDesc->bDescriptorSubtype);
+    AppendTextHex(_T("bDescriptorSubtype:   "),
+                  MixerDesc->bDescriptorSubtype, 2);
 
-    AppendTextBuffer(_T("bUnitID:              0x%02X\r\n"),
-                     MixerDesc->bUnitID);
+    AppendTextHex(_T("bUnitID:              "),
+                  MixerDesc->bUnitID, 2);
 
-    AppendTextBuffer(_T("bNrInPins:            0x%02X\r\n"),
-                     MixerDesc->bNrInPins);
+    AppendTextHex(_T("bNrInPins:            "),
+                  MixerDesc->bNrInPins, 2);
 
     for (i=0; i<MixerDesc->bNrInPins; i++)
     {
@@ -587,16 +569,16 @@ DisplayACMixerUnit (
 
     data = &MixerDesc->baSourceID[MixerDesc->bNrInPins];
 
-    AppendTextBuffer(_T("bNrChannels:          0x%02X\r\n"),
-                     *data++);
+    AppendTextHex(_T("bNrChannels:          "),
+                  *data++, 2);
 
-    AppendTextBuffer(_T("wChannelConfig:     0x%04X\r\n"),
-                     *((PUSHORT)data)++);
+    AppendTextHex(_T("wChannelConfig:     "),
+                  *((PUSHORT)data)++, 4);
 
-    AppendTextBuffer(_T("iChannelNames:        0x%02X\r\n"),
-                     *data++);
+    AppendTextHex(_T("iChannelNames:        "),
+                  *data++, 2);
 
-    AppendTextBuffer(_T("bmControls:\r\n"));
+    AppendTextString(_T("bmControls:\r\n"));
 
     i = MixerDesc->bLength - 10 - MixerDesc->bNrInPins;
 
@@ -604,8 +586,8 @@ DisplayACMixerUnit (
 
     data += i;
 
-    AppendTextBuffer(_T("iMixer:               0x%02X\r\n"),
-                     *data);
+    AppendTextHex(_T("iMixer:               "),
+                  *data, 2);
 
     return TRUE;
 }
@@ -631,22 +613,22 @@ DisplayACSelectorUnit (
         return FALSE;
     }
 
-    AppendTextBuffer(_T("\r\nAudio Control Selector Unit Descriptor:\r\n"));
+    AppendTextString(_T("\r\nAudio Control Selector Unit Descriptor:\r\n"));
 
-    AppendTextBuffer(_T("bLength:              0x%02X\r\n"),
-                     SelectorDesc->bLength);
+    AppendTextHex(_T("bLength:              "),
+                  SelectorDesc->bLength, 2);
 
-    AppendTextBuffer(_T("bDescriptorType:      0x%02X\r\n"),
-                     SelectorDesc->bDescriptorType);
+    AppendTextHex(_T("bDescriptorType:      "),
+                  SelectorDesc->bDescriptorType, 2);
 
-    AppendTextBuffer(_T("bDescriptorSubtype:   0x%02X\r\n"),
-                     SelectorDesc->bDescriptorSubtype);
+    AppendTextHex(_T("bDescriptorSubtype:   "),
+                  SelectorDesc->bDescriptorSubtype, 2);
 
-    AppendTextBuffer(_T("bUnitID:              0x%02X\r\n"),
-                     SelectorDesc->bUnitID);
+    AppendTextHex(_T("bUnitID:              "),
+                  SelectorDesc->bUnitID, 2);
 
-    AppendTextBuffer(_T("bNrInPins:            0x%02X\r\n"),
-                     SelectorDesc->bNrInPins);
+    AppendTextHex(_T("bNrInPins:            "),
+                  SelectorDesc->bNrInPins, 2);
 
     for (i=0; i<SelectorDesc->bNrInPins; i++)
     {
@@ -657,8 +639,8 @@ DisplayACSelectorUnit (
 
     data = &SelectorDesc->baSourceID[SelectorDesc->bNrInPins];
 
-    AppendTextBuffer(_T("iSelector:            0x%02X\r\n"),
-                     *data);
+    AppendTextHex(_T("iSelector:            "),
+                  *data, 2);
 
     return TRUE;
 }
@@ -694,25 +676,25 @@ DisplayACFeatureUnit (
         return FALSE;
     }
 
-    AppendTextBuffer(_T("\r\nAudio Control Feature Unit Descriptor:\r\n"));
+    AppendTextString(_T("\r\nAudio Control Feature Unit Descriptor:\r\n"));
 
-    AppendTextBuffer(_T("bLength:              0x%02X\r\n"),
-                     FeatureDesc->bLength);
+    AppendTextHex(_T("bLength:              "),
+                  FeatureDesc->bLength, 2);
 
-    AppendTextBuffer(_T("bDescriptorType:      0x%02X\r\n"),
-                     FeatureDesc->bDescriptorType);
+    AppendTextHex(_T("bDescriptorType:      "),
+                  FeatureDesc->bDescriptorType, 2);
 
-    AppendTextBuffer(_T("bDescriptorSubtype:   0x%02X\r\n"),
-                     FeatureDesc->bDescriptorSubtype);
+    AppendTextHex(_T("bDescriptorSubtype:   "),
+                  FeatureDesc->bDescriptorSubtype, 2);
 
-    AppendTextBuffer(_T("bUnitID:              0x%02X\r\n"),
-                     FeatureDesc->bUnitID);
+    AppendTextHex(_T("bUnitID:              "),
+                  FeatureDesc->bUnitID, 2);
 
-    AppendTextBuffer(_T("bSourceID:            0x%02X\r\n"),
-                     FeatureDesc->bSourceID);
+    AppendTextHex(_T("bSourceID:            "),
+                  FeatureDesc->bSourceID, 2);
 
-    AppendTextBuffer(_T("bControlSize:         0x%02X\r\n"),
-                     FeatureDesc->bControlSize);
+    AppendTextHex(_T("bControlSize:         "),
+                  FeatureDesc->bControlSize, 2);
 
     data = &FeatureDesc->bmaControls[0];
 
@@ -726,8 +708,8 @@ DisplayACFeatureUnit (
         data += n;
     }
 
-    AppendTextBuffer(_T("iFeature:             0x%02X\r\n"),
-                     *data);
+    AppendTextHex(_T("iFeature:             "),
+                  *data, 2);
 
     return TRUE;
 }
@@ -753,19 +735,19 @@ DisplayACProcessingUnit (
         return FALSE;
     }
 
-    AppendTextBuffer(_T("\r\nAudio Control Processing Unit Descriptor:\r\n"));
+    AppendTextString(_T("\r\nAudio Control Processing Unit Descriptor:\r\n"));
 
-    AppendTextBuffer(_T("bLength:              0x%02X\r\n"),
-                     ProcessingDesc->bLength);
+    AppendTextHex(_T("bLength:              "),
+                  ProcessingDesc->bLength, 2);
 
-    AppendTextBuffer(_T("bDescriptorType:      0x%02X\r\n"),
-                     ProcessingDesc->bDescriptorType);
+    AppendTextHex(_T("bDescriptorType:      "),
+                  ProcessingDesc->bDescriptorType, 2);
 
-    AppendTextBuffer(_T("bDescriptorSubtype:   0x%02X\r\n"),
-                     ProcessingDesc->bDescriptorSubtype);
+    AppendTextHex(_T("bDescriptorSubtype:   "),
+                  ProcessingDesc->bDescriptorSubtype, 2);
 
-    AppendTextBuffer(_T("bUnitID:              0x%02X\r\n"),
-                     ProcessingDesc->bUnitID);
+    AppendTextHex(_T("bUnitID:              "),
+                  ProcessingDesc->bUnitID, 2);
 
     AppendTextBuffer(_T("wProcessType:       0x%04X"),
                      ProcessingDesc->wProcessType);
@@ -773,40 +755,40 @@ DisplayACProcessingUnit (
     switch (ProcessingDesc->wProcessType)
     {
         case USB_AUDIO_PROCESS_UNDEFINED:
-            AppendTextBuffer(_T("(Undefined Process)\r\n"));
+            AppendTextString(_T("(Undefined Process)\r\n"));
             break;
 
         case USB_AUDIO_PROCESS_UPDOWNMIX:
-            AppendTextBuffer(_T("(Up / Down Mix Process)\r\n"));
+            AppendTextString(_T("(Up / Down Mix Process)\r\n"));
             break;
 
         case USB_AUDIO_PROCESS_DOLBYPROLOGIC:
-            AppendTextBuffer(_T("(Dolby Prologic Process)\r\n"));
+            AppendTextString(_T("(Dolby Prologic Process)\r\n"));
             break;
 
         case USB_AUDIO_PROCESS_3DSTEREOEXTENDER:
-            AppendTextBuffer(_T("(3D-Stereo Extender Process)\r\n"));
+            AppendTextString(_T("(3D-Stereo Extender Process)\r\n"));
             break;
 
         case USB_AUDIO_PROCESS_REVERBERATION:
-            AppendTextBuffer(_T("(Reverberation Process)\r\n"));
+            AppendTextString(_T("(Reverberation Process)\r\n"));
             break;
 
         case USB_AUDIO_PROCESS_CHORUS:
-            AppendTextBuffer(_T("(Chorus Process)\r\n"));
+            AppendTextString(_T("(Chorus Process)\r\n"));
             break;
 
         case USB_AUDIO_PROCESS_DYNRANGECOMP:
-            AppendTextBuffer(_T("(Dynamic Range Compressor Process)\r\n"));
+            AppendTextString(_T("(Dynamic Range Compressor Process)\r\n"));
             break;
 
         default:
-            AppendTextBuffer(_T("\r\n"));
+            AppendTextString(_T("\r\n"));
             break;
     }
 
-    AppendTextBuffer(_T("bNrInPins:            0x%02X\r\n"),
-                     ProcessingDesc->bNrInPins);
+    AppendTextHex(_T("bNrInPins:            "),
+                  ProcessingDesc->bNrInPins, 2);
 
     for (i=0; i<ProcessingDesc->bNrInPins; i++)
     {
@@ -817,35 +799,35 @@ DisplayACProcessingUnit (
 
     data = &ProcessingDesc->baSourceID[ProcessingDesc->bNrInPins];
 
-    AppendTextBuffer(_T("bNrChannels:          0x%02X\r\n"),
-                     *data++);
+    AppendTextHex(_T("bNrChannels:          "),
+                  *data++, 2);
 
-    AppendTextBuffer(_T("wChannelConfig:     0x%04X\r\n"),
-                     *((PUSHORT)data)++);
+    AppendTextHex(_T("wChannelConfig:     "),
+                  *((PUSHORT)data)++, 4);
 
-    AppendTextBuffer(_T("iChannelNames:        0x%02X\r\n"),
-                     *data++);
+    AppendTextHex(_T("iChannelNames:        "),
+                  *data++, 2);
 
     i = *data++;
 
-    AppendTextBuffer(_T("bControlSize:         0x%02X\r\n"),
-                     i);
+    AppendTextHex(_T("bControlSize:         "),
+                  i, 2);
 
-    AppendTextBuffer(_T("bmControls:\r\n"));
+    AppendTextString(_T("bmControls:\r\n"));
 
     DisplayBytes(data, i);
 
     data += i;
 
-    AppendTextBuffer(_T("iProcessing:          0x%02X\r\n"),
-                     *data++);
+    AppendTextHex(_T("iProcessing:          "),
+                  *data++, 2);
 
 
     i = ProcessingDesc->bLength - 13 - ProcessingDesc->bNrInPins - i;
 
     if (i)
     {
-        AppendTextBuffer(_T("Process Specific:\r\n"));
+        AppendTextString(_T("Process Specific:\r\n"));
 
         DisplayBytes(data, i);
     }
@@ -874,26 +856,26 @@ DisplayACExtensionUnit (
         return FALSE;
     }
 
-    AppendTextBuffer(_T("\r\nAudio Control Extension Unit Descriptor:\r\n"));
+    AppendTextString(_T("\r\nAudio Control Extension Unit Descriptor:\r\n"));
 
-    AppendTextBuffer(_T("bLength:              0x%02X\r\n"),
-                     ExtensionDesc->bLength);
+    AppendTextHex(_T("bLength:              "),
+                  ExtensionDesc->bLength, 2);
 
-    AppendTextBuffer(_T("bDescriptorType:      0x%02X\r\n"),
-                     ExtensionDesc->bDescriptorType);
+    AppendTextHex(_T("bDescriptorType:      "),
+                  ExtensionDesc->bDescriptorType, 2);
 
-    AppendTextBuffer(_T("bDescriptorSubtype:   0x%02X\r\n"),
-                     ExtensionDesc->bDescriptorSubtype);
+    AppendTextHex(_T("bDescriptorSubtype:   "),
+                  ExtensionDesc->bDescriptorSubtype, 2);
 
-    AppendTextBuffer(_T("bUnitID:              0x%02X\r\n"),
-                     ExtensionDesc->bUnitID);
+    AppendTextHex(_T("bUnitID:              "),
+                  ExtensionDesc->bUnitID, 2);
 
-    AppendTextBuffer(_T("wExtensionCode:     0x%04X\r\n"),
-                     ExtensionDesc->wExtensionCode);
+    AppendTextHex(_T("wExtensionCode:     "),
+                  ExtensionDesc->wExtensionCode, 4);
 
 
-    AppendTextBuffer(_T("bNrInPins:            0x%02X\r\n"),
-                     ExtensionDesc->bNrInPins);
+    AppendTextHex(_T("bNrInPins:            "),
+                  ExtensionDesc->bNrInPins, 2);
 
     for (i=0; i<ExtensionDesc->bNrInPins; i++)
     {
@@ -904,28 +886,28 @@ DisplayACExtensionUnit (
 
     data = &ExtensionDesc->baSourceID[ExtensionDesc->bNrInPins];
 
-    AppendTextBuffer(_T("bNrChannels:          0x%02X\r\n"),
-                     *data++);
+    AppendTextHex(_T("bNrChannels:          "),
+                  *data++, 2);
 
-    AppendTextBuffer(_T("wChannelConfig:     0x%04X\r\n"),
-                     *((PUSHORT)data)++);
+    AppendTextHex(_T("wChannelConfig:     "),
+                  *((PUSHORT)data)++, 4);
 
-    AppendTextBuffer(_T("iChannelNames:        0x%02X\r\n"),
-                     *data++);
+    AppendTextHex(_T("iChannelNames:        "),
+                  *data++, 2);
 
     i = *data++;
 
-    AppendTextBuffer(_T("bControlSize:         0x%02X\r\n"),
-                     i);
+    AppendTextHex(_T("bControlSize:         "),
+                  i, 2);
 
-    AppendTextBuffer(_T("bmControls:\r\n"));
+    AppendTextString(_T("bmControls:\r\n"));
 
     DisplayBytes(data, i);
 
     data += i;
 
-    AppendTextBuffer(_T("iExtension:           0x%02X\r\n"),
-                     *data);
+    AppendTextHex(_T("iExtension:           "),
+                  *data, 2);
     return TRUE;
 }
 
@@ -949,22 +931,22 @@ DisplayASGeneral (
         return FALSE;
     }
 
-    AppendTextBuffer(_T("\r\nAudio Streaming Class Specific Interface Descriptor:\r\n"));
+    AppendTextString(_T("\r\nAudio Streaming Class Specific Interface Descriptor:\r\n"));
 
-    AppendTextBuffer(_T("bLength:              0x%02X\r\n"),
-                     GeneralDesc->bLength);
+    AppendTextHex(_T("bLength:              "),
+                  GeneralDesc->bLength, 2);
 
-    AppendTextBuffer(_T("bDescriptorType:      0x%02X\r\n"),
-                     GeneralDesc->bDescriptorType);
+    AppendTextHex(_T("bDescriptorType:      "),
+                  GeneralDesc->bDescriptorType, 2);
 
-    AppendTextBuffer(_T("bDescriptorSubtype:   0x%02X\r\n"),
-                     GeneralDesc->bDescriptorSubtype);
+    AppendTextHex(_T("bDescriptorSubtype:   "),
+                  GeneralDesc->bDescriptorSubtype, 2);
 
-    AppendTextBuffer(_T("bTerminalLink:        0x%02X\r\n"),
-                     GeneralDesc->bTerminalLink);
+    AppendTextHex(_T("bTerminalLink:        "),
+                  GeneralDesc->bTerminalLink, 2);
 
-    AppendTextBuffer(_T("bDelay:               0x%02X\r\n"),
-                     GeneralDesc->bDelay);
+    AppendTextHex(_T("bDelay:               "),
+                  GeneralDesc->bDelay, 2);
 
     AppendTextBuffer(_T("wFormatTag:         0x%04X"),
                      GeneralDesc->wFormatTag);
@@ -978,7 +960,7 @@ DisplayASGeneral (
     }
     else
     {
-        AppendTextBuffer(_T("\r\n"));
+        AppendTextString(_T("\r\n"));
     }
 
     return TRUE;
@@ -1002,25 +984,25 @@ DisplayCSEndpoint (
         return FALSE;
     }
 
-    AppendTextBuffer(_T("\r\nAudio Streaming Class Specific Audio Data Endpoint Descriptor:\r\n"));
+    AppendTextString(_T("\r\nAudio Streaming Class Specific Audio Data Endpoint Descriptor:\r\n"));
 
-    AppendTextBuffer(_T("bLength:              0x%02X\r\n"),
-                     EndpointDesc->bLength);
+    AppendTextHex(_T("bLength:              "),
+                  EndpointDesc->bLength, 2);
 
-    AppendTextBuffer(_T("bDescriptorType:      0x%02X\r\n"),
-                     EndpointDesc->bDescriptorType);
+    AppendTextHex(_T("bDescriptorType:      "),
+                  EndpointDesc->bDescriptorType, 2);
 
-    AppendTextBuffer(_T("bDescriptorSubtype:   0x%02X\r\n"),
-                     EndpointDesc->bDescriptorSubtype);
+    AppendTextHex(_T("bDescriptorSubtype:   "),
+                  EndpointDesc->bDescriptorSubtype, 2);
 
-    AppendTextBuffer(_T("bmAttributes:         0x%02X\r\n"),
-                     EndpointDesc->bmAttributes);
+    AppendTextHex(_T("bmAttributes:         "),
+                  EndpointDesc->bmAttributes, 2);
 
-    AppendTextBuffer(_T("bLockDelayUnits:      0x%02X\r\n"),
-                     EndpointDesc->bLockDelayUnits);
+    AppendTextHex(_T("bLockDelayUnits:      "),
+                  EndpointDesc->bLockDelayUnits, 2);
 
-    AppendTextBuffer(_T("wLockDelay:         0x%04X\r\n"),
-                     EndpointDesc->wLockDelay);
+    AppendTextHex(_T("wLockDelay:         "),
+                  EndpointDesc->wLockDelay, 4);
 
     return TRUE;
 }
@@ -1047,19 +1029,19 @@ DisplayASFormatType (
         return FALSE;
     }
 
-    AppendTextBuffer(_T("\r\nAudio Streaming Format Type Descriptor:\r\n"));
+    AppendTextString(_T("\r\nAudio Streaming Format Type Descriptor:\r\n"));
 
-    AppendTextBuffer(_T("bLength:              0x%02X\r\n"),
-                     FormatDesc->bLength);
+    AppendTextHex(_T("bLength:              "),
+                  FormatDesc->bLength, 2);
 
-    AppendTextBuffer(_T("bDescriptorType:      0x%02X\r\n"),
-                     FormatDesc->bDescriptorType);
+    AppendTextHex(_T("bDescriptorType:      "),
+                  FormatDesc->bDescriptorType, 2);
 
-    AppendTextBuffer(_T("bDescriptorSubtype:   0x%02X\r\n"),
-                     FormatDesc->bDescriptorSubtype);
+    AppendTextHex(_T("bDescriptorSubtype:   "),
+                  FormatDesc->bDescriptorSubtype, 2);
 
-    AppendTextBuffer(_T("bFormatType:          0x%02X\r\n"),
-                     FormatDesc->bFormatType);
+    AppendTextHex(_T("bFormatType:          "),
+                  FormatDesc->bFormatType, 2);
 
 
     if (FormatDesc->bFormatType == 0x01 ||
@@ -1069,17 +1051,17 @@ DisplayASFormatType (
 
         FormatI_IIIDesc = (PUSB_AUDIO_TYPE_I_OR_III_FORMAT_DESCRIPTOR)FormatDesc;
 
-        AppendTextBuffer(_T("bNrChannels:          0x%02X\r\n"),
-                         FormatI_IIIDesc->bNrChannels);
+        AppendTextHex(_T("bNrChannels:          "),
+                      FormatI_IIIDesc->bNrChannels, 2);
 
-        AppendTextBuffer(_T("bSubframeSize:        0x%02X\r\n"),
-                         FormatI_IIIDesc->bSubframeSize);
+        AppendTextHex(_T("bSubframeSize:        "),
+                      FormatI_IIIDesc->bSubframeSize, 2);
 
-        AppendTextBuffer(_T("bBitResolution:       0x%02X\r\n"),
-                         FormatI_IIIDesc->bBitResolution);
+        AppendTextHex(_T("bBitResolution:       "),
+                      FormatI_IIIDesc->bBitResolution, 2);
 
-        AppendTextBuffer(_T("bSamFreqType:         0x%02X\r\n"),
-                         FormatI_IIIDesc->bSamFreqType);
+        AppendTextHex(_T("bSamFreqType:         "),
+                      FormatI_IIIDesc->bSamFreqType, 2);
 
         data = (PUCHAR)(FormatI_IIIDesc + 1);
 
@@ -1092,14 +1074,14 @@ DisplayASFormatType (
 
         FormatIIDesc = (PUSB_AUDIO_TYPE_II_FORMAT_DESCRIPTOR)FormatDesc;
 
-        AppendTextBuffer(_T("wMaxBitRate:        0x%04X\r\n"),
-                         FormatIIDesc->wMaxBitRate);
+        AppendTextHex(_T("wMaxBitRate:        "),
+                      FormatIIDesc->wMaxBitRate, 4);
 
-        AppendTextBuffer(_T("wSamplesPerFrame:   0x%04X\r\n"),
-                         FormatIIDesc->wSamplesPerFrame);
+        AppendTextHex(_T("wSamplesPerFrame:   "),
+                      FormatIIDesc->wSamplesPerFrame, 4);
 
-        AppendTextBuffer(_T("bSamFreqType:         0x%02X\r\n"),
-                         FormatIIDesc->bSamFreqType);
+        AppendTextHex(_T("bSamFreqType:         "),
+                      FormatIIDesc->bSamFreqType, 2);
 
         data = (PUCHAR)(FormatIIDesc + 1);
 
@@ -1159,16 +1141,16 @@ DisplayASFormatSpecific (
     PUSB_AUDIO_COMMON_DESCRIPTOR CommonDesc
 )
 {
-    AppendTextBuffer(_T("\r\nAudio Streaming Format Specific Descriptor:\r\n"));
+    AppendTextString(_T("\r\nAudio Streaming Format Specific Descriptor:\r\n"));
 
-    AppendTextBuffer(_T("bLength:              0x%02X\r\n"),
-                     CommonDesc->bLength);
+    AppendTextHex(_T("bLength:              "),
+                  CommonDesc->bLength, 2);
 
-    AppendTextBuffer(_T("bDescriptorType:      0x%02X\r\n"),
-                     CommonDesc->bDescriptorType);
+    AppendTextHex(_T("bDescriptorType:      "),
+                  CommonDesc->bDescriptorType, 2);
 
-    AppendTextBuffer(_T("bDescriptorSubtype:   0x%02X\r\n"),
-                     CommonDesc->bDescriptorSubtype);
+    AppendTextHex(_T("bDescriptorSubtype:   "),
+                  CommonDesc->bDescriptorSubtype, 2);
 
     DisplayBytes((PUCHAR)(CommonDesc + 1),
                  CommonDesc->bLength);
@@ -1197,13 +1179,13 @@ DisplayBytes (
 
         if (i % 16 == 15)
         {
-            AppendTextBuffer(_T("\r\n"));
+            AppendTextString(_T("\r\n"));
         }
     }
 
     if (i % 16 != 0)
     {
-        AppendTextBuffer(_T("\r\n"));
+        AppendTextString(_T("\r\n"));
     }
 }
 
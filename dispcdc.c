@@ -0,0 +1,421 @@
+/*++
+
+Copyright (c) 1997-1998 Microsoft Corporation
+
+Module Name:
+
+    DISPCDC.C
+
+Abstract:
+
+    This source file contains routines which update the edit control
+    to display information about the Functional Descriptors of USB
+    Communications Class interfaces: serial (ACM), Ethernet (ECM and NCM)
+    and mobile broadband (MBIM) functions.
+
+    The routines are found through CdcClassDecoders, see CLASSDEC.C.
+
+Environment:
+
+    user mode
+
+Revision History:
+
+    10-16-26 : created
+
+--*/
+
+//*****************************************************************************
+// I N C L U D E S
+//*****************************************************************************
+
+#include <windows.h>
+#include <basetyps.h>
+#include <tchar.h>
+#include "usbview.h"
+
+//*****************************************************************************
+// L O C A L    F U N C T I O N    P R O T O T Y P E S
+//*****************************************************************************
+
+BOOL
+DisplayCdcHeader (
+    PUSB_CDC_HEADER_DESCRIPTOR HeaderDesc
+);
+
+BOOL
+DisplayCdcCallManagement (
+    PUSB_CDC_CALL_MANAGEMENT_DESCRIPTOR CallMgmtDesc
+);
+
+BOOL
+DisplayCdcAcm (
+    PUSB_CDC_ACM_DESCRIPTOR AcmDesc
+);
+
+BOOL
+DisplayCdcUnion (
+    PUSB_CDC_UNION_DESCRIPTOR UnionDesc
+);
+
+BOOL
+DisplayCdcEthernet (
+    PUSB_CDC_ETHERNET_DESCRIPTOR EthernetDesc
+);
+
+BOOL
+DisplayCdcNcm (
+    PUSB_CDC_NCM_DESCRIPTOR NcmDesc
+);
+
+BOOL
+DisplayCdcMbim (
+    PUSB_CDC_MBIM_DESCRIPTOR MbimDesc
+);
+
+VOID
+DisplayCdcCommon (
+    PCTSTR                      Title,
+    PUSB_CDC_COMMON_DESCRIPTOR  CommonDesc
+);
+
+//*****************************************************************************
+// G L O B A L S
+//*****************************************************************************
+
+//
+// The Functional Descriptors follow the Communications Interface
+// Descriptor, whatever its subclass
+//
+CLASS_DESC_DECODER CdcClassDecoders[] =
+{
+    {USB_DEVICE_CLASS_COMMUNICATIONS, CLASS_DESC_ANY,
+     USB_CDC_CS_INTERFACE, USB_CDC_HEADER,
+     (LPFNDISPLAYCLASSDESC)DisplayCdcHeader},
+
+    {USB_DEVICE_CLASS_COMMUNICATIONS, CLASS_DESC_ANY,
+     USB_CDC_CS_INTERFACE, USB_CDC_CALL_MANAGEMENT,
+     (LPFNDISPLAYCLASSDESC)DisplayCdcCallManagement},
+
+    {USB_DEVICE_CLASS_COMMUNICATIONS, CLASS_DESC_ANY,
+     USB_CDC_CS_INTERFACE, USB_CDC_ABSTRACT_CONTROL,
+     (LPFNDISPLAYCLASSDESC)DisplayCdcAcm},
+
+    {USB_DEVICE_CLASS_COMMUNICATIONS, CLASS_DESC_ANY,
+     USB_CDC_CS_INTERFACE, USB_CDC_UNION,
+     (LPFNDISPLAYCLASSDESC)DisplayCdcUnion},
+
+    {USB_DEVICE_CLASS_COMMUNICATIONS, CLASS_DESC_ANY,
+     USB_CDC_CS_INTERFACE, USB_CDC_ETHERNET_NETWORKING,
+     (LPFNDISPLAYCLASSDESC)DisplayCdcEthernet},
+
+    {USB_DEVICE_CLASS_COMMUNICATIONS, CLASS_DESC_ANY,
+     USB_CDC_CS_INTERFACE, USB_CDC_NCM,
+     (LPFNDISPLAYCLASSDESC)DisplayCdcNcm},
+
+    {USB_DEVICE_CLASS_COMMUNICATIONS, CLASS_DESC_ANY,
+     USB_CDC_CS_INTERFACE, USB_CDC_MBIM,
+     (LPFNDISPLAYCLASSDESC)DisplayCdcMbim},
+    //
+    // Terminate List
+    //
+    {0, 0, 0, 0, NULL}
+};
+
+
+//*****************************************************************************
+// L O C A L    F U N C T I O N S
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// DisplayCdcHeader()
+//
+//*****************************************************************************
+
+BOOL
+DisplayCdcHeader (
+    PUSB_CDC_HEADER_DESCRIPTOR HeaderDesc
+)
+{
+    if (HeaderDesc->bLength < sizeof(USB_CDC_HEADER_DESCRIPTOR))
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    DisplayCdcCommon(_T("Communications Class Header Functional Descriptor"),
+                     (PUSB_CDC_COMMON_DESCRIPTOR)HeaderDesc);
+
+    AppendTextHex(_T("bcdCDC:             "),
+                  HeaderDesc->bcdCDC, 4);
+
+    return TRUE;
+}
+
+
+//*****************************************************************************
+//
+// DisplayCdcCallManagement()
+//
+//*****************************************************************************
+
+BOOL
+DisplayCdcCallManagement (
+    PUSB_CDC_CALL_MANAGEMENT_DESCRIPTOR CallMgmtDesc
+)
+{
+    if (CallMgmtDesc->bLength < sizeof(USB_CDC_CALL_MANAGEMENT_DESCRIPTOR))
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    DisplayCdcCommon(_T("Communications Class Call Management Functional Descriptor"),
+                     (PUSB_CDC_COMMON_DESCRIPTOR)CallMgmtDesc);
+
+    AppendTextHex(_T("bmCapabilities:       "),
+                  CallMgmtDesc->bmCapabilities, 2);
+
+    if (CallMgmtDesc->bmCapabilities & 0x01)
+    {
+        AppendTextString(_T("  Handles call management\r\n"));
+    }
+
+    if (CallMgmtDesc->bmCapabilities & 0x02)
+    {
+        AppendTextString(_T("  Call management over the Data Class interface\r\n"));
+    }
+
+    AppendTextHex(_T("bDataInterface:       "),
+                  CallMgmtDesc->bDataInterface, 2);
+
+    return TRUE;
+}
+
+
+//*****************************************************************************
+//
+// DisplayCdcAcm()
+//
+//*****************************************************************************
+
+BOOL
+DisplayCdcAcm (
+    PUSB_CDC_ACM_DESCRIPTOR AcmDesc
+)
+{
+    if (AcmDesc->bLength < sizeof(USB_CDC_ACM_DESCRIPTOR))
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    DisplayCdcCommon(_T("Communications Class Abstract Control Management Functional Descriptor"),
+                     (PUSB_CDC_COMMON_DESCRIPTOR)AcmDesc);
+
+    AppendTextHex(_T("bmCapabilities:       "),
+                  AcmDesc->bmCapabilities, 2);
+
+    if (AcmDesc->bmCapabilities & 0x01)
+    {
+        AppendTextString(_T("  Comm_Feature requests\r\n"));
+    }
+
+    if (AcmDesc->bmCapabilities & 0x02)
+    {
+        AppendTextString(_T("  Line_Coding, Control_Line_State requests and Serial_State notification\r\n"));
+    }
+
+    if (AcmDesc->bmCapabilities & 0x04)
+    {
+        AppendTextString(_T("  Send_Break request\r\n"));
+    }
+
+    if (AcmDesc->bmCapabilities & 0x08)
+    {
+        AppendTextString(_T("  Network_Connection notification\r\n"));
+    }
+
+    return TRUE;
+}
+
+
+//*****************************************************************************
+//
+// DisplayCdcUnion()
+//
+//*****************************************************************************
+
+BOOL
+DisplayCdcUnion (
+    PUSB_CDC_UNION_DESCRIPTOR UnionDesc
+)
+{
+    UCHAR i, n;
+
+    if (UnionDesc->bLength < sizeof(USB_CDC_UNION_DESCRIPTOR))
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    DisplayCdcCommon(_T("Communications Class Union Functional Descriptor"),
+                     (PUSB_CDC_COMMON_DESCRIPTOR)UnionDesc);
+
+    AppendTextHex(_T("bControlInterface:    "),
+                  UnionDesc->bControlInterface, 2);
+
+    n = UnionDesc->bLength - FIELD_OFFSET(USB_CDC_UNION_DESCRIPTOR, bSubordinateInterface);
+
+    for (i = 0; i < n; i++)
+    {
+        AppendTextBuffer(_T("bSubordinateInterface[%d]: 0x%02X\r\n"),
+                         i,
+                         UnionDesc->bSubordinateInterface[i]);
+    }
+
+    return TRUE;
+}
+
+
+//*****************************************************************************
+//
+// DisplayCdcEthernet()
+//
+//*****************************************************************************
+
+BOOL
+DisplayCdcEthernet (
+    PUSB_CDC_ETHERNET_DESCRIPTOR EthernetDesc
+)
+{
+    if (EthernetDesc->bLength < sizeof(USB_CDC_ETHERNET_DESCRIPTOR))
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    DisplayCdcCommon(_T("Communications Class Ethernet Networking Functional Descriptor"),
+                     (PUSB_CDC_COMMON_DESCRIPTOR)EthernetDesc);
+
+    AppendTextHex(_T("iMACAddress:          "),
+                  EthernetDesc->iMACAddress, 2);
+
+    AppendTextHex(_T("bmEthernetStatistics: "),
+                  EthernetDesc->bmEthernetStatistics, 8);
+
+    AppendTextBuffer(_T("wMaxSegmentSize:    0x%04X (%d)\r\n"),
+                     EthernetDesc->wMaxSegmentSize,
+                     EthernetDesc->wMaxSegmentSize);
+
+    AppendTextHex(_T("wNumberMCFilters:   "),
+                  EthernetDesc->wNumberMCFilters, 4);
+
+    AppendTextHex(_T("bNumberPowerFilters:  "),
+                  EthernetDesc->bNumberPowerFilters, 2);
+
+    return TRUE;
+}
+
+
+//*****************************************************************************
+//
+// DisplayCdcNcm()
+//
+//*****************************************************************************
+
+BOOL
+DisplayCdcNcm (
+    PUSB_CDC_NCM_DESCRIPTOR NcmDesc
+)
+{
+    if (NcmDesc->bLength < sizeof(USB_CDC_NCM_DESCRIPTOR))
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    DisplayCdcCommon(_T("Communications Class NCM Functional Descriptor"),
+                     (PUSB_CDC_COMMON_DESCRIPTOR)NcmDesc);
+
+    AppendTextHex(_T("bcdNcmVersion:      "),
+                  NcmDesc->bcdNcmVersion, 4);
+
+    AppendTextHex(_T("bmNetworkCapabilities:"),
+                  NcmDesc->bmNetworkCapabilities, 2);
+
+    return TRUE;
+}
+
+
+//*****************************************************************************
+//
+// DisplayCdcMbim()
+//
+//*****************************************************************************
+
+BOOL
+DisplayCdcMbim (
+    PUSB_CDC_MBIM_DESCRIPTOR MbimDesc
+)
+{
+    if (MbimDesc->bLength < sizeof(USB_CDC_MBIM_DESCRIPTOR))
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    DisplayCdcCommon(_T("Communications Class MBIM Functional Descriptor"),
+                     (PUSB_CDC_COMMON_DESCRIPTOR)MbimDesc);
+
+    AppendTextHex(_T("bcdMBIMVersion:     "),
+                  MbimDesc->bcdMBIMVersion, 4);
+
+    AppendTextBuffer(_T("wMaxControlMessage: 0x%04X (%d)\r\n"),
+                     MbimDesc->wMaxControlMessage,
+                     MbimDesc->wMaxControlMessage);
+
+    AppendTextHex(_T("bNumberFilters:       "),
+                  MbimDesc->bNumberFilters, 2);
+
+    AppendTextHex(_T("bMaxFilterSize:       "),
+                  MbimDesc->bMaxFilterSize, 2);
+
+    AppendTextBuffer(_T("wMaxSegmentSize:    0x%04X (%d)\r\n"),
+                     MbimDesc->wMaxSegmentSize,
+                     MbimDesc->wMaxSegmentSize);
+
+    AppendTextHex(_T("bmNetworkCapabilities:"),
+                  MbimDesc->bmNetworkCapabilities, 2);
+
+    return TRUE;
+}
+
+
+//*****************************************************************************
+//
+// DisplayCdcCommon()
+//
+// The title and the fields all Functional Descriptors start with.
+//
+//*****************************************************************************
+
+VOID
+DisplayCdcCommon (
+    PCTSTR                      Title,
+    PUSB_CDC_COMMON_DESCRIPTOR  CommonDesc
+)
+{
+    AppendTextBuffer(_T("\r\n%s:\r\n"),
+                     Title);
+
+    AppendTextHex(_T("bLength:              "),
+                  CommonDesc->bLength, 2);
+
+    AppendTextHex(_T("bDescriptorType:      "),
+                  CommonDesc->bDescriptorType, 2);
+
+    AppendTextHex(_T("bDescriptorSubtype:   "),
+                  CommonDesc->bDescriptorSubtype, 2);
+}
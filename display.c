@@ -11,6 +11,16 @@ Abstract:
 This source file contains the routines which update the edit control
 to display information about the selected USB device.
 
+The text is built in one buffer which doubles in size whenever it runs
+short, so a large device costs a handful of reallocations.  The lines
+which make up most of the text, a label with a hex value or fixed text,
+are appended directly instead of going through printf.
+
+The text of a device is made up of sections: the first holds everything
+up to the Configuration Descriptor, each descriptor in it is one more.
+RenderDeviceInfoToSink() formats only a range of the sections and hands
+each one to a TEXT_SINK as soon as it is done, see TEXTSINK.C.
+
 Environment:
 
 user mode
@@ -29,8 +39,8 @@ Revision History:
 #include <basetyps.h>
 #include <stdio.h>
 #include <stddef.h>
+#include <string.h>
 #include <tchar.h>
-#include "vndrlist.h"
 #include "usbview.h"
 
 #if _MSC_VER >= 1200
@@ -45,13 +55,31 @@ Revision History:
 // D E F I N E S
 //*****************************************************************************
 
-#define BUFFERALLOCINCREMENT        8192
+#define BUFFERINITIALSIZE           8192
 #define BUFFERMINFREESPACE          1024
 
 //*****************************************************************************
 // T Y P E D E F S
 //*****************************************************************************
 
+// All vendor names of VNDRLIST.H packed one after the other, each a member
+// named after its Vendor ID, so their offsets are known at compile time
+//
+typedef struct _USB_VENDOR_NAMES
+{
+#define USB_VENDOR(id, name) TCHAR Vendor##id[sizeof(_T(name)) / sizeof(TCHAR)];
+#include "vndrlist.h"
+#undef USB_VENDOR
+} USB_VENDOR_NAMES;
+
+// Vendor ID and the offset of its name in USB_VENDOR_NAMES, in characters
+//
+typedef struct _USB_VENDOR_ENTRY
+{
+    USHORT  VendorID;
+    USHORT  NameOffset;
+} USB_VENDOR_ENTRY;
+
 //*****************************************************************************
 // G L O B A L S    P R I V A T E    T O    T H I S    F I L E
 //*****************************************************************************
@@ -62,10 +90,64 @@ PTSTR TextBuffer = NULL;
 int   TextBufferLen = 0;
 int   TextBufferPos = 0;
 
+// What is being rendered.  Without a sink everything stays in the text
+// buffer.
+//
+PTEXT_SINK  RenderSink = NULL;
+ULONG       RenderSection;          // the one being formatted
+ULONG       RenderFirstSection;
+ULONG       RenderEndSection;       // one past the last one formatted
+
+// Vendor names, sorted by Vendor ID.  Neither table holds a pointer, so
+// they need no relocations when the image is loaded.
+//
+const USB_VENDOR_NAMES UsbVendorNames =
+{
+#define USB_VENDOR(id, name) _T(name),
+#include "vndrlist.h"
+#undef USB_VENDOR
+};
+
+const USB_VENDOR_ENTRY UsbVendorTable[] =
+{
+#define USB_VENDOR(id, name) \
+    { id, (USHORT)(offsetof(USB_VENDOR_NAMES, Vendor##id) / sizeof(TCHAR)) },
+#include "vndrlist.h"
+#undef USB_VENDOR
+};
+
+#define NUM_USB_VENDORS (sizeof(UsbVendorTable) / sizeof(UsbVendorTable[0]))
+
+// Index of the first entry of UsbVendorTable for each high byte of a
+// Vendor ID, built on first use by GetVendorString()
+//
+USHORT          UsbVendorIndex[257];
+volatile LONG   UsbVendorIndexReady;
+
 //*****************************************************************************
 // L O C A L    F U N C T I O N    P R O T O T Y P E S
 //*****************************************************************************
 
+BOOL
+GrowTextBuffer (
+    int     FreeSpace
+);
+
+VOID
+FormatDeviceInfo (
+    PVOID   Info
+);
+
+BOOL
+BeginSection (
+    VOID
+);
+
+VOID
+EndSection (
+    VOID
+);
+
 VOID
 DisplayHubInfo (
     PUSB_HUB_INFORMATION HubInfo
@@ -77,10 +159,32 @@ DisplayHubCaps (
     PUSB_HUB_CAPABILITIES HubCaps 
 );
 
+VOID
+DisplayBandwidth (
+    PUSB_BANDWIDTH  Bandwidth
+);
+
+VOID
+DisplayScheduleMap (
+    PUSB_SCHEDULE_MAP   ScheduleMap
+);
+
+PCTSTR
+ScheduleSlotMark (
+    PUSB_SCHEDULE_SLOT  Slot,
+    ULONG               PeriodicNs
+);
+
 VOID
 DisplayConnectionInfo (
     PUSB_NODE_CONNECTION_INFORMATION_EX    ConnectInfo,
-    PSTRING_DESCRIPTOR_NODE             StringDescs
+    PSTRING_DESCRIPTORS                 StringDescs
+);
+
+VOID
+DisplaySpeedDowngrade (
+    PUSB_DEVICE_QUALIFIER_DESCRIPTOR    QualifierDesc,
+    SPEED_DOWNGRADE                     SpeedDowngrade
 );
 
 VOID
@@ -91,20 +195,20 @@ DisplayPipeInfo (
 
 VOID
 DisplayConfigDesc (
-    PUSB_CONFIGURATION_DESCRIPTOR   ConfigDesc,
-    PSTRING_DESCRIPTOR_NODE         StringDescs
+    PUSB_DESCRIPTOR_REQUEST         ConfigDesc,
+    PSTRING_DESCRIPTORS             StringDescs
 );
 
 VOID
 DisplayConfigurationDescriptor (
     PUSB_CONFIGURATION_DESCRIPTOR   ConfigDesc,
-    PSTRING_DESCRIPTOR_NODE         StringDescs
+    PSTRING_DESCRIPTORS             StringDescs
 );
 
 VOID
 DisplayInterfaceDescriptor (
     PUSB_INTERFACE_DESCRIPTOR   InterfaceDesc,
-    PSTRING_DESCRIPTOR_NODE     StringDescs
+    PSTRING_DESCRIPTORS         StringDescs
 );
 
 VOID
@@ -117,10 +221,25 @@ DisplayHidDescriptor (
     PUSB_HID_DESCRIPTOR         HidDesc
 );
 
+BOOL
+DisplayPipeUsageDescriptor (
+    PUSB_STORAGE_PIPE_USAGE_DESCRIPTOR  PipeUsageDesc
+);
+
+BOOL
+DisplayHubDescriptor (
+    PUSB_HUB_DESCRIPTOR         HubDesc
+);
+
+BOOL
+DisplaySSHubDescriptor (
+    PUSB_SS_HUB_DESCRIPTOR      HubDesc
+);
+
 VOID
 DisplayStringDescriptor (
     UCHAR                       Index,
-    PSTRING_DESCRIPTOR_NODE     StringDescs
+    PSTRING_DESCRIPTORS         StringDescs
 );
 
 VOID
@@ -128,11 +247,46 @@ DisplayUnknownDescriptor (
     PUSB_COMMON_DESCRIPTOR      CommonDesc
 );
 
-PTSTR
-GetVendorString (
-    USHORT     idVendor
+VOID
+BuildVendorIndex (
+    VOID
+);
+
+VOID
+AppendTextNameOr (
+    PCTSTR  Name,
+    PCTSTR  Otherwise
 );
 
+//*****************************************************************************
+// G L O B A L S
+//*****************************************************************************
+
+//
+// Decoders of the few Mass Storage and Hub Class Descriptors, see CLASSDEC.C
+//
+CLASS_DESC_DECODER StorageClassDecoders[] =
+{
+    {USB_DEVICE_CLASS_STORAGE, USB_STORAGE_SUBCLASS_SCSI,
+     USB_STORAGE_PIPE_USAGE_TYPE, CLASS_DESC_ANY,
+     (LPFNDISPLAYCLASSDESC)DisplayPipeUsageDescriptor},
+
+    {0, 0, 0, 0, NULL}
+};
+
+CLASS_DESC_DECODER HubClassDecoders[] =
+{
+    {USB_DEVICE_CLASS_HUB, CLASS_DESC_ANY,
+     USB_HUB_DESCRIPTOR_TYPE, CLASS_DESC_ANY,
+     (LPFNDISPLAYCLASSDESC)DisplayHubDescriptor},
+
+    {USB_DEVICE_CLASS_HUB, CLASS_DESC_ANY,
+     USB_SS_HUB_DESCRIPTOR_TYPE, CLASS_DESC_ANY,
+     (LPFNDISPLAYCLASSDESC)DisplaySSHubDescriptor},
+
+    {0, 0, 0, 0, NULL}
+};
+
 //*****************************************************************************
 // L O C A L    F U N C T I O N S
 //*****************************************************************************
@@ -150,7 +304,7 @@ CreateTextBuffer (
 {
     // Allocate the buffer
     //
-    TextBuffer = ALLOC(BUFFERALLOCINCREMENT * sizeof(TCHAR));
+    TextBuffer = ALLOC(BUFFERINITIALSIZE * sizeof(TCHAR));
 
     if (TextBuffer == NULL)
     {
@@ -159,7 +313,7 @@ CreateTextBuffer (
         return FALSE;
     }
 
-    TextBufferLen = BUFFERALLOCINCREMENT;
+    TextBufferLen = BUFFERINITIALSIZE;
 
     // Reset the buffer position and terminate the buffer
     //
@@ -216,6 +370,53 @@ ResetTextBuffer (
     return TRUE;
 }
 
+//*****************************************************************************
+//
+// GrowTextBuffer()
+//
+// Makes sure at least FreeSpace characters are free in the buffer, doubling
+// its size as often as needed.  Returns FALSE if it could not be grown.
+//
+//*****************************************************************************
+
+BOOL
+GrowTextBuffer (
+    int     FreeSpace
+)
+{
+    PTSTR   TextBufferTmp;
+    int     newLen;
+
+    if (TextBufferLen - TextBufferPos >= FreeSpace)
+    {
+        return TRUE;
+    }
+
+    newLen = TextBufferLen;
+
+    while (newLen - TextBufferPos < FreeSpace)
+    {
+        newLen *= 2;
+    }
+
+    TextBufferTmp = REALLOC(TextBuffer, newLen * sizeof(TCHAR));
+
+    if (TextBufferTmp == NULL)
+    {
+        // If GlobalReAlloc fails, the original memory is not freed,
+        // and the original handle and pointer are still valid.
+        //
+        OOPS();
+
+        return FALSE;
+    }
+
+    TextBuffer = TextBufferTmp;
+    TextBufferLen = newLen;
+
+    return TRUE;
+}
+
 //*****************************************************************************
 //
 // AppendTextBuffer()
@@ -235,26 +436,9 @@ AppendTextBuffer (
     // Make sure we have a healthy amount of space free in the buffer,
     // reallocating the buffer if necessary.
     //
-    if (TextBufferLen - TextBufferPos < BUFFERMINFREESPACE)
+    if (!GrowTextBuffer(BUFFERMINFREESPACE))
     {
-        PTSTR TextBufferTmp;
-
-        TextBufferTmp = REALLOC(TextBuffer, (TextBufferLen+BUFFERALLOCINCREMENT) * sizeof(TCHAR));
-
-        if (TextBufferTmp != NULL)
-        {
-            TextBuffer = TextBufferTmp;
-            TextBufferLen += BUFFERALLOCINCREMENT;
-        }
-        else
-        {
-            // If GlobalReAlloc fails, the original memory is not freed,
-            // and the original handle and pointer are still valid.
-            //
-            OOPS();
-
-            return;
-        }
+        return;
     }
 
     // Add the text to the end of the buffer, updating the buffer position.
@@ -265,6 +449,138 @@ AppendTextBuffer (
                                arglist);
 }
 
+//*****************************************************************************
+//
+// AppendTextString()
+//
+// Appends String as it is, without looking for format specifications.
+//
+//*****************************************************************************
+
+VOID
+AppendTextString (
+    LPCTSTR String
+)
+{
+    int length;
+
+    length = (int)_tcslen(String);
+
+    if (!GrowTextBuffer(length + 1))
+    {
+        return;
+    }
+
+    memcpy(TextBuffer + TextBufferPos, String, (length + 1) * sizeof(TCHAR));
+
+    TextBufferPos += length;
+}
+
+//*****************************************************************************
+//
+// AppendTextHex()
+//
+// Appends a line of Label followed by Value in hex, the same as
+// AppendTextBuffer(_T("<Label>0x%0<Digits>X\r\n"), Value).
+//
+//*****************************************************************************
+
+VOID
+AppendTextHex (
+    LPCTSTR Label,
+    ULONG   Value,
+    int     Digits
+)
+{
+    static const TCHAR hexDigits[] = _T("0123456789ABCDEF");
+    PTSTR   text;
+    int     labelLength;
+    int     i;
+
+    // Like printf, use more digits if the value does not fit
+    //
+    while (Digits < 8 && (Value >> (Digits * 4)) != 0)
+    {
+        Digits++;
+    }
+
+    labelLength = (int)_tcslen(Label);
+
+    if (!GrowTextBuffer(labelLength + Digits + 5))
+    {
+        return;
+    }
+
+    text = TextBuffer + TextBufferPos;
+
+    memcpy(text, Label, labelLength * sizeof(TCHAR));
+    text += labelLength;
+
+    *text++ = _T('0');
+    *text++ = _T('x');
+
+    for (i = Digits - 1; i >= 0; i--)
+    {
+        *text++ = hexDigits[(Value >> (i * 4)) & 0xF];
+    }
+
+    *text++ = _T('\r');
+    *text++ = _T('\n');
+    *text = 0;
+
+    TextBufferPos = (int)(text - TextBuffer);
+}
+
+//*****************************************************************************
+//
+// AppendTextHexName()
+//
+// Same as AppendTextHex(), with Name after the value if it is not NULL.
+//
+//*****************************************************************************
+
+VOID
+AppendTextHexName (
+    LPCTSTR Label,
+    ULONG   Value,
+    int     Digits,
+    PCTSTR  Name
+)
+{
+    if (Name == NULL)
+    {
+        AppendTextHex(Label, Value, Digits);
+    }
+    else
+    {
+        AppendTextBuffer(_T("%s0x%0*X (%s)\r\n"), Label, Digits, Value, Name);
+    }
+}
+
+//*****************************************************************************
+//
+// AppendTextNameOr()
+//
+// Ends a line with Name in parentheses, or with Otherwise if Name is NULL.
+//
+//*****************************************************************************
+
+VOID
+AppendTextNameOr (
+    PCTSTR  Name,
+    PCTSTR  Otherwise
+)
+{
+    if (Name == NULL)
+    {
+        AppendTextString(Otherwise);
+    }
+    else
+    {
+        AppendTextBuffer(_T(" (%s)\r\n"), Name);
+    }
+}
+
 
 //
 // Hardcoded information about specific EHCI controllers
@@ -305,7 +621,19 @@ UpdateEditControl (
 {
     TV_ITEM tvi;
     PVOID   info;
-    ULONG   i;
+    PCTSTR  text;
+    BOOL    fetched;
+
+    // Text rendered for the item before and not changed since only needs
+    // to be shown again
+    //
+    text = LookupRenderCache(hTreeItem);
+
+    if (text != NULL)
+    {
+        SetWindowText(hEditWnd, text);
+        return;
+    }
 
     // Start with an empty text buffer.
     //
@@ -335,103 +663,294 @@ UpdateEditControl (
     //
     if (info)
     {
-        PUSB_NODE_INFORMATION               HubInfo = NULL;
-        PCTSTR                              HubName = NULL;
-        PUSB_HUB_CAPABILITIES               HubCaps = NULL;
-        PUSB_HUB_CAPABILITIES_EX            HubCapsEx = NULL;
-        PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfo = NULL;
-        PUSB_DESCRIPTOR_REQUEST             ConfigDesc = NULL;
-        PSTRING_DESCRIPTOR_NODE             StringDescs = NULL;
+        // Descriptors enumeration left out are fetched in the background,
+        // until they are in only the connection information is shown
+        //
+        fetched = RequestLazyDescriptors(info);
 
-        switch (*(PUSBDEVICEINFOTYPE)info)
+        if (RenderDeviceInfo(info) != NULL && fetched)
         {
-            case HostControllerInfo:
-                AppendTextBuffer(_T("DriverKey: %s\r\n"),
-                                 ((PUSBHOSTCONTROLLERINFO)info)->DriverKey);
+            AddRenderCache(hTreeItem, TextBuffer, TextBufferPos);
+        }
+    }
 
-                AppendTextBuffer(_T("VendorID: %04X\r\n"),
-                                 ((PUSBHOSTCONTROLLERINFO)info)->VendorID);
+    // All done formatting text buffer with info, now update the edit
+    // control with the contents of the text buffer
+    //
+    SetWindowText(hEditWnd, TextBuffer);
+}
 
-                AppendTextBuffer(_T("DeviceID: %04X\r\n"),
-                                 ((PUSBHOSTCONTROLLERINFO)info)->DeviceID);
+//*****************************************************************************
+//
+// RenderDeviceInfo()
+//
+// Info - Info stored for a TreeView item.
+//
+// Formats everything known about the item into the text buffer, which is
+// returned.  Returns NULL if the text buffer has not been created.
+//
+//*****************************************************************************
+
+PCTSTR
+RenderDeviceInfo (
+    PVOID   Info
+)
+{
+    if (!ResetTextBuffer())
+    {
+        return NULL;
+    }
+
+    RenderSink = NULL;
+    RenderSection = 0;
+    RenderFirstSection = 0;
+    RenderEndSection = MAXULONG;
+
+    FormatDeviceInfo(Info);
+
+    return TextBuffer;
+}
+
+//*****************************************************************************
+//
+// RenderDeviceInfoToSink()
+//
+// Info - Info stored for a TreeView item.
+//
+// Sink - Where the text goes, one section at a time.
+//
+// FirstSection, NumSections - The sections to format, the others are
+// skipped.  With NumSections 0 nothing is formatted.
+//
+// Returns the number of sections Info has, whichever were formatted, so
+// a front end can page through them.  Rendering stops early if the sink
+// does not take the text.
+//
+//*****************************************************************************
+
+ULONG
+RenderDeviceInfoToSink (
+    PVOID       Info,
+    PTEXT_SINK  Sink,
+    ULONG       FirstSection,
+    ULONG       NumSections
+)
+{
+    if (!ResetTextBuffer())
+    {
+        return 0;
+    }
+
+    RenderSink = Sink;
+    RenderSection = 0;
+    RenderFirstSection = FirstSection;
+    RenderEndSection = NumSections > MAXULONG - FirstSection ?
+                       MAXULONG : FirstSection + NumSections;
+
+    FormatDeviceInfo(Info);
+
+    RenderSink = NULL;
+
+    ResetTextBuffer();
+
+    return RenderSection;
+}
+
+//*****************************************************************************
+//
+// BeginSection()
+//
+// Returns TRUE if the section about to be formatted is in the range asked
+// for.
+//
+//*****************************************************************************
+
+BOOL
+BeginSection (
+    VOID
+)
+{
+    return RenderSection >= RenderFirstSection &&
+           RenderSection < RenderEndSection;
+}
+
+//*****************************************************************************
+//
+// EndSection()
+//
+// Hands the text of the section just formatted to the sink, if any.
+//
+//*****************************************************************************
+
+VOID
+EndSection (
+    VOID
+)
+{
+    if (RenderSink != NULL && TextBufferPos != 0)
+    {
+        if (!RenderSink->Write(RenderSink, TextBuffer, TextBufferPos))
+        {
+            // Nothing more will be taken, just count the rest
+            //
+            RenderEndSection = 0;
+        }
 
-                AppendTextBuffer(_T("SubSysID: %08X\r\n"),
-                                 ((PUSBHOSTCONTROLLERINFO)info)->SubSysID);
+        *TextBuffer = 0;
+        TextBufferPos = 0;
+    }
+
+    RenderSection++;
+}
 
-                AppendTextBuffer(_T("Revision: %02X\r\n"),
-                                 ((PUSBHOSTCONTROLLERINFO)info)->Revision);
+//*****************************************************************************
+//
+// FormatDeviceInfo()
+//
+// Formats the sections of Info set up by the caller.
+//
+//*****************************************************************************
 
-                for (i = 0; EhciControllerData[i].VendorID; i++)
+VOID
+FormatDeviceInfo (
+    PVOID   Info
+)
+{
+    PUSB_NODE_INFORMATION               HubInfo = NULL;
+    PCTSTR                              HubName = NULL;
+    PUSB_HUB_CAPABILITIES               HubCaps = NULL;
+    PUSB_HUB_CAPABILITIES_EX            HubCapsEx = NULL;
+    PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfo = NULL;
+    PUSB_DESCRIPTOR_REQUEST             ConfigDesc = NULL;
+    PSTRING_DESCRIPTORS                 StringDescs = NULL;
+    PUSB_DEVICE_QUALIFIER_DESCRIPTOR    QualifierDesc = NULL;
+    SPEED_DOWNGRADE                     SpeedDowngrade = SpeedNotDowngraded;
+    PUSB_BANDWIDTH                      Bandwidth = NULL;
+    PUSB_SCHEDULE_MAP                   ScheduleMap = NULL;
+    ULONG                               i;
+    BOOL                                render;
+
+    render = BeginSection();
+
+    switch (*(PUSBDEVICEINFOTYPE)Info)
+    {
+        case HostControllerInfo:
+            Bandwidth = &((PUSBHOSTCONTROLLERINFO)Info)->Bandwidth;
+            ScheduleMap = &((PUSBHOSTCONTROLLERINFO)Info)->ScheduleMap;
+
+            if (!render)
+            {
+                break;
+            }
+
+            AppendTextBuffer(_T("DriverKey: %s\r\n"),
+                             ((PUSBHOSTCONTROLLERINFO)Info)->DriverKey);
+
+            AppendTextBuffer(_T("VendorID: %04X\r\n"),
+                             ((PUSBHOSTCONTROLLERINFO)Info)->VendorID);
+
+            AppendTextBuffer(_T("DeviceID: %04X\r\n"),
+                             ((PUSBHOSTCONTROLLERINFO)Info)->DeviceID);
+
+            AppendTextBuffer(_T("SubSysID: %08X\r\n"),
+                             ((PUSBHOSTCONTROLLERINFO)Info)->SubSysID);
+
+            AppendTextBuffer(_T("Revision: %02X\r\n"),
+                             ((PUSBHOSTCONTROLLERINFO)Info)->Revision);
+
+            for (i = 0; EhciControllerData[i].VendorID; i++)
+            {
+                if (((PUSBHOSTCONTROLLERINFO)Info)->VendorID ==
+                      EhciControllerData[i].VendorID &&
+                    ((PUSBHOSTCONTROLLERINFO)Info)->DeviceID ==
+                      EhciControllerData[i].DeviceID)
                 {
-                    if (((PUSBHOSTCONTROLLERINFO)info)->VendorID ==
-                          EhciControllerData[i].VendorID &&
-                        ((PUSBHOSTCONTROLLERINFO)info)->DeviceID ==
-                          EhciControllerData[i].DeviceID)
-                    {
-                        AppendTextBuffer(_T("DebugPort: %d\r\n"),
-                                         EhciControllerData[i].DebugPortNumber);
-                    }
+                    AppendTextBuffer(_T("DebugPort: %d\r\n"),
+                                     EhciControllerData[i].DebugPortNumber);
                 }
+            }
 
-                break;
+            break;
 
-            case RootHubInfo:
-                HubInfo = ((PUSBROOTHUBINFO)info)->HubInfo;
-                HubName = ((PUSBROOTHUBINFO)info)->HubName;
-                HubCaps = ((PUSBROOTHUBINFO)info)->HubCaps;
-                HubCapsEx = ((PUSBROOTHUBINFO)info)->HubCapsEx;
+        case RootHubInfo:
+            HubInfo = ((PUSBROOTHUBINFO)Info)->HubInfo;
+            HubName = ((PUSBROOTHUBINFO)Info)->HubName;
+            HubCaps = ((PUSBROOTHUBINFO)Info)->HubCaps;
+            HubCapsEx = ((PUSBROOTHUBINFO)Info)->HubCapsEx;
+            Bandwidth = &((PUSBROOTHUBINFO)Info)->Bandwidth;
 
+            if (render)
+            {
                 AppendTextBuffer(_T("Root Hub: %s\r\n"),
                                  HubName);
+            }
 
-                break;
-
-            case ExternalHubInfo:
-                HubInfo = ((PUSBEXTERNALHUBINFO)info)->HubInfo;
-                HubName = ((PUSBEXTERNALHUBINFO)info)->HubName;
-                HubCaps = ((PUSBEXTERNALHUBINFO)info)->HubCaps;
-                HubCapsEx = ((PUSBEXTERNALHUBINFO)info)->HubCapsEx;
-                ConnectionInfo = ((PUSBEXTERNALHUBINFO)info)->ConnectionInfo;
-                ConfigDesc = ((PUSBEXTERNALHUBINFO)info)->ConfigDesc;
-                StringDescs = ((PUSBEXTERNALHUBINFO)info)->StringDescs;
+            break;
 
+        case ExternalHubInfo:
+            HubInfo = ((PUSBEXTERNALHUBINFO)Info)->HubInfo;
+            HubName = ((PUSBEXTERNALHUBINFO)Info)->HubName;
+            HubCaps = ((PUSBEXTERNALHUBINFO)Info)->HubCaps;
+            HubCapsEx = ((PUSBEXTERNALHUBINFO)Info)->HubCapsEx;
+            Bandwidth = &((PUSBEXTERNALHUBINFO)Info)->Bandwidth;
+            ConnectionInfo = ((PUSBEXTERNALHUBINFO)Info)->ConnectionInfo;
+            ConfigDesc = ((PUSBEXTERNALHUBINFO)Info)->ConfigDesc;
+            StringDescs = ((PUSBEXTERNALHUBINFO)Info)->StringDescs;
+            QualifierDesc = ((PUSBEXTERNALHUBINFO)Info)->QualifierDesc;
+            SpeedDowngrade = ((PUSBEXTERNALHUBINFO)Info)->SpeedDowngrade;
+
+            if (render)
+            {
                 AppendTextBuffer(_T("External Hub: %s\r\n"),
                                  HubName);
+            }
 
-                break;
+            break;
 
-            case DeviceInfo:
-                ConnectionInfo = ((PUSBDEVICEINFO)info)->ConnectionInfo;
-                ConfigDesc = ((PUSBDEVICEINFO)info)->ConfigDesc;
-                StringDescs = ((PUSBDEVICEINFO)info)->StringDescs;
-                break;
-        }
+        case DeviceInfo:
+            ConnectionInfo = ((PUSBDEVICEINFO)Info)->ConnectionInfo;
+            ConfigDesc = ((PUSBDEVICEINFO)Info)->ConfigDesc;
+            StringDescs = ((PUSBDEVICEINFO)Info)->StringDescs;
+            QualifierDesc = ((PUSBDEVICEINFO)Info)->QualifierDesc;
+            SpeedDowngrade = ((PUSBDEVICEINFO)Info)->SpeedDowngrade;
+            break;
+    }
 
-        if (HubInfo)
-        {
-            DisplayHubInfo(&HubInfo->u.HubInformation);
-            DisplayHubCaps(HubCapsEx, HubCaps);
-        }
+    if (HubInfo && render)
+    {
+        DisplayHubInfo(&HubInfo->u.HubInformation);
+        DisplayHubCaps(HubCapsEx, HubCaps);
+    }
 
-        
+    if (Bandwidth && render)
+    {
+        DisplayBandwidth(Bandwidth);
+    }
 
-        if (ConnectionInfo)
-        {
-            DisplayConnectionInfo(ConnectionInfo,
-                                  StringDescs);
-        }
+    if (ScheduleMap && render)
+    {
+        DisplayScheduleMap(ScheduleMap);
+    }
 
-        if (ConfigDesc)
-        {
-            DisplayConfigDesc((PUSB_CONFIGURATION_DESCRIPTOR)(ConfigDesc + 1),
+    if (ConnectionInfo && render)
+    {
+        DisplayConnectionInfo(ConnectionInfo,
                               StringDescs);
-        }
     }
 
-    // All done formatting text buffer with info, now update the edit
-    // control with the contents of the text buffer
-    //
-    SetWindowText(hEditWnd, TextBuffer);
+    if ((QualifierDesc || SpeedDowngrade != SpeedNotDowngraded) && render)
+    {
+        DisplaySpeedDowngrade(QualifierDesc,
+                              SpeedDowngrade);
+    }
+
+    EndSection();
+
+    if (ConfigDesc)
+    {
+        DisplayConfigDesc(ConfigDesc,
+                          StringDescs);
+    }
 }
 
 
@@ -463,91 +982,221 @@ DisplayHubInfo (
     switch (wHubChar & 0x0003)
     {
         case 0x0000:
-            AppendTextBuffer(_T("Power switching:         Ganged\r\n"));
+            AppendTextString(_T("Power switching:         Ganged\r\n"));
             break;
 
         case 0x0001:
-            AppendTextBuffer(_T("Power switching:         Individual\r\n"));
+            AppendTextString(_T("Power switching:         Individual\r\n"));
             break;
 
         case 0x0002:
         case 0x0003:
-            AppendTextBuffer(_T("Power switching:         None\r\n"));
+            AppendTextString(_T("Power switching:         None\r\n"));
             break;
     }
 
-    switch (wHubChar & 0x0004)
+    switch (wHubChar & 0x0004)
+    {
+        case 0x0000:
+            AppendTextString(_T("Compound device:         No\r\n"));
+            break;
+
+        case 0x0004:
+            AppendTextString(_T("Compound device:         Yes\r\n"));
+            break;
+    }
+
+    switch (wHubChar & 0x0018)
+    {
+        case 0x0000:
+            AppendTextString(_T("Over-current Protection: Global\r\n"));
+            break;
+
+        case 0x0008:
+            AppendTextString(_T("Over-current Protection: Individual\r\n"));
+            break;
+
+        case 0x0010:
+        case 0x0018:
+            AppendTextString(_T("No Over-current Protection (Bus Power Only)\r\n"));
+            break;
+    }
+
+    AppendTextString(_T("\r\n"));
+
+}
+
+
+//*****************************************************************************
+//
+// DisplayHubCaps()
+//
+// HubCapsEx - Extended Capabilities
+// HubCaps - Basic capabilities
+//
+//*****************************************************************************
+
+VOID
+DisplayHubCaps (
+    PUSB_HUB_CAPABILITIES_EX HubCapsEx, 
+    PUSB_HUB_CAPABILITIES HubCaps 
+)
+{
+    if (HubCapsEx) {
+#if (_WIN32_WINNT >= 0x0600) 
+        // Only available on Vista + 
+        PUSB_HUB_CAP_FLAGS HubCapFlags = (PUSB_HUB_CAP_FLAGS) &(HubCapsEx->CapabilityFlags);
+        AppendTextBuffer(_T("Extended Hub Capability Flags:  %0#8lx\r\n"), HubCapFlags->ul);
+        AppendTextBuffer(_T("    High speed Capable:  %s\r\n"), (HubCapFlags->HubIsHighSpeedCapable ? _T("Yes") : _T("No")));
+        AppendTextBuffer(_T("    High speed:  %s\r\n"), (HubCapFlags->HubIsHighSpeed ? _T("Yes") : _T("No")));
+        AppendTextBuffer(_T("    Mulit-transaction Capable:  %s\r\n"), (HubCapFlags->HubIsMultiTtCapable ? _T("Yes") : _T("No")));
+        AppendTextBuffer(_T("    Mulit-transaction ON:  %s\r\n"), (HubCapFlags->HubIsMultiTt ? _T("Yes") : _T("No")));
+        AppendTextBuffer(_T("    Root hub:  %s\r\n"), (HubCapFlags->HubIsRoot? _T("Yes") : _T("No")));
+        AppendTextBuffer(_T("    Armed for wake on connect:  %s\r\n"), (HubCapFlags->HubIsArmedWakeOnConnect ? _T("Yes") : _T("No")));
+        AppendTextBuffer(_T("    Reserved (26 bits):  %0#6lx\r\n"), HubCapFlags->ReservedMBZ);
+
+        // Don't display un-extended caps if extended caps are available, they don't appear to be correct.
+#endif
+    } else {
+        AppendTextString(_T("Extended Hub Capabilities UNAVAILABLE\r\n"));
+        // Pre-Vista this is all we've got
+        if (HubCaps) {
+            AppendTextBuffer(_T("Hub Capabilities:  %0#8lx (%s)\r\n"), HubCaps->HubIs2xCapable, (HubCaps->HubIs2xCapable? _T("High speed") : _T("Not high speed")));
+        } else {
+            AppendTextString(_T("Hub Capabilities UNAVAILABLE\r\n"));
+        }
+    }
+    AppendTextString(_T("\r\n"));
+}
+
+//*****************************************************************************
+//
+// DisplayBandwidth()
+//
+// Bandwidth - Periodic bandwidth reserved below a host controller or hub,
+// see ComputeBandwidth().
+//
+//*****************************************************************************
+
+VOID
+DisplayBandwidth (
+    PUSB_BANDWIDTH  Bandwidth
+)
+{
+    AppendTextBuffer(_T("Periodic Endpoints:      %d\r\n"),
+                     Bandwidth->PeriodicEndpoints);
+
+    AppendTextBuffer(_T("Busiest Frame:           %d ns (%d%% of periodic time)\r\n"),
+                     Bandwidth->FrameNs,
+                     Bandwidth->FramePercent);
+
+    AppendTextBuffer(_T("Busiest Microframe:      %d ns (%d%% of periodic time)\r\n"),
+                     Bandwidth->MicroframeNs,
+                     Bandwidth->MicroframePercent);
+
+    if (Bandwidth->OverThreshold)
+    {
+        AppendTextBuffer(_T("Over Threshold:          more than %d%% of periodic time\r\n"),
+                         gBandwidthThreshold);
+    }
+
+    AppendTextString(_T("\r\n"));
+}
+
+//*****************************************************************************
+//
+// DisplayScheduleMap()
+//
+// ScheduleMap - Where the open periodic pipes below a host controller are
+// scheduled.  Only the frames something is scheduled in are listed, with
+// the full and low speed pipes of the frame and the high speed pipes of
+// each of its microframes.
+//
+//*****************************************************************************
+
+VOID
+DisplayScheduleMap (
+    PUSB_SCHEDULE_MAP   ScheduleMap
+)
+{
+    PUSB_SCHEDULE_SLOT  slot;
+    ULONG               frame;
+    ULONG               microframe;
+    BOOL                used;
+
+    AppendTextBuffer(_T("Scheduled Pipes:         %d, %d collisions, %d hot slots\r\n"),
+                     ScheduleMap->PeriodicPipes,
+                     ScheduleMap->Collisions,
+                     ScheduleMap->HotSlots);
+
+    if (ScheduleMap->PeriodicPipes != 0)
     {
-        case 0x0000:
-            AppendTextBuffer(_T("Compound device:         No\r\n"));
-            break;
+        AppendTextString(_T("(* shared by several pipes, ! over the threshold)\r\n"));
+        AppendTextString(_T("Frame  Pipes        ns    Microframe 0-7 pipes\r\n"));
 
-        case 0x0004:
-            AppendTextBuffer(_T("Compound device:         Yes\r\n"));
-            break;
-    }
+        for (frame = 0; frame < SCHEDULE_FRAMES; frame++)
+        {
+            slot = &ScheduleMap->Frames[frame];
+            used = slot->Pipes != 0;
 
-    switch (wHubChar & 0x0018)
-    {
-        case 0x0000:
-            AppendTextBuffer(_T("Over-current Protection: Global\r\n"));
-            break;
+            for (microframe = 0; microframe < 8; microframe++)
+            {
+                used |= ScheduleMap->Microframes[frame * 8 + microframe].Pipes != 0;
+            }
 
-        case 0x0008:
-            AppendTextBuffer(_T("Over-current Protection: Individual\r\n"));
-            break;
+            if (!used)
+            {
+                continue;
+            }
 
-        case 0x0010:
-        case 0x0018:
-            AppendTextBuffer(_T("No Over-current Protection (Bus Power Only)\r\n"));
-            break;
-    }
+            AppendTextBuffer(_T("%5d  %5d %9d%s  "),
+                             frame,
+                             slot->Pipes,
+                             slot->Ns,
+                             ScheduleSlotMark(slot, FRAME_PERIODIC_NS));
 
-    AppendTextBuffer(_T("\r\n"));
+            for (microframe = 0; microframe < 8; microframe++)
+            {
+                slot = &ScheduleMap->Microframes[frame * 8 + microframe];
 
-}
+                AppendTextBuffer(_T(" %2d%s"),
+                                 slot->Pipes,
+                                 ScheduleSlotMark(slot, MICROFRAME_PERIODIC_NS));
+            }
+
+            AppendTextString(_T("\r\n"));
+        }
+    }
 
+    AppendTextString(_T("\r\n"));
+}
 
 //*****************************************************************************
 //
-// DisplayHubCaps()
+// ScheduleSlotMark()
 //
-// HubCapsEx - Extended Capabilities
-// HubCaps - Basic capabilities
+// Returns the mark of a slot of a schedule map whose periodic time is
+// PeriodicNs, "!" if it is hot, "*" if several pipes share it.
 //
 //*****************************************************************************
 
-VOID
-DisplayHubCaps (
-    PUSB_HUB_CAPABILITIES_EX HubCapsEx, 
-    PUSB_HUB_CAPABILITIES HubCaps 
+PCTSTR
+ScheduleSlotMark (
+    PUSB_SCHEDULE_SLOT  Slot,
+    ULONG               PeriodicNs
 )
 {
-    if (HubCapsEx) {
-#if (_WIN32_WINNT >= 0x0600) 
-        // Only available on Vista + 
-        PUSB_HUB_CAP_FLAGS HubCapFlags = (PUSB_HUB_CAP_FLAGS) &(HubCapsEx->CapabilityFlags);
-        AppendTextBuffer(_T("Extended Hub Capability Flags:  %0#8lx\r\n"), HubCapFlags->ul);
-        AppendTextBuffer(_T("    High speed Capable:  %s\r\n"), (HubCapFlags->HubIsHighSpeedCapable ? _T("Yes") : _T("No")));
-        AppendTextBuffer(_T("    High speed:  %s\r\n"), (HubCapFlags->HubIsHighSpeed ? _T("Yes") : _T("No")));
-        AppendTextBuffer(_T("    Mulit-transaction Capable:  %s\r\n"), (HubCapFlags->HubIsMultiTtCapable ? _T("Yes") : _T("No")));
-        AppendTextBuffer(_T("    Mulit-transaction ON:  %s\r\n"), (HubCapFlags->HubIsMultiTt ? _T("Yes") : _T("No")));
-        AppendTextBuffer(_T("    Root hub:  %s\r\n"), (HubCapFlags->HubIsRoot? _T("Yes") : _T("No")));
-        AppendTextBuffer(_T("    Armed for wake on connect:  %s\r\n"), (HubCapFlags->HubIsArmedWakeOnConnect ? _T("Yes") : _T("No")));
-        AppendTextBuffer(_T("    Reserved (26 bits):  %0#6lx\r\n"), HubCapFlags->ReservedMBZ);
+    if ((ULONGLONG)Slot->Ns * 100 > (ULONGLONG)PeriodicNs * gBandwidthThreshold)
+    {
+        return _T("!");
+    }
 
-        // Don't display un-extended caps if extended caps are available, they don't appear to be correct.
-#endif
-    } else {
-        AppendTextBuffer(_T("Extended Hub Capabilities UNAVAILABLE\r\n"));
-        // Pre-Vista this is all we've got
-        if (HubCaps) {
-            AppendTextBuffer(_T("Hub Capabilities:  %0#8lx (%s)\r\n"), HubCaps->HubIs2xCapable, (HubCaps->HubIs2xCapable? _T("High speed") : _T("Not high speed")));
-        } else {
-            AppendTextBuffer(_T("Hub Capabilities UNAVAILABLE\r\n"));
-        }
+    if (Slot->Pipes > 1)
+    {
+        return _T("*");
     }
-    AppendTextBuffer(_T("\r\n"));
+
+    return _T(" ");
 }
 
 //*****************************************************************************
@@ -561,31 +1210,40 @@ DisplayHubCaps (
 VOID
 DisplayConnectionInfo (
     PUSB_NODE_CONNECTION_INFORMATION_EX    ConnectInfo,
-    PSTRING_DESCRIPTOR_NODE             StringDescs
+    PSTRING_DESCRIPTORS                 StringDescs
 )
 {
 
     if (ConnectInfo->ConnectionStatus == NoDeviceConnected)
     {
-        AppendTextBuffer(_T("ConnectionStatus: NoDeviceConnected\r\n"));
+        AppendTextString(_T("ConnectionStatus: NoDeviceConnected\r\n"));
     }
     else
     {
         PCTSTR VendorString;
 
-        AppendTextBuffer(_T("Device Descriptor:\r\n"));
+        AppendTextString(_T("Device Descriptor:\r\n"));
 
-        AppendTextBuffer(_T("bcdUSB:             0x%04X\r\n"),
-                         ConnectInfo->DeviceDescriptor.bcdUSB);
+        AppendTextHex(_T("bcdUSB:             "),
+                      ConnectInfo->DeviceDescriptor.bcdUSB, 4);
 
-        AppendTextBuffer(_T("bDeviceClass:         0x%02X\r\n"),
-                         ConnectInfo->DeviceDescriptor.bDeviceClass);
+        AppendTextHexName(_T("bDeviceClass:         "),
+                          ConnectInfo->DeviceDescriptor.bDeviceClass, 2,
+                          LookupUsbClassName(
+                              ConnectInfo->DeviceDescriptor.bDeviceClass));
 
-        AppendTextBuffer(_T("bDeviceSubClass:      0x%02X\r\n"),
-                         ConnectInfo->DeviceDescriptor.bDeviceSubClass);
+        AppendTextHexName(_T("bDeviceSubClass:      "),
+                          ConnectInfo->DeviceDescriptor.bDeviceSubClass, 2,
+                          LookupUsbSubClassName(
+                              ConnectInfo->DeviceDescriptor.bDeviceClass,
+                              ConnectInfo->DeviceDescriptor.bDeviceSubClass));
 
-        AppendTextBuffer(_T("bDeviceProtocol:      0x%02X\r\n"),
-                         ConnectInfo->DeviceDescriptor.bDeviceProtocol);
+        AppendTextHexName(_T("bDeviceProtocol:      "),
+                          ConnectInfo->DeviceDescriptor.bDeviceProtocol, 2,
+                          LookupUsbProtocolName(
+                              ConnectInfo->DeviceDescriptor.bDeviceClass,
+                              ConnectInfo->DeviceDescriptor.bDeviceSubClass,
+                              ConnectInfo->DeviceDescriptor.bDeviceProtocol));
 
         AppendTextBuffer(_T("bMaxPacketSize0:      0x%02X (%d)\r\n"),
                          ConnectInfo->DeviceDescriptor.bMaxPacketSize0,
@@ -593,26 +1251,21 @@ DisplayConnectionInfo (
 
         VendorString = GetVendorString(ConnectInfo->DeviceDescriptor.idVendor);
 
-        if (VendorString != NULL)
-        {
-            AppendTextBuffer(_T("idVendor:           0x%04X (%s)\r\n"),
-                             ConnectInfo->DeviceDescriptor.idVendor,
-                             VendorString);
-        }
-        else
-        {
-            AppendTextBuffer(_T("idVendor:           0x%04X\r\n"),
-                             ConnectInfo->DeviceDescriptor.idVendor);
-        }
+        AppendTextHexName(_T("idVendor:           "),
+                          ConnectInfo->DeviceDescriptor.idVendor, 4,
+                          VendorString);
 
-        AppendTextBuffer(_T("idProduct:          0x%04X\r\n"),
-                         ConnectInfo->DeviceDescriptor.idProduct);
+        AppendTextHexName(_T("idProduct:          "),
+                          ConnectInfo->DeviceDescriptor.idProduct, 4,
+                          LookupUsbProductName(
+                              ConnectInfo->DeviceDescriptor.idVendor,
+                              ConnectInfo->DeviceDescriptor.idProduct));
 
-        AppendTextBuffer(_T("bcdDevice:          0x%04X\r\n"),
-                         ConnectInfo->DeviceDescriptor.bcdDevice);
+        AppendTextHex(_T("bcdDevice:          "),
+                      ConnectInfo->DeviceDescriptor.bcdDevice, 4);
 
-        AppendTextBuffer(_T("iManufacturer:        0x%02X\r\n"),
-                         ConnectInfo->DeviceDescriptor.iManufacturer);
+        AppendTextHex(_T("iManufacturer:        "),
+                      ConnectInfo->DeviceDescriptor.iManufacturer, 2);
 
         if (ConnectInfo->DeviceDescriptor.iManufacturer)
         {
@@ -620,8 +1273,8 @@ DisplayConnectionInfo (
                                     StringDescs);
         }
 
-        AppendTextBuffer(_T("iProduct:             0x%02X\r\n"),
-                         ConnectInfo->DeviceDescriptor.iProduct);
+        AppendTextHex(_T("iProduct:             "),
+                      ConnectInfo->DeviceDescriptor.iProduct, 2);
 
         if (ConnectInfo->DeviceDescriptor.iProduct)
         {
@@ -629,8 +1282,8 @@ DisplayConnectionInfo (
                                     StringDescs);
         }
 
-        AppendTextBuffer(_T("iSerialNumber:        0x%02X\r\n"),
-                         ConnectInfo->DeviceDescriptor.iSerialNumber);
+        AppendTextHex(_T("iSerialNumber:        "),
+                      ConnectInfo->DeviceDescriptor.iSerialNumber, 2);
 
         if (ConnectInfo->DeviceDescriptor.iSerialNumber)
         {
@@ -638,32 +1291,39 @@ DisplayConnectionInfo (
                                     StringDescs);
         }
 
-        AppendTextBuffer(_T("bNumConfigurations:   0x%02X\r\n"),
-                         ConnectInfo->DeviceDescriptor.bNumConfigurations);
+        AppendTextHex(_T("bNumConfigurations:   "),
+                      ConnectInfo->DeviceDescriptor.bNumConfigurations, 2);
+
+        if (StringDescs != NULL && StringDescs->RequestsSent != 0)
+        {
+            AppendTextBuffer(_T("String Requests:      %d sent, %d saved\r\n"),
+                             StringDescs->RequestsSent,
+                             StringDescs->RequestsSaved);
+        }
 
         AppendTextBuffer(_T("\r\nConnectionStatus: %s\r\n"),
                          ConnectionStatuses[ConnectInfo->ConnectionStatus]);
 
-        AppendTextBuffer(_T("Current Config Value: 0x%02X\r\n"),
-                         ConnectInfo->CurrentConfigurationValue);
+        AppendTextHex(_T("Current Config Value: "),
+                      ConnectInfo->CurrentConfigurationValue, 2);
 
 	switch	(ConnectInfo->Speed){
 		case UsbLowSpeed:
-			AppendTextBuffer(_T("Device Bus Speed:     Low\r\n"));
+			AppendTextString(_T("Device Bus Speed:     Low\r\n"));
 			break;
 		case UsbFullSpeed:
-			AppendTextBuffer(_T("Device Bus Speed:     Full\r\n"));
+			AppendTextString(_T("Device Bus Speed:     Full\r\n"));
 			break;
 		case UsbHighSpeed:
-			AppendTextBuffer(_T("Device Bus Speed:     High\r\n"));
+			AppendTextString(_T("Device Bus Speed:     High\r\n"));
 			break;
 		default:
-			AppendTextBuffer(_T("Device Bus Speed:     Unknown\r\n"));
+			AppendTextString(_T("Device Bus Speed:     Unknown\r\n"));
 
 	}
 
-        AppendTextBuffer(_T("Device Address:       0x%02X\r\n"),
-                         ConnectInfo->DeviceAddress);
+        AppendTextHex(_T("Device Address:       "),
+                      ConnectInfo->DeviceAddress, 2);
 
         AppendTextBuffer(_T("Open Pipes:             %2d\r\n"),
                          ConnectInfo->NumberOfOpenPipes);
@@ -676,6 +1336,66 @@ DisplayConnectionInfo (
     }
 }
 
+//*****************************************************************************
+//
+// DisplaySpeedDowngrade()
+//
+// QualifierDesc - Device Qualifier Descriptor of a full speed device, or
+// NULL.
+//
+// SpeedDowngrade - Why the device does not run at high speed, see
+// DetectSpeedDowngrades().
+//
+//*****************************************************************************
+
+VOID
+DisplaySpeedDowngrade (
+    PUSB_DEVICE_QUALIFIER_DESCRIPTOR    QualifierDesc,
+    SPEED_DOWNGRADE                     SpeedDowngrade
+)
+{
+    if (QualifierDesc)
+    {
+        AppendTextString(_T("\r\nDevice Qualifier Descriptor:\r\n"));
+
+        AppendTextHex(_T("bcdUSB:             "),
+                      QualifierDesc->bcdUSB, 4);
+
+        AppendTextHexName(_T("bDeviceClass:         "),
+                          QualifierDesc->bDeviceClass, 2,
+                          LookupUsbClassName(QualifierDesc->bDeviceClass));
+
+        AppendTextHexName(_T("bDeviceSubClass:      "),
+                          QualifierDesc->bDeviceSubClass, 2,
+                          LookupUsbSubClassName(QualifierDesc->bDeviceClass,
+                                                QualifierDesc->bDeviceSubClass));
+
+        AppendTextHexName(_T("bDeviceProtocol:      "),
+                          QualifierDesc->bDeviceProtocol, 2,
+                          LookupUsbProtocolName(QualifierDesc->bDeviceClass,
+                                                QualifierDesc->bDeviceSubClass,
+                                                QualifierDesc->bDeviceProtocol));
+
+        AppendTextBuffer(_T("bMaxPacketSize0:      0x%02X (%d)\r\n"),
+                         QualifierDesc->bMaxPacketSize0,
+                         QualifierDesc->bMaxPacketSize0);
+
+        AppendTextHex(_T("bNumConfigurations:   "),
+                      QualifierDesc->bNumConfigurations, 2);
+    }
+
+    switch (SpeedDowngrade)
+    {
+        case SpeedDowngradedByHub:
+            AppendTextString(_T("Speed Downgrade:      High speed capable, a hub or host controller above is not\r\n"));
+            break;
+
+        case SpeedDowngradedByLink:
+            AppendTextString(_T("Speed Downgrade:      High speed capable on a high speed port, check the cable\r\n"));
+            break;
+    }
+}
+
 //*****************************************************************************
 //
 // DisplayPipeInfo()
@@ -709,93 +1429,75 @@ DisplayPipeInfo (
 // ConfigDesc - The Configuration Descriptor, and associated Interface and
 // EndpointDescriptors
 //
+// Each descriptor is a section of its own.  Those out of the range being
+// rendered are skipped, the index of the Configuration Descriptor tells
+// which interface each class specific descriptor belongs to.
+//
 //*****************************************************************************
 
 VOID
 DisplayConfigDesc (
-    PUSB_CONFIGURATION_DESCRIPTOR   ConfigDesc,
-    PSTRING_DESCRIPTOR_NODE         StringDescs
+    PUSB_DESCRIPTOR_REQUEST         ConfigDesc,
+    PSTRING_DESCRIPTORS             StringDescs
 )
 {
-    PUCHAR                  descEnd;
-    PUSB_COMMON_DESCRIPTOR  commonDesc;
-    UCHAR                   bInterfaceClass;
-    UCHAR                   bInterfaceSubClass;
-    BOOL                    displayUnknown;
-
-    bInterfaceClass = 0;
+    PCONFIG_DESC_INDEX          configIndex;
+    PCONFIG_DESC_ENTRY          entry;
+    PUSB_COMMON_DESCRIPTOR      commonDesc;
+    PUSB_INTERFACE_DESCRIPTOR   interfaceDesc;
+    BOOL                        displayUnknown;
 
-    descEnd = (PUCHAR)ConfigDesc + ConfigDesc->wTotalLength;
+    configIndex = GetConfigDescIndex(ConfigDesc);
 
-    commonDesc = (PUSB_COMMON_DESCRIPTOR)ConfigDesc;
-
-    while ((PUCHAR)commonDesc + sizeof(USB_COMMON_DESCRIPTOR) < descEnd &&
-           (PUCHAR)commonDesc + commonDesc->bLength <= descEnd)
+    for (entry = configIndex->Entries;
+         entry < configIndex->Entries + configIndex->NumEntries;
+         entry++)
     {
+        if (!BeginSection())
+        {
+            EndSection();
+            continue;
+        }
+
+        commonDesc = CONFIG_ENTRY_DESC(ConfigDesc, entry);
         displayUnknown = FALSE;
 
-        switch (commonDesc->bDescriptorType)
+        switch (entry->Kind)
         {
-            case USB_CONFIGURATION_DESCRIPTOR_TYPE:
-                if (commonDesc->bLength != sizeof(USB_CONFIGURATION_DESCRIPTOR))
-                {
-                    OOPS();
-                    displayUnknown = TRUE;
-                    break;
-                }
+            case ConfigDescConfiguration:
                 DisplayConfigurationDescriptor((PUSB_CONFIGURATION_DESCRIPTOR)commonDesc,
                                                StringDescs);
                 break;
 
-            case USB_INTERFACE_DESCRIPTOR_TYPE:
-                if ((commonDesc->bLength != sizeof(USB_INTERFACE_DESCRIPTOR)) &&
-                    (commonDesc->bLength != sizeof(USB_INTERFACE_DESCRIPTOR2)))
-                {
-                    OOPS();
-                    displayUnknown = TRUE;
-                    break;
-                }
-                bInterfaceClass = ((PUSB_INTERFACE_DESCRIPTOR)commonDesc)->bInterfaceClass;
-                bInterfaceSubClass = ((PUSB_INTERFACE_DESCRIPTOR)commonDesc)->bInterfaceSubClass;
-
+            case ConfigDescInterface:
                 DisplayInterfaceDescriptor((PUSB_INTERFACE_DESCRIPTOR)commonDesc,
                                            StringDescs);
                 break;
 
-            case USB_ENDPOINT_DESCRIPTOR_TYPE:
-                if ((commonDesc->bLength != sizeof(USB_ENDPOINT_DESCRIPTOR)) &&
-                    (commonDesc->bLength != sizeof(USB_ENDPOINT_DESCRIPTOR2)))
-                {
-                    OOPS();
-                    displayUnknown = TRUE;
-                    break;
-                }
+            case ConfigDescEndpoint:
                 DisplayEndpointDescriptor((PUSB_ENDPOINT_DESCRIPTOR)commonDesc);
                 break;
 
-            case USB_HID_DESCRIPTOR_TYPE:
-                if (commonDesc->bLength < sizeof(USB_HID_DESCRIPTOR))
+            case ConfigDescHid:
+                DisplayHidDescriptor((PUSB_HID_DESCRIPTOR)commonDesc);
+                break;
+
+            case ConfigDescOther:
+                if (entry->InterfaceEntry == NO_CONFIG_ENTRY)
                 {
-                    OOPS();
                     displayUnknown = TRUE;
                     break;
                 }
-                DisplayHidDescriptor((PUSB_HID_DESCRIPTOR)commonDesc);
+
+                interfaceDesc = (PUSB_INTERFACE_DESCRIPTOR)CONFIG_ENTRY_DESC(
+                    ConfigDesc, &configIndex->Entries[entry->InterfaceEntry]);
+
+                displayUnknown = !DisplayClassDescriptor(commonDesc,
+                                                         interfaceDesc);
                 break;
 
             default:
-                switch (bInterfaceClass)
-                {
-                    case USB_DEVICE_CLASS_AUDIO:
-                        displayUnknown = !DisplayAudioDescriptor(
-                                              (PUSB_AUDIO_COMMON_DESCRIPTOR)commonDesc,
-                                              bInterfaceSubClass);
-                        break;
-
-                    default:
-                        displayUnknown = TRUE;
-                        break;
-                }
+                displayUnknown = TRUE;
                 break;
         }
 
@@ -804,7 +1506,7 @@ DisplayConfigDesc (
             DisplayUnknownDescriptor(commonDesc);
         }
 
-        (PUCHAR)commonDesc += commonDesc->bLength;
+        EndSection();
     }
 }
 
@@ -818,23 +1520,23 @@ DisplayConfigDesc (
 VOID
 DisplayConfigurationDescriptor (
     PUSB_CONFIGURATION_DESCRIPTOR   ConfigDesc,
-    PSTRING_DESCRIPTOR_NODE         StringDescs
+    PSTRING_DESCRIPTORS             StringDescs
 )
 {
 
-    AppendTextBuffer(_T("\r\nConfiguration Descriptor:\r\n"));
+    AppendTextString(_T("\r\nConfiguration Descriptor:\r\n"));
 
-    AppendTextBuffer(_T("wTotalLength:       0x%04X\r\n"),
-                     ConfigDesc->wTotalLength);
+    AppendTextHex(_T("wTotalLength:       "),
+                  ConfigDesc->wTotalLength, 4);
 
-    AppendTextBuffer(_T("bNumInterfaces:       0x%02X\r\n"),
-                     ConfigDesc->bNumInterfaces);
+    AppendTextHex(_T("bNumInterfaces:       "),
+                  ConfigDesc->bNumInterfaces, 2);
 
-    AppendTextBuffer(_T("bConfigurationValue:  0x%02X\r\n"),
-                     ConfigDesc->bConfigurationValue);
+    AppendTextHex(_T("bConfigurationValue:  "),
+                  ConfigDesc->bConfigurationValue, 2);
 
-    AppendTextBuffer(_T("iConfiguration:       0x%02X\r\n"),
-                     ConfigDesc->iConfiguration);
+    AppendTextHex(_T("iConfiguration:       "),
+                  ConfigDesc->iConfiguration, 2);
 
     if (ConfigDesc->iConfiguration)
     {
@@ -847,20 +1549,20 @@ DisplayConfigurationDescriptor (
 
     if (ConfigDesc->bmAttributes & 0x80)
     {
-        AppendTextBuffer(_T("Bus Powered "));
+        AppendTextString(_T("Bus Powered "));
     }
 
     if (ConfigDesc->bmAttributes & 0x40)
     {
-        AppendTextBuffer(_T("Self Powered "));
+        AppendTextString(_T("Self Powered "));
     }
 
     if (ConfigDesc->bmAttributes & 0x20)
     {
-        AppendTextBuffer(_T("Remote Wakeup"));
+        AppendTextString(_T("Remote Wakeup"));
     }
 
-    AppendTextBuffer(_T(")\r\n"));
+    AppendTextString(_T(")\r\n"));
 
     AppendTextBuffer(_T("MaxPower:             0x%02X (%d mA)\r\n"),
                      ConfigDesc->MaxPower,
@@ -877,26 +1579,28 @@ DisplayConfigurationDescriptor (
 VOID
 DisplayInterfaceDescriptor (
     PUSB_INTERFACE_DESCRIPTOR   InterfaceDesc,
-    PSTRING_DESCRIPTOR_NODE     StringDescs
+    PSTRING_DESCRIPTORS         StringDescs
 )
 {
     PCTSTR pStr;
+    PCTSTR name;
 
-    AppendTextBuffer(_T("\r\nInterface Descriptor:\r\n"));
+    AppendTextString(_T("\r\nInterface Descriptor:\r\n"));
 
-    AppendTextBuffer(_T("bInterfaceNumber:     0x%02X\r\n"),
-                     InterfaceDesc->bInterfaceNumber);
+    AppendTextHex(_T("bInterfaceNumber:     "),
+                  InterfaceDesc->bInterfaceNumber, 2);
 
-    AppendTextBuffer(_T("bAlternateSetting:    0x%02X\r\n"),
-                     InterfaceDesc->bAlternateSetting);
+    AppendTextHex(_T("bAlternateSetting:    "),
+                  InterfaceDesc->bAlternateSetting, 2);
 
-    AppendTextBuffer(_T("bNumEndpoints:        0x%02X\r\n"),
-                     InterfaceDesc->bNumEndpoints);
+    AppendTextHex(_T("bNumEndpoints:        "),
+                  InterfaceDesc->bNumEndpoints, 2);
 
     AppendTextBuffer(_T("bInterfaceClass:      0x%02X"),
                      InterfaceDesc->bInterfaceClass);
 
     pStr = _T("\r\n");
+    name = NULL;
 
     switch (InterfaceDesc->bInterfaceClass)
     {
@@ -913,15 +1617,17 @@ DisplayInterfaceDescriptor (
             break;
 
         default:
+            name = LookupUsbClassName(InterfaceDesc->bInterfaceClass);
             break;
     }
 
-    AppendTextBuffer(pStr);
+    AppendTextNameOr(name, pStr);
 
     AppendTextBuffer(_T("bInterfaceSubClass:   0x%02X"),
                      InterfaceDesc->bInterfaceSubClass);
 
     pStr = _T("\r\n");
+    name = NULL;
 
     switch (InterfaceDesc->bInterfaceClass)
     {
@@ -941,21 +1647,28 @@ DisplayInterfaceDescriptor (
                     break;
 
                 default:
+                    name = LookupUsbSubClassName(InterfaceDesc->bInterfaceClass,
+                                                 InterfaceDesc->bInterfaceSubClass);
                     break;
             }
             break;
 
         default:
+            name = LookupUsbSubClassName(InterfaceDesc->bInterfaceClass,
+                                         InterfaceDesc->bInterfaceSubClass);
             break;
     }
 
-    AppendTextBuffer(pStr);
+    AppendTextNameOr(name, pStr);
 
-    AppendTextBuffer(_T("bInterfaceProtocol:   0x%02X\r\n"),
-                     InterfaceDesc->bInterfaceProtocol);
+    AppendTextHexName(_T("bInterfaceProtocol:   "),
+                      InterfaceDesc->bInterfaceProtocol, 2,
+                      LookupUsbProtocolName(InterfaceDesc->bInterfaceClass,
+                                            InterfaceDesc->bInterfaceSubClass,
+                                            InterfaceDesc->bInterfaceProtocol));
 
-    AppendTextBuffer(_T("iInterface:           0x%02X\r\n"),
-                     InterfaceDesc->iInterface);
+    AppendTextHex(_T("iInterface:           "),
+                  InterfaceDesc->iInterface, 2);
 
     if (InterfaceDesc->iInterface)
     {
@@ -969,8 +1682,8 @@ DisplayInterfaceDescriptor (
 
         interfaceDesc2 = (PUSB_INTERFACE_DESCRIPTOR2)InterfaceDesc;
 
-        AppendTextBuffer(_T("wNumClasses:        0x%04X\r\n"),
-                         interfaceDesc2->wNumClasses);
+        AppendTextHex(_T("wNumClasses:        "),
+                      interfaceDesc2->wNumClasses, 4);
     }
 
 }
@@ -987,7 +1700,7 @@ DisplayEndpointDescriptor (
 )
 {
 
-    AppendTextBuffer(_T("\r\nEndpoint Descriptor:\r\n"));
+    AppendTextString(_T("\r\nEndpoint Descriptor:\r\n"));
 
     if (USB_ENDPOINT_DIRECTION_IN(EndpointDesc->bEndpointAddress))
     {
@@ -1003,19 +1716,19 @@ DisplayEndpointDescriptor (
     switch (EndpointDesc->bmAttributes & 0x03)
     {
         case 0x00:
-            AppendTextBuffer(_T("Transfer Type:     Control\r\n"));
+            AppendTextString(_T("Transfer Type:     Control\r\n"));
             break;
 
         case 0x01:
-            AppendTextBuffer(_T("Transfer Type: Isochronous\r\n"));
+            AppendTextString(_T("Transfer Type: Isochronous\r\n"));
             break;
 
         case 0x02:
-            AppendTextBuffer(_T("Transfer Type:        Bulk\r\n"));
+            AppendTextString(_T("Transfer Type:        Bulk\r\n"));
             break;
 
         case 0x03:
-            AppendTextBuffer(_T("Transfer Type:   Interrupt\r\n"));
+            AppendTextString(_T("Transfer Type:   Interrupt\r\n"));
             break;
 
     }
@@ -1026,8 +1739,8 @@ DisplayEndpointDescriptor (
 
     if (EndpointDesc->bLength == sizeof(USB_ENDPOINT_DESCRIPTOR))
     {
-        AppendTextBuffer(_T("bInterval:            0x%02X\r\n"),
-                         EndpointDesc->bInterval);
+        AppendTextHex(_T("bInterval:            "),
+                      EndpointDesc->bInterval, 2);
     }
     else
     {
@@ -1035,11 +1748,11 @@ DisplayEndpointDescriptor (
 
         endpointDesc2 = (PUSB_ENDPOINT_DESCRIPTOR2)EndpointDesc;
 
-        AppendTextBuffer(_T("wInterval:          0x%04X\r\n"),
-                         endpointDesc2->wInterval);
+        AppendTextHex(_T("wInterval:          "),
+                      endpointDesc2->wInterval, 4);
 
-        AppendTextBuffer(_T("bSyncAddress:         0x%02X\r\n"),
-                         endpointDesc2->bSyncAddress);
+        AppendTextHex(_T("bSyncAddress:         "),
+                      endpointDesc2->bSyncAddress, 2);
     }
 
 }
@@ -1058,26 +1771,176 @@ DisplayHidDescriptor (
 {
     UCHAR i;
 
-    AppendTextBuffer(_T("\r\nHID Descriptor:\r\n"));
+    AppendTextString(_T("\r\nHID Descriptor:\r\n"));
 
-    AppendTextBuffer(_T("bcdHID:             0x%04X\r\n"),
-    HidDesc->bcdHID);
+    AppendTextHex(_T("bcdHID:             "),
+ HidDesc->bcdHID, 4);
 
-    AppendTextBuffer(_T("bCountryCode:         0x%02X\r\n"),
-                     HidDesc->bCountryCode);
+    AppendTextHex(_T("bCountryCode:         "),
+                  HidDesc->bCountryCode, 2);
 
-    AppendTextBuffer(_T("bNumDescriptors:      0x%02X\r\n"),
-                     HidDesc->bNumDescriptors);
+    AppendTextHex(_T("bNumDescriptors:      "),
+                  HidDesc->bNumDescriptors, 2);
 
     for (i=0; i<HidDesc->bNumDescriptors; i++)
     {
-        AppendTextBuffer(_T("bDescriptorType:      0x%02X\r\n"),
-                         HidDesc->OptionalDescriptors[i].bDescriptorType);
+        AppendTextHex(_T("bDescriptorType:      "),
+                      HidDesc->OptionalDescriptors[i].bDescriptorType, 2);
+
+        AppendTextHex(_T("wDescriptorLength:  "),
+                      HidDesc->OptionalDescriptors[i].wDescriptorLength, 4);
+    }
+
+}
+
+
+//*****************************************************************************
+//
+// DisplayPipeUsageDescriptor()
+//
+// Follows each endpoint of a USB Attached SCSI interface.
+//
+//*****************************************************************************
+
+PCTSTR PipeIDs[] =
+{
+    _T("Reserved"),
+    _T("Command"),
+    _T("Status"),
+    _T("Data-In"),
+    _T("Data-Out")
+};
+
+BOOL
+DisplayPipeUsageDescriptor (
+    PUSB_STORAGE_PIPE_USAGE_DESCRIPTOR  PipeUsageDesc
+)
+{
+    if (PipeUsageDesc->bLength < sizeof(USB_STORAGE_PIPE_USAGE_DESCRIPTOR))
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    AppendTextString(_T("\r\nMass Storage Pipe Usage Descriptor:\r\n"));
+
+    AppendTextHexName(_T("bPipeID:              "),
+                      PipeUsageDesc->bPipeID, 2,
+                      PipeUsageDesc->bPipeID < sizeof(PipeIDs) / sizeof(PipeIDs[0]) ?
+                      PipeIDs[PipeUsageDesc->bPipeID] : NULL);
+
+    return TRUE;
+}
+
+
+//*****************************************************************************
+//
+// DisplayHubDescriptor()
+//
+// DeviceRemovable and PortPwrCtrlMask have a bit for each port and one for
+// the hub, rounded up to whole bytes.
+//
+//*****************************************************************************
+
+BOOL
+DisplayHubDescriptor (
+    PUSB_HUB_DESCRIPTOR         HubDesc
+)
+{
+    UCHAR maskLength;
+    UCHAR i;
+
+    maskLength = (UCHAR)((HubDesc->bNumberOfPorts + 8) / 8);
+
+    if (HubDesc->bDescriptorLength < FIELD_OFFSET(USB_HUB_DESCRIPTOR, bRemoveAndPowerMask) +
+                                     maskLength * 2)
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    AppendTextString(_T("\r\nHub Descriptor:\r\n"));
+
+    AppendTextHex(_T("bNumberOfPorts:       "),
+                  HubDesc->bNumberOfPorts, 2);
+
+    AppendTextHex(_T("wHubCharacteristics:"),
+                  HubDesc->wHubCharacteristics, 4);
+
+    AppendTextBuffer(_T("bPowerOnToPowerGood:  0x%02X (%d ms)\r\n"),
+                     HubDesc->bPowerOnToPowerGood,
+                     HubDesc->bPowerOnToPowerGood * 2);
+
+    AppendTextBuffer(_T("bHubControlCurrent:   0x%02X (%d mA)\r\n"),
+                     HubDesc->bHubControlCurrent,
+                     HubDesc->bHubControlCurrent);
+
+    AppendTextString(_T("DeviceRemovable:      "));
+
+    for (i = 0; i < maskLength; i++)
+    {
+        AppendTextBuffer(_T("%02X "),
+                         HubDesc->bRemoveAndPowerMask[i]);
+    }
+
+    AppendTextString(_T("\r\nPortPwrCtrlMask:      "));
+
+    for (i = 0; i < maskLength; i++)
+    {
+        AppendTextBuffer(_T("%02X "),
+                         HubDesc->bRemoveAndPowerMask[maskLength + i]);
+    }
+
+    AppendTextString(_T("\r\n"));
+
+    return TRUE;
+}
+
+
+//*****************************************************************************
+//
+// DisplaySSHubDescriptor()
+//
+//*****************************************************************************
 
-        AppendTextBuffer(_T("wDescriptorLength:  0x%04X\r\n"),
-                         HidDesc->OptionalDescriptors[i].wDescriptorLength);
+BOOL
+DisplaySSHubDescriptor (
+    PUSB_SS_HUB_DESCRIPTOR      HubDesc
+)
+{
+    if (HubDesc->bLength < sizeof(USB_SS_HUB_DESCRIPTOR))
+    {
+        OOPS();
+        return FALSE;
     }
 
+    AppendTextString(_T("\r\nSuperSpeed Hub Descriptor:\r\n"));
+
+    AppendTextHex(_T("bNumberOfPorts:       "),
+                  HubDesc->bNumberOfPorts, 2);
+
+    AppendTextHex(_T("wHubCharacteristics:"),
+                  HubDesc->wHubCharacteristics, 4);
+
+    AppendTextBuffer(_T("bPowerOnToPowerGood:  0x%02X (%d ms)\r\n"),
+                     HubDesc->bPowerOnToPowerGood,
+                     HubDesc->bPowerOnToPowerGood * 2);
+
+    AppendTextBuffer(_T("bHubControlCurrent:   0x%02X (%d mA)\r\n"),
+                     HubDesc->bHubControlCurrent,
+                     HubDesc->bHubControlCurrent * 4);
+
+    AppendTextHex(_T("bHubHdrDecLat:        "),
+                  HubDesc->bHubHdrDecLat, 2);
+
+    AppendTextBuffer(_T("wHubDelay:          0x%04X (%d ns)\r\n"),
+                     HubDesc->wHubDelay,
+                     HubDesc->wHubDelay);
+
+    AppendTextHex(_T("DeviceRemovable:    "),
+                  HubDesc->DeviceRemovable, 4);
+
+    return TRUE;
 }
 
 
@@ -1106,48 +1969,48 @@ DisplayPowerDescriptor (
 {
     UCHAR i;
 
-    AppendTextBuffer(_T("\r\nPower Descriptor:\r\n"));
+    AppendTextString(_T("\r\nPower Descriptor:\r\n"));
 
     AppendTextBuffer(_T("bCapabilitiesFlags:   0x%02X ("),
                      PowerDesc->bCapabilitiesFlags);
 
     if (PowerDesc->bCapabilitiesFlags & USB_SUPPORT_D2_WAKEUP)
     {
-        AppendTextBuffer(_T("WakeD2 "));
+        AppendTextString(_T("WakeD2 "));
     }
     if (PowerDesc->bCapabilitiesFlags & USB_SUPPORT_D1_WAKEUP)
     {
-        AppendTextBuffer(_T("WakeD1 "));
+        AppendTextString(_T("WakeD1 "));
     }
     if (PowerDesc->bCapabilitiesFlags & USB_SUPPORT_D3_COMMAND)
     {
-        AppendTextBuffer(_T("D3 "));
+        AppendTextString(_T("D3 "));
     }
     if (PowerDesc->bCapabilitiesFlags & USB_SUPPORT_D2_COMMAND)
     {
-        AppendTextBuffer(_T("D2 "));
+        AppendTextString(_T("D2 "));
     }
     if (PowerDesc->bCapabilitiesFlags & USB_SUPPORT_D1_COMMAND)
     {
-        AppendTextBuffer(_T("D1 "));
+        AppendTextString(_T("D1 "));
     }
     if (PowerDesc->bCapabilitiesFlags & USB_SUPPORT_D0_COMMAND)
     {
-        AppendTextBuffer(_T("D0 "));
+        AppendTextString(_T("D0 "));
     }
-    AppendTextBuffer(_T(")\r\n"));
+    AppendTextString(_T(")\r\n"));
 
-    AppendTextBuffer(_T("EventNotification:  0x%04X\r\n"),
-                     PowerDesc->EventNotification);
+    AppendTextHex(_T("EventNotification:  "),
+                  PowerDesc->EventNotification, 4);
 
-    AppendTextBuffer(_T("D1LatencyTime:      0x%04X\r\n"),
-                     PowerDesc->D1LatencyTime);
+    AppendTextHex(_T("D1LatencyTime:      "),
+                  PowerDesc->D1LatencyTime, 4);
 
-    AppendTextBuffer(_T("D2LatencyTime:      0x%04X\r\n"),
-                     PowerDesc->D2LatencyTime);
+    AppendTextHex(_T("D2LatencyTime:      "),
+                  PowerDesc->D2LatencyTime, 4);
 
-    AppendTextBuffer(_T("D3LatencyTime:      0x%04X\r\n"),
-                     PowerDesc->D3LatencyTime);
+    AppendTextHex(_T("D3LatencyTime:      "),
+                  PowerDesc->D3LatencyTime, 4);
 
     AppendTextBuffer(_T("PowerUnit:            0x%02X (%s)\r\n"),
                      PowerDesc->PowerUnit,
@@ -1180,40 +2043,38 @@ DisplayPowerDescriptor (
 VOID
 DisplayStringDescriptor (
     UCHAR                       Index,
-    PSTRING_DESCRIPTOR_NODE     StringDescs
+    PSTRING_DESCRIPTORS         StringDescs
 )
 {
+    PSTRING_DESCRIPTOR_RECORD   record;
+
     // Use an actual "int" here because it's passed as a printf * precision
     int descChars;  
 
-    while (StringDescs)
+    for (record = FirstStringDescriptor(StringDescs, Index);
+         record != NULL;
+         record = NextStringDescriptor(StringDescs, record))
     {
-        if (StringDescs->DescriptorIndex == Index)
-        {
-
-            //
-            // bString from USB_STRING_DESCRIPTOR isn't NULL-terminated, so 
-            // calculate the number of characters.  
-            // 
-            // bLength is the length of the whole structure, not just the string.  
-            // 
-            // bLength is bytes, bString is WCHARs
-            // 
-            descChars = 
-                ( (int) StringDescs->StringDescriptor->bLength - 
-                offsetof(USB_STRING_DESCRIPTOR, bString) ) /
-                sizeof(WCHAR);
-            //
-            // Use the * precision and pass the number of characters just caculated.
-            // bString is always WCHAR so specify widestring regardless of what TCHAR resolves to
-            // 
-            AppendTextBuffer(_T("0x%04X: \"%.*ws\"\r\n"),
-                StringDescs->LanguageID,
-                descChars,
-                StringDescs->StringDescriptor->bString);
-        }
-
-        StringDescs = StringDescs->Next;
+        //
+        // bString from USB_STRING_DESCRIPTOR isn't NULL-terminated, so 
+        // calculate the number of characters.  
+        // 
+        // bLength is the length of the whole structure, not just the string.  
+        // 
+        // bLength is bytes, bString is WCHARs
+        // 
+        descChars = 
+            ( (int) record->StringDescriptor->bLength - 
+            offsetof(USB_STRING_DESCRIPTOR, bString) ) /
+            sizeof(WCHAR);
+        //
+        // Use the * precision and pass the number of characters just caculated.
+        // bString is always WCHAR so specify widestring regardless of what TCHAR resolves to
+        // 
+        AppendTextBuffer(_T("0x%04X: \"%.*ws\"\r\n"),
+            record->LanguageID,
+            descChars,
+            record->StringDescriptor->bString);
     }
 
 }
@@ -1232,13 +2093,13 @@ DisplayUnknownDescriptor (
 {
     UCHAR   i;
 
-    AppendTextBuffer(_T("\r\nUnknown Descriptor:\r\n"));
+    AppendTextString(_T("\r\nUnknown Descriptor:\r\n"));
 
-    AppendTextBuffer(_T("bDescriptorType:      0x%02X\r\n"),
-                     CommonDesc->bDescriptorType);
+    AppendTextHex(_T("bDescriptorType:      "),
+                  CommonDesc->bDescriptorType, 2);
 
-    AppendTextBuffer(_T("bLength:              0x%02X\r\n"),
-                     CommonDesc->bLength);
+    AppendTextHex(_T("bLength:              "),
+                  CommonDesc->bLength, 2);
 
     for (i = 0; i < CommonDesc->bLength; i++)
     {
@@ -1247,13 +2108,13 @@ DisplayUnknownDescriptor (
 
         if (i % 16 == 15)
         {
-            AppendTextBuffer(_T("\r\n"));
+            AppendTextString(_T("\r\n"));
         }
     }
 
     if (i % 16 != 0)
     {
-        AppendTextBuffer(_T("\r\n"));
+        AppendTextString(_T("\r\n"));
     }
 
 }
@@ -1267,30 +2128,103 @@ DisplayUnknownDescriptor (
 // Return Value - Vendor name string associated with idVendor, or NULL if
 // no vendor name string is found which is associated with idVendor.
 //
+// A name from the USB ID database, see USBIDS.C, takes precedence over the
+// built-in table.  The high byte of idVendor picks the few entries of the
+// table to search, so the cost does not grow with the size of the table.
+//
 //*****************************************************************************
 
-PTSTR
+PCTSTR
 GetVendorString (
     USHORT     idVendor
 )
 {
-    PUSBVENDORID vendorID;
+    PCTSTR  name;
+    ULONG   low;
+    ULONG   high;
+    ULONG   middle;
+
+    if (idVendor == 0x0000)
+    {
+        return NULL;
+    }
+
+    name = LookupUsbVendorName(idVendor);
+
+    if (name != NULL)
+    {
+        return name;
+    }
+
+    if (!UsbVendorIndexReady)
+    {
+        BuildVendorIndex();
+    }
+
+    low = UsbVendorIndex[idVendor >> 8];
+    high = UsbVendorIndex[(idVendor >> 8) + 1];
+
+    while (low < high)
+    {
+        middle = (low + high) / 2;
+
+        if (UsbVendorTable[middle].VendorID < idVendor)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
 
-    if (idVendor != 0x0000)
+    if (low < NUM_USB_VENDORS && UsbVendorTable[low].VendorID == idVendor)
     {
-        vendorID = USBVendorIDs;
+        return (PCTSTR)&UsbVendorNames + UsbVendorTable[low].NameOffset;
+    }
+
+    return NULL;
+}
 
-        while (vendorID->usVendorID != 0x0000)
+//*****************************************************************************
+//
+// BuildVendorIndex()
+//
+// Any number of threads may build the index at the same time, they all
+// store the same values.
+//
+//*****************************************************************************
+
+VOID
+BuildVendorIndex (
+    VOID
+)
+{
+    ULONG   entry;
+    ULONG   highByte;
+
+    entry = 0;
+
+    for (highByte = 0; highByte <= 256; highByte++)
+    {
+        while (entry < NUM_USB_VENDORS &&
+               (ULONG)(UsbVendorTable[entry].VendorID >> 8) < highByte)
         {
-            if (vendorID->usVendorID == idVendor)
+            // VNDRLIST.H must be sorted
+            //
+            if (entry > 0 &&
+                UsbVendorTable[entry].VendorID <= UsbVendorTable[entry - 1].VendorID)
             {
-                return (vendorID->szVendor);
+                OOPS();
             }
-            vendorID++;
+
+            entry++;
         }
+
+        UsbVendorIndex[highByte] = (USHORT)entry;
     }
 
-    return NULL;
+    InterlockedExchange(&UsbVendorIndexReady, TRUE);
 }
 
 #if _MSC_VER >= 1200
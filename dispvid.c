@@ -0,0 +1,1065 @@
+/*++
+
+Copyright (c) 1997-1998 Microsoft Corporation
+
+Module Name:
+
+    DISPVID.C
+
+Abstract:
+
+    This source file contains routines which update the edit control
+    to display information about USB Video Class (UVC) descriptors: the
+    terminals and units of a Video Control interface, and the formats and
+    frames of a Video Streaming interface.
+
+    The routines are found through VideoClassDecoders, see CLASSDEC.C.
+
+Environment:
+
+    user mode
+
+Revision History:
+
+    10-16-26 : created
+
+--*/
+
+//*****************************************************************************
+// I N C L U D E S
+//*****************************************************************************
+
+#include <windows.h>
+#include <basetyps.h>
+#include <tchar.h>
+#include "usbview.h"
+
+//*****************************************************************************
+// T Y P E D E F S
+//*****************************************************************************
+
+typedef struct _VIDEOTERMTYPE
+{
+    USHORT  TermTypeCode;
+    PCTSTR  TermTypeName;
+} VIDEOTERMTYPE, *PVIDEOTERMTYPE;
+
+//*****************************************************************************
+// G L O B A L S    P R I V A T E    T O    T H I S    F I L E
+//*****************************************************************************
+
+//
+// USB Device Class Definition for Video Devices 1.1, Appendix B
+//
+VIDEOTERMTYPE VideoTermTypes[] =
+{
+    //
+    // B.1 USB Terminal Types
+    //
+    {0x0100, _T("USB vendor specific")},
+    {0x0101, _T("USB streaming")},
+    //
+    // B.2 Input Terminal Types
+    //
+    {0x0200, _T("Input vendor specific")},
+    {0x0201, _T("Camera sensor")},
+    {0x0202, _T("Sequential media")},
+    //
+    // B.3 Output Terminal Types
+    //
+    {0x0300, _T("Output vendor specific")},
+    {0x0301, _T("Display")},
+    {0x0302, _T("Sequential media")},
+    //
+    // B.4 External Terminal Types
+    //
+    {0x0400, _T("External vendor specific")},
+    {0x0401, _T("Composite video connector")},
+    {0x0402, _T("S-Video connector")},
+    {0x0403, _T("Component video connector")},
+    //
+    // Terminate List
+    //
+    {0xFFFF, NULL}
+};
+
+//*****************************************************************************
+// L O C A L    F U N C T I O N    P R O T O T Y P E S
+//*****************************************************************************
+
+BOOL
+DisplayVCHeader (
+    PUSB_VIDEO_VC_HEADER_DESCRIPTOR HeaderDesc
+);
+
+BOOL
+DisplayVCInputTerminal (
+    PUSB_VIDEO_INPUT_TERMINAL_DESCRIPTOR ITDesc
+);
+
+BOOL
+DisplayVCOutputTerminal (
+    PUSB_VIDEO_OUTPUT_TERMINAL_DESCRIPTOR OTDesc
+);
+
+BOOL
+DisplayVCSelectorUnit (
+    PUSB_VIDEO_SELECTOR_UNIT_DESCRIPTOR SelectorDesc
+);
+
+BOOL
+DisplayVCProcessingUnit (
+    PUSB_VIDEO_PROCESSING_UNIT_DESCRIPTOR ProcessingDesc
+);
+
+BOOL
+DisplayVCExtensionUnit (
+    PUSB_VIDEO_EXTENSION_UNIT_DESCRIPTOR ExtensionDesc
+);
+
+BOOL
+DisplayVCInterruptEndpoint (
+    PUSB_VIDEO_INTERRUPT_ENDPOINT_DESCRIPTOR EndpointDesc
+);
+
+BOOL
+DisplayVSInputHeader (
+    PUSB_VIDEO_VS_INPUT_HEADER_DESCRIPTOR HeaderDesc
+);
+
+BOOL
+DisplayVSFormatUncompressed (
+    PUSB_VIDEO_FORMAT_UNCOMPRESSED_DESCRIPTOR FormatDesc
+);
+
+BOOL
+DisplayVSFormatMjpeg (
+    PUSB_VIDEO_FORMAT_MJPEG_DESCRIPTOR FormatDesc
+);
+
+BOOL
+DisplayVSFrame (
+    PUSB_VIDEO_FRAME_DESCRIPTOR FrameDesc
+);
+
+BOOL
+DisplayVSColorFormat (
+    PUSB_VIDEO_COLORFORMAT_DESCRIPTOR ColorDesc
+);
+
+VOID
+DisplayVideoCommon (
+    PCTSTR          Title,
+    PUCHAR          Desc
+);
+
+VOID
+DisplayVideoBytes (
+    PCTSTR          Label,
+    PUCHAR          Data,
+    ULONG           Length
+);
+
+VOID
+DisplayVideoGuid (
+    PCTSTR          Label,
+    PUCHAR          Guid
+);
+
+VOID
+DisplayFrameInterval (
+    PCTSTR          Label,
+    PUCHAR          Data
+);
+
+PCTSTR
+VideoTermTypeCodeToName (
+    USHORT TermTypeCode
+);
+
+//*****************************************************************************
+// G L O B A L S
+//*****************************************************************************
+
+CLASS_DESC_DECODER VideoClassDecoders[] =
+{
+    //
+    // Video Control Interface
+    //
+    {USB_DEVICE_CLASS_VIDEO, USB_VIDEO_SUBCLASS_VIDEOCONTROL,
+     USB_VIDEO_CS_INTERFACE, USB_VIDEO_VC_HEADER,
+     (LPFNDISPLAYCLASSDESC)DisplayVCHeader},
+
+    {USB_DEVICE_CLASS_VIDEO, USB_VIDEO_SUBCLASS_VIDEOCONTROL,
+     USB_VIDEO_CS_INTERFACE, USB_VIDEO_VC_INPUT_TERMINAL,
+     (LPFNDISPLAYCLASSDESC)DisplayVCInputTerminal},
+
+    {USB_DEVICE_CLASS_VIDEO, USB_VIDEO_SUBCLASS_VIDEOCONTROL,
+     USB_VIDEO_CS_INTERFACE, USB_VIDEO_VC_OUTPUT_TERMINAL,
+     (LPFNDISPLAYCLASSDESC)DisplayVCOutputTerminal},
+
+    {USB_DEVICE_CLASS_VIDEO, USB_VIDEO_SUBCLASS_VIDEOCONTROL,
+     USB_VIDEO_CS_INTERFACE, USB_VIDEO_VC_SELECTOR_UNIT,
+     (LPFNDISPLAYCLASSDESC)DisplayVCSelectorUnit},
+
+    {USB_DEVICE_CLASS_VIDEO, USB_VIDEO_SUBCLASS_VIDEOCONTROL,
+     USB_VIDEO_CS_INTERFACE, USB_VIDEO_VC_PROCESSING_UNIT,
+     (LPFNDISPLAYCLASSDESC)DisplayVCProcessingUnit},
+
+    {USB_DEVICE_CLASS_VIDEO, USB_VIDEO_SUBCLASS_VIDEOCONTROL,
+     USB_VIDEO_CS_INTERFACE, USB_VIDEO_VC_EXTENSION_UNIT,
+     (LPFNDISPLAYCLASSDESC)DisplayVCExtensionUnit},
+
+    {USB_DEVICE_CLASS_VIDEO, USB_VIDEO_SUBCLASS_VIDEOCONTROL,
+     USB_VIDEO_CS_ENDPOINT, USB_VIDEO_EP_INTERRUPT,
+     (LPFNDISPLAYCLASSDESC)DisplayVCInterruptEndpoint},
+    //
+    // Video Streaming Interface
+    //
+    {USB_DEVICE_CLASS_VIDEO, USB_VIDEO_SUBCLASS_VIDEOSTREAMING,
+     USB_VIDEO_CS_INTERFACE, USB_VIDEO_VS_INPUT_HEADER,
+     (LPFNDISPLAYCLASSDESC)DisplayVSInputHeader},
+
+    {USB_DEVICE_CLASS_VIDEO, USB_VIDEO_SUBCLASS_VIDEOSTREAMING,
+     USB_VIDEO_CS_INTERFACE, USB_VIDEO_VS_FORMAT_UNCOMPRESSED,
+     (LPFNDISPLAYCLASSDESC)DisplayVSFormatUncompressed},
+
+    {USB_DEVICE_CLASS_VIDEO, USB_VIDEO_SUBCLASS_VIDEOSTREAMING,
+     USB_VIDEO_CS_INTERFACE, USB_VIDEO_VS_FRAME_UNCOMPRESSED,
+     (LPFNDISPLAYCLASSDESC)DisplayVSFrame},
+
+    {USB_DEVICE_CLASS_VIDEO, USB_VIDEO_SUBCLASS_VIDEOSTREAMING,
+     USB_VIDEO_CS_INTERFACE, USB_VIDEO_VS_FORMAT_MJPEG,
+     (LPFNDISPLAYCLASSDESC)DisplayVSFormatMjpeg},
+
+    {USB_DEVICE_CLASS_VIDEO, USB_VIDEO_SUBCLASS_VIDEOSTREAMING,
+     USB_VIDEO_CS_INTERFACE, USB_VIDEO_VS_FRAME_MJPEG,
+     (LPFNDISPLAYCLASSDESC)DisplayVSFrame},
+
+    {USB_DEVICE_CLASS_VIDEO, USB_VIDEO_SUBCLASS_VIDEOSTREAMING,
+     USB_VIDEO_CS_INTERFACE, USB_VIDEO_VS_COLORFORMAT,
+     (LPFNDISPLAYCLASSDESC)DisplayVSColorFormat},
+    //
+    // Terminate List
+    //
+    {0, 0, 0, 0, NULL}
+};
+
+
+//*****************************************************************************
+// L O C A L    F U N C T I O N S
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// DisplayVCHeader()
+//
+//*****************************************************************************
+
+BOOL
+DisplayVCHeader (
+    PUSB_VIDEO_VC_HEADER_DESCRIPTOR HeaderDesc
+)
+{
+    if (HeaderDesc->bLength < sizeof(USB_VIDEO_VC_HEADER_DESCRIPTOR) +
+                              HeaderDesc->bInCollection)
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    DisplayVideoCommon(_T("Video Control Interface Header Descriptor"),
+                       (PUCHAR)HeaderDesc);
+
+    AppendTextHex(_T("bcdUVC:             "),
+                  HeaderDesc->bcdUVC, 4);
+
+    AppendTextHex(_T("wTotalLength:       "),
+                  HeaderDesc->wTotalLength, 4);
+
+    AppendTextBuffer(_T("dwClockFrequency: 0x%08X (%d Hz)\r\n"),
+                     HeaderDesc->dwClockFrequency,
+                     HeaderDesc->dwClockFrequency);
+
+    AppendTextHex(_T("bInCollection:        "),
+                  HeaderDesc->bInCollection, 2);
+
+    DisplayVideoBytes(_T("baInterfaceNr:        "),
+                      (PUCHAR)(HeaderDesc + 1),
+                      HeaderDesc->bInCollection);
+
+    return TRUE;
+}
+
+
+//*****************************************************************************
+//
+// DisplayVCInputTerminal()
+//
+// Camera terminals have a few more fields.
+//
+//*****************************************************************************
+
+BOOL
+DisplayVCInputTerminal (
+    PUSB_VIDEO_INPUT_TERMINAL_DESCRIPTOR ITDesc
+)
+{
+    PUSB_VIDEO_CAMERA_TERMINAL_DESCRIPTOR cameraDesc;
+
+    if (ITDesc->bLength < sizeof(USB_VIDEO_INPUT_TERMINAL_DESCRIPTOR))
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    cameraDesc = NULL;
+
+    if (ITDesc->wTerminalType == USB_VIDEO_ITT_CAMERA)
+    {
+        cameraDesc = (PUSB_VIDEO_CAMERA_TERMINAL_DESCRIPTOR)ITDesc;
+
+        if (cameraDesc->bLength < sizeof(USB_VIDEO_CAMERA_TERMINAL_DESCRIPTOR) ||
+            cameraDesc->bLength < sizeof(USB_VIDEO_CAMERA_TERMINAL_DESCRIPTOR) +
+                                  cameraDesc->bControlSize)
+        {
+            OOPS();
+            return FALSE;
+        }
+    }
+
+    DisplayVideoCommon(cameraDesc ? _T("Video Control Camera Terminal Descriptor") :
+                                    _T("Video Control Input Terminal Descriptor"),
+                       (PUCHAR)ITDesc);
+
+    AppendTextHex(_T("bTerminalID:          "),
+                  ITDesc->bTerminalID, 2);
+
+    AppendTextHexName(_T("wTerminalType:      "),
+                      ITDesc->wTerminalType, 4,
+                      VideoTermTypeCodeToName(ITDesc->wTerminalType));
+
+    AppendTextHex(_T("bAssocTerminal:       "),
+                  ITDesc->bAssocTerminal, 2);
+
+    AppendTextHex(_T("iTerminal:            "),
+                  ITDesc->iTerminal, 2);
+
+    if (cameraDesc)
+    {
+        AppendTextHex(_T("wObjectiveFocalLengthMin: "),
+                      cameraDesc->wObjectiveFocalLengthMin, 4);
+
+        AppendTextHex(_T("wObjectiveFocalLengthMax: "),
+                      cameraDesc->wObjectiveFocalLengthMax, 4);
+
+        AppendTextHex(_T("wOcularFocalLength: "),
+                      cameraDesc->wOcularFocalLength, 4);
+
+        AppendTextHex(_T("bControlSize:         "),
+                      cameraDesc->bControlSize, 2);
+
+        DisplayVideoBytes(_T("bmControls:           "),
+                          (PUCHAR)(cameraDesc + 1),
+                          cameraDesc->bControlSize);
+    }
+
+    return TRUE;
+}
+
+
+//*****************************************************************************
+//
+// DisplayVCOutputTerminal()
+//
+//*****************************************************************************
+
+BOOL
+DisplayVCOutputTerminal (
+    PUSB_VIDEO_OUTPUT_TERMINAL_DESCRIPTOR OTDesc
+)
+{
+    if (OTDesc->bLength < sizeof(USB_VIDEO_OUTPUT_TERMINAL_DESCRIPTOR))
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    DisplayVideoCommon(_T("Video Control Output Terminal Descriptor"),
+                       (PUCHAR)OTDesc);
+
+    AppendTextHex(_T("bTerminalID:          "),
+                  OTDesc->bTerminalID, 2);
+
+    AppendTextHexName(_T("wTerminalType:      "),
+                      OTDesc->wTerminalType, 4,
+                      VideoTermTypeCodeToName(OTDesc->wTerminalType));
+
+    AppendTextHex(_T("bAssocTerminal:       "),
+                  OTDesc->bAssocTerminal, 2);
+
+    AppendTextHex(_T("bSourceID:            "),
+                  OTDesc->bSourceID, 2);
+
+    AppendTextHex(_T("iTerminal:            "),
+                  OTDesc->iTerminal, 2);
+
+    return TRUE;
+}
+
+
+//*****************************************************************************
+//
+// DisplayVCSelectorUnit()
+//
+//*****************************************************************************
+
+BOOL
+DisplayVCSelectorUnit (
+    PUSB_VIDEO_SELECTOR_UNIT_DESCRIPTOR SelectorDesc
+)
+{
+    PUCHAR sourceIDs;
+
+    // baSourceID[bNrInPins], iSelector
+    //
+    if (SelectorDesc->bLength < sizeof(USB_VIDEO_SELECTOR_UNIT_DESCRIPTOR) +
+                                SelectorDesc->bNrInPins + 1)
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    DisplayVideoCommon(_T("Video Control Selector Unit Descriptor"),
+                       (PUCHAR)SelectorDesc);
+
+    AppendTextHex(_T("bUnitID:              "),
+                  SelectorDesc->bUnitID, 2);
+
+    AppendTextHex(_T("bNrInPins:            "),
+                  SelectorDesc->bNrInPins, 2);
+
+    sourceIDs = (PUCHAR)(SelectorDesc + 1);
+
+    DisplayVideoBytes(_T("baSourceID:           "),
+                      sourceIDs,
+                      SelectorDesc->bNrInPins);
+
+    AppendTextHex(_T("iSelector:            "),
+                  sourceIDs[SelectorDesc->bNrInPins], 2);
+
+    return TRUE;
+}
+
+
+//*****************************************************************************
+//
+// DisplayVCProcessingUnit()
+//
+//*****************************************************************************
+
+BOOL
+DisplayVCProcessingUnit (
+    PUSB_VIDEO_PROCESSING_UNIT_DESCRIPTOR ProcessingDesc
+)
+{
+    PUCHAR controls;
+    ULONG  length;
+
+    // bmControls[bControlSize], iProcessing, and bmVideoStandards since
+    // UVC 1.1
+    //
+    length = sizeof(USB_VIDEO_PROCESSING_UNIT_DESCRIPTOR) +
+             ProcessingDesc->bControlSize + 1;
+
+    if (ProcessingDesc->bLength < length)
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    DisplayVideoCommon(_T("Video Control Processing Unit Descriptor"),
+                       (PUCHAR)ProcessingDesc);
+
+    AppendTextHex(_T("bUnitID:              "),
+                  ProcessingDesc->bUnitID, 2);
+
+    AppendTextHex(_T("bSourceID:            "),
+                  ProcessingDesc->bSourceID, 2);
+
+    AppendTextHex(_T("wMaxMultiplier:     "),
+                  ProcessingDesc->wMaxMultiplier, 4);
+
+    AppendTextHex(_T("bControlSize:         "),
+                  ProcessingDesc->bControlSize, 2);
+
+    controls = (PUCHAR)(ProcessingDesc + 1);
+
+    DisplayVideoBytes(_T("bmControls:           "),
+                      controls,
+                      ProcessingDesc->bControlSize);
+
+    AppendTextHex(_T("iProcessing:          "),
+                  controls[ProcessingDesc->bControlSize], 2);
+
+    if (ProcessingDesc->bLength > length)
+    {
+        AppendTextHex(_T("bmVideoStandards:     "),
+                      controls[ProcessingDesc->bControlSize + 1], 2);
+    }
+
+    return TRUE;
+}
+
+
+//*****************************************************************************
+//
+// DisplayVCExtensionUnit()
+//
+//*****************************************************************************
+
+BOOL
+DisplayVCExtensionUnit (
+    PUSB_VIDEO_EXTENSION_UNIT_DESCRIPTOR ExtensionDesc
+)
+{
+    PUCHAR data;
+    UCHAR  controlSize;
+
+    // baSourceID[bNrInPins], bControlSize, bmControls[bControlSize],
+    // iExtension
+    //
+    data = (PUCHAR)(ExtensionDesc + 1);
+
+    if (ExtensionDesc->bLength < sizeof(USB_VIDEO_EXTENSION_UNIT_DESCRIPTOR) +
+                                 ExtensionDesc->bNrInPins + 2)
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    controlSize = data[ExtensionDesc->bNrInPins];
+
+    if (ExtensionDesc->bLength < sizeof(USB_VIDEO_EXTENSION_UNIT_DESCRIPTOR) +
+                                 ExtensionDesc->bNrInPins + 2 + controlSize)
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    DisplayVideoCommon(_T("Video Control Extension Unit Descriptor"),
+                       (PUCHAR)ExtensionDesc);
+
+    AppendTextHex(_T("bUnitID:              "),
+                  ExtensionDesc->bUnitID, 2);
+
+    DisplayVideoGuid(_T("guidExtensionCode:    "),
+                     ExtensionDesc->guidExtensionCode);
+
+    AppendTextHex(_T("bNumControls:         "),
+                  ExtensionDesc->bNumControls, 2);
+
+    AppendTextHex(_T("bNrInPins:            "),
+                  ExtensionDesc->bNrInPins, 2);
+
+    DisplayVideoBytes(_T("baSourceID:           "),
+                      data,
+                      ExtensionDesc->bNrInPins);
+
+    data += ExtensionDesc->bNrInPins;
+
+    AppendTextHex(_T("bControlSize:         "),
+                  controlSize, 2);
+
+    DisplayVideoBytes(_T("bmControls:           "),
+                      data + 1,
+                      controlSize);
+
+    AppendTextHex(_T("iExtension:           "),
+                  data[1 + controlSize], 2);
+
+    return TRUE;
+}
+
+
+//*****************************************************************************
+//
+// DisplayVCInterruptEndpoint()
+//
+//*****************************************************************************
+
+BOOL
+DisplayVCInterruptEndpoint (
+    PUSB_VIDEO_INTERRUPT_ENDPOINT_DESCRIPTOR EndpointDesc
+)
+{
+    if (EndpointDesc->bLength < sizeof(USB_VIDEO_INTERRUPT_ENDPOINT_DESCRIPTOR))
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    DisplayVideoCommon(_T("Video Control Interrupt Endpoint Descriptor"),
+                       (PUCHAR)EndpointDesc);
+
+    AppendTextBuffer(_T("wMaxTransferSize:   0x%04X (%d)\r\n"),
+                     EndpointDesc->wMaxTransferSize,
+                     EndpointDesc->wMaxTransferSize);
+
+    return TRUE;
+}
+
+
+//*****************************************************************************
+//
+// DisplayVSInputHeader()
+//
+//*****************************************************************************
+
+BOOL
+DisplayVSInputHeader (
+    PUSB_VIDEO_VS_INPUT_HEADER_DESCRIPTOR HeaderDesc
+)
+{
+    PUCHAR controls;
+    UCHAR  i;
+
+    // bmaControls[bNumFormats][bControlSize]
+    //
+    if (HeaderDesc->bLength < sizeof(USB_VIDEO_VS_INPUT_HEADER_DESCRIPTOR) +
+                              HeaderDesc->bNumFormats * HeaderDesc->bControlSize)
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    DisplayVideoCommon(_T("Video Streaming Input Header Descriptor"),
+                       (PUCHAR)HeaderDesc);
+
+    AppendTextHex(_T("bNumFormats:          "),
+                  HeaderDesc->bNumFormats, 2);
+
+    AppendTextHex(_T("wTotalLength:       "),
+                  HeaderDesc->wTotalLength, 4);
+
+    AppendTextHex(_T("bEndpointAddress:     "),
+                  HeaderDesc->bEndpointAddress, 2);
+
+    AppendTextHex(_T("bmInfo:               "),
+                  HeaderDesc->bmInfo, 2);
+
+    AppendTextHex(_T("bTerminalLink:        "),
+                  HeaderDesc->bTerminalLink, 2);
+
+    AppendTextHex(_T("bStillCaptureMethod:  "),
+                  HeaderDesc->bStillCaptureMethod, 2);
+
+    AppendTextHex(_T("bTriggerSupport:      "),
+                  HeaderDesc->bTriggerSupport, 2);
+
+    AppendTextHex(_T("bTriggerUsage:        "),
+                  HeaderDesc->bTriggerUsage, 2);
+
+    AppendTextHex(_T("bControlSize:         "),
+                  HeaderDesc->bControlSize, 2);
+
+    controls = (PUCHAR)(HeaderDesc + 1);
+
+    for (i = 0; i < HeaderDesc->bNumFormats; i++)
+    {
+        AppendTextBuffer(_T("bmaControls[%d]:       "),
+                         i + 1);
+
+        DisplayVideoBytes(_T(""),
+                          controls,
+                          HeaderDesc->bControlSize);
+
+        controls += HeaderDesc->bControlSize;
+    }
+
+    return TRUE;
+}
+
+
+//*****************************************************************************
+//
+// DisplayVSFormatUncompressed()
+//
+//*****************************************************************************
+
+BOOL
+DisplayVSFormatUncompressed (
+    PUSB_VIDEO_FORMAT_UNCOMPRESSED_DESCRIPTOR FormatDesc
+)
+{
+    if (FormatDesc->bLength < sizeof(USB_VIDEO_FORMAT_UNCOMPRESSED_DESCRIPTOR))
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    DisplayVideoCommon(_T("Video Streaming Uncompressed Format Descriptor"),
+                       (PUCHAR)FormatDesc);
+
+    AppendTextHex(_T("bFormatIndex:         "),
+                  FormatDesc->bFormatIndex, 2);
+
+    AppendTextHex(_T("bNumFrameDescriptors: "),
+                  FormatDesc->bNumFrameDescriptors, 2);
+
+    DisplayVideoGuid(_T("guidFormat:           "),
+                     FormatDesc->guidFormat);
+
+    AppendTextBuffer(_T("bBitsPerPixel:        0x%02X (%d bits)\r\n"),
+                     FormatDesc->bBitsPerPixel,
+                     FormatDesc->bBitsPerPixel);
+
+    AppendTextHex(_T("bDefaultFrameIndex:   "),
+                  FormatDesc->bDefaultFrameIndex, 2);
+
+    AppendTextHex(_T("bAspectRatioX:        "),
+                  FormatDesc->bAspectRatioX, 2);
+
+    AppendTextHex(_T("bAspectRatioY:        "),
+                  FormatDesc->bAspectRatioY, 2);
+
+    AppendTextHex(_T("bmInterlaceFlags:     "),
+                  FormatDesc->bmInterlaceFlags, 2);
+
+    AppendTextHex(_T("bCopyProtect:         "),
+                  FormatDesc->bCopyProtect, 2);
+
+    return TRUE;
+}
+
+
+//*****************************************************************************
+//
+// DisplayVSFormatMjpeg()
+//
+//*****************************************************************************
+
+BOOL
+DisplayVSFormatMjpeg (
+    PUSB_VIDEO_FORMAT_MJPEG_DESCRIPTOR FormatDesc
+)
+{
+    if (FormatDesc->bLength < sizeof(USB_VIDEO_FORMAT_MJPEG_DESCRIPTOR))
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    DisplayVideoCommon(_T("Video Streaming MJPEG Format Descriptor"),
+                       (PUCHAR)FormatDesc);
+
+    AppendTextHex(_T("bFormatIndex:         "),
+                  FormatDesc->bFormatIndex, 2);
+
+    AppendTextHex(_T("bNumFrameDescriptors: "),
+                  FormatDesc->bNumFrameDescriptors, 2);
+
+    AppendTextHex(_T("bmFlags:              "),
+                  FormatDesc->bmFlags, 2);
+
+    AppendTextHex(_T("bDefaultFrameIndex:   "),
+                  FormatDesc->bDefaultFrameIndex, 2);
+
+    AppendTextHex(_T("bAspectRatioX:        "),
+                  FormatDesc->bAspectRatioX, 2);
+
+    AppendTextHex(_T("bAspectRatioY:        "),
+                  FormatDesc->bAspectRatioY, 2);
+
+    AppendTextHex(_T("bmInterlaceFlags:     "),
+                  FormatDesc->bmInterlaceFlags, 2);
+
+    AppendTextHex(_T("bCopyProtect:         "),
+                  FormatDesc->bCopyProtect, 2);
+
+    return TRUE;
+}
+
+
+//*****************************************************************************
+//
+// DisplayVSFrame()
+//
+// Uncompressed and MJPEG frames are laid out the same.
+//
+//*****************************************************************************
+
+BOOL
+DisplayVSFrame (
+    PUSB_VIDEO_FRAME_DESCRIPTOR FrameDesc
+)
+{
+    PUCHAR data;
+    ULONG  numIntervals;
+    ULONG  i;
+    TCHAR  label[32];
+
+    // Three intervals, min, max and step, if continuous
+    //
+    numIntervals = FrameDesc->bFrameIntervalType ? FrameDesc->bFrameIntervalType : 3;
+
+    if (FrameDesc->bLength < sizeof(USB_VIDEO_FRAME_DESCRIPTOR) +
+                             numIntervals * sizeof(ULONG))
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    DisplayVideoCommon(FrameDesc->bDescriptorSubtype == USB_VIDEO_VS_FRAME_MJPEG ?
+                       _T("Video Streaming MJPEG Frame Descriptor") :
+                       _T("Video Streaming Uncompressed Frame Descriptor"),
+                       (PUCHAR)FrameDesc);
+
+    AppendTextHex(_T("bFrameIndex:          "),
+                  FrameDesc->bFrameIndex, 2);
+
+    AppendTextHex(_T("bmCapabilities:       "),
+                  FrameDesc->bmCapabilities, 2);
+
+    AppendTextBuffer(_T("wWidth:             0x%04X (%d)\r\n"),
+                     FrameDesc->wWidth,
+                     FrameDesc->wWidth);
+
+    AppendTextBuffer(_T("wHeight:            0x%04X (%d)\r\n"),
+                     FrameDesc->wHeight,
+                     FrameDesc->wHeight);
+
+    AppendTextBuffer(_T("dwMinBitRate:     0x%08X (%u bps)\r\n"),
+                     FrameDesc->dwMinBitRate,
+                     FrameDesc->dwMinBitRate);
+
+    AppendTextBuffer(_T("dwMaxBitRate:     0x%08X (%u bps)\r\n"),
+                     FrameDesc->dwMaxBitRate,
+                     FrameDesc->dwMaxBitRate);
+
+    AppendTextBuffer(_T("dwMaxVideoFrameBufferSize: 0x%08X (%u bytes)\r\n"),
+                     FrameDesc->dwMaxVideoFrameBufferSize,
+                     FrameDesc->dwMaxVideoFrameBufferSize);
+
+    DisplayFrameInterval(_T("dwDefaultFrameInterval:"),
+                         (PUCHAR)&FrameDesc->dwDefaultFrameInterval);
+
+    AppendTextHex(_T("bFrameIntervalType:   "),
+                  FrameDesc->bFrameIntervalType, 2);
+
+    data = (PUCHAR)(FrameDesc + 1);
+
+    if (FrameDesc->bFrameIntervalType == 0)
+    {
+        DisplayFrameInterval(_T("dwMinFrameInterval:"), data);
+        DisplayFrameInterval(_T("dwMaxFrameInterval:"), data + 4);
+        DisplayFrameInterval(_T("dwFrameIntervalStep:"), data + 8);
+    }
+    else
+    {
+        for (i = 0; i < numIntervals; i++)
+        {
+            wsprintf(label, _T("dwFrameInterval[%d]:"), i + 1);
+
+            DisplayFrameInterval(label, data + i * 4);
+        }
+    }
+
+    return TRUE;
+}
+
+
+//*****************************************************************************
+//
+// DisplayVSColorFormat()
+//
+//*****************************************************************************
+
+BOOL
+DisplayVSColorFormat (
+    PUSB_VIDEO_COLORFORMAT_DESCRIPTOR ColorDesc
+)
+{
+    if (ColorDesc->bLength < sizeof(USB_VIDEO_COLORFORMAT_DESCRIPTOR))
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    DisplayVideoCommon(_T("Video Streaming Color Matching Descriptor"),
+                       (PUCHAR)ColorDesc);
+
+    AppendTextHex(_T("bColorPrimaries:      "),
+                  ColorDesc->bColorPrimaries, 2);
+
+    AppendTextHex(_T("bTransferCharacteristics: "),
+                  ColorDesc->bTransferCharacteristics, 2);
+
+    AppendTextHex(_T("bMatrixCoefficients:  "),
+                  ColorDesc->bMatrixCoefficients, 2);
+
+    return TRUE;
+}
+
+
+//*****************************************************************************
+//
+// DisplayVideoCommon()
+//
+// The title and the fields all Video Class Descriptors start with.
+//
+//*****************************************************************************
+
+VOID
+DisplayVideoCommon (
+    PCTSTR  Title,
+    PUCHAR  Desc
+)
+{
+    AppendTextBuffer(_T("\r\n%s:\r\n"),
+                     Title);
+
+    AppendTextHex(_T("bLength:              "),
+                  Desc[0], 2);
+
+    AppendTextHex(_T("bDescriptorType:      "),
+                  Desc[1], 2);
+
+    AppendTextHex(_T("bDescriptorSubtype:   "),
+                  Desc[2], 2);
+}
+
+
+//*****************************************************************************
+//
+// DisplayVideoBytes()
+//
+// Shows Length bytes on one line, as they are in the descriptor.
+//
+//*****************************************************************************
+
+VOID
+DisplayVideoBytes (
+    PCTSTR  Label,
+    PUCHAR  Data,
+    ULONG   Length
+)
+{
+    ULONG i;
+
+    AppendTextString(Label);
+
+    for (i = 0; i < Length; i++)
+    {
+        AppendTextBuffer(_T("%02X "),
+                         Data[i]);
+    }
+
+    AppendTextString(_T("\r\n"));
+}
+
+
+//*****************************************************************************
+//
+// DisplayVideoGuid()
+//
+// Guid - 16 bytes in the order they are sent, which for a GUID is little
+// endian in its first three fields.  Video formats are also named by the
+// FOURCC in the first field.
+//
+//*****************************************************************************
+
+VOID
+DisplayVideoGuid (
+    PCTSTR  Label,
+    PUCHAR  Guid
+)
+{
+    UCHAR i;
+
+    AppendTextBuffer(_T("%s{%02X%02X%02X%02X-%02X%02X-%02X%02X-%02X%02X-%02X%02X%02X%02X%02X%02X}"),
+                     Label,
+                     Guid[3], Guid[2], Guid[1], Guid[0],
+                     Guid[5], Guid[4],
+                     Guid[7], Guid[6],
+                     Guid[8], Guid[9],
+                     Guid[10], Guid[11], Guid[12], Guid[13], Guid[14], Guid[15]);
+
+    for (i = 0; i < 4; i++)
+    {
+        if (Guid[i] < 0x20 || Guid[i] > 0x7E)
+        {
+            break;
+        }
+    }
+
+    if (i == 4)
+    {
+        AppendTextBuffer(_T(" (%c%c%c%c)"),
+                         Guid[0], Guid[1], Guid[2], Guid[3]);
+    }
+
+    AppendTextString(_T("\r\n"));
+}
+
+
+//*****************************************************************************
+//
+// DisplayFrameInterval()
+//
+// Data - An interval in 100 ns units, not necessarily aligned.
+//
+//*****************************************************************************
+
+VOID
+DisplayFrameInterval (
+    PCTSTR  Label,
+    PUCHAR  Data
+)
+{
+    ULONG interval;
+    ULONG centiFps;
+
+    interval = (Data[0]) + (Data[1] << 8) + (Data[2] << 16) + ((ULONG)Data[3] << 24);
+
+    if (interval == 0)
+    {
+        AppendTextBuffer(_T("%s 0x%08X\r\n"),
+                         Label,
+                         interval);
+        return;
+    }
+
+    centiFps = (ULONG)(1000000000 / interval);
+
+    AppendTextBuffer(_T("%s 0x%08X (%u.%02u fps)\r\n"),
+                     Label,
+                     interval,
+                     centiFps / 100,
+                     centiFps % 100);
+}
+
+
+//*****************************************************************************
+//
+// VideoTermTypeCodeToName()
+//
+//*****************************************************************************
+
+PCTSTR
+VideoTermTypeCodeToName (
+    USHORT TermTypeCode
+)
+{
+    PVIDEOTERMTYPE termType;
+
+    for (termType=VideoTermTypes; termType->TermTypeName; termType++)
+    {
+        if (termType->TermTypeCode == TermTypeCode)
+        {
+            break;
+        }
+    }
+
+    return termType->TermTypeName;
+}
@@ -9,7 +9,7 @@ Module Name:
 Abstract:
 
     This source file contains the routines which enumerate the USB bus
-    and populate the TreeView control.
+    and build the device tree that is used to populate the TreeView control.
 
     The enumeration process goes like this:
 
@@ -77,17 +77,139 @@ Revision History:
 
 #define NUM_HCS_TO_CHECK 10
 
+// Size of the buffers the single round trip queries are sent in.  This is
+// enough for the names hubs and host controllers report and for the
+// Configuration Descriptors of all but the biggest composite devices.
+// Whatever does not fit is requested a second time with the right size.
+//
+#define QUERY_BUFFER_SIZE 1024
+
+// Number of entries in the Configuration Descriptor length cache, a power
+// of 2.
+//
+#define CONFIG_LENGTH_CACHE_SIZE 256
+
+// Whether the Configuration and String Descriptors of the device on a
+// connection are left for GetLazyDescriptors() or RequestLazyDescriptors()
+// instead of being fetched during enumeration
+//
+#define LAZY_DESCRIPTORS(Context, ConnectionInfo)               \
+    ((Context)->DoConfigDesc && (Context)->DoLazyDesc &&        \
+     (ConnectionInfo)->ConnectionStatus == DeviceConnected)
+
+// Whether the Configuration Descriptor is fetched during enumeration
+//
+#define EAGER_CONFIG_DESC(Context)                              \
+    ((Context)->DoConfigDesc && !(Context)->DoLazyDesc)
+
+#define CONFIG_LENGTH_SLOT(DeviceDesc)                          \
+    ((((DeviceDesc)->idVendor * 31 + (DeviceDesc)->idProduct)   \
+      * 31 + (DeviceDesc)->bcdDevice) & (CONFIG_LENGTH_CACHE_SIZE - 1))
+
 //*****************************************************************************
-// G L O B A L S
+// T Y P E D E F S
 //*****************************************************************************
 
-// List of enumerated host controllers.
+// Everything needed to enumerate one hub as a work pool item.  The tree
+// node has already been added to its parent, so that the finished tree has
+// the same order no matter when the work item runs.
 //
-LIST_ENTRY EnumeratedHCListHead =
+typedef struct _HUB_ENUM_TASK
 {
-    &EnumeratedHCListHead,
-    &EnumeratedHCListHead
-};
+    PENUM_CONTEXT                       Context;
+    PUSBTREENODE                        Node;
+    PTSTR                               HubName;
+    PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfo;
+    PUSB_DESCRIPTOR_REQUEST             ConfigDesc;
+    PSTRING_DESCRIPTORS                 StringDescs;
+    PUSB_DEVICE_QUALIFIER_DESCRIPTOR    QualifierDesc;
+    BOOL                                HasDeviceDesc;
+    TCHAR                               DeviceDesc[0];
+} HUB_ENUM_TASK, *PHUB_ENUM_TASK;
+
+// Configuration Descriptor wTotalLength last seen for a device model, so
+// the next time the descriptor can be requested with the right size.
+//
+typedef struct _CONFIG_LENGTH_ENTRY
+{
+    USHORT  idVendor;
+    USHORT  idProduct;
+    USHORT  bcdDevice;
+    USHORT  wTotalLength;   // 0 if the entry is unused
+} CONFIG_LENGTH_ENTRY, *PCONFIG_LENGTH_ENTRY;
+
+// Steps of the overlapped requests for one hub port.  The PortQueryGetXxx
+// steps decide which request to send next, each other step waits for the
+// request it is named after.
+//
+typedef enum _PORT_QUERY_STEP
+{
+    PortQueryStart,
+    PortQueryConnectionInfoEx,
+    PortQueryConnectionInfo,
+    PortQueryGetDriverKey,
+    PortQueryDriverKeyFirst,
+    PortQueryDriverKey,
+    PortQueryGetConfigDesc,
+    PortQueryConfigDescFirst,
+    PortQueryConfigDesc,
+    PortQueryGetStrings,
+    PortQueryLanguageIDs,
+    PortQueryGetNextString,
+    PortQueryString,
+    PortQueryGetQualifier,
+    PortQueryQualifier,
+    PortQueryGetHubName,
+    PortQueryHubNameFirst,
+    PortQueryHubName,
+    PortQueryDone
+} PORT_QUERY_STEP;
+
+// State of one hub port enumerated by EnumerateHubPortsOverlapped()
+//
+typedef struct _PORT_QUERY
+{
+    OVERLAPPED                          Overlapped;
+    PENUM_CONTEXT                       Context;
+    PORT_QUERY_STEP                     Step;
+    ULONG                               ConnectionIndex;
+    BOOL                                Pending;
+    DWORD                               BytesReturned;
+    PVOID                               Buffer;         // allocated request
+    ULONG                               BufferSize;
+
+    PUSBTREENODE                        Node;
+    PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfo;
+    PTSTR                               DriverKeyName;
+    PUSB_DESCRIPTOR_REQUEST             ConfigDesc;
+    PSTRING_DESCRIPTORS                 StringDescs;
+    PUSB_DEVICE_QUALIFIER_DESCRIPTOR    QualifierDesc;
+    PTSTR                               ExtHubName;
+    BOOL                                Cached;         // from the descriptor cache
+
+    PUCHAR                              StringIndexes;
+    ULONG                               NumStrings;     // indexes * languages
+    ULONG                               NextString;
+    ULONG                               NumLanguageIDs;
+    USHORT                              LanguageIDs[MAXIMUM_USB_STRING_LENGTH / 2];
+
+    // Requests that fit are sent from here.  The array of queries is
+    // reused for all ports of a hub, so this is allocated once per batch.
+    //
+    union
+    {
+        USB_NODE_CONNECTION_DRIVERKEY_NAME  DriverKeyNameRequest;
+        USB_NODE_CONNECTION_NAME            HubNameRequest;
+        UCHAR                               DescriptorRequest[sizeof(USB_DESCRIPTOR_REQUEST) +
+                                                              MAXIMUM_USB_STRING_LENGTH];
+        UCHAR                               QueryBuffer[QUERY_BUFFER_SIZE];
+    } Scratch;
+} PORT_QUERY, *PPORT_QUERY;
+
+//*****************************************************************************
+// G L O B A L S
+//*****************************************************************************
+
 
 //*****************************************************************************
 // L O C A L    F U N C T I O N    P R O T O T Y P E S
@@ -95,19 +217,112 @@ LIST_ENTRY EnumeratedHCListHead =
 
 BOOL
 EnumerateHub (
-    HTREEITEM                           hTreeParent,
+    PENUM_CONTEXT                       Context,
+    PUSBTREENODE                        Node,
     __in PTSTR                        HubName,
     PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfo,
     __in_opt PUSB_DESCRIPTOR_REQUEST ConfigDesc,
-    __in_opt PSTRING_DESCRIPTOR_NODE StringDescs,
+    __in_opt PSTRING_DESCRIPTORS StringDescs,
+    __in_opt PUSB_DEVICE_QUALIFIER_DESCRIPTOR QualifierDesc,
     __in_opt PCTSTR                       DeviceDesc
 );
 
+BOOL
+QueueHubEnumeration (
+    PENUM_CONTEXT                       Context,
+    PUSBTREENODE                        Node,
+    __in PTSTR                          HubName,
+    PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfo,
+    __in_opt PUSB_DESCRIPTOR_REQUEST    ConfigDesc,
+    __in_opt PSTRING_DESCRIPTORS        StringDescs,
+    __in_opt PUSB_DEVICE_QUALIFIER_DESCRIPTOR QualifierDesc,
+    __in_opt PCTSTR                     DeviceDesc
+);
+
+VOID
+EnumerateHubTask (
+    PVOID   Parameter
+);
+
 VOID
 EnumerateHubPorts (
-    HTREEITEM   hTreeParent,
+    PENUM_CONTEXT   Context,
+    PUSBTREENODE    Parent,
+    HANDLE          hHubDevice,
+    ULONG           NumPorts
+);
+
+BOOL
+EnumerateHubPortsOverlapped (
+    PENUM_CONTEXT   Context,
+    PUSBTREENODE    Parent,
+    PCTSTR          HubDeviceName,
+    ULONG           NumPorts
+);
+
+VOID
+InitPortQuery (
+    PENUM_CONTEXT   Context,
+    PPORT_QUERY     Query,
+    ULONG           ConnectionIndex
+);
+
+VOID
+RunPortQuery (
     HANDLE      hHubDevice,
-    ULONG       NumPorts
+    PPORT_QUERY Query,
+    BOOL        Success
+);
+
+VOID
+FinishPortQuery (
+    PPORT_QUERY Query
+);
+
+VOID
+AddHubPort (
+    PENUM_CONTEXT                       Context,
+    PUSBTREENODE                        Node,
+    PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfoEx,
+    __in_opt PTSTR                      DriverKeyName,
+    __in_opt PUSB_DESCRIPTOR_REQUEST    ConfigDesc,
+    __in_opt PSTRING_DESCRIPTORS        StringDescs,
+    __in_opt PUSB_DEVICE_QUALIFIER_DESCRIPTOR QualifierDesc,
+    __in_opt PTSTR                      ExtHubName
+);
+
+VOID
+ConnectionInfoToEx (
+    PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfoEx,
+    PUSB_NODE_CONNECTION_INFORMATION    ConnectionInfo
+);
+
+PTSTR
+GetParentHubName (
+    PUSBTREENODE    Node
+);
+
+PTSTR
+GetHubNodeName (
+    PUSBTREENODE    HubNode
+);
+
+PUSBTREENODE
+AddPortTreeNode (
+    PUSBTREENODE    Parent,
+    ULONG           ConnectionIndex
+);
+
+BOOL
+SetTreeNode (
+    PUSBTREENODE    Node,
+    PVOID           Info,
+    __in_opt PCTSTR Text,
+    TREEICON        Icon
+);
+
+PTSTR WideStrToMultiStr (
+    __in LPCWSTR WideStr
 );
 
 PTSTR GetRootHubName (
@@ -130,41 +345,148 @@ PTSTR GetDriverKeyName (
 
 PUSB_DESCRIPTOR_REQUEST
 GetConfigDescriptor (
-    HANDLE  hHubDevice,
-    ULONG   ConnectionIndex,
-    UCHAR   DescriptorIndex
+    HANDLE                  hHubDevice,
+    ULONG                   ConnectionIndex,
+    UCHAR                   DescriptorIndex,
+    PUSB_DEVICE_DESCRIPTOR  DeviceDesc
+);
+
+USHORT
+CheckConfigDescriptor (
+    PUSB_DESCRIPTOR_REQUEST ConfigDescReq,
+    ULONG                   RequestSize,
+    ULONG                   BytesReturned,
+    PBOOL                   Complete
+);
+
+USHORT
+GetCachedConfigLength (
+    PUSB_DEVICE_DESCRIPTOR  DeviceDesc
+);
+
+VOID
+CacheConfigLength (
+    PUSB_DEVICE_DESCRIPTOR  DeviceDesc,
+    USHORT                  TotalLength
+);
+
+PVOID
+AllocQueryBuffer (
+    VOID
+);
+
+VOID
+FreeQueryBuffer (
+    PVOID   Buffer
+);
+
+VOID
+FreeQueryBufferPool (
+    VOID
 );
 
 BOOL
 AreThereStringDescriptors (
     PUSB_DEVICE_DESCRIPTOR          DeviceDesc,
-    PUSB_CONFIGURATION_DESCRIPTOR   ConfigDesc
+    PUSB_DESCRIPTOR_REQUEST         ConfigDesc
 );
 
-PSTRING_DESCRIPTOR_NODE
+PSTRING_DESCRIPTORS
 GetAllStringDescriptors (
+    PENUM_CONTEXT                   Context,
     HANDLE                          hHubDevice,
     ULONG                           ConnectionIndex,
     PUSB_DEVICE_DESCRIPTOR          DeviceDesc,
-    PUSB_CONFIGURATION_DESCRIPTOR   ConfigDesc
+    PUSB_DESCRIPTOR_REQUEST         ConfigDesc
 );
 
-PSTRING_DESCRIPTOR_NODE
+BOOL
 GetStringDescriptor (
     HANDLE  hHubDevice,
     ULONG   ConnectionIndex,
     UCHAR   DescriptorIndex,
-    USHORT  LanguageID
+    USHORT  LanguageID,
+    PSTRING_DESCRIPTORS *StringDescs
 );
 
-PSTRING_DESCRIPTOR_NODE
+VOID
 GetStringDescriptors (
     HANDLE  hHubDevice,
     ULONG   ConnectionIndex,
     UCHAR   DescriptorIndex,
     ULONG   NumLanguageIDs,
     USHORT  *LanguageIDs,
-    PSTRING_DESCRIPTOR_NODE StringDescNodeTail
+    PSTRING_DESCRIPTORS *StringDescs
+);
+
+ULONG
+GetStringDescriptorIndexes (
+    PUSB_DEVICE_DESCRIPTOR          DeviceDesc,
+    PUSB_DESCRIPTOR_REQUEST         ConfigDesc,
+    __out_opt PUCHAR                Indexes,
+    __out_opt PULONG                NumDuplicates
+);
+
+VOID
+AddStringDescriptorIndex (
+    UCHAR   Index,
+    PUCHAR  Seen,
+    PUCHAR  Indexes,
+    PULONG  NumIndexes,
+    PULONG  NumDuplicates
+);
+
+ULONG
+SelectStringLanguages (
+    PENUM_CONTEXT   Context,
+    USHORT          *LanguageIDs,
+    ULONG           NumLanguageIDs,
+    USHORT          *Selected
+);
+
+VOID
+CountStringRequests (
+    PSTRING_DESCRIPTORS     StringDescs,
+    ULONG                   NumIndexes,
+    ULONG                   NumDuplicates,
+    ULONG                   NumLanguageIDs,
+    ULONG                   NumSelected
+);
+
+PUSB_DEVICE_QUALIFIER_DESCRIPTOR
+CopyQualifierDescriptor (
+    PUSB_DESCRIPTOR_REQUEST QualifierDescReq,
+    ULONG                   BytesReturned
+);
+
+BOOL
+GetLazyDescriptorFields (
+    PVOID                                   Info,
+    PUSB_NODE_CONNECTION_INFORMATION_EX     *ConnectionInfo,
+    PUSB_DESCRIPTOR_REQUEST                 **ConfigDesc,
+    PSTRING_DESCRIPTORS                     **StringDescs,
+    PTSTR                                   *HubName,
+    PBOOL                                   *Lazy,
+    PULONG                                  *LazyRequest
+);
+
+VOID
+InitDescriptorRequest (
+    PVOID   Request,
+    ULONG   RequestSize,
+    ULONG   ConnectionIndex,
+    UCHAR   DescriptorType,
+    UCHAR   DescriptorIndex,
+    USHORT  LanguageID
+);
+
+BOOL
+AddRequestedStringDescriptor (
+    PSTRING_DESCRIPTORS     *StringDescs,
+    PUSB_DESCRIPTOR_REQUEST StringDescReq,
+    ULONG                   BytesReturned,
+    UCHAR                   DescriptorIndex,
+    USHORT                  LanguageID
 );
 
 //*****************************************************************************
@@ -181,33 +503,46 @@ PCTSTR ConnectionStatuses[] =
     _T("DeviceNotEnoughPower")
 };
 
-ULONG TotalDevicesConnected;
+// Protects the query buffer pool and the Configuration Descriptor length
+// cache, which are shared by all enumeration threads and by enumerations
+// running at the same time.  The pool holds idle buffers only, until the
+// next FreeQueryBufferPool(), the cache lasts for the whole session.
+//
+CRITICAL_SECTION    QueryLock;
+volatile LONG       QueryLockState;
+PVOID               QueryBufferPool;
+
+CONFIG_LENGTH_ENTRY ConfigLengthCache[CONFIG_LENGTH_CACHE_SIZE];
+
+// Number of the last RequestLazyDescriptors(), only used by the UI thread
+//
+ULONG               LazyRequests;
 
 
 //*****************************************************************************
 //
 // EnumerateHostController()
 //
-// hTreeParent - Handle of the TreeView item under which host controllers
-// should be added.
+// Context - Enumeration the host controller is part of.
+//
+// Parent - Tree node under which host controllers should be added.
 //
 //*****************************************************************************
 
 VOID
 EnumerateHostController (
-    HTREEITEM  hTreeParent,
+    PENUM_CONTEXT Context,
+    PUSBTREENODE Parent,
     HANDLE     hHCDev,
     __in PTSTR leafName
 )
 {
     PTSTR       driverKeyName;
-    PTSTR       deviceDesc;
-    PTSTR       deviceId;
-    HTREEITEM   hHCItem;
+    DEVNODE_STRINGS devNodeStrings;
+    PUSBTREENODE hcNode;
     PTSTR       rootHubName;
-    PLIST_ENTRY listEntry;
+    PUSBTREENODE hcNodeInTree;
     PUSBHOSTCONTROLLERINFO hcInfo;
-    PUSBHOSTCONTROLLERINFO hcInfoInList;
 
     // ṹռ䱣Ϣ
     hcInfo = (PUSBHOSTCONTROLLERINFO)ALLOC(sizeof(USBHOSTCONTROLLERINFO));
@@ -222,34 +557,32 @@ EnumerateHostController (
         if (driverKeyName)
         {
             // 豸Ѿöбö
-            listEntry = EnumeratedHCListHead.Flink;
-
-            while (listEntry != &EnumeratedHCListHead)
+            // Host controllers are added to Parent on this thread only,
+            // so its children can be looked at without a lock
+            //
+            for (hcNodeInTree = Parent->FirstChild;
+                 hcNodeInTree != NULL;
+                 hcNodeInTree = hcNodeInTree->NextSibling)
             {
-                hcInfoInList = CONTAINING_RECORD(listEntry,
-                                                 USBHOSTCONTROLLERINFO,
-                                                 ListEntry);
-
-                if (_tcscmp(driverKeyName, hcInfoInList->DriverKey) == 0)
+                if (_tcscmp(driverKeyName, hcNodeInTree->Key) == 0)
                 {
                     // Ѿб˳
                     FREE(driverKeyName);
                     FREE(hcInfo);
                     return;
                 }
-
-                listEntry = listEntry->Flink;
             }
 
-            // ȡ豸IDַ
-            // ע: һȫʱַ,Ҫʹý
-            deviceId = DriverNameToDeviceDesc(driverKeyName, TRUE);
+            // ȡ豸IDַ豸ַ
+            devNodeStrings.DriverKey = driverKeyName;
 
-            if (deviceId)
+            GetDevNodeStrings(Context->DevNodeIndex, &devNodeStrings, 1);
+
+            if (devNodeStrings.DeviceId[0] != 0)
             {
                 ULONG   ven, dev, subsys, rev;
 
-                if (_stscanf_s(deviceId,
+                if (_stscanf_s(devNodeStrings.DeviceId,
                            _T("PCI\\VEN_%x&DEV_%x&SUBSYS_%x&REV_%x"),
                            &ven, &dev, &subsys, &rev) != 4)
                 {
@@ -268,35 +601,30 @@ EnumerateHostController (
                 OOPS();
             }
 
-            // Obtain the device description string for this host controller.
-            // (Note, this a tmp global string buffer, make a copy of
-            // this string if it will be used later.)
-            // ȡ豸ַ
-            deviceDesc = DriverNameToDeviceDesc(driverKeyName, FALSE);
-
-            if (deviceDesc)
+            // Use the device description string for this host controller.
+            //
+            if (devNodeStrings.DeviceDesc[0] != 0)
             {
-                leafName = deviceDesc;
+                leafName = devNodeStrings.DeviceDesc;
             }
             else
             {
                 OOPS();
             }
 
-            // Add this host controller to the USB device tree view.
+            // Add this host controller to the USB device tree.
             //
-            hHCItem = AddLeaf(hTreeParent,
-                              (LPARAM)hcInfo,
-                              leafName,
-                              GoodDeviceIcon);
+            hcNode = AddTreeNode(Parent,
+                                 hcInfo,
+                                 leafName,
+                                 GoodDeviceIcon);
 
-            if (hHCItem)
+            if (hcNode)
             {
-                // Add this host controller to the list of enumerated
-                // host controllers.
+                // The driver key identifies the host controller from one
+                // refresh to the next
                 //
-                InsertTailList(&EnumeratedHCListHead,
-                               &hcInfo->ListEntry);
+                hcNode->Key = hcInfo->DriverKey;
 
                 // Get the name of the root hub for this host
                 // controller and then enumerate the root hub.
@@ -305,13 +633,18 @@ EnumerateHostController (
 
                 if (rootHubName != NULL)
                 {
-                    if (EnumerateHub(hHCItem,
-                                 rootHubName,
-                                 NULL,      // ConnectionInfo
-                                 NULL,      // ConfigDesc
-                                 NULL,      // StringDescs
-                                 _T("RootHub")  // DeviceDesc
-                                ) == FALSE)
+                    if (QueueHubEnumeration(Context,
+                                            AddTreeNode(hcNode,
+                                                        NULL,
+                                                        NULL,
+                                                        HubIcon),
+                                            rootHubName,
+                                            NULL,      // ConnectionInfo
+                                            NULL,      // ConfigDesc
+                                            NULL,      // StringDescs
+                                            NULL,      // QualifierDesc
+                                            _T("RootHub")  // DeviceDesc
+                                           ) == FALSE)
                     {
                         FREE(rootHubName);
                     }
@@ -325,8 +658,7 @@ EnumerateHostController (
             }
             else
             {
-                // Failure adding host controller to USB device tree
-                // view.
+                // Failure adding host controller to USB device tree.
 
                 OOPS();
 
@@ -345,47 +677,164 @@ EnumerateHostController (
     }
 }
 
+//*****************************************************************************
+//
+// EnumerateHostControllerInterface()
+//
+// Called for each present GUID_CLASS_USB_HOST_CONTROLLER interface.
+//
+// Context - The enumeration, host controllers are added under the Root of
+// its snapshot.
+//
+//*****************************************************************************
+
+BOOL
+EnumerateHostControllerInterface (
+    PVOID   Context,
+    PCTSTR  DevicePath
+)
+{
+    HANDLE  hHCDev;
+
+    hHCDev = BackendOpenDevice(DevicePath, 0);
+
+    // Ч,֤Ѿɹ.ʾϢ,
+    // Ȼöϵĸ
+    if (hHCDev != INVALID_HANDLE_VALUE)
+    {
+        EnumerateHostController((PENUM_CONTEXT)Context,
+                                &((PENUM_CONTEXT)Context)->Snapshot->Root,
+                                hHCDev,
+                                (PTSTR)DevicePath);
+
+        BackendCloseDevice(hHCDev);
+    }
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// InitLockOnce()
+//
+// Initializes Lock the first time it is called for State, which starts out
+// as LOCK_UNINITIALIZED.  Callers racing the first one wait until it is
+// done, so this may be called from any thread.
+//
+//*****************************************************************************
+
+VOID
+InitLockOnce (
+    LPCRITICAL_SECTION  Lock,
+    volatile LONG       *State
+)
+{
+    if (InterlockedCompareExchange((PLONG)State,
+                                   LOCK_INITIALIZING,
+                                   LOCK_UNINITIALIZED) == LOCK_UNINITIALIZED)
+    {
+        InitializeCriticalSection(Lock);
+
+        InterlockedExchange((PLONG)State, LOCK_READY);
+    }
+    else
+    {
+        while (*State != LOCK_READY)
+        {
+            Sleep(0);
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// InitEnumContext()
+//
+// Snapshot - Zero initialized snapshot the enumeration fills in, NULL if
+// only the options are needed.
+//
+// The options are those chosen for the program, see ParseCommandLine().
+//
+//*****************************************************************************
+
+VOID
+InitEnumContext (
+    PENUM_CONTEXT   Context,
+    PUSB_SNAPSHOT   Snapshot
+)
+{
+    memset(Context, 0, sizeof(ENUM_CONTEXT));
+
+    Context->DoConfigDesc   = gDoConfigDesc;
+    Context->DoLazyDesc     = gDoLazyDesc;
+    Context->DoOverlapped   = gDoOverlapped;
+    Context->DoDevNodeIndex = gDoDevNodeIndex;
+
+    Context->BandwidthThreshold = gBandwidthThreshold;
+
+    Context->StringLanguages = gStringLanguages;
+
+    memcpy(Context->PreferredLanguageIDs,
+           gPreferredLanguageIDs,
+           sizeof(Context->PreferredLanguageIDs));
+
+    Context->NumPreferredLanguageIDs = gNumPreferredLanguageIDs;
+
+    Context->Snapshot = Snapshot;
+}
+
 //*****************************************************************************
 //
 // EnumerateHostControllers()
 //
-// hTreeParent - Handle of the TreeView item under which host controllers
-// should be added.
+// Context - Set up by InitEnumContext().  Host controllers are added as
+// children of the Root of its snapshot.  The host controllers themselves
+// are found one after another on the calling thread, each hub below them
+// is enumerated as a separate work pool item.  This returns once the
+// whole tree has been built.
+//
+// All the state of the enumeration is in Context, so several may run at
+// the same time on different threads.
 //
 //*****************************************************************************
 
 VOID
 EnumerateHostControllers (
-    HTREEITEM  hTreeParent,
-    ULONG     *DevicesConnected
+    PENUM_CONTEXT   Context
 )
 {
     TCHAR        HCName[16];
     int         HCNum;
     HANDLE      hHCDev;
     PTSTR       leafName;
+    PUSBTREENODE Parent;
+    PENUM_COUNTERS previousCounters;
+
+    Parent = &Context->Snapshot->Root;
 
-    HDEVINFO                         deviceInfo;
-    SP_DEVICE_INTERFACE_DATA         deviceInfoData;
-    PSP_DEVICE_INTERFACE_DETAIL_DATA deviceDetailData;
-    ULONG                            index;
-    ULONG                            requiredLength;
+    previousCounters = SetBackendCounters(&Context->Snapshot->Counters);
 
-    TotalDevicesConnected = 0;
-    TotalHubs = 0;
+    InitLockOnce(&QueryLock, &QueryLockState);
+
+    BeginDescriptorCacheRefresh();
+
+    // One walk of the devnode tree for all the lookups of this enumeration
+    //
+    Context->DevNodeIndex = NULL;
+
+    if (Context->DoDevNodeIndex)
+    {
+        Context->DevNodeIndex = BuildDevNodeIndex();
+    }
+
+    WorkPoolBegin(&Context->Batch);
 
     // һЩƣȻԴ
     for (HCNum = 0; HCNum < NUM_HCS_TO_CHECK; HCNum++)
     {
         _stprintf_s(HCName, sizeof(HCName)/sizeof(HCName[0]), _T("\\\\.\\HCD%d"), HCNum);
 
-        hHCDev = CreateFile(HCName,
-                            GENERIC_WRITE,
-                            FILE_SHARE_WRITE,
-                            NULL,
-                            OPEN_EXISTING,
-                            0,
-                            NULL);
+        hHCDev = BackendOpenDevice(HCName, 0);
 
         // Ч,֤Ѿɹ.ʾϢ,
         // Ȼöϵĸ
@@ -393,86 +842,47 @@ EnumerateHostControllers (
         {
             leafName = HCName + _tcslen(_T("\\\\.\\")) - _tcslen(_T(""));
 
-            EnumerateHostController(hTreeParent,
+            EnumerateHostController(Context,
+                                    Parent,
                                     hHCDev,
                                     leafName);
 
-            CloseHandle(hHCDev);
+            BackendCloseDevice(hHCDev);
         }
     }
 
     // ʹûGUIDĽӿö
-    deviceInfo = SetupDiGetClassDevs((LPGUID)&GUID_CLASS_USB_HOST_CONTROLLER,
-                                     NULL,
-                                     NULL,
-                                     (DIGCF_PRESENT | DIGCF_DEVICEINTERFACE));
+    BackendEnumInterfaces((LPGUID)&GUID_CLASS_USB_HOST_CONTROLLER,
+                          EnumerateHostControllerInterface,
+                          Context);
 
-    if (deviceInfo != INVALID_HANDLE_VALUE)
-    {
-        deviceInfoData.cbSize = sizeof(SP_DEVICE_INTERFACE_DATA);
+    WorkPoolWait(&Context->Batch);
 
-        for (index=0;
-             SetupDiEnumDeviceInterfaces(deviceInfo,
-                                         0,
-                                         (LPGUID)&GUID_CLASS_USB_HOST_CONTROLLER,
-                                         index,
-                                         &deviceInfoData);
-             index++)
-        {
-            SetupDiGetDeviceInterfaceDetail(deviceInfo,
-                                            &deviceInfoData,
-                                            NULL,
-                                            0,
-                                            &requiredLength,
-                                            NULL);
-
-            deviceDetailData = GlobalAlloc(GPTR, requiredLength);
-
-            deviceDetailData->cbSize = sizeof(SP_DEVICE_INTERFACE_DETAIL_DATA);
-
-            SetupDiGetDeviceInterfaceDetail(deviceInfo,
-                                            &deviceInfoData,
-                                            deviceDetailData,
-                                            requiredLength,
-                                            &requiredLength,
-                                            NULL);
-
-            hHCDev = CreateFile(deviceDetailData->DevicePath,
-                                GENERIC_WRITE,
-                                FILE_SHARE_WRITE,
-                                NULL,
-                                OPEN_EXISTING,
-                                0,
-                                NULL);
-
-            // Ч,֤Ѿɹ.ʾϢ,
-            // Ȼöϵĸ
-            if (hHCDev != INVALID_HANDLE_VALUE)
-            {
-                leafName = deviceDetailData->DevicePath;
+    // Every hub is in the tree now
+    //
+    ComputeBandwidth(Context->Snapshot, Context->BandwidthThreshold);
 
-                EnumerateHostController(hTreeParent,
-                                        hHCDev,
-                                        leafName);
+    DetectSpeedDowngrades(Context->Snapshot);
 
-                CloseHandle(hHCDev);
-            }
+    FreeQueryBufferPool();
 
-            GlobalFree(deviceDetailData);
-        }
+    EndDescriptorCacheRefresh();
 
-        SetupDiDestroyDeviceInfoList(deviceInfo);
-    }
+    FreeDevNodeIndex(Context->DevNodeIndex);
+
+    Context->DevNodeIndex = NULL;
 
-    *DevicesConnected = TotalDevicesConnected;
+    SetBackendCounters(previousCounters);
 }
 
 //*****************************************************************************
 //
 // EnumerateHub()
 //
-// hTreeParent - Handle of the TreeView item under which this hub should be
-// added.
+// Context - Enumeration the hub is part of.
+//
+// Node - Tree node already reserved for this hub in its parent.  It is
+// filled in here.
 //
 // HubName - Name of this hub.  This pointer is kept so the caller can neither
 // free nor reuse this memory.
@@ -488,15 +898,20 @@ EnumerateHostControllers (
 // StringDescs - NULL if this is a root hub. This pointer is kept so the caller 
 // can neither free nor reuse this memory.
 //
+// QualifierDesc - NULL if this is a root hub or the hub has none.  This
+// pointer is kept so the caller can neither free nor reuse this memory.
+//
 //*****************************************************************************
 
 BOOL
 EnumerateHub (
-    HTREEITEM                           hTreeParent,
+    PENUM_CONTEXT                       Context,
+    PUSBTREENODE                        Node,
     __in PTSTR                        HubName,
     PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfo,
     __in_opt PUSB_DESCRIPTOR_REQUEST ConfigDesc,
-    __in_opt PSTRING_DESCRIPTOR_NODE StringDescs,
+    __in_opt PSTRING_DESCRIPTORS StringDescs,
+    __in_opt PUSB_DEVICE_QUALIFIER_DESCRIPTOR QualifierDesc,
     __in_opt PCTSTR                       DeviceDesc
     )
 {
@@ -504,7 +919,6 @@ EnumerateHub (
     PUSB_HUB_CAPABILITIES   hubCaps;
     PUSB_HUB_CAPABILITIES_EX hubCapsEx;
     HANDLE                  hHubDevice;
-    HTREEITEM               hItem;
     PTSTR                   deviceName;
     size_t                  deviceNameSize;
     BOOL                    success;
@@ -519,6 +933,7 @@ EnumerateHub (
     hubInfo     = NULL;
     hubCaps     = NULL;
     hubCapsEx   = NULL;
+    deviceName  = NULL;
     hHubDevice  = INVALID_HANDLE_VALUE;
 
     // Allocate some space for a USBDEVICEINFO structure to hold the
@@ -590,6 +1005,13 @@ EnumerateHub (
         ((PUSBEXTERNALHUBINFO)info)->ConfigDesc = ConfigDesc;
 
         ((PUSBEXTERNALHUBINFO)info)->StringDescs = StringDescs;
+
+        ((PUSBEXTERNALHUBINFO)info)->QualifierDesc = QualifierDesc;
+
+        ((PUSBEXTERNALHUBINFO)info)->ParentHubName = GetParentHubName(Node);
+
+        ((PUSBEXTERNALHUBINFO)info)->LazyDescriptors =
+            LAZY_DESCRIPTORS(Context, ConnectionInfo);
     }
     else
     {
@@ -619,17 +1041,7 @@ EnumerateHub (
 
     // Try to hub the open device
     // Դ򿪼豸
-    hHubDevice = CreateFile(deviceName,
-                            GENERIC_WRITE,
-                            FILE_SHARE_WRITE,
-                            NULL,
-                            OPEN_EXISTING,
-                            0,
-                            NULL);
-
-    // Done with temp buffer for full hub device name
-    //
-    FREE(deviceName);
+    hHubDevice = BackendOpenDevice(deviceName, 0);
 
     if (hHubDevice == INVALID_HANDLE_VALUE)
     {
@@ -643,14 +1055,14 @@ EnumerateHub (
     //
     // Now query USBHUB for the USB_HUB_CAPABILTIES_EX structure for this hub.
     //
-    success = DeviceIoControl(hHubDevice,
-                              IOCTL_USB_GET_HUB_CAPABILITIES_EX,
-                              hubCapsEx,
-                              sizeof(USB_HUB_CAPABILITIES_EX),
-                              hubCapsEx,
-                              sizeof(USB_HUB_CAPABILITIES_EX),
-                              &nBytes,
-                              NULL);
+    success = BackendDeviceIoControl(hHubDevice,
+                                     IOCTL_USB_GET_HUB_CAPABILITIES_EX,
+                                     hubCapsEx,
+                                     sizeof(USB_HUB_CAPABILITIES_EX),
+                                     hubCapsEx,
+                                     sizeof(USB_HUB_CAPABILITIES_EX),
+                                     &nBytes,
+                                     NULL);
 
     // This will fail for pre-vista OS.  Ignore failures but don't try to use the data.
     if (!success)
@@ -663,14 +1075,14 @@ EnumerateHub (
     //
     // Now query USBHUB for the USB_HUB_CAPABILTIES structure for this hub.
     //
-    success = DeviceIoControl(hHubDevice,
-                              IOCTL_USB_GET_HUB_CAPABILITIES,
-                              hubCaps,
-                              sizeof(USB_HUB_CAPABILITIES),
-                              hubCaps,
-                              sizeof(USB_HUB_CAPABILITIES),
-                              &nBytes,
-                              NULL);
+    success = BackendDeviceIoControl(hHubDevice,
+                                     IOCTL_USB_GET_HUB_CAPABILITIES,
+                                     hubCaps,
+                                     sizeof(USB_HUB_CAPABILITIES),
+                                     hubCaps,
+                                     sizeof(USB_HUB_CAPABILITIES),
+                                     &nBytes,
+                                     NULL);
 
     if (!success)
     {
@@ -683,14 +1095,14 @@ EnumerateHub (
     // This will tell us the number of downstream ports to enumerate, among
     // other things.
     //
-    success = DeviceIoControl(hHubDevice,
-                              IOCTL_USB_GET_NODE_INFORMATION,
-                              hubInfo,
-                              sizeof(USB_NODE_INFORMATION),
-                              hubInfo,
-                              sizeof(USB_NODE_INFORMATION),
-                              &nBytes,
-                              NULL);
+    success = BackendDeviceIoControl(hHubDevice,
+                                     IOCTL_USB_GET_NODE_INFORMATION,
+                                     hubInfo,
+                                     sizeof(USB_NODE_INFORMATION),
+                                     hubInfo,
+                                     sizeof(USB_NODE_INFORMATION),
+                                     &nBytes,
+                                     NULL);
 
     if (!success)
     {
@@ -727,31 +1139,42 @@ EnumerateHub (
         _tcscat_s(leafName, sizeof(leafName)/sizeof(leafName[0]), HubName);
     }
 
-    // Now add an item to the TreeView with the PUSBDEVICEINFO pointer info
-    // as the LPARAM reference value containing everything we know about the
+    // Now fill in the tree node with the PUSBDEVICEINFO pointer info
+    // as the reference value containing everything we know about the
     // hub.
     //
-    hItem = AddLeaf(hTreeParent,
-                    (LPARAM)info,
-                    leafName,
-                    HubIcon);
-
-    if (hItem == NULL)
+    if (!SetTreeNode(Node,
+                     info,
+                     leafName,
+                     HubIcon))
     {
         OOPS();
         goto EnumerateHubError;
     }
 
-    // Now recursively enumrate the ports of this hub.
+    // Now recursively enumrate the ports of this hub, all ports at the
+    // same time if the hub can be opened for overlapped I/O.
     // Եݹ鷽ʽöٴ˼Ķ˿ڡ
-    EnumerateHubPorts(
-        hItem,
-        hHubDevice,
-        hubInfo->u.HubInformation.HubDescriptor.bNumberOfPorts
-        );
+    if (!Context->DoOverlapped ||
+        !EnumerateHubPortsOverlapped(
+            Context,
+            Node,
+            deviceName,
+            hubInfo->u.HubInformation.HubDescriptor.bNumberOfPorts))
+    {
+        EnumerateHubPorts(
+            Context,
+            Node,
+            hHubDevice,
+            hubInfo->u.HubInformation.HubDescriptor.bNumberOfPorts
+            );
+    }
 
+    // Done with temp buffer for full hub device name
+    //
+    FREE(deviceName);
 
-    CloseHandle(hHubDevice);
+    BackendCloseDevice(hHubDevice);
     return TRUE;
 
 EnumerateHubError:
@@ -761,10 +1184,15 @@ EnumerateHubError:
 
     if (hHubDevice != INVALID_HANDLE_VALUE)
     {
-        CloseHandle(hHubDevice);
+        BackendCloseDevice(hHubDevice);
         hHubDevice = INVALID_HANDLE_VALUE;
     }
 
+    if (deviceName)
+    {
+        FREE(deviceName);
+    }
+
     if (hubInfo)
     {
         FREE(hubInfo);
@@ -790,63 +1218,194 @@ EnumerateHubError:
 
 //*****************************************************************************
 //
-// EnumerateHubPorts()
-//
-// hTreeParent - Handle of the TreeView item under which the hub port should
-// be added.
+// QueueHubEnumeration()
 //
-// hHubDevice - Handle of the hub device to enumerate.
+// Node - Tree node reserved for the hub in its parent, so hubs keep their
+// port order in the tree.  May be NULL if reserving it failed.
 //
-// NumPorts - Number of ports on the hub.
+// The remaining parameters are as for EnumerateHub().  Returns FALSE,
+// leaving the caller owning everything it passed in, if the hub could not
+// be queued.  Otherwise the work item owns them.
 //
 //*****************************************************************************
 
-VOID
-EnumerateHubPorts (
-    HTREEITEM   hTreeParent,
-    HANDLE      hHubDevice,
-    ULONG       NumPorts
+BOOL
+QueueHubEnumeration (
+    PENUM_CONTEXT                       Context,
+    PUSBTREENODE                        Node,
+    __in PTSTR                          HubName,
+    PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfo,
+    __in_opt PUSB_DESCRIPTOR_REQUEST    ConfigDesc,
+    __in_opt PSTRING_DESCRIPTORS        StringDescs,
+    __in_opt PUSB_DEVICE_QUALIFIER_DESCRIPTOR QualifierDesc,
+    __in_opt PCTSTR                     DeviceDesc
 )
 {
-    ULONG       index;
-    BOOL        success;
+    PHUB_ENUM_TASK  task;
+    size_t          deviceDescSize;
 
-    PUSB_NODE_CONNECTION_INFORMATION_EX connectionInfoEx;
-    PUSB_DESCRIPTOR_REQUEST             configDesc;
-    PSTRING_DESCRIPTOR_NODE             stringDescs;
-    PUSBDEVICEINFO                      info;
+    if (Node == NULL)
+    {
+        OOPS();
+        return FALSE;
+    }
 
-    PTSTR driverKeyName;
-    PTSTR deviceDesc;
-    TCHAR  leafName[512]; // XXXXX how big does this have to be?
-    int   icon;
+    // DeviceDesc may point at a temporary buffer, keep a copy of it
+    //
+    deviceDescSize = DeviceDesc ? _tcslen(DeviceDesc) + 1 : 1;
 
-    // Loop over all ports of the hub.
-    // ϵж˿
-    // Port indices are 1 based, not 0 based.
-    // ˿1ʼ(Ǵ0ʼ)
-    for (index=1; index <= NumPorts; index++)
+    task = (PHUB_ENUM_TASK)ALLOC(sizeof(HUB_ENUM_TASK) +
+                                 deviceDescSize * sizeof(TCHAR));
+
+    if (task == NULL)
     {
-        ULONG nBytesEx;
+        OOPS();
+        return FALSE;
+    }
 
-        // Allocate space to hold the connection info for this port.
-        // For now, allocate it big enough to hold info for 30 pipes.
-        //
-        // Endpoint numbers are 0-15.  Endpoint number 0 is the standard
-        // control endpoint which is not explicitly listed in the Configuration
-        // Descriptor.  There can be an IN endpoint and an OUT endpoint at
-        // endpoint numbers 1-15 so there can be a maximum of 30 endpoints
-        // per device configuration.
-        //
-        // Should probably size this dynamically at some point.
-        //
-        nBytesEx = sizeof(USB_NODE_CONNECTION_INFORMATION_EX) +
-                   sizeof(USB_PIPE_INFO) * 30;
+    task->Context        = Context;
+    task->Node           = Node;
+    task->HubName        = HubName;
+    task->ConnectionInfo = ConnectionInfo;
+    task->ConfigDesc     = ConfigDesc;
+    task->StringDescs    = StringDescs;
+    task->QualifierDesc  = QualifierDesc;
 
-        connectionInfoEx = (PUSB_NODE_CONNECTION_INFORMATION_EX)ALLOC(nBytesEx);
+    if (DeviceDesc)
+    {
+        task->HasDeviceDesc = TRUE;
+        _tcscpy_s(task->DeviceDesc, deviceDescSize, DeviceDesc);
+    }
 
-        if (connectionInfoEx == NULL)
-        {
+    WorkPoolSubmit(&Context->Batch, EnumerateHubTask, task);
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// EnumerateHubTask()
+//
+// Work pool routine for a hub queued by QueueHubEnumeration().
+//
+//*****************************************************************************
+
+VOID
+EnumerateHubTask (
+    PVOID   Parameter
+)
+{
+    PHUB_ENUM_TASK task;
+    PENUM_COUNTERS previousCounters;
+
+    task = (PHUB_ENUM_TASK)Parameter;
+
+    // The pool thread may work for another enumeration next
+    //
+    previousCounters = SetBackendCounters(&task->Context->Snapshot->Counters);
+
+    if (EnumerateHub(task->Context,
+                     task->Node,
+                     task->HubName,
+                     task->ConnectionInfo,
+                     task->ConfigDesc,
+                     task->StringDescs,
+                     task->QualifierDesc,
+                     task->HasDeviceDesc ? task->DeviceDesc : NULL) == FALSE)
+    {
+        // The node stays empty and is left out of the tree view
+        //
+        FREE(task->HubName);
+
+        if (task->ConnectionInfo)
+        {
+            FREE(task->ConnectionInfo);
+        }
+
+        if (task->ConfigDesc)
+        {
+            FREE(task->ConfigDesc);
+        }
+
+        FreeStringDescriptors(task->StringDescs);
+
+        if (task->QualifierDesc)
+        {
+            FREE(task->QualifierDesc);
+        }
+    }
+
+    SetBackendCounters(previousCounters);
+
+    FREE(task);
+}
+
+//*****************************************************************************
+//
+// EnumerateHubPorts()
+//
+// Context - Enumeration the hub is part of.
+//
+// Parent - Tree node under which the hub ports should be added.
+//
+// hHubDevice - Handle of the hub device to enumerate.
+//
+// NumPorts - Number of ports on the hub.
+//
+// The ports are queried one after another with blocking requests.  See
+// EnumerateHubPortsOverlapped() for the version which queries all ports at
+// the same time.
+//
+//*****************************************************************************
+
+VOID
+EnumerateHubPorts (
+    PENUM_CONTEXT   Context,
+    PUSBTREENODE    Parent,
+    HANDLE          hHubDevice,
+    ULONG           NumPorts
+)
+{
+    ULONG       index;
+    BOOL        success;
+
+    PUSB_NODE_CONNECTION_INFORMATION_EX connectionInfoEx;
+    PUSB_DESCRIPTOR_REQUEST             configDesc;
+    PSTRING_DESCRIPTORS                 stringDescs;
+    PUSB_DEVICE_QUALIFIER_DESCRIPTOR    qualifierDesc;
+
+    PTSTR driverKeyName;
+    PTSTR extHubName;
+    PTSTR hubName;
+
+    hubName = GetHubNodeName(Parent);
+
+    // Loop over all ports of the hub.
+    // ϵж˿
+    // Port indices are 1 based, not 0 based.
+    // ˿1ʼ(Ǵ0ʼ)
+    for (index=1; index <= NumPorts; index++)
+    {
+        ULONG nBytesEx;
+
+        // Allocate space to hold the connection info for this port.
+        // For now, allocate it big enough to hold info for 30 pipes.
+        //
+        // Endpoint numbers are 0-15.  Endpoint number 0 is the standard
+        // control endpoint which is not explicitly listed in the Configuration
+        // Descriptor.  There can be an IN endpoint and an OUT endpoint at
+        // endpoint numbers 1-15 so there can be a maximum of 30 endpoints
+        // per device configuration.
+        //
+        // Should probably size this dynamically at some point.
+        //
+        nBytesEx = sizeof(USB_NODE_CONNECTION_INFORMATION_EX) +
+                   sizeof(USB_PIPE_INFO) * 30;
+
+        connectionInfoEx = (PUSB_NODE_CONNECTION_INFORMATION_EX)ALLOC(nBytesEx);
+
+        if (connectionInfoEx == NULL)
+        {
             OOPS();
             break;
         }
@@ -858,14 +1417,14 @@ EnumerateHubPorts (
         //
         connectionInfoEx->ConnectionIndex = index;
 
-        success = DeviceIoControl(hHubDevice,
-                                  IOCTL_USB_GET_NODE_CONNECTION_INFORMATION_EX,
-                                  connectionInfoEx,
-                                  nBytesEx,
-                                  connectionInfoEx,
-                                  nBytesEx,
-                                  &nBytesEx,
-                                  NULL);
+        success = BackendDeviceIoControl(hHubDevice,
+                                         IOCTL_USB_GET_NODE_CONNECTION_INFORMATION_EX,
+                                         connectionInfoEx,
+                                         nBytesEx,
+                                         connectionInfoEx,
+                                         nBytesEx,
+                                         &nBytesEx,
+                                         NULL);
 
         if (!success)
         {
@@ -880,16 +1439,23 @@ EnumerateHubPorts (
 
             connectionInfo = (PUSB_NODE_CONNECTION_INFORMATION)ALLOC(nBytes);
 
+            if (connectionInfo == NULL)
+            {
+                OOPS();
+                FREE(connectionInfoEx);
+                continue;
+            }
+
             connectionInfo->ConnectionIndex = index;
 
-            success = DeviceIoControl(hHubDevice,
-                                      IOCTL_USB_GET_NODE_CONNECTION_INFORMATION,
-                                      connectionInfo,
-                                      nBytes,
-                                      connectionInfo,
-                                      nBytes,
-                                      &nBytes,
-                                      NULL);
+            success = BackendDeviceIoControl(hHubDevice,
+                                             IOCTL_USB_GET_NODE_CONNECTION_INFORMATION,
+                                             connectionInfo,
+                                             nBytes,
+                                             connectionInfo,
+                                             nBytes,
+                                             &nBytes,
+                                             NULL);
 
             if (!success)
             {
@@ -900,77 +1466,55 @@ EnumerateHubPorts (
                 continue;
             }
 
-            // Copy IOCTL_USB_GET_NODE_CONNECTION_INFORMATION into
-            // IOCTL_USB_GET_NODE_CONNECTION_INFORMATION_EX structure.
-            //
-            connectionInfoEx->ConnectionIndex =
-                connectionInfo->ConnectionIndex;
-
-            connectionInfoEx->DeviceDescriptor =
-                connectionInfo->DeviceDescriptor;
-
-            connectionInfoEx->CurrentConfigurationValue =
-                connectionInfo->CurrentConfigurationValue;
-
-            connectionInfoEx->Speed =
-                connectionInfo->LowSpeed ? UsbLowSpeed : UsbFullSpeed;
-
-            connectionInfoEx->DeviceIsHub =
-                connectionInfo->DeviceIsHub;
-
-            connectionInfoEx->DeviceAddress =
-                connectionInfo->DeviceAddress;
-
-            connectionInfoEx->NumberOfOpenPipes =
-                connectionInfo->NumberOfOpenPipes;
-
-            connectionInfoEx->ConnectionStatus =
-                connectionInfo->ConnectionStatus;
-
-            memcpy(&connectionInfoEx->PipeList[0],
-                   &connectionInfo->PipeList[0],
-                   sizeof(USB_PIPE_INFO) * 30);
+            ConnectionInfoToEx(connectionInfoEx, connectionInfo);
 
             FREE(connectionInfo);
         }
 
-        // Update the count of connected devices
+        // A device which has not changed since the last refresh needs
+        // nothing more than the connection info
         //
-        if (connectionInfoEx->ConnectionStatus == DeviceConnected)
-        {
-            TotalDevicesConnected++;
-        }
-
-        if (connectionInfoEx->DeviceIsHub)
+        if (LookupDescriptorCache(hubName,
+                                  connectionInfoEx,
+                                  EAGER_CONFIG_DESC(Context),
+                                  &driverKeyName,
+                                  &configDesc,
+                                  &stringDescs,
+                                  &qualifierDesc,
+                                  &extHubName,
+                                  &Context->Snapshot->Counters))
         {
-            TotalHubs++;
+            AddHubPort(Context,
+                       AddPortTreeNode(Parent, index),
+                       connectionInfoEx,
+                       driverKeyName,
+                       configDesc,
+                       stringDescs,
+                       qualifierDesc,
+                       extHubName);
+            continue;
         }
 
-        // If there is a device connected, get the Device Description
+        // If there is a device connected, get the Driver Key Name, which
+        // leads to the Device Description
         // ˴豸ȡ豸
-        deviceDesc = NULL;
+        driverKeyName = NULL;
         if (connectionInfoEx->ConnectionStatus != NoDeviceConnected)
         {
             driverKeyName = GetDriverKeyName(hHubDevice,
                                              index);
-
-            if (driverKeyName)
-            {
-                deviceDesc = DriverNameToDeviceDesc(driverKeyName, FALSE);
-
-                FREE(driverKeyName);
-            }
         }
 
         // If there is a device connected to the port, try to retrieve the
         // Configuration Descriptor from the device.
         //
-        if (gDoConfigDesc &&
+        if (EAGER_CONFIG_DESC(Context) &&
             connectionInfoEx->ConnectionStatus == DeviceConnected)
         {
             configDesc = GetConfigDescriptor(hHubDevice,
                                              index,
-                                             0);
+                                             0,
+                                             &connectionInfoEx->DeviceDescriptor);
         }
         else
         {
@@ -979,169 +1523,1721 @@ EnumerateHubPorts (
 
         if (configDesc != NULL &&
             AreThereStringDescriptors(&connectionInfoEx->DeviceDescriptor,
-                                      (PUSB_CONFIGURATION_DESCRIPTOR)(configDesc+1)))
+                                      configDesc))
         {
             stringDescs = GetAllStringDescriptors(
+                              Context,
                               hHubDevice,
                               index,
                               &connectionInfoEx->DeviceDescriptor,
-                              (PUSB_CONFIGURATION_DESCRIPTOR)(configDesc+1));
+                              configDesc);
         }
         else
         {
             stringDescs = NULL;
         }
 
+        // A full speed device claiming USB 2.0 which has a Device
+        // Qualifier Descriptor could run at high speed, see SPEED.C
+        //
+        qualifierDesc = NULL;
+        if (MAY_BE_DOWNGRADED(connectionInfoEx))
+        {
+            qualifierDesc = GetDeviceQualifierDescriptor(hHubDevice,
+                                                         index);
+        }
+
         // If the device connected to the port is an external hub, get the
-        // name of the external hub and recursively enumerate it.
+        // name of the external hub.
         //
+        extHubName = NULL;
         if (connectionInfoEx->DeviceIsHub)
         {
-            PTSTR extHubName;
-
             extHubName = GetExternalHubName(hHubDevice,
                                             index);
+        }
 
-            if (extHubName != NULL)
-            {
+        UpdateDescriptorCache(hubName,
+                              connectionInfoEx,
+                              driverKeyName,
+                              configDesc,
+                              stringDescs,
+                              qualifierDesc,
+                              extHubName);
+
+        AddHubPort(Context,
+                   AddPortTreeNode(Parent, index),
+                   connectionInfoEx,
+                   driverKeyName,
+                   configDesc,
+                   stringDescs,
+                   qualifierDesc,
+                   extHubName);
+    }
+}
 
-                if (EnumerateHub(hTreeParent, 
-                             extHubName,
-                             connectionInfoEx,
-                             configDesc,
-                             stringDescs,
-                             deviceDesc) == FALSE) 
-                {
-                    FREE(extHubName);
+//*****************************************************************************
+//
+// EnumerateHubPortsOverlapped()
+//
+// Context - Enumeration the hub is part of.
+//
+// Parent - Tree node under which the hub ports should be added.
+//
+// HubDeviceName - Full device name of the hub.  The hub is opened again
+// here for overlapped I/O.
+//
+// NumPorts - Number of ports on the hub.
+//
+// Sends the requests for every port at the same time, so that a hub takes
+// about as long as its slowest port rather than the sum of all of them.
+// Each port goes through the same requests as in EnumerateHubPorts(), and
+// is added to its tree node as soon as its last request has completed.
+//
+// Returns FALSE, without having touched Parent, if the overlapped requests
+// could not be set up.
+//
+//*****************************************************************************
 
-                    FREE(connectionInfoEx);
+BOOL
+EnumerateHubPortsOverlapped (
+    PENUM_CONTEXT   Context,
+    PUSBTREENODE    Parent,
+    PCTSTR          HubDeviceName,
+    ULONG           NumPorts
+)
+{
+    HANDLE          hHubDevice;
+    PPORT_QUERY     queries;
+    PPORT_QUERY     query;
+    HANDLE          events[MAXIMUM_WAIT_OBJECTS];
+    ULONG           eventQuery[MAXIMUM_WAIT_OBJECTS];
+    ULONG           numQueries;
+    ULONG           numPending;
+    ULONG           firstPort;
+    ULONG           count;
+    ULONG           i;
+    DWORD           wait;
+    BOOL            success;
+
+    if (NumPorts == 0)
+    {
+        return FALSE;
+    }
 
-                    if (configDesc)
-                    {
-                        FREE(configDesc);
-                    }
+    hHubDevice = BackendOpenDevice(HubDeviceName, FILE_FLAG_OVERLAPPED);
 
-                    if (stringDescs != NULL)
-                    {
-                        PSTRING_DESCRIPTOR_NODE Next;
+    if (hHubDevice == INVALID_HANDLE_VALUE)
+    {
+        OOPS();
+        return FALSE;
+    }
 
-                        do {
+    // One wait can only cover MAXIMUM_WAIT_OBJECTS ports, larger hubs are
+    // done in several batches.
+    //
+    numQueries = min(NumPorts, MAXIMUM_WAIT_OBJECTS);
 
-                            Next = stringDescs->Next;
-                            FREE(stringDescs);
-                            stringDescs = Next;
+    queries = (PPORT_QUERY)ALLOC(numQueries * sizeof(PORT_QUERY));
 
-                        } while (stringDescs != NULL);
-                    }
-                }
-            }
-        }
-        else
+    if (queries == NULL)
+    {
+        OOPS();
+        BackendCloseDevice(hHubDevice);
+        return FALSE;
+    }
+
+    for (i = 0; i < numQueries; i++)
+    {
+        queries[i].Overlapped.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+
+        if (queries[i].Overlapped.hEvent == NULL)
         {
-            // Allocate some space for a USBDEVICEINFO structure to hold the
-            // Config Descriptors, Strings Descriptors, and connection info
-            // pointers.  GPTR zero initializes the structure for us.
-            //
-            info = (PUSBDEVICEINFO) ALLOC(sizeof(USBDEVICEINFO));
+            OOPS();
 
-            if (info == NULL)
+            while (i-- > 0)
             {
-                OOPS();
-                if (configDesc != NULL)
-                {
-                    FREE(configDesc);
-                }
-                FREE(connectionInfoEx);
-                break;
+                CloseHandle(queries[i].Overlapped.hEvent);
             }
 
-            info->DeviceInfoType = DeviceInfo;
+            FREE(queries);
+            BackendCloseDevice(hHubDevice);
+            return FALSE;
+        }
+    }
+
+    for (firstPort = 1; firstPort <= NumPorts; firstPort += numQueries)
+    {
+        count = min(numQueries, NumPorts - firstPort + 1);
 
-            info->ConnectionInfo = connectionInfoEx;
+        // Reserve the tree nodes first, ports may complete in any order
+        //
+        for (i = 0; i < count; i++)
+        {
+            query = &queries[i];
 
-            info->ConfigDesc = configDesc;
+            InitPortQuery(Context, query, firstPort + i);
 
-            info->StringDescs = stringDescs;
+            query->Node = AddPortTreeNode(Parent, firstPort + i);
+        }
 
-            _stprintf_s(leafName, sizeof(leafName)/sizeof(leafName[0]), _T("[Port%d] "), index);
+        // Send the first request of every port
+        //
+        for (i = 0; i < count; i++)
+        {
+            query = &queries[i];
 
-            _tcscat_s(leafName, sizeof(leafName)/sizeof(leafName[0]), ConnectionStatuses[connectionInfoEx->ConnectionStatus]);
+            RunPortQuery(hHubDevice, query, TRUE);
 
-            if (deviceDesc)
+            if (query->Step == PortQueryDone)
             {
-                _tcscat_s(leafName, sizeof(leafName)/sizeof(leafName[0]), _T(" :  "));
-                _tcscat_s(leafName, sizeof(leafName)/sizeof(leafName[0]), deviceDesc);
+                FinishPortQuery(query);
             }
+        }
+
+        // Then keep going with whichever port completes next
+        //
+        for (;;)
+        {
+            numPending = 0;
 
-            if (connectionInfoEx->ConnectionStatus == NoDeviceConnected)
+            for (i = 0; i < count; i++)
             {
-                icon = NoDeviceIcon;
+                if (queries[i].Pending)
+                {
+                    events[numPending] = queries[i].Overlapped.hEvent;
+                    eventQuery[numPending] = i;
+                    numPending++;
+                }
             }
-            else if (connectionInfoEx->CurrentConfigurationValue)
+
+            if (numPending == 0)
             {
-                icon = GoodDeviceIcon;
+                break;
+            }
+
+            wait = WaitForMultipleObjects(numPending,
+                                          events,
+                                          FALSE,
+                                          INFINITE);
+
+            if (wait - WAIT_OBJECT_0 < numPending)
+            {
+                query = &queries[eventQuery[wait - WAIT_OBJECT_0]];
             }
             else
             {
-                icon = BadDeviceIcon;
+                // Should not happen, fall back to waiting for the first one
+                //
+                OOPS();
+                query = &queries[eventQuery[0]];
             }
 
-            AddLeaf(hTreeParent, 
-                            (LPARAM)info,
-                            leafName,
-                            icon);
+            query->Pending = FALSE;
+
+            success = BackendGetOverlappedResult(hHubDevice,
+                                                 &query->Overlapped,
+                                                 &query->BytesReturned,
+                                                 TRUE);
+
+            RunPortQuery(hHubDevice, query, success);
+
+            if (query->Step == PortQueryDone)
+            {
+                FinishPortQuery(query);
+            }
         }
     }
-}
 
+    for (i = 0; i < numQueries; i++)
+    {
+        CloseHandle(queries[i].Overlapped.hEvent);
+    }
+
+    FREE(queries);
+
+    BackendCloseDevice(hHubDevice);
+
+    return TRUE;
+}
 
 //*****************************************************************************
 //
-// WideStrToMultiStr()
+// InitPortQuery()
+//
+// Resets a PORT_QUERY for ConnectionIndex, keeping its event.
 //
 //*****************************************************************************
 
-PTSTR WideStrToMultiStr (__in LPCWSTR WideStr)
+VOID
+InitPortQuery (
+    PENUM_CONTEXT   Context,
+    PPORT_QUERY     Query,
+    ULONG           ConnectionIndex
+)
 {
-    // Is there a better way to do this?
-#if defined(_UNICODE) //  If this is built for UNICODE, just clone the input
-    ULONG nChars;
-    PTSTR RetStr;
+    HANDLE hEvent;
 
-    nChars = wcslen(WideStr) + 1;
-    RetStr = ALLOC(nChars * sizeof(TCHAR));
-    if (RetStr == NULL)
-    {
-        return NULL;
-    }
-    _tcscpy_s(RetStr, nChars, WideStr);
-    return RetStr;
-    
+    hEvent = Query->Overlapped.hEvent;
 
-#else //  convert
-    ULONG nBytes;
-    PTSTR MultiStr;
-    
-    // Get the length of the converted string
-    //
-    nBytes = WideCharToMultiByte(
-                 CP_ACP,
-                 0,
-                 WideStr,
-                 -1,
-                 NULL,
-                 0,
-                 NULL,
-                 NULL);
+    memset(Query, 0, sizeof(PORT_QUERY));
 
-    if (nBytes == 0)
-    {
-        return NULL;
-    }
+    Query->Overlapped.hEvent = hEvent;
+    Query->Context = Context;
+    Query->ConnectionIndex = ConnectionIndex;
+    Query->Step = PortQueryStart;
+}
 
-    // Allocate space to hold the converted string
-    //
-    MultiStr = ALLOC(nBytes);
+//*****************************************************************************
+//
+// RunPortQuery()
+//
+// hHubDevice - Hub opened for overlapped I/O.
+//
+// Query - Port whose last request has completed.
+//
+// Success - Whether that request succeeded.  The number of bytes it
+// returned is in Query->BytesReturned.
+//
+// Processes the result of the last request and sends the next one.  This
+// returns when a request is pending, with Query->Pending set, or when the
+// port is done, with Query->Step set to PortQueryDone.  Requests which
+// complete right away are processed here without returning.
+//
+//*****************************************************************************
+
+VOID
+RunPortQuery (
+    HANDLE      hHubDevice,
+    PPORT_QUERY Query,
+    BOOL        Success
+)
+{
+    PUSB_NODE_CONNECTION_INFORMATION_EX connectionInfoEx;
+    PUSB_CONFIGURATION_DESCRIPTOR       configDesc;
+    PUSB_STRING_DESCRIPTOR              languagesDesc;
+    DWORD                               ioControlCode;
+    PVOID                               request;
+    ULONG                               requestSize;
+    ULONG                               numLanguageIDs;
+    ULONG                               numIndexes;
+    ULONG                               numDuplicates;
+    USHORT                              totalLength;
+    BOOL                                complete;
+    HANDLE                              hEvent;
+
+    for (;;)
+    {
+        connectionInfoEx = Query->ConnectionInfo;
+
+        switch (Query->Step)
+        {
+            case PortQueryStart:
+
+                // See EnumerateHubPorts() for the size
+                //
+                requestSize = sizeof(USB_NODE_CONNECTION_INFORMATION_EX) +
+                              sizeof(USB_PIPE_INFO) * 30;
+
+                Query->ConnectionInfo = ALLOC(requestSize);
+
+                if (Query->ConnectionInfo == NULL)
+                {
+                    OOPS();
+                    Query->Step = PortQueryDone;
+                    continue;
+                }
+
+                Query->ConnectionInfo->ConnectionIndex = Query->ConnectionIndex;
+
+                ioControlCode = IOCTL_USB_GET_NODE_CONNECTION_INFORMATION_EX;
+                request = Query->ConnectionInfo;
+                Query->Step = PortQueryConnectionInfoEx;
+                break;
+
+            case PortQueryConnectionInfoEx:
+
+                if (Success)
+                {
+                    Query->Step = PortQueryGetDriverKey;
+                    continue;
+                }
+
+                // Try using IOCTL_USB_GET_NODE_CONNECTION_INFORMATION
+                // instead of IOCTL_USB_GET_NODE_CONNECTION_INFORMATION_EX
+                //
+                requestSize = sizeof(USB_NODE_CONNECTION_INFORMATION) +
+                              sizeof(USB_PIPE_INFO) * 30;
+
+                Query->Buffer = ALLOC(requestSize);
+
+                if (Query->Buffer == NULL)
+                {
+                    OOPS();
+                    FREE(Query->ConnectionInfo);
+                    Query->ConnectionInfo = NULL;
+                    Query->Step = PortQueryDone;
+                    continue;
+                }
+
+                ((PUSB_NODE_CONNECTION_INFORMATION)Query->Buffer)->ConnectionIndex =
+                    Query->ConnectionIndex;
+
+                ioControlCode = IOCTL_USB_GET_NODE_CONNECTION_INFORMATION;
+                request = Query->Buffer;
+                Query->Step = PortQueryConnectionInfo;
+                break;
+
+            case PortQueryConnectionInfo:
+
+                if (Success)
+                {
+                    ConnectionInfoToEx(connectionInfoEx,
+                                       (PUSB_NODE_CONNECTION_INFORMATION)Query->Buffer);
+
+                    Query->Step = PortQueryGetDriverKey;
+                }
+                else
+                {
+                    OOPS();
+                    FREE(Query->ConnectionInfo);
+                    Query->ConnectionInfo = NULL;
+                    Query->Step = PortQueryDone;
+                }
+
+                FREE(Query->Buffer);
+                Query->Buffer = NULL;
+                continue;
+
+            case PortQueryGetDriverKey:
+
+                // A device which has not changed since the last refresh
+                // needs nothing more than the connection info
+                //
+                if (Query->Node != NULL &&
+                    LookupDescriptorCache(GetParentHubName(Query->Node),
+                                          connectionInfoEx,
+                                          EAGER_CONFIG_DESC(Query->Context),
+                                          &Query->DriverKeyName,
+                                          &Query->ConfigDesc,
+                                          &Query->StringDescs,
+                                          &Query->QualifierDesc,
+                                          &Query->ExtHubName,
+                                          &Query->Context->Snapshot->Counters))
+                {
+                    Query->Cached = TRUE;
+                    Query->Step = PortQueryDone;
+                    continue;
+                }
+
+                // If there is a device connected, get the Driver Key Name
+                //
+                if (connectionInfoEx->ConnectionStatus == NoDeviceConnected)
+                {
+                    Query->Step = PortQueryGetConfigDesc;
+                    continue;
+                }
+
+                // Ask for the whole name at once, see GetDriverKeyName()
+                //
+                memset(&Query->Scratch.DriverKeyNameRequest, 0,
+                       sizeof(USB_NODE_CONNECTION_DRIVERKEY_NAME));
+
+                Query->Scratch.DriverKeyNameRequest.ConnectionIndex =
+                    Query->ConnectionIndex;
+
+                ioControlCode = IOCTL_USB_GET_NODE_CONNECTION_DRIVERKEY_NAME;
+                request = &Query->Scratch.DriverKeyNameRequest;
+                requestSize = sizeof(Query->Scratch.QueryBuffer);
+                Query->Step = PortQueryDriverKeyFirst;
+                break;
+
+            case PortQueryDriverKeyFirst:
+
+                requestSize = Query->Scratch.DriverKeyNameRequest.ActualLength;
+
+                if (!Success ||
+                    requestSize <= sizeof(USB_NODE_CONNECTION_DRIVERKEY_NAME))
+                {
+                    OOPS();
+                    Query->Step = PortQueryGetConfigDesc;
+                    continue;
+                }
+
+                if (requestSize <= sizeof(Query->Scratch.QueryBuffer))
+                {
+                    Query->DriverKeyName = WideStrToMultiStr(
+                        Query->Scratch.DriverKeyNameRequest.DriverKeyName);
+
+                    Query->Step = PortQueryGetConfigDesc;
+                    continue;
+                }
+
+                // The name did not fit, get it again with the right size
+                //
+                Query->Buffer = ALLOC(requestSize);
+
+                if (Query->Buffer == NULL)
+                {
+                    OOPS();
+                    Query->Step = PortQueryGetConfigDesc;
+                    continue;
+                }
+
+                ((PUSB_NODE_CONNECTION_DRIVERKEY_NAME)Query->Buffer)->ConnectionIndex =
+                    Query->ConnectionIndex;
+
+                ioControlCode = IOCTL_USB_GET_NODE_CONNECTION_DRIVERKEY_NAME;
+                request = Query->Buffer;
+                Query->Step = PortQueryDriverKey;
+                break;
+
+            case PortQueryDriverKey:
+
+                if (Success)
+                {
+                    Query->DriverKeyName = WideStrToMultiStr(
+                        ((PUSB_NODE_CONNECTION_DRIVERKEY_NAME)Query->Buffer)->DriverKeyName);
+                }
+                else
+                {
+                    OOPS();
+                }
+
+                FREE(Query->Buffer);
+                Query->Buffer = NULL;
+                Query->Step = PortQueryGetConfigDesc;
+                continue;
+
+            case PortQueryGetConfigDesc:
+
+                // If there is a device connected to the port, try to
+                // retrieve the Configuration Descriptor from the device.
+                // The first request asks for the length this device model
+                // had before, else for as much as the query buffer holds.
+                //
+                if (!EAGER_CONFIG_DESC(Query->Context) ||
+                    connectionInfoEx->ConnectionStatus != DeviceConnected)
+                {
+                    Query->Step = PortQueryGetQualifier;
+                    continue;
+                }
+
+                totalLength = GetCachedConfigLength(&connectionInfoEx->DeviceDescriptor);
+
+                if (totalLength != 0)
+                {
+                    requestSize = sizeof(USB_DESCRIPTOR_REQUEST) + totalLength;
+
+                    Query->Buffer = ALLOC(requestSize);
+
+                    if (Query->Buffer == NULL)
+                    {
+                        OOPS();
+                        Query->Step = PortQueryGetQualifier;
+                        continue;
+                    }
+
+                    request = Query->Buffer;
+                }
+                else
+                {
+                    requestSize = sizeof(Query->Scratch.QueryBuffer);
+                    request = Query->Scratch.QueryBuffer;
+                }
+
+                InitDescriptorRequest(request,
+                                      requestSize,
+                                      Query->ConnectionIndex,
+                                      USB_CONFIGURATION_DESCRIPTOR_TYPE,
+                                      0,
+                                      0);
+
+                Query->BufferSize = requestSize;
+                ioControlCode = IOCTL_USB_GET_DESCRIPTOR_FROM_NODE_CONNECTION;
+                Query->Step = PortQueryConfigDescFirst;
+                break;
+
+            case PortQueryConfigDescFirst:
+
+                request = (Query->Buffer != NULL) ? Query->Buffer :
+                                                    Query->Scratch.QueryBuffer;
+
+                totalLength = 0;
+
+                if (Success)
+                {
+                    totalLength = CheckConfigDescriptor(
+                        (PUSB_DESCRIPTOR_REQUEST)request,
+                        Query->BufferSize,
+                        Query->BytesReturned,
+                        &complete);
+                }
+
+                if (totalLength == 0)
+                {
+                    OOPS();
+
+                    if (Query->Buffer != NULL)
+                    {
+                        FREE(Query->Buffer);
+                        Query->Buffer = NULL;
+                    }
+
+                    Query->Step = PortQueryGetQualifier;
+                    continue;
+                }
+
+                if (complete)
+                {
+                    // Copy the descriptor out of the query buffer
+                    //
+                    if (Query->Buffer == NULL)
+                    {
+                        Query->Buffer = ALLOC(Query->BytesReturned);
+
+                        if (Query->Buffer == NULL)
+                        {
+                            OOPS();
+                            Query->Step = PortQueryGetQualifier;
+                            continue;
+                        }
+
+                        memcpy(Query->Buffer, request, Query->BytesReturned);
+                    }
+
+                    CacheConfigLength(&connectionInfoEx->DeviceDescriptor,
+                                      totalLength);
+
+                    Query->ConfigDesc = (PUSB_DESCRIPTOR_REQUEST)Query->Buffer;
+                    Query->Buffer = NULL;
+                    Query->Step = PortQueryGetStrings;
+                    continue;
+                }
+
+                // The descriptor did not fit.  Now request the entire
+                // Configuration Descriptor
+                //
+                if (Query->Buffer != NULL)
+                {
+                    FREE(Query->Buffer);
+                }
+
+                requestSize = sizeof(USB_DESCRIPTOR_REQUEST) + totalLength;
+
+                Query->Buffer = ALLOC(requestSize);
+
+                if (Query->Buffer == NULL)
+                {
+                    OOPS();
+                    Query->Step = PortQueryGetQualifier;
+                    continue;
+                }
+
+                InitDescriptorRequest(Query->Buffer,
+                                      requestSize,
+                                      Query->ConnectionIndex,
+                                      USB_CONFIGURATION_DESCRIPTOR_TYPE,
+                                      0,
+                                      0);
+
+                request = Query->Buffer;
+                Query->BufferSize = requestSize;
+                ioControlCode = IOCTL_USB_GET_DESCRIPTOR_FROM_NODE_CONNECTION;
+                Query->Step = PortQueryConfigDesc;
+                break;
+
+            case PortQueryConfigDesc:
+
+                configDesc = (PUSB_CONFIGURATION_DESCRIPTOR)
+                    ((PUSB_DESCRIPTOR_REQUEST)Query->Buffer + 1);
+
+                if (Success &&
+                    Query->BytesReturned == Query->BufferSize &&
+                    configDesc->wTotalLength == Query->BufferSize -
+                                                sizeof(USB_DESCRIPTOR_REQUEST))
+                {
+                    CacheConfigLength(&connectionInfoEx->DeviceDescriptor,
+                                      configDesc->wTotalLength);
+
+                    Query->ConfigDesc = (PUSB_DESCRIPTOR_REQUEST)Query->Buffer;
+                }
+                else
+                {
+                    OOPS();
+                    FREE(Query->Buffer);
+                }
+
+                Query->Buffer = NULL;
+                Query->Step = PortQueryGetStrings;
+                continue;
+
+            case PortQueryGetStrings:
+
+                // Parse the Configuration Descriptor once for everything
+                // that looks at it later, see GetConfigDescriptor()
+                //
+                if (Query->ConfigDesc != NULL &&
+                    !IndexConfigDesc(&Query->ConfigDesc))
+                {
+                    FREE(Query->ConfigDesc);
+                    Query->ConfigDesc = NULL;
+                }
+
+                // Start with String Descriptor 0, the supported languages
+                //
+                if (Query->ConfigDesc == NULL ||
+                    !AreThereStringDescriptors(
+                        &connectionInfoEx->DeviceDescriptor,
+                        Query->ConfigDesc))
+                {
+                    Query->Step = PortQueryGetQualifier;
+                    continue;
+                }
+
+                requestSize = sizeof(Query->Scratch.DescriptorRequest);
+                request = Query->Scratch.DescriptorRequest;
+
+                InitDescriptorRequest(request,
+                                      requestSize,
+                                      Query->ConnectionIndex,
+                                      USB_STRING_DESCRIPTOR_TYPE,
+                                      0,
+                                      0);
+
+                ioControlCode = IOCTL_USB_GET_DESCRIPTOR_FROM_NODE_CONNECTION;
+                Query->Step = PortQueryLanguageIDs;
+                break;
+
+            case PortQueryLanguageIDs:
+
+                Query->Step = PortQueryGetQualifier;
+
+                if (!Success)
+                {
+                    OOPS();
+                    continue;
+                }
+
+                if (!AddRequestedStringDescriptor(
+                        &Query->StringDescs,
+                        (PUSB_DESCRIPTOR_REQUEST)Query->Scratch.DescriptorRequest,
+                        Query->BytesReturned,
+                        0,
+                        0))
+                {
+                    continue;
+                }
+
+                Query->StringDescs->RequestsSent = 1;
+
+                // Then every string in every selected language, in the
+                // same order as GetAllStringDescriptors()
+                //
+                numIndexes = GetStringDescriptorIndexes(
+                    &connectionInfoEx->DeviceDescriptor,
+                    Query->ConfigDesc,
+                    NULL,
+                    NULL);
+
+                if (numIndexes == 0)
+                {
+                    continue;
+                }
+
+                Query->StringIndexes = (PUCHAR)ALLOC(numIndexes);
+
+                if (Query->StringIndexes == NULL)
+                {
+                    OOPS();
+                    continue;
+                }
+
+                GetStringDescriptorIndexes(
+                    &connectionInfoEx->DeviceDescriptor,
+                    Query->ConfigDesc,
+                    Query->StringIndexes,
+                    &numDuplicates);
+
+                languagesDesc = FindStringDescriptor(Query->StringDescs, 0, 0);
+
+                numLanguageIDs = (languagesDesc->bLength - 2) / 2;
+
+                Query->NumLanguageIDs = SelectStringLanguages(
+                    Query->Context,
+                    &languagesDesc->bString[0],
+                    numLanguageIDs,
+                    Query->LanguageIDs);
+
+                CountStringRequests(Query->StringDescs,
+                                    numIndexes,
+                                    numDuplicates,
+                                    numLanguageIDs,
+                                    Query->NumLanguageIDs);
+
+                Query->NumStrings = numIndexes * Query->NumLanguageIDs;
+                Query->NextString = 0;
+                Query->Step = PortQueryGetNextString;
+                continue;
+
+            case PortQueryGetNextString:
+
+                if (Query->NextString == Query->NumStrings)
+                {
+                    Query->Step = PortQueryGetQualifier;
+                    continue;
+                }
+
+                requestSize = sizeof(Query->Scratch.DescriptorRequest);
+                request = Query->Scratch.DescriptorRequest;
+
+                InitDescriptorRequest(request,
+                                      requestSize,
+                                      Query->ConnectionIndex,
+                                      USB_STRING_DESCRIPTOR_TYPE,
+                                      Query->StringIndexes[Query->NextString / Query->NumLanguageIDs],
+                                      Query->LanguageIDs[Query->NextString % Query->NumLanguageIDs]);
+
+                ioControlCode = IOCTL_USB_GET_DESCRIPTOR_FROM_NODE_CONNECTION;
+                Query->Step = PortQueryString;
+                break;
+
+            case PortQueryString:
+
+                if (Success)
+                {
+                    AddRequestedStringDescriptor(
+                        &Query->StringDescs,
+                        (PUSB_DESCRIPTOR_REQUEST)Query->Scratch.DescriptorRequest,
+                        Query->BytesReturned,
+                        Query->StringIndexes[Query->NextString / Query->NumLanguageIDs],
+                        Query->LanguageIDs[Query->NextString % Query->NumLanguageIDs]);
+                }
+                else
+                {
+                    OOPS();
+                }
+
+                Query->NextString++;
+                Query->Step = PortQueryGetNextString;
+                continue;
+
+            case PortQueryGetQualifier:
+
+                // All strings there are have been added by now
+                //
+                TrimStringDescriptors(&Query->StringDescs);
+
+                // See EnumerateHubPorts()
+                //
+                if (!MAY_BE_DOWNGRADED(connectionInfoEx))
+                {
+                    Query->Step = PortQueryGetHubName;
+                    continue;
+                }
+
+                requestSize = sizeof(USB_DESCRIPTOR_REQUEST) +
+                              sizeof(USB_DEVICE_QUALIFIER_DESCRIPTOR);
+                request = Query->Scratch.DescriptorRequest;
+
+                InitDescriptorRequest(request,
+                                      requestSize,
+                                      Query->ConnectionIndex,
+                                      USB_DEVICE_QUALIFIER_DESCRIPTOR_TYPE,
+                                      0,
+                                      0);
+
+                ioControlCode = IOCTL_USB_GET_DESCRIPTOR_FROM_NODE_CONNECTION;
+                Query->Step = PortQueryQualifier;
+                break;
+
+            case PortQueryQualifier:
+
+                // Only a high speed capable device has one, see
+                // GetDeviceQualifierDescriptor()
+                //
+                if (Success)
+                {
+                    Query->QualifierDesc = CopyQualifierDescriptor(
+                        (PUSB_DESCRIPTOR_REQUEST)Query->Scratch.DescriptorRequest,
+                        Query->BytesReturned);
+                }
+
+                Query->Step = PortQueryGetHubName;
+                continue;
+
+            case PortQueryGetHubName:
+
+                // If the device connected to the port is an external hub,
+                // get the name of the external hub.
+                //
+                if (!connectionInfoEx->DeviceIsHub)
+                {
+                    Query->Step = PortQueryDone;
+                    continue;
+                }
+
+                // Ask for the whole name at once, see GetExternalHubName()
+                //
+                memset(&Query->Scratch.HubNameRequest, 0,
+                       sizeof(USB_NODE_CONNECTION_NAME));
+
+                Query->Scratch.HubNameRequest.ConnectionIndex =
+                    Query->ConnectionIndex;
+
+                ioControlCode = IOCTL_USB_GET_NODE_CONNECTION_NAME;
+                request = &Query->Scratch.HubNameRequest;
+                requestSize = sizeof(Query->Scratch.QueryBuffer);
+                Query->Step = PortQueryHubNameFirst;
+                break;
+
+            case PortQueryHubNameFirst:
+
+                requestSize = Query->Scratch.HubNameRequest.ActualLength;
+
+                if (!Success ||
+                    requestSize <= sizeof(USB_NODE_CONNECTION_NAME))
+                {
+                    OOPS();
+                    Query->Step = PortQueryDone;
+                    continue;
+                }
+
+                if (requestSize <= sizeof(Query->Scratch.QueryBuffer))
+                {
+                    Query->ExtHubName = WideStrToMultiStr(
+                        Query->Scratch.HubNameRequest.NodeName);
+
+                    Query->Step = PortQueryDone;
+                    continue;
+                }
+
+                // The name did not fit, get it again with the right size
+                //
+                Query->Buffer = ALLOC(requestSize);
+
+                if (Query->Buffer == NULL)
+                {
+                    OOPS();
+                    Query->Step = PortQueryDone;
+                    continue;
+                }
+
+                ((PUSB_NODE_CONNECTION_NAME)Query->Buffer)->ConnectionIndex =
+                    Query->ConnectionIndex;
+
+                ioControlCode = IOCTL_USB_GET_NODE_CONNECTION_NAME;
+                request = Query->Buffer;
+                Query->Step = PortQueryHubName;
+                break;
+
+            case PortQueryHubName:
+
+                if (Success)
+                {
+                    Query->ExtHubName = WideStrToMultiStr(
+                        ((PUSB_NODE_CONNECTION_NAME)Query->Buffer)->NodeName);
+                }
+                else
+                {
+                    OOPS();
+                }
+
+                FREE(Query->Buffer);
+                Query->Buffer = NULL;
+                Query->Step = PortQueryDone;
+                continue;
+
+            case PortQueryDone:
+            default:
+
+                return;
+        }
+
+        // Send the request for the new step
+        //
+        hEvent = Query->Overlapped.hEvent;
+
+        memset(&Query->Overlapped, 0, sizeof(OVERLAPPED));
+
+        Query->Overlapped.hEvent = hEvent;
+
+        ResetEvent(hEvent);
+
+        Query->BytesReturned = 0;
+
+        Success = BackendDeviceIoControl(hHubDevice,
+                                         ioControlCode,
+                                         request,
+                                         requestSize,
+                                         request,
+                                         requestSize,
+                                         &Query->BytesReturned,
+                                         &Query->Overlapped);
+
+        // A request which completed right away is processed on the next
+        // pass through the loop
+        //
+        if (!Success && GetLastError() == ERROR_IO_PENDING)
+        {
+            Query->Pending = TRUE;
+            return;
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// FinishPortQuery()
+//
+// Adds a port whose requests have all completed to its tree node.
+//
+//*****************************************************************************
+
+VOID
+FinishPortQuery (
+    PPORT_QUERY Query
+)
+{
+    if (Query->StringIndexes != NULL)
+    {
+        FREE(Query->StringIndexes);
+        Query->StringIndexes = NULL;
+    }
+
+    if (Query->ConnectionInfo == NULL)
+    {
+        // The connection info could not be read, the node stays empty
+        // and is left out of the tree view
+        //
+        return;
+    }
+
+    if (!Query->Cached && Query->Node != NULL)
+    {
+        UpdateDescriptorCache(GetParentHubName(Query->Node),
+                              Query->ConnectionInfo,
+                              Query->DriverKeyName,
+                              Query->ConfigDesc,
+                              Query->StringDescs,
+                              Query->QualifierDesc,
+                              Query->ExtHubName);
+    }
+
+    AddHubPort(Query->Context,
+               Query->Node,
+               Query->ConnectionInfo,
+               Query->DriverKeyName,
+               Query->ConfigDesc,
+               Query->StringDescs,
+               Query->QualifierDesc,
+               Query->ExtHubName);
+
+    Query->ConnectionInfo = NULL;
+}
+
+//*****************************************************************************
+//
+// AddHubPort()
+//
+// Context - Enumeration the hub is part of.
+//
+// Node - Tree node reserved for the port, or NULL if that failed.
+//
+// ConnectionInfoEx - Connection info for the port.
+//
+// DriverKeyName - Driver key of the connected device, or NULL.
+//
+// ConfigDesc, StringDescs - Descriptors of the connected device, or NULL.
+//
+// ExtHubName - Name of the connected hub, or NULL.
+//
+// Fills in Node, or queues the hub for enumeration.  This takes ownership
+// of everything passed in, whether or not the port could be added.
+//
+//*****************************************************************************
+
+VOID
+AddHubPort (
+    PENUM_CONTEXT                       Context,
+    PUSBTREENODE                        Node,
+    PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfoEx,
+    __in_opt PTSTR                      DriverKeyName,
+    __in_opt PUSB_DESCRIPTOR_REQUEST    ConfigDesc,
+    __in_opt PSTRING_DESCRIPTORS        StringDescs,
+    __in_opt PUSB_DEVICE_QUALIFIER_DESCRIPTOR QualifierDesc,
+    __in_opt PTSTR                      ExtHubName
+)
+{
+    PUSBDEVICEINFO  info;
+    PTSTR           deviceDesc;
+    TCHAR           deviceDescBuf[MAX_DEVICE_ID_LEN];
+    TCHAR           leafName[512]; // XXXXX how big does this have to be?
+    int             icon;
+
+    // Update the count of connected devices
+    //
+    if (ConnectionInfoEx->ConnectionStatus == DeviceConnected)
+    {
+        InterlockedIncrement(&Context->Snapshot->DevicesConnected);
+    }
+
+    if (ConnectionInfoEx->DeviceIsHub)
+    {
+        InterlockedIncrement(&Context->Snapshot->Hubs);
+    }
+
+    // Get the Device Description from the driver key name
+    //
+    deviceDesc = NULL;
+    if (DriverKeyName)
+    {
+        if (GetDevNodeString(Context->DevNodeIndex,
+                             DriverKeyName,
+                             FALSE,
+                             deviceDescBuf,
+                             sizeof(deviceDescBuf)/sizeof(deviceDescBuf[0])))
+        {
+            deviceDesc = deviceDescBuf;
+        }
+
+        FREE(DriverKeyName);
+    }
+
+    if (Node == NULL)
+    {
+        OOPS();
+    }
+    else if (ConnectionInfoEx->DeviceIsHub)
+    {
+        // The device connected to the port is an external hub, queue it
+        // to be enumerated.
+        //
+        if (ExtHubName != NULL &&
+            QueueHubEnumeration(Context,
+                                Node,
+                                ExtHubName,
+                                ConnectionInfoEx,
+                                ConfigDesc,
+                                StringDescs,
+                                QualifierDesc,
+                                deviceDesc))
+        {
+            return;
+        }
+    }
+    else
+    {
+        // Allocate some space for a USBDEVICEINFO structure to hold the
+        // Config Descriptors, Strings Descriptors, and connection info
+        // pointers.  GPTR zero initializes the structure for us.
+        //
+        info = (PUSBDEVICEINFO) ALLOC(sizeof(USBDEVICEINFO));
+
+        if (info == NULL)
+        {
+            OOPS();
+        }
+        else
+        {
+            info->DeviceInfoType = DeviceInfo;
+
+            info->ConnectionInfo = ConnectionInfoEx;
+
+            info->ConfigDesc = ConfigDesc;
+
+            info->StringDescs = StringDescs;
+
+            info->QualifierDesc = QualifierDesc;
+
+            info->ParentHubName = GetParentHubName(Node);
+
+            info->LazyDescriptors = LAZY_DESCRIPTORS(Context, ConnectionInfoEx);
+
+            _stprintf_s(leafName, sizeof(leafName)/sizeof(leafName[0]), _T("[Port%d] "), ConnectionInfoEx->ConnectionIndex);
+
+            _tcscat_s(leafName, sizeof(leafName)/sizeof(leafName[0]), ConnectionStatuses[ConnectionInfoEx->ConnectionStatus]);
+
+            if (deviceDesc)
+            {
+                _tcscat_s(leafName, sizeof(leafName)/sizeof(leafName[0]), _T(" :  "));
+                _tcscat_s(leafName, sizeof(leafName)/sizeof(leafName[0]), deviceDesc);
+            }
+
+            if (ConnectionInfoEx->ConnectionStatus == NoDeviceConnected)
+            {
+                icon = NoDeviceIcon;
+            }
+            else if (ConnectionInfoEx->CurrentConfigurationValue)
+            {
+                icon = GoodDeviceIcon;
+            }
+            else
+            {
+                icon = BadDeviceIcon;
+            }
+
+            if (!SetTreeNode(Node,
+                             info,
+                             leafName,
+                             icon))
+            {
+                OOPS();
+                FreeDeviceInfo(info);
+            }
+
+            return;
+        }
+    }
+
+    // The port could not be added, free everything
+    //
+    if (ExtHubName)
+    {
+        FREE(ExtHubName);
+    }
+
+    if (ConfigDesc)
+    {
+        FREE(ConfigDesc);
+    }
+
+    FreeStringDescriptors(StringDescs);
+
+    if (QualifierDesc)
+    {
+        FREE(QualifierDesc);
+    }
+
+    FREE(ConnectionInfoEx);
+}
+
+//*****************************************************************************
+//
+// ConnectionInfoToEx()
+//
+// Copies what IOCTL_USB_GET_NODE_CONNECTION_INFORMATION returned into a
+// USB_NODE_CONNECTION_INFORMATION_EX structure.  Both must have room for
+// 30 pipes.
+//
+//*****************************************************************************
+
+VOID
+ConnectionInfoToEx (
+    PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfoEx,
+    PUSB_NODE_CONNECTION_INFORMATION    ConnectionInfo
+)
+{
+    ConnectionInfoEx->ConnectionIndex =
+        ConnectionInfo->ConnectionIndex;
+
+    ConnectionInfoEx->DeviceDescriptor =
+        ConnectionInfo->DeviceDescriptor;
+
+    ConnectionInfoEx->CurrentConfigurationValue =
+        ConnectionInfo->CurrentConfigurationValue;
+
+    ConnectionInfoEx->Speed =
+        ConnectionInfo->LowSpeed ? UsbLowSpeed : UsbFullSpeed;
+
+    ConnectionInfoEx->DeviceIsHub =
+        ConnectionInfo->DeviceIsHub;
+
+    ConnectionInfoEx->DeviceAddress =
+        ConnectionInfo->DeviceAddress;
+
+    ConnectionInfoEx->NumberOfOpenPipes =
+        ConnectionInfo->NumberOfOpenPipes;
+
+    ConnectionInfoEx->ConnectionStatus =
+        ConnectionInfo->ConnectionStatus;
+
+    memcpy(&ConnectionInfoEx->PipeList[0],
+           &ConnectionInfo->PipeList[0],
+           sizeof(USB_PIPE_INFO) * 30);
+}
+
+//*****************************************************************************
+//
+// GetParentHubName()
+//
+// Node - Tree node of a hub port, whose parent is the node of the hub.
+//
+// Returns the name of that hub, which is owned by the info of its node.
+//
+//*****************************************************************************
+
+PTSTR
+GetParentHubName (
+    PUSBTREENODE    Node
+)
+{
+    return GetHubNodeName(Node->Parent);
+}
+
+//*****************************************************************************
+//
+// GetHubNodeName()
+//
+// HubNode - Tree node of a hub, or NULL.
+//
+// Returns the name of the hub, which is owned by the info of its node.
+//
+//*****************************************************************************
+
+PTSTR
+GetHubNodeName (
+    PUSBTREENODE    HubNode
+)
+{
+    PVOID   info;
+
+    if (HubNode == NULL || HubNode->Info == NULL)
+    {
+        return NULL;
+    }
+
+    info = HubNode->Info;
+
+    switch (*(PUSBDEVICEINFOTYPE)info)
+    {
+        case RootHubInfo:
+            return ((PUSBROOTHUBINFO)info)->HubName;
+
+        case ExternalHubInfo:
+            return ((PUSBEXTERNALHUBINFO)info)->HubName;
+
+        default:
+            return NULL;
+    }
+}
+
+//*****************************************************************************
+//
+// GetLazyDescriptorFields()
+//
+// Returns FALSE if Info is not the info of a device on a hub port, which
+// has no lazy descriptors.
+//
+//*****************************************************************************
+
+BOOL
+GetLazyDescriptorFields (
+    PVOID                                   Info,
+    PUSB_NODE_CONNECTION_INFORMATION_EX     *ConnectionInfo,
+    PUSB_DESCRIPTOR_REQUEST                 **ConfigDesc,
+    PSTRING_DESCRIPTORS                     **StringDescs,
+    PTSTR                                   *HubName,
+    PBOOL                                   *Lazy,
+    PULONG                                  *LazyRequest
+)
+{
+    switch (*(PUSBDEVICEINFOTYPE)Info)
+    {
+        case ExternalHubInfo:
+            *ConnectionInfo = ((PUSBEXTERNALHUBINFO)Info)->ConnectionInfo;
+            *ConfigDesc = &((PUSBEXTERNALHUBINFO)Info)->ConfigDesc;
+            *StringDescs = &((PUSBEXTERNALHUBINFO)Info)->StringDescs;
+            *HubName = ((PUSBEXTERNALHUBINFO)Info)->ParentHubName;
+            *Lazy = &((PUSBEXTERNALHUBINFO)Info)->LazyDescriptors;
+            *LazyRequest = &((PUSBEXTERNALHUBINFO)Info)->LazyRequest;
+            return TRUE;
+
+        case DeviceInfo:
+            *ConnectionInfo = ((PUSBDEVICEINFO)Info)->ConnectionInfo;
+            *ConfigDesc = &((PUSBDEVICEINFO)Info)->ConfigDesc;
+            *StringDescs = &((PUSBDEVICEINFO)Info)->StringDescs;
+            *HubName = ((PUSBDEVICEINFO)Info)->ParentHubName;
+            *Lazy = &((PUSBDEVICEINFO)Info)->LazyDescriptors;
+            *LazyRequest = &((PUSBDEVICEINFO)Info)->LazyRequest;
+            return TRUE;
+
+        default:
+            return FALSE;
+    }
+}
+
+//*****************************************************************************
+//
+// GetLazyDescriptors()
+//
+// Info - Info of the tree item about to be written out.
+//
+// With DoLazyDesc, enumeration leaves out the Configuration and String
+// Descriptors of connected devices.  They are fetched here the first time
+// they are needed, and kept in its info from then on, in the languages
+// chosen for the program now.
+//
+// This waits for the device, the detail view uses RequestLazyDescriptors()
+// instead.  A fetch it queued which comes back after this is dropped.
+//
+//*****************************************************************************
+
+VOID
+GetLazyDescriptors (
+    PVOID   Info
+)
+{
+    PUSB_NODE_CONNECTION_INFORMATION_EX connectionInfo;
+    PUSB_DESCRIPTOR_REQUEST             *configDesc;
+    PSTRING_DESCRIPTORS                 *stringDescs;
+    PTSTR                               hubName;
+    PBOOL                               lazy;
+    PULONG                              lazyRequest;
+    LAZY_DESC_REQUEST                   request;
+
+    if (!GetLazyDescriptorFields(Info,
+                                 &connectionInfo,
+                                 &configDesc,
+                                 &stringDescs,
+                                 &hubName,
+                                 &lazy,
+                                 &lazyRequest))
+    {
+        return;
+    }
+
+    // Only try once, whether or not it works
+    //
+    if (!*lazy)
+    {
+        return;
+    }
+
+    if (hubName == NULL || *configDesc != NULL)
+    {
+        *lazy = FALSE;
+        return;
+    }
+
+    memset(&request, 0, sizeof(request));
+
+    request.Request = *lazyRequest;
+    request.HubName = hubName;
+    request.ConnectionIndex = connectionInfo->ConnectionIndex;
+    request.DeviceDescriptor = connectionInfo->DeviceDescriptor;
+
+    FetchLazyDescriptors(&request);
+
+    TakeLazyDescriptors(Info, &request);
+}
+
+//*****************************************************************************
+//
+// RequestLazyDescriptors()
+//
+// Info - Info of the tree item about to be displayed.
+//
+// Like GetLazyDescriptors(), but the enumeration thread fetches them and
+// posts them to the window, which hands them to TakeLazyDescriptors().
+// Returns FALSE if they are not in Info yet.  Without the enumeration
+// thread they are fetched right away.
+//
+//*****************************************************************************
+
+BOOL
+RequestLazyDescriptors (
+    PVOID   Info
+)
+{
+    PUSB_NODE_CONNECTION_INFORMATION_EX connectionInfo;
+    PUSB_DESCRIPTOR_REQUEST             *configDesc;
+    PSTRING_DESCRIPTORS                 *stringDescs;
+    PTSTR                               hubName;
+    PBOOL                               lazy;
+    PULONG                              lazyRequest;
+    PLAZY_DESC_REQUEST                  request;
+    size_t                              hubNameSize;
+
+    if (!GetLazyDescriptorFields(Info,
+                                 &connectionInfo,
+                                 &configDesc,
+                                 &stringDescs,
+                                 &hubName,
+                                 &lazy,
+                                 &lazyRequest))
+    {
+        return TRUE;
+    }
+
+    if (!*lazy)
+    {
+        return TRUE;
+    }
+
+    // Already queued
+    //
+    if (*lazyRequest != 0)
+    {
+        return FALSE;
+    }
+
+    if (hubName == NULL || *configDesc != NULL)
+    {
+        *lazy = FALSE;
+        return TRUE;
+    }
+
+    // The hub name is copied, the info of the hub may be gone by the time
+    // the enumeration thread gets to it
+    //
+    hubNameSize = _tcslen(hubName) + 1;
+
+    request = (PLAZY_DESC_REQUEST)ALLOC(sizeof(LAZY_DESC_REQUEST));
+
+    if (request != NULL)
+    {
+        request->HubName = (PTSTR)ALLOC(hubNameSize * sizeof(TCHAR));
+    }
+
+    if (request == NULL || request->HubName == NULL)
+    {
+        OOPS();
+
+        if (request != NULL)
+        {
+            FREE(request);
+        }
+
+        GetLazyDescriptors(Info);
+        return TRUE;
+    }
+
+    _tcscpy_s(request->HubName, hubNameSize, hubName);
+
+    // Numbered so what comes back is only taken by the info which asked,
+    // not by another one which got the same address after a refresh
+    //
+    if (++LazyRequests == 0)
+    {
+        LazyRequests = 1;
+    }
+
+    request->Info = Info;
+    request->Request = LazyRequests;
+    request->ConnectionIndex = connectionInfo->ConnectionIndex;
+    request->DeviceDescriptor = connectionInfo->DeviceDescriptor;
+
+    if (!QueueLazyDescriptors(request))
+    {
+        FreeLazyDescriptors(request);
+
+        GetLazyDescriptors(Info);
+        return TRUE;
+    }
+
+    *lazyRequest = request->Request;
+
+    return FALSE;
+}
+
+//*****************************************************************************
+//
+// FetchLazyDescriptors()
+//
+// Request - Which device, ConfigDesc and StringDescs are set to what it
+// returns.  Touches nothing but Request, so it runs on any thread.
+//
+//*****************************************************************************
+
+VOID
+FetchLazyDescriptors (
+    PLAZY_DESC_REQUEST  Request
+)
+{
+    PTSTR           deviceName;
+    size_t          deviceNameSize;
+    HANDLE          hHubDevice;
+    ENUM_CONTEXT    context;
+
+    // Open the hub the device is connected to, see EnumerateHub()
+    //
+    deviceNameSize = _tcslen(Request->HubName) + _tcslen(_T("\\\\.\\")) + 1;
+    deviceName = (PTSTR)ALLOC(deviceNameSize * sizeof(TCHAR));
+
+    if (deviceName == NULL)
+    {
+        OOPS();
+        return;
+    }
+
+    _tcscpy_s(deviceName, deviceNameSize, _T("\\\\.\\"));
+    _tcscat_s(deviceName, deviceNameSize, Request->HubName);
+
+    hHubDevice = BackendOpenDevice(deviceName, 0);
+
+    FREE(deviceName);
+
+    if (hHubDevice == INVALID_HANDLE_VALUE)
+    {
+        OOPS();
+        return;
+    }
+
+    InitEnumContext(&context, NULL);
+
+    Request->ConfigDesc = GetConfigDescriptor(hHubDevice,
+                                              Request->ConnectionIndex,
+                                              0,
+                                              &Request->DeviceDescriptor);
+
+    if (Request->ConfigDesc != NULL &&
+        AreThereStringDescriptors(&Request->DeviceDescriptor,
+                                  Request->ConfigDesc))
+    {
+        Request->StringDescs = GetAllStringDescriptors(
+                                   &context,
+                                   hHubDevice,
+                                   Request->ConnectionIndex,
+                                   &Request->DeviceDescriptor,
+                                   Request->ConfigDesc);
+    }
+
+    BackendCloseDevice(hHubDevice);
+
+    // Outside of an enumeration nothing else frees the query buffers
+    //
+    FreeQueryBufferPool();
+}
+
+//*****************************************************************************
+//
+// TakeLazyDescriptors()
+//
+// Info - Info the descriptors fetched for Request may be for.
+//
+// Moves them into Info if it is the one which asked for them, in which
+// case TRUE is returned.  What is not taken is left in Request.
+//
+//*****************************************************************************
+
+BOOL
+TakeLazyDescriptors (
+    PVOID               Info,
+    PLAZY_DESC_REQUEST  Request
+)
+{
+    PUSB_NODE_CONNECTION_INFORMATION_EX connectionInfo;
+    PUSB_DESCRIPTOR_REQUEST             *configDesc;
+    PSTRING_DESCRIPTORS                 *stringDescs;
+    PTSTR                               hubName;
+    PBOOL                               lazy;
+    PULONG                              lazyRequest;
+
+    if (!GetLazyDescriptorFields(Info,
+                                 &connectionInfo,
+                                 &configDesc,
+                                 &stringDescs,
+                                 &hubName,
+                                 &lazy,
+                                 &lazyRequest) ||
+        !*lazy ||
+        *lazyRequest != Request->Request)
+    {
+        return FALSE;
+    }
+
+    *lazy = FALSE;
+    *lazyRequest = 0;
+
+    if (*configDesc == NULL)
+    {
+        *configDesc = Request->ConfigDesc;
+        *stringDescs = Request->StringDescs;
+
+        Request->ConfigDesc = NULL;
+        Request->StringDescs = NULL;
+    }
+
+    // Keep them for the next refresh as well
+    //
+    UpdateDescriptorCache(hubName,
+                          connectionInfo,
+                          NULL,
+                          *configDesc,
+                          *stringDescs,
+                          NULL,
+                          NULL);
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// FreeLazyDescriptors()
+//
+// Frees Request along with what was not taken from it.
+//
+//*****************************************************************************
+
+VOID
+FreeLazyDescriptors (
+    PLAZY_DESC_REQUEST  Request
+)
+{
+    if (Request->ConfigDesc != NULL)
+    {
+        FREE(Request->ConfigDesc);
+    }
+
+    FreeStringDescriptors(Request->StringDescs);
+
+    if (Request->HubName != NULL)
+    {
+        FREE(Request->HubName);
+    }
+
+    FREE(Request);
+}
+
+
+//*****************************************************************************
+//
+// WideStrToMultiStr()
+//
+//*****************************************************************************
+
+PTSTR WideStrToMultiStr (__in LPCWSTR WideStr)
+{
+    // Is there a better way to do this?
+#if defined(_UNICODE) //  If this is built for UNICODE, just clone the input
+    ULONG nChars;
+    PTSTR RetStr;
+
+    nChars = wcslen(WideStr) + 1;
+    RetStr = ALLOC(nChars * sizeof(TCHAR));
+    if (RetStr == NULL)
+    {
+        return NULL;
+    }
+    _tcscpy_s(RetStr, nChars, WideStr);
+    return RetStr;
+    
+
+#else //  convert
+    ULONG nBytes;
+    PTSTR MultiStr;
+    
+    // Get the length of the converted string
+    //
+    nBytes = WideCharToMultiByte(
+                 CP_ACP,
+                 0,
+                 WideStr,
+                 -1,
+                 NULL,
+                 0,
+                 NULL,
+                 NULL);
+
+    if (nBytes == 0)
+    {
+        return NULL;
+    }
+
+    // Allocate space to hold the converted string
+    //
+    MultiStr = ALLOC(nBytes);
 
     if (MultiStr == NULL)
     {
@@ -1187,68 +3283,85 @@ PTSTR GetRootHubName (
 {
     BOOL                success;
     ULONG               nBytes;
-    USB_ROOT_HUB_NAME   rootHubName;
+    PUSB_ROOT_HUB_NAME  rootHubName;
     PUSB_ROOT_HUB_NAME  rootHubNameW;
     PTSTR               rootHubNameA;
 
+    rootHubName = NULL;
     rootHubNameW = NULL;
     rootHubNameA = NULL;
 
-    // Get the length of the name of the Root Hub attached to the
-    // Host Controller
-    // ȡӵĸƳ
-    success = DeviceIoControl(HostController,
-                              IOCTL_USB_GET_ROOT_HUB_NAME,
-                              0,
-                              0,
-                              &rootHubName,
-                              sizeof(rootHubName),
-                              &nBytes,
-                              NULL);
+    // Get the name of the Root Hub attached to the Host Controller, in one
+    // request if it fits in a query buffer.  If not, the request still
+    // returns the length of the name.
+    // ȡĸ
+    rootHubName = AllocQueryBuffer();
 
-    if (!success)
+    if (rootHubName == NULL)
     {
         OOPS();
         goto GetRootHubNameError;
     }
 
-    // Allocate space to hold the Root Hub name
-    // ռ䱣
-    nBytes = rootHubName.ActualLength;
+    success = BackendDeviceIoControl(HostController,
+                                     IOCTL_USB_GET_ROOT_HUB_NAME,
+                                     0,
+                                     0,
+                                     rootHubName,
+                                     QUERY_BUFFER_SIZE,
+                                     &nBytes,
+                                     NULL);
 
-    rootHubNameW = ALLOC(nBytes);
-
-    if (rootHubNameW == NULL)
+    if (!success)
     {
         OOPS();
         goto GetRootHubNameError;
     }
 
-    // Get the name of the Root Hub attached to the Host Controller
-    // ȡĸ
-    success = DeviceIoControl(HostController,
-                              IOCTL_USB_GET_ROOT_HUB_NAME,
-                              NULL,
-                              0,
-                              rootHubNameW,
-                              nBytes,
-                              &nBytes,
-                              NULL);
+    nBytes = rootHubName->ActualLength;
 
-    if (!success)
+    if (nBytes <= QUERY_BUFFER_SIZE)
     {
-        OOPS();
-        goto GetRootHubNameError;
+        // Convert the Root Hub name
+        // ת
+        rootHubNameA = WideStrToMultiStr(rootHubName->RootHubName);
     }
+    else
+    {
+        // Allocate space to hold the Root Hub name
+        // ռ䱣
+        rootHubNameW = ALLOC(nBytes);
+
+        if (rootHubNameW == NULL)
+        {
+            OOPS();
+            goto GetRootHubNameError;
+        }
+
+        success = BackendDeviceIoControl(HostController,
+                                         IOCTL_USB_GET_ROOT_HUB_NAME,
+                                         NULL,
+                                         0,
+                                         rootHubNameW,
+                                         nBytes,
+                                         &nBytes,
+                                         NULL);
+
+        if (!success)
+        {
+            OOPS();
+            goto GetRootHubNameError;
+        }
 
-    // Convert the Root Hub name
-    // ת
-    rootHubNameA = WideStrToMultiStr(rootHubNameW->RootHubName);
+        rootHubNameA = WideStrToMultiStr(rootHubNameW->RootHubName);
 
-    // All done, free the uncoverted Root Hub name and return the
-    // converted Root Hub name
+        FREE(rootHubNameW);
+    }
+
+    // All done, give back the query buffer and return the converted Root
+    // Hub name
     // ͷδתĸֲתĸ
-    FREE(rootHubNameW);
+    FreeQueryBuffer(rootHubName);
 
     return rootHubNameA;
 
@@ -1262,10 +3375,15 @@ GetRootHubNameError:
         rootHubNameW = NULL;
     }
 
+    if (rootHubName != NULL)
+    {
+        FreeQueryBuffer(rootHubName);
+        rootHubName = NULL;
+    }
+
     return NULL;
 }
 
-
 //*****************************************************************************
 //
 // GetExternalHubName()
@@ -1279,78 +3397,97 @@ PTSTR GetExternalHubName (
 {
     BOOL                        success;
     ULONG                       nBytes;
-    USB_NODE_CONNECTION_NAME	extHubName;
+    PUSB_NODE_CONNECTION_NAME   extHubName;
     PUSB_NODE_CONNECTION_NAME   extHubNameW;
     PTSTR                       extHubNameA;
 
+    extHubName = NULL;
     extHubNameW = NULL;
     extHubNameA = NULL;
 
-    // Get the length of the name of the external hub attached to the
-    // specified port.
+    // Get the name of the external hub attached to the specified port, in
+    // one request if it fits in a query buffer.  If not, the request still
+    // returns the length of the name.
     //
-    extHubName.ConnectionIndex = ConnectionIndex;
-
-    success = DeviceIoControl(Hub,
-                              IOCTL_USB_GET_NODE_CONNECTION_NAME,
-                              &extHubName,
-                              sizeof(extHubName),
-                              &extHubName,
-                              sizeof(extHubName),
-                              &nBytes,
-                              NULL);
+    extHubName = AllocQueryBuffer();
 
-    if (!success)
+    if (extHubName == NULL)
     {
         OOPS();
         goto GetExternalHubNameError;
     }
 
-    // Allocate space to hold the external hub name
-    //
-    nBytes = extHubName.ActualLength;
+    memset(extHubName, 0, sizeof(USB_NODE_CONNECTION_NAME));
+
+    extHubName->ConnectionIndex = ConnectionIndex;
+
+    success = BackendDeviceIoControl(Hub,
+                                     IOCTL_USB_GET_NODE_CONNECTION_NAME,
+                                     extHubName,
+                                     QUERY_BUFFER_SIZE,
+                                     extHubName,
+                                     QUERY_BUFFER_SIZE,
+                                     &nBytes,
+                                     NULL);
 
-    if (nBytes <= sizeof(extHubName))
+    if (!success)
     {
         OOPS();
         goto GetExternalHubNameError;
     }
 
-    extHubNameW = ALLOC(nBytes);
+    nBytes = extHubName->ActualLength;
 
-    if (extHubNameW == NULL)
+    if (nBytes <= sizeof(USB_NODE_CONNECTION_NAME))
     {
         OOPS();
         goto GetExternalHubNameError;
     }
 
-    // Get the name of the external hub attached to the specified port
-    //
-    extHubNameW->ConnectionIndex = ConnectionIndex;
-
-    success = DeviceIoControl(Hub,
-                              IOCTL_USB_GET_NODE_CONNECTION_NAME,
-                              extHubNameW,
-                              nBytes,
-                              extHubNameW,
-                              nBytes,
-                              &nBytes,
-                              NULL);
-
-    if (!success)
+    if (nBytes <= QUERY_BUFFER_SIZE)
     {
-        OOPS();
-        goto GetExternalHubNameError;
+        // Convert the External Hub name
+        //
+        extHubNameA = WideStrToMultiStr(extHubName->NodeName);
     }
+    else
+    {
+        // Allocate space to hold the external hub name and get it again
+        //
+        extHubNameW = ALLOC(nBytes);
 
-    // Convert the External Hub name
-    //
-    extHubNameA = WideStrToMultiStr(extHubNameW->NodeName);
+        if (extHubNameW == NULL)
+        {
+            OOPS();
+            goto GetExternalHubNameError;
+        }
+
+        extHubNameW->ConnectionIndex = ConnectionIndex;
+
+        success = BackendDeviceIoControl(Hub,
+                                         IOCTL_USB_GET_NODE_CONNECTION_NAME,
+                                         extHubNameW,
+                                         nBytes,
+                                         extHubNameW,
+                                         nBytes,
+                                         &nBytes,
+                                         NULL);
+
+        if (!success)
+        {
+            OOPS();
+            goto GetExternalHubNameError;
+        }
+
+        extHubNameA = WideStrToMultiStr(extHubNameW->NodeName);
+
+        FREE(extHubNameW);
+    }
 
-    // All done, free the uncoverted external hub name and return the
-    // converted external hub name
+    // All done, give back the query buffer and return the converted
+    // external hub name
     //
-    FREE(extHubNameW);
+    FreeQueryBuffer(extHubName);
 
     return extHubNameA;
 
@@ -1364,10 +3501,15 @@ GetExternalHubNameError:
         extHubNameW = NULL;
     }
 
+    if (extHubName != NULL)
+    {
+        FreeQueryBuffer(extHubName);
+        extHubName = NULL;
+    }
+
     return NULL;
 }
 
-
 //*****************************************************************************
 //
 // GetDriverKeyName()
@@ -1381,79 +3523,97 @@ PTSTR GetDriverKeyName (
 {
     BOOL                                success;
     ULONG                               nBytes;
-    USB_NODE_CONNECTION_DRIVERKEY_NAME  driverKeyName;
+    PUSB_NODE_CONNECTION_DRIVERKEY_NAME driverKeyName;
     PUSB_NODE_CONNECTION_DRIVERKEY_NAME driverKeyNameW;
     PTSTR                               driverKeyNameA;
 
+    driverKeyName = NULL;
     driverKeyNameW = NULL;
     driverKeyNameA = NULL;
 
-    // Get the length of the name of the driver key of the device attached to
-    // the specified port.
+    // Get the name of the driver key of the device attached to the
+    // specified port, in one request if it fits in a query buffer.  If
+    // not, the request still returns the length of the name.
     //
-    driverKeyName.ConnectionIndex = ConnectionIndex;
+    driverKeyName = AllocQueryBuffer();
 
-    success = DeviceIoControl(Hub,
-                              IOCTL_USB_GET_NODE_CONNECTION_DRIVERKEY_NAME,
-                              &driverKeyName,
-                              sizeof(driverKeyName),
-                              &driverKeyName,
-                              sizeof(driverKeyName),
-                              &nBytes,
-                              NULL);
-
-    if (!success)
+    if (driverKeyName == NULL)
     {
         OOPS();
         goto GetDriverKeyNameError;
     }
 
-    // Allocate space to hold the driver key name
-    //
-    nBytes = driverKeyName.ActualLength;
+    memset(driverKeyName, 0, sizeof(USB_NODE_CONNECTION_DRIVERKEY_NAME));
+
+    driverKeyName->ConnectionIndex = ConnectionIndex;
 
-    if (nBytes <= sizeof(driverKeyName))
+    success = BackendDeviceIoControl(Hub,
+                                     IOCTL_USB_GET_NODE_CONNECTION_DRIVERKEY_NAME,
+                                     driverKeyName,
+                                     QUERY_BUFFER_SIZE,
+                                     driverKeyName,
+                                     QUERY_BUFFER_SIZE,
+                                     &nBytes,
+                                     NULL);
+
+    if (!success)
     {
         OOPS();
         goto GetDriverKeyNameError;
     }
 
-    driverKeyNameW = ALLOC(nBytes);
+    nBytes = driverKeyName->ActualLength;
 
-    if (driverKeyNameW == NULL)
+    if (nBytes <= sizeof(USB_NODE_CONNECTION_DRIVERKEY_NAME))
     {
         OOPS();
         goto GetDriverKeyNameError;
     }
 
-    // Get the name of the driver key of the device attached to
-    // the specified port.
-    //
-    driverKeyNameW->ConnectionIndex = ConnectionIndex;
+    if (nBytes <= QUERY_BUFFER_SIZE)
+    {
+        // Convert the driver key name
+        //
+        driverKeyNameA = WideStrToMultiStr(driverKeyName->DriverKeyName);
+    }
+    else
+    {
+        // Allocate space to hold the driver key name and get it again
+        //
+        driverKeyNameW = ALLOC(nBytes);
+
+        if (driverKeyNameW == NULL)
+        {
+            OOPS();
+            goto GetDriverKeyNameError;
+        }
+
+        driverKeyNameW->ConnectionIndex = ConnectionIndex;
+
+        success = BackendDeviceIoControl(Hub,
+                                         IOCTL_USB_GET_NODE_CONNECTION_DRIVERKEY_NAME,
+                                         driverKeyNameW,
+                                         nBytes,
+                                         driverKeyNameW,
+                                         nBytes,
+                                         &nBytes,
+                                         NULL);
+
+        if (!success)
+        {
+            OOPS();
+            goto GetDriverKeyNameError;
+        }
 
-    success = DeviceIoControl(Hub,
-                              IOCTL_USB_GET_NODE_CONNECTION_DRIVERKEY_NAME,
-                              driverKeyNameW,
-                              nBytes,
-                              driverKeyNameW,
-                              nBytes,
-                              &nBytes,
-                              NULL);
+        driverKeyNameA = WideStrToMultiStr(driverKeyNameW->DriverKeyName);
 
-    if (!success)
-    {
-        OOPS();
-        goto GetDriverKeyNameError;
+        FREE(driverKeyNameW);
     }
 
-    // Convert the driver key name
-    //
-    driverKeyNameA = WideStrToMultiStr(driverKeyNameW->DriverKeyName);
-
-    // All done, free the uncoverted driver key name and return the
-    // converted driver key name
+    // All done, give back the query buffer and return the converted
+    // driver key name
     //
-    FREE(driverKeyNameW);
+    FreeQueryBuffer(driverKeyName);
 
     return driverKeyNameA;
 
@@ -1467,10 +3627,15 @@ GetDriverKeyNameError:
         driverKeyNameW = NULL;
     }
 
+    if (driverKeyName != NULL)
+    {
+        FreeQueryBuffer(driverKeyName);
+        driverKeyName = NULL;
+    }
+
     return NULL;
 }
 
-
 //*****************************************************************************
 //
 // GetHCDDriverKeyName()
@@ -1483,67 +3648,86 @@ PTSTR GetHCDDriverKeyName (
 {
     BOOL                    success;
     ULONG                   nBytes;
-    USB_HCD_DRIVERKEY_NAME  driverKeyName;
+    PUSB_HCD_DRIVERKEY_NAME driverKeyName;
     PUSB_HCD_DRIVERKEY_NAME driverKeyNameW;
     PTSTR                   driverKeyNameA;
 
+    driverKeyName = NULL;
     driverKeyNameW = NULL;
     driverKeyNameA = NULL;
 
-    // ȡHCDԿƵĳ
-    success = DeviceIoControl(HCD,
-                              IOCTL_GET_HCD_DRIVERKEY_NAME,
-                              &driverKeyName,
-                              sizeof(driverKeyName),
-                              &driverKeyName,
-                              sizeof(driverKeyName),
-                              &nBytes,
-                              NULL);
+    // ȡHCDԿ, ŵʱһ󼴿, 󷵻Ƶĳ
+    driverKeyName = AllocQueryBuffer();
 
-    if (!success)
+    if (driverKeyName == NULL)
     {
         OOPS();
         goto GetHCDDriverKeyNameError;
     }
 
-    // ռԿ
-    nBytes = driverKeyName.ActualLength;
+    memset(driverKeyName, 0, sizeof(USB_HCD_DRIVERKEY_NAME));
 
-    if (nBytes <= sizeof(driverKeyName))
+    success = BackendDeviceIoControl(HCD,
+                                     IOCTL_GET_HCD_DRIVERKEY_NAME,
+                                     driverKeyName,
+                                     QUERY_BUFFER_SIZE,
+                                     driverKeyName,
+                                     QUERY_BUFFER_SIZE,
+                                     &nBytes,
+                                     NULL);
+
+    if (!success)
     {
         OOPS();
         goto GetHCDDriverKeyNameError;
     }
 
-    driverKeyNameW = ALLOC(nBytes);
+    nBytes = driverKeyName->ActualLength;
 
-    if (driverKeyNameW == NULL)
+    if (nBytes <= sizeof(USB_HCD_DRIVERKEY_NAME))
     {
         OOPS();
         goto GetHCDDriverKeyNameError;
     }
 
-    // ȡض˿豸Կ
-    success = DeviceIoControl(HCD,
-                              IOCTL_GET_HCD_DRIVERKEY_NAME,
-                              driverKeyNameW,
-                              nBytes,
-                              driverKeyNameW,
-                              nBytes,
-                              &nBytes,
-                              NULL);
-
-    if (!success)
+    if (nBytes <= QUERY_BUFFER_SIZE)
     {
-        OOPS();
-        goto GetHCDDriverKeyNameError;
+        // תԿƸʽ
+        driverKeyNameA = WideStrToMultiStr(driverKeyName->DriverKeyName);
     }
+    else
+    {
+        // ռԿ, Ȼٴλȡ
+        driverKeyNameW = ALLOC(nBytes);
+
+        if (driverKeyNameW == NULL)
+        {
+            OOPS();
+            goto GetHCDDriverKeyNameError;
+        }
 
-    // תԿƸʽ
-    driverKeyNameA = WideStrToMultiStr(driverKeyNameW->DriverKeyName);
+        success = BackendDeviceIoControl(HCD,
+                                         IOCTL_GET_HCD_DRIVERKEY_NAME,
+                                         driverKeyNameW,
+                                         nBytes,
+                                         driverKeyNameW,
+                                         nBytes,
+                                         &nBytes,
+                                         NULL);
 
-    // ɺͷδתԿƸʽ,תԿ
-    FREE(driverKeyNameW);
+        if (!success)
+        {
+            OOPS();
+            goto GetHCDDriverKeyNameError;
+        }
+
+        driverKeyNameA = WideStrToMultiStr(driverKeyNameW->DriverKeyName);
+
+        FREE(driverKeyNameW);
+    }
+
+    // ɺ黹ѯ,תԿ
+    FreeQueryBuffer(driverKeyName);
 
     return driverKeyNameA;
 
@@ -1556,10 +3740,15 @@ GetHCDDriverKeyNameError:
         driverKeyNameW = NULL;
     }
 
+    if (driverKeyName != NULL)
+    {
+        FreeQueryBuffer(driverKeyName);
+        driverKeyName = NULL;
+    }
+
     return NULL;
 }
 
-
 //*****************************************************************************
 //
 // GetConfigDescriptor()
@@ -1572,42 +3761,58 @@ GetHCDDriverKeyNameError:
 //
 // DescriptorIndex - Configuration Descriptor index, zero based.
 //
+// DeviceDesc - Device Descriptor of the attached device.  The length of
+// Configuration Descriptor 0 is remembered for each device model, so it
+// can be requested with the right size the next time.
+//
 //*****************************************************************************
 
 PUSB_DESCRIPTOR_REQUEST
 GetConfigDescriptor (
-    HANDLE  hHubDevice,
-    ULONG   ConnectionIndex,
-    UCHAR   DescriptorIndex
+    HANDLE                  hHubDevice,
+    ULONG                   ConnectionIndex,
+    UCHAR                   DescriptorIndex,
+    PUSB_DEVICE_DESCRIPTOR  DeviceDesc
 )
 {
     BOOL    success;
+    BOOL    complete;
     ULONG   nBytes;
     ULONG   nBytesReturned;
-
-    UCHAR   configDescReqBuf[sizeof(USB_DESCRIPTOR_REQUEST) +
-                             sizeof(USB_CONFIGURATION_DESCRIPTOR)];
+    USHORT  totalLength;
+    PVOID   queryBuffer;
 
     PUSB_DESCRIPTOR_REQUEST         configDescReq;
-    PUSB_CONFIGURATION_DESCRIPTOR   configDesc;
 
+    queryBuffer = NULL;
+    configDescReq = NULL;
 
-    // Request the Configuration Descriptor the first time using our
-    // local buffer, which is just big enough for the Cofiguration
-    // Descriptor itself.
+    // Request the Configuration Descriptor the first time with the length
+    // it had when this device model was last seen.  Otherwise use a query
+    // buffer, which is big enough for most Configuration Descriptors.
     //
-    nBytes = sizeof(configDescReqBuf);
+    totalLength = (DescriptorIndex == 0) ? GetCachedConfigLength(DeviceDesc) : 0;
 
-    configDescReq = (PUSB_DESCRIPTOR_REQUEST)configDescReqBuf;
-    configDesc = (PUSB_CONFIGURATION_DESCRIPTOR)(configDescReq+1);
+    if (totalLength != 0)
+    {
+        nBytes = sizeof(USB_DESCRIPTOR_REQUEST) + totalLength;
 
-    // Zero fill the entire request structure
-    //
-    memset(configDescReq, 0, nBytes);
+        configDescReq = (PUSB_DESCRIPTOR_REQUEST)ALLOC(nBytes);
+    }
+    else
+    {
+        nBytes = QUERY_BUFFER_SIZE;
 
-    // Indicate the port from which the descriptor will be requested
-    //
-    configDescReq->ConnectionIndex = ConnectionIndex;
+        queryBuffer = AllocQueryBuffer();
+
+        configDescReq = (PUSB_DESCRIPTOR_REQUEST)queryBuffer;
+    }
+
+    if (configDescReq == NULL)
+    {
+        OOPS();
+        return NULL;
+    }
 
     //
     // USBHUB uses URB_FUNCTION_GET_DESCRIPTOR_FROM_DEVICE to process this
@@ -1622,112 +3827,456 @@ GetConfigDescriptor (
     //     wIndex    = Zero (or Language ID for String Descriptors)
     //     wLength   = Length of descriptor buffer
     //
-    configDescReq->SetupPacket.wValue = (USB_CONFIGURATION_DESCRIPTOR_TYPE << 8)
-                                        | DescriptorIndex;
+    InitDescriptorRequest(configDescReq,
+                          nBytes,
+                          ConnectionIndex,
+                          USB_CONFIGURATION_DESCRIPTOR_TYPE,
+                          DescriptorIndex,
+                          0);
+
+    // Now issue the get descriptor request.
+    //
+    success = BackendDeviceIoControl(hHubDevice,
+                                     IOCTL_USB_GET_DESCRIPTOR_FROM_NODE_CONNECTION,
+                                     configDescReq,
+                                     nBytes,
+                                     configDescReq,
+                                     nBytes,
+                                     &nBytesReturned,
+                                     NULL);
+
+    if (!success)
+    {
+        OOPS();
+        goto GetConfigDescriptorError;
+    }
+
+    totalLength = CheckConfigDescriptor(configDescReq,
+                                        nBytes,
+                                        nBytesReturned,
+                                        &complete);
+
+    if (totalLength == 0)
+    {
+        OOPS();
+        goto GetConfigDescriptorError;
+    }
+
+    if (complete && queryBuffer != NULL)
+    {
+        // Copy the descriptor out of the query buffer
+        //
+        configDescReq = (PUSB_DESCRIPTOR_REQUEST)ALLOC(nBytesReturned);
+
+        if (configDescReq == NULL)
+        {
+            OOPS();
+            goto GetConfigDescriptorError;
+        }
+
+        memcpy(configDescReq, queryBuffer, nBytesReturned);
+    }
+    else if (!complete)
+    {
+        // The descriptor did not fit.  Now request the entire Configuration
+        // Descriptor using a dynamically allocated buffer which is sized
+        // big enough to hold the entire descriptor
+        //
+        if (configDescReq != queryBuffer)
+        {
+            FREE(configDescReq);
+        }
+
+        nBytes = sizeof(USB_DESCRIPTOR_REQUEST) + totalLength;
+
+        configDescReq = (PUSB_DESCRIPTOR_REQUEST)ALLOC(nBytes);
+
+        if (configDescReq == NULL)
+        {
+            OOPS();
+            goto GetConfigDescriptorError;
+        }
+
+        InitDescriptorRequest(configDescReq,
+                              nBytes,
+                              ConnectionIndex,
+                              USB_CONFIGURATION_DESCRIPTOR_TYPE,
+                              DescriptorIndex,
+                              0);
+
+        success = BackendDeviceIoControl(hHubDevice,
+                                         IOCTL_USB_GET_DESCRIPTOR_FROM_NODE_CONNECTION,
+                                         configDescReq,
+                                         nBytes,
+                                         configDescReq,
+                                         nBytes,
+                                         &nBytesReturned,
+                                         NULL);
+
+        if (!success ||
+            CheckConfigDescriptor(configDescReq,
+                                  nBytes,
+                                  nBytesReturned,
+                                  &complete) != totalLength ||
+            !complete)
+        {
+            OOPS();
+            goto GetConfigDescriptorError;
+        }
+    }
+
+    // Parse it once for everything that looks at it later
+    //
+    if (!IndexConfigDesc(&configDescReq))
+    {
+        goto GetConfigDescriptorError;
+    }
+
+    if (DescriptorIndex == 0)
+    {
+        CacheConfigLength(DeviceDesc, totalLength);
+    }
+
+    if (queryBuffer != NULL)
+    {
+        FreeQueryBuffer(queryBuffer);
+    }
+
+    return configDescReq;
+
+
+GetConfigDescriptorError:
+    // There was an error, free anything that was allocated
+    //
+    if (configDescReq != NULL && configDescReq != queryBuffer)
+    {
+        FREE(configDescReq);
+    }
+
+    if (queryBuffer != NULL)
+    {
+        FreeQueryBuffer(queryBuffer);
+    }
+
+    return NULL;
+}
+
+//*****************************************************************************
+//
+// GetDeviceQualifierDescriptor()
+//
+// hHubDevice - Handle of the hub device containing the port from which the
+// Device Qualifier Descriptor will be requested.
+//
+// ConnectionIndex - Identifies the port on the hub to which a device is
+// attached from which the Device Qualifier Descriptor will be requested.
+//
+// Returns NULL if the device has none.  Only a high speed capable device
+// has one, any other device stalls the request, so a failure is expected.
+//
+//*****************************************************************************
+
+PUSB_DEVICE_QUALIFIER_DESCRIPTOR
+GetDeviceQualifierDescriptor (
+    HANDLE  hHubDevice,
+    ULONG   ConnectionIndex
+)
+{
+    BOOL    success;
+    ULONG   nBytes;
+    ULONG   nBytesReturned;
+
+    UCHAR   qualifierDescReqBuf[sizeof(USB_DESCRIPTOR_REQUEST) +
+                                sizeof(USB_DEVICE_QUALIFIER_DESCRIPTOR)];
+
+    PUSB_DESCRIPTOR_REQUEST             qualifierDescReq;
+
+    nBytes = sizeof(qualifierDescReqBuf);
+
+    qualifierDescReq = (PUSB_DESCRIPTOR_REQUEST)qualifierDescReqBuf;
+
+    InitDescriptorRequest(qualifierDescReq,
+                          nBytes,
+                          ConnectionIndex,
+                          USB_DEVICE_QUALIFIER_DESCRIPTOR_TYPE,
+                          0,
+                          0);
+
+    success = BackendDeviceIoControl(hHubDevice,
+                                     IOCTL_USB_GET_DESCRIPTOR_FROM_NODE_CONNECTION,
+                                     qualifierDescReq,
+                                     nBytes,
+                                     qualifierDescReq,
+                                     nBytes,
+                                     &nBytesReturned,
+                                     NULL);
+
+    if (!success)
+    {
+        return NULL;
+    }
+
+    return CopyQualifierDescriptor(qualifierDescReq, nBytesReturned);
+}
+
+//*****************************************************************************
+//
+// CopyQualifierDescriptor()
+//
+// Checks the response to a Device Qualifier Descriptor request and returns
+// a copy of the descriptor, or NULL if the response is unusable.
+//
+//*****************************************************************************
+
+PUSB_DEVICE_QUALIFIER_DESCRIPTOR
+CopyQualifierDescriptor (
+    PUSB_DESCRIPTOR_REQUEST QualifierDescReq,
+    ULONG                   BytesReturned
+)
+{
+    PUSB_DEVICE_QUALIFIER_DESCRIPTOR    qualifierDesc;
+
+    qualifierDesc = (PUSB_DEVICE_QUALIFIER_DESCRIPTOR)(QualifierDescReq + 1);
+
+    if (BytesReturned != sizeof(USB_DESCRIPTOR_REQUEST) +
+                         sizeof(USB_DEVICE_QUALIFIER_DESCRIPTOR) ||
+        qualifierDesc->bLength != sizeof(USB_DEVICE_QUALIFIER_DESCRIPTOR) ||
+        qualifierDesc->bDescriptorType != USB_DEVICE_QUALIFIER_DESCRIPTOR_TYPE)
+    {
+        OOPS();
+        return NULL;
+    }
+
+    qualifierDesc = ALLOC(sizeof(USB_DEVICE_QUALIFIER_DESCRIPTOR));
+
+    if (qualifierDesc == NULL)
+    {
+        OOPS();
+        return NULL;
+    }
+
+    memcpy(qualifierDesc,
+           QualifierDescReq + 1,
+           sizeof(USB_DEVICE_QUALIFIER_DESCRIPTOR));
+
+    return qualifierDesc;
+}
+
+//*****************************************************************************
+//
+// CheckConfigDescriptor()
+//
+// Checks the response to a Configuration Descriptor request and returns
+// the wTotalLength of the descriptor, or 0 if the response is unusable.
+//
+// RequestSize - Size of the request, USB_DESCRIPTOR_REQUEST included.
+//
+// Complete - Set to FALSE if the descriptor was cut short by the size of
+// the request, and has to be requested again with wTotalLength bytes.
+//
+//*****************************************************************************
+
+USHORT
+CheckConfigDescriptor (
+    PUSB_DESCRIPTOR_REQUEST ConfigDescReq,
+    ULONG                   RequestSize,
+    ULONG                   BytesReturned,
+    PBOOL                   Complete
+)
+{
+    PUSB_CONFIGURATION_DESCRIPTOR   configDesc;
+    ULONG                           descLength;
+
+    if (BytesReturned < sizeof(USB_DESCRIPTOR_REQUEST) +
+                        sizeof(USB_CONFIGURATION_DESCRIPTOR))
+    {
+        return 0;
+    }
+
+    configDesc = (PUSB_CONFIGURATION_DESCRIPTOR)(ConfigDescReq + 1);
+    descLength = BytesReturned - sizeof(USB_DESCRIPTOR_REQUEST);
+
+    if (configDesc->wTotalLength < sizeof(USB_CONFIGURATION_DESCRIPTOR))
+    {
+        return 0;
+    }
+
+    // The device stops sending after wTotalLength bytes or when the
+    // buffer is full, whichever comes first.
+    //
+    if (configDesc->wTotalLength == descLength)
+    {
+        *Complete = TRUE;
+    }
+    else if (configDesc->wTotalLength > descLength &&
+             BytesReturned == RequestSize)
+    {
+        *Complete = FALSE;
+    }
+    else
+    {
+        return 0;
+    }
+
+    return configDesc->wTotalLength;
+}
+
+//*****************************************************************************
+//
+// GetCachedConfigLength()
+//
+// Returns the length of Configuration Descriptor 0 last seen for a device
+// with the same idVendor, idProduct and bcdDevice, or 0 if there was none.
+//
+//*****************************************************************************
+
+USHORT
+GetCachedConfigLength (
+    PUSB_DEVICE_DESCRIPTOR  DeviceDesc
+)
+{
+    PCONFIG_LENGTH_ENTRY    entry;
+    USHORT                  totalLength;
+
+    totalLength = 0;
+
+    entry = &ConfigLengthCache[CONFIG_LENGTH_SLOT(DeviceDesc)];
+
+    EnterCriticalSection(&QueryLock);
+
+    if (entry->idVendor == DeviceDesc->idVendor &&
+        entry->idProduct == DeviceDesc->idProduct &&
+        entry->bcdDevice == DeviceDesc->bcdDevice)
+    {
+        totalLength = entry->wTotalLength;
+    }
+
+    LeaveCriticalSection(&QueryLock);
+
+    return totalLength;
+}
+
+//*****************************************************************************
+//
+// CacheConfigLength()
+//
+// Remembers the length of Configuration Descriptor 0 of a device model.  A
+// model that hashes to the same entry replaces the one there.
+//
+//*****************************************************************************
+
+VOID
+CacheConfigLength (
+    PUSB_DEVICE_DESCRIPTOR  DeviceDesc,
+    USHORT                  TotalLength
+)
+{
+    PCONFIG_LENGTH_ENTRY    entry;
+
+    entry = &ConfigLengthCache[CONFIG_LENGTH_SLOT(DeviceDesc)];
+
+    EnterCriticalSection(&QueryLock);
+
+    entry->idVendor     = DeviceDesc->idVendor;
+    entry->idProduct    = DeviceDesc->idProduct;
+    entry->bcdDevice    = DeviceDesc->bcdDevice;
+    entry->wTotalLength = TotalLength;
+
+    LeaveCriticalSection(&QueryLock);
+}
+
+//*****************************************************************************
+//
+// AllocQueryBuffer()
+//
+// Returns a QUERY_BUFFER_SIZE byte buffer for a single round trip request,
+// taken from the pool if there is one there.  The contents are undefined.
+// Give it back with FreeQueryBuffer().
+//
+//*****************************************************************************
+
+PVOID
+AllocQueryBuffer (
+    VOID
+)
+{
+    PVOID   buffer;
 
-    configDescReq->SetupPacket.wLength = (USHORT)(nBytes - sizeof(USB_DESCRIPTOR_REQUEST));
+    EnterCriticalSection(&QueryLock);
 
-    // Now issue the get descriptor request.
-    //
-    success = DeviceIoControl(hHubDevice,
-                              IOCTL_USB_GET_DESCRIPTOR_FROM_NODE_CONNECTION,
-                              configDescReq,
-                              nBytes,
-                              configDescReq,
-                              nBytes,
-                              &nBytesReturned,
-                              NULL);
+    buffer = QueryBufferPool;
 
-    if (!success)
+    if (buffer != NULL)
     {
-        OOPS();
-        return NULL;
+        QueryBufferPool = *(PVOID *)buffer;
     }
 
-    if (nBytes != nBytesReturned)
-    {
-        OOPS();
-        return NULL;
-    }
+    LeaveCriticalSection(&QueryLock);
 
-    if (configDesc->wTotalLength < sizeof(USB_CONFIGURATION_DESCRIPTOR))
+    if (buffer == NULL)
     {
-        OOPS();
-        return NULL;
+        buffer = ALLOC(QUERY_BUFFER_SIZE);
     }
 
-    // Now request the entire Configuration Descriptor using a dynamically
-    // allocated buffer which is sized big enough to hold the entire descriptor
-    //
-    nBytes = sizeof(USB_DESCRIPTOR_REQUEST) + configDesc->wTotalLength;
+    return buffer;
+}
 
-    configDescReq = (PUSB_DESCRIPTOR_REQUEST)ALLOC(nBytes);
+//*****************************************************************************
+//
+// FreeQueryBuffer()
+//
+// Puts a buffer from AllocQueryBuffer() back in the pool.  The first
+// pointer of a pooled buffer links it to the next one.
+//
+//*****************************************************************************
 
-    if (configDescReq == NULL)
-    {
-        OOPS();
-        return NULL;
-    }
+VOID
+FreeQueryBuffer (
+    PVOID   Buffer
+)
+{
+    EnterCriticalSection(&QueryLock);
 
-    configDesc = (PUSB_CONFIGURATION_DESCRIPTOR)(configDescReq+1);
+    *(PVOID *)Buffer = QueryBufferPool;
 
-    // Indicate the port from which the descriptor will be requested
-    //
-    configDescReq->ConnectionIndex = ConnectionIndex;
+    QueryBufferPool = Buffer;
 
-    //
-    // USBHUB uses URB_FUNCTION_GET_DESCRIPTOR_FROM_DEVICE to process this
-    // IOCTL_USB_GET_DESCRIPTOR_FROM_NODE_CONNECTION request.
-    //
-    // USBD will automatically initialize these fields:
-    //     bmRequest = 0x80
-    //     bRequest  = 0x06
-    //
-    // We must inititialize these fields:
-    //     wValue    = Descriptor Type (high) and Descriptor Index (low byte)
-    //     wIndex    = Zero (or Language ID for String Descriptors)
-    //     wLength   = Length of descriptor buffer
-    //
-    configDescReq->SetupPacket.wValue = (USB_CONFIGURATION_DESCRIPTOR_TYPE << 8)
-                                        | DescriptorIndex;
+    LeaveCriticalSection(&QueryLock);
+}
 
-    configDescReq->SetupPacket.wLength = (USHORT)(nBytes - sizeof(USB_DESCRIPTOR_REQUEST));
+//*****************************************************************************
+//
+// FreeQueryBufferPool()
+//
+// Frees the pooled query buffers once an enumeration is done.
+//
+//*****************************************************************************
 
-    // Now issue the get descriptor request.
-    //
-    success = DeviceIoControl(hHubDevice,
-                              IOCTL_USB_GET_DESCRIPTOR_FROM_NODE_CONNECTION,
-                              configDescReq,
-                              nBytes,
-                              configDescReq,
-                              nBytes,
-                              &nBytesReturned,
-                              NULL);
+VOID
+FreeQueryBufferPool (
+    VOID
+)
+{
+    PVOID   buffers;
+    PVOID   buffer;
 
-    if (!success)
-    {
-        OOPS();
-        FREE(configDescReq);
-        return NULL;
-    }
+    EnterCriticalSection(&QueryLock);
 
-    if (nBytes != nBytesReturned)
-    {
-        OOPS();
-        FREE(configDescReq);
-        return NULL;
-    }
+    buffers = QueryBufferPool;
+
+    QueryBufferPool = NULL;
 
-    if (configDesc->wTotalLength != (nBytes - sizeof(USB_DESCRIPTOR_REQUEST)))
+    LeaveCriticalSection(&QueryLock);
+
+    while (buffers != NULL)
     {
-        OOPS();
-        FREE(configDescReq);
-        return NULL;
-    }
+        buffer = buffers;
 
-    return configDescReq;
-}
+        buffers = *(PVOID *)buffer;
 
+        FREE(buffer);
+    }
+}
 
 //*****************************************************************************
 //
@@ -1736,20 +4285,17 @@ GetConfigDescriptor (
 // DeviceDesc - Device Descriptor for which String Descriptors should be
 // checked.
 //
-// ConfigDesc - Configuration Descriptor (also containing Interface Descriptor)
-// for which String Descriptors should be checked.
+// ConfigDesc - Indexed Configuration Descriptor request (also containing
+// Interface Descriptors) for which String Descriptors should be checked.
 //
 //*****************************************************************************
 
 BOOL
 AreThereStringDescriptors (
     PUSB_DEVICE_DESCRIPTOR          DeviceDesc,
-    PUSB_CONFIGURATION_DESCRIPTOR   ConfigDesc
+    PUSB_DESCRIPTOR_REQUEST         ConfigDesc
 )
 {
-    PUCHAR                  descEnd;
-    PUSB_COMMON_DESCRIPTOR  commonDesc;
-
     //
     // Check Device Descriptor strings
     //
@@ -1764,53 +4310,11 @@ AreThereStringDescriptors (
 
 
     //
-    // Check the Configuration and Interface Descriptor strings
+    // Check the Configuration and Interface Descriptor strings, which
+    // were found when the descriptor was indexed
     //
 
-    descEnd = (PUCHAR)ConfigDesc + ConfigDesc->wTotalLength;
-
-    commonDesc = (PUSB_COMMON_DESCRIPTOR)ConfigDesc;
-
-    while ((PUCHAR)commonDesc + sizeof(USB_COMMON_DESCRIPTOR) < descEnd &&
-           (PUCHAR)commonDesc + commonDesc->bLength <= descEnd)
-    {
-        switch (commonDesc->bDescriptorType)
-        {
-            case USB_CONFIGURATION_DESCRIPTOR_TYPE:
-                if (commonDesc->bLength != sizeof(USB_CONFIGURATION_DESCRIPTOR))
-                {
-                    OOPS();
-                    break;
-                }
-                if (((PUSB_CONFIGURATION_DESCRIPTOR)commonDesc)->iConfiguration)
-                {
-                    return TRUE;
-                }
-                (PUCHAR)commonDesc += commonDesc->bLength;
-                continue;
-
-            case USB_INTERFACE_DESCRIPTOR_TYPE:
-                if (commonDesc->bLength != sizeof(USB_INTERFACE_DESCRIPTOR) &&
-                    commonDesc->bLength != sizeof(USB_INTERFACE_DESCRIPTOR2))
-                {
-                    OOPS();
-                    break;
-                }
-                if (((PUSB_INTERFACE_DESCRIPTOR)commonDesc)->iInterface)
-                {
-                    return TRUE;
-                }
-                (PUCHAR)commonDesc += commonDesc->bLength;
-                continue;
-
-            default:
-                (PUCHAR)commonDesc += commonDesc->bLength;
-                continue;
-        }
-        break;
-    }
-
-    return FALSE;
+    return GetConfigDescIndex(ConfigDesc)->HasStrings;
 }
 
 
@@ -1818,6 +4322,8 @@ AreThereStringDescriptors (
 //
 // GetAllStringDescriptors()
 //
+// Context - Chooses the languages the strings are requested in.
+//
 // hHubDevice - Handle of the hub device containing the port from which the
 // String Descriptors will be requested.
 //
@@ -1827,142 +4333,105 @@ AreThereStringDescriptors (
 // DeviceDesc - Device Descriptor for which String Descriptors should be
 // requested.
 //
-// ConfigDesc - Configuration Descriptor (also containing Interface Descriptor)
-// for which String Descriptors should be requested.
+// ConfigDesc - Indexed Configuration Descriptor request (also containing
+// Interface Descriptors) for which String Descriptors should be requested.
 //
 //*****************************************************************************
 
-PSTRING_DESCRIPTOR_NODE
+PSTRING_DESCRIPTORS
 GetAllStringDescriptors (
+    PENUM_CONTEXT                   Context,
     HANDLE                          hHubDevice,
     ULONG                           ConnectionIndex,
     PUSB_DEVICE_DESCRIPTOR          DeviceDesc,
-    PUSB_CONFIGURATION_DESCRIPTOR   ConfigDesc
+    PUSB_DESCRIPTOR_REQUEST         ConfigDesc
 )
 {
-    PSTRING_DESCRIPTOR_NODE supportedLanguagesString;
-    PSTRING_DESCRIPTOR_NODE stringDescNodeTail;
+    PSTRING_DESCRIPTORS     stringDescs;
+    PUSB_STRING_DESCRIPTOR  supportedLanguagesString;
     ULONG                   numLanguageIDs;
-    USHORT                  *languageIDs;
-
-    PUCHAR                  descEnd;
-    PUSB_COMMON_DESCRIPTOR  commonDesc;
+    USHORT                  selectedIDs[MAXIMUM_USB_STRING_LENGTH / 2];
+    ULONG                   numSelected;
+    PUCHAR                  indexes;
+    ULONG                   numIndexes;
+    ULONG                   numDuplicates;
+    ULONG                   i;
 
     //
     // Get the array of supported Language IDs, which is returned
     // in String Descriptor 0
     //
-    supportedLanguagesString = GetStringDescriptor(hHubDevice,
-                                                   ConnectionIndex,
-                                                   0,
-                                                   0);
+    stringDescs = NULL;
 
-    if (supportedLanguagesString == NULL)
+    if (!GetStringDescriptor(hHubDevice,
+                             ConnectionIndex,
+                             0,
+                             0,
+                             &stringDescs))
     {
+        FreeStringDescriptors(stringDescs);
         return NULL;
     }
 
-    numLanguageIDs = (supportedLanguagesString->StringDescriptor->bLength - 2) / 2;
+    supportedLanguagesString = FindStringDescriptor(stringDescs, 0, 0);
 
-    languageIDs = &supportedLanguagesString->StringDescriptor->bString[0];
+    numLanguageIDs = (supportedLanguagesString->bLength - 2) / 2;
 
-    stringDescNodeTail = supportedLanguagesString;
+    stringDescs->RequestsSent = 1;
 
     //
-    // Get the Device Descriptor strings
+    // Get the Device, Configuration and Interface Descriptor strings, each
+    // index once, in the languages Context->StringLanguages selects
     //
 
-    if (DeviceDesc->iManufacturer)
-    {
-        stringDescNodeTail = GetStringDescriptors(hHubDevice,
-                                                  ConnectionIndex,
-                                                  DeviceDesc->iManufacturer,
-                                                  numLanguageIDs,
-                                                  languageIDs,
-                                                  stringDescNodeTail);
-    }
+    numIndexes = GetStringDescriptorIndexes(DeviceDesc, ConfigDesc, NULL, NULL);
 
-    if (DeviceDesc->iProduct)
+    if (numIndexes == 0)
     {
-        stringDescNodeTail = GetStringDescriptors(hHubDevice,
-                                                  ConnectionIndex,
-                                                  DeviceDesc->iProduct,
-                                                  numLanguageIDs,
-                                                  languageIDs,
-                                                  stringDescNodeTail);
+        TrimStringDescriptors(&stringDescs);
+        return stringDescs;
     }
 
-    if (DeviceDesc->iSerialNumber)
+    indexes = (PUCHAR)ALLOC(numIndexes);
+
+    if (indexes == NULL)
     {
-        stringDescNodeTail = GetStringDescriptors(hHubDevice,
-                                                  ConnectionIndex,
-                                                  DeviceDesc->iSerialNumber,
-                                                  numLanguageIDs,
-                                                  languageIDs,
-                                                  stringDescNodeTail);
+        OOPS();
+        TrimStringDescriptors(&stringDescs);
+        return stringDescs;
     }
 
+    GetStringDescriptorIndexes(DeviceDesc, ConfigDesc, indexes, &numDuplicates);
 
+    // The table moves as strings are added, so select the languages from
+    // String Descriptor 0 before that
     //
-    // Get the Configuration and Interface Descriptor strings
-    //
-
-    descEnd = (PUCHAR)ConfigDesc + ConfigDesc->wTotalLength;
-
-    commonDesc = (PUSB_COMMON_DESCRIPTOR)ConfigDesc;
-
-    while ((PUCHAR)commonDesc + sizeof(USB_COMMON_DESCRIPTOR) < descEnd &&
-           (PUCHAR)commonDesc + commonDesc->bLength <= descEnd)
+    numSelected = SelectStringLanguages(Context,
+                                        &supportedLanguagesString->bString[0],
+                                        numLanguageIDs,
+                                        selectedIDs);
+
+    CountStringRequests(stringDescs,
+                        numIndexes,
+                        numDuplicates,
+                        numLanguageIDs,
+                        numSelected);
+
+    for (i = 0; i < numIndexes; i++)
     {
-        switch (commonDesc->bDescriptorType)
-        {
-            case USB_CONFIGURATION_DESCRIPTOR_TYPE:
-                if (commonDesc->bLength != sizeof(USB_CONFIGURATION_DESCRIPTOR))
-                {
-                    OOPS();
-                    break;
-                }
-                if (((PUSB_CONFIGURATION_DESCRIPTOR)commonDesc)->iConfiguration)
-                {
-                    stringDescNodeTail = GetStringDescriptors(
-                                             hHubDevice,
-                                             ConnectionIndex,
-                                             ((PUSB_CONFIGURATION_DESCRIPTOR)commonDesc)->iConfiguration,
-                                             numLanguageIDs,
-                                             languageIDs,
-                                             stringDescNodeTail);
-                }
-                (PUCHAR)commonDesc += commonDesc->bLength;
-                continue;
+        GetStringDescriptors(hHubDevice,
+                             ConnectionIndex,
+                             indexes[i],
+                             numSelected,
+                             selectedIDs,
+                             &stringDescs);
+    }
 
-            case USB_INTERFACE_DESCRIPTOR_TYPE:
-                if (commonDesc->bLength != sizeof(USB_INTERFACE_DESCRIPTOR) &&
-                    commonDesc->bLength != sizeof(USB_INTERFACE_DESCRIPTOR2))
-                {
-                    OOPS();
-                    break;
-                }
-                if (((PUSB_INTERFACE_DESCRIPTOR)commonDesc)->iInterface)
-                {
-                    stringDescNodeTail = GetStringDescriptors(
-                                             hHubDevice,
-                                             ConnectionIndex,
-                                             ((PUSB_INTERFACE_DESCRIPTOR)commonDesc)->iInterface,
-                                             numLanguageIDs,
-                                             languageIDs,
-                                             stringDescNodeTail);
-                }
-                (PUCHAR)commonDesc += commonDesc->bLength;
-                continue;
+    FREE(indexes);
 
-            default:
-                (PUCHAR)commonDesc += commonDesc->bLength;
-                continue;
-        }
-        break;
-    }
+    TrimStringDescriptors(&stringDescs);
 
-    return supportedLanguagesString;
+    return stringDescs;
 }
 
 
@@ -1980,14 +4449,18 @@ GetAllStringDescriptors (
 //
 // LanguageID - Language in which the string should be requested.
 //
+// StringDescs - Table the String Descriptor is added to, see
+// AddStringDescriptor().
+//
 //*****************************************************************************
 
-PSTRING_DESCRIPTOR_NODE
+BOOL
 GetStringDescriptor (
     HANDLE  hHubDevice,
     ULONG   ConnectionIndex,
     UCHAR   DescriptorIndex,
-    USHORT  LanguageID
+    USHORT  LanguageID,
+    PSTRING_DESCRIPTORS *StringDescs
 )
 {
     BOOL    success;
@@ -1998,13 +4471,10 @@ GetStringDescriptor (
                              MAXIMUM_USB_STRING_LENGTH];
 
     PUSB_DESCRIPTOR_REQUEST stringDescReq;
-    PUSB_STRING_DESCRIPTOR  stringDesc;
-    PSTRING_DESCRIPTOR_NODE stringDescNode;
 
     nBytes = sizeof(stringDescReqBuf);
 
     stringDescReq = (PUSB_DESCRIPTOR_REQUEST)stringDescReqBuf;
-    stringDesc = (PUSB_STRING_DESCRIPTOR)(stringDescReq+1);
 
     // Zero fill the entire request structure
     //
@@ -2022,135 +4492,409 @@ GetStringDescriptor (
     //     bmRequest = 0x80
     //     bRequest  = 0x06
     //
-    // We must inititialize these fields:
-    //     wValue    = Descriptor Type (high) and Descriptor Index (low byte)
-    //     wIndex    = Zero (or Language ID for String Descriptors)
-    //     wLength   = Length of descriptor buffer
+    // We must inititialize these fields:
+    //     wValue    = Descriptor Type (high) and Descriptor Index (low byte)
+    //     wIndex    = Zero (or Language ID for String Descriptors)
+    //     wLength   = Length of descriptor buffer
+    //
+    stringDescReq->SetupPacket.wValue = (USB_STRING_DESCRIPTOR_TYPE << 8)
+                                        | DescriptorIndex;
+
+    stringDescReq->SetupPacket.wIndex = LanguageID;
+
+    stringDescReq->SetupPacket.wLength = (USHORT)(nBytes - sizeof(USB_DESCRIPTOR_REQUEST));
+
+    // Now issue the get descriptor request.
+    //
+    success = BackendDeviceIoControl(hHubDevice,
+                                     IOCTL_USB_GET_DESCRIPTOR_FROM_NODE_CONNECTION,
+                                     stringDescReq,
+                                     nBytes,
+                                     stringDescReq,
+                                     nBytes,
+                                     &nBytesReturned,
+                                     NULL);
+
+    if (!success)
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    return AddRequestedStringDescriptor(StringDescs,
+                                        stringDescReq,
+                                        nBytesReturned,
+                                        DescriptorIndex,
+                                        LanguageID);
+}
+
+
+//*****************************************************************************
+//
+// GetStringDescriptors()
+//
+// hHubDevice - Handle of the hub device containing the port from which the
+// String Descriptor will be requested.
+//
+// ConnectionIndex - Identifies the port on the hub to which a device is
+// attached from which the String Descriptor will be requested.
+//
+// DescriptorIndex - String Descriptor index.
+//
+// NumLanguageIDs -  Number of languages in which the string should be
+// requested.
+//
+// LanguageIDs - Languages in which the string should be requested.
+//
+// StringDescs - Table the String Descriptors are added to.
+//
+//*****************************************************************************
+
+VOID
+GetStringDescriptors (
+    HANDLE  hHubDevice,
+    ULONG   ConnectionIndex,
+    UCHAR   DescriptorIndex,
+    ULONG   NumLanguageIDs,
+    USHORT  *LanguageIDs,
+    PSTRING_DESCRIPTORS *StringDescs
+)
+{
+    ULONG i;
+
+    for (i=0; i<NumLanguageIDs; i++)
+    {
+        GetStringDescriptor(hHubDevice,
+                            ConnectionIndex,
+                            DescriptorIndex,
+                            *LanguageIDs,
+                            StringDescs);
+
+        LanguageIDs++;
+    }
+}
+
+//*****************************************************************************
+//
+// AddRequestedStringDescriptor()
+//
+// StringDescs - Table the String Descriptor is added to.
+//
+// StringDescReq - Completed get descriptor request for a String Descriptor.
+//
+// BytesReturned - Number of bytes the request returned.
+//
+// Checks the returned String Descriptor and adds it to the table.
+//
+//*****************************************************************************
+
+BOOL
+AddRequestedStringDescriptor (
+    PSTRING_DESCRIPTORS     *StringDescs,
+    PUSB_DESCRIPTOR_REQUEST StringDescReq,
+    ULONG                   BytesReturned,
+    UCHAR                   DescriptorIndex,
+    USHORT                  LanguageID
+)
+{
+    PUSB_STRING_DESCRIPTOR  stringDesc;
+
+    stringDesc = (PUSB_STRING_DESCRIPTOR)(StringDescReq+1);
+
+    //
+    // Do some sanity checks on the return from the get descriptor request.
+    //
+
+    if (BytesReturned < 2)
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    if (stringDesc->bDescriptorType != USB_STRING_DESCRIPTOR_TYPE)
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    if (stringDesc->bLength != BytesReturned - sizeof(USB_DESCRIPTOR_REQUEST))
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    if (stringDesc->bLength % 2 != 0)
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    return AddStringDescriptor(StringDescs,
+                               DescriptorIndex,
+                               LanguageID,
+                               stringDesc);
+}
+
+//*****************************************************************************
+//
+// GetStringDescriptorIndexes()
+//
+// DeviceDesc - Device Descriptor whose strings should be listed.
+//
+// ConfigDesc - Indexed Configuration Descriptor request (also containing
+// Interface Descriptors) whose strings should be listed.
+//
+// Indexes - Receives the non zero string indexes in the order they should
+// be requested, or NULL to only count them.  An index used by several
+// descriptors is listed once, where it is first used.
+//
+// NumDuplicates - Receives the number of uses of an index that were left
+// out because it was already listed, may be NULL.
+//
+// Returns the number of indexes.
+//
+//*****************************************************************************
+
+ULONG
+GetStringDescriptorIndexes (
+    PUSB_DEVICE_DESCRIPTOR          DeviceDesc,
+    PUSB_DESCRIPTOR_REQUEST         ConfigDesc,
+    __out_opt PUCHAR                Indexes,
+    __out_opt PULONG                NumDuplicates
+)
+{
+    PCONFIG_DESC_INDEX      configIndex;
+    PCONFIG_DESC_ENTRY      entry;
+    PUSB_COMMON_DESCRIPTOR  commonDesc;
+    ULONG                   numIndexes;
+    ULONG                   numDuplicates;
+    UCHAR                   seen[256 / 8];
+
+    numIndexes = 0;
+    numDuplicates = 0;
+
+    memset(seen, 0, sizeof(seen));
+
+    //
+    // Device Descriptor strings
     //
-    stringDescReq->SetupPacket.wValue = (USB_STRING_DESCRIPTOR_TYPE << 8)
-                                        | DescriptorIndex;
 
-    stringDescReq->SetupPacket.wIndex = LanguageID;
+    AddStringDescriptorIndex(DeviceDesc->iManufacturer,
+                             seen, Indexes, &numIndexes, &numDuplicates);
 
-    stringDescReq->SetupPacket.wLength = (USHORT)(nBytes - sizeof(USB_DESCRIPTOR_REQUEST));
+    AddStringDescriptorIndex(DeviceDesc->iProduct,
+                             seen, Indexes, &numIndexes, &numDuplicates);
 
-    // Now issue the get descriptor request.
-    //
-    success = DeviceIoControl(hHubDevice,
-                              IOCTL_USB_GET_DESCRIPTOR_FROM_NODE_CONNECTION,
-                              stringDescReq,
-                              nBytes,
-                              stringDescReq,
-                              nBytes,
-                              &nBytesReturned,
-                              NULL);
+    AddStringDescriptorIndex(DeviceDesc->iSerialNumber,
+                             seen, Indexes, &numIndexes, &numDuplicates);
 
     //
-    // Do some sanity checks on the return from the get descriptor request.
+    // Configuration and Interface Descriptor strings
     //
 
-    if (!success)
+    configIndex = GetConfigDescIndex(ConfigDesc);
+
+    for (entry = configIndex->Entries;
+         entry < configIndex->Entries + configIndex->NumEntries;
+         entry++)
     {
-        OOPS();
-        return NULL;
+        commonDesc = CONFIG_ENTRY_DESC(ConfigDesc, entry);
+
+        switch (entry->Kind)
+        {
+            case ConfigDescConfiguration:
+                AddStringDescriptorIndex(
+                    ((PUSB_CONFIGURATION_DESCRIPTOR)commonDesc)->iConfiguration,
+                    seen, Indexes, &numIndexes, &numDuplicates);
+                break;
+
+            case ConfigDescInterface:
+                AddStringDescriptorIndex(
+                    ((PUSB_INTERFACE_DESCRIPTOR)commonDesc)->iInterface,
+                    seen, Indexes, &numIndexes, &numDuplicates);
+                break;
+
+            default:
+                break;
+        }
     }
 
-    if (nBytesReturned < 2)
+    if (NumDuplicates)
     {
-        OOPS();
-        return NULL;
+        *NumDuplicates = numDuplicates;
     }
 
-    if (stringDesc->bDescriptorType != USB_STRING_DESCRIPTOR_TYPE)
+    return numIndexes;
+}
+
+//*****************************************************************************
+//
+// AddStringDescriptorIndex()
+//
+// Index - String index found in a descriptor, 0 if there is no string.
+//
+// Seen - 256 bit set of the indexes already listed.
+//
+// Adds Index to the list built by GetStringDescriptorIndexes() unless it is
+// 0, or counts it as a duplicate if it is already listed.
+//
+//*****************************************************************************
+
+VOID
+AddStringDescriptorIndex (
+    UCHAR   Index,
+    PUCHAR  Seen,
+    PUCHAR  Indexes,
+    PULONG  NumIndexes,
+    PULONG  NumDuplicates
+)
+{
+    if (Index == 0)
     {
-        OOPS();
-        return NULL;
+        return;
     }
 
-    if (stringDesc->bLength != nBytesReturned - sizeof(USB_DESCRIPTOR_REQUEST))
+    if (Seen[Index / 8] & (1 << (Index % 8)))
     {
-        OOPS();
-        return NULL;
+        (*NumDuplicates)++;
+        return;
     }
 
-    if (stringDesc->bLength % 2 != 0)
+    Seen[Index / 8] |= (1 << (Index % 8));
+
+    if (Indexes)
     {
-        OOPS();
-        return NULL;
+        Indexes[*NumIndexes] = Index;
     }
 
-    //
-    // Looks good, allocate some (zero filled) space for the string descriptor
-    // node and copy the string descriptor to it.
-    //
+    (*NumIndexes)++;
+}
+
+//*****************************************************************************
+//
+// SelectStringLanguages()
+//
+// LanguageIDs - Languages the device supports, from String Descriptor 0.
+//
+// Selected - Receives the languages strings should be requested in, as
+// chosen by Context->StringLanguages.  It must have room for
+// NumLanguageIDs.
+//
+// Returns the number of selected languages.
+//
+//*****************************************************************************
+
+ULONG
+SelectStringLanguages (
+    PENUM_CONTEXT   Context,
+    USHORT          *LanguageIDs,
+    ULONG           NumLanguageIDs,
+    USHORT          *Selected
+)
+{
+    ULONG   numSelected;
+    ULONG   i;
+    ULONG   j;
 
-    stringDescNode = (PSTRING_DESCRIPTOR_NODE)ALLOC(sizeof(STRING_DESCRIPTOR_NODE) +
-                                                    stringDesc->bLength);
+    numSelected = 0;
 
-    if (stringDescNode == NULL)
+    if (Context->StringLanguages == StringLanguagesAll)
     {
-        OOPS();
-        return NULL;
+        for (i = 0; i < NumLanguageIDs; i++)
+        {
+            Selected[numSelected++] = LanguageIDs[i];
+        }
+
+        return numSelected;
     }
 
-    stringDescNode->DescriptorIndex = DescriptorIndex;
-    stringDescNode->LanguageID = LanguageID;
+    if (Context->StringLanguages == StringLanguagesPreferred)
+    {
+        // Keep the order of the device, it lists its main language first
+        //
+        for (i = 0; i < NumLanguageIDs; i++)
+        {
+            for (j = 0; j < Context->NumPreferredLanguageIDs; j++)
+            {
+                if (LanguageIDs[i] == Context->PreferredLanguageIDs[j])
+                {
+                    Selected[numSelected++] = LanguageIDs[i];
+                    break;
+                }
+            }
+        }
+    }
 
-    memcpy(stringDescNode->StringDescriptor,
-           stringDesc,
-           stringDesc->bLength);
+    // StringLanguagesFirst, or none of the preferred languages is supported
+    //
+    if (numSelected == 0 && NumLanguageIDs != 0)
+    {
+        Selected[numSelected++] = LanguageIDs[0];
+    }
 
-    return stringDescNode;
+    return numSelected;
 }
 
-
 //*****************************************************************************
 //
-// GetStringDescriptors()
+// CountStringRequests()
 //
-// hHubDevice - Handle of the hub device containing the port from which the
-// String Descriptor will be requested.
+// StringDescs - Table holding String Descriptor 0 so far.
 //
-// ConnectionIndex - Identifies the port on the hub to which a device is
-// attached from which the String Descriptor will be requested.
+// Records how many control transfers fetching the strings takes, and how
+// many requesting every use of an index in every language would have
+// taken on top of that.
 //
-// DescriptorIndex - String Descriptor index.
+//*****************************************************************************
+
+VOID
+CountStringRequests (
+    PSTRING_DESCRIPTORS     StringDescs,
+    ULONG                   NumIndexes,
+    ULONG                   NumDuplicates,
+    ULONG                   NumLanguageIDs,
+    ULONG                   NumSelected
+)
+{
+    StringDescs->RequestsSent = (USHORT)(1 + NumIndexes * NumSelected);
+
+    StringDescs->RequestsSaved = (USHORT)(NumDuplicates * NumLanguageIDs +
+                                          NumIndexes * (NumLanguageIDs - NumSelected));
+}
+
+//*****************************************************************************
 //
-// NumLanguageIDs -  Number of languages in which the string should be
-// requested.
+// InitDescriptorRequest()
 //
-// LanguageIDs - Languages in which the string should be requested.
+// Request - Buffer of RequestSize bytes for a get descriptor request, which
+// is zero filled and set up to fetch the descriptor into the rest of the
+// buffer.
 //
 //*****************************************************************************
 
-PSTRING_DESCRIPTOR_NODE
-GetStringDescriptors (
-    HANDLE  hHubDevice,
+VOID
+InitDescriptorRequest (
+    PVOID   Request,
+    ULONG   RequestSize,
     ULONG   ConnectionIndex,
+    UCHAR   DescriptorType,
     UCHAR   DescriptorIndex,
-    ULONG   NumLanguageIDs,
-    USHORT  *LanguageIDs,
-    PSTRING_DESCRIPTOR_NODE StringDescNodeTail
+    USHORT  LanguageID
 )
 {
-    ULONG i;
+    PUSB_DESCRIPTOR_REQUEST descReq;
 
-    for (i=0; i<NumLanguageIDs; i++)
-    {
-        StringDescNodeTail->Next = GetStringDescriptor(hHubDevice,
-                                                       ConnectionIndex,
-                                                       DescriptorIndex,
-                                                       *LanguageIDs);
+    descReq = (PUSB_DESCRIPTOR_REQUEST)Request;
 
-        if (StringDescNodeTail->Next)
-        {
-            StringDescNodeTail = StringDescNodeTail->Next;
-        }
+    memset(descReq, 0, RequestSize);
 
-        LanguageIDs++;
-    }
+    descReq->ConnectionIndex = ConnectionIndex;
 
-    return StringDescNodeTail;
+    descReq->SetupPacket.wValue = (DescriptorType << 8) | DescriptorIndex;
+
+    descReq->SetupPacket.wIndex = LanguageID;
+
+    descReq->SetupPacket.wLength = (USHORT)(RequestSize - sizeof(USB_DESCRIPTOR_REQUEST));
 }
 
 //*****************************************************************************
@@ -2166,7 +4910,6 @@ CleanupItem (
 )
 {
     TV_ITEM tvi;
-    PVOID   info;
 
     tvi.mask = TVIF_HANDLE | TVIF_PARAM;
     tvi.hItem = hTreeItem;
@@ -2174,8 +4917,27 @@ CleanupItem (
     TreeView_GetItem(hTreeWnd,
                      &tvi);
 
-    info = (PVOID)tvi.lParam;
+    // The item handle may be reused once the item is deleted
+    //
+    InvalidateRenderCache(hTreeItem);
+
+    FreeDeviceInfo((PVOID)tvi.lParam);
+}
+
+//*****************************************************************************
+//
+// FreeDeviceInfo()
+//
+// Info - One of the USBxxxINFO structures built during enumeration, or NULL.
+// Frees the structure and everything it points to.
+//
+//*****************************************************************************
 
+VOID
+FreeDeviceInfo (
+    PVOID   info
+)
+{
     if (info)
     {
         PTSTR                               DriverKey = NULL;
@@ -2185,17 +4947,12 @@ CleanupItem (
         PTSTR                               HubName = NULL;
         PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfoEx = NULL;
         PUSB_DESCRIPTOR_REQUEST             ConfigDesc = NULL;
-        PSTRING_DESCRIPTOR_NODE             StringDescs = NULL;
+        PSTRING_DESCRIPTORS                 StringDescs = NULL;
+        PUSB_DEVICE_QUALIFIER_DESCRIPTOR    QualifierDesc = NULL;
 
         switch (*(PUSBDEVICEINFOTYPE)info)
         {
             case HostControllerInfo:
-                //
-                // Remove this host controller from the list of enumerated
-                // host controllers.
-                //
-                RemoveEntryList(&((PUSBHOSTCONTROLLERINFO)info)->ListEntry);
-
                 DriverKey = ((PUSBHOSTCONTROLLERINFO)info)->DriverKey;
                 break;
 
@@ -2214,12 +4971,14 @@ CleanupItem (
                 ConnectionInfoEx = ((PUSBEXTERNALHUBINFO)info)->ConnectionInfo;
                 ConfigDesc = ((PUSBEXTERNALHUBINFO)info)->ConfigDesc;
                 StringDescs = ((PUSBEXTERNALHUBINFO)info)->StringDescs;
+                QualifierDesc = ((PUSBEXTERNALHUBINFO)info)->QualifierDesc;
                 break;
 
             case DeviceInfo:
                 ConnectionInfoEx = ((PUSBDEVICEINFO)info)->ConnectionInfo;
                 ConfigDesc = ((PUSBDEVICEINFO)info)->ConfigDesc;
                 StringDescs = ((PUSBDEVICEINFO)info)->StringDescs;
+                QualifierDesc = ((PUSBDEVICEINFO)info)->QualifierDesc;
                 break;
         }
 
@@ -2253,17 +5012,11 @@ CleanupItem (
             FREE(ConfigDesc);
         }
 
-        if (StringDescs)
-        {
-            PSTRING_DESCRIPTOR_NODE Next;
-
-            do {
+        FreeStringDescriptors(StringDescs);
 
-                Next = StringDescs->Next;
-                FREE(StringDescs);
-                StringDescs = Next;
-
-            } while (StringDescs);
+        if (QualifierDesc)
+        {
+            FREE(QualifierDesc);
         }
 
         if (ConnectionInfoEx)
@@ -2275,6 +5028,203 @@ CleanupItem (
     }
 }
 
+//*****************************************************************************
+//
+// AddTreeNode()
+//
+// Parent - Node to which the new node is appended as the last child.  Only
+// the thread building Parent's subtree may add children to it.
+//
+// Info - USBxxxINFO structure for the node, or NULL for a hub which has
+// not been enumerated yet.
+//
+// Text - Label for the node, copied.  May be NULL.
+//
+//*****************************************************************************
+
+PUSBTREENODE
+AddTreeNode (
+    PUSBTREENODE    Parent,
+    PVOID           Info,
+    __in_opt PCTSTR Text,
+    TREEICON        Icon
+)
+{
+    PUSBTREENODE node;
+
+    node = (PUSBTREENODE)ALLOC(sizeof(USBTREENODE));
+
+    if (node == NULL)
+    {
+        return NULL;
+    }
+
+    if (!SetTreeNode(node, Info, Text, Icon))
+    {
+        FREE(node);
+        return NULL;
+    }
+
+    node->Parent = Parent;
+
+    if (Parent->LastChild)
+    {
+        Parent->LastChild->NextSibling = node;
+    }
+    else
+    {
+        Parent->FirstChild = node;
+    }
+
+    Parent->LastChild = node;
+
+    return node;
+}
+
+//*****************************************************************************
+//
+// AddPortTreeNode()
+//
+// Reserves the tree node of a hub port, which is identified by its port
+// number, and filled in once the port has been queried.
+//
+//*****************************************************************************
+
+PUSBTREENODE
+AddPortTreeNode (
+    PUSBTREENODE    Parent,
+    ULONG           ConnectionIndex
+)
+{
+    PUSBTREENODE node;
+
+    node = AddTreeNode(Parent, NULL, NULL, NoDeviceIcon);
+
+    if (node != NULL)
+    {
+        node->Id = ConnectionIndex;
+    }
+
+    return node;
+}
+
+//*****************************************************************************
+//
+// SetTreeNode()
+//
+//*****************************************************************************
+
+BOOL
+SetTreeNode (
+    PUSBTREENODE    Node,
+    PVOID           Info,
+    __in_opt PCTSTR Text,
+    TREEICON        Icon
+)
+{
+    size_t textSize;
+
+    if (Text)
+    {
+        textSize = _tcslen(Text) + 1;
+
+        Node->Text = (PTSTR)ALLOC(textSize * sizeof(TCHAR));
+
+        if (Node->Text == NULL)
+        {
+            return FALSE;
+        }
+
+        _tcscpy_s(Node->Text, textSize, Text);
+    }
+
+    Node->Info = Info;
+    Node->Icon = Icon;
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// FreeTreeNodes()
+//
+// Node - Node whose descendants are freed.  Node itself is not freed.
+//
+// FreeInfo - TRUE to free the USBxxxINFO structures as well.  Pass FALSE
+// once they have been handed to the TreeView, which then owns them.
+//
+//*****************************************************************************
+
+VOID
+FreeTreeNodes (
+    PUSBTREENODE    Node,
+    BOOL            FreeInfo
+)
+{
+    PUSBTREENODE child;
+    PUSBTREENODE next;
+
+    for (child = Node->FirstChild; child != NULL; child = next)
+    {
+        next = child->NextSibling;
+
+        FreeTreeNode(child, FreeInfo);
+    }
+
+    Node->FirstChild = NULL;
+    Node->LastChild = NULL;
+}
+
+//*****************************************************************************
+//
+// FreeSnapshot()
+//
+// Frees a snapshot which was never taken in, along with its whole tree.
+//
+//*****************************************************************************
+
+VOID
+FreeSnapshot (
+    PUSB_SNAPSHOT Snapshot
+)
+{
+    FreeTreeNodes(&Snapshot->Root, TRUE);
+
+    FREE(Snapshot);
+}
+
+//*****************************************************************************
+//
+// FreeTreeNode()
+//
+// Node - Node which is freed along with its descendants.  It must not be
+// linked to a parent any longer.
+//
+// FreeInfo - As for FreeTreeNodes().
+//
+//*****************************************************************************
+
+VOID
+FreeTreeNode (
+    PUSBTREENODE    Node,
+    BOOL            FreeInfo
+)
+{
+    FreeTreeNodes(Node, FreeInfo);
+
+    if (FreeInfo)
+    {
+        FreeDeviceInfo(Node->Info);
+    }
+
+    if (Node->Text)
+    {
+        FREE(Node->Text);
+    }
+
+    FREE(Node);
+}
+
 #if _MSC_VER >= 1200
 #pragma warning(pop)
 #endif
@@ -0,0 +1,410 @@
+/*++
+
+Copyright (c) 1997-1998 Microsoft Corporation
+
+Module Name:
+
+    ENUMTHRD.C
+
+Abstract:
+
+    This source file contains the enumeration thread, which keeps the UI
+    thread responsive while the USB devices are enumerated.
+
+    The UI asks for an enumeration with RequestEnumeration().  The thread
+    builds a USB_SNAPSHOT and posts it to the window, which takes it in with
+    one message.  Requests made while an enumeration runs leave at most one
+    more enumeration to do once it is over.  Requests are numbered, and
+    each snapshot is posted with the last one it answers.  An enumeration
+    which could not be done posts no snapshot, but still answers them.
+
+    The thread also fetches the lazy descriptors the detail view asks for
+    with RequestLazyDescriptors(), so a device which does not answer does
+    not hang the window.  They are fetched before the next enumeration
+    starts, and each is posted to the window on its own.
+
+Environment:
+
+    user mode
+
+Revision History:
+
+    10-16-26 : created
+
+--*/
+
+//*****************************************************************************
+// I N C L U D E S
+//*****************************************************************************
+
+#include <windows.h>
+#include <basetyps.h>
+#include <winioctl.h>
+#include "usbview.h"
+
+//*****************************************************************************
+// D E F I N E S
+//*****************************************************************************
+
+// How long StopEnumerationThread() waits for an enumeration to finish.  A
+// device which never completes a request would otherwise keep the program
+// from exiting.
+//
+#define ENUM_STOP_TIMEOUT   5000    // ms
+
+//*****************************************************************************
+// L O C A L    F U N C T I O N    P R O T O T Y P E S
+//*****************************************************************************
+
+DWORD WINAPI
+EnumerationThread (
+    LPVOID  Parameter
+);
+
+VOID
+FetchQueuedLazyDescriptors (
+    VOID
+);
+
+VOID
+FreeQueuedLazyDescriptors (
+    PLAZY_DESC_REQUEST  Requests
+);
+
+//*****************************************************************************
+// G L O B A L S    P R I V A T E    T O    T H I S    F I L E
+//*****************************************************************************
+
+HANDLE          hEnumThread;
+HANDLE          hEnumRequestEvent;      // auto reset
+volatile LONG   EnumRequests;           // number of the last request
+volatile BOOL   EnumStopRequested;
+HWND            hEnumNotifyWnd;
+UINT            EnumNotifyMessage;
+UINT            EnumDescMessage;
+
+// Lazy descriptor requests not taken by the thread yet, newest first
+//
+CRITICAL_SECTION    LazyQueueLock;
+PLAZY_DESC_REQUEST  LazyQueue;
+
+
+//*****************************************************************************
+//
+// StartEnumerationThread()
+//
+// hWnd, Message - Each snapshot is posted to hWnd as Message, with the
+// PUSB_SNAPSHOT in lParam and the last request it answers in wParam.  The
+// window owns it from then on.  lParam is NULL if the snapshot could not
+// be built.
+//
+// DescMessage - Each request queued by QueueLazyDescriptors() is posted
+// back to hWnd as DescMessage, with the PLAZY_DESC_REQUEST in lParam.
+//
+//*****************************************************************************
+
+BOOL
+StartEnumerationThread (
+    HWND    hWnd,
+    UINT    Message,
+    UINT    DescMessage
+)
+{
+    DWORD threadId;
+
+    hEnumNotifyWnd = hWnd;
+    EnumNotifyMessage = Message;
+    EnumDescMessage = DescMessage;
+    EnumStopRequested = FALSE;
+    LazyQueue = NULL;
+
+    hEnumRequestEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+
+    if (hEnumRequestEvent == NULL)
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    InitializeCriticalSection(&LazyQueueLock);
+
+    hEnumThread = CreateThread(NULL,
+                               0,
+                               EnumerationThread,
+                               NULL,
+                               0,
+                               &threadId);
+
+    if (hEnumThread == NULL)
+    {
+        OOPS();
+        DeleteCriticalSection(&LazyQueueLock);
+        CloseHandle(hEnumRequestEvent);
+        hEnumRequestEvent = NULL;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// RequestEnumeration()
+//
+// Returns the number of the request.  The first snapshot posted for that
+// request or a later one was enumerated after it was made.
+//
+//*****************************************************************************
+
+ULONG
+RequestEnumeration (
+    VOID
+)
+{
+    ULONG request;
+
+    request = (ULONG)InterlockedIncrement(&EnumRequests);
+
+    if (hEnumRequestEvent != NULL)
+    {
+        SetEvent(hEnumRequestEvent);
+    }
+
+    return request;
+}
+
+//*****************************************************************************
+//
+// QueueLazyDescriptors()
+//
+// Request - Set up by RequestLazyDescriptors(), owned by the thread once
+// this returns TRUE.  Returns FALSE if there is no thread to fetch them.
+//
+//*****************************************************************************
+
+BOOL
+QueueLazyDescriptors (
+    PLAZY_DESC_REQUEST  Request
+)
+{
+    if (hEnumThread == NULL)
+    {
+        return FALSE;
+    }
+
+    EnterCriticalSection(&LazyQueueLock);
+
+    Request->Next = LazyQueue;
+    LazyQueue = Request;
+
+    LeaveCriticalSection(&LazyQueueLock);
+
+    SetEvent(hEnumRequestEvent);
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// StopEnumerationThread()
+//
+// Waits for the enumeration which is running, if any.  Returns FALSE if
+// the thread did not stop within ENUM_STOP_TIMEOUT, in which case it is
+// abandoned.
+//
+//*****************************************************************************
+
+BOOL
+StopEnumerationThread (
+    VOID
+)
+{
+    BOOL stopped;
+
+    if (hEnumThread == NULL)
+    {
+        return TRUE;
+    }
+
+    EnumStopRequested = TRUE;
+
+    SetEvent(hEnumRequestEvent);
+
+    stopped = WaitForSingleObject(hEnumThread, ENUM_STOP_TIMEOUT) == WAIT_OBJECT_0;
+
+    if (!stopped)
+    {
+        OOPS();
+    }
+
+    CloseHandle(hEnumThread);
+    hEnumThread = NULL;
+
+    // An abandoned thread still waits on the event and may still take
+    // requests from the queue
+    //
+    if (stopped)
+    {
+        FreeQueuedLazyDescriptors(LazyQueue);
+        LazyQueue = NULL;
+
+        DeleteCriticalSection(&LazyQueueLock);
+
+        CloseHandle(hEnumRequestEvent);
+    }
+
+    hEnumRequestEvent = NULL;
+
+    return stopped;
+}
+
+//*****************************************************************************
+//
+// EnumerationThread()
+//
+//*****************************************************************************
+
+DWORD WINAPI
+EnumerationThread (
+    LPVOID  Parameter
+)
+{
+    HANDLE          hRequestEvent;
+    PUSB_SNAPSHOT   snapshot;
+    ENUM_CONTEXT    context;
+    ULONG           request;
+    ULONG           answered;
+
+    UNREFERENCED_PARAMETER(Parameter);
+
+    hRequestEvent = hEnumRequestEvent;
+
+    answered = 0;
+
+    for (;;)
+    {
+        WaitForSingleObject(hRequestEvent, INFINITE);
+
+        if (EnumStopRequested)
+        {
+            break;
+        }
+
+        // The window shows the selection without them until they are in
+        //
+        FetchQueuedLazyDescriptors();
+
+        if (EnumStopRequested)
+        {
+            break;
+        }
+
+        // Every request made so far is answered by what is enumerated from
+        // now on, later ones set the event again.  None may have been made
+        // if only lazy descriptors were asked for.
+        //
+        request = (ULONG)EnumRequests;
+
+        if (request == answered)
+        {
+            continue;
+        }
+
+        answered = request;
+
+        snapshot = (PUSB_SNAPSHOT)ALLOC(sizeof(USB_SNAPSHOT));
+
+        if (snapshot == NULL)
+        {
+            // The window still has to know this request is over
+            //
+            OOPS();
+        }
+        else
+        {
+            InitEnumContext(&context, snapshot);
+
+            EnumerateHostControllers(&context);
+        }
+
+        if (EnumStopRequested ||
+            !PostMessage(hEnumNotifyWnd,
+                         EnumNotifyMessage,
+                         (WPARAM)request,
+                         (LPARAM)snapshot))
+        {
+            if (snapshot != NULL)
+            {
+                FreeSnapshot(snapshot);
+            }
+        }
+    }
+
+    return 0;
+}
+
+//*****************************************************************************
+//
+// FetchQueuedLazyDescriptors()
+//
+// Fetches and posts the lazy descriptors queued so far.  What is left when
+// the thread is asked to stop is freed.
+//
+//*****************************************************************************
+
+VOID
+FetchQueuedLazyDescriptors (
+    VOID
+)
+{
+    PLAZY_DESC_REQUEST  requests;
+    PLAZY_DESC_REQUEST  request;
+
+    EnterCriticalSection(&LazyQueueLock);
+
+    requests = LazyQueue;
+    LazyQueue = NULL;
+
+    LeaveCriticalSection(&LazyQueueLock);
+
+    while (requests != NULL && !EnumStopRequested)
+    {
+        request = requests;
+        requests = request->Next;
+
+        FetchLazyDescriptors(request);
+
+        if (EnumStopRequested ||
+            !PostMessage(hEnumNotifyWnd,
+                         EnumDescMessage,
+                         0,
+                         (LPARAM)request))
+        {
+            FreeLazyDescriptors(request);
+        }
+    }
+
+    FreeQueuedLazyDescriptors(requests);
+}
+
+//*****************************************************************************
+//
+// FreeQueuedLazyDescriptors()
+//
+//*****************************************************************************
+
+VOID
+FreeQueuedLazyDescriptors (
+    PLAZY_DESC_REQUEST  Requests
+)
+{
+    PLAZY_DESC_REQUEST  request;
+
+    while (Requests != NULL)
+    {
+        request = Requests;
+        Requests = request->Next;
+
+        FreeLazyDescriptors(request);
+    }
+}
@@ -31,7 +31,27 @@ L32OBJS         =   usbview.obj \
                     display.obj \
                     debug.obj   \
                     devnode.obj \
-                    dispaud.obj
+                    dispaud.obj \
+                    devaccess.obj \
+                    devtrace.obj \
+                    workpool.obj \
+                    devsim.obj  \
+                    bench.obj   \
+                    desccache.obj \
+                    treediff.obj \
+                    refsched.obj \
+                    enumthrd.obj \
+                    rendcache.obj \
+                    textsink.obj \
+                    usbids.obj  \
+                    strdesc.obj \
+                    cfgindex.obj \
+                    classdec.obj \
+                    dispcdc.obj \
+                    dispvid.obj \
+                    serial.obj \
+                    bandwidth.obj \
+                    speed.obj
 
 !INCLUDE $(ROOT)\DEV\MASTER.MK
 
@@ -0,0 +1,229 @@
+/*++
+
+Copyright (c) 1997-1998 Microsoft Corporation
+
+Module Name:
+
+    REFSCHED.C
+
+Abstract:
+
+    This source file contains the refresh scheduler, which folds bursts of
+    device change notifications into a single refresh.
+
+    A refresh is due once no notification has come for the quiet period,
+    or at the latest the maximum delay after the first notification which
+    is still waiting, so a steady stream of notifications cannot put it off
+    forever.  While a refresh runs, any number of notifications leave just
+    one more refresh pending.  Only the snapshot of the request the
+    refresh made ends it, not one of an earlier refresh, such as a manual
+    one, which was already under way.
+
+    The scheduler only keeps state and does the arithmetic; the caller owns
+    the timer and runs the refresh.  Time comes from a clock callback so the
+    logic can be driven by a simulated clock.
+
+Environment:
+
+    user mode
+
+Revision History:
+
+    10-16-26 : created
+
+--*/
+
+//*****************************************************************************
+// I N C L U D E S
+//*****************************************************************************
+
+#include <windows.h>
+#include <basetyps.h>
+#include <winioctl.h>
+#include <string.h>
+#include "usbview.h"
+
+//*****************************************************************************
+// L O C A L    F U N C T I O N    P R O T O T Y P E S
+//*****************************************************************************
+
+ULONG
+GetSystemTicks (
+    PVOID   Context
+);
+
+
+//*****************************************************************************
+//
+// InitRefreshScheduler()
+//
+// QuietPeriod - ms without notifications after which a refresh is due.
+//
+// MaxDelay - ms after the first waiting notification after which a refresh
+// is due regardless.
+//
+// GetTicks, ClockContext - Clock in ms, or NULL for GetTickCount().
+//
+//*****************************************************************************
+
+VOID
+InitRefreshScheduler (
+    PREFRESH_SCHEDULER  Scheduler,
+    ULONG               QuietPeriod,
+    ULONG               MaxDelay,
+    __in_opt LPFNGETTICKS GetTicks,
+    __in_opt PVOID      ClockContext
+)
+{
+    memset(Scheduler, 0, sizeof(REFRESH_SCHEDULER));
+
+    Scheduler->QuietPeriod = QuietPeriod;
+    Scheduler->MaxDelay = max(MaxDelay, QuietPeriod);
+    Scheduler->GetTicks = GetTicks ? GetTicks : GetSystemTicks;
+    Scheduler->ClockContext = ClockContext;
+}
+
+//*****************************************************************************
+//
+// RequestRefresh()
+//
+// Records a notification.  Returns the ms until the refresh is due, see
+// GetRefreshDelay().
+//
+//*****************************************************************************
+
+ULONG
+RequestRefresh (
+    PREFRESH_SCHEDULER  Scheduler
+)
+{
+    ULONG now;
+
+    now = (*Scheduler->GetTicks)(Scheduler->ClockContext);
+
+    Scheduler->Notifications++;
+
+    if (Scheduler->Pending)
+    {
+        Scheduler->Folded++;
+    }
+    else
+    {
+        Scheduler->Pending = TRUE;
+        Scheduler->FirstRequest = now;
+    }
+
+    Scheduler->LastRequest = now;
+
+    return GetRefreshDelay(Scheduler);
+}
+
+//*****************************************************************************
+//
+// GetRefreshDelay()
+//
+// Returns 0 if a refresh is due now, the ms until it is due, or INFINITE if
+// none is pending or one is running.  In the last case, ask again once
+// EndScheduledRefresh() was called.
+//
+//*****************************************************************************
+
+ULONG
+GetRefreshDelay (
+    PREFRESH_SCHEDULER  Scheduler
+)
+{
+    ULONG now;
+    ULONG sinceFirst;
+    ULONG sinceLast;
+
+    if (!Scheduler->Pending || Scheduler->Running)
+    {
+        return INFINITE;
+    }
+
+    now = (*Scheduler->GetTicks)(Scheduler->ClockContext);
+
+    // Unsigned, so this is right across a wrap of the tick count
+    //
+    sinceFirst = now - Scheduler->FirstRequest;
+    sinceLast = now - Scheduler->LastRequest;
+
+    if (sinceLast >= Scheduler->QuietPeriod ||
+        sinceFirst >= Scheduler->MaxDelay)
+    {
+        return 0;
+    }
+
+    return min(Scheduler->QuietPeriod - sinceLast,
+               Scheduler->MaxDelay - sinceFirst);
+}
+
+//*****************************************************************************
+//
+// BeginScheduledRefresh()
+//
+// Called once the refresh was requested.  The notifications so far are
+// taken care of by it, later ones make another one pending.
+//
+// Request - What the refresh was requested as, see RequestEnumeration().
+//
+//*****************************************************************************
+
+VOID
+BeginScheduledRefresh (
+    PREFRESH_SCHEDULER  Scheduler,
+    ULONG               Request
+)
+{
+    Scheduler->Pending = FALSE;
+    Scheduler->Running = TRUE;
+    Scheduler->Request = Request;
+    Scheduler->Refreshes++;
+}
+
+//*****************************************************************************
+//
+// EndScheduledRefresh()
+//
+// Called for each snapshot taken in.  Request - The last request the
+// snapshot answers.  The running refresh is done if that is its own
+// request or a later one.  Returns the ms until the next one is due, see
+// GetRefreshDelay().
+//
+//*****************************************************************************
+
+ULONG
+EndScheduledRefresh (
+    PREFRESH_SCHEDULER  Scheduler,
+    ULONG               Request
+)
+{
+    // Unsigned, so this is right across a wrap of the request count
+    //
+    if (Scheduler->Running &&
+        (LONG)(Request - Scheduler->Request) >= 0)
+    {
+        Scheduler->Running = FALSE;
+    }
+
+    return GetRefreshDelay(Scheduler);
+}
+
+//*****************************************************************************
+//
+// GetSystemTicks()
+//
+// The default LPFNGETTICKS.
+//
+//*****************************************************************************
+
+ULONG
+GetSystemTicks (
+    PVOID   Context
+)
+{
+    UNREFERENCED_PARAMETER(Context);
+
+    return GetTickCount();
+}
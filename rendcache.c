@@ -0,0 +1,560 @@
+/*++
+
+Copyright (c) 1997-1998 Microsoft Corporation
+
+Module Name:
+
+    RENDCACHE.C
+
+Abstract:
+
+    This source file contains the render cache, which keeps the detail text
+    formatted for each TreeView item so that selecting it again only costs
+    a SetWindowText().
+
+    An entry is keyed by the item and dropped when the item is deleted, or
+    when a refresh gives the item info which would render differently, see
+    RenderCacheInfoChanged().  The text of all entries together is kept
+    under a budget, the least recently used entries are dropped first.
+
+    Only the UI thread uses the cache, so it has no lock.
+
+Environment:
+
+    user mode
+
+Revision History:
+
+    10-16-26 : created
+
+--*/
+
+//*****************************************************************************
+// I N C L U D E S
+//*****************************************************************************
+
+#include <windows.h>
+#include <basetyps.h>
+#include <winioctl.h>
+#include <string.h>
+#include <tchar.h>
+#include "usbview.h"
+
+#if _MSC_VER >= 1200
+#pragma warning(push)
+#endif
+#pragma warning(disable:4200) // named type definition in parentheses
+
+//*****************************************************************************
+// D E F I N E S
+//*****************************************************************************
+
+#define RENDER_CACHE_BUCKETS    512     // power of 2
+
+//*****************************************************************************
+// T Y P E D E F S
+//*****************************************************************************
+
+typedef struct _RENDER_CACHE_ENTRY
+{
+    LIST_ENTRY                  ListEntry;  // in RenderCacheLru, oldest first
+    struct _RENDER_CACHE_ENTRY *Next;       // in its bucket
+    PVOID                       Key;
+    ULONG                       Size;       // bytes, entry included
+    TCHAR                       Text[0];
+} RENDER_CACHE_ENTRY, *PRENDER_CACHE_ENTRY;
+
+//*****************************************************************************
+// L O C A L    F U N C T I O N    P R O T O T Y P E S
+//*****************************************************************************
+
+PRENDER_CACHE_ENTRY *
+FindRenderCacheEntry (
+    PVOID   Key
+);
+
+VOID
+DropRenderCacheEntry (
+    PRENDER_CACHE_ENTRY *Link
+);
+
+BOOL
+SameBytes (
+    __in_opt PVOID  Old,
+    __in_opt PVOID  New,
+    ULONG           Size
+);
+
+BOOL
+SameString (
+    __in_opt PCTSTR Old,
+    __in_opt PCTSTR New
+);
+
+BOOL
+SameConnectionInfo (
+    __in_opt PUSB_NODE_CONNECTION_INFORMATION_EX Old,
+    __in_opt PUSB_NODE_CONNECTION_INFORMATION_EX New
+);
+
+BOOL
+SameConfigDesc (
+    __in_opt PUSB_DESCRIPTOR_REQUEST Old,
+    __in_opt PUSB_DESCRIPTOR_REQUEST New
+);
+
+//*****************************************************************************
+// G L O B A L S    P R I V A T E    T O    T H I S    F I L E
+//*****************************************************************************
+
+PRENDER_CACHE_ENTRY RenderCacheBuckets[RENDER_CACHE_BUCKETS];
+LIST_ENTRY          RenderCacheLru;
+ULONG               RenderCacheSize;
+ULONG               RenderCacheBudget;
+
+
+//*****************************************************************************
+//
+// SetRenderCacheBudget()
+//
+// Budget - Bytes the cached text may take up, 0 to not cache at all.
+// Entries over the new budget are dropped right away.
+//
+//*****************************************************************************
+
+VOID
+SetRenderCacheBudget (
+    ULONG   Budget
+)
+{
+    if (RenderCacheLru.Flink == NULL)
+    {
+        RenderCacheLru.Flink = RenderCacheLru.Blink = &RenderCacheLru;
+    }
+
+    RenderCacheBudget = Budget;
+
+    while (RenderCacheSize > RenderCacheBudget)
+    {
+        InvalidateRenderCache(((PRENDER_CACHE_ENTRY)RenderCacheLru.Flink)->Key);
+    }
+}
+
+//*****************************************************************************
+//
+// LookupRenderCache()
+//
+// Key - The TreeView item whose text is wanted.
+//
+// Returns the cached text, which stays valid until the cache is next
+// changed, or NULL if there is none.
+//
+//*****************************************************************************
+
+PCTSTR
+LookupRenderCache (
+    PVOID   Key
+)
+{
+    PRENDER_CACHE_ENTRY *link;
+    PRENDER_CACHE_ENTRY entry;
+
+    if (RenderCacheBudget == 0)
+    {
+        return NULL;
+    }
+
+    link = FindRenderCacheEntry(Key);
+
+    if (*link == NULL)
+    {
+        return NULL;
+    }
+
+    // Now the most recently used
+    //
+    entry = *link;
+
+    RemoveEntryList(&entry->ListEntry);
+    InsertTailList(&RenderCacheLru, &entry->ListEntry);
+
+    return entry->Text;
+}
+
+//*****************************************************************************
+//
+// AddRenderCache()
+//
+// Key - The TreeView item the text was rendered for.
+//
+// Text, Length - The text, Length characters without the terminator.  It
+// is copied, replacing what was cached for Key.
+//
+//*****************************************************************************
+
+VOID
+AddRenderCache (
+    PVOID   Key,
+    PCTSTR  Text,
+    ULONG   Length
+)
+{
+    PRENDER_CACHE_ENTRY entry;
+    ULONG               size;
+
+    InvalidateRenderCache(Key);
+
+    size = sizeof(RENDER_CACHE_ENTRY) + (Length + 1) * sizeof(TCHAR);
+
+    // Text which alone does not fit is simply rendered every time
+    //
+    if (size > RenderCacheBudget)
+    {
+        return;
+    }
+
+    while (RenderCacheSize + size > RenderCacheBudget)
+    {
+        InvalidateRenderCache(((PRENDER_CACHE_ENTRY)RenderCacheLru.Flink)->Key);
+    }
+
+    entry = (PRENDER_CACHE_ENTRY)ALLOC(size);
+
+    if (entry == NULL)
+    {
+        OOPS();
+        return;
+    }
+
+    entry->Key = Key;
+    entry->Size = size;
+
+    memcpy(entry->Text, Text, Length * sizeof(TCHAR));
+    entry->Text[Length] = 0;
+
+    entry->Next = RenderCacheBuckets[((ULONG_PTR)Key >> 4) & (RENDER_CACHE_BUCKETS - 1)];
+    RenderCacheBuckets[((ULONG_PTR)Key >> 4) & (RENDER_CACHE_BUCKETS - 1)] = entry;
+
+    InsertTailList(&RenderCacheLru, &entry->ListEntry);
+
+    RenderCacheSize += size;
+}
+
+//*****************************************************************************
+//
+// InvalidateRenderCache()
+//
+// Drops what was cached for Key, if anything.
+//
+//*****************************************************************************
+
+VOID
+InvalidateRenderCache (
+    PVOID   Key
+)
+{
+    PRENDER_CACHE_ENTRY *link;
+
+    if (RenderCacheSize == 0)
+    {
+        return;
+    }
+
+    link = FindRenderCacheEntry(Key);
+
+    if (*link != NULL)
+    {
+        DropRenderCacheEntry(link);
+    }
+}
+
+//*****************************************************************************
+//
+// FreeRenderCache()
+//
+// Drops every entry, before exiting.
+//
+//*****************************************************************************
+
+VOID
+FreeRenderCache (
+    VOID
+)
+{
+    ULONG   i;
+
+    for (i = 0; i < RENDER_CACHE_BUCKETS; i++)
+    {
+        while (RenderCacheBuckets[i] != NULL)
+        {
+            DropRenderCacheEntry(&RenderCacheBuckets[i]);
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// RenderCacheInfoChanged()
+//
+// Old, New - The info a TreeView item had and the info a refresh gave it,
+// any of the USBxxxINFO structures or NULL.
+//
+// Returns TRUE unless everything RenderDeviceInfo() shows is the same in
+// both.  Info whose descriptors were not fetched yet counts as changed if
+// the other has them, it may render differently once they are.
+//
+//*****************************************************************************
+
+BOOL
+RenderCacheInfoChanged (
+    __in_opt PVOID  Old,
+    __in_opt PVOID  New
+)
+{
+    if (Old == NULL || New == NULL)
+    {
+        return Old != New;
+    }
+
+    if (*(PUSBDEVICEINFOTYPE)Old != *(PUSBDEVICEINFOTYPE)New)
+    {
+        return TRUE;
+    }
+
+    switch (*(PUSBDEVICEINFOTYPE)New)
+    {
+        case HostControllerInfo:
+        {
+            PUSBHOSTCONTROLLERINFO oldInfo = (PUSBHOSTCONTROLLERINFO)Old;
+            PUSBHOSTCONTROLLERINFO newInfo = (PUSBHOSTCONTROLLERINFO)New;
+
+            return oldInfo->VendorID != newInfo->VendorID ||
+                   oldInfo->DeviceID != newInfo->DeviceID ||
+                   oldInfo->SubSysID != newInfo->SubSysID ||
+                   oldInfo->Revision != newInfo->Revision ||
+                   !SameBytes(&oldInfo->Bandwidth, &newInfo->Bandwidth,
+                              sizeof(USB_BANDWIDTH)) ||
+                   !SameBytes(&oldInfo->ScheduleMap, &newInfo->ScheduleMap,
+                              sizeof(USB_SCHEDULE_MAP)) ||
+                   !SameString(oldInfo->DriverKey, newInfo->DriverKey);
+        }
+
+        case RootHubInfo:
+        {
+            PUSBROOTHUBINFO oldInfo = (PUSBROOTHUBINFO)Old;
+            PUSBROOTHUBINFO newInfo = (PUSBROOTHUBINFO)New;
+
+            return !SameString(oldInfo->HubName, newInfo->HubName) ||
+                   !SameBytes(&oldInfo->Bandwidth, &newInfo->Bandwidth,
+                              sizeof(USB_BANDWIDTH)) ||
+                   !SameBytes(oldInfo->HubInfo, newInfo->HubInfo,
+                              sizeof(USB_NODE_INFORMATION)) ||
+                   !SameBytes(oldInfo->HubCaps, newInfo->HubCaps,
+                              sizeof(USB_HUB_CAPABILITIES)) ||
+#if (_WIN32_WINNT >= 0x0600)
+                   !SameBytes(oldInfo->HubCapsEx, newInfo->HubCapsEx,
+                              sizeof(USB_HUB_CAPABILITIES_EX)) ||
+#endif
+                   FALSE;
+        }
+
+        case ExternalHubInfo:
+        {
+            PUSBEXTERNALHUBINFO oldInfo = (PUSBEXTERNALHUBINFO)Old;
+            PUSBEXTERNALHUBINFO newInfo = (PUSBEXTERNALHUBINFO)New;
+
+            return !SameString(oldInfo->HubName, newInfo->HubName) ||
+                   !SameBytes(&oldInfo->Bandwidth, &newInfo->Bandwidth,
+                              sizeof(USB_BANDWIDTH)) ||
+                   !SameBytes(oldInfo->HubInfo, newInfo->HubInfo,
+                              sizeof(USB_NODE_INFORMATION)) ||
+                   !SameBytes(oldInfo->HubCaps, newInfo->HubCaps,
+                              sizeof(USB_HUB_CAPABILITIES)) ||
+#if (_WIN32_WINNT >= 0x0600)
+                   !SameBytes(oldInfo->HubCapsEx, newInfo->HubCapsEx,
+                              sizeof(USB_HUB_CAPABILITIES_EX)) ||
+#endif
+                   !SameConnectionInfo(oldInfo->ConnectionInfo,
+                                       newInfo->ConnectionInfo) ||
+                   !SameConfigDesc(oldInfo->ConfigDesc,
+                                   newInfo->ConfigDesc) ||
+                   !SameStringDescriptors(oldInfo->StringDescs,
+                                          newInfo->StringDescs) ||
+                   !SameBytes(oldInfo->QualifierDesc, newInfo->QualifierDesc,
+                              sizeof(USB_DEVICE_QUALIFIER_DESCRIPTOR)) ||
+                   oldInfo->SpeedDowngrade != newInfo->SpeedDowngrade;
+        }
+
+        case DeviceInfo:
+        {
+            PUSBDEVICEINFO oldInfo = (PUSBDEVICEINFO)Old;
+            PUSBDEVICEINFO newInfo = (PUSBDEVICEINFO)New;
+
+            return !SameConnectionInfo(oldInfo->ConnectionInfo,
+                                       newInfo->ConnectionInfo) ||
+                   !SameConfigDesc(oldInfo->ConfigDesc,
+                                   newInfo->ConfigDesc) ||
+                   !SameStringDescriptors(oldInfo->StringDescs,
+                                          newInfo->StringDescs) ||
+                   !SameBytes(oldInfo->QualifierDesc, newInfo->QualifierDesc,
+                              sizeof(USB_DEVICE_QUALIFIER_DESCRIPTOR)) ||
+                   oldInfo->SpeedDowngrade != newInfo->SpeedDowngrade;
+        }
+    }
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// FindRenderCacheEntry()
+//
+// Returns the link to the entry of Key, which points to NULL if there is
+// none.
+//
+//*****************************************************************************
+
+PRENDER_CACHE_ENTRY *
+FindRenderCacheEntry (
+    PVOID   Key
+)
+{
+    PRENDER_CACHE_ENTRY *link;
+
+    link = &RenderCacheBuckets[((ULONG_PTR)Key >> 4) & (RENDER_CACHE_BUCKETS - 1)];
+
+    while (*link != NULL && (*link)->Key != Key)
+    {
+        link = &(*link)->Next;
+    }
+
+    return link;
+}
+
+//*****************************************************************************
+//
+// DropRenderCacheEntry()
+//
+//*****************************************************************************
+
+VOID
+DropRenderCacheEntry (
+    PRENDER_CACHE_ENTRY *Link
+)
+{
+    PRENDER_CACHE_ENTRY entry;
+
+    entry = *Link;
+
+    *Link = entry->Next;
+
+    RemoveEntryList(&entry->ListEntry);
+
+    RenderCacheSize -= entry->Size;
+
+    FREE(entry);
+}
+
+//*****************************************************************************
+//
+// SameBytes()
+//
+//*****************************************************************************
+
+BOOL
+SameBytes (
+    __in_opt PVOID  Old,
+    __in_opt PVOID  New,
+    ULONG           Size
+)
+{
+    if (Old == NULL || New == NULL)
+    {
+        return Old == New;
+    }
+
+    return memcmp(Old, New, Size) == 0;
+}
+
+//*****************************************************************************
+//
+// SameString()
+//
+//*****************************************************************************
+
+BOOL
+SameString (
+    __in_opt PCTSTR Old,
+    __in_opt PCTSTR New
+)
+{
+    if (Old == NULL || New == NULL)
+    {
+        return Old == New;
+    }
+
+    return _tcscmp(Old, New) == 0;
+}
+
+//*****************************************************************************
+//
+// SameConnectionInfo()
+//
+// Compares the connection information including the open pipes.
+//
+//*****************************************************************************
+
+BOOL
+SameConnectionInfo (
+    __in_opt PUSB_NODE_CONNECTION_INFORMATION_EX Old,
+    __in_opt PUSB_NODE_CONNECTION_INFORMATION_EX New
+)
+{
+    if (Old == NULL || New == NULL)
+    {
+        return Old == New;
+    }
+
+    if (Old->NumberOfOpenPipes != New->NumberOfOpenPipes)
+    {
+        return FALSE;
+    }
+
+    return memcmp(Old, New,
+                  sizeof(USB_NODE_CONNECTION_INFORMATION_EX) +
+                  Old->NumberOfOpenPipes * sizeof(USB_PIPE_INFO)) == 0;
+}
+
+//*****************************************************************************
+//
+// SameConfigDesc()
+//
+// Compares the Configuration Descriptors, not the requests which fetched
+// them.
+//
+//*****************************************************************************
+
+BOOL
+SameConfigDesc (
+    __in_opt PUSB_DESCRIPTOR_REQUEST Old,
+    __in_opt PUSB_DESCRIPTOR_REQUEST New
+)
+{
+    PUSB_CONFIGURATION_DESCRIPTOR oldDesc;
+    PUSB_CONFIGURATION_DESCRIPTOR newDesc;
+
+    if (Old == NULL || New == NULL)
+    {
+        return Old == New;
+    }
+
+    oldDesc = (PUSB_CONFIGURATION_DESCRIPTOR)(Old + 1);
+    newDesc = (PUSB_CONFIGURATION_DESCRIPTOR)(New + 1);
+
+    return oldDesc->wTotalLength == newDesc->wTotalLength &&
+           memcmp(oldDesc, newDesc, oldDesc->wTotalLength) == 0;
+}
+
+#if _MSC_VER >= 1200
+#pragma warning(pop)
+#endif
@@ -0,0 +1,1995 @@
+/*++
+
+Copyright (c) 1997-1998 Microsoft Corporation
+
+Module Name:
+
+    SERIAL.C
+
+Abstract:
+
+    This source file contains the machine readable renderers of the device
+    tree, for tools which would otherwise have to scrape the detail text.
+    One traversal walks the tree and everything the detail view shows
+    about each node, host controller PCI IDs, hub information and
+    capabilities, connection information and pipes, the Device and
+    Configuration Descriptors and the String Descriptors, and hands each
+    value to an emitter, see SERIAL_EMITTER.  There are two emitters:
+
+    JSON, written as it is produced.  Byte arrays are hex strings.
+
+    A compact binary format.  It starts with "USBV" and a version byte,
+    then the fields of the top object follow as records.  Each record is
+    a key, a varint of (field << 3) | type, then for SerialTypeUint a
+    varint value and for the other types a varint length and that many
+    bytes.  The bytes of an object or array are its records, so a reader
+    may skip what it does not know.  Varints are little endian base 128.
+
+    Strings are UTF-8 in both.
+
+Environment:
+
+    user mode
+
+Revision History:
+
+    10-16-26 : created
+
+--*/
+
+//*****************************************************************************
+// I N C L U D E S
+//*****************************************************************************
+
+#include <windows.h>
+#include <basetyps.h>
+#include <winioctl.h>
+#include <string.h>
+#include <tchar.h>
+#include "usbview.h"
+
+//*****************************************************************************
+// D E F I N E S
+//*****************************************************************************
+
+#define SERIAL_VERSION          1
+
+#define SERIAL_MAX_DEPTH        32
+#define SERIAL_INITIAL_SIZE     0x4000
+#define SERIAL_FLUSH_SIZE       0x3000      // a streaming emitter writes out this much at a time
+
+#define SERIAL_BINARY_MAGIC     "USBV"
+
+//*****************************************************************************
+// T Y P E D E F S
+//*****************************************************************************
+
+typedef enum _SERIAL_TYPE
+{
+    SerialTypeUint,
+    SerialTypeString,
+    SerialTypeBytes,
+    SerialTypeObject,
+    SerialTypeArray
+} SERIAL_TYPE;
+
+// Every value written has one of these, the name of a JSON member and the
+// field number of a binary record.  Fields are only ever appended.
+//
+typedef enum _SERIAL_FIELD
+{
+    SerialFieldVersion,
+    SerialFieldDevicesConnected,
+    SerialFieldHubs,
+    SerialFieldControllers,
+    SerialFieldNode,
+    SerialFieldType,
+    SerialFieldPort,
+    SerialFieldText,
+    SerialFieldChildren,
+    SerialFieldDriverKey,
+    SerialFieldVendorId,
+    SerialFieldDeviceId,
+    SerialFieldSubSysId,
+    SerialFieldRevision,
+    SerialFieldHubName,
+    SerialFieldHub,
+    SerialFieldBusPowered,
+    SerialFieldNumberOfPorts,
+    SerialFieldHubCharacteristics,
+    SerialFieldPowerOnToPowerGood,
+    SerialFieldHubControlCurrent,
+    SerialFieldCapabilityFlags,
+    SerialFieldHighSpeedCapable,
+    SerialFieldConnection,
+    SerialFieldConnectionStatus,
+    SerialFieldConnectionStatusName,
+    SerialFieldSpeed,
+    SerialFieldDeviceAddress,
+    SerialFieldCurrentConfigurationValue,
+    SerialFieldDeviceIsHub,
+    SerialFieldPipes,
+    SerialFieldPipe,
+    SerialFieldScheduleOffset,
+    SerialFieldDeviceDescriptor,
+    SerialFieldBcdUSB,
+    SerialFieldDeviceClass,
+    SerialFieldDeviceSubClass,
+    SerialFieldDeviceProtocol,
+    SerialFieldMaxPacketSize0,
+    SerialFieldIdVendor,
+    SerialFieldIdProduct,
+    SerialFieldBcdDevice,
+    SerialFieldIManufacturer,
+    SerialFieldIProduct,
+    SerialFieldISerialNumber,
+    SerialFieldNumConfigurations,
+    SerialFieldVendor,
+    SerialFieldProduct,
+    SerialFieldDescriptors,
+    SerialFieldDescriptor,
+    SerialFieldKind,
+    SerialFieldLength,
+    SerialFieldDescriptorType,
+    SerialFieldDescriptorSubtype,
+    SerialFieldData,
+    SerialFieldTotalLength,
+    SerialFieldNumInterfaces,
+    SerialFieldConfigurationValue,
+    SerialFieldIConfiguration,
+    SerialFieldAttributes,
+    SerialFieldMaxPower,
+    SerialFieldInterfaceNumber,
+    SerialFieldAlternateSetting,
+    SerialFieldNumEndpoints,
+    SerialFieldInterfaceClass,
+    SerialFieldInterfaceSubClass,
+    SerialFieldInterfaceProtocol,
+    SerialFieldIInterface,
+    SerialFieldEndpointAddress,
+    SerialFieldMaxPacketSize,
+    SerialFieldInterval,
+    SerialFieldStrings,
+    SerialFieldString,
+    SerialFieldIndex,
+    SerialFieldLanguageId,
+    SerialFieldValue,
+    SerialFieldBandwidthWarnings,
+    SerialFieldBandwidth,
+    SerialFieldPeriodicEndpoints,
+    SerialFieldFrameNs,
+    SerialFieldMicroframeNs,
+    SerialFieldFramePercent,
+    SerialFieldMicroframePercent,
+    SerialFieldOverThreshold,
+    SerialFieldSchedule,
+    SerialFieldPeriodicPipes,
+    SerialFieldCollisions,
+    SerialFieldHotSlots,
+    SerialFieldFrames,
+    SerialFieldMicroframes,
+    SerialFieldSlot,
+    SerialFieldPipeCount,
+    SerialFieldNs,
+    SerialFieldSpeedDowngrades,
+    SerialFieldSpeedDowngrade,
+    SerialFieldDeviceQualifier,
+    SerialFieldCount
+} SERIAL_FIELD;
+
+typedef struct _SERIAL_WRITER *PSERIAL_WRITER;
+
+// What a format does with each value of the traversal.  Key is called
+// before each value, Open and Close around the members of an object or the
+// items of an array.
+//
+typedef struct _SERIAL_EMITTER
+{
+    BOOL    Streams;    // may be written out inside an object
+
+    VOID    (*BeginDocument)(PSERIAL_WRITER Writer);
+
+    VOID    (*EndDocument)(PSERIAL_WRITER Writer);
+
+    VOID    (*Key)(PSERIAL_WRITER Writer, SERIAL_FIELD Field, SERIAL_TYPE Type);
+
+    VOID    (*Open)(PSERIAL_WRITER Writer, BOOL Array);
+
+    VOID    (*Close)(PSERIAL_WRITER Writer, BOOL Array);
+
+    VOID    (*Uint)(PSERIAL_WRITER Writer, ULONG Value);
+
+    VOID    (*String)(PSERIAL_WRITER Writer, PCSTR Utf8, ULONG Length);
+
+    VOID    (*Bytes)(PSERIAL_WRITER Writer, PUCHAR Data, ULONG Length);
+
+} SERIAL_EMITTER, *PSERIAL_EMITTER;
+
+typedef struct _SERIAL_WRITER
+{
+    PSERIAL_EMITTER Emitter;
+
+    HANDLE          hFile;      // NULL to only count the bytes
+
+    BOOL            Failed;
+
+    ULONG           Written;    // bytes handed to hFile
+
+    PUCHAR          Buffer;     // not written out yet
+    ULONG           Length;
+    ULONG           Size;
+
+    PCHAR           Utf8;       // a string being converted
+    ULONG           Utf8Size;
+
+#ifndef UNICODE
+    PWCHAR          Wide;
+    ULONG           WideSize;   // characters
+#endif
+
+    // Level 0 is the document, each open object or array adds one
+    //
+    ULONG           Depth;
+    BOOLEAN         Array[SERIAL_MAX_DEPTH];
+    ULONG           Members[SERIAL_MAX_DEPTH];
+    ULONG           Start[SERIAL_MAX_DEPTH];    // binary: where its length goes
+
+} SERIAL_WRITER;
+
+//*****************************************************************************
+// L O C A L    F U N C T I O N    P R O T O T Y P E S
+//*****************************************************************************
+
+VOID
+SerializeNode (
+    PSERIAL_WRITER  Writer,
+    PUSBTREENODE    Node
+);
+
+VOID
+SerializeHubInfo (
+    PSERIAL_WRITER              Writer,
+    PUSB_NODE_INFORMATION       HubInfo,
+    PUSB_HUB_CAPABILITIES       HubCaps,
+    PUSB_HUB_CAPABILITIES_EX    HubCapsEx
+);
+
+VOID
+SerializeBandwidth (
+    PSERIAL_WRITER  Writer,
+    PUSB_BANDWIDTH  Bandwidth
+);
+
+VOID
+SerializeScheduleMap (
+    PSERIAL_WRITER      Writer,
+    PUSB_SCHEDULE_MAP   ScheduleMap
+);
+
+VOID
+SerializeScheduleSlots (
+    PSERIAL_WRITER      Writer,
+    SERIAL_FIELD        Field,
+    PUSB_SCHEDULE_SLOT  Slots,
+    ULONG               NumSlots
+);
+
+VOID
+SerializeConnectionInfo (
+    PSERIAL_WRITER                      Writer,
+    PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfo
+);
+
+VOID
+SerializeSpeedDowngrade (
+    PSERIAL_WRITER                      Writer,
+    PUSB_DEVICE_QUALIFIER_DESCRIPTOR    QualifierDesc,
+    SPEED_DOWNGRADE                     SpeedDowngrade
+);
+
+VOID
+SerializeEndpoint (
+    PSERIAL_WRITER              Writer,
+    PUSB_ENDPOINT_DESCRIPTOR    EndpointDesc
+);
+
+VOID
+SerializeConfigDesc (
+    PSERIAL_WRITER          Writer,
+    PUSB_DESCRIPTOR_REQUEST ConfigDesc
+);
+
+VOID
+SerializeStrings (
+    PSERIAL_WRITER          Writer,
+    PSTRING_DESCRIPTORS     StringDescs
+);
+
+VOID
+SerialBegin (
+    PSERIAL_WRITER  Writer,
+    SERIAL_FIELD    Field,
+    BOOL            Array
+);
+
+VOID
+SerialEnd (
+    PSERIAL_WRITER  Writer
+);
+
+VOID
+SerialUint (
+    PSERIAL_WRITER  Writer,
+    SERIAL_FIELD    Field,
+    ULONG           Value
+);
+
+VOID
+SerialString (
+    PSERIAL_WRITER  Writer,
+    SERIAL_FIELD    Field,
+    PCTSTR          String
+);
+
+VOID
+SerialStringW (
+    PSERIAL_WRITER  Writer,
+    SERIAL_FIELD    Field,
+    PCWSTR          String,
+    ULONG           Length
+);
+
+VOID
+SerialBytes (
+    PSERIAL_WRITER  Writer,
+    SERIAL_FIELD    Field,
+    PUCHAR          Data,
+    ULONG           Length
+);
+
+VOID
+SerialPut (
+    PSERIAL_WRITER  Writer,
+    const VOID      *Data,
+    ULONG           Length
+);
+
+BOOL
+SerialReserve (
+    PSERIAL_WRITER  Writer,
+    ULONG           Length
+);
+
+VOID
+SerialFlush (
+    PSERIAL_WRITER  Writer
+);
+
+VOID
+JsonBeginDocument (
+    PSERIAL_WRITER  Writer
+);
+
+VOID
+JsonEndDocument (
+    PSERIAL_WRITER  Writer
+);
+
+VOID
+JsonKey (
+    PSERIAL_WRITER  Writer,
+    SERIAL_FIELD    Field,
+    SERIAL_TYPE     Type
+);
+
+VOID
+JsonOpen (
+    PSERIAL_WRITER  Writer,
+    BOOL            Array
+);
+
+VOID
+JsonClose (
+    PSERIAL_WRITER  Writer,
+    BOOL            Array
+);
+
+VOID
+JsonUint (
+    PSERIAL_WRITER  Writer,
+    ULONG           Value
+);
+
+VOID
+JsonString (
+    PSERIAL_WRITER  Writer,
+    PCSTR           Utf8,
+    ULONG           Length
+);
+
+VOID
+JsonBytes (
+    PSERIAL_WRITER  Writer,
+    PUCHAR          Data,
+    ULONG           Length
+);
+
+VOID
+BinaryBeginDocument (
+    PSERIAL_WRITER  Writer
+);
+
+VOID
+BinaryEndDocument (
+    PSERIAL_WRITER  Writer
+);
+
+VOID
+BinaryKey (
+    PSERIAL_WRITER  Writer,
+    SERIAL_FIELD    Field,
+    SERIAL_TYPE     Type
+);
+
+VOID
+BinaryOpen (
+    PSERIAL_WRITER  Writer,
+    BOOL            Array
+);
+
+VOID
+BinaryClose (
+    PSERIAL_WRITER  Writer,
+    BOOL            Array
+);
+
+VOID
+BinaryUint (
+    PSERIAL_WRITER  Writer,
+    ULONG           Value
+);
+
+VOID
+BinaryString (
+    PSERIAL_WRITER  Writer,
+    PCSTR           Utf8,
+    ULONG           Length
+);
+
+VOID
+BinaryBytes (
+    PSERIAL_WRITER  Writer,
+    PUCHAR          Data,
+    ULONG           Length
+);
+
+ULONG
+PutVarint (
+    PUCHAR  Buffer,
+    ULONG   Value
+);
+
+//*****************************************************************************
+// G L O B A L S    P R I V A T E    T O    T H I S    F I L E
+//*****************************************************************************
+
+// Indexed by SERIAL_FIELD
+//
+PCSTR SerialFieldNames[] =
+{
+    "version",
+    "devicesConnected",
+    "hubs",
+    "controllers",
+    "node",
+    "type",
+    "port",
+    "text",
+    "children",
+    "driverKey",
+    "vendorId",
+    "deviceId",
+    "subSysId",
+    "revision",
+    "hubName",
+    "hub",
+    "busPowered",
+    "bNumberOfPorts",
+    "wHubCharacteristics",
+    "bPowerOnToPowerGood",
+    "bHubControlCurrent",
+    "capabilityFlags",
+    "hubIs2xCapable",
+    "connection",
+    "connectionStatus",
+    "connectionStatusName",
+    "speed",
+    "deviceAddress",
+    "currentConfigurationValue",
+    "deviceIsHub",
+    "pipes",
+    "pipe",
+    "scheduleOffset",
+    "deviceDescriptor",
+    "bcdUSB",
+    "bDeviceClass",
+    "bDeviceSubClass",
+    "bDeviceProtocol",
+    "bMaxPacketSize0",
+    "idVendor",
+    "idProduct",
+    "bcdDevice",
+    "iManufacturer",
+    "iProduct",
+    "iSerialNumber",
+    "bNumConfigurations",
+    "vendor",
+    "product",
+    "descriptors",
+    "descriptor",
+    "kind",
+    "bLength",
+    "bDescriptorType",
+    "bDescriptorSubtype",
+    "data",
+    "wTotalLength",
+    "bNumInterfaces",
+    "bConfigurationValue",
+    "iConfiguration",
+    "bmAttributes",
+    "MaxPower",
+    "bInterfaceNumber",
+    "bAlternateSetting",
+    "bNumEndpoints",
+    "bInterfaceClass",
+    "bInterfaceSubClass",
+    "bInterfaceProtocol",
+    "iInterface",
+    "bEndpointAddress",
+    "wMaxPacketSize",
+    "bInterval",
+    "strings",
+    "string",
+    "index",
+    "languageId",
+    "value",
+    "bandwidthWarnings",
+    "bandwidth",
+    "periodicEndpoints",
+    "frameNs",
+    "microframeNs",
+    "framePercent",
+    "microframePercent",
+    "overThreshold",
+    "schedule",
+    "periodicPipes",
+    "collisions",
+    "hotSlots",
+    "frames",
+    "microframes",
+    "slot",
+    "pipeCount",
+    "ns",
+    "speedDowngrades",
+    "speedDowngrade",
+    "deviceQualifier"
+};
+
+C_ASSERT(sizeof(SerialFieldNames) / sizeof(SerialFieldNames[0]) == SerialFieldCount);
+
+// Indexed by USBDEVICEINFOTYPE
+//
+PCTSTR SerialInfoTypes[] =
+{
+    _T("hostController"),
+    _T("rootHub"),
+    _T("externalHub"),
+    _T("device")
+};
+
+// Indexed by CONFIG_DESC_KIND
+//
+PCTSTR SerialDescKinds[] =
+{
+    _T("configuration"),
+    _T("interface"),
+    _T("endpoint"),
+    _T("hid"),
+    _T("other"),
+    _T("invalid")
+};
+
+SERIAL_EMITTER JsonEmitter =
+{
+    TRUE,
+    JsonBeginDocument,
+    JsonEndDocument,
+    JsonKey,
+    JsonOpen,
+    JsonClose,
+    JsonUint,
+    JsonString,
+    JsonBytes
+};
+
+SERIAL_EMITTER BinaryEmitter =
+{
+    FALSE,
+    BinaryBeginDocument,
+    BinaryEndDocument,
+    BinaryKey,
+    BinaryOpen,
+    BinaryClose,
+    BinaryUint,
+    BinaryString,
+    BinaryBytes
+};
+
+const CHAR HexDigits[] = "0123456789ABCDEF";
+
+
+//*****************************************************************************
+//
+// SerializeSnapshot()
+//
+// Snapshot - The tree to write and what was counted while it was built.
+// Lazy descriptors of its devices are fetched as the detail view would.
+//
+// hFile - Where the output goes, or NULL to only produce it, as the
+// benchmark does.
+//
+// Returns the number of bytes written, 0 if that failed.
+//
+//*****************************************************************************
+
+ULONG
+SerializeSnapshot (
+    PUSB_SNAPSHOT   Snapshot,
+    SERIAL_FORMAT   Format,
+    __in_opt HANDLE hFile
+)
+{
+    SERIAL_WRITER   writer;
+    PUSBTREENODE    node;
+
+    memset(&writer, 0, sizeof(writer));
+
+    writer.Emitter = (Format == SerialFormatJson) ? &JsonEmitter : &BinaryEmitter;
+    writer.hFile = hFile;
+
+    writer.Buffer = (PUCHAR)ALLOC(SERIAL_INITIAL_SIZE);
+
+    if (writer.Buffer == NULL)
+    {
+        OOPS();
+        return 0;
+    }
+
+    writer.Size = SERIAL_INITIAL_SIZE;
+
+    writer.Emitter->BeginDocument(&writer);
+
+    SerialUint(&writer, SerialFieldVersion, SERIAL_VERSION);
+    SerialUint(&writer, SerialFieldDevicesConnected, Snapshot->DevicesConnected);
+    SerialUint(&writer, SerialFieldHubs, Snapshot->Hubs);
+    SerialUint(&writer, SerialFieldBandwidthWarnings, Snapshot->BandwidthWarnings);
+    SerialUint(&writer, SerialFieldSpeedDowngrades, Snapshot->SpeedDowngrades);
+
+    SerialBegin(&writer, SerialFieldControllers, TRUE);
+
+    for (node = Snapshot->Root.FirstChild;
+         node != NULL && !writer.Failed;
+         node = node->NextSibling)
+    {
+        SerializeNode(&writer, node);
+    }
+
+    SerialEnd(&writer);
+
+    writer.Emitter->EndDocument(&writer);
+
+    writer.Depth = 0;
+
+    SerialFlush(&writer);
+
+    FREE(writer.Buffer);
+
+    if (writer.Utf8 != NULL)
+    {
+        FREE(writer.Utf8);
+    }
+
+#ifndef UNICODE
+    if (writer.Wide != NULL)
+    {
+        FREE(writer.Wide);
+    }
+#endif
+
+    return writer.Failed ? 0 : writer.Written;
+}
+
+//*****************************************************************************
+//
+// SerializeToFile()
+//
+// FileName - File the output goes to, which is created or truncated, or
+// "-" for stdout.
+//
+//*****************************************************************************
+
+BOOL
+SerializeToFile (
+    PUSB_SNAPSHOT   Snapshot,
+    SERIAL_FORMAT   Format,
+    __in PCTSTR     FileName
+)
+{
+    HANDLE  hFile;
+    BOOL    closeFile;
+    ULONG   written;
+
+    if (_tcscmp(FileName, _T("-")) == 0)
+    {
+        hFile = GetStdHandle(STD_OUTPUT_HANDLE);
+        closeFile = FALSE;
+
+        if (hFile == NULL)
+        {
+            return FALSE;
+        }
+    }
+    else
+    {
+        hFile = CreateFile(FileName,
+                           GENERIC_WRITE,
+                           0,
+                           NULL,
+                           CREATE_ALWAYS,
+                           FILE_ATTRIBUTE_NORMAL,
+                           NULL);
+        closeFile = TRUE;
+    }
+
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    written = SerializeSnapshot(Snapshot, Format, hFile);
+
+    if (closeFile)
+    {
+        CloseHandle(hFile);
+    }
+
+    return written != 0;
+}
+
+//*****************************************************************************
+//
+// SerializeNode()
+//
+// Writes Node, what its Info holds and its children as one object.
+//
+//*****************************************************************************
+
+VOID
+SerializeNode (
+    PSERIAL_WRITER  Writer,
+    PUSBTREENODE    Node
+)
+{
+    PVOID                               info;
+    PUSBHOSTCONTROLLERINFO              hcInfo;
+    PUSB_NODE_INFORMATION               hubInfo;
+    PCTSTR                              hubName;
+    PUSB_HUB_CAPABILITIES               hubCaps;
+    PUSB_HUB_CAPABILITIES_EX            hubCapsEx;
+    PUSB_NODE_CONNECTION_INFORMATION_EX connectionInfo;
+    PUSB_DESCRIPTOR_REQUEST             configDesc;
+    PSTRING_DESCRIPTORS                 stringDescs;
+    PUSB_DEVICE_QUALIFIER_DESCRIPTOR    qualifierDesc;
+    SPEED_DOWNGRADE                     speedDowngrade;
+    PUSB_BANDWIDTH                      bandwidth;
+    PUSB_SCHEDULE_MAP                   scheduleMap;
+    PUSBTREENODE                        child;
+
+    hubInfo = NULL;
+    hubName = NULL;
+    hubCaps = NULL;
+    hubCapsEx = NULL;
+    connectionInfo = NULL;
+    configDesc = NULL;
+    stringDescs = NULL;
+    qualifierDesc = NULL;
+    speedDowngrade = SpeedNotDowngraded;
+    bandwidth = NULL;
+    scheduleMap = NULL;
+
+    SerialBegin(Writer, SerialFieldNode, FALSE);
+
+    info = Node->Info;
+
+    if (info != NULL)
+    {
+        GetLazyDescriptors(info);
+
+        SerialString(Writer, SerialFieldType,
+                     SerialInfoTypes[*(PUSBDEVICEINFOTYPE)info]);
+    }
+
+    if (Node->Id != 0)
+    {
+        SerialUint(Writer, SerialFieldPort, Node->Id);
+    }
+
+    if (Node->Text != NULL)
+    {
+        SerialString(Writer, SerialFieldText, Node->Text);
+    }
+
+    if (info != NULL)
+    {
+        switch (*(PUSBDEVICEINFOTYPE)info)
+        {
+            case HostControllerInfo:
+                hcInfo = (PUSBHOSTCONTROLLERINFO)info;
+
+                if (hcInfo->DriverKey != NULL)
+                {
+                    SerialString(Writer, SerialFieldDriverKey, hcInfo->DriverKey);
+                }
+
+                SerialUint(Writer, SerialFieldVendorId, hcInfo->VendorID);
+                SerialUint(Writer, SerialFieldDeviceId, hcInfo->DeviceID);
+                SerialUint(Writer, SerialFieldSubSysId, hcInfo->SubSysID);
+                SerialUint(Writer, SerialFieldRevision, hcInfo->Revision);
+
+                bandwidth = &hcInfo->Bandwidth;
+                scheduleMap = &hcInfo->ScheduleMap;
+                break;
+
+            case RootHubInfo:
+                hubInfo = ((PUSBROOTHUBINFO)info)->HubInfo;
+                hubName = ((PUSBROOTHUBINFO)info)->HubName;
+                hubCaps = ((PUSBROOTHUBINFO)info)->HubCaps;
+                hubCapsEx = ((PUSBROOTHUBINFO)info)->HubCapsEx;
+                bandwidth = &((PUSBROOTHUBINFO)info)->Bandwidth;
+                break;
+
+            case ExternalHubInfo:
+                hubInfo = ((PUSBEXTERNALHUBINFO)info)->HubInfo;
+                hubName = ((PUSBEXTERNALHUBINFO)info)->HubName;
+                hubCaps = ((PUSBEXTERNALHUBINFO)info)->HubCaps;
+                hubCapsEx = ((PUSBEXTERNALHUBINFO)info)->HubCapsEx;
+                bandwidth = &((PUSBEXTERNALHUBINFO)info)->Bandwidth;
+                connectionInfo = ((PUSBEXTERNALHUBINFO)info)->ConnectionInfo;
+                configDesc = ((PUSBEXTERNALHUBINFO)info)->ConfigDesc;
+                stringDescs = ((PUSBEXTERNALHUBINFO)info)->StringDescs;
+                qualifierDesc = ((PUSBEXTERNALHUBINFO)info)->QualifierDesc;
+                speedDowngrade = ((PUSBEXTERNALHUBINFO)info)->SpeedDowngrade;
+                break;
+
+            case DeviceInfo:
+                connectionInfo = ((PUSBDEVICEINFO)info)->ConnectionInfo;
+                configDesc = ((PUSBDEVICEINFO)info)->ConfigDesc;
+                stringDescs = ((PUSBDEVICEINFO)info)->StringDescs;
+                qualifierDesc = ((PUSBDEVICEINFO)info)->QualifierDesc;
+                speedDowngrade = ((PUSBDEVICEINFO)info)->SpeedDowngrade;
+                break;
+        }
+    }
+
+    if (hubName != NULL)
+    {
+        SerialString(Writer, SerialFieldHubName, hubName);
+    }
+
+    if (hubInfo != NULL)
+    {
+        SerializeHubInfo(Writer, hubInfo, hubCaps, hubCapsEx);
+    }
+
+    if (bandwidth != NULL)
+    {
+        SerializeBandwidth(Writer, bandwidth);
+    }
+
+    if (scheduleMap != NULL)
+    {
+        SerializeScheduleMap(Writer, scheduleMap);
+    }
+
+    if (connectionInfo != NULL)
+    {
+        SerializeConnectionInfo(Writer, connectionInfo);
+
+        SerializeSpeedDowngrade(Writer, qualifierDesc, speedDowngrade);
+    }
+
+    if (configDesc != NULL)
+    {
+        SerializeConfigDesc(Writer, configDesc);
+    }
+
+    if (stringDescs != NULL)
+    {
+        SerializeStrings(Writer, stringDescs);
+    }
+
+    if (Node->FirstChild != NULL)
+    {
+        SerialBegin(Writer, SerialFieldChildren, TRUE);
+
+        for (child = Node->FirstChild;
+             child != NULL && !Writer->Failed;
+             child = child->NextSibling)
+        {
+            SerializeNode(Writer, child);
+        }
+
+        SerialEnd(Writer);
+    }
+
+    SerialEnd(Writer);
+}
+
+//*****************************************************************************
+//
+// SerializeHubInfo()
+//
+//*****************************************************************************
+
+VOID
+SerializeHubInfo (
+    PSERIAL_WRITER              Writer,
+    PUSB_NODE_INFORMATION       HubInfo,
+    PUSB_HUB_CAPABILITIES       HubCaps,
+    PUSB_HUB_CAPABILITIES_EX    HubCapsEx
+)
+{
+    PUSB_HUB_INFORMATION    hubInformation;
+
+    hubInformation = &HubInfo->u.HubInformation;
+
+    SerialBegin(Writer, SerialFieldHub, FALSE);
+
+    SerialUint(Writer, SerialFieldBusPowered,
+               hubInformation->HubIsBusPowered ? 1 : 0);
+    SerialUint(Writer, SerialFieldNumberOfPorts,
+               hubInformation->HubDescriptor.bNumberOfPorts);
+    SerialUint(Writer, SerialFieldHubCharacteristics,
+               hubInformation->HubDescriptor.wHubCharacteristics);
+    SerialUint(Writer, SerialFieldPowerOnToPowerGood,
+               hubInformation->HubDescriptor.bPowerOnToPowerGood);
+    SerialUint(Writer, SerialFieldHubControlCurrent,
+               hubInformation->HubDescriptor.bHubControlCurrent);
+
+#if (_WIN32_WINNT >= 0x0600)
+    if (HubCapsEx != NULL)
+    {
+        SerialUint(Writer, SerialFieldCapabilityFlags,
+                   HubCapsEx->CapabilityFlags.ul);
+    }
+#endif
+
+    if (HubCaps != NULL)
+    {
+        SerialUint(Writer, SerialFieldHighSpeedCapable,
+                   HubCaps->HubIs2xCapable ? 1 : 0);
+    }
+
+    SerialEnd(Writer);
+}
+
+//*****************************************************************************
+//
+// SerializeBandwidth()
+//
+//*****************************************************************************
+
+VOID
+SerializeBandwidth (
+    PSERIAL_WRITER  Writer,
+    PUSB_BANDWIDTH  Bandwidth
+)
+{
+    SerialBegin(Writer, SerialFieldBandwidth, FALSE);
+
+    SerialUint(Writer, SerialFieldPeriodicEndpoints, Bandwidth->PeriodicEndpoints);
+    SerialUint(Writer, SerialFieldFrameNs, Bandwidth->FrameNs);
+    SerialUint(Writer, SerialFieldMicroframeNs, Bandwidth->MicroframeNs);
+    SerialUint(Writer, SerialFieldFramePercent, Bandwidth->FramePercent);
+    SerialUint(Writer, SerialFieldMicroframePercent, Bandwidth->MicroframePercent);
+    SerialUint(Writer, SerialFieldOverThreshold, Bandwidth->OverThreshold ? 1 : 0);
+
+    SerialEnd(Writer);
+}
+
+//*****************************************************************************
+//
+// SerializeScheduleMap()
+//
+// Only the slots something is scheduled in are written, with their index.
+//
+//*****************************************************************************
+
+VOID
+SerializeScheduleMap (
+    PSERIAL_WRITER      Writer,
+    PUSB_SCHEDULE_MAP   ScheduleMap
+)
+{
+    SerialBegin(Writer, SerialFieldSchedule, FALSE);
+
+    SerialUint(Writer, SerialFieldPeriodicPipes, ScheduleMap->PeriodicPipes);
+    SerialUint(Writer, SerialFieldCollisions, ScheduleMap->Collisions);
+    SerialUint(Writer, SerialFieldHotSlots, ScheduleMap->HotSlots);
+
+    SerializeScheduleSlots(Writer,
+                           SerialFieldFrames,
+                           ScheduleMap->Frames,
+                           SCHEDULE_FRAMES);
+
+    SerializeScheduleSlots(Writer,
+                           SerialFieldMicroframes,
+                           ScheduleMap->Microframes,
+                           SCHEDULE_MICROFRAMES);
+
+    SerialEnd(Writer);
+}
+
+//*****************************************************************************
+//
+// SerializeScheduleSlots()
+//
+//*****************************************************************************
+
+VOID
+SerializeScheduleSlots (
+    PSERIAL_WRITER      Writer,
+    SERIAL_FIELD        Field,
+    PUSB_SCHEDULE_SLOT  Slots,
+    ULONG               NumSlots
+)
+{
+    ULONG   i;
+
+    SerialBegin(Writer, Field, TRUE);
+
+    for (i = 0; i < NumSlots; i++)
+    {
+        if (Slots[i].Pipes == 0)
+        {
+            continue;
+        }
+
+        SerialBegin(Writer, SerialFieldSlot, FALSE);
+
+        SerialUint(Writer, SerialFieldIndex, i);
+        SerialUint(Writer, SerialFieldPipeCount, Slots[i].Pipes);
+        SerialUint(Writer, SerialFieldNs, Slots[i].Ns);
+
+        SerialEnd(Writer);
+    }
+
+    SerialEnd(Writer);
+}
+
+//*****************************************************************************
+//
+// SerializeConnectionInfo()
+//
+// Writes the connection, its pipes and the Device Descriptor.
+//
+//*****************************************************************************
+
+VOID
+SerializeConnectionInfo (
+    PSERIAL_WRITER                      Writer,
+    PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfo
+)
+{
+    PUSB_DEVICE_DESCRIPTOR  deviceDesc;
+    PCTSTR                  name;
+    ULONG                   i;
+
+    SerialBegin(Writer, SerialFieldConnection, FALSE);
+
+    SerialUint(Writer, SerialFieldConnectionStatus,
+               ConnectionInfo->ConnectionStatus);
+
+    // ConnectionStatuses only names those up to DeviceNotEnoughPower
+    //
+    if (ConnectionInfo->ConnectionStatus <= DeviceNotEnoughPower)
+    {
+        SerialString(Writer, SerialFieldConnectionStatusName,
+                     ConnectionStatuses[ConnectionInfo->ConnectionStatus]);
+    }
+
+    if (ConnectionInfo->ConnectionStatus != NoDeviceConnected)
+    {
+        SerialUint(Writer, SerialFieldSpeed, ConnectionInfo->Speed);
+        SerialUint(Writer, SerialFieldDeviceAddress, ConnectionInfo->DeviceAddress);
+        SerialUint(Writer, SerialFieldCurrentConfigurationValue,
+                   ConnectionInfo->CurrentConfigurationValue);
+        SerialUint(Writer, SerialFieldDeviceIsHub,
+                   ConnectionInfo->DeviceIsHub ? 1 : 0);
+
+        SerialBegin(Writer, SerialFieldPipes, TRUE);
+
+        for (i = 0; i < ConnectionInfo->NumberOfOpenPipes; i++)
+        {
+            SerialBegin(Writer, SerialFieldPipe, FALSE);
+
+            SerialUint(Writer, SerialFieldScheduleOffset,
+                       ConnectionInfo->PipeList[i].ScheduleOffset);
+
+            SerializeEndpoint(Writer, &ConnectionInfo->PipeList[i].EndpointDescriptor);
+
+            SerialEnd(Writer);
+        }
+
+        SerialEnd(Writer);
+    }
+
+    SerialEnd(Writer);
+
+    if (ConnectionInfo->ConnectionStatus == NoDeviceConnected)
+    {
+        return;
+    }
+
+    deviceDesc = &ConnectionInfo->DeviceDescriptor;
+
+    SerialBegin(Writer, SerialFieldDeviceDescriptor, FALSE);
+
+    SerialUint(Writer, SerialFieldBcdUSB, deviceDesc->bcdUSB);
+    SerialUint(Writer, SerialFieldDeviceClass, deviceDesc->bDeviceClass);
+    SerialUint(Writer, SerialFieldDeviceSubClass, deviceDesc->bDeviceSubClass);
+    SerialUint(Writer, SerialFieldDeviceProtocol, deviceDesc->bDeviceProtocol);
+    SerialUint(Writer, SerialFieldMaxPacketSize0, deviceDesc->bMaxPacketSize0);
+    SerialUint(Writer, SerialFieldIdVendor, deviceDesc->idVendor);
+    SerialUint(Writer, SerialFieldIdProduct, deviceDesc->idProduct);
+    SerialUint(Writer, SerialFieldBcdDevice, deviceDesc->bcdDevice);
+    SerialUint(Writer, SerialFieldIManufacturer, deviceDesc->iManufacturer);
+    SerialUint(Writer, SerialFieldIProduct, deviceDesc->iProduct);
+    SerialUint(Writer, SerialFieldISerialNumber, deviceDesc->iSerialNumber);
+    SerialUint(Writer, SerialFieldNumConfigurations, deviceDesc->bNumConfigurations);
+
+    name = GetVendorString(deviceDesc->idVendor);
+
+    if (name != NULL)
+    {
+        SerialString(Writer, SerialFieldVendor, name);
+    }
+
+    name = LookupUsbProductName(deviceDesc->idVendor, deviceDesc->idProduct);
+
+    if (name != NULL)
+    {
+        SerialString(Writer, SerialFieldProduct, name);
+    }
+
+    SerialEnd(Writer);
+}
+
+//*****************************************************************************
+//
+// SerializeSpeedDowngrade()
+//
+// Writes SpeedDowngrade, and the Device Qualifier Descriptor if there is
+// one, see DetectSpeedDowngrades().
+//
+//*****************************************************************************
+
+VOID
+SerializeSpeedDowngrade (
+    PSERIAL_WRITER                      Writer,
+    PUSB_DEVICE_QUALIFIER_DESCRIPTOR    QualifierDesc,
+    SPEED_DOWNGRADE                     SpeedDowngrade
+)
+{
+    SerialUint(Writer, SerialFieldSpeedDowngrade, SpeedDowngrade);
+
+    if (QualifierDesc == NULL)
+    {
+        return;
+    }
+
+    SerialBegin(Writer, SerialFieldDeviceQualifier, FALSE);
+
+    SerialUint(Writer, SerialFieldBcdUSB, QualifierDesc->bcdUSB);
+    SerialUint(Writer, SerialFieldDeviceClass, QualifierDesc->bDeviceClass);
+    SerialUint(Writer, SerialFieldDeviceSubClass, QualifierDesc->bDeviceSubClass);
+    SerialUint(Writer, SerialFieldDeviceProtocol, QualifierDesc->bDeviceProtocol);
+    SerialUint(Writer, SerialFieldMaxPacketSize0, QualifierDesc->bMaxPacketSize0);
+    SerialUint(Writer, SerialFieldNumConfigurations, QualifierDesc->bNumConfigurations);
+
+    SerialEnd(Writer);
+}
+
+//*****************************************************************************
+//
+// SerializeEndpoint()
+//
+// Writes the members of an Endpoint Descriptor into the open object.
+//
+//*****************************************************************************
+
+VOID
+SerializeEndpoint (
+    PSERIAL_WRITER              Writer,
+    PUSB_ENDPOINT_DESCRIPTOR    EndpointDesc
+)
+{
+    SerialUint(Writer, SerialFieldEndpointAddress, EndpointDesc->bEndpointAddress);
+    SerialUint(Writer, SerialFieldAttributes, EndpointDesc->bmAttributes);
+    SerialUint(Writer, SerialFieldMaxPacketSize, EndpointDesc->wMaxPacketSize);
+    SerialUint(Writer, SerialFieldInterval, EndpointDesc->bInterval);
+}
+
+//*****************************************************************************
+//
+// SerializeConfigDesc()
+//
+// Writes each descriptor of the configuration by its index entry.  The
+// standard descriptors are decoded, the others are written as they are.
+//
+//*****************************************************************************
+
+VOID
+SerializeConfigDesc (
+    PSERIAL_WRITER          Writer,
+    PUSB_DESCRIPTOR_REQUEST ConfigDesc
+)
+{
+    PCONFIG_DESC_INDEX              index;
+    PCONFIG_DESC_ENTRY              entry;
+    PUSB_COMMON_DESCRIPTOR          commonDesc;
+    PUSB_CONFIGURATION_DESCRIPTOR   configDesc;
+    PUSB_INTERFACE_DESCRIPTOR       interfaceDesc;
+
+    index = GetConfigDescIndex(ConfigDesc);
+
+    SerialBegin(Writer, SerialFieldDescriptors, TRUE);
+
+    for (entry = index->Entries;
+         entry < index->Entries + index->NumEntries && !Writer->Failed;
+         entry++)
+    {
+        commonDesc = CONFIG_ENTRY_DESC(ConfigDesc, entry);
+
+        SerialBegin(Writer, SerialFieldDescriptor, FALSE);
+
+        SerialString(Writer, SerialFieldKind, SerialDescKinds[entry->Kind]);
+        SerialUint(Writer, SerialFieldLength, commonDesc->bLength);
+        SerialUint(Writer, SerialFieldDescriptorType, commonDesc->bDescriptorType);
+
+        switch (entry->Kind)
+        {
+            case ConfigDescConfiguration:
+                configDesc = (PUSB_CONFIGURATION_DESCRIPTOR)commonDesc;
+
+                SerialUint(Writer, SerialFieldTotalLength, configDesc->wTotalLength);
+                SerialUint(Writer, SerialFieldNumInterfaces, configDesc->bNumInterfaces);
+                SerialUint(Writer, SerialFieldConfigurationValue, configDesc->bConfigurationValue);
+                SerialUint(Writer, SerialFieldIConfiguration, configDesc->iConfiguration);
+                SerialUint(Writer, SerialFieldAttributes, configDesc->bmAttributes);
+                SerialUint(Writer, SerialFieldMaxPower, configDesc->MaxPower);
+                break;
+
+            case ConfigDescInterface:
+                interfaceDesc = (PUSB_INTERFACE_DESCRIPTOR)commonDesc;
+
+                SerialUint(Writer, SerialFieldInterfaceNumber, interfaceDesc->bInterfaceNumber);
+                SerialUint(Writer, SerialFieldAlternateSetting, interfaceDesc->bAlternateSetting);
+                SerialUint(Writer, SerialFieldNumEndpoints, interfaceDesc->bNumEndpoints);
+                SerialUint(Writer, SerialFieldInterfaceClass, interfaceDesc->bInterfaceClass);
+                SerialUint(Writer, SerialFieldInterfaceSubClass, interfaceDesc->bInterfaceSubClass);
+                SerialUint(Writer, SerialFieldInterfaceProtocol, interfaceDesc->bInterfaceProtocol);
+                SerialUint(Writer, SerialFieldIInterface, interfaceDesc->iInterface);
+                break;
+
+            case ConfigDescEndpoint:
+                SerializeEndpoint(Writer, (PUSB_ENDPOINT_DESCRIPTOR)commonDesc);
+                break;
+
+            default:
+                // Class specific descriptors are told apart by the class of
+                // the interface they follow and their subtype
+                //
+                if (entry->InterfaceEntry != NO_CONFIG_ENTRY)
+                {
+                    interfaceDesc = (PUSB_INTERFACE_DESCRIPTOR)
+                        CONFIG_ENTRY_DESC(ConfigDesc,
+                                          &index->Entries[entry->InterfaceEntry]);
+
+                    SerialUint(Writer, SerialFieldInterfaceClass,
+                               interfaceDesc->bInterfaceClass);
+                    SerialUint(Writer, SerialFieldInterfaceSubClass,
+                               interfaceDesc->bInterfaceSubClass);
+                }
+
+                if (commonDesc->bLength > 2)
+                {
+                    SerialUint(Writer, SerialFieldDescriptorSubtype,
+                               ((PUCHAR)commonDesc)[2]);
+                }
+
+                SerialBytes(Writer, SerialFieldData,
+                            (PUCHAR)commonDesc, commonDesc->bLength);
+                break;
+        }
+
+        SerialEnd(Writer);
+    }
+
+    SerialEnd(Writer);
+}
+
+//*****************************************************************************
+//
+// SerializeStrings()
+//
+// Writes every String Descriptor fetched, in every language, but the list
+// of languages itself.
+//
+//*****************************************************************************
+
+VOID
+SerializeStrings (
+    PSERIAL_WRITER          Writer,
+    PSTRING_DESCRIPTORS     StringDescs
+)
+{
+    PSTRING_DESCRIPTOR_RECORD   record;
+    PUCHAR                      end;
+
+    end = (PUCHAR)StringDescs + StringDescs->Length;
+
+    SerialBegin(Writer, SerialFieldStrings, TRUE);
+
+    for (record = FIRST_STRING_RECORD(StringDescs);
+         (PUCHAR)record < end && !Writer->Failed;
+         record = NEXT_STRING_RECORD(record))
+    {
+        if (record->DescriptorIndex == 0)
+        {
+            continue;
+        }
+
+        SerialBegin(Writer, SerialFieldString, FALSE);
+
+        SerialUint(Writer, SerialFieldIndex, record->DescriptorIndex);
+        SerialUint(Writer, SerialFieldLanguageId, record->LanguageID);
+
+        // bLength is bytes, bString is WCHARs
+        //
+        SerialStringW(Writer,
+                      SerialFieldValue,
+                      record->StringDescriptor->bString,
+                      (record->StringDescriptor->bLength -
+                       offsetof(USB_STRING_DESCRIPTOR, bString)) / sizeof(WCHAR));
+
+        SerialEnd(Writer);
+    }
+
+    SerialEnd(Writer);
+}
+
+//*****************************************************************************
+//
+// SerialBegin()
+// SerialEnd()
+//
+// Open an object or array as a member of the one open, and close it.
+//
+//*****************************************************************************
+
+VOID
+SerialBegin (
+    PSERIAL_WRITER  Writer,
+    SERIAL_FIELD    Field,
+    BOOL            Array
+)
+{
+    if (Writer->Depth + 1 >= SERIAL_MAX_DEPTH)
+    {
+        OOPS();
+        Writer->Failed = TRUE;
+        return;
+    }
+
+    Writer->Emitter->Key(Writer, Field, Array ? SerialTypeArray : SerialTypeObject);
+
+    Writer->Depth++;
+
+    Writer->Array[Writer->Depth] = (BOOLEAN)Array;
+    Writer->Members[Writer->Depth] = 0;
+    Writer->Start[Writer->Depth] = Writer->Length;
+
+    Writer->Emitter->Open(Writer, Array);
+}
+
+VOID
+SerialEnd (
+    PSERIAL_WRITER  Writer
+)
+{
+    // Nothing was opened if it failed
+    //
+    if (Writer->Failed)
+    {
+        return;
+    }
+
+    Writer->Emitter->Close(Writer, Writer->Array[Writer->Depth]);
+
+    Writer->Depth--;
+
+    if (Writer->Length >= SERIAL_FLUSH_SIZE &&
+        (Writer->Emitter->Streams || Writer->Depth == 0))
+    {
+        SerialFlush(Writer);
+    }
+}
+
+//*****************************************************************************
+//
+// SerialUint()
+// SerialString()
+// SerialStringW()
+// SerialBytes()
+//
+// Write one value as a member of the open object or array.
+//
+//*****************************************************************************
+
+VOID
+SerialUint (
+    PSERIAL_WRITER  Writer,
+    SERIAL_FIELD    Field,
+    ULONG           Value
+)
+{
+    Writer->Emitter->Key(Writer, Field, SerialTypeUint);
+    Writer->Emitter->Uint(Writer, Value);
+}
+
+VOID
+SerialString (
+    PSERIAL_WRITER  Writer,
+    SERIAL_FIELD    Field,
+    PCTSTR          String
+)
+{
+#ifdef UNICODE
+    SerialStringW(Writer, Field, String, (ULONG)wcslen(String));
+#else
+    PWCHAR  wide;
+    int     chars;
+
+    chars = MultiByteToWideChar(CP_ACP, 0, String, -1, NULL, 0);
+
+    if (chars <= 0)
+    {
+        Writer->Failed = TRUE;
+        return;
+    }
+
+    if ((ULONG)chars > Writer->WideSize)
+    {
+        wide = (PWCHAR)(Writer->Wide == NULL ?
+                        ALLOC(chars * sizeof(WCHAR)) :
+                        REALLOC(Writer->Wide, chars * sizeof(WCHAR)));
+
+        if (wide == NULL)
+        {
+            OOPS();
+            Writer->Failed = TRUE;
+            return;
+        }
+
+        Writer->Wide = wide;
+        Writer->WideSize = chars;
+    }
+
+    MultiByteToWideChar(CP_ACP, 0, String, -1, Writer->Wide, chars);
+
+    SerialStringW(Writer, Field, Writer->Wide, chars - 1);
+#endif
+}
+
+VOID
+SerialStringW (
+    PSERIAL_WRITER  Writer,
+    SERIAL_FIELD    Field,
+    PCWSTR          String,
+    ULONG           Length
+)
+{
+    PCHAR   utf8;
+    int     bytes;
+
+    bytes = 0;
+
+    if (Length != 0)
+    {
+        bytes = WideCharToMultiByte(CP_UTF8, 0, String, Length,
+                                    NULL, 0, NULL, NULL);
+
+        if (bytes <= 0)
+        {
+            Writer->Failed = TRUE;
+            return;
+        }
+
+        if ((ULONG)bytes > Writer->Utf8Size)
+        {
+            utf8 = (PCHAR)(Writer->Utf8 == NULL ?
+                           ALLOC(bytes) :
+                           REALLOC(Writer->Utf8, bytes));
+
+            if (utf8 == NULL)
+            {
+                OOPS();
+                Writer->Failed = TRUE;
+                return;
+            }
+
+            Writer->Utf8 = utf8;
+            Writer->Utf8Size = bytes;
+        }
+
+        WideCharToMultiByte(CP_UTF8, 0, String, Length,
+                            Writer->Utf8, bytes, NULL, NULL);
+    }
+
+    Writer->Emitter->Key(Writer, Field, SerialTypeString);
+    Writer->Emitter->String(Writer, Writer->Utf8, bytes);
+}
+
+VOID
+SerialBytes (
+    PSERIAL_WRITER  Writer,
+    SERIAL_FIELD    Field,
+    PUCHAR          Data,
+    ULONG           Length
+)
+{
+    Writer->Emitter->Key(Writer, Field, SerialTypeBytes);
+    Writer->Emitter->Bytes(Writer, Data, Length);
+}
+
+//*****************************************************************************
+//
+// SerialPut()
+//
+// Appends Length bytes to the output.
+//
+//*****************************************************************************
+
+VOID
+SerialPut (
+    PSERIAL_WRITER  Writer,
+    const VOID      *Data,
+    ULONG           Length
+)
+{
+    if (!SerialReserve(Writer, Length))
+    {
+        return;
+    }
+
+    memcpy(Writer->Buffer + Writer->Length, Data, Length);
+
+    Writer->Length += Length;
+}
+
+//*****************************************************************************
+//
+// SerialReserve()
+//
+// Makes room for Length more bytes in the buffer.  Returns FALSE, and the
+// writer has failed, if there is not enough memory.
+//
+//*****************************************************************************
+
+BOOL
+SerialReserve (
+    PSERIAL_WRITER  Writer,
+    ULONG           Length
+)
+{
+    PUCHAR  buffer;
+    ULONG   size;
+
+    if (Writer->Failed)
+    {
+        return FALSE;
+    }
+
+    if (Writer->Size - Writer->Length >= Length)
+    {
+        return TRUE;
+    }
+
+    for (size = Writer->Size * 2; size - Writer->Length < Length; size *= 2)
+    {
+    }
+
+    buffer = (PUCHAR)REALLOC(Writer->Buffer, size);
+
+    if (buffer == NULL)
+    {
+        OOPS();
+        Writer->Failed = TRUE;
+        return FALSE;
+    }
+
+    Writer->Buffer = buffer;
+    Writer->Size = size;
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// SerialFlush()
+//
+// Writes out what is in the buffer.  Without a file it is only counted.
+//
+//*****************************************************************************
+
+VOID
+SerialFlush (
+    PSERIAL_WRITER  Writer
+)
+{
+    DWORD   bytesWritten;
+
+    if (Writer->Failed || Writer->Length == 0)
+    {
+        return;
+    }
+
+    if (Writer->hFile != NULL &&
+        (!WriteFile(Writer->hFile, Writer->Buffer, Writer->Length, &bytesWritten, NULL) ||
+         bytesWritten != Writer->Length))
+    {
+        Writer->Failed = TRUE;
+        return;
+    }
+
+    Writer->Written += Writer->Length;
+    Writer->Length = 0;
+}
+
+//*****************************************************************************
+//
+// JSON emitter
+//
+// The document is one object.  Members of an object are named by their
+// field, items of an array are not.
+//
+//*****************************************************************************
+
+VOID
+JsonBeginDocument (
+    PSERIAL_WRITER  Writer
+)
+{
+    SerialPut(Writer, "{", 1);
+}
+
+VOID
+JsonEndDocument (
+    PSERIAL_WRITER  Writer
+)
+{
+    SerialPut(Writer, "}\n", 2);
+}
+
+VOID
+JsonKey (
+    PSERIAL_WRITER  Writer,
+    SERIAL_FIELD    Field,
+    SERIAL_TYPE     Type
+)
+{
+    PCSTR   name;
+
+    UNREFERENCED_PARAMETER(Type);
+
+    if (Writer->Members[Writer->Depth]++ != 0)
+    {
+        SerialPut(Writer, ",", 1);
+    }
+
+    if (!Writer->Array[Writer->Depth])
+    {
+        name = SerialFieldNames[Field];
+
+        SerialPut(Writer, "\"", 1);
+        SerialPut(Writer, name, (ULONG)strlen(name));
+        SerialPut(Writer, "\":", 2);
+    }
+}
+
+VOID
+JsonOpen (
+    PSERIAL_WRITER  Writer,
+    BOOL            Array
+)
+{
+    SerialPut(Writer, Array ? "[" : "{", 1);
+}
+
+VOID
+JsonClose (
+    PSERIAL_WRITER  Writer,
+    BOOL            Array
+)
+{
+    SerialPut(Writer, Array ? "]" : "}", 1);
+}
+
+VOID
+JsonUint (
+    PSERIAL_WRITER  Writer,
+    ULONG           Value
+)
+{
+    CHAR    digits[10];
+    ULONG   i;
+
+    i = sizeof(digits);
+
+    do
+    {
+        digits[--i] = (CHAR)('0' + Value % 10);
+        Value /= 10;
+    }
+    while (Value != 0);
+
+    SerialPut(Writer, digits + i, sizeof(digits) - i);
+}
+
+VOID
+JsonString (
+    PSERIAL_WRITER  Writer,
+    PCSTR           Utf8,
+    ULONG           Length
+)
+{
+    CHAR    escape[6];
+    ULONG   run;
+    ULONG   i;
+    UCHAR   c;
+
+    SerialPut(Writer, "\"", 1);
+
+    // Copy runs of characters which need no escaping in one go
+    //
+    run = 0;
+
+    for (i = 0; i < Length; i++)
+    {
+        c = (UCHAR)Utf8[i];
+
+        if (c >= 0x20 && c != '"' && c != '\\')
+        {
+            continue;
+        }
+
+        SerialPut(Writer, Utf8 + run, i - run);
+
+        escape[0] = '\\';
+
+        if (c == '"' || c == '\\')
+        {
+            escape[1] = (CHAR)c;
+            SerialPut(Writer, escape, 2);
+        }
+        else
+        {
+            escape[1] = 'u';
+            escape[2] = '0';
+            escape[3] = '0';
+            escape[4] = HexDigits[c >> 4];
+            escape[5] = HexDigits[c & 0x0F];
+            SerialPut(Writer, escape, 6);
+        }
+
+        run = i + 1;
+    }
+
+    SerialPut(Writer, Utf8 + run, Length - run);
+
+    SerialPut(Writer, "\"", 1);
+}
+
+VOID
+JsonBytes (
+    PSERIAL_WRITER  Writer,
+    PUCHAR          Data,
+    ULONG           Length
+)
+{
+    PUCHAR  hex;
+    ULONG   i;
+
+    if (!SerialReserve(Writer, Length * 2 + 2))
+    {
+        return;
+    }
+
+    hex = Writer->Buffer + Writer->Length;
+
+    *hex++ = '"';
+
+    for (i = 0; i < Length; i++)
+    {
+        *hex++ = HexDigits[Data[i] >> 4];
+        *hex++ = HexDigits[Data[i] & 0x0F];
+    }
+
+    *hex++ = '"';
+
+    Writer->Length += Length * 2 + 2;
+}
+
+//*****************************************************************************
+//
+// Binary emitter
+//
+// The length of an object or array is only known once it is closed.  One
+// byte is kept for it when it is opened, and its records are moved up if
+// the length takes more.
+//
+//*****************************************************************************
+
+VOID
+BinaryBeginDocument (
+    PSERIAL_WRITER  Writer
+)
+{
+    UCHAR   version;
+
+    version = SERIAL_VERSION;
+
+    SerialPut(Writer, SERIAL_BINARY_MAGIC, sizeof(SERIAL_BINARY_MAGIC) - 1);
+    SerialPut(Writer, &version, 1);
+}
+
+VOID
+BinaryEndDocument (
+    PSERIAL_WRITER  Writer
+)
+{
+    UNREFERENCED_PARAMETER(Writer);
+}
+
+VOID
+BinaryKey (
+    PSERIAL_WRITER  Writer,
+    SERIAL_FIELD    Field,
+    SERIAL_TYPE     Type
+)
+{
+    UCHAR   key[5];
+
+    SerialPut(Writer, key, PutVarint(key, ((ULONG)Field << 3) | Type));
+}
+
+VOID
+BinaryOpen (
+    PSERIAL_WRITER  Writer,
+    BOOL            Array
+)
+{
+    UNREFERENCED_PARAMETER(Array);
+
+    SerialPut(Writer, "", 1);
+}
+
+VOID
+BinaryClose (
+    PSERIAL_WRITER  Writer,
+    BOOL            Array
+)
+{
+    UCHAR   length[5];
+    ULONG   start;
+    ULONG   contents;
+    ULONG   bytes;
+
+    UNREFERENCED_PARAMETER(Array);
+
+    start = Writer->Start[Writer->Depth];
+    contents = Writer->Length - start - 1;
+
+    bytes = PutVarint(length, contents);
+
+    if (bytes > 1)
+    {
+        if (!SerialReserve(Writer, bytes - 1))
+        {
+            return;
+        }
+
+        memmove(Writer->Buffer + start + bytes,
+                Writer->Buffer + start + 1,
+                contents);
+
+        Writer->Length += bytes - 1;
+    }
+
+    memcpy(Writer->Buffer + start, length, bytes);
+}
+
+VOID
+BinaryUint (
+    PSERIAL_WRITER  Writer,
+    ULONG           Value
+)
+{
+    UCHAR   value[5];
+
+    SerialPut(Writer, value, PutVarint(value, Value));
+}
+
+VOID
+BinaryString (
+    PSERIAL_WRITER  Writer,
+    PCSTR           Utf8,
+    ULONG           Length
+)
+{
+    BinaryBytes(Writer, (PUCHAR)Utf8, Length);
+}
+
+VOID
+BinaryBytes (
+    PSERIAL_WRITER  Writer,
+    PUCHAR          Data,
+    ULONG           Length
+)
+{
+    UCHAR   length[5];
+
+    SerialPut(Writer, length, PutVarint(length, Length));
+    SerialPut(Writer, Data, Length);
+}
+
+//*****************************************************************************
+//
+// PutVarint()
+//
+// Buffer - Room for 5 bytes.
+//
+// Returns the number of bytes Value took.
+//
+//*****************************************************************************
+
+ULONG
+PutVarint (
+    PUCHAR  Buffer,
+    ULONG   Value
+)
+{
+    ULONG   i;
+
+    for (i = 0; Value >= 0x80; i++)
+    {
+        Buffer[i] = (UCHAR)(Value | 0x80);
+        Value >>= 7;
+    }
+
+    Buffer[i++] = (UCHAR)Value;
+
+    return i;
+}
@@ -0,0 +1,250 @@
+/*++
+
+Copyright (c) 1997-1998 Microsoft Corporation
+
+Module Name:
+
+    SPEED.C
+
+Abstract:
+
+    This source file contains the detection of devices running slower than
+    they can, see SPEED_DOWNGRADE in USBVIEW.H.  It runs over a snapshot
+    once enumeration is done, and sends no requests of its own.
+
+    A bcdUSB of 0x0200 or more does not make a device high speed capable,
+    full speed only devices report it too.  A high speed capable device
+    has a Device Qualifier Descriptor, which says how it would run at the
+    other speed, and any other device stalls the request for it.  So it
+    is only asked from connected full speed devices claiming USB 2.0, the
+    only ones which can be downgraded, and those which have one are.  The
+    enumeration asks for it along with the other descriptors of the port,
+    and keeps it in the descriptor cache, see MAY_BE_DOWNGRADED().
+
+    Whether a hub or host controller upstream is not high speed tells why:
+    otherwise the device failed high speed chirp on a high speed port,
+    which is usually the cable.
+
+Environment:
+
+    user mode
+
+Revision History:
+
+    10-16-26 : created
+
+--*/
+
+//*****************************************************************************
+// I N C L U D E S
+//*****************************************************************************
+
+#include <windows.h>
+#include <basetyps.h>
+#include <winioctl.h>
+#include <string.h>
+#include <tchar.h>
+#include "usbview.h"
+
+//*****************************************************************************
+// L O C A L    F U N C T I O N    P R O T O T Y P E S
+//*****************************************************************************
+
+LONG
+CheckHubPorts (
+    PUSBTREENODE    HubNode,
+    BOOL            HighSpeed
+);
+
+BOOL
+CheckDevice (
+    PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfo,
+    PUSB_DEVICE_QUALIFIER_DESCRIPTOR    QualifierDesc,
+    BOOL                                HighSpeed,
+    SPEED_DOWNGRADE                    *SpeedDowngrade
+);
+
+BOOL
+RootHubIsHighSpeed (
+    PUSBROOTHUBINFO RootHubInfo
+);
+
+
+//*****************************************************************************
+//
+// DetectSpeedDowngrades()
+//
+// Snapshot - A complete tree.  The SpeedDowngrade of the info of each
+// device and external hub is set from its QualifierDesc, and
+// Snapshot->SpeedDowngrades counts those which are downgraded.
+//
+//*****************************************************************************
+
+VOID
+DetectSpeedDowngrades (
+    PUSB_SNAPSHOT   Snapshot
+)
+{
+    PUSBTREENODE    hcNode;
+    PUSBTREENODE    hubNode;
+    PUSBROOTHUBINFO hubInfo;
+
+    Snapshot->SpeedDowngrades = 0;
+
+    for (hcNode = Snapshot->Root.FirstChild;
+         hcNode != NULL;
+         hcNode = hcNode->NextSibling)
+    {
+        for (hubNode = hcNode->FirstChild;
+             hubNode != NULL;
+             hubNode = hubNode->NextSibling)
+        {
+            hubInfo = (PUSBROOTHUBINFO)hubNode->Info;
+
+            if (hubInfo == NULL || hubInfo->DeviceInfoType != RootHubInfo)
+            {
+                continue;
+            }
+
+            Snapshot->SpeedDowngrades +=
+                CheckHubPorts(hubNode, RootHubIsHighSpeed(hubInfo));
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// CheckHubPorts()
+//
+// HubNode - A hub, whose ports are checked.
+//
+// HighSpeed - The hub and everything above it run at high speed.
+//
+// Returns the number of devices downgraded below the hub.
+//
+//*****************************************************************************
+
+LONG
+CheckHubPorts (
+    PUSBTREENODE    HubNode,
+    BOOL            HighSpeed
+)
+{
+    PUSBTREENODE        node;
+    PUSBDEVICEINFO      deviceInfo;
+    PUSBEXTERNALHUBINFO hubInfo;
+    BOOL                hubHighSpeed;
+    LONG                downgrades;
+
+    downgrades = 0;
+
+    for (node = HubNode->FirstChild; node != NULL; node = node->NextSibling)
+    {
+        if (node->Info == NULL)
+        {
+            continue;
+        }
+
+        switch (*(PUSBDEVICEINFOTYPE)node->Info)
+        {
+            case DeviceInfo:
+                deviceInfo = (PUSBDEVICEINFO)node->Info;
+
+                if (CheckDevice(deviceInfo->ConnectionInfo,
+                                deviceInfo->QualifierDesc,
+                                HighSpeed,
+                                &deviceInfo->SpeedDowngrade))
+                {
+                    downgrades++;
+                }
+                break;
+
+            case ExternalHubInfo:
+                hubInfo = (PUSBEXTERNALHUBINFO)node->Info;
+
+                if (CheckDevice(hubInfo->ConnectionInfo,
+                                hubInfo->QualifierDesc,
+                                HighSpeed,
+                                &hubInfo->SpeedDowngrade))
+                {
+                    downgrades++;
+                }
+
+                hubHighSpeed = HighSpeed &&
+                               hubInfo->ConnectionInfo != NULL &&
+                               hubInfo->ConnectionInfo->Speed == UsbHighSpeed;
+
+                downgrades += CheckHubPorts(node, hubHighSpeed);
+                break;
+        }
+    }
+
+    return downgrades;
+}
+
+//*****************************************************************************
+//
+// CheckDevice()
+//
+// QualifierDesc - Fetched for the device during enumeration, NULL if it
+// has none or was not asked for it.
+//
+// Returns TRUE if the device is downgraded.
+//
+//*****************************************************************************
+
+BOOL
+CheckDevice (
+    PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfo,
+    PUSB_DEVICE_QUALIFIER_DESCRIPTOR    QualifierDesc,
+    BOOL                                HighSpeed,
+    SPEED_DOWNGRADE                    *SpeedDowngrade
+)
+{
+    *SpeedDowngrade = SpeedNotDowngraded;
+
+    if (ConnectionInfo == NULL ||
+        !MAY_BE_DOWNGRADED(ConnectionInfo) ||
+        QualifierDesc == NULL)
+    {
+        return FALSE;
+    }
+
+    *SpeedDowngrade = HighSpeed ? SpeedDowngradedByLink :
+                                  SpeedDowngradedByHub;
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// RootHubIsHighSpeed()
+//
+// The extended capabilities say whether the root hub runs at high speed,
+// before Vista there are only the basic ones, which say whether it can.
+//
+//*****************************************************************************
+
+BOOL
+RootHubIsHighSpeed (
+    PUSBROOTHUBINFO RootHubInfo
+)
+{
+#if (_WIN32_WINNT >= 0x0600)
+    PUSB_HUB_CAP_FLAGS  hubCapFlags;
+
+    if (RootHubInfo->HubCapsEx != NULL)
+    {
+        hubCapFlags = (PUSB_HUB_CAP_FLAGS)&RootHubInfo->HubCapsEx->CapabilityFlags;
+
+        return hubCapFlags->HubIsHighSpeed ? TRUE : FALSE;
+    }
+#endif
+
+    if (RootHubInfo->HubCaps != NULL)
+    {
+        return RootHubInfo->HubCaps->HubIs2xCapable ? TRUE : FALSE;
+    }
+
+    return FALSE;
+}
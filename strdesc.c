@@ -0,0 +1,343 @@
+/*++
+
+Copyright (c) 1997-1998 Microsoft Corporation
+
+Module Name:
+
+    STRDESC.C
+
+Abstract:
+
+    This source file contains the table the String Descriptors of a device
+    are kept in, see STRING_DESCRIPTORS in USBVIEW.H.  The records are
+    appended to one buffer as the strings are fetched, which grows as
+    needed and is trimmed when the device is done, so that a device holds
+    a single allocation for all of its strings however many there are.
+
+    Offsets into the table are kept in WORDs, which limits a table to
+    128 KB, more than enough for 255 strings in a few languages.
+
+Environment:
+
+    user mode
+
+Revision History:
+
+    10-16-26 : created
+
+--*/
+
+//*****************************************************************************
+// I N C L U D E S
+//*****************************************************************************
+
+#include <windows.h>
+#include <basetyps.h>
+#include <winioctl.h>
+#include <string.h>
+#include <tchar.h>
+#include "usbview.h"
+
+//*****************************************************************************
+// D E F I N E S
+//*****************************************************************************
+
+#define STRING_TABLE_INITIAL_SIZE   1024
+#define MAX_STRING_TABLE_SIZE       0x20000
+
+#define STRING_RECORD_AT(StringDescs, Offset) \
+    ((PSTRING_DESCRIPTOR_RECORD)((PUCHAR)(StringDescs) + (Offset) * 2))
+
+
+//*****************************************************************************
+//
+// AddStringDescriptor()
+//
+// StringDescs - Table to append to, which is created if it is NULL and may
+// move as it grows.
+//
+// StringDesc - Checked String Descriptor of DescriptorIndex in LanguageID.
+// All languages of an index have to be added one after the other.
+//
+// Returns FALSE if the string could not be added, the table is unchanged.
+//
+//*****************************************************************************
+
+BOOL
+AddStringDescriptor (
+    PSTRING_DESCRIPTORS     *StringDescs,
+    UCHAR                   DescriptorIndex,
+    USHORT                  LanguageID,
+    PUSB_STRING_DESCRIPTOR  StringDesc
+)
+{
+    PSTRING_DESCRIPTORS         table;
+    PSTRING_DESCRIPTOR_RECORD   record;
+    ULONG                       recordSize;
+    ULONG                       size;
+
+    if (StringDesc->bLength < 2 || StringDesc->bLength % 2 != 0)
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    recordSize = sizeof(STRING_DESCRIPTOR_RECORD) + StringDesc->bLength;
+
+    table = *StringDescs;
+
+    if (table == NULL)
+    {
+        table = (PSTRING_DESCRIPTORS)ALLOC(STRING_TABLE_INITIAL_SIZE);
+
+        if (table == NULL)
+        {
+            OOPS();
+            return FALSE;
+        }
+
+        table->Size = STRING_TABLE_INITIAL_SIZE;
+        table->Length = sizeof(STRING_DESCRIPTORS);
+
+        *StringDescs = table;
+    }
+
+    // The run of an index cannot be continued once another index followed
+    //
+    if (table->First[DescriptorIndex] != 0 &&
+        STRING_RECORD_AT(table, table->Last)->DescriptorIndex != DescriptorIndex)
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    if (table->Length + recordSize > MAX_STRING_TABLE_SIZE)
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    if (table->Length + recordSize > table->Size)
+    {
+        for (size = table->Size; table->Length + recordSize > size; size *= 2)
+        {
+        }
+
+        table = (PSTRING_DESCRIPTORS)REALLOC(table, size);
+
+        if (table == NULL)
+        {
+            OOPS();
+            return FALSE;
+        }
+
+        table->Size = size;
+
+        *StringDescs = table;
+    }
+
+    record = (PSTRING_DESCRIPTOR_RECORD)((PUCHAR)table + table->Length);
+
+    record->DescriptorIndex = DescriptorIndex;
+    record->Reserved = 0;
+    record->LanguageID = LanguageID;
+
+    memcpy(record->StringDescriptor, StringDesc, StringDesc->bLength);
+
+    table->Last = (USHORT)(table->Length / 2);
+
+    if (table->First[DescriptorIndex] == 0)
+    {
+        table->First[DescriptorIndex] = table->Last;
+    }
+
+    table->Length += recordSize;
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// TrimStringDescriptors()
+//
+// Frees the room left at the end of the table once all strings are added.
+//
+//*****************************************************************************
+
+VOID
+TrimStringDescriptors (
+    PSTRING_DESCRIPTORS     *StringDescs
+)
+{
+    PSTRING_DESCRIPTORS table;
+
+    if (*StringDescs == NULL || (*StringDescs)->Length == (*StringDescs)->Size)
+    {
+        return;
+    }
+
+    table = (PSTRING_DESCRIPTORS)REALLOC(*StringDescs, (*StringDescs)->Length);
+
+    // Keeping the larger buffer is fine too
+    //
+    if (table != NULL)
+    {
+        table->Size = table->Length;
+
+        *StringDescs = table;
+    }
+}
+
+//*****************************************************************************
+//
+// FirstStringDescriptor()
+// NextStringDescriptor()
+//
+// Return the records of DescriptorIndex, one for each language it was
+// fetched in, then NULL.
+//
+//*****************************************************************************
+
+PSTRING_DESCRIPTOR_RECORD
+FirstStringDescriptor (
+    __in_opt PSTRING_DESCRIPTORS    StringDescs,
+    UCHAR                           DescriptorIndex
+)
+{
+    if (StringDescs == NULL || StringDescs->First[DescriptorIndex] == 0)
+    {
+        return NULL;
+    }
+
+    return STRING_RECORD_AT(StringDescs, StringDescs->First[DescriptorIndex]);
+}
+
+PSTRING_DESCRIPTOR_RECORD
+NextStringDescriptor (
+    PSTRING_DESCRIPTORS         StringDescs,
+    PSTRING_DESCRIPTOR_RECORD   Record
+)
+{
+    PSTRING_DESCRIPTOR_RECORD next;
+
+    next = NEXT_STRING_RECORD(Record);
+
+    if ((PUCHAR)next >= (PUCHAR)StringDescs + StringDescs->Length ||
+        next->DescriptorIndex != Record->DescriptorIndex)
+    {
+        return NULL;
+    }
+
+    return next;
+}
+
+//*****************************************************************************
+//
+// FindStringDescriptor()
+//
+// Returns the String Descriptor of DescriptorIndex in LanguageID, or NULL
+// if it was not fetched.
+//
+//*****************************************************************************
+
+PUSB_STRING_DESCRIPTOR
+FindStringDescriptor (
+    __in_opt PSTRING_DESCRIPTORS    StringDescs,
+    UCHAR                           DescriptorIndex,
+    USHORT                          LanguageID
+)
+{
+    PSTRING_DESCRIPTOR_RECORD record;
+
+    for (record = FirstStringDescriptor(StringDescs, DescriptorIndex);
+         record != NULL;
+         record = NextStringDescriptor(StringDescs, record))
+    {
+        if (record->LanguageID == LanguageID)
+        {
+            return record->StringDescriptor;
+        }
+    }
+
+    return NULL;
+}
+
+//*****************************************************************************
+//
+// CopyStringDescriptors()
+//
+// Returns a copy of the table, or NULL.
+//
+//*****************************************************************************
+
+PSTRING_DESCRIPTORS
+CopyStringDescriptors (
+    __in_opt PSTRING_DESCRIPTORS    StringDescs
+)
+{
+    PSTRING_DESCRIPTORS copy;
+
+    if (StringDescs == NULL)
+    {
+        return NULL;
+    }
+
+    copy = (PSTRING_DESCRIPTORS)ALLOC(StringDescs->Length);
+
+    if (copy == NULL)
+    {
+        OOPS();
+        return NULL;
+    }
+
+    memcpy(copy, StringDescs, StringDescs->Length);
+
+    copy->Size = copy->Length;
+
+    return copy;
+}
+
+//*****************************************************************************
+//
+// SameStringDescriptors()
+//
+// Compares two tables, including the request counts, which are shown as
+// well.
+//
+//*****************************************************************************
+
+BOOL
+SameStringDescriptors (
+    __in_opt PSTRING_DESCRIPTORS    Old,
+    __in_opt PSTRING_DESCRIPTORS    New
+)
+{
+    if (Old == NULL || New == NULL)
+    {
+        return Old == New;
+    }
+
+    // Everything but Size, which depends on how the table was built
+    //
+    return Old->Length == New->Length &&
+           memcmp(&Old->Length,
+                  &New->Length,
+                  Old->Length - FIELD_OFFSET(STRING_DESCRIPTORS, Length)) == 0;
+}
+
+//*****************************************************************************
+//
+// FreeStringDescriptors()
+//
+//*****************************************************************************
+
+VOID
+FreeStringDescriptors (
+    __in_opt PSTRING_DESCRIPTORS    StringDescs
+)
+{
+    if (StringDescs != NULL)
+    {
+        FREE(StringDescs);
+    }
+}
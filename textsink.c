@@ -0,0 +1,510 @@
+/*++
+
+Copyright (c) 1997-1998 Microsoft Corporation
+
+Module Name:
+
+    TEXTSINK.C
+
+Abstract:
+
+    This source file contains the sinks the detail text of a device can be
+    rendered into by RenderDeviceInfoToSink(): a growable memory buffer, a
+    file, stdout, or a callback.  Text written to a file or stdout is
+    UTF-8 in a UNICODE build.
+
+    It also renders descriptors captured from a device, such as the
+    descriptors file Linux keeps in sysfs for each USB device, without a
+    window and without any device, see RenderDescriptorFile().
+
+Environment:
+
+    user mode
+
+Revision History:
+
+    10-16-26 : created
+
+--*/
+
+//*****************************************************************************
+// I N C L U D E S
+//*****************************************************************************
+
+#include <windows.h>
+#include <basetyps.h>
+#include <winioctl.h>
+#include <string.h>
+#include <tchar.h>
+#include "usbview.h"
+
+//*****************************************************************************
+// D E F I N E S
+//*****************************************************************************
+
+#define MEMORY_SINK_INITIAL_SIZE    4096    // characters
+#define FILE_SINK_CHUNK             512     // characters converted at a time
+
+#define MAX_DESCRIPTOR_FILE_SIZE    0x10000
+
+//*****************************************************************************
+// L O C A L    F U N C T I O N    P R O T O T Y P E S
+//*****************************************************************************
+
+BOOL
+WriteMemorySink (
+    PTEXT_SINK  Sink,
+    PCTSTR      Text,
+    ULONG       Length
+);
+
+BOOL
+WriteFileSink (
+    PTEXT_SINK  Sink,
+    PCTSTR      Text,
+    ULONG       Length
+);
+
+PUSBDEVICEINFO
+BuildDescriptorDeviceInfo (
+    PUCHAR  Descriptors,
+    ULONG   Length
+);
+
+
+//*****************************************************************************
+//
+// InitMemorySink()
+//
+// The text is collected in Sink->Buffer, which is always terminated and
+// holds Sink->Length characters.
+//
+//*****************************************************************************
+
+BOOL
+InitMemorySink (
+    PTEXT_SINK  Sink
+)
+{
+    memset(Sink, 0, sizeof(TEXT_SINK));
+
+    Sink->Buffer = (PTSTR)ALLOC(MEMORY_SINK_INITIAL_SIZE * sizeof(TCHAR));
+
+    if (Sink->Buffer == NULL)
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    Sink->Size = MEMORY_SINK_INITIAL_SIZE;
+    Sink->Write = WriteMemorySink;
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// InitFileSink()
+//
+// FileName - File the text is written to, which is created or truncated.
+//
+//*****************************************************************************
+
+BOOL
+InitFileSink (
+    PTEXT_SINK  Sink,
+    PCTSTR      FileName
+)
+{
+    memset(Sink, 0, sizeof(TEXT_SINK));
+
+    Sink->hFile = CreateFile(FileName,
+                             GENERIC_WRITE,
+                             0,
+                             NULL,
+                             CREATE_ALWAYS,
+                             FILE_ATTRIBUTE_NORMAL,
+                             NULL);
+
+    if (Sink->hFile == INVALID_HANDLE_VALUE)
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    Sink->CloseFile = TRUE;
+    Sink->Write = WriteFileSink;
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// InitStdoutSink()
+//
+// Fails if the process has no stdout, as when it is started from a shell
+// without redirecting it.
+//
+//*****************************************************************************
+
+BOOL
+InitStdoutSink (
+    PTEXT_SINK  Sink
+)
+{
+    memset(Sink, 0, sizeof(TEXT_SINK));
+
+    Sink->hFile = GetStdHandle(STD_OUTPUT_HANDLE);
+
+    if (Sink->hFile == INVALID_HANDLE_VALUE || Sink->hFile == NULL)
+    {
+        return FALSE;
+    }
+
+    Sink->Write = WriteFileSink;
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// InitCallbackSink()
+//
+// Callback - Called with each piece of text, Sink->Context is Context.
+//
+//*****************************************************************************
+
+VOID
+InitCallbackSink (
+    PTEXT_SINK          Sink,
+    LPFNTEXTSINKWRITE   Callback,
+    __in_opt PVOID      Context
+)
+{
+    memset(Sink, 0, sizeof(TEXT_SINK));
+
+    Sink->Write = Callback;
+    Sink->Context = Context;
+}
+
+//*****************************************************************************
+//
+// CloseTextSink()
+//
+// Frees the buffer of a memory sink and closes the file of a file sink.
+//
+//*****************************************************************************
+
+VOID
+CloseTextSink (
+    PTEXT_SINK  Sink
+)
+{
+    if (Sink->Buffer != NULL)
+    {
+        FREE(Sink->Buffer);
+        Sink->Buffer = NULL;
+    }
+
+    if (Sink->CloseFile)
+    {
+        CloseHandle(Sink->hFile);
+        Sink->CloseFile = FALSE;
+    }
+
+    Sink->hFile = INVALID_HANDLE_VALUE;
+}
+
+//*****************************************************************************
+//
+// WriteMemorySink()
+//
+//*****************************************************************************
+
+BOOL
+WriteMemorySink (
+    PTEXT_SINK  Sink,
+    PCTSTR      Text,
+    ULONG       Length
+)
+{
+    PTSTR   buffer;
+    ULONG   size;
+
+    if (Sink->Size - Sink->Length <= Length)
+    {
+        size = Sink->Size;
+
+        while (size - Sink->Length <= Length)
+        {
+            size *= 2;
+        }
+
+        buffer = (PTSTR)REALLOC(Sink->Buffer, size * sizeof(TCHAR));
+
+        if (buffer == NULL)
+        {
+            OOPS();
+            return FALSE;
+        }
+
+        Sink->Buffer = buffer;
+        Sink->Size = size;
+    }
+
+    memcpy(Sink->Buffer + Sink->Length, Text, Length * sizeof(TCHAR));
+
+    Sink->Length += Length;
+    Sink->Buffer[Sink->Length] = 0;
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// WriteFileSink()
+//
+//*****************************************************************************
+
+BOOL
+WriteFileSink (
+    PTEXT_SINK  Sink,
+    PCTSTR      Text,
+    ULONG       Length
+)
+{
+    DWORD   bytesWritten;
+#ifdef UNICODE
+    CHAR    utf8[FILE_SINK_CHUNK * 3];
+    ULONG   chunk;
+    int     bytes;
+
+    while (Length != 0)
+    {
+        chunk = min(Length, FILE_SINK_CHUNK);
+
+        // Don't split a surrogate pair between two chunks
+        //
+        if (chunk < Length && Text[chunk - 1] >= 0xD800 && Text[chunk - 1] <= 0xDBFF)
+        {
+            chunk--;
+        }
+
+        bytes = WideCharToMultiByte(CP_UTF8, 0, Text, chunk,
+                                    utf8, sizeof(utf8), NULL, NULL);
+
+        if (bytes == 0 ||
+            !WriteFile(Sink->hFile, utf8, bytes, &bytesWritten, NULL))
+        {
+            return FALSE;
+        }
+
+        Text += chunk;
+        Length -= chunk;
+    }
+
+    return TRUE;
+#else
+    return WriteFile(Sink->hFile, Text, Length, &bytesWritten, NULL);
+#endif
+}
+
+//*****************************************************************************
+//
+// RenderDescriptorFile()
+//
+// FileName - File holding the descriptors of a device as they came over
+// the bus: optionally its Device Descriptor, then a Configuration
+// Descriptor with all that follows it.  Further configurations are
+// ignored.
+//
+// Sink - Where the text goes.
+//
+// FirstSection, NumSections - The range to render, see
+// RenderDeviceInfoToSink().
+//
+// Returns FALSE if the file could not be read or holds no descriptors.
+//
+//*****************************************************************************
+
+BOOL
+RenderDescriptorFile (
+    __in PCTSTR FileName,
+    PTEXT_SINK  Sink,
+    ULONG       FirstSection,
+    ULONG       NumSections
+)
+{
+    HANDLE          hFile;
+    PUCHAR          descriptors;
+    DWORD           length;
+    PUSBDEVICEINFO  info;
+    BOOL            success;
+
+    hFile = CreateFile(FileName,
+                       GENERIC_READ,
+                       FILE_SHARE_READ,
+                       NULL,
+                       OPEN_EXISTING,
+                       FILE_ATTRIBUTE_NORMAL,
+                       NULL);
+
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    descriptors = (PUCHAR)ALLOC(MAX_DESCRIPTOR_FILE_SIZE);
+
+    if (descriptors == NULL)
+    {
+        OOPS();
+        CloseHandle(hFile);
+        return FALSE;
+    }
+
+    success = ReadFile(hFile,
+                       descriptors,
+                       MAX_DESCRIPTOR_FILE_SIZE,
+                       &length,
+                       NULL);
+
+    CloseHandle(hFile);
+
+    info = success ? BuildDescriptorDeviceInfo(descriptors, length) : NULL;
+
+    FREE(descriptors);
+
+    if (info == NULL)
+    {
+        return FALSE;
+    }
+
+    success = CreateTextBuffer();
+
+    if (success)
+    {
+        RenderDeviceInfoToSink(info, Sink, FirstSection, NumSections);
+
+        DestroyTextBuffer();
+    }
+
+    FreeDeviceInfo(info);
+
+    return success;
+}
+
+//*****************************************************************************
+//
+// BuildDescriptorDeviceInfo()
+//
+// Returns the info of a device with the given descriptors, as enumeration
+// would have built it, but with nothing known about the connection but the
+// Device Descriptor.  Free it with FreeDeviceInfo().
+//
+//*****************************************************************************
+
+PUSBDEVICEINFO
+BuildDescriptorDeviceInfo (
+    PUCHAR  Descriptors,
+    ULONG   Length
+)
+{
+    PUSBDEVICEINFO                  info;
+    PUSB_DEVICE_DESCRIPTOR          deviceDesc;
+    PUSB_CONFIGURATION_DESCRIPTOR   configDesc;
+    ULONG                           configLength;
+
+    deviceDesc = NULL;
+    configDesc = NULL;
+
+    if (Length >= sizeof(USB_DEVICE_DESCRIPTOR) &&
+        Descriptors[0] == sizeof(USB_DEVICE_DESCRIPTOR) &&
+        Descriptors[1] == USB_DEVICE_DESCRIPTOR_TYPE)
+    {
+        deviceDesc = (PUSB_DEVICE_DESCRIPTOR)Descriptors;
+
+        Descriptors += sizeof(USB_DEVICE_DESCRIPTOR);
+        Length -= sizeof(USB_DEVICE_DESCRIPTOR);
+    }
+
+    if (Length >= sizeof(USB_CONFIGURATION_DESCRIPTOR) &&
+        Descriptors[0] == sizeof(USB_CONFIGURATION_DESCRIPTOR) &&
+        Descriptors[1] == USB_CONFIGURATION_DESCRIPTOR_TYPE)
+    {
+        configDesc = (PUSB_CONFIGURATION_DESCRIPTOR)Descriptors;
+    }
+
+    if (deviceDesc == NULL && configDesc == NULL)
+    {
+        OOPS();
+        return NULL;
+    }
+
+    info = (PUSBDEVICEINFO)ALLOC(sizeof(USBDEVICEINFO));
+
+    if (info == NULL)
+    {
+        OOPS();
+        return NULL;
+    }
+
+    info->DeviceInfoType = DeviceInfo;
+
+    if (deviceDesc != NULL)
+    {
+        info->ConnectionInfo = (PUSB_NODE_CONNECTION_INFORMATION_EX)
+            ALLOC(sizeof(USB_NODE_CONNECTION_INFORMATION_EX));
+
+        if (info->ConnectionInfo == NULL)
+        {
+            OOPS();
+            FreeDeviceInfo(info);
+            return NULL;
+        }
+
+        info->ConnectionInfo->ConnectionStatus = DeviceConnected;
+        info->ConnectionInfo->DeviceDescriptor = *deviceDesc;
+
+        // Not known from the descriptors, shown as Unknown
+        //
+        info->ConnectionInfo->Speed = 0xFF;
+
+        if (configDesc != NULL)
+        {
+            info->ConnectionInfo->CurrentConfigurationValue =
+                configDesc->bConfigurationValue;
+        }
+    }
+
+    if (configDesc != NULL)
+    {
+        // A truncated capture is shown as far as it goes
+        //
+        configLength = min(configDesc->wTotalLength, Length);
+
+        info->ConfigDesc = (PUSB_DESCRIPTOR_REQUEST)
+            ALLOC(sizeof(USB_DESCRIPTOR_REQUEST) + configLength);
+
+        if (info->ConfigDesc == NULL)
+        {
+            OOPS();
+            FreeDeviceInfo(info);
+            return NULL;
+        }
+
+        memcpy(info->ConfigDesc + 1, configDesc, configLength);
+
+        ((PUSB_CONFIGURATION_DESCRIPTOR)(info->ConfigDesc + 1))->wTotalLength =
+            (USHORT)configLength;
+
+        if (!IndexConfigDesc(&info->ConfigDesc))
+        {
+            FreeDeviceInfo(info);
+            return NULL;
+        }
+    }
+
+    return info;
+}
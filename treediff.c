@@ -0,0 +1,360 @@
+/*++
+
+Copyright (c) 1997-1998 Microsoft Corporation
+
+Module Name:
+
+    TREEDIFF.C
+
+Abstract:
+
+    This source file contains the tree diff, which brings the tree of the
+    last refresh up to date with a newly enumerated one.
+
+    Nodes are matched with their siblings by identity, the driver key for
+    host controllers and the port number for hub ports, so a node is
+    identified by its host controller and its chain of ports.  Nodes which
+    match are updated in place, and only the nodes which came or went are
+    inserted or removed.  What that means for whatever shows the tree is
+    left to callbacks, nothing here depends on the UI.
+
+Environment:
+
+    user mode
+
+Revision History:
+
+    10-16-26 : created
+
+--*/
+
+//*****************************************************************************
+// I N C L U D E S
+//*****************************************************************************
+
+#include <windows.h>
+#include <basetyps.h>
+#include <winioctl.h>
+#include <tchar.h>
+#include "usbview.h"
+
+//*****************************************************************************
+// L O C A L    F U N C T I O N    P R O T O T Y P E S
+//*****************************************************************************
+
+BOOL
+SameTreeNode (
+    PUSBTREENODE    Node,
+    PUSBTREENODE    NewNode
+);
+
+BOOL
+TreeNodeChanged (
+    PUSBTREENODE    Node,
+    PUSBTREENODE    NewNode
+);
+
+VOID
+AppendTreeNode (
+    PUSBTREENODE    Parent,
+    PUSBTREENODE    Node
+);
+
+
+//*****************************************************************************
+//
+// DiffTreeNodes()
+//
+// Node - Node of the current tree.
+//
+// NewNode - The same node in the newly enumerated tree.
+//
+// Callbacks - Called for each change found, see TREE_DIFF_CALLBACKS.
+//
+// Stats - Counts of what was found are added to this.
+//
+// Afterwards the children of Node are those of NewNode, in the same order,
+// and NewNode has no children left.  Nodes which were inserted are moved
+// over from the new tree, the others are freed.  The Info of nodes is left
+// to the callbacks, they are never freed here.
+//
+//*****************************************************************************
+
+VOID
+DiffTreeNodes (
+    PUSBTREENODE            Node,
+    PUSBTREENODE            NewNode,
+    PTREE_DIFF_CALLBACKS    Callbacks,
+    PTREE_DIFF_STATS        Stats
+)
+{
+    PUSBTREENODE    child;
+    PUSBTREENODE    *link;
+    PUSBTREENODE    newChild;
+    PUSBTREENODE    nextNewChild;
+    PUSBTREENODE    match;
+    PUSBTREENODE    remaining;
+    BOOL            changed;
+
+    // First remove the children which are gone
+    //
+    link = &Node->FirstChild;
+
+    while ((child = *link) != NULL)
+    {
+        for (newChild = NewNode->FirstChild;
+             newChild != NULL;
+             newChild = newChild->NextSibling)
+        {
+            if (SameTreeNode(child, newChild))
+            {
+                break;
+            }
+        }
+
+        if (newChild == NULL)
+        {
+            *link = child->NextSibling;
+
+            (*Callbacks->RemoveNode)(Callbacks->Context, child);
+
+            FreeTreeNode(child, FALSE);
+
+            Stats->Removed++;
+        }
+        else
+        {
+            link = &child->NextSibling;
+        }
+    }
+
+    // Then rebuild the list of children in the new order.  The children
+    // still in the old list come after those already placed, so a new
+    // node is always shown right after the last one placed.
+    //
+    remaining = Node->FirstChild;
+
+    Node->FirstChild = NULL;
+    Node->LastChild = NULL;
+
+    for (newChild = NewNode->FirstChild;
+         newChild != NULL;
+         newChild = nextNewChild)
+    {
+        nextNewChild = newChild->NextSibling;
+
+        newChild->NextSibling = NULL;
+
+        // Siblings almost never change order, so the match is nearly
+        // always the first child left
+        //
+        link = &remaining;
+
+        while ((match = *link) != NULL && !SameTreeNode(match, newChild))
+        {
+            link = &match->NextSibling;
+        }
+
+        if (match != NULL)
+        {
+            *link = match->NextSibling;
+
+            match->NextSibling = NULL;
+
+            if (link != &remaining)
+            {
+                // It moved ahead of other children, show it again at
+                // its new place
+                //
+                (*Callbacks->RemoveNode)(Callbacks->Context, match);
+
+                FreeTreeNode(match, FALSE);
+
+                Stats->Removed++;
+
+                match = NULL;
+            }
+        }
+
+        if (match != NULL)
+        {
+            changed = TreeNodeChanged(match, newChild);
+
+            (*Callbacks->UpdateNode)(Callbacks->Context,
+                                     match,
+                                     newChild,
+                                     changed);
+
+            if (changed)
+            {
+                Stats->Changed++;
+            }
+            else
+            {
+                Stats->Unchanged++;
+            }
+
+            if (match->Text)
+            {
+                FREE(match->Text);
+            }
+
+            match->Info = newChild->Info;
+            match->Text = newChild->Text;
+            match->Icon = newChild->Icon;
+            match->Key = newChild->Key;
+
+            newChild->Info = NULL;
+            newChild->Text = NULL;
+
+            DiffTreeNodes(match, newChild, Callbacks, Stats);
+
+            FreeTreeNode(newChild, FALSE);
+
+            AppendTreeNode(Node, match);
+        }
+        else
+        {
+            newChild->Parent = Node;
+
+            if ((*Callbacks->InsertNode)(Callbacks->Context,
+                                         Node,
+                                         Node->LastChild,
+                                         newChild))
+            {
+                AppendTreeNode(Node, newChild);
+
+                Stats->Inserted++;
+            }
+            else
+            {
+                OOPS();
+                FreeTreeNode(newChild, TRUE);
+            }
+        }
+    }
+
+    NewNode->FirstChild = NULL;
+    NewNode->LastChild = NULL;
+}
+
+//*****************************************************************************
+//
+// DropUnnamedTreeNodes()
+//
+// Frees the nodes of hubs which could not be enumerated, which have no
+// text, along with their Info.  These are left out of the tree.
+//
+//*****************************************************************************
+
+VOID
+DropUnnamedTreeNodes (
+    PUSBTREENODE    Node
+)
+{
+    PUSBTREENODE    child;
+    PUSBTREENODE    *link;
+
+    link = &Node->FirstChild;
+
+    Node->LastChild = NULL;
+
+    while ((child = *link) != NULL)
+    {
+        if (child->Text == NULL)
+        {
+            *link = child->NextSibling;
+
+            FreeTreeNode(child, TRUE);
+        }
+        else
+        {
+            DropUnnamedTreeNodes(child);
+
+            Node->LastChild = child;
+
+            link = &child->NextSibling;
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// SameTreeNode()
+//
+// Returns TRUE if the two nodes are the same node of their parent.
+//
+//*****************************************************************************
+
+BOOL
+SameTreeNode (
+    PUSBTREENODE    Node,
+    PUSBTREENODE    NewNode
+)
+{
+    if (Node->Id != NewNode->Id)
+    {
+        return FALSE;
+    }
+
+    if (Node->Key == NULL || NewNode->Key == NULL)
+    {
+        return Node->Key == NewNode->Key;
+    }
+
+    return _tcscmp(Node->Key, NewNode->Key) == 0;
+}
+
+//*****************************************************************************
+//
+// TreeNodeChanged()
+//
+// Returns TRUE if the text or the icon of the node differ.
+//
+//*****************************************************************************
+
+BOOL
+TreeNodeChanged (
+    PUSBTREENODE    Node,
+    PUSBTREENODE    NewNode
+)
+{
+    if (Node->Icon != NewNode->Icon)
+    {
+        return TRUE;
+    }
+
+    if (Node->Text == NULL || NewNode->Text == NULL)
+    {
+        return Node->Text != NewNode->Text;
+    }
+
+    return _tcscmp(Node->Text, NewNode->Text) != 0;
+}
+
+//*****************************************************************************
+//
+// AppendTreeNode()
+//
+//*****************************************************************************
+
+VOID
+AppendTreeNode (
+    PUSBTREENODE    Parent,
+    PUSBTREENODE    Node
+)
+{
+    Node->Parent = Parent;
+    Node->NextSibling = NULL;
+
+    if (Parent->LastChild)
+    {
+        Parent->LastChild->NextSibling = Node;
+    }
+    else
+    {
+        Parent->FirstChild = Node;
+    }
+
+    Parent->LastChild = Node;
+}
@@ -81,6 +81,80 @@ Revision History:
 #define USB_AUDIO_PROCESS_DYNRANGECOMP      0x06
 
 
+//
+// USB Class Definitions for Communications Devices
+// Table 12 and 13.  Type and Subtype Values for the Functional Descriptors
+//
+#define USB_CDC_CS_INTERFACE                0x24
+
+#define USB_CDC_HEADER                      0x00
+#define USB_CDC_CALL_MANAGEMENT             0x01
+#define USB_CDC_ABSTRACT_CONTROL            0x02
+#define USB_CDC_UNION                       0x06
+#define USB_CDC_ETHERNET_NETWORKING         0x0F
+#define USB_CDC_NCM                         0x1A
+#define USB_CDC_MBIM                        0x1B
+
+
+//
+// USB Device Class Definition for Video Devices
+// Appendix A.  Video Device Class Codes
+//
+#define USB_DEVICE_CLASS_VIDEO              0x0E
+
+// A.2  Video Interface Subclass Codes
+//
+#define USB_VIDEO_SUBCLASS_VIDEOCONTROL     0x01
+#define USB_VIDEO_SUBCLASS_VIDEOSTREAMING   0x02
+
+// A.4  Video Class-Specific Descriptor Types
+//
+#define USB_VIDEO_CS_INTERFACE              0x24
+#define USB_VIDEO_CS_ENDPOINT               0x25
+
+// A.5  Video Class-Specific VC Interface Descriptor Subtypes
+//
+#define USB_VIDEO_VC_HEADER                 0x01
+#define USB_VIDEO_VC_INPUT_TERMINAL         0x02
+#define USB_VIDEO_VC_OUTPUT_TERMINAL        0x03
+#define USB_VIDEO_VC_SELECTOR_UNIT          0x04
+#define USB_VIDEO_VC_PROCESSING_UNIT        0x05
+#define USB_VIDEO_VC_EXTENSION_UNIT         0x06
+
+// A.6  Video Class-Specific VS Interface Descriptor Subtypes
+//
+#define USB_VIDEO_VS_INPUT_HEADER           0x01
+#define USB_VIDEO_VS_FORMAT_UNCOMPRESSED    0x04
+#define USB_VIDEO_VS_FRAME_UNCOMPRESSED     0x05
+#define USB_VIDEO_VS_FORMAT_MJPEG           0x06
+#define USB_VIDEO_VS_FRAME_MJPEG            0x07
+#define USB_VIDEO_VS_COLORFORMAT            0x0D
+
+// A.7  Video Class-Specific Endpoint Descriptor Subtypes
+//
+#define USB_VIDEO_EP_INTERRUPT              0x03
+
+// B.2  Input Terminal Types
+//
+#define USB_VIDEO_ITT_CAMERA                0x0201
+
+
+//
+// Universal Serial Bus Mass Storage Class, UAS Protocol
+// 5.3.1  Pipe Usage Descriptor
+//
+#define USB_STORAGE_SUBCLASS_SCSI           0x06
+#define USB_STORAGE_PIPE_USAGE_TYPE         0x24
+
+
+//
+// USB 2.0 Specification, 11.23.2.1  Hub Descriptor, and
+// USB 3.0 Specification, 10.13.2.1  Enhanced SuperSpeed Hub Descriptor
+//
+#define USB_HUB_DESCRIPTOR_TYPE             0x29
+#define USB_SS_HUB_DESCRIPTOR_TYPE          0x2A
+
+
 //*****************************************************************************
 // T Y P E D E F S
 //*****************************************************************************
@@ -315,4 +389,316 @@ typedef struct _USB_AUDIO_TYPE_II_FORMAT_DESCRIPTOR {
 *PUSB_AUDIO_TYPE_II_FORMAT_DESCRIPTOR;
 
 
+// Communications Class Functional Descriptors, CDC 1.2 and its subclass
+// specifications.  All of them start like this.
+//
+typedef struct _USB_CDC_COMMON_DESCRIPTOR {
+    UCHAR  bLength;
+    UCHAR  bDescriptorType;
+    UCHAR  bDescriptorSubtype;
+} USB_CDC_COMMON_DESCRIPTOR,
+*PUSB_CDC_COMMON_DESCRIPTOR;
+
+// 5.2.3.1  Header Functional Descriptor
+//
+typedef struct _USB_CDC_HEADER_DESCRIPTOR {
+    UCHAR  bLength;
+    UCHAR  bDescriptorType;
+    UCHAR  bDescriptorSubtype;
+    USHORT bcdCDC;
+} USB_CDC_HEADER_DESCRIPTOR,
+*PUSB_CDC_HEADER_DESCRIPTOR;
+
+// PSTN 5.3.1  Call Management Functional Descriptor
+//
+typedef struct _USB_CDC_CALL_MANAGEMENT_DESCRIPTOR {
+    UCHAR  bLength;
+    UCHAR  bDescriptorType;
+    UCHAR  bDescriptorSubtype;
+    UCHAR  bmCapabilities;
+    UCHAR  bDataInterface;
+} USB_CDC_CALL_MANAGEMENT_DESCRIPTOR,
+*PUSB_CDC_CALL_MANAGEMENT_DESCRIPTOR;
+
+// PSTN 5.3.2  Abstract Control Management Functional Descriptor
+//
+typedef struct _USB_CDC_ACM_DESCRIPTOR {
+    UCHAR  bLength;
+    UCHAR  bDescriptorType;
+    UCHAR  bDescriptorSubtype;
+    UCHAR  bmCapabilities;
+} USB_CDC_ACM_DESCRIPTOR,
+*PUSB_CDC_ACM_DESCRIPTOR;
+
+// 5.2.3.2  Union Functional Descriptor
+//
+typedef struct _USB_CDC_UNION_DESCRIPTOR {
+    UCHAR  bLength;
+    UCHAR  bDescriptorType;
+    UCHAR  bDescriptorSubtype;
+    UCHAR  bControlInterface;
+    UCHAR  bSubordinateInterface[1];
+} USB_CDC_UNION_DESCRIPTOR,
+*PUSB_CDC_UNION_DESCRIPTOR;
+
+// ECM 5.4  Ethernet Networking Functional Descriptor
+//
+typedef struct _USB_CDC_ETHERNET_DESCRIPTOR {
+    UCHAR  bLength;
+    UCHAR  bDescriptorType;
+    UCHAR  bDescriptorSubtype;
+    UCHAR  iMACAddress;
+    ULONG  bmEthernetStatistics;
+    USHORT wMaxSegmentSize;
+    USHORT wNumberMCFilters;
+    UCHAR  bNumberPowerFilters;
+} USB_CDC_ETHERNET_DESCRIPTOR,
+*PUSB_CDC_ETHERNET_DESCRIPTOR;
+
+// NCM 5.2.1  NCM Functional Descriptor
+//
+typedef struct _USB_CDC_NCM_DESCRIPTOR {
+    UCHAR  bLength;
+    UCHAR  bDescriptorType;
+    UCHAR  bDescriptorSubtype;
+    USHORT bcdNcmVersion;
+    UCHAR  bmNetworkCapabilities;
+} USB_CDC_NCM_DESCRIPTOR,
+*PUSB_CDC_NCM_DESCRIPTOR;
+
+// MBIM 6.4  MBIM Functional Descriptor
+//
+typedef struct _USB_CDC_MBIM_DESCRIPTOR {
+    UCHAR  bLength;
+    UCHAR  bDescriptorType;
+    UCHAR  bDescriptorSubtype;
+    USHORT bcdMBIMVersion;
+    USHORT wMaxControlMessage;
+    UCHAR  bNumberFilters;
+    UCHAR  bMaxFilterSize;
+    USHORT wMaxSegmentSize;
+    UCHAR  bmNetworkCapabilities;
+} USB_CDC_MBIM_DESCRIPTOR,
+*PUSB_CDC_MBIM_DESCRIPTOR;
+
+
+// Video Class-Specific Descriptors, UVC 1.1
+//
+// 3.7.2  Class-Specific VC Interface Header Descriptor
+//
+typedef struct _USB_VIDEO_VC_HEADER_DESCRIPTOR {
+    UCHAR  bLength;
+    UCHAR  bDescriptorType;
+    UCHAR  bDescriptorSubtype;
+    USHORT bcdUVC;
+    USHORT wTotalLength;
+    ULONG  dwClockFrequency;
+    UCHAR  bInCollection;
+} USB_VIDEO_VC_HEADER_DESCRIPTOR,
+*PUSB_VIDEO_VC_HEADER_DESCRIPTOR;
+
+// 3.7.2.1  Input Terminal Descriptor
+//
+typedef struct _USB_VIDEO_INPUT_TERMINAL_DESCRIPTOR {
+    UCHAR  bLength;
+    UCHAR  bDescriptorType;
+    UCHAR  bDescriptorSubtype;
+    UCHAR  bTerminalID;
+    USHORT wTerminalType;
+    UCHAR  bAssocTerminal;
+    UCHAR  iTerminal;
+} USB_VIDEO_INPUT_TERMINAL_DESCRIPTOR,
+*PUSB_VIDEO_INPUT_TERMINAL_DESCRIPTOR;
+
+// 3.7.2.3  Camera Terminal Descriptor
+//
+typedef struct _USB_VIDEO_CAMERA_TERMINAL_DESCRIPTOR {
+    UCHAR  bLength;
+    UCHAR  bDescriptorType;
+    UCHAR  bDescriptorSubtype;
+    UCHAR  bTerminalID;
+    USHORT wTerminalType;
+    UCHAR  bAssocTerminal;
+    UCHAR  iTerminal;
+    USHORT wObjectiveFocalLengthMin;
+    USHORT wObjectiveFocalLengthMax;
+    USHORT wOcularFocalLength;
+    UCHAR  bControlSize;
+} USB_VIDEO_CAMERA_TERMINAL_DESCRIPTOR,
+*PUSB_VIDEO_CAMERA_TERMINAL_DESCRIPTOR;
+
+// 3.7.2.2  Output Terminal Descriptor
+//
+typedef struct _USB_VIDEO_OUTPUT_TERMINAL_DESCRIPTOR {
+    UCHAR  bLength;
+    UCHAR  bDescriptorType;
+    UCHAR  bDescriptorSubtype;
+    UCHAR  bTerminalID;
+    USHORT wTerminalType;
+    UCHAR  bAssocTerminal;
+    UCHAR  bSourceID;
+    UCHAR  iTerminal;
+} USB_VIDEO_OUTPUT_TERMINAL_DESCRIPTOR,
+*PUSB_VIDEO_OUTPUT_TERMINAL_DESCRIPTOR;
+
+// 3.7.2.4  Selector Unit Descriptor
+//
+typedef struct _USB_VIDEO_SELECTOR_UNIT_DESCRIPTOR {
+    UCHAR  bLength;
+    UCHAR  bDescriptorType;
+    UCHAR  bDescriptorSubtype;
+    UCHAR  bUnitID;
+    UCHAR  bNrInPins;
+} USB_VIDEO_SELECTOR_UNIT_DESCRIPTOR,
+*PUSB_VIDEO_SELECTOR_UNIT_DESCRIPTOR;
+
+// 3.7.2.5  Processing Unit Descriptor
+//
+typedef struct _USB_VIDEO_PROCESSING_UNIT_DESCRIPTOR {
+    UCHAR  bLength;
+    UCHAR  bDescriptorType;
+    UCHAR  bDescriptorSubtype;
+    UCHAR  bUnitID;
+    UCHAR  bSourceID;
+    USHORT wMaxMultiplier;
+    UCHAR  bControlSize;
+} USB_VIDEO_PROCESSING_UNIT_DESCRIPTOR,
+*PUSB_VIDEO_PROCESSING_UNIT_DESCRIPTOR;
+
+// 3.7.2.7  Extension Unit Descriptor
+//
+typedef struct _USB_VIDEO_EXTENSION_UNIT_DESCRIPTOR {
+    UCHAR  bLength;
+    UCHAR  bDescriptorType;
+    UCHAR  bDescriptorSubtype;
+    UCHAR  bUnitID;
+    UCHAR  guidExtensionCode[16];
+    UCHAR  bNumControls;
+    UCHAR  bNrInPins;
+} USB_VIDEO_EXTENSION_UNIT_DESCRIPTOR,
+*PUSB_VIDEO_EXTENSION_UNIT_DESCRIPTOR;
+
+// 3.9.2.1  Input Header Descriptor
+//
+typedef struct _USB_VIDEO_VS_INPUT_HEADER_DESCRIPTOR {
+    UCHAR  bLength;
+    UCHAR  bDescriptorType;
+    UCHAR  bDescriptorSubtype;
+    UCHAR  bNumFormats;
+    USHORT wTotalLength;
+    UCHAR  bEndpointAddress;
+    UCHAR  bmInfo;
+    UCHAR  bTerminalLink;
+    UCHAR  bStillCaptureMethod;
+    UCHAR  bTriggerSupport;
+    UCHAR  bTriggerUsage;
+    UCHAR  bControlSize;
+} USB_VIDEO_VS_INPUT_HEADER_DESCRIPTOR,
+*PUSB_VIDEO_VS_INPUT_HEADER_DESCRIPTOR;
+
+// Uncompressed Payload 3.1.1  Uncompressed Video Format Descriptor
+//
+typedef struct _USB_VIDEO_FORMAT_UNCOMPRESSED_DESCRIPTOR {
+    UCHAR  bLength;
+    UCHAR  bDescriptorType;
+    UCHAR  bDescriptorSubtype;
+    UCHAR  bFormatIndex;
+    UCHAR  bNumFrameDescriptors;
+    UCHAR  guidFormat[16];
+    UCHAR  bBitsPerPixel;
+    UCHAR  bDefaultFrameIndex;
+    UCHAR  bAspectRatioX;
+    UCHAR  bAspectRatioY;
+    UCHAR  bmInterlaceFlags;
+    UCHAR  bCopyProtect;
+} USB_VIDEO_FORMAT_UNCOMPRESSED_DESCRIPTOR,
+*PUSB_VIDEO_FORMAT_UNCOMPRESSED_DESCRIPTOR;
+
+// MJPEG Payload 3.1.1  Motion-JPEG Video Format Descriptor
+//
+typedef struct _USB_VIDEO_FORMAT_MJPEG_DESCRIPTOR {
+    UCHAR  bLength;
+    UCHAR  bDescriptorType;
+    UCHAR  bDescriptorSubtype;
+    UCHAR  bFormatIndex;
+    UCHAR  bNumFrameDescriptors;
+    UCHAR  bmFlags;
+    UCHAR  bDefaultFrameIndex;
+    UCHAR  bAspectRatioX;
+    UCHAR  bAspectRatioY;
+    UCHAR  bmInterlaceFlags;
+    UCHAR  bCopyProtect;
+} USB_VIDEO_FORMAT_MJPEG_DESCRIPTOR,
+*PUSB_VIDEO_FORMAT_MJPEG_DESCRIPTOR;
+
+// Uncompressed and MJPEG Payload 3.1.2  Video Frame Descriptor, followed
+// by the frame intervals
+//
+typedef struct _USB_VIDEO_FRAME_DESCRIPTOR {
+    UCHAR  bLength;
+    UCHAR  bDescriptorType;
+    UCHAR  bDescriptorSubtype;
+    UCHAR  bFrameIndex;
+    UCHAR  bmCapabilities;
+    USHORT wWidth;
+    USHORT wHeight;
+    ULONG  dwMinBitRate;
+    ULONG  dwMaxBitRate;
+    ULONG  dwMaxVideoFrameBufferSize;
+    ULONG  dwDefaultFrameInterval;
+    UCHAR  bFrameIntervalType;
+} USB_VIDEO_FRAME_DESCRIPTOR,
+*PUSB_VIDEO_FRAME_DESCRIPTOR;
+
+// 3.9.2.6  Color Matching Descriptor
+//
+typedef struct _USB_VIDEO_COLORFORMAT_DESCRIPTOR {
+    UCHAR  bLength;
+    UCHAR  bDescriptorType;
+    UCHAR  bDescriptorSubtype;
+    UCHAR  bColorPrimaries;
+    UCHAR  bTransferCharacteristics;
+    UCHAR  bMatrixCoefficients;
+} USB_VIDEO_COLORFORMAT_DESCRIPTOR,
+*PUSB_VIDEO_COLORFORMAT_DESCRIPTOR;
+
+// 3.8.2.2  Class-specific VC Interrupt Endpoint Descriptor
+//
+typedef struct _USB_VIDEO_INTERRUPT_ENDPOINT_DESCRIPTOR {
+    UCHAR  bLength;
+    UCHAR  bDescriptorType;
+    UCHAR  bDescriptorSubtype;
+    USHORT wMaxTransferSize;
+} USB_VIDEO_INTERRUPT_ENDPOINT_DESCRIPTOR,
+*PUSB_VIDEO_INTERRUPT_ENDPOINT_DESCRIPTOR;
+
+
+// UAS 5.3.1  Pipe Usage Descriptor
+//
+typedef struct _USB_STORAGE_PIPE_USAGE_DESCRIPTOR {
+    UCHAR  bLength;
+    UCHAR  bDescriptorType;
+    UCHAR  bPipeID;
+    UCHAR  Reserved;
+} USB_STORAGE_PIPE_USAGE_DESCRIPTOR,
+*PUSB_STORAGE_PIPE_USAGE_DESCRIPTOR;
+
+
+// USB 3.0 10.13.2.1  Enhanced SuperSpeed Hub Descriptor, USB_HUB_DESCRIPTOR
+// is the one of USB 2.0
+//
+typedef struct _USB_SS_HUB_DESCRIPTOR {
+    UCHAR  bLength;
+    UCHAR  bDescriptorType;
+    UCHAR  bNumberOfPorts;
+    USHORT wHubCharacteristics;
+    UCHAR  bPowerOnToPowerGood;
+    UCHAR  bHubControlCurrent;
+    UCHAR  bHubHdrDecLat;
+    USHORT wHubDelay;
+    USHORT DeviceRemovable;
+} USB_SS_HUB_DESCRIPTOR,
+*PUSB_SS_HUB_DESCRIPTOR;
+
+
 #pragma pack(pop)
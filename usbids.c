@@ -0,0 +1,1062 @@
+/*++
+
+Copyright (c) 1997-1998 Microsoft Corporation
+
+Module Name:
+
+    USBIDS.C
+
+Abstract:
+
+    This source file contains the external USB ID database.  A usb.ids
+    style text file, as maintained at http://www.linux-usb.org/usb.ids, is
+    compiled once into a binary index next to it, which is then mapped
+    read-only into memory.  The index is compiled again whenever the text
+    file changes.
+
+    The index holds a table of the name of every Vendor ID, and two open
+    addressing hash tables: one of the products of all vendors, keyed by
+    Vendor ID and Product ID, and one of the classes, subclasses and
+    protocols.  The names follow as terminated strings in the character
+    set of the build.  A lookup is a few reads of the mapped file and
+    never allocates.
+
+    The database is loaded before any other thread starts and not changed
+    until they are gone, so the lookups need no lock.
+
+Environment:
+
+    user mode
+
+Revision History:
+
+    10-16-26 : created
+
+--*/
+
+//*****************************************************************************
+// I N C L U D E S
+//*****************************************************************************
+
+#include <windows.h>
+#include <basetyps.h>
+#include <winioctl.h>
+#include <string.h>
+#include <tchar.h>
+#include "usbview.h"
+
+//*****************************************************************************
+// D E F I N E S
+//*****************************************************************************
+
+#define USB_IDS_MAGIC           0x58444955      // "UIDX"
+#define USB_IDS_VERSION         1
+
+#define USB_IDS_VENDORS         0x10000
+
+#define MAX_USB_IDS_FILE_SIZE   (64 * 1024 * 1024)
+
+// Keys of the class hash table
+//
+#define CLASS_KEY(c)            (0x01000000 | ((c) << 16))
+#define SUBCLASS_KEY(c, s)      (0x02000000 | ((c) << 16) | ((s) << 8))
+#define PROTOCOL_KEY(c, s, p)   (0x03000000 | ((c) << 16) | ((s) << 8) | (p))
+
+//*****************************************************************************
+// T Y P E D E F S
+//*****************************************************************************
+
+// Start of the index file.  It is followed by
+//
+//     ULONG               VendorNames[USB_IDS_VENDORS]
+//     USB_IDS_HASH_ENTRY  Products[ProductHashSize]
+//     USB_IDS_HASH_ENTRY  Classes[ClassHashSize]
+//     TCHAR               Names[NamesLength]
+//
+// Names are given as offsets into Names, in characters.  Offset 0 is an
+// empty name which stands for none.
+//
+typedef struct _USB_IDS_HEADER
+{
+    ULONG       Magic;
+    ULONG       Version;
+    ULONG       CharSize;           // sizeof(TCHAR) of the build
+    FILETIME    SourceTime;         // of the text file compiled
+    ULONG       SourceSize;
+    ULONG       ProductHashSize;    // power of 2
+    ULONG       ClassHashSize;      // power of 2
+    ULONG       NamesLength;
+    ULONG       Vendors;
+    ULONG       Products;
+    ULONG       Classes;            // with subclasses and protocols
+} USB_IDS_HEADER, *PUSB_IDS_HEADER;
+
+typedef struct _USB_IDS_HASH_ENTRY
+{
+    ULONG       Key;
+    ULONG       Name;               // 0 if the slot is free
+} USB_IDS_HASH_ENTRY, *PUSB_IDS_HASH_ENTRY;
+
+// One line of the text file worth keeping, while compiling
+//
+typedef enum _USB_IDS_KIND
+{
+    UsbIdsVendor,
+    UsbIdsProduct,
+    UsbIdsClass
+} USB_IDS_KIND;
+
+typedef struct _USB_IDS_LINE
+{
+    USB_IDS_KIND    Kind;
+    ULONG           Key;
+    PCSTR           Name;
+    ULONG           NameLength;     // bytes, not terminated
+} USB_IDS_LINE, *PUSB_IDS_LINE;
+
+//*****************************************************************************
+// L O C A L    F U N C T I O N    P R O T O T Y P E S
+//*****************************************************************************
+
+BOOL
+MapUsbIdsIndex (
+    PCTSTR      IndexFile,
+    __in_opt LPFILETIME SourceTime,
+    ULONG       SourceSize
+);
+
+BOOL
+CompileUsbIds (
+    PCTSTR      DatabaseFile,
+    PCTSTR      IndexFile
+);
+
+ULONG
+ParseUsbIds (
+    PCSTR           Text,
+    ULONG           Length,
+    PUSB_IDS_LINE   Lines
+);
+
+BOOL
+ParseUsbIdsHex (
+    PCSTR   *Text,
+    PCSTR   End,
+    ULONG   Digits,
+    PULONG  Value
+);
+
+ULONG
+HashUsbIdsKey (
+    ULONG   Key
+);
+
+ULONG
+HashTableSize (
+    ULONG   Entries
+);
+
+VOID
+InsertUsbIdsHash (
+    PUSB_IDS_HASH_ENTRY Table,
+    ULONG               Size,
+    ULONG               Key,
+    ULONG               Name
+);
+
+PCTSTR
+LookupUsbIdsHash (
+    PUSB_IDS_HASH_ENTRY Table,
+    ULONG               Size,
+    ULONG               Key
+);
+
+//*****************************************************************************
+// G L O B A L S    P R I V A T E    T O    T H I S    F I L E
+//*****************************************************************************
+
+HANDLE              UsbIdsFile = INVALID_HANDLE_VALUE;
+HANDLE              UsbIdsMapping;
+PUSB_IDS_HEADER     UsbIdsHeader;
+
+PULONG              UsbIdsVendors;
+PUSB_IDS_HASH_ENTRY UsbIdsProducts;
+PUSB_IDS_HASH_ENTRY UsbIdsClasses;
+PCTSTR              UsbIdsNames;
+
+
+//*****************************************************************************
+//
+// LoadUsbIds()
+//
+// DatabaseFile - The usb.ids text file, or NULL to only use IndexFile.
+//
+// IndexFile - The index compiled from it, or NULL for DatabaseFile with
+// ".idx" appended.  It is compiled if it does not exist or is out of date.
+//
+// Returns FALSE if no database could be loaded, the lookups then find
+// nothing.
+//
+//*****************************************************************************
+
+BOOL
+LoadUsbIds (
+    __in_opt PCTSTR DatabaseFile,
+    __in_opt PCTSTR IndexFile
+)
+{
+    WIN32_FILE_ATTRIBUTE_DATA   source;
+    TCHAR                       indexFile[MAX_PATH];
+
+    UnloadUsbIds();
+
+    if (IndexFile == NULL)
+    {
+        if (DatabaseFile == NULL ||
+            _stprintf_s(indexFile, MAX_PATH, _T("%s.idx"), DatabaseFile) < 0)
+        {
+            return FALSE;
+        }
+
+        IndexFile = indexFile;
+    }
+
+    if (DatabaseFile == NULL)
+    {
+        return MapUsbIdsIndex(IndexFile, NULL, 0);
+    }
+
+    if (!GetFileAttributesEx(DatabaseFile, GetFileExInfoStandard, &source) ||
+        source.nFileSizeHigh != 0 ||
+        source.nFileSizeLow > MAX_USB_IDS_FILE_SIZE)
+    {
+        return FALSE;
+    }
+
+    if (MapUsbIdsIndex(IndexFile, &source.ftLastWriteTime, source.nFileSizeLow))
+    {
+        return TRUE;
+    }
+
+    return CompileUsbIds(DatabaseFile, IndexFile) &&
+           MapUsbIdsIndex(IndexFile, &source.ftLastWriteTime, source.nFileSizeLow);
+}
+
+//*****************************************************************************
+//
+// UnloadUsbIds()
+//
+//*****************************************************************************
+
+VOID
+UnloadUsbIds (
+    VOID
+)
+{
+    UsbIdsVendors = NULL;
+    UsbIdsProducts = NULL;
+    UsbIdsClasses = NULL;
+    UsbIdsNames = NULL;
+
+    if (UsbIdsHeader != NULL)
+    {
+        UnmapViewOfFile(UsbIdsHeader);
+        UsbIdsHeader = NULL;
+    }
+
+    if (UsbIdsMapping != NULL)
+    {
+        CloseHandle(UsbIdsMapping);
+        UsbIdsMapping = NULL;
+    }
+
+    if (UsbIdsFile != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(UsbIdsFile);
+        UsbIdsFile = INVALID_HANDLE_VALUE;
+    }
+}
+
+//*****************************************************************************
+//
+// LookupUsbVendorName()
+//
+// Returns the name of the vendor, or NULL if it is not in the database.
+//
+//*****************************************************************************
+
+PCTSTR
+LookupUsbVendorName (
+    USHORT  VendorID
+)
+{
+    if (UsbIdsVendors == NULL || UsbIdsVendors[VendorID] == 0)
+    {
+        return NULL;
+    }
+
+    return UsbIdsNames + UsbIdsVendors[VendorID];
+}
+
+//*****************************************************************************
+//
+// LookupUsbProductName()
+//
+// Returns the name of the product, or NULL if it is not in the database.
+//
+//*****************************************************************************
+
+PCTSTR
+LookupUsbProductName (
+    USHORT  VendorID,
+    USHORT  ProductID
+)
+{
+    if (UsbIdsProducts == NULL)
+    {
+        return NULL;
+    }
+
+    return LookupUsbIdsHash(UsbIdsProducts,
+                            UsbIdsHeader->ProductHashSize,
+                            ((ULONG)VendorID << 16) | ProductID);
+}
+
+//*****************************************************************************
+//
+// LookupUsbClassName()
+// LookupUsbSubClassName()
+// LookupUsbProtocolName()
+//
+// Return the name of a device or interface class, subclass or protocol,
+// or NULL if it is not in the database.
+//
+//*****************************************************************************
+
+PCTSTR
+LookupUsbClassName (
+    UCHAR   Class
+)
+{
+    if (UsbIdsClasses == NULL)
+    {
+        return NULL;
+    }
+
+    return LookupUsbIdsHash(UsbIdsClasses,
+                            UsbIdsHeader->ClassHashSize,
+                            CLASS_KEY(Class));
+}
+
+PCTSTR
+LookupUsbSubClassName (
+    UCHAR   Class,
+    UCHAR   SubClass
+)
+{
+    if (UsbIdsClasses == NULL)
+    {
+        return NULL;
+    }
+
+    return LookupUsbIdsHash(UsbIdsClasses,
+                            UsbIdsHeader->ClassHashSize,
+                            SUBCLASS_KEY(Class, SubClass));
+}
+
+PCTSTR
+LookupUsbProtocolName (
+    UCHAR   Class,
+    UCHAR   SubClass,
+    UCHAR   Protocol
+)
+{
+    if (UsbIdsClasses == NULL)
+    {
+        return NULL;
+    }
+
+    return LookupUsbIdsHash(UsbIdsClasses,
+                            UsbIdsHeader->ClassHashSize,
+                            PROTOCOL_KEY(Class, SubClass, Protocol));
+}
+
+//*****************************************************************************
+//
+// MapUsbIdsIndex()
+//
+// Maps IndexFile if it is an index of this version and character set, and
+// was compiled from a text file with the given time and size, if given.
+// Every offset in it is checked, so a damaged index is compiled again
+// rather than read out of bounds.
+//
+//*****************************************************************************
+
+BOOL
+MapUsbIdsIndex (
+    PCTSTR      IndexFile,
+    __in_opt LPFILETIME SourceTime,
+    ULONG       SourceSize
+)
+{
+    PUSB_IDS_HEADER     header;
+    PUSB_IDS_HASH_ENTRY entry;
+    ULONGLONG           size;
+    DWORD               fileSize;
+    DWORD               fileSizeHigh;
+    ULONG               i;
+
+    UsbIdsFile = CreateFile(IndexFile,
+                            GENERIC_READ,
+                            FILE_SHARE_READ,
+                            NULL,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL,
+                            NULL);
+
+    if (UsbIdsFile == INVALID_HANDLE_VALUE)
+    {
+        return FALSE;
+    }
+
+    fileSize = GetFileSize(UsbIdsFile, &fileSizeHigh);
+
+    if (fileSizeHigh != 0 || fileSize < sizeof(USB_IDS_HEADER))
+    {
+        UnloadUsbIds();
+        return FALSE;
+    }
+
+    UsbIdsMapping = CreateFileMapping(UsbIdsFile, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if (UsbIdsMapping == NULL)
+    {
+        UnloadUsbIds();
+        return FALSE;
+    }
+
+    header = (PUSB_IDS_HEADER)MapViewOfFile(UsbIdsMapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (header == NULL)
+    {
+        UnloadUsbIds();
+        return FALSE;
+    }
+
+    UsbIdsHeader = header;
+
+    size = sizeof(USB_IDS_HEADER) +
+           USB_IDS_VENDORS * sizeof(ULONG) +
+           ((ULONGLONG)header->ProductHashSize + header->ClassHashSize) *
+               sizeof(USB_IDS_HASH_ENTRY) +
+           (ULONGLONG)header->NamesLength * sizeof(TCHAR);
+
+    if (header->Magic != USB_IDS_MAGIC ||
+        header->Version != USB_IDS_VERSION ||
+        header->CharSize != sizeof(TCHAR) ||
+        (SourceTime != NULL &&
+         (CompareFileTime(&header->SourceTime, SourceTime) != 0 ||
+          header->SourceSize != SourceSize)) ||
+        header->ProductHashSize == 0 ||
+        (header->ProductHashSize & (header->ProductHashSize - 1)) != 0 ||
+        header->ClassHashSize == 0 ||
+        (header->ClassHashSize & (header->ClassHashSize - 1)) != 0 ||
+        header->NamesLength == 0 ||
+        size != fileSize)
+    {
+        UnloadUsbIds();
+        return FALSE;
+    }
+
+    UsbIdsVendors = (PULONG)(header + 1);
+    UsbIdsProducts = (PUSB_IDS_HASH_ENTRY)(UsbIdsVendors + USB_IDS_VENDORS);
+    UsbIdsClasses = UsbIdsProducts + header->ProductHashSize;
+    UsbIdsNames = (PCTSTR)(UsbIdsClasses + header->ClassHashSize);
+
+    // Names are looked up without checking, so check them all now
+    //
+    for (i = 0; i < USB_IDS_VENDORS; i++)
+    {
+        if (UsbIdsVendors[i] >= header->NamesLength)
+        {
+            UnloadUsbIds();
+            return FALSE;
+        }
+    }
+
+    for (entry = UsbIdsProducts;
+         entry < UsbIdsProducts + header->ProductHashSize + header->ClassHashSize;
+         entry++)
+    {
+        if (entry->Name >= header->NamesLength)
+        {
+            UnloadUsbIds();
+            return FALSE;
+        }
+    }
+
+    if (UsbIdsNames[0] != 0 || UsbIdsNames[header->NamesLength - 1] != 0)
+    {
+        UnloadUsbIds();
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// CompileUsbIds()
+//
+// Compiles the text DatabaseFile into IndexFile, see MapUsbIdsIndex().
+//
+//*****************************************************************************
+
+BOOL
+CompileUsbIds (
+    PCTSTR      DatabaseFile,
+    PCTSTR      IndexFile
+)
+{
+    HANDLE              hFile;
+    BY_HANDLE_FILE_INFORMATION fileInfo;
+    PCHAR               text;
+    DWORD               length;
+    PUSB_IDS_LINE       lines;
+    ULONG               numLines;
+    ULONG               i;
+    USB_IDS_HEADER      sizes;
+    PUSB_IDS_HEADER     header;
+    PULONG              vendors;
+    PUSB_IDS_HASH_ENTRY products;
+    PUSB_IDS_HASH_ENTRY classes;
+    PTSTR               names;
+    ULONG               namesLength;
+    ULONG               name;
+    ULONG               nameLength;
+    ULONG               indexSize;
+    DWORD               bytesWritten;
+    BOOL                success;
+
+    text = NULL;
+    lines = NULL;
+    header = NULL;
+    success = FALSE;
+
+    hFile = CreateFile(DatabaseFile,
+                       GENERIC_READ,
+                       FILE_SHARE_READ,
+                       NULL,
+                       OPEN_EXISTING,
+                       FILE_ATTRIBUTE_NORMAL,
+                       NULL);
+
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        return FALSE;
+    }
+
+    if (!GetFileInformationByHandle(hFile, &fileInfo) ||
+        fileInfo.nFileSizeHigh != 0 ||
+        fileInfo.nFileSizeLow > MAX_USB_IDS_FILE_SIZE)
+    {
+        goto CompileUsbIdsDone;
+    }
+
+    text = (PCHAR)ALLOC(fileInfo.nFileSizeLow + 1);
+
+    // No more lines than characters
+    //
+    lines = (PUSB_IDS_LINE)ALLOC((fileInfo.nFileSizeLow + 1) * sizeof(USB_IDS_LINE));
+
+    if (text == NULL || lines == NULL)
+    {
+        OOPS();
+        goto CompileUsbIdsDone;
+    }
+
+    if (!ReadFile(hFile, text, fileInfo.nFileSizeLow, &length, NULL) ||
+        length != fileInfo.nFileSizeLow)
+    {
+        OOPS();
+        goto CompileUsbIdsDone;
+    }
+
+    numLines = ParseUsbIds(text, length, lines);
+
+    // Size everything up
+    //
+    memset(&sizes, 0, sizeof(sizes));
+
+    namesLength = 1;
+
+    for (i = 0; i < numLines; i++)
+    {
+#ifdef UNICODE
+        nameLength = MultiByteToWideChar(CP_UTF8, 0,
+                                         lines[i].Name,
+                                         lines[i].NameLength,
+                                         NULL, 0);
+#else
+        nameLength = lines[i].NameLength;
+#endif
+        namesLength += nameLength + 1;
+
+        switch (lines[i].Kind)
+        {
+            case UsbIdsVendor:  sizes.Vendors++;   break;
+            case UsbIdsProduct: sizes.Products++;  break;
+            case UsbIdsClass:   sizes.Classes++;   break;
+        }
+    }
+
+    sizes.ProductHashSize = HashTableSize(sizes.Products);
+    sizes.ClassHashSize = HashTableSize(sizes.Classes);
+    sizes.NamesLength = namesLength;
+
+    indexSize = sizeof(USB_IDS_HEADER) +
+                USB_IDS_VENDORS * sizeof(ULONG) +
+                (sizes.ProductHashSize + sizes.ClassHashSize) *
+                    sizeof(USB_IDS_HASH_ENTRY) +
+                namesLength * sizeof(TCHAR);
+
+    header = (PUSB_IDS_HEADER)ALLOC(indexSize);
+
+    if (header == NULL)
+    {
+        OOPS();
+        goto CompileUsbIdsDone;
+    }
+
+    *header = sizes;
+
+    header->Magic = USB_IDS_MAGIC;
+    header->Version = USB_IDS_VERSION;
+    header->CharSize = sizeof(TCHAR);
+    header->SourceTime = fileInfo.ftLastWriteTime;
+    header->SourceSize = fileInfo.nFileSizeLow;
+
+    vendors = (PULONG)(header + 1);
+    products = (PUSB_IDS_HASH_ENTRY)(vendors + USB_IDS_VENDORS);
+    classes = products + header->ProductHashSize;
+    names = (PTSTR)(classes + header->ClassHashSize);
+
+    // The allocation is zeroed, so offset 0 already is the empty name
+    //
+    name = 1;
+
+    for (i = 0; i < numLines; i++)
+    {
+#ifdef UNICODE
+        nameLength = MultiByteToWideChar(CP_UTF8, 0,
+                                         lines[i].Name,
+                                         lines[i].NameLength,
+                                         names + name,
+                                         namesLength - name - 1);
+#else
+        nameLength = lines[i].NameLength;
+        memcpy(names + name, lines[i].Name, nameLength);
+#endif
+        names[name + nameLength] = 0;
+
+        // The first of several entries for the same ID wins
+        //
+        switch (lines[i].Kind)
+        {
+            case UsbIdsVendor:
+                if (vendors[lines[i].Key] == 0)
+                {
+                    vendors[lines[i].Key] = name;
+                }
+                break;
+
+            case UsbIdsProduct:
+                InsertUsbIdsHash(products, header->ProductHashSize,
+                                 lines[i].Key, name);
+                break;
+
+            case UsbIdsClass:
+                InsertUsbIdsHash(classes, header->ClassHashSize,
+                                 lines[i].Key, name);
+                break;
+        }
+
+        name += nameLength + 1;
+    }
+
+    CloseHandle(hFile);
+
+    hFile = CreateFile(IndexFile,
+                       GENERIC_WRITE,
+                       0,
+                       NULL,
+                       CREATE_ALWAYS,
+                       FILE_ATTRIBUTE_NORMAL,
+                       NULL);
+
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        OOPS();
+        goto CompileUsbIdsDone;
+    }
+
+    success = WriteFile(hFile, header, indexSize, &bytesWritten, NULL) &&
+              bytesWritten == indexSize;
+
+    if (!success)
+    {
+        OOPS();
+    }
+
+CompileUsbIdsDone:
+
+    if (hFile != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(hFile);
+    }
+
+    if (!success && header != NULL)
+    {
+        DeleteFile(IndexFile);
+    }
+
+    if (header != NULL)
+    {
+        FREE(header);
+    }
+
+    if (lines != NULL)
+    {
+        FREE(lines);
+    }
+
+    if (text != NULL)
+    {
+        FREE(text);
+    }
+
+    return success;
+}
+
+//*****************************************************************************
+//
+// ParseUsbIds()
+//
+// Text, Length - The usb.ids text file.
+//
+// Lines - Receives the vendors, the products of each vendor, and the
+// classes with their subclasses and protocols.  Names point into Text.
+//
+// Returns the number of Lines filled in.  Interfaces of products and the
+// other lists of the file (HID usages, languages, ...) are skipped.
+//
+//*****************************************************************************
+
+ULONG
+ParseUsbIds (
+    PCSTR           Text,
+    ULONG           Length,
+    PUSB_IDS_LINE   Lines
+)
+{
+    PCSTR   end;
+    PCSTR   line;
+    PCSTR   lineEnd;
+    PCSTR   p;
+    ULONG   numLines;
+    ULONG   tabs;
+    ULONG   value;
+    ULONG   vendor;
+    ULONG   class;
+    ULONG   subClass;
+    enum { InNothing, InVendor, InClass } section;
+
+    end = Text + Length;
+    numLines = 0;
+    section = InNothing;
+    vendor = 0;
+    class = 0;
+    subClass = 0;
+
+    for (line = Text; line < end; line = lineEnd + 1)
+    {
+        lineEnd = line;
+
+        while (lineEnd < end && *lineEnd != '\n')
+        {
+            lineEnd++;
+        }
+
+        p = line;
+
+        if (p == lineEnd || *p == '#' || *p == '\r')
+        {
+            continue;
+        }
+
+        for (tabs = 0; p < lineEnd && *p == '\t'; p++)
+        {
+            tabs++;
+        }
+
+        if (tabs == 0)
+        {
+            section = InNothing;
+
+            if (p + 2 <= lineEnd && p[0] == 'C' && p[1] == ' ')
+            {
+                p += 2;
+
+                if (!ParseUsbIdsHex(&p, lineEnd, 2, &value))
+                {
+                    continue;
+                }
+
+                section = InClass;
+                class = value;
+
+                Lines[numLines].Kind = UsbIdsClass;
+                Lines[numLines].Key = CLASS_KEY(class);
+            }
+            else
+            {
+                if (!ParseUsbIdsHex(&p, lineEnd, 4, &value))
+                {
+                    continue;
+                }
+
+                section = InVendor;
+                vendor = value;
+
+                Lines[numLines].Kind = UsbIdsVendor;
+                Lines[numLines].Key = vendor;
+            }
+        }
+        else if (tabs == 1 && section == InVendor)
+        {
+            if (!ParseUsbIdsHex(&p, lineEnd, 4, &value))
+            {
+                continue;
+            }
+
+            Lines[numLines].Kind = UsbIdsProduct;
+            Lines[numLines].Key = (vendor << 16) | value;
+        }
+        else if (tabs == 1 && section == InClass)
+        {
+            if (!ParseUsbIdsHex(&p, lineEnd, 2, &value))
+            {
+                continue;
+            }
+
+            subClass = value;
+
+            Lines[numLines].Kind = UsbIdsClass;
+            Lines[numLines].Key = SUBCLASS_KEY(class, subClass);
+        }
+        else if (tabs == 2 && section == InClass)
+        {
+            if (!ParseUsbIdsHex(&p, lineEnd, 2, &value))
+            {
+                continue;
+            }
+
+            Lines[numLines].Kind = UsbIdsClass;
+            Lines[numLines].Key = PROTOCOL_KEY(class, subClass, value);
+        }
+        else
+        {
+            continue;
+        }
+
+        // The name follows after two spaces, up to the end of the line
+        //
+        while (p < lineEnd && (*p == ' ' || *p == '\t'))
+        {
+            p++;
+        }
+
+        Lines[numLines].Name = p;
+
+        while (lineEnd > p && (lineEnd[-1] == '\r' || lineEnd[-1] == ' '))
+        {
+            lineEnd--;
+        }
+
+        Lines[numLines].NameLength = (ULONG)(lineEnd - p);
+
+        numLines++;
+
+        // Back to the real end of the line
+        //
+        while (lineEnd < end && *lineEnd != '\n')
+        {
+            lineEnd++;
+        }
+    }
+
+    return numLines;
+}
+
+//*****************************************************************************
+//
+// ParseUsbIdsHex()
+//
+// Parses exactly Digits hex digits followed by a blank at *Text, and moves
+// *Text past them.
+//
+//*****************************************************************************
+
+BOOL
+ParseUsbIdsHex (
+    PCSTR   *Text,
+    PCSTR   End,
+    ULONG   Digits,
+    PULONG  Value
+)
+{
+    PCSTR   p;
+    ULONG   i;
+    ULONG   digit;
+
+    p = *Text;
+
+    if (p + Digits >= End || (p[Digits] != ' ' && p[Digits] != '\t'))
+    {
+        return FALSE;
+    }
+
+    *Value = 0;
+
+    for (i = 0; i < Digits; i++, p++)
+    {
+        if (*p >= '0' && *p <= '9')
+        {
+            digit = *p - '0';
+        }
+        else if (*p >= 'a' && *p <= 'f')
+        {
+            digit = *p - 'a' + 10;
+        }
+        else if (*p >= 'A' && *p <= 'F')
+        {
+            digit = *p - 'A' + 10;
+        }
+        else
+        {
+            return FALSE;
+        }
+
+        *Value = (*Value << 4) | digit;
+    }
+
+    *Text = p;
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// HashUsbIdsKey()
+//
+// Mixes all bits of Key into the low ones, Product IDs alone are not
+// spread well.
+//
+//*****************************************************************************
+
+ULONG
+HashUsbIdsKey (
+    ULONG   Key
+)
+{
+    Key ^= Key >> 16;
+    Key *= 0x85EBCA6B;
+    Key ^= Key >> 13;
+    Key *= 0xC2B2AE35;
+    Key ^= Key >> 16;
+
+    return Key;
+}
+
+//*****************************************************************************
+//
+// HashTableSize()
+//
+// Returns a power of 2 of at least twice Entries, so probes stay short.
+//
+//*****************************************************************************
+
+ULONG
+HashTableSize (
+    ULONG   Entries
+)
+{
+    ULONG   size;
+
+    for (size = 16; size < Entries * 2; size *= 2)
+    {
+    }
+
+    return size;
+}
+
+//*****************************************************************************
+//
+// InsertUsbIdsHash()
+//
+//*****************************************************************************
+
+VOID
+InsertUsbIdsHash (
+    PUSB_IDS_HASH_ENTRY Table,
+    ULONG               Size,
+    ULONG               Key,
+    ULONG               Name
+)
+{
+    ULONG   slot;
+
+    for (slot = HashUsbIdsKey(Key) & (Size - 1);
+         Table[slot].Name != 0;
+         slot = (slot + 1) & (Size - 1))
+    {
+        if (Table[slot].Key == Key)
+        {
+            return;
+        }
+    }
+
+    Table[slot].Key = Key;
+    Table[slot].Name = Name;
+}
+
+//*****************************************************************************
+//
+// LookupUsbIdsHash()
+//
+//*****************************************************************************
+
+PCTSTR
+LookupUsbIdsHash (
+    PUSB_IDS_HASH_ENTRY Table,
+    ULONG               Size,
+    ULONG               Key
+)
+{
+    ULONG   slot;
+    ULONG   probes;
+
+    // A damaged index may have no free slot, so stop after the whole table
+    //
+    for (slot = HashUsbIdsKey(Key) & (Size - 1), probes = 0;
+         Table[slot].Name != 0 && probes < Size;
+         slot = (slot + 1) & (Size - 1), probes++)
+    {
+        if (Table[slot].Key == Key)
+        {
+            return UsbIdsNames + Table[slot].Name;
+        }
+    }
+
+    return NULL;
+}
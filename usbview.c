@@ -51,6 +51,24 @@ Revision History:
 #define SIZEBAR             0
 #define WINDOWSCALEFACTOR   15
 
+// device change notifications
+//
+#define REFRESH_TIMER           1
+#define DEFAULT_QUIET_PERIOD    250     // ms
+#define DEFAULT_MAX_DELAY       2000    // ms
+
+// detail text kept for items selected before
+//
+#define DEFAULT_RENDER_CACHE    4096    // KB
+
+// posted by the enumeration thread, lParam is the PUSB_SNAPSHOT
+//
+#define WM_USBVIEW_SNAPSHOT     (WM_APP + 1)
+
+// posted by the enumeration thread, lParam is the PLAZY_DESC_REQUEST
+//
+#define WM_USBVIEW_DESCRIPTORS  (WM_APP + 2)
+
 //*****************************************************************************
 // L O C A L    F U N C T I O N    P R O T O T Y P E S
 //*****************************************************************************
@@ -142,10 +160,51 @@ USBView_OnDeviceChange (
     DWORD dwEventData
 );
 
+VOID
+USBView_OnTimer (
+    HWND hWnd,
+    UINT id
+);
+
+VOID
+USBView_OnSnapshot (
+    HWND          hWnd,
+    ULONG         Request,
+    PUSB_SNAPSHOT Snapshot
+);
+
+VOID
+USBView_OnDescriptors (
+    HWND                hWnd,
+    PLAZY_DESC_REQUEST  Request
+);
+
+PUSBTREENODE
+FindInfoTreeNode (
+    PUSBTREENODE    Node,
+    PVOID           Info
+);
+
+VOID
+StopRefreshing (
+    HWND hWnd
+);
+
+VOID
+TakeSnapshot (
+    PUSB_SNAPSHOT Snapshot
+);
+
+VOID
+ScheduleRefresh (
+    HWND  hWnd,
+    ULONG Delay
+);
+
 
 VOID DestroyTree (VOID);
 
-VOID RefreshTree (VOID);
+ULONG RefreshTree (VOID);
 
 INT_PTR CALLBACK
 AboutDlgProc (
@@ -168,6 +227,58 @@ ExpandItem (
     HTREEITEM hTreeItem
 );
 
+VOID
+PopulateTree (
+    HTREEITEM       hTreeParent,
+    PUSBTREENODE    Node
+);
+
+HTREEITEM
+InsertLeaf (
+    HTREEITEM       hTreeParent,
+    HTREEITEM       hInsertAfter,
+    LPARAM          lParam,
+    __in LPTSTR     lpszText,
+    TREEICON        TreeIcon
+);
+
+int
+GetTreeIconImage (
+    TREEICON        TreeIcon
+);
+
+BOOL
+InsertTreeItem (
+    PVOID           Context,
+    PUSBTREENODE    Parent,
+    PUSBTREENODE    After,
+    PUSBTREENODE    Node
+);
+
+VOID
+RemoveTreeItem (
+    PVOID           Context,
+    PUSBTREENODE    Node
+);
+
+VOID
+UpdateTreeItem (
+    PVOID           Context,
+    PUSBTREENODE    Node,
+    PUSBTREENODE    NewNode,
+    BOOL            Changed
+);
+
+VOID
+ParseCommandLine (
+    VOID
+);
+
+VOID
+ParseLanguages (
+    PCTSTR  Languages
+);
+
 //*****************************************************************************
 // G L O B A L S    P R I V A T E    T O    T H I S    F I L E
 //*****************************************************************************
@@ -183,9 +294,19 @@ HCURSOR         ghSplitCursor;
 int             gBarLocation    = 0;
 BOOL            gbButtonDown    = FALSE;
 HTREEITEM       ghTreeRoot      = NULL;
+USBTREENODE     gTreeModel;     // what ghTreeRoot shows
 
 BOOL            gDoAutoRefresh  = FALSE;
 BOOL            gDoConfigDesc   = FALSE;
+BOOL            gDoLazyDesc     = TRUE;
+BOOL            gDoOverlapped   = TRUE;
+BOOL            gDoDevNodeIndex = TRUE;
+
+ULONG           gBandwidthThreshold = DEFAULT_BANDWIDTH_THRESHOLD;
+
+STRING_LANGUAGES gStringLanguages = StringLanguagesAll;
+USHORT           gPreferredLanguageIDs[MAX_PREFERRED_LANGUAGES];
+ULONG            gNumPreferredLanguageIDs;
 
 // added
 int             giGoodDevice;
@@ -195,6 +316,27 @@ int             giHub;
 int             giNoDevice;
 HDEVNOTIFY      gNotifyDevHandle;
 HDEVNOTIFY      gNotifyHubHandle;
+REFRESH_SCHEDULER gRefreshScheduler;
+BOOL            gEnumThread     = FALSE;    // enumerating in the background
+BOOL            gEnumAbandoned  = FALSE;    // the thread did not stop in time
+
+// command line options
+TCHAR           gRecordFile[MAX_PATH];
+TCHAR           gReplayFile[MAX_PATH];
+BOOL            gReplayLatency  = FALSE;
+TCHAR           gBenchFile[MAX_PATH];
+ULONG           gEnumWorkers;
+ULONG           gQuietPeriod    = DEFAULT_QUIET_PERIOD;
+ULONG           gMaxRefreshDelay = DEFAULT_MAX_DELAY;
+ULONG           gRenderCacheKB  = DEFAULT_RENDER_CACHE;
+TCHAR           gRenderFile[MAX_PATH];
+TCHAR           gRenderToFile[MAX_PATH];
+ULONG           gFirstSection   = 0;
+ULONG           gNumSections    = MAXULONG;
+TCHAR           gUsbIdsFile[MAX_PATH];
+TCHAR           gUsbIdxFile[MAX_PATH];
+TCHAR           gJsonFile[MAX_PATH];
+TCHAR           gBinaryFile[MAX_PATH];
 
 
 //*****************************************************************************
@@ -218,7 +360,128 @@ WinMain (
 
     ghInstance = hInstance;
 
-    
+    ParseCommandLine();
+
+    BuildClassDecoders();
+
+    // Run the benchmark instead of the UI if asked to
+    //
+    if (gBenchFile[0] != 0)
+    {
+        BOOL success;
+
+        success = RunEnumerationBenchmark(gBenchFile, gEnumWorkers);
+
+        StopTraceRecording();
+
+        StopTraceReplay();
+
+        StopSimulation();
+
+        FreeDescriptorCache();
+
+        UnloadUsbIds();
+
+        CHECKFORLEAKS();
+
+        return success ? 0 : 1;
+    }
+
+    // Or render captured descriptors
+    //
+    if (gRenderFile[0] != 0)
+    {
+        TEXT_SINK sink;
+        BOOL      success;
+
+        success = gRenderToFile[0] != 0 ? InitFileSink(&sink, gRenderToFile) :
+                                          InitStdoutSink(&sink);
+
+        if (success)
+        {
+            success = RenderDescriptorFile(gRenderFile,
+                                           &sink,
+                                           gFirstSection,
+                                           gNumSections);
+
+            CloseTextSink(&sink);
+        }
+
+        UnloadUsbIds();
+
+        CHECKFORLEAKS();
+
+        return success ? 0 : 1;
+    }
+
+    // Or write the device tree in a machine readable format
+    //
+    if (gJsonFile[0] != 0 || gBinaryFile[0] != 0)
+    {
+        USB_SNAPSHOT snapshot;
+        ENUM_CONTEXT context;
+        BOOL         success;
+
+        if (!WorkPoolCreate(gEnumWorkers))
+        {
+            OOPS();
+        }
+
+        memset(&snapshot, 0, sizeof(snapshot));
+
+        InitEnumContext(&context, &snapshot);
+
+        // Everything is written, so fetch it all now
+        //
+        context.DoConfigDesc = TRUE;
+        context.DoLazyDesc = FALSE;
+
+        EnumerateHostControllers(&context);
+
+        DropUnnamedTreeNodes(&snapshot.Root);
+
+        success = TRUE;
+
+        if (gJsonFile[0] != 0)
+        {
+            success = SerializeToFile(&snapshot, SerialFormatJson, gJsonFile);
+        }
+
+        if (gBinaryFile[0] != 0)
+        {
+            success = SerializeToFile(&snapshot, SerialFormatBinary, gBinaryFile) &&
+                      success;
+        }
+
+        FreeTreeNodes(&snapshot.Root, TRUE);
+
+        WorkPoolDestroy();
+
+        StopTraceRecording();
+
+        StopTraceReplay();
+
+        StopSimulation();
+
+        FreeDescriptorCache();
+
+        UnloadUsbIds();
+
+        CHECKFORLEAKS();
+
+        return success ? 0 : 1;
+    }
+
+    if (!WorkPoolCreate(gEnumWorkers))
+    {
+        OOPS();
+    }
+
+    InitRefreshScheduler(&gRefreshScheduler,
+                         gQuietPeriod,
+                         gMaxRefreshDelay,
+                         NULL,
+                         NULL);
 
     ghSplitCursor = LoadCursor(ghInstance,
                                MAKEINTRESOURCE(IDC_SPLIT));
@@ -243,6 +506,8 @@ WinMain (
         return 0;
     }
 
+    SetRenderCacheBudget(gRenderCacheKB * 1024);
+
     if (!CreateMainWindow(nCmdShow))
     {
         return 0;
@@ -261,8 +526,33 @@ WinMain (
         }
     }
 
+    // An abandoned enumeration thread may be stuck in a request, and the
+    // pool workers with it, still using the backend, the caches and the
+    // usb.ids table.  Freeing them would pull them from under it, and
+    // WorkPoolDestroy() would wait on the stuck workers forever.  Leave it
+    // all to the end of the process.
+    //
+    if (gEnumAbandoned)
+    {
+        return 1;
+    }
+
     DestroyTextBuffer();
 
+    FreeRenderCache();
+
+    UnloadUsbIds();
+
+    WorkPoolDestroy();
+
+    StopTraceRecording();
+
+    StopTraceReplay();
+
+    StopSimulation();
+
+    FreeDescriptorCache();
+
     CHECKFORLEAKS();
 
     return 1;
@@ -270,75 +560,399 @@ WinMain (
 
 //*****************************************************************************
 //
-// CreateMainWindow()
+// ParseCommandLine()
+//
+// Recognized options:
+//
+// /record:<file>   Record all device access to <file> while running.
+// /replay:<file>   Serve all device access from a previously recorded <file>
+//                  instead of the real USB stack.
+// /replaylatency   With /replay, sleep for the recorded latency of each call.
+// /simulate:<controllers>,<depth>,<latency>
+//                  Enumerate a simulated topology instead of the real USB
+//                  stack.  Each root hub has a tree of external hubs <depth>
+//                  levels deep below it, every request takes <latency> ms.
+// /workers:<n>     Number of enumeration threads, 0 to enumerate serially.
+//                  The default is one per processor.
+// /nooverlapped    Query the ports of a hub one after another instead of
+//                  all at the same time.
+// /nodevnodeindex  Walk the devnode tree for every driver key looked up
+//                  instead of indexing it once per refresh.
+// /eagerdescriptors
+//                  Fetch the Configuration and String Descriptors of every
+//                  device during a refresh, instead of when the device is
+//                  first displayed.
+// /languages:all|first|<id>[,<id>...]
+//                  Languages String Descriptors are requested in: all the
+//                  device supports (the default), only its first one, or
+//                  those of the listed hex Language IDs it supports.
+// /quiet:<ms>      With auto refresh, wait until there were no device
+//                  changes for <ms> before refreshing.  The default is 250.
+// /maxdelay:<ms>   But refresh no later than <ms> after the first device
+//                  change.  The default is 2000.
+// /bwthreshold:<percent>
+//                  Flag host controllers and hubs whose busiest frame or
+//                  microframe uses more than <percent> of its periodic
+//                  time.  The default is 90.
+// /rendercache:<KB>
+//                  Keep up to <KB> of the detail text of items selected
+//                  before, 0 to format it on every selection.  The default
+//                  is 4096.
+// /bench:<file>    Time enumeration with 0 up to <n> workers, write the
+//                  results to <file> and exit.
+// /render:<file>   Write the details of the device whose descriptors were
+//                  captured to <file> to stdout and exit.
+// /renderto:<file> With /render, write them to <file> instead.
+// /sections:<first>,<count>
+//                  With /render, only write <count> sections starting at
+//                  <first>: section 0 is the Device Descriptor, each
+//                  descriptor of the configuration is one more.
+// /usbids:<file>   Take the names of vendors, products and classes from the
+//                  usb.ids style <file>.  The default is a usb.ids next to
+//                  usbview.exe, if there is one.
+// /usbidx:<file>   Keep the index compiled from it in <file> instead of
+//                  next to it, with .idx appended.  Without /usbids, use
+//                  <file> as it is.
+// /json:<file>     Write the device tree, with everything the detail view
+//                  shows of each item, to <file> as JSON and exit.  A
+//                  <file> of - is stdout.
+// /binary:<file>   Write it to <file> in the compact binary format of
+//                  SERIAL.C.  Both may be given, the tree is enumerated once.
 //
 //*****************************************************************************
 
-BOOL
-CreateMainWindow (
-    int nCmdShow
+VOID
+ParseCommandLine (
+    VOID
 )
 {
-    RECT rc;
+    PCTSTR      cmdLine;
+    TCHAR       arg[MAX_PATH + 16];
+    ULONG       len;
+    BOOL        quoted;
+    BOOL        programName;
+    ULONG       simControllers;
+    ULONG       simDepth;
+    ULONG       simLatency;
+    SYSTEM_INFO systemInfo;
 
-    InitCommonControls();
+    simControllers = 0;
+    simDepth = 0;
+    simLatency = 0;
 
-    ghMainWnd = CreateDialog(ghInstance,
-                             MAKEINTRESOURCE(IDD_MAINDIALOG),
-                             NULL,
-                             MainDlgProc);
+    GetSystemInfo(&systemInfo);
 
-    if (ghMainWnd == NULL)
+    gEnumWorkers = systemInfo.dwNumberOfProcessors;
+
+    cmdLine = GetCommandLine();
+
+    programName = TRUE;
+
+    for (;;)
     {
-        OOPS();
-        return FALSE;
+        while (*cmdLine == _T(' ') || *cmdLine == _T('\t'))
+        {
+            cmdLine++;
+        }
+
+        if (*cmdLine == 0)
+        {
+            break;
+        }
+
+        // Copy out the next argument, dropping any double quotes
+        //
+        len = 0;
+        quoted = FALSE;
+
+        while (*cmdLine != 0 &&
+               (quoted || (*cmdLine != _T(' ') && *cmdLine != _T('\t'))))
+        {
+            if (*cmdLine == _T('"'))
+            {
+                quoted = !quoted;
+            }
+            else if (len < sizeof(arg)/sizeof(arg[0]) - 1)
+            {
+                arg[len++] = *cmdLine;
+            }
+
+            cmdLine++;
+        }
+
+        arg[len] = 0;
+
+        if (programName)
+        {
+            programName = FALSE;
+            continue;
+        }
+
+        if (_tcsnicmp(arg, _T("/record:"), 8) == 0)
+        {
+            _tcscpy_s(gRecordFile, MAX_PATH, arg + 8);
+        }
+        else if (_tcsnicmp(arg, _T("/replay:"), 8) == 0)
+        {
+            _tcscpy_s(gReplayFile, MAX_PATH, arg + 8);
+        }
+        else if (_tcsicmp(arg, _T("/replaylatency")) == 0)
+        {
+            gReplayLatency = TRUE;
+        }
+        else if (_tcsnicmp(arg, _T("/simulate:"), 10) == 0)
+        {
+            if (_stscanf_s(arg + 10, _T("%u,%u,%u"),
+                           &simControllers, &simDepth, &simLatency) < 1)
+            {
+                OOPS();
+            }
+        }
+        else if (_tcsnicmp(arg, _T("/workers:"), 9) == 0)
+        {
+            gEnumWorkers = _tcstoul(arg + 9, NULL, 10);
+        }
+        else if (_tcsicmp(arg, _T("/nooverlapped")) == 0)
+        {
+            gDoOverlapped = FALSE;
+        }
+        else if (_tcsicmp(arg, _T("/nodevnodeindex")) == 0)
+        {
+            gDoDevNodeIndex = FALSE;
+        }
+        else if (_tcsicmp(arg, _T("/eagerdescriptors")) == 0)
+        {
+            gDoLazyDesc = FALSE;
+        }
+        else if (_tcsnicmp(arg, _T("/languages:"), 11) == 0)
+        {
+            ParseLanguages(arg + 11);
+        }
+        else if (_tcsnicmp(arg, _T("/quiet:"), 7) == 0)
+        {
+            gQuietPeriod = _tcstoul(arg + 7, NULL, 10);
+        }
+        else if (_tcsnicmp(arg, _T("/maxdelay:"), 10) == 0)
+        {
+            gMaxRefreshDelay = _tcstoul(arg + 10, NULL, 10);
+        }
+        else if (_tcsnicmp(arg, _T("/bwthreshold:"), 13) == 0)
+        {
+            gBandwidthThreshold = _tcstoul(arg + 13, NULL, 10);
+        }
+        else if (_tcsnicmp(arg, _T("/rendercache:"), 13) == 0)
+        {
+            gRenderCacheKB = _tcstoul(arg + 13, NULL, 10);
+        }
+        else if (_tcsnicmp(arg, _T("/bench:"), 7) == 0)
+        {
+            _tcscpy_s(gBenchFile, MAX_PATH, arg + 7);
+        }
+        else if (_tcsnicmp(arg, _T("/render:"), 8) == 0)
+        {
+            _tcscpy_s(gRenderFile, MAX_PATH, arg + 8);
+        }
+        else if (_tcsnicmp(arg, _T("/renderto:"), 10) == 0)
+        {
+            _tcscpy_s(gRenderToFile, MAX_PATH, arg + 10);
+        }
+        else if (_tcsnicmp(arg, _T("/sections:"), 10) == 0)
+        {
+            if (_stscanf_s(arg + 10, _T("%u,%u"),
+                           &gFirstSection, &gNumSections) < 1)
+            {
+                OOPS();
+            }
+        }
+        else if (_tcsnicmp(arg, _T("/usbids:"), 8) == 0)
+        {
+            _tcscpy_s(gUsbIdsFile, MAX_PATH, arg + 8);
+        }
+        else if (_tcsnicmp(arg, _T("/usbidx:"), 8) == 0)
+        {
+            _tcscpy_s(gUsbIdxFile, MAX_PATH, arg + 8);
+        }
+        else if (_tcsnicmp(arg, _T("/json:"), 6) == 0)
+        {
+            _tcscpy_s(gJsonFile, MAX_PATH, arg + 6);
+        }
+        else if (_tcsnicmp(arg, _T("/binary:"), 8) == 0)
+        {
+            _tcscpy_s(gBinaryFile, MAX_PATH, arg + 8);
+        }
     }
 
-    GetWindowRect(ghMainWnd, &rc);
+    // The ID database is loaded before any thread could look up a name
+    //
+    if (gUsbIdsFile[0] == 0 && gUsbIdxFile[0] == 0)
+    {
+        PTSTR fileName;
 
-    gBarLocation = 5 * (rc.right - rc.left) / 8;
+        len = GetModuleFileName(NULL, gUsbIdsFile, MAX_PATH);
+        fileName = _tcsrchr(gUsbIdsFile, _T('\\'));
 
-    ResizeWindows(FALSE, 0);
+        if (len != 0 && len < MAX_PATH && fileName != NULL &&
+            (ULONG)(fileName - gUsbIdsFile) + 9 < MAX_PATH)
+        {
+            _tcscpy_s(fileName + 1, MAX_PATH - (fileName + 1 - gUsbIdsFile),
+                      _T("usb.ids"));
+        }
+        else
+        {
+            gUsbIdsFile[0] = 0;
+        }
+    }
 
-    ShowWindow(ghMainWnd, nCmdShow);
+    if ((gUsbIdsFile[0] != 0 || gUsbIdxFile[0] != 0) &&
+        !LoadUsbIds(gUsbIdsFile[0] != 0 ? gUsbIdsFile : NULL,
+                    gUsbIdxFile[0] != 0 ? gUsbIdxFile : NULL))
+    {
+        // Not an error, the built-in vendor names are used
+        //
+        gUsbIdsFile[0] = 0;
+    }
 
-    UpdateWindow(ghMainWnd);
+    if (simControllers != 0 &&
+        !StartSimulation(simControllers, simDepth, simLatency))
+    {
+        OOPS();
+    }
 
-    return TRUE;
-}
+    // Start replay first so that a replayed session can itself be recorded
+    //
+    if (gReplayFile[0] != 0 && !StartTraceReplay(gReplayFile, gReplayLatency))
+    {
+        OOPS();
+    }
 
+    if (gRecordFile[0] != 0 && !StartTraceRecording(gRecordFile))
+    {
+        OOPS();
+    }
+}
 
 //*****************************************************************************
 //
-// ResizeWindows()
+// ParseLanguages()
 //
-// Handles resizing the two child windows of the main window.  If
-// bSizeBar is true, then the sizing is happening because the user is
-// moving the bar.  If bSizeBar is false, the sizing is happening
-// because of the WM_SIZE or something like that.
+// Languages - Value of the /languages: option, "all", "first" or a comma
+// separated list of hex Language IDs such as "0409,0407".
 //
 //*****************************************************************************
 
 VOID
-ResizeWindows (
-    BOOL    bSizeBar,
-    int     BarLocation
+ParseLanguages (
+    PCTSTR  Languages
 )
 {
-    RECT    MainClientRect;
-    RECT    MainWindowRect;
-    RECT    TreeWindowRect;
-    RECT    StatusWindowRect;
-    int     right;
+    PTSTR   end;
+    ULONG   languageID;
 
-    // Is the user moving the bar?
-    //
-    if (!bSizeBar)
+    if (_tcsicmp(Languages, _T("all")) == 0)
     {
-        BarLocation = gBarLocation;
+        gStringLanguages = StringLanguagesAll;
+        return;
     }
 
-    GetClientRect(ghMainWnd, &MainClientRect);
+    if (_tcsicmp(Languages, _T("first")) == 0)
+    {
+        gStringLanguages = StringLanguagesFirst;
+        return;
+    }
+
+    gNumPreferredLanguageIDs = 0;
+
+    while (*Languages != 0 &&
+           gNumPreferredLanguageIDs < MAX_PREFERRED_LANGUAGES)
+    {
+        languageID = _tcstoul(Languages, &end, 16);
+
+        if (end == Languages || languageID == 0 || languageID > 0xFFFF)
+        {
+            OOPS();
+            break;
+        }
+
+        gPreferredLanguageIDs[gNumPreferredLanguageIDs++] = (USHORT)languageID;
+
+        Languages = (*end == _T(',')) ? end + 1 : end;
+    }
+
+    gStringLanguages = gNumPreferredLanguageIDs ? StringLanguagesPreferred :
+                                                  StringLanguagesAll;
+}
+
+//*****************************************************************************
+//
+// CreateMainWindow()
+//
+//*****************************************************************************
+
+BOOL
+CreateMainWindow (
+    int nCmdShow
+)
+{
+    RECT rc;
+
+    InitCommonControls();
+
+    ghMainWnd = CreateDialog(ghInstance,
+                             MAKEINTRESOURCE(IDD_MAINDIALOG),
+                             NULL,
+                             MainDlgProc);
+
+    if (ghMainWnd == NULL)
+    {
+        OOPS();
+        return FALSE;
+    }
+
+    GetWindowRect(ghMainWnd, &rc);
+
+    gBarLocation = 5 * (rc.right - rc.left) / 8;
+
+    ResizeWindows(FALSE, 0);
+
+    ShowWindow(ghMainWnd, nCmdShow);
+
+    UpdateWindow(ghMainWnd);
+
+    return TRUE;
+}
+
+
+//*****************************************************************************
+//
+// ResizeWindows()
+//
+// Handles resizing the two child windows of the main window.  If
+// bSizeBar is true, then the sizing is happening because the user is
+// moving the bar.  If bSizeBar is false, the sizing is happening
+// because of the WM_SIZE or something like that.
+//
+//*****************************************************************************
+
+VOID
+ResizeWindows (
+    BOOL    bSizeBar,
+    int     BarLocation
+)
+{
+    RECT    MainClientRect;
+    RECT    MainWindowRect;
+    RECT    TreeWindowRect;
+    RECT    StatusWindowRect;
+    int     right;
+
+    // Is the user moving the bar?
+    //
+    if (!bSizeBar)
+    {
+        BarLocation = gBarLocation;
+    }
+
+    GetClientRect(ghMainWnd, &MainClientRect);
 
     GetWindowRect(ghStatusWnd, &StatusWindowRect);
 
@@ -426,6 +1040,15 @@ MainDlgProc (
         HANDLE_MSG(hWnd, WM_SIZE,           USBView_OnSize);
         HANDLE_MSG(hWnd, WM_NOTIFY,         USBView_OnNotify);
         HANDLE_MSG(hWnd, WM_DEVICECHANGE,   USBView_OnDeviceChange);
+        HANDLE_MSG(hWnd, WM_TIMER,          USBView_OnTimer);
+
+        case WM_USBVIEW_SNAPSHOT:
+            USBView_OnSnapshot(hWnd, (ULONG)wParam, (PUSB_SNAPSHOT)lParam);
+            break;
+
+        case WM_USBVIEW_DESCRIPTORS:
+            USBView_OnDescriptors(hWnd, (PLAZY_DESC_REQUEST)lParam);
+            break;
     }
 
     return 0;
@@ -523,6 +1146,13 @@ USBView_OnInitDialog (
                 (WPARAM) hFont,
                 0);
 
+    // Enumerate in the background so the window stays responsive, or on
+    // this thread if that is not possible
+    //
+    gEnumThread = StartEnumerationThread(hWnd,
+                                         WM_USBVIEW_SNAPSHOT,
+                                         WM_USBVIEW_DESCRIPTORS);
+
     RefreshTree();
 
     return FALSE;
@@ -539,6 +1169,8 @@ USBView_OnClose (
     HWND hWnd
 )
 {
+    StopRefreshing(hWnd);
+
     DestroyTree();
 
     PostQuitMessage(0);
@@ -599,6 +1231,7 @@ USBView_OnCommand (
         case ID_EXIT:
             UnregisterDeviceNotification(gNotifyDevHandle);
             UnregisterDeviceNotification(gNotifyHubHandle);
+            StopRefreshing(hWnd);
             DestroyTree();
             PostQuitMessage(0);
             EndDialog(hWnd, 0);
@@ -735,7 +1368,10 @@ USBView_OnDeviceChange (
         switch (uEvent)
         {
             case DBT_DEVNODES_CHANGED:
-                RefreshTree();
+                // One device change comes as a burst of these, refresh
+                // once it is over
+                //
+                ScheduleRefresh(hwnd, RequestRefresh(&gRefreshScheduler));
                 break;
         }
     }
@@ -743,6 +1379,228 @@ USBView_OnDeviceChange (
     return TRUE;
 }
 
+//*****************************************************************************
+//
+// USBView_OnTimer()
+//
+//*****************************************************************************
+
+VOID
+USBView_OnTimer (
+    HWND hWnd,
+    UINT id
+)
+{
+    ULONG delay;
+    ULONG request;
+
+    if (id != REFRESH_TIMER)
+    {
+        return;
+    }
+
+    delay = GetRefreshDelay(&gRefreshScheduler);
+
+    if (delay == 0)
+    {
+        // It ends once the snapshot of its request has been taken in.
+        // Without the enumeration thread that was done already.
+        //
+        request = RefreshTree();
+
+        BeginScheduledRefresh(&gRefreshScheduler, request);
+
+        if (!gEnumThread)
+        {
+            EndScheduledRefresh(&gRefreshScheduler, request);
+        }
+
+        delay = GetRefreshDelay(&gRefreshScheduler);
+    }
+
+    ScheduleRefresh(hWnd, delay);
+}
+
+//*****************************************************************************
+//
+// USBView_OnSnapshot()
+//
+// Request - Last request the snapshot answers, see RequestEnumeration().
+//
+// Snapshot - Posted by the enumeration thread, now owned by this thread,
+// or NULL if the enumeration could not be done.
+//
+//*****************************************************************************
+
+VOID
+USBView_OnSnapshot (
+    HWND          hWnd,
+    ULONG         Request,
+    PUSB_SNAPSHOT Snapshot
+)
+{
+    if (Snapshot != NULL)
+    {
+        TakeSnapshot(Snapshot);
+    }
+
+    // A snapshot of a manual refresh which was already running does not
+    // end a scheduled one requested since
+    //
+    if (gRefreshScheduler.Running)
+    {
+        ScheduleRefresh(hWnd, EndScheduledRefresh(&gRefreshScheduler, Request));
+    }
+}
+
+//*****************************************************************************
+//
+// USBView_OnDescriptors()
+//
+// Request - Lazy descriptors posted by the enumeration thread, now owned by
+// this thread.  The info which asked for them may have been replaced by a
+// refresh since, in which case they are dropped.
+//
+//*****************************************************************************
+
+VOID
+USBView_OnDescriptors (
+    HWND                hWnd,
+    PLAZY_DESC_REQUEST  Request
+)
+{
+    PUSBTREENODE node;
+
+    node = FindInfoTreeNode(&gTreeModel, Request->Info);
+
+    if (node != NULL && TakeLazyDescriptors(node->Info, Request))
+    {
+        // What was shown for it had the connection information only
+        //
+        InvalidateRenderCache(node->Item);
+
+        if (TreeView_GetSelection(ghTreeWnd) == (HTREEITEM)node->Item)
+        {
+            UpdateEditControl(ghEditWnd,
+                              ghTreeWnd,
+                              (HTREEITEM)node->Item);
+        }
+    }
+
+    FreeLazyDescriptors(Request);
+}
+
+//*****************************************************************************
+//
+// FindInfoTreeNode()
+//
+// Returns the node under Node, or Node itself, which has Info, or NULL.
+//
+//*****************************************************************************
+
+PUSBTREENODE
+FindInfoTreeNode (
+    PUSBTREENODE    Node,
+    PVOID           Info
+)
+{
+    PUSBTREENODE child;
+    PUSBTREENODE found;
+
+    if (Node->Info == Info)
+    {
+        return Node;
+    }
+
+    for (child = Node->FirstChild; child != NULL; child = child->NextSibling)
+    {
+        found = FindInfoTreeNode(child, Info);
+
+        if (found != NULL)
+        {
+            return found;
+        }
+    }
+
+    return NULL;
+}
+
+//*****************************************************************************
+//
+// StopRefreshing()
+//
+// Stops the enumeration thread before the window goes away, and frees the
+// snapshots and lazy descriptors it posted which were not taken in.  If it
+// does not stop, it is abandoned, see WinMain().
+//
+//*****************************************************************************
+
+VOID
+StopRefreshing (
+    HWND hWnd
+)
+{
+    MSG msg;
+
+    KillTimer(hWnd, REFRESH_TIMER);
+
+    if (gEnumThread)
+    {
+        if (!StopEnumerationThread())
+        {
+            gEnumAbandoned = TRUE;
+        }
+
+        gEnumThread = FALSE;
+    }
+
+    while (PeekMessage(&msg,
+                       hWnd,
+                       WM_USBVIEW_SNAPSHOT,
+                       WM_USBVIEW_SNAPSHOT,
+                       PM_REMOVE))
+    {
+        if (msg.lParam != 0)
+        {
+            FreeSnapshot((PUSB_SNAPSHOT)msg.lParam);
+        }
+    }
+
+    while (PeekMessage(&msg,
+                       hWnd,
+                       WM_USBVIEW_DESCRIPTORS,
+                       WM_USBVIEW_DESCRIPTORS,
+                       PM_REMOVE))
+    {
+        FreeLazyDescriptors((PLAZY_DESC_REQUEST)msg.lParam);
+    }
+}
+
+//*****************************************************************************
+//
+// ScheduleRefresh()
+//
+// Delay - What the refresh scheduler says, ms until the refresh is due or
+// INFINITE if there is none to wait for.
+//
+//*****************************************************************************
+
+VOID
+ScheduleRefresh (
+    HWND  hWnd,
+    ULONG Delay
+)
+{
+    if (Delay == INFINITE)
+    {
+        KillTimer(hWnd, REFRESH_TIMER);
+    }
+    else
+    {
+        SetTimer(hWnd, REFRESH_TIMER, Delay, NULL);
+    }
+}
+
 
 
 //*****************************************************************************
@@ -769,12 +1627,20 @@ VOID DestroyTree (VOID)
 
         ghTreeRoot = NULL;
     }
+
+    FreeTreeNodes(&gTreeModel, FALSE);
 }
 
 //*****************************************************************************
 //
 // RefreshTree()
 //
+// Starts an enumeration, whose snapshot is taken in by TakeSnapshot() once
+// it is done.  Without the enumeration thread this is all done right here.
+//
+// Returns the number of the request, see RequestEnumeration(), 0 without
+// the enumeration thread.
+//
 //*****************************************************************************
 
 // : RefreshTree
@@ -782,58 +1648,230 @@ VOID DestroyTree (VOID)
 // :
 // :
 // ֵ  :
-VOID RefreshTree (VOID)
+ULONG RefreshTree (VOID)
 {
-    TCHAR  statusText[128];
-    ULONG devicesConnected;
+    PUSB_SNAPSHOT snapshot;
+    ENUM_CONTEXT  context;
 
-    // Clear the selection of the TreeView, so that when the tree is
-    // destroyed, the control won't try to constantly "shift" the
-    // selection to another item.
+    if (gEnumThread)
+    {
+        return RequestEnumeration();
+    }
+
+    snapshot = (PUSB_SNAPSHOT)ALLOC(sizeof(USB_SNAPSHOT));
+
+    if (snapshot == NULL)
+    {
+        OOPS();
+        return 0;
+    }
+
+    InitEnumContext(&context, snapshot);
+
+    EnumerateHostControllers(&context);
+
+    TakeSnapshot(snapshot);
+
+    return 0;
+}
+
+//*****************************************************************************
+//
+// TakeSnapshot()
+//
+// Snapshot - What an enumeration found.  Its tree is diffed into the one
+// shown, then it is freed.
+//
+//*****************************************************************************
+
+VOID
+TakeSnapshot (
+    PUSB_SNAPSHOT Snapshot
+)
+{
+    TCHAR  statusText[256];
+    TREE_DIFF_CALLBACKS callbacks;
+    TREE_DIFF_STATS stats;
+    HTREEITEM hSelection;
+
+    // Create the root tree node the first time, the tree is only patched
+    // from then on
     //
-    TreeView_SelectItem(ghTreeWnd, NULL);
+    if (ghTreeRoot == NULL)
+    {
+        ghTreeRoot = AddLeaf(TVI_ROOT, 0, _T("My Computer"), ComputerIcon);
+
+        if (ghTreeRoot == NULL)
+        {
+            OOPS();
+            FreeSnapshot(Snapshot);
+            return;
+        }
+
+        memset(&gTreeModel, 0, sizeof(gTreeModel));
 
-    // Clear the edit control
+        gTreeModel.Item = ghTreeRoot;
+    }
+
+    DropUnnamedTreeNodes(&Snapshot->Root);
+
+    // Apply only what changed since the last refresh, so items which are
+    // still there keep their expanded and selected state
     //
-    SetWindowText(ghEditWnd, _T(""));
+    callbacks.Context = NULL;
+    callbacks.InsertNode = InsertTreeItem;
+    callbacks.RemoveNode = RemoveTreeItem;
+    callbacks.UpdateNode = UpdateTreeItem;
 
-    // Destroy the current contents of the TreeView
+    memset(&stats, 0, sizeof(stats));
+
+    DiffTreeNodes(&gTreeModel, &Snapshot->Root, &callbacks, &stats);
+
+    TreeView_Expand(ghTreeWnd, ghTreeRoot, TVE_EXPAND);
+
+    // The info of the selected item was replaced, show the new one
     //
-    if (ghTreeRoot)
+    hSelection = TreeView_GetSelection(ghTreeWnd);
+
+    if (hSelection)
     {
-        WalkTree(ghTreeRoot, CleanupItem, 0);
+        UpdateEditControl(ghEditWnd,
+                          ghTreeWnd,
+                          hSelection);
+    }
+    else
+    {
+        SetWindowText(ghEditWnd, _T(""));
+    }
 
-        TreeView_DeleteAllItems(ghTreeWnd);
+    // Update Status Line with number of devices connected
+    //
+    _stprintf_s(statusText, sizeof(statusText)/sizeof(statusText[0]), _T("Devices Connected: %d   Hubs Connected: %d   Over Bandwidth: %d   Downgraded: %d   Cached: %d hits, %d misses   Changes: +%u -%u ~%u   Notifications: %u, %u folded"),
+             Snapshot->DevicesConnected, Snapshot->Hubs, Snapshot->BandwidthWarnings,
+             Snapshot->SpeedDowngrades,
+             Snapshot->Counters.CacheHits, Snapshot->Counters.CacheMisses,
+             stats.Inserted, stats.Removed, stats.Changed,
+             gRefreshScheduler.Notifications, gRefreshScheduler.Folded);
+    SetWindowText(ghStatusWnd, statusText);
+
+    // Its tree has been taken over by the diff
+    //
+    FREE(Snapshot);
+}
 
-        ghTreeRoot = NULL;
+//*****************************************************************************
+//
+// InsertTreeItem()
+//
+// LPFNINSERTNODE for TakeSnapshot(), adds Node and its children to the
+// TreeView, which takes ownership of their Info.
+//
+//*****************************************************************************
+
+BOOL
+InsertTreeItem (
+    PVOID           Context,
+    PUSBTREENODE    Parent,
+    PUSBTREENODE    After,
+    PUSBTREENODE    Node
+)
+{
+    HTREEITEM hItem;
+
+    hItem = InsertLeaf((HTREEITEM)Parent->Item,
+                       After ? (HTREEITEM)After->Item : TVI_FIRST,
+                       (LPARAM)Node->Info,
+                       Node->Text,
+                       Node->Icon);
+
+    if (hItem == NULL)
+    {
+        return FALSE;
     }
 
-    // Create the root tree node
+    Node->Item = hItem;
+
+    PopulateTree(hItem, Node);
+
+    return TRUE;
+}
+
+//*****************************************************************************
+//
+// RemoveTreeItem()
+//
+// LPFNREMOVENODE for TakeSnapshot(), deletes the item of Node and its
+// children, and frees their Info.
+//
+//*****************************************************************************
+
+VOID
+RemoveTreeItem (
+    PVOID           Context,
+    PUSBTREENODE    Node
+)
+{
+    HTREEITEM hItem;
+    HTREEITEM hChild;
+
+    hItem = (HTREEITEM)Node->Item;
+
+    // Not WalkTree(hItem), which would go on to the siblings of hItem
     //
-    ghTreeRoot = AddLeaf(TVI_ROOT, 0, _T("My Computer"), ComputerIcon);
+    hChild = TreeView_GetChild(ghTreeWnd, hItem);
 
-    if (ghTreeRoot != NULL)
+    if (hChild)
     {
-        // Enumerate all USB buses and populate the tree
-        //
-        EnumerateHostControllers(ghTreeRoot, &devicesConnected);
+        WalkTree(hChild, CleanupItem, 0);
+    }
 
-        //
-        // Expand all tree nodes
-        //
-        WalkTree(ghTreeRoot, ExpandItem, 0);
+    CleanupItem(ghTreeWnd, hItem);
 
-        // Update Status Line with number of devices connected
-        //
-        _stprintf_s(statusText, sizeof(statusText)/sizeof(statusText[0]), _T("Devices Connected: %d   Hubs Connected: %d"),
-                 devicesConnected, TotalHubs);
-        SetWindowText(ghStatusWnd, statusText);
+    TreeView_DeleteItem(ghTreeWnd, hItem);
+}
+
+//*****************************************************************************
+//
+// UpdateTreeItem()
+//
+// LPFNUPDATENODE for TakeSnapshot(), points the item of Node at the Info of
+// NewNode and frees the Info it had.  The text rendered for the item is
+// only dropped if the new Info would render differently.
+//
+//*****************************************************************************
+
+VOID
+UpdateTreeItem (
+    PVOID           Context,
+    PUSBTREENODE    Node,
+    PUSBTREENODE    NewNode,
+    BOOL            Changed
+)
+{
+    TV_ITEM tvi;
+
+    memset(&tvi, 0, sizeof(tvi));
+
+    tvi.mask = TVIF_HANDLE | TVIF_PARAM;
+    tvi.hItem = (HTREEITEM)Node->Item;
+    tvi.lParam = (LPARAM)NewNode->Info;
+
+    if (Changed)
+    {
+        tvi.mask |= TVIF_TEXT | TVIF_IMAGE | TVIF_SELECTEDIMAGE;
+        tvi.pszText = NewNode->Text;
+        tvi.iImage = GetTreeIconImage(NewNode->Icon);
+        tvi.iSelectedImage = tvi.iImage;
     }
-    else
+
+    TreeView_SetItem(ghTreeWnd, &tvi);
+
+    if (RenderCacheInfoChanged(Node->Info, NewNode->Info))
     {
-        OOPS();
+        InvalidateRenderCache(Node->Item);
     }
 
+    FreeDeviceInfo(Node->Info);
 }
 
 //*****************************************************************************
@@ -882,6 +1920,31 @@ AddLeaf (
     __in LPTSTR    lpszText,
     TREEICON  TreeIcon
 )
+{
+    return InsertLeaf(hTreeParent,
+                      TVI_LAST,
+                      lParam,
+                      lpszText,
+                      TreeIcon);
+}
+
+//*****************************************************************************
+//
+// InsertLeaf()
+//
+// Like AddLeaf(), but the item goes right after hInsertAfter, or TVI_FIRST
+// or TVI_LAST.
+//
+//*****************************************************************************
+
+HTREEITEM
+InsertLeaf (
+    HTREEITEM       hTreeParent,
+    HTREEITEM       hInsertAfter,
+    LPARAM          lParam,
+    __in LPTSTR     lpszText,
+    TREEICON        TreeIcon
+)
 {
     TV_INSERTSTRUCT tvins;
     HTREEITEM       hti;
@@ -892,7 +1955,7 @@ AddLeaf (
     //
     tvins.hParent = hTreeParent;
 
-    tvins.hInsertAfter = TVI_LAST;
+    tvins.hInsertAfter = hInsertAfter;
 
     // pszText and lParam members are valid
     //
@@ -915,38 +1978,95 @@ AddLeaf (
 
     // Determine which icon to display for the device
     //
+    tvins.item.iImage = GetTreeIconImage(TreeIcon);
+    tvins.item.iSelectedImage = tvins.item.iImage;
+
+    TreeView_SetItem(ghTreeWnd, &tvins.item);
+
+    return hti;
+}
+
+//*****************************************************************************
+//
+// GetTreeIconImage()
+//
+//*****************************************************************************
+
+int
+GetTreeIconImage (
+    TREEICON        TreeIcon
+)
+{
     switch (TreeIcon)
     {
         case ComputerIcon:
-            tvins.item.iImage = giComputer;
-            tvins.item.iSelectedImage = giComputer;
-            break;
+            return giComputer;
 
         case HubIcon:
-            tvins.item.iImage = giHub;
-            tvins.item.iSelectedImage = giHub;
-            break;
+            return giHub;
 
         case NoDeviceIcon:
-            tvins.item.iImage = giNoDevice;
-            tvins.item.iSelectedImage = giNoDevice;
-            break;
+            return giNoDevice;
 
         case GoodDeviceIcon:
-            tvins.item.iImage = giGoodDevice;
-            tvins.item.iSelectedImage = giGoodDevice;
-            break;
+            return giGoodDevice;
 
         case BadDeviceIcon:
         default:
-            tvins.item.iImage = giBadDevice;
-            tvins.item.iSelectedImage = giBadDevice;
-            break;
+            return giBadDevice;
     }
+}
 
-    TreeView_SetItem(ghTreeWnd, &tvins.item);
+//*****************************************************************************
+//
+// PopulateTree()
+//
+// Adds the children of Node, and their children, under hTreeParent and
+// expands them.  The TreeView takes ownership of each node's Info.
+//
+//*****************************************************************************
 
-    return hti;
+VOID
+PopulateTree (
+    HTREEITEM       hTreeParent,
+    PUSBTREENODE    Node
+)
+{
+    PUSBTREENODE    child;
+    PUSBTREENODE    *link;
+    HTREEITEM       hItem;
+
+    link = &Node->FirstChild;
+
+    Node->LastChild = NULL;
+
+    while ((child = *link) != NULL)
+    {
+        hItem = AddLeaf(hTreeParent,
+                        (LPARAM)child->Info,
+                        child->Text,
+                        child->Icon);
+
+        if (hItem == NULL)
+        {
+            // Leave it out of the tree
+            //
+            OOPS();
+            *link = child->NextSibling;
+            FreeTreeNode(child, TRUE);
+            continue;
+        }
+
+        child->Item = hItem;
+
+        PopulateTree(hItem, child);
+
+        Node->LastChild = child;
+
+        link = &child->NextSibling;
+    }
+
+    TreeView_Expand(ghTreeWnd, hTreeParent, TVE_EXPAND);
 }
 
 //*****************************************************************************
@@ -27,6 +27,7 @@ Revision History:
 #include <commctrl.h>
 #include <usbioctl.h>
 #include <usbiodef.h>
+#include <cfgmgr32.h>
 
 #include "usbdesc.h"
 #include "usb100.h"
@@ -166,18 +167,244 @@ typedef VOID
     HTREEITEM   hTreeItem
 );
 
+// Callback function for walking the device interfaces of a class.  Return
+// FALSE to stop the walk.
 //
-// Structure used to build a linked list of String Descriptors
-// retrieved from a device.
+typedef BOOL
+(*LPFNINTERFACECALLBACK)(
+    PVOID       Context,
+    PCTSTR      DevicePath
+);
+
+//
+// Table of routines through which all access to the USB stack and the
+// configuration manager is made.  See DEVACCESS.C.
+//
+
+typedef struct _DEVICE_ACCESS_BACKEND
+{
+    PCTSTR      Name;
+
+    HANDLE      (*OpenDevice)(PCTSTR DevicePath, DWORD FlagsAndAttributes);
+
+    BOOL        (*CloseDevice)(HANDLE hDevice);
+
+    BOOL        (*IoControl)(HANDLE hDevice, DWORD IoControlCode,
+                             PVOID InBuffer, DWORD InBufferSize,
+                             PVOID OutBuffer, DWORD OutBufferSize,
+                             PDWORD BytesReturned, LPOVERLAPPED Overlapped);
+
+    BOOL        (*OverlappedResult)(HANDLE hDevice, LPOVERLAPPED Overlapped,
+                                    PDWORD BytesReturned, BOOL Wait);
+
+    BOOL        (*EnumInterfaces)(LPGUID InterfaceGuid,
+                                  LPFNINTERFACECALLBACK Callback,
+                                  PVOID Context);
+
+    CONFIGRET   (*LocateDevNode)(PDEVINST DevInst);
+
+    CONFIGRET   (*GetChild)(PDEVINST DevInstChild, DEVINST DevInst);
+
+    CONFIGRET   (*GetSibling)(PDEVINST DevInstSibling, DEVINST DevInst);
+
+    CONFIGRET   (*GetParent)(PDEVINST DevInstParent, DEVINST DevInst);
+
+    CONFIGRET   (*GetDevNodeProperty)(DEVINST DevInst, ULONG Property,
+                                      PVOID Buffer, PULONG Length);
+
+    CONFIGRET   (*GetDeviceId)(DEVINST DevInst, PTSTR Buffer, ULONG Length);
+
+} DEVICE_ACCESS_BACKEND, *PDEVICE_ACCESS_BACKEND;
+
+//
+// String Descriptors retrieved from a device, all in one allocation, see
+// STRDESC.C.  Each record holds one String Descriptor in one language.
+// The records of a descriptor index follow each other, and First gives
+// where the run of each index starts, so finding a string never walks
+// more than the languages of its index.  String Descriptor 0, the
+// supported languages, comes first.  The table also counts the control
+// transfers sent to fill it, and the ones saved by fetching each index
+// once and by the language policy.
 //
 
-typedef struct _STRING_DESCRIPTOR_NODE
+typedef struct _STRING_DESCRIPTOR_RECORD
 {
-    struct _STRING_DESCRIPTOR_NODE *Next;
     UCHAR                           DescriptorIndex;
+    UCHAR                           Reserved;
     USHORT                          LanguageID;
-    USB_STRING_DESCRIPTOR           StringDescriptor[0];
-} STRING_DESCRIPTOR_NODE, *PSTRING_DESCRIPTOR_NODE;
+    USB_STRING_DESCRIPTOR           StringDescriptor[0];    // bLength bytes
+} STRING_DESCRIPTOR_RECORD, *PSTRING_DESCRIPTOR_RECORD;
+
+typedef struct _STRING_DESCRIPTORS
+{
+    ULONG                           Size;           // bytes allocated
+    ULONG                           Length;         // bytes used
+    USHORT                          RequestsSent;
+    USHORT                          RequestsSaved;
+    USHORT                          Last;           // in WORDs, 0 if none
+    USHORT                          First[256];     // in WORDs, 0 if none
+} STRING_DESCRIPTORS, *PSTRING_DESCRIPTORS;
+
+#define FIRST_STRING_RECORD(StringDescs) \
+    ((PSTRING_DESCRIPTOR_RECORD)((StringDescs) + 1))
+
+#define NEXT_STRING_RECORD(Record) \
+    ((PSTRING_DESCRIPTOR_RECORD)((PUCHAR)(Record)->StringDescriptor + \
+                                 (Record)->StringDescriptor->bLength))
+
+//
+// Index of a Configuration Descriptor and all descriptors following it,
+// parsed once when it is fetched and kept in the same allocation, see
+// CFGINDEX.C.  There is one entry for each descriptor, in order, which
+// tells what it was checked to be and where it is.
+//
+
+typedef enum _CONFIG_DESC_KIND
+{
+    ConfigDescConfiguration,
+    ConfigDescInterface,
+    ConfigDescEndpoint,
+    ConfigDescHid,
+    ConfigDescOther,            // class specific or unknown
+    ConfigDescInvalid           // a standard descriptor of the wrong length
+} CONFIG_DESC_KIND;
+
+#define NO_CONFIG_ENTRY     0xFFFF
+
+typedef struct _CONFIG_DESC_ENTRY
+{
+    USHORT                          Offset;         // from the Configuration Descriptor
+    UCHAR                           Kind;           // CONFIG_DESC_KIND
+    UCHAR                           Reserved;
+    USHORT                          InterfaceEntry; // NO_CONFIG_ENTRY if none
+} CONFIG_DESC_ENTRY, *PCONFIG_DESC_ENTRY;
+
+typedef struct _CONFIG_DESC_INDEX
+{
+    ULONG                           Size;           // bytes, entries included
+    USHORT                          NumEntries;
+    USHORT                          NumInterfaces;  // alternate settings included
+    USHORT                          NumEndpoints;
+    BOOLEAN                         HasStrings;     // iConfiguration or iInterface
+    UCHAR                           Reserved;
+    CONFIG_DESC_ENTRY               Entries[0];
+} CONFIG_DESC_INDEX, *PCONFIG_DESC_INDEX;
+
+#define CONFIG_ENTRY_DESC(ConfigDesc, Entry) \
+    ((PUSB_COMMON_DESCRIPTOR)((PUCHAR)((ConfigDesc) + 1) + (Entry)->Offset))
+
+//
+// Decoders of class specific descriptors, see CLASSDEC.C.  Each display
+// module has a table of them, ended by one without Display.  A decoder
+// returns FALSE if the descriptor is not what it should be, and it is
+// dumped instead.
+//
+
+#define CLASS_DESC_ANY      0x100   // matches any subclass or subtype
+
+typedef BOOL
+(*LPFNDISPLAYCLASSDESC) (
+    PUSB_COMMON_DESCRIPTOR  CommonDesc
+);
+
+typedef struct _CLASS_DESC_DECODER
+{
+    UCHAR                   InterfaceClass;
+    USHORT                  InterfaceSubClass;  // or CLASS_DESC_ANY
+    UCHAR                   DescriptorType;
+    USHORT                  DescriptorSubtype;  // or CLASS_DESC_ANY
+    LPFNDISPLAYCLASSDESC    Display;
+} CLASS_DESC_DECODER, *PCLASS_DESC_DECODER;
+
+//
+// Languages String Descriptors are requested in
+//
+
+typedef enum _STRING_LANGUAGES
+{
+    StringLanguagesAll,         // every language the device supports
+    StringLanguagesPreferred,   // those in PreferredLanguageIDs, else first
+    StringLanguagesFirst        // only the first language the device lists
+} STRING_LANGUAGES;
+
+#define MAX_PREFERRED_LANGUAGES 8
+
+//
+// State of a lock set up on first use by InitLockOnce()
+//
+
+#define LOCK_UNINITIALIZED  0
+#define LOCK_INITIALIZING   1
+#define LOCK_READY          2
+
+//
+// Periodic bandwidth reserved below a host controller or hub, see
+// BANDWIDTH.C.  The busiest frame and microframe are given in ns and in
+// percent of the time a frame (90%) or microframe (80%) may spend on
+// interrupt and isochronous transfers.
+//
+
+typedef struct _USB_BANDWIDTH
+{
+    ULONG                   PeriodicEndpoints;
+    ULONG                   FrameNs;
+    ULONG                   MicroframeNs;
+    ULONG                   FramePercent;
+    ULONG                   MicroframePercent;
+    BOOL                    OverThreshold;
+} USB_BANDWIDTH, *PUSB_BANDWIDTH;
+
+#define FRAME_NS                1000000
+#define MICROFRAME_NS           125000
+#define FRAME_PERIODIC_NS       (FRAME_NS / 100 * 90)
+#define MICROFRAME_PERIODIC_NS  (MICROFRAME_NS / 100 * 80)
+
+#define DEFAULT_BANDWIDTH_THRESHOLD 90
+
+//
+// Where the USB stack placed the open interrupt and isochronous pipes
+// below a host controller, by their ScheduleOffset, over the longest
+// period scheduled.  Slots used by more than one pipe are collisions,
+// slots using more than the bandwidth threshold are hot.
+//
+
+#define SCHEDULE_FRAMES         32
+#define SCHEDULE_MICROFRAMES    (SCHEDULE_FRAMES * 8)
+
+typedef struct _USB_SCHEDULE_SLOT
+{
+    USHORT                  Pipes;
+    USHORT                  Reserved;
+    ULONG                   Ns;
+} USB_SCHEDULE_SLOT, *PUSB_SCHEDULE_SLOT;
+
+typedef struct _USB_SCHEDULE_MAP
+{
+    ULONG                   PeriodicPipes;
+    ULONG                   Collisions;
+    ULONG                   HotSlots;
+    USB_SCHEDULE_SLOT       Frames[SCHEDULE_FRAMES];            // full and low speed
+    USB_SCHEDULE_SLOT       Microframes[SCHEDULE_MICROFRAMES];  // high speed
+} USB_SCHEDULE_MAP, *PUSB_SCHEDULE_MAP;
+
+//
+// Whether a device runs slower than it could, see SPEED.C
+//
+
+typedef enum _SPEED_DOWNGRADE
+{
+    SpeedNotDowngraded,         // as fast as it can, or not known to be slower
+    SpeedDowngradedByHub,       // a full speed hub or host controller is upstream
+    SpeedDowngradedByLink       // all upstream is high speed, the cable or port is suspect
+} SPEED_DOWNGRADE;
+
+// Only these devices can be downgraded, and only they are asked for their
+// Device Qualifier Descriptor
+//
+#define MAY_BE_DOWNGRADED(ConnectionInfo)                       \
+    ((ConnectionInfo)->ConnectionStatus == DeviceConnected &&   \
+     (ConnectionInfo)->Speed == UsbFullSpeed &&                 \
+     (ConnectionInfo)->DeviceDescriptor.bcdUSB >= 0x0200)
 
 
 //
@@ -203,8 +430,6 @@ typedef struct _USBHOSTCONTROLLERINFO
 {
     USBDEVICEINFOTYPE                   DeviceInfoType;
 
-    LIST_ENTRY                          ListEntry;
-
     PTSTR                               DriverKey;
 
     ULONG                               VendorID;
@@ -215,6 +440,10 @@ typedef struct _USBHOSTCONTROLLERINFO
 
     ULONG                               Revision;
 
+    USB_BANDWIDTH                       Bandwidth;
+
+    USB_SCHEDULE_MAP                    ScheduleMap;
+
 } USBHOSTCONTROLLERINFO, *PUSBHOSTCONTROLLERINFO;
 
 
@@ -230,6 +459,8 @@ typedef struct _USBROOTHUBINFO
 
     PUSB_HUB_CAPABILITIES_EX            HubCapsEx;
 
+    USB_BANDWIDTH                       Bandwidth;
+
 } USBROOTHUBINFO, *PUSBROOTHUBINFO;
 
 
@@ -249,7 +480,19 @@ typedef struct _USBEXTERNALHUBINFO
 
     PUSB_DESCRIPTOR_REQUEST             ConfigDesc;
 
-    PSTRING_DESCRIPTOR_NODE             StringDescs;
+    PSTRING_DESCRIPTORS                 StringDescs;
+
+    PTSTR                               ParentHubName;  // see USBDEVICEINFO
+
+    BOOL                                LazyDescriptors;
+
+    ULONG                               LazyRequest;    // see USBDEVICEINFO
+
+    PUSB_DEVICE_QUALIFIER_DESCRIPTOR    QualifierDesc;  // see USBDEVICEINFO
+
+    SPEED_DOWNGRADE                     SpeedDowngrade;
+
+    USB_BANDWIDTH                       Bandwidth;
 
 } USBEXTERNALHUBINFO, *PUSBEXTERNALHUBINFO;
 
@@ -262,11 +505,324 @@ typedef struct _USBDEVICEINFO
 
     PUSB_DESCRIPTOR_REQUEST             ConfigDesc;
 
-    PSTRING_DESCRIPTOR_NODE             StringDescs;
+    PSTRING_DESCRIPTORS                 StringDescs;
+
+    // Name of the hub the device is connected to, owned by the info of
+    // that hub.  If LazyDescriptors is set, ConfigDesc and StringDescs
+    // have not been fetched yet, see GetLazyDescriptors().  LazyRequest is
+    // set while the enumeration thread fetches them, see
+    // RequestLazyDescriptors().
+    //
+    PTSTR                               ParentHubName;
+
+    BOOL                                LazyDescriptors;
+
+    ULONG                               LazyRequest;
+
+    // Device Qualifier Descriptor, only fetched from full speed devices
+    // which claim USB 2.0, and NULL if they have none.  It is fetched with
+    // the connection information and kept in the descriptor cache.
+    // SpeedDowngrade is set from it by DetectSpeedDowngrades().
+    //
+    PUSB_DEVICE_QUALIFIER_DESCRIPTOR    QualifierDesc;
+
+    SPEED_DOWNGRADE                     SpeedDowngrade;
 
 } USBDEVICEINFO, *PUSBDEVICEINFO;
 
 
+//
+// Node of the device tree built by the enumeration code.  The tree is built
+// away from the TreeView, possibly by several threads, and then added to
+// the TreeView in one pass.  Info becomes the lParam of the TreeView item.
+//
+
+typedef struct _USBTREENODE
+{
+    struct _USBTREENODE    *Parent;
+
+    struct _USBTREENODE    *FirstChild;
+
+    struct _USBTREENODE    *LastChild;
+
+    struct _USBTREENODE    *NextSibling;
+
+    PVOID                   Info;
+
+    PTSTR                   Text;
+
+    TREEICON                Icon;
+
+    // Identity of the node among its siblings, which stays the same from
+    // one refresh to the next
+    //
+    ULONG                   Id;     // port number, 0 if not a port
+
+    PCTSTR                  Key;    // driver key of a host controller
+
+    PVOID                   Item;   // item showing the node, set by the UI
+
+} USBTREENODE, *PUSBTREENODE;
+
+
+// What one enumeration cost.  Each enumeration counts into its own, see
+// SetBackendCounters().
+//
+typedef struct _ENUM_COUNTERS
+{
+    LONG                    IoControls;     // requests sent through the backend
+
+    LONG                    DevNodeCalls;   // config manager calls sent through the backend
+
+    LONG                    CacheHits;      // devices not fetched again
+
+    LONG                    CacheMisses;
+
+} ENUM_COUNTERS, *PENUM_COUNTERS;
+
+
+// Everything one enumeration found.  It is built on the enumeration thread
+// and handed over whole, nothing changes it until it is taken in.
+//
+typedef struct _USB_SNAPSHOT
+{
+    USBTREENODE             Root;   // host controllers are its children
+
+    LONG                    DevicesConnected;
+
+    LONG                    Hubs;
+
+    LONG                    BandwidthWarnings;  // host controllers over the threshold
+
+    LONG                    SpeedDowngrades;    // devices running slower than they can
+
+    ENUM_COUNTERS           Counters;
+
+} USB_SNAPSHOT, *PUSB_SNAPSHOT;
+
+
+// Lazy descriptors of one device, fetched by the enumeration thread for
+// RequestLazyDescriptors() and posted back to the window.
+//
+typedef struct _LAZY_DESC_REQUEST
+{
+    struct _LAZY_DESC_REQUEST  *Next;       // queued for the thread
+
+    PVOID                       Info;       // only compared, may be freed by now
+
+    ULONG                       Request;    // LazyRequest of Info
+
+    PTSTR                       HubName;    // copied from the info
+
+    ULONG                       ConnectionIndex;
+
+    USB_DEVICE_DESCRIPTOR       DeviceDescriptor;
+
+    PUSB_DESCRIPTOR_REQUEST     ConfigDesc;     // what was fetched
+
+    PSTRING_DESCRIPTORS         StringDescs;
+
+} LAZY_DESC_REQUEST, *PLAZY_DESC_REQUEST;
+
+
+// One lookup of a batch passed to GetDevNodeStrings().  The strings are
+// empty if they could not be read.
+//
+typedef struct _DEVNODE_STRINGS
+{
+    PCTSTR                  DriverKey;
+
+    BOOL                    Found;
+
+    TCHAR                   DeviceDesc[MAX_DEVICE_ID_LEN];
+
+    TCHAR                   DeviceId[MAX_DEVICE_ID_LEN];
+
+} DEVNODE_STRINGS, *PDEVNODE_STRINGS;
+
+
+// Devnodes indexed by driver key, see BuildDevNodeIndex()
+//
+typedef struct _DEVNODE_INDEX *PDEVNODE_INDEX;
+
+
+// Callbacks through which DiffTreeNodes() applies the changes it finds.
+//
+// InsertNode - Node is new, show it and its children under Parent, right
+// after After (or first if After is NULL).  Returns FALSE if it could not.
+//
+// RemoveNode - Node and its children are gone, release them.
+//
+// UpdateNode - Node is still there and NewNode is what it is now.  Changed
+// is TRUE if the text or icon differ.  Node->Info is replaced by
+// NewNode->Info once this returns.
+//
+typedef BOOL
+(*LPFNINSERTNODE)(
+    PVOID           Context,
+    PUSBTREENODE    Parent,
+    PUSBTREENODE    After,
+    PUSBTREENODE    Node
+);
+
+typedef VOID
+(*LPFNREMOVENODE)(
+    PVOID           Context,
+    PUSBTREENODE    Node
+);
+
+typedef VOID
+(*LPFNUPDATENODE)(
+    PVOID           Context,
+    PUSBTREENODE    Node,
+    PUSBTREENODE    NewNode,
+    BOOL            Changed
+);
+
+typedef struct _TREE_DIFF_CALLBACKS
+{
+    PVOID                   Context;
+
+    LPFNINSERTNODE          InsertNode;
+
+    LPFNREMOVENODE          RemoveNode;
+
+    LPFNUPDATENODE          UpdateNode;
+
+} TREE_DIFF_CALLBACKS, *PTREE_DIFF_CALLBACKS;
+
+typedef struct _TREE_DIFF_STATS
+{
+    ULONG                   Inserted;   // subtrees
+    ULONG                   Removed;    // subtrees
+    ULONG                   Changed;    // nodes whose text or icon changed
+    ULONG                   Unchanged;
+
+} TREE_DIFF_STATS, *PTREE_DIFF_STATS;
+
+
+// Clock of the refresh scheduler, in ms
+//
+typedef ULONG
+(*LPFNGETTICKS)(
+    PVOID       Context
+);
+
+typedef struct _REFRESH_SCHEDULER
+{
+    ULONG                   QuietPeriod;    // ms
+    ULONG                   MaxDelay;       // ms
+
+    LPFNGETTICKS            GetTicks;
+    PVOID                   ClockContext;
+
+    BOOL                    Pending;        // a refresh is waiting
+    BOOL                    Running;
+    ULONG                   Request;        // of the running refresh
+    ULONG                   FirstRequest;   // ticks of the first waiting one
+    ULONG                   LastRequest;
+
+    ULONG                   Notifications;
+    ULONG                   Folded;         // notifications which added no refresh
+    ULONG                   Refreshes;
+
+} REFRESH_SCHEDULER, *PREFRESH_SCHEDULER;
+
+
+// Where rendered detail text goes, see TEXTSINK.C.  Write gets Length
+// characters which are not terminated, and returns FALSE if it could not
+// take them, which ends the rendering.
+//
+typedef struct _TEXT_SINK *PTEXT_SINK;
+
+typedef BOOL
+(*LPFNTEXTSINKWRITE)(
+    PTEXT_SINK  Sink,
+    PCTSTR      Text,
+    ULONG       Length
+);
+
+typedef struct _TEXT_SINK
+{
+    LPFNTEXTSINKWRITE       Write;
+
+    PVOID                   Context;    // of a callback sink
+
+    HANDLE                  hFile;      // of a file or stdout sink
+
+    BOOL                    CloseFile;
+
+    PTSTR                   Buffer;     // of a memory sink, terminated
+
+    ULONG                   Length;     // characters in Buffer
+
+    ULONG                   Size;       // characters Buffer has room for
+
+} TEXT_SINK;
+
+
+// Machine readable formats of the device tree, see SERIAL.C
+//
+typedef enum _SERIAL_FORMAT
+{
+    SerialFormatJson,
+    SerialFormatBinary
+} SERIAL_FORMAT;
+
+
+// Work pool item routine
+//
+typedef VOID
+(*LPFNWORKROUTINE)(
+    PVOID       Context
+);
+
+
+// Work items which are waited for together, see WorkPoolBegin()
+//
+typedef struct _WORK_BATCH
+{
+    LONG                    Outstanding;
+
+    HANDLE                  Done;   // NULL if the items run inline
+
+} WORK_BATCH, *PWORK_BATCH;
+
+
+// State of one enumeration.  Nothing a walk changes lives anywhere else,
+// so any number of enumerations may run at the same time.  The options
+// are taken from the gDoXxx and string language globals by
+// InitEnumContext() and may be changed before the enumeration starts.
+//
+typedef struct _ENUM_CONTEXT
+{
+    BOOL                    DoConfigDesc;
+
+    BOOL                    DoLazyDesc;
+
+    BOOL                    DoOverlapped;
+
+    BOOL                    DoDevNodeIndex;
+
+    ULONG                   BandwidthThreshold; // percent, see USB_BANDWIDTH
+
+    STRING_LANGUAGES        StringLanguages;
+
+    USHORT                  PreferredLanguageIDs[MAX_PREFERRED_LANGUAGES];
+
+    ULONG                   NumPreferredLanguageIDs;
+
+    PUSB_SNAPSHOT           Snapshot;       // where the results go
+
+    // Only used by ENUM.C while the enumeration runs
+    //
+    WORK_BATCH              Batch;
+
+    PDEVNODE_INDEX          DevNodeIndex;
+
+} ENUM_CONTEXT, *PENUM_CONTEXT;
+
+
 //*****************************************************************************
 // G L O B A L S
 //*****************************************************************************
@@ -276,7 +832,15 @@ typedef struct _USBDEVICEINFO
 //
 
 BOOL gDoConfigDesc;
-int TotalHubs;
+BOOL gDoLazyDesc;
+BOOL gDoOverlapped;
+BOOL gDoDevNodeIndex;
+
+ULONG gBandwidthThreshold;
+
+STRING_LANGUAGES gStringLanguages;
+USHORT           gPreferredLanguageIDs[MAX_PREFERRED_LANGUAGES];
+ULONG            gNumPreferredLanguageIDs;
 
 //
 // ENUM.C
@@ -284,6 +848,16 @@ int TotalHubs;
 
 PCTSTR ConnectionStatuses[];
 
+//
+// DISPLAY.C, DISPAUD.C, DISPCDC.C, DISPVID.C
+//
+
+extern CLASS_DESC_DECODER StorageClassDecoders[];
+extern CLASS_DESC_DECODER HubClassDecoders[];
+extern CLASS_DESC_DECODER AudioClassDecoders[];
+extern CLASS_DESC_DECODER CdcClassDecoders[];
+extern CLASS_DESC_DECODER VideoClassDecoders[];
+
 
 //*****************************************************************************
 // F U N C T I O N    P R O T O T Y P E S
@@ -334,14 +908,68 @@ AppendTextBuffer (
     ...
 );
 
+VOID
+AppendTextString (
+    LPCTSTR String
+);
+
+VOID
+AppendTextHex (
+    LPCTSTR Label,
+    ULONG   Value,
+    int     Digits
+);
+
+VOID
+AppendTextHexName (
+    LPCTSTR Label,
+    ULONG   Value,
+    int     Digits,
+    PCTSTR  Name
+);
+
+PCTSTR
+RenderDeviceInfo (
+    PVOID   Info
+);
+
+ULONG
+RenderDeviceInfoToSink (
+    PVOID       Info,
+    PTEXT_SINK  Sink,
+    ULONG       FirstSection,
+    ULONG       NumSections
+);
+
+PCTSTR
+GetVendorString (
+    USHORT     idVendor
+);
+
 //
 // ENUM.C
 //
 
+VOID
+InitLockOnce (
+    LPCRITICAL_SECTION  Lock,
+    volatile LONG       *State
+);
+
+VOID
+InitEnumContext (
+    PENUM_CONTEXT   Context,
+    PUSB_SNAPSHOT   Snapshot
+);
+
 VOID
 EnumerateHostControllers (
-    HTREEITEM  hTreeParent,
-    ULONG     *DevicesConnected
+    PENUM_CONTEXT   Context
+);
+
+VOID
+FreeSnapshot (
+    PUSB_SNAPSHOT Snapshot
 );
 
 
@@ -351,10 +979,67 @@ CleanupItem (
     HTREEITEM hTreeItem
 );
 
+VOID
+FreeDeviceInfo (
+    PVOID   info
+);
+
+VOID
+GetLazyDescriptors (
+    PVOID   Info
+);
+
+BOOL
+RequestLazyDescriptors (
+    PVOID   Info
+);
+
+VOID
+FetchLazyDescriptors (
+    PLAZY_DESC_REQUEST  Request
+);
+
+BOOL
+TakeLazyDescriptors (
+    PVOID               Info,
+    PLAZY_DESC_REQUEST  Request
+);
+
+VOID
+FreeLazyDescriptors (
+    PLAZY_DESC_REQUEST  Request
+);
+
+PUSB_DEVICE_QUALIFIER_DESCRIPTOR
+GetDeviceQualifierDescriptor (
+    HANDLE  hHubDevice,
+    ULONG   ConnectionIndex
+);
+
+PUSBTREENODE
+AddTreeNode (
+    PUSBTREENODE    Parent,
+    PVOID           Info,
+    __in_opt PCTSTR Text,
+    TREEICON        Icon
+);
+
+VOID
+FreeTreeNodes (
+    PUSBTREENODE    Node,
+    BOOL            FreeInfo
+);
+
+VOID
+FreeTreeNode (
+    PUSBTREENODE    Node,
+    BOOL            FreeInfo
+);
+
 
 //
-// DEBUG.C
-//
+// DEBUG.C
+//
 
 HGLOBAL
 MyAlloc (
@@ -384,21 +1069,619 @@ MyCheckForLeaks (
 // DEVNODE.C
 //
 
-PTSTR
-DriverNameToDeviceDesc (
+BOOL
+GetDevNodeString (
+    __in_opt PDEVNODE_INDEX Index,
     __in PCTSTR DriverName,
-    BOOLEAN DeviceId
+    BOOLEAN     DeviceId,
+    __out_ecount(Length) PTSTR Buffer,
+    ULONG       Length
+);
+
+ULONG
+GetDevNodeStrings (
+    __in_opt PDEVNODE_INDEX Index,
+    __inout_ecount(Count) PDEVNODE_STRINGS Strings,
+    ULONG   Count
+);
+
+PDEVNODE_INDEX
+BuildDevNodeIndex (
+    VOID
+);
+
+VOID
+FreeDevNodeIndex (
+    __in_opt PDEVNODE_INDEX Index
+);
+
+
+//
+// DEVACCESS.C
+//
+
+PDEVICE_ACCESS_BACKEND
+GetNativeBackend (
+    VOID
+);
+
+PENUM_COUNTERS
+SetBackendCounters (
+    __in_opt PENUM_COUNTERS Counters
+);
+
+PDEVICE_ACCESS_BACKEND
+GetDeviceBackend (
+    VOID
+);
+
+PDEVICE_ACCESS_BACKEND
+SetDeviceBackend (
+    PDEVICE_ACCESS_BACKEND Backend
+);
+
+HANDLE
+BackendOpenDevice (
+    PCTSTR  DevicePath,
+    DWORD   FlagsAndAttributes
+);
+
+BOOL
+BackendCloseDevice (
+    HANDLE  hDevice
+);
+
+BOOL
+BackendDeviceIoControl (
+    HANDLE          hDevice,
+    DWORD           IoControlCode,
+    PVOID           InBuffer,
+    DWORD           InBufferSize,
+    PVOID           OutBuffer,
+    DWORD           OutBufferSize,
+    PDWORD          BytesReturned,
+    LPOVERLAPPED    Overlapped
+);
+
+BOOL
+BackendGetOverlappedResult (
+    HANDLE          hDevice,
+    LPOVERLAPPED    Overlapped,
+    PDWORD          BytesReturned,
+    BOOL            Wait
+);
+
+BOOL
+BackendEnumInterfaces (
+    LPGUID                  InterfaceGuid,
+    LPFNINTERFACECALLBACK   Callback,
+    PVOID                   Context
+);
+
+CONFIGRET
+BackendLocateDevNode (
+    PDEVINST    DevInst
+);
+
+CONFIGRET
+BackendGetChild (
+    PDEVINST    DevInstChild,
+    DEVINST     DevInst
+);
+
+CONFIGRET
+BackendGetSibling (
+    PDEVINST    DevInstSibling,
+    DEVINST     DevInst
+);
+
+CONFIGRET
+BackendGetParent (
+    PDEVINST    DevInstParent,
+    DEVINST     DevInst
+);
+
+CONFIGRET
+BackendGetDevNodeProperty (
+    DEVINST     DevInst,
+    ULONG       Property,
+    PVOID       Buffer,
+    PULONG      Length
+);
+
+CONFIGRET
+BackendGetDeviceId (
+    DEVINST     DevInst,
+    PTSTR       Buffer,
+    ULONG       Length
+);
+
+BOOL
+CompleteEmulatedRequest (
+    LPOVERLAPPED    Overlapped,
+    BOOL            Success,
+    DWORD           LastError,
+    DWORD           BytesReturned,
+    ULONG           DelayMs
+);
+
+BOOL
+GetEmulatedOverlappedResult (
+    LPOVERLAPPED    Overlapped,
+    PDWORD          BytesReturned,
+    BOOL            Wait
+);
+
+
+//
+// DEVTRACE.C
+//
+
+BOOL
+StartTraceRecording (
+    __in PCTSTR FileName
+);
+
+VOID
+StopTraceRecording (
+    VOID
+);
+
+BOOL
+StartTraceReplay (
+    __in PCTSTR FileName,
+    BOOL        EmulateLatency
+);
+
+VOID
+StopTraceReplay (
+    VOID
+);
+
+ULONG
+GetTraceReplayMisses (
+    VOID
+);
+
+
+//
+// WORKPOOL.C
+//
+
+BOOL
+WorkPoolCreate (
+    ULONG Workers
+);
+
+VOID
+WorkPoolDestroy (
+    VOID
+);
+
+VOID
+WorkPoolBegin (
+    PWORK_BATCH Batch
+);
+
+VOID
+WorkPoolSubmit (
+    PWORK_BATCH     Batch,
+    LPFNWORKROUTINE Routine,
+    PVOID           Context
+);
+
+VOID
+WorkPoolWait (
+    PWORK_BATCH Batch
+);
+
+ULONG
+WorkPoolWorkers (
+    VOID
+);
+
+
+//
+// DEVSIM.C
+//
+
+BOOL
+StartSimulation (
+    ULONG   Controllers,
+    ULONG   Depth,
+    ULONG   LatencyMs
+);
+
+VOID
+StopSimulation (
+    VOID
+);
+
+
+//
+// BENCH.C
+//
+
+BOOL
+RunEnumerationBenchmark (
+    __in PCTSTR FileName,
+    ULONG       MaxWorkers
+);
+
+
+//
+// TREEDIFF.C
+//
+
+VOID
+DiffTreeNodes (
+    PUSBTREENODE            Node,
+    PUSBTREENODE            NewNode,
+    PTREE_DIFF_CALLBACKS    Callbacks,
+    PTREE_DIFF_STATS        Stats
+);
+
+VOID
+DropUnnamedTreeNodes (
+    PUSBTREENODE    Node
 );
 
 
 //
-// DISPAUD.C
+// ENUMTHRD.C
 //
 
 BOOL
-DisplayAudioDescriptor (
-    PUSB_AUDIO_COMMON_DESCRIPTOR CommonDesc,
-    UCHAR                        bInterfaceSubClass
+StartEnumerationThread (
+    HWND    hWnd,
+    UINT    Message,
+    UINT    DescMessage
+);
+
+ULONG
+RequestEnumeration (
+    VOID
+);
+
+BOOL
+QueueLazyDescriptors (
+    PLAZY_DESC_REQUEST  Request
+);
+
+BOOL
+StopEnumerationThread (
+    VOID
+);
+
+
+//
+// REFSCHED.C
+//
+
+VOID
+InitRefreshScheduler (
+    PREFRESH_SCHEDULER  Scheduler,
+    ULONG               QuietPeriod,
+    ULONG               MaxDelay,
+    __in_opt LPFNGETTICKS GetTicks,
+    __in_opt PVOID      ClockContext
+);
+
+ULONG
+RequestRefresh (
+    PREFRESH_SCHEDULER  Scheduler
+);
+
+ULONG
+GetRefreshDelay (
+    PREFRESH_SCHEDULER  Scheduler
+);
+
+VOID
+BeginScheduledRefresh (
+    PREFRESH_SCHEDULER  Scheduler,
+    ULONG               Request
+);
+
+ULONG
+EndScheduledRefresh (
+    PREFRESH_SCHEDULER  Scheduler,
+    ULONG               Request
+);
+
+
+//
+// DESCCACHE.C
+//
+
+VOID
+BeginDescriptorCacheRefresh (
+    VOID
+);
+
+VOID
+EndDescriptorCacheRefresh (
+    VOID
+);
+
+BOOL
+LookupDescriptorCache (
+    __in_opt PCTSTR                     HubName,
+    PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfo,
+    BOOL                                NeedConfigDesc,
+    PTSTR                               *DriverKeyName,
+    PUSB_DESCRIPTOR_REQUEST             *ConfigDesc,
+    PSTRING_DESCRIPTORS                 *StringDescs,
+    PUSB_DEVICE_QUALIFIER_DESCRIPTOR    *QualifierDesc,
+    PTSTR                               *ExtHubName,
+    PENUM_COUNTERS                      Counters
+);
+
+VOID
+UpdateDescriptorCache (
+    __in_opt PCTSTR                     HubName,
+    PUSB_NODE_CONNECTION_INFORMATION_EX ConnectionInfo,
+    __in_opt PCTSTR                     DriverKeyName,
+    __in_opt PUSB_DESCRIPTOR_REQUEST    ConfigDesc,
+    __in_opt PSTRING_DESCRIPTORS        StringDescs,
+    __in_opt PUSB_DEVICE_QUALIFIER_DESCRIPTOR QualifierDesc,
+    __in_opt PCTSTR                     ExtHubName
+);
+
+VOID
+FreeDescriptorCache (
+    VOID
+);
+
+
+//
+// RENDCACHE.C
+//
+
+VOID
+SetRenderCacheBudget (
+    ULONG   Budget
+);
+
+PCTSTR
+LookupRenderCache (
+    PVOID   Key
+);
+
+VOID
+AddRenderCache (
+    PVOID   Key,
+    PCTSTR  Text,
+    ULONG   Length
+);
+
+VOID
+InvalidateRenderCache (
+    PVOID   Key
+);
+
+VOID
+FreeRenderCache (
+    VOID
+);
+
+BOOL
+RenderCacheInfoChanged (
+    __in_opt PVOID  Old,
+    __in_opt PVOID  New
+);
+
+
+//
+// TEXTSINK.C
+//
+
+BOOL
+InitMemorySink (
+    PTEXT_SINK  Sink
+);
+
+BOOL
+InitFileSink (
+    PTEXT_SINK  Sink,
+    PCTSTR      FileName
+);
+
+BOOL
+InitStdoutSink (
+    PTEXT_SINK  Sink
+);
+
+VOID
+InitCallbackSink (
+    PTEXT_SINK          Sink,
+    LPFNTEXTSINKWRITE   Callback,
+    __in_opt PVOID      Context
+);
+
+VOID
+CloseTextSink (
+    PTEXT_SINK  Sink
+);
+
+BOOL
+RenderDescriptorFile (
+    __in PCTSTR FileName,
+    PTEXT_SINK  Sink,
+    ULONG       FirstSection,
+    ULONG       NumSections
+);
+
+
+//
+// STRDESC.C
+//
+
+BOOL
+AddStringDescriptor (
+    PSTRING_DESCRIPTORS     *StringDescs,
+    UCHAR                   DescriptorIndex,
+    USHORT                  LanguageID,
+    PUSB_STRING_DESCRIPTOR  StringDesc
+);
+
+VOID
+TrimStringDescriptors (
+    PSTRING_DESCRIPTORS     *StringDescs
+);
+
+PSTRING_DESCRIPTOR_RECORD
+FirstStringDescriptor (
+    __in_opt PSTRING_DESCRIPTORS    StringDescs,
+    UCHAR                           DescriptorIndex
+);
+
+PSTRING_DESCRIPTOR_RECORD
+NextStringDescriptor (
+    PSTRING_DESCRIPTORS         StringDescs,
+    PSTRING_DESCRIPTOR_RECORD   Record
+);
+
+PUSB_STRING_DESCRIPTOR
+FindStringDescriptor (
+    __in_opt PSTRING_DESCRIPTORS    StringDescs,
+    UCHAR                           DescriptorIndex,
+    USHORT                          LanguageID
+);
+
+PSTRING_DESCRIPTORS
+CopyStringDescriptors (
+    __in_opt PSTRING_DESCRIPTORS    StringDescs
+);
+
+BOOL
+SameStringDescriptors (
+    __in_opt PSTRING_DESCRIPTORS    Old,
+    __in_opt PSTRING_DESCRIPTORS    New
+);
+
+VOID
+FreeStringDescriptors (
+    __in_opt PSTRING_DESCRIPTORS    StringDescs
+);
+
+//
+// CFGINDEX.C
+//
+
+BOOL
+IndexConfigDesc (
+    PUSB_DESCRIPTOR_REQUEST *ConfigDesc
+);
+
+PCONFIG_DESC_INDEX
+GetConfigDescIndex (
+    PUSB_DESCRIPTOR_REQUEST ConfigDesc
+);
+
+ULONG
+GetConfigDescSize (
+    PUSB_DESCRIPTOR_REQUEST ConfigDesc
+);
+
+//
+// USBIDS.C
+//
+
+BOOL
+LoadUsbIds (
+    __in_opt PCTSTR DatabaseFile,
+    __in_opt PCTSTR IndexFile
+);
+
+VOID
+UnloadUsbIds (
+    VOID
+);
+
+PCTSTR
+LookupUsbVendorName (
+    USHORT  VendorID
+);
+
+PCTSTR
+LookupUsbProductName (
+    USHORT  VendorID,
+    USHORT  ProductID
+);
+
+PCTSTR
+LookupUsbClassName (
+    UCHAR   Class
+);
+
+PCTSTR
+LookupUsbSubClassName (
+    UCHAR   Class,
+    UCHAR   SubClass
+);
+
+PCTSTR
+LookupUsbProtocolName (
+    UCHAR   Class,
+    UCHAR   SubClass,
+    UCHAR   Protocol
+);
+
+
+//
+// CLASSDEC.C
+//
+
+VOID
+BuildClassDecoders (
+    VOID
+);
+
+BOOL
+DisplayClassDescriptor (
+    PUSB_COMMON_DESCRIPTOR      CommonDesc,
+    PUSB_INTERFACE_DESCRIPTOR   InterfaceDesc
+);
+
+
+//
+// SERIAL.C
+//
+
+ULONG
+SerializeSnapshot (
+    PUSB_SNAPSHOT   Snapshot,
+    SERIAL_FORMAT   Format,
+    __in_opt HANDLE hFile
+);
+
+BOOL
+SerializeToFile (
+    PUSB_SNAPSHOT   Snapshot,
+    SERIAL_FORMAT   Format,
+    __in PCTSTR     FileName
+);
+
+
+//
+// BANDWIDTH.C
+//
+
+VOID
+ComputeBandwidth (
+    PUSB_SNAPSHOT   Snapshot,
+    ULONG           Threshold
+);
+
+
+//
+// SPEED.C
+//
+
+VOID
+DetectSpeedDowngrades (
+    PUSB_SNAPSHOT   Snapshot
 );
 
 #if _MSC_VER >= 1200
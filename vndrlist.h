@@ -11,6 +11,11 @@ Abstract:
     This header file contains a list of all currently known USB Vendor IDs
     the vendor name associated with each Vendor ID
 
+    Each entry is USB_VENDOR(<Vendor ID>, <name>), which the file including
+    this one defines.  It is included several times to build the tables of
+    GetVendorString() in DISPLAY.C, so it has no include guard.  Keep the
+    entries sorted by Vendor ID.
+
 Environment:
 
     Kernel & user mode
@@ -21,17 +26,6 @@ Revision History:
 
 --*/
 
-#ifndef   __VNDRLIST_H__
-#define   __VNDRLIST_H__
-
-//
-// Vendor ID structure
-//
-typedef struct {
-    USHORT  usVendorID;
-    PTSTR   szVendor;
-} USBVENDORID, *PUSBVENDORID;
-
 //
 // This list built from information obtained on Nov-30-2000 from
 // http://www.usb.org
@@ -40,900 +34,893 @@ typedef struct {
 // are made here as to its accuracy.
 //
 
-USBVENDORID USBVendorIDs[] =
-{
-    { 1000, /* 0x03E8 */ _T("EndPoints Inc.")},
-    { 1001, /* 0x03E9 */ _T("Thesys Microelectronics")},
-    { 1003, /* 0x03EB */ _T("Atmel Corporation")},
-    { 1006, /* 0x03EE */ _T("Mitsumi")},
-    { 1008, /* 0x03F0 */ _T("Hewlett Packard")},
-    { 1010, /* 0x03F2 */ _T("Oak Technology, Inc")},
-    { 1011, /* 0x03F3 */ _T("Adaptec, Inc.")},
-    { 1012, /* 0x03F4 */ _T("Diebold, Inc.")},
-    { 1017, /* 0x03F9 */ _T("KeyTronic Corp.")},
-    { 1019, /* 0x03FB */ _T("OPTi Inc.")},
-    { 1022, /* 0x03FE */ _T("Farallon Comunications")},
-    { 1024, /* 0x0400 */ _T("National Semiconductor")},
-    { 1026, /* 0x0402 */ _T("Acer Labs Inc.")},
-    { 1027, /* 0x0403 */ _T("Future Technology Devices International Limited")},
-    { 1028, /* 0x0404 */ _T("NCR Corporation")},
-    { 1029, /* 0x0405 */ _T("inSilicon")},
-    { 1033, /* 0x0409 */ _T("NEC Corporation")},
-    { 1034, /* 0x040A */ _T("Kodak Co.")},
-    { 1035, /* 0x040B */ _T("Weltrend Semiconductor")},
-    { 1037, /* 0x040D */ _T("VIA Technologies, Inc.")},
-    { 1038, /* 0x040E */ _T("MCCI")},
-    { 1041, /* 0x0411 */ _T("Melco, Inc.")},
-    { 1046, /* 0x0416 */ _T("Winbond Electronics Corp.")},
-    { 1050, /* 0x041A */ _T("Phoenix Technologies Ltd.")},
-    { 1054, /* 0x041E */ _T("Creative Labs")},
-    { 1057, /* 0x0421 */ _T("Nokia Mobile Phones")},
-    { 1058, /* 0x0422 */ _T("ADI Systems Inc.")},
-    { 1059, /* 0x0423 */ _T("CATC")},
-    { 1060, /* 0x0424 */ _T("Standard Microsystems Corp.")},
-    { 1061, /* 0x0425 */ _T("Motorola Semiconductors HK, Ltd.")},
-    { 1065, /* 0x0429 */ _T("Cirrus Logic Inc.")},
-    { 1068, /* 0x042C */ _T("Innovative Semiconductors, Inc.")},
-    { 1072, /* 0x0430 */ _T("Fujitsu Takamisawa America")},
-    { 1074, /* 0x0432 */ _T("Unisys Corp.")},
-    { 1078, /* 0x0436 */ _T("Taugagreining HF")},
-    { 1080, /* 0x0438 */ _T("Advanced Micro Devices")},
-    { 1085, /* 0x043D */ _T("Lexmark International Inc.")},
-    { 1086, /* 0x043E */ _T("LG Electronics USA Inc.")},
-    { 1088, /* 0x0440 */ _T("EIZO NANAO CORPORATION")},
-    { 1091, /* 0x0443 */ _T("Gateway 2000")},
-    { 1093, /* 0x0445 */ _T("Lucent Technologies")},
-    { 1094, /* 0x0446 */ _T("NMB Technologies, Inc.")},
-    { 1102, /* 0x044E */ _T("Alps Electric Co., Ltd.")},
-    { 1103, /* 0x044F */ _T("ThrustMaster, Inc.")},
-    { 1105, /* 0x0451 */ _T("Texas Instruments")},
-    { 1106, /* 0x0452 */ _T("Mitsubishi Electric & Electronics US, Inc.")},
-    { 1110, /* 0x0456 */ _T("Analog Devices, Inc.")},
-    { 1111, /* 0x0457 */ _T("Silicon Integrated Systems Corp.")},
-    { 1114, /* 0x045A */ _T("Diamond Multimedia Systems")},
-    { 1115, /* 0x045B */ _T("Hitachi, Ltd (2)")},
-    { 1118, /* 0x045E */ _T("Microsoft Corporation")},
-    { 1121, /* 0x0461 */ _T("Primax Electronics")},
-    { 1123, /* 0x0463 */ _T("MGE UPS Systems")},
-    { 1124, /* 0x0464 */ _T("AMP/Tycoelectronics")},
-    { 1128, /* 0x0468 */ _T("Wieson Electronic Co., Ltd.")},
-    { 1130, /* 0x046A */ _T("Cherry GMBH")},
-    { 1132, /* 0x046C */ _T("Toshiba Corporation, Digital Media Equipment")},
-    { 1133, /* 0x046D */ _T("Logitech Inc.")},
-    { 1134, /* 0x046E */ _T("Behavior Tech. Computer Corporation")},
-    { 1137, /* 0x0471 */ _T("Philips")},
-    { 1138, /* 0x0472 */ _T("Sun Microsystems")},
-    { 1140, /* 0x0474 */ _T("Sanyo Electric Co. Ltd.")},
-    { 1141, /* 0x0475 */ _T("TECO Electric & Machinery Co., Ltd.")},
-    { 1146, /* 0x047A */ _T("USAR Systems Incorporated")},
-    { 1147, /* 0x047B */ _T("Silitek Corp.")},
-    { 1149, /* 0x047D */ _T("Kensington")},
-    { 1150, /* 0x047E */ _T("Lucent Microelectronics Technologies")},
-    { 1151, /* 0x047F */ _T("Plantronics, Inc.")},
-    { 1154, /* 0x0482 */ _T("Kyocera Tech. Development, Inc.")},
-    { 1155, /* 0x0483 */ _T("STMicroelectronics")},
-    { 1160, /* 0x0488 */ _T("Cirque Corporation")},
-    { 1161, /* 0x0489 */ _T("Foxconn / Hon Hai")},
-    { 1165, /* 0x048D */ _T("Integrated Technology Express")},
-    { 1169, /* 0x0491 */ _T("Capetronic Kaohsiung Corp.")},
-    { 1170, /* 0x0492 */ _T("Samsung SemiConductor, Inc.")},
-    { 1174, /* 0x0496 */ _T("Micron Electronics")},
-    { 1175, /* 0x0497 */ _T("Smile International, Inc.")},
-    { 1177, /* 0x0499 */ _T("Yamaha Corporation")},
-    { 1179, /* 0x049B */ _T("Curtis Computer Products")},
-    { 1183, /* 0x049F */ _T("Compaq Computer Corporation")},
-    { 1188, /* 0x04A4 */ _T("Hitachi, Ltd.")},
-    { 1189, /* 0x04A5 */ _T("Acer Communications & Multimedia Inc.")},
-    { 1192, /* 0x04A8 */ _T("Multivideo Labs, Inc.")},
-    { 1193, /* 0x04A9 */ _T("Canon Inc. (Kosugi Office)")},
-    { 1201, /* 0x04B1 */ _T("Pan International")},
-    { 1203, /* 0x04B3 */ _T("IBM Corporation")},
-    { 1204, /* 0x04B4 */ _T("Cypress Semiconductor")},
-    { 1205, /* 0x04B5 */ _T("ROHM LSI Systems USA, LLC")},
-    { 1207, /* 0x04B7 */ _T("Compal Electronics, Inc.")},
-    { 1208, /* 0x04B8 */ _T("Seiko Epson Corp.")},
-    { 1209, /* 0x04B9 */ _T("Rainbow Technologies, Inc.")},
-    { 1211, /* 0x04BB */ _T("I-O Data Device, Inc.")},
-    { 1215, /* 0x04BF */ _T("TDK Corporation")},
-    { 1221, /* 0x04C5 */ _T("Fujitsu Ltd.")},
-    { 1224, /* 0x04C8 */ _T("Konica Corporation")},
-    { 1227, /* 0x04CB */ _T("Fuji Photo Film Co., Ltd.")},
-    { 1228, /* 0x04CC */ _T("Philips Semiconductors")},
-    { 1230, /* 0x04CE */ _T("ScanLogic Corporation")},
-    { 1231, /* 0x04CF */ _T("Myson Technology Inc.")},
-    { 1236, /* 0x04D4 */ _T("LSI Logic Corporation")},
-    { 1238, /* 0x04D6 */ _T("Mentor Graphics")},
-    { 1239, /* 0x04D7 */ _T("Oki Semiconductor")},
-    { 1240, /* 0x04D8 */ _T("Microchip Technology Inc.")},
-    { 1241, /* 0x04D9 */ _T("Holtek Semiconductor, Inc.")},
-    { 1242, /* 0x04DA */ _T("Panasonic (Matsushita)")},
-    { 1245, /* 0x04DD */ _T("Sharp Corporation")},
-    { 1246, /* 0x04DE */ _T("MindShare, Inc.")},
-    { 1254, /* 0x04E6 */ _T("SCM Microsystems")},
-    { 1255, /* 0x04E7 */ _T("Elo TouchSystems")},
-    { 1257, /* 0x04E9 */ _T("PC-Tel,  Inc.")},
-    { 1258, /* 0x04EA */ _T("Sipex Corporation")},
-    { 1259, /* 0x04EB */ _T("Northstar Systems, Inc.")},
-    { 1260, /* 0x04EC */ _T("Tokyo Electron Device Limited")},
-    { 1261, /* 0x04ED */ _T("Annabooks")},
-    { 1265, /* 0x04F1 */ _T("Victor Company of Japan, Limited")},
-    { 1266, /* 0x04F2 */ _T("Chicony Electronics Co., Ltd.")},
-    { 1267, /* 0x04F3 */ _T("Elan Microelectronics Corportation")},
-    { 1271, /* 0x04F7 */ _T("Newnex Technology Corp.")},
-    { 1272, /* 0x04F8 */ _T("FuturePlus Systems")},
-    { 1274, /* 0x04FA */ _T("Dallas Semiconductor")},
-    { 1276, /* 0x04FC */ _T("SUNPLUS TECHNOLOGY CO., LTD.")},
-    { 1277, /* 0x04FD */ _T("Soliton Systems K.K.")},
-    { 1279, /* 0x04FF */ _T("E-CMOS Corp.")},
-    { 1281, /* 0x0501 */ _T("FAI/DDK Connector Division")},
-    { 1282, /* 0x0502 */ _T("Acer, Inc.")},
-    { 1286, /* 0x0506 */ _T("3Com Corporation")},
-    { 1287, /* 0x0507 */ _T("Hosiden Corporation")},
-    { 1289, /* 0x0509 */ _T("Aztech Systems Ltd")},
-    { 1293, /* 0x050D */ _T("Belkin Components")},
-    { 1295, /* 0x050F */ _T("KC Technology Inc.")},
-    { 1296, /* 0x0510 */ _T("Sejin Electron Inc.")},
-    { 1300, /* 0x0514 */ _T("FCI Electronics")},
-    { 1302, /* 0x0516 */ _T("Longwell Electronics/Longwell Company")},
-    { 1308, /* 0x051C */ _T("Shuttle Inc.")},
-    { 1309, /* 0x051D */ _T("American Power Conversion")},
-    { 1311, /* 0x051F */ _T("IO Systems Inc. fomerly Elite Electronics, Inc.")},
-    { 1314, /* 0x0522 */ _T("Advanced Connectek USA Inc.")},
-    { 1317, /* 0x0525 */ _T("Netchip Technology Inc.")},
-    { 1318, /* 0x0526 */ _T("Temic MHS S.A.")},
-    { 1320, /* 0x0528 */ _T("ATI Technologies, Inc.")},
-    { 1321, /* 0x0529 */ _T("Aladdin Knowledge Systems")},
-    { 1322, /* 0x052A */ _T("Crescent Heart Software")},
-    { 1323, /* 0x052B */ _T("Tekom Technologies, Inc")},
-    { 1324, /* 0x052C */ _T("Canon Information Systems, Inc.")},
-    { 1329, /* 0x0531 */ _T("Wacom Technology Corp.")},
-    { 1335, /* 0x0537 */ _T("Inventec Corporation")},
-    { 1337, /* 0x0539 */ _T("Shyh Shiun Terminals Co. LTD")},
-    { 1338, /* 0x053A */ _T("Preh Werke Gmbh & Co. KG")},
-    { 1342, /* 0x053E */ _T("Mobility Electronics")},
-    { 1343, /* 0x053F */ _T("Synopsys, Inc.")},
-    { 1347, /* 0x0543 */ _T("ViewSonic Corporation")},
-    { 1349, /* 0x0545 */ _T("Xirlink, Inc.")},
-    { 1350, /* 0x0546 */ _T("Polaroid Corporation")},
-    { 1354, /* 0x054A */ _T("Fujitsu Microelectronics, Inc.")},
-    { 1356, /* 0x054C */ _T("Sony Corporation")},
-    { 1360, /* 0x0550 */ _T("Fuji Xerox Co., Ltd.")},
-    { 1363, /* 0x0553 */ _T("STMicroelectronics Imaging Division")},
-    { 1366, /* 0x0556 */ _T("Asahi Kasei Microsystems Co., Ltd")},
-    { 1367, /* 0x0557 */ _T("ATEN International Co. Ltd.")},
-    { 1369, /* 0x0559 */ _T("Cadence Design Systems, Inc.")},
-    { 1373, /* 0x055D */ _T("Samsung Electro-Mechanics Co.")},
-    { 1374, /* 0x055E */ _T("Optoma Corporation")},
-    { 1378, /* 0x0562 */ _T("Telex Communications Inc.")},
-    { 1379, /* 0x0563 */ _T("Immersion Corporation")},
-    { 1380, /* 0x0564 */ _T("Chinon Industries, Inc.")},
-    { 1386, /* 0x056A */ _T("WACOM Co., Ltd.")},
-    { 1388, /* 0x056C */ _T("e-TEK Labs")},
-    { 1390, /* 0x056E */ _T("Elecom Co., Ltd.")},
-    { 1391, /* 0x056F */ _T("Korea Data Systems Co., Ltd.")},
-    { 1393, /* 0x0571 */ _T("XLR8, Inc.")},
-    { 1394, /* 0x0572 */ _T("Conexant Systems, Inc.")},
-    { 1395, /* 0x0573 */ _T("Nogatech Ltd.")},
-    { 1397, /* 0x0575 */ _T("Philips Creative Display Solutions")},
-    { 1398, /* 0x0576 */ _T("BAFO/Quality Computer Accessories")},
-    { 1403, /* 0x057B */ _T("Y-E Data, Inc.")},
-    { 1404, /* 0x057C */ _T("AVM GmbH")},
-    { 1405, /* 0x057D */ _T("Shark Multimedia Inc.")},
-    { 1406, /* 0x057E */ _T("Nintendo Co., Ltd.")},
-    { 1410, /* 0x0582 */ _T("Roland Corporation")},
-    { 1411, /* 0x0583 */ _T("Padix Co., Ltd.")},
-    { 1412, /* 0x0584 */ _T("RATOC System Inc.")},
-    { 1413, /* 0x0585 */ _T("FlashPoint Technology, Inc.")},
-    { 1419, /* 0x058B */ _T("Infineon Technologies")},
-    { 1420, /* 0x058C */ _T("In Focus Systems")},
-    { 1421, /* 0x058D */ _T("Micrel Semiconductor")},
-    { 1423, /* 0x058F */ _T("Alcor Micro, Inc.")},
-    { 1424, /* 0x0590 */ _T("OMRON Corporation")},
-    { 1426, /* 0x0592 */ _T("Powerware Corporation")},
-    { 1429, /* 0x0595 */ _T("Zoran Microelectronics Ltd.")},
-    { 1430, /* 0x0596 */ _T("MicroTouch Systems Inc.")},
-    { 1432, /* 0x0598 */ _T("Niigata Canotec Co., Inc.")},
-    { 1435, /* 0x059B */ _T("Iomega Corporation")},
-    { 1437, /* 0x059D */ _T("Advanced Input Devices")},
-    { 1438, /* 0x059E */ _T("Intelligent Instrumentation")},
-    { 1439, /* 0x059F */ _T("LaCie")},
-    { 1442, /* 0x05A2 */ _T("Fuji Film Microdevices Co. Ltd.")},
-    { 1443, /* 0x05A3 */ _T("V Automation Inc.")},
-    { 1444, /* 0x05A4 */ _T("Ortek Technology, Inc.")},
-    { 1446, /* 0x05A6 */ _T("Cisco Systems, Inc.")},
-    { 1449, /* 0x05A9 */ _T("OmniVision Technologies, Inc.")},
-    { 1451, /* 0x05AB */ _T("In-System Design")},
-    { 1452, /* 0x05AC */ _T("Apple Computer")},
-    { 1453, /* 0x05AD */ _T("Y.C.Cable U.S.A., Inc")},
-    { 1456, /* 0x05B0 */ _T("Fountain Technologies, Inc")},
-    { 1460, /* 0x05B4 */ _T("HYUNDAI Electronics Industries Co., Ltd.")},
-    { 1466, /* 0x05BA */ _T("DigitalPersona, Inc.")},
-    { 1469, /* 0x05BD */ _T("RAFI GmbH & Co. KG")},
-    { 1470, /* 0x05BE */ _T("Raychem Corporation")},
-    { 1472, /* 0x05C0 */ _T("Keil Software")},
-    { 1473, /* 0x05C1 */ _T("Kawasaki Steel")},
-    { 1477, /* 0x05C5 */ _T("Digi International Inc.")},
-    { 1478, /* 0x05C6 */ _T("Qualcomm, Inc")},
-    { 1479, /* 0x05C7 */ _T("Qtronix Corp")},
-    { 1480, /* 0x05C8 */ _T("Cheng Uei Precision Industry Co., Ltd")},
-    { 1482, /* 0x05CA */ _T("Ricoh Company Ltd.")},
-    { 1483, /* 0x05CB */ _T("PowerVision Technologies Inc.")},
-    { 1485, /* 0x05CD */ _T("Silicom LTD.")},
-    { 1486, /* 0x05CE */ _T("Sican GmbH")},
-    { 1487, /* 0x05CF */ _T("Sung Forn Co. LTD.")},
-    { 1488, /* 0x05D0 */ _T("Lunar Corporation")},
-    { 1489, /* 0x05D1 */ _T("Brainboxes Limited")},
-    { 1496, /* 0x05D8 */ _T("Ultima Electronics Corp.")},
-    { 1497, /* 0x05D9 */ _T("Axiohm Transaction Solutions")},
-    { 1498, /* 0x05DA */ _T("Microtek International Inc.")},
-    { 1499, /* 0x05DB */ _T("Sun Corporation")},
-    { 1500, /* 0x05DC */ _T("Lexar Media, Inc.")},
-    { 1501, /* 0x05DD */ _T("Delta Electronics Inc.")},
-    { 1504, /* 0x05E0 */ _T("Symbol Technologies")},
-    { 1507, /* 0x05E3 */ _T("Genesys Logic, Inc.")},
-    { 1509, /* 0x05E5 */ _T("Fuji Electric Co., Ltd.")},
-    { 1510, /* 0x05E6 */ _T("Keithley Instruments")},
-    { 1513, /* 0x05E9 */ _T("Kawasaki LSI")},
-    { 1519, /* 0x05EF */ _T("Anko Electronic Co., Ltd.")},
-    { 1520, /* 0x05F0 */ _T("Canopus Co., Ltd.")},
-    { 1523, /* 0x05F3 */ _T("PI Engineering, Inc")},
-    { 1525, /* 0x05F5 */ _T("Unixtar Technology Inc.")},
-    { 1527, /* 0x05F7 */ _T("Silicon Portals Inc.")},
-    { 1529, /* 0x05F9 */ _T("PSC Scanning, Inc.")},
-    { 1533, /* 0x05FD */ _T("STD Manufacturing Ltd.")},
-    { 1534, /* 0x05FE */ _T("CHIC TECHNOLOGY CORP")},
-    { 1535, /* 0x05FF */ _T("LeCroy Corporation")},
-    { 1537, /* 0x0601 */ _T("Jazz Hipster Corporation")},
-    { 1538, /* 0x0602 */ _T("Vista Imaging Inc.")},
-    { 1539, /* 0x0603 */ _T("Novatek Microelectronics Corp.")},
-    { 1540, /* 0x0604 */ _T("Jean Co, Ltd.")},
-    { 1543, /* 0x0607 */ _T("Bridge Information Co., Ltd.")},
-    { 1545, /* 0x0609 */ _T("SMK Manufacturing Inc.")},
-    { 1546, /* 0x060A */ _T("Worth Data, Inc.")},
-    { 1551, /* 0x060F */ _T("Joinsoon Electronics Mfg. Co., Ltd.")},
-    { 1553, /* 0x0611 */ _T("Totoku Electric Co., LTD.")},
-    { 1555, /* 0x0613 */ _T("TransAct Technologies Incorporated")},
-    { 1556, /* 0x0614 */ _T("Bio-Rad Laboratories")},
-    { 1558, /* 0x0616 */ _T("Future Techno Designs PVT. LTD.")},
-    { 1561, /* 0x0619 */ _T("Seiko Instruments Inc.")},
-    { 1564, /* 0x061C */ _T("Act Labs, Ltd.")},
-    { 1565, /* 0x061D */ _T("Quatech, Inc.")},
-    { 1566, /* 0x061E */ _T("Nissei Electric Co.")},
-    { 1568, /* 0x0620 */ _T("Alaris, Inc.")},
-    { 1569, /* 0x0621 */ _T("ODU-Steckverbindungssysteme GmbH & Co. KG")},
-    { 1571, /* 0x0623 */ _T("Littelfuse, Inc.")},
-    { 1572, /* 0x0624 */ _T("Avocent Corporation")},
-    { 1574, /* 0x0626 */ _T("Nippon Systems Development Co., Ltd.")},
-    { 1577, /* 0x0629 */ _T("Zida Technologies Limited")},
-    { 1579, /* 0x062B */ _T("Greatlink Electronics Taiwan  Ltd.")},
-    { 1581, /* 0x062D */ _T("Taiwan Tai-Hao Enterprises Co. Ltd.")},
-    { 1582, /* 0x062E */ _T("Mainsuper Enterprises Co., Ltd.")},
-    { 1583, /* 0x062F */ _T("Sin Sheng Terminal & Machine Inc.")},
-    { 1588, /* 0x0634 */ _T("Micron Technology, Inc.")},
-    { 1590, /* 0x0636 */ _T("Sierra Imaging, Inc.")},
-    { 1592, /* 0x0638 */ _T("Avision, Inc.")},
-    { 1600, /* 0x0640 */ _T("Hitex Development Tools")},
-    { 1601, /* 0x0641 */ _T("Woods Industries, Inc.")},
-    { 1604, /* 0x0644 */ _T("TEAC Corporation")},
-    { 1605, /* 0x0645 */ _T("Ethentica Inc.")},
-    { 1611, /* 0x064B */ _T("White Mountain DSP, Inc.")},
-    { 1612, /* 0x064C */ _T("Ji-Haw Industrial Co., Ltd")},
-    { 1615, /* 0x064F */ _T("WIBU-Systems AG")},
-    { 1617, /* 0x0651 */ _T("Likom Technology Sdn. Bhd.")},
-    { 1618, /* 0x0652 */ _T("Stargate Solutions, Inc.")},
-    { 1620, /* 0x0654 */ _T("Granite Microsystems, Inc.")},
-    { 1621, /* 0x0655 */ _T("Space Shuttle Hi-Tech Co.,Ltd.")},
-    { 1622, /* 0x0656 */ _T("Glory Mark Electronic Ltd.")},
-    { 1623, /* 0x0657 */ _T("Tekcon American Corp.")},
-    { 1626, /* 0x065A */ _T("Optoelectronics Co., Ltd.")},
-    { 1631, /* 0x065F */ _T("Good Way Industrial Co, Ltd & GWC Technology Inc.")},
-    { 1632, /* 0x0660 */ _T("TSAY-E (BVI) International Inc.")},
-    { 1633, /* 0x0661 */ _T("Hamamatsu Photonics K.K.")},
-    { 1635, /* 0x0663 */ _T("Topmax Electronic Co., Ltd.")},
-    { 1641, /* 0x0669 */ _T("Oce' Printing Systems GmbH")},
-    { 1642, /* 0x066A */ _T("Total Technologies, Ltd.")},
-    { 1647, /* 0x066F */ _T("SigmaTel, Inc.")},
-    { 1650, /* 0x0672 */ _T("Labtec Inc.")},
-    { 1652, /* 0x0674 */ _T("Key Mouse Electronic Enterprise Co., Ltd.")},
-    { 1653, /* 0x0675 */ _T("DrayTek Corp.")},
-    { 1654, /* 0x0676 */ _T("Teles AG")},
-    { 1656, /* 0x0678 */ _T("ACARD Technology Corp.")},
-    { 1659, /* 0x067B */ _T("Prolific Technology, Inc.")},
-    { 1660, /* 0x067C */ _T("Efficient Networks, Inc.")},
-    { 1662, /* 0x067E */ _T("Intermec")},
-    { 1663, /* 0x067F */ _T("Virata Ltd.")},
-    { 1664, /* 0x0680 */ _T("Avance Logic, Inc.")},
-    { 1665, /* 0x0681 */ _T("Siemens Information and Communication Products")},
-    { 1670, /* 0x0686 */ _T("Minolta Co., Ltd.")},
-    { 1674, /* 0x068A */ _T("Pertech Inc.")},
-    { 1680, /* 0x0690 */ _T("Golden Bridge Electech Inc.")},
-    { 1683, /* 0x0693 */ _T("Hagiwara Sys-Com Co., Ltd.")},
-    { 1684, /* 0x0694 */ _T("The LEGO Company")},
-    { 1688, /* 0x0698 */ _T("Chuntex (CTX)")},
-    { 1689, /* 0x0699 */ _T("Tektronix, Inc.")},
-    { 1690, /* 0x069A */ _T("Askey Computer Corporation")},
-    { 1691, /* 0x069B */ _T("Thomson Consumer Electronics")},
-    { 1693, /* 0x069D */ _T("Hughes Network Systems (HNS)")},
-    { 1698, /* 0x06A2 */ _T("Topro Technology Inc.")},
-    { 1699, /* 0x06A3 */ _T("Saitek PLC")},
-    { 1701, /* 0x06A5 */ _T("Divio")},
-    { 1705, /* 0x06A9 */ _T("Westell")},
-    { 1706, /* 0x06AA */ _T("Sysgration Ltd.")},
-    { 1708, /* 0x06AC */ _T("Fujitsu PC Corporation")},
-    { 1710, /* 0x06AE */ _T("Professional Multimedia Testing Centre")},
-    { 1720, /* 0x06B8 */ _T("Pixela Corproation")},
-    { 1721, /* 0x06B9 */ _T("Alcatel Telecom")},
-    { 1722, /* 0x06BA */ _T("Smooth Cord & Connector Co., Ltd.")},
-    { 1723, /* 0x06BB */ _T("EDA Inc.")},
-    { 1724, /* 0x06BC */ _T("Oki Data Corporation")},
-    { 1725, /* 0x06BD */ _T("AGFA-Gevaert NV")},
-    { 1727, /* 0x06BF */ _T("Leoco Corporation")},
-    { 1732, /* 0x06C4 */ _T("Bizlink International Corporation")},
-    { 1736, /* 0x06C8 */ _T("SIIG, Inc.")},
-    { 1740, /* 0x06CC */ _T("Terayon Communication Systems")},
-    { 1741, /* 0x06CD */ _T("Keyspan")},
-    { 1747, /* 0x06D3 */ _T("Mitsubishi Electric Corporation")},
-    { 1754, /* 0x06DA */ _T("Phoenixtec Power Co., Ltd.")},
-    { 1755, /* 0x06DB */ _T("Paradyne")},
-    { 1756, /* 0x06DC */ _T("Compeye Corporation")},
-    { 1758, /* 0x06DE */ _T("Heisei Electronics Co. Ltd.")},
-    { 1760, /* 0x06E0 */ _T("Multi-Tech Systems, Inc.")},
-    { 1764, /* 0x06E4 */ _T("Alcatel Microelectronics")},
-    { 1766, /* 0x06E6 */ _T("Tiger Jet Network, Inc.")},
-    { 1778, /* 0x06F2 */ _T("Machkey  International (USA)")},
-    { 1789, /* 0x06FD */ _T("Boston Acoustics")},
-    { 1793, /* 0x0701 */ _T("Supercomal Wire & Cable SDN. BHD.")},
-    { 1797, /* 0x0705 */ _T("NKK Corporation")},
-    { 1801, /* 0x0709 */ _T("Parthus Technologies")},
-    { 1802, /* 0x070A */ _T("Oki Electric Industry Co., Ltd")},
-    { 1805, /* 0x070D */ _T("Comoss Electronic Co., Ltd.")},
-    { 1808, /* 0x0710 */ _T("Connect Tech Inc.")},
-    { 1809, /* 0x0711 */ _T("Magic Control Technology Corp.")},
-    { 1816, /* 0x0718 */ _T("Imation Corp.")},
-    { 1817, /* 0x0719 */ _T("Tremon Enterprises Co., Ltd.")},
-    { 1821, /* 0x071D */ _T("Eicon Technology Corporation")},
-    { 1827, /* 0x0723 */ _T("Centillium Communications Corporation")},
-    { 1830, /* 0x0726 */ _T("Vanguard International Semiconductor-America")},
-    { 1841, /* 0x0731 */ _T("SusTeen, Inc.")},
-    { 1843, /* 0x0733 */ _T("ViewQuest Technologies, Inc.")},
-    { 1844, /* 0x0734 */ _T("LASAT Communications A/S")},
-    { 1848, /* 0x0738 */ _T("Mad Catz, Inc.")},
-    { 1862, /* 0x0746 */ _T("ONKYO Corporation")},
-    { 1864, /* 0x0748 */ _T("Strong Man Enterprise Co., Ltd.")},
-    { 1868, /* 0x074C */ _T("C-C-C Group PLC")},
-    { 1869, /* 0x074D */ _T("Micronas GmbH")},
-    { 1870, /* 0x074E */ _T("Digital Stream Corporation")},
-    { 1879, /* 0x0757 */ _T("Network Technologies, Inc.")},
-    { 1892, /* 0x0764 */ _T("Cyber Power System, Inc.")},
-    { 1893, /* 0x0765 */ _T("X-Rite Incorporated")},
-    { 1896, /* 0x0768 */ _T("Camtel Technology Corp.")},
-    { 1897, /* 0x0769 */ _T("Surecom Technology Corp.")},
-    { 1898, /* 0x076A */ _T("Conceptual Systems")},
-    { 1899, /* 0x076B */ _T("OMNIKEY AG")},
-    { 1900, /* 0x076C */ _T("Partner Tech")},
-    { 1901, /* 0x076D */ _T("Denso Corporation")},
-    { 1910, /* 0x0776 */ _T("Inalways Corporation")},
-    { 1911, /* 0x0777 */ _T("Comda Enterprise Corporation")},
-    { 1913, /* 0x0779 */ _T("Fairchild Semiconductor")},
-    { 1914, /* 0x077A */ _T("Sankyo Seiki Mfg. Co., Ltd.")},
-    { 1915, /* 0x077B */ _T("Linksys")},
-    { 1916, /* 0x077C */ _T("Forward Electronics Co., Ltd.")},
-    { 1921, /* 0x0781 */ _T("SanDisk Corporation")},
-    { 1922, /* 0x0782 */ _T("Trackerball")},
-    { 1929, /* 0x0789 */ _T("Logitec Corporation")},
-    { 1934, /* 0x078E */ _T("Brimax Inc.")},
-    { 1936, /* 0x0790 */ _T("Pro-Image Manufacturing Co., Ltd")},
-    { 1937, /* 0x0791 */ _T("Copartner Wire and Cable Mfg. Corp.")},
-    { 1938, /* 0x0792 */ _T("Axis Communications AB")},
-    { 1939, /* 0x0793 */ _T("Wha Yu Industrial Co., Ltd.")},
-    { 1940, /* 0x0794 */ _T("ABL Electronics Corporation")},
-    { 1941, /* 0x0795 */ _T("RealChip Inc.")},
-    { 1942, /* 0x0796 */ _T("Certicom Corp.")},
-    { 1943, /* 0x0797 */ _T("Grandtech Semiconductor Corporation")},
-    { 1949, /* 0x079D */ _T("Alfadata Computer Corp.")},
-    { 1954, /* 0x07A2 */ _T("National Technical Systems")},
-    { 1955, /* 0x07A3 */ _T("ONNTO Corp.")},
-    { 1956, /* 0x07A4 */ _T("Be Incorporated")},
-    { 1958, /* 0x07A6 */ _T("ADMtek Incorporated")},
-    { 1962, /* 0x07AA */ _T("correga K.K.")},
-    { 1963, /* 0x07AB */ _T("Freecom Technologies")},
-    { 1969, /* 0x07B1 */ _T("IMP, Inc.")},
-    { 1971, /* 0x07B3 */ _T("Plustek, Inc.")},
-    { 1972, /* 0x07B4 */ _T("Olympus Optical Co., Ltd.")},
-    { 1973, /* 0x07B5 */ _T("Mega World International Ltd.")},
-    { 1974, /* 0x07B6 */ _T("Marubun Corp.")},
-    { 1975, /* 0x07B7 */ _T("TIME Interconect Ltd.")},
-    { 1976, /* 0x07B8 */ _T("AboCom Systems, Inc.")},
-    { 1980, /* 0x07BC */ _T("Canon Computer Sytems, Inc.")},
-    { 1982, /* 0x07BE */ _T("Veridicom")},
-    { 1988, /* 0x07C4 */ _T("Datafab Systems Inc.")},
-    { 1989, /* 0x07C5 */ _T("APG Cash Drawer")},
-    { 1990, /* 0x07C6 */ _T("Share Wave, Inc.")},
-    { 1991, /* 0x07C7 */ _T("Powertech Industrial Co., Ltd.")},
-    { 1993, /* 0x07C9 */ _T("Allied Telesyn International")},
-    { 1995, /* 0x07CB */ _T("Kingmax Technology Inc.")},
-    { 1996, /* 0x07CC */ _T("Carry Computer Eng., Co., Ltd.")},
-    { 2003, /* 0x07D3 */ _T("Cyberdata Corp.")},
-    { 2007, /* 0x07D7 */ _T("GCC Technologies, Inc.")},
-    { 2010, /* 0x07DA */ _T("Arasan Chip Systems")},
-    { 2015, /* 0x07DF */ _T("David Electronics Company, Ltd.")},
-    { 2018, /* 0x07E2 */ _T("Elmeg GmbH & Co., Ltd.")},
-    { 2019, /* 0x07E3 */ _T("Planex Communications, Inc.")},
-    { 2020, /* 0x07E4 */ _T("Movado Enterprise Co., Ltd.")},
-    { 2021, /* 0x07E5 */ _T("QPS, Inc.")},
-    { 2022, /* 0x07E6 */ _T("Allied Cable Corporation")},
-    { 2024, /* 0x07E8 */ _T("Labsystems")},
-    { 2026, /* 0x07EA */ _T("Iwatsu Electric Co., Ltd.")},
-    { 2027, /* 0x07EB */ _T("Double-H Technology Co., Ltd.")},
-    { 2028, /* 0x07EC */ _T("Taiyo Electrical Wire & Cable Co., Ltd.")},
-    { 2039, /* 0x07F7 */ _T("Century Corporation")},
-    { 2041, /* 0x07F9 */ _T("Dotop Technology, Inc.")},
-    { 2049, /* 0x0801 */ _T("Mag-Tek")},
-    { 2050, /* 0x0802 */ _T("Infineer Inc.")},
-    { 2051, /* 0x0803 */ _T("Zoom Telephonics, Inc.")},
-    { 2057, /* 0x0809 */ _T("Genicom Corp.")},
-    { 2058, /* 0x080A */ _T("Evermuch Technology Co., Ltd.")},
-    { 2061, /* 0x080D */ _T("TECO Image Systems Co., Ltd.")},
-    { 2064, /* 0x0810 */ _T("Personal Communication Systems, Inc.")},
-    { 2067, /* 0x0813 */ _T("Mattel, Inc.")},
-    { 2078, /* 0x081E */ _T("AlphaSmart, Inc.")},
-    { 2082, /* 0x0822 */ _T("REUDO Corporation")},
-    { 2086, /* 0x0826 */ _T("Data Transit")},
-    { 2087, /* 0x0827 */ _T("BroadLogic, Inc.")},
-    { 2088, /* 0x0828 */ _T("Sato Corporation")},
-    { 2089, /* 0x0829 */ _T("Telocity, Inc")},
-    { 2096, /* 0x0830 */ _T("Palm Inc.")},
-    { 2098, /* 0x0832 */ _T("Kouwell Electronics Corp.")},
-    { 2099, /* 0x0833 */ _T("Sourcenext Corporation")},
-    { 2101, /* 0x0835 */ _T("Action Star Enterprise Co., Ltd.")},
-    { 2105, /* 0x0839 */ _T("Samsung Techwin")},
-    { 2106, /* 0x083A */ _T("Accton Technology Corporation")},
-    { 2118, /* 0x0846 */ _T("NETGEAR, Inc.")},
-    { 2125, /* 0x084D */ _T("Minton Optic Industry Co., Ltd.")},
-    { 2129, /* 0x0851 */ _T("Macronix International Co., Ltd.")},
-    { 2130, /* 0x0852 */ _T("CSEM")},
-    { 2136, /* 0x0858 */ _T("Hitachi Maxell Ltd.")},
-    { 2137, /* 0x0859 */ _T("Minolta Systems Laboratory, Inc.")},
-    { 2138, /* 0x085A */ _T("Xircom")},
-    { 2154, /* 0x086A */ _T("Emagic Soft-und Hardware Gmbh")},
-    { 2158, /* 0x086E */ _T("System TALKS Inc.")},
-    { 2159, /* 0x086F */ _T("MEC IMEX INC/HPT")},
-    { 2160, /* 0x0870 */ _T("Metricom")},
-    { 2163, /* 0x0873 */ _T("Xpeed Inc.")},
-    { 2169, /* 0x0879 */ _T("Comtrol Corporation")},
-    { 2172, /* 0x087C */ _T("ADESSO/Kbtek America Inc.")},
-    { 2173, /* 0x087D */ _T("JATON Corporation")},
-    { 2174, /* 0x087E */ _T("Fujitsu Computer Products of America")},
-    { 2176, /* 0x0880 */ _T("APT Technologies Inc.")},
-    { 2194, /* 0x0892 */ _T("DioGraphy Inc.")},
-    { 2205, /* 0x089D */ _T("Icron Systems Inc.")},
-    { 2206, /* 0x089E */ _T("NST Co., Ltd.")},
-    { 2222, /* 0x08AE */ _T("Mace Group, Inc.")},
-    { 2228, /* 0x08B4 */ _T("Sorenson Vision, Inc.")},
-    { 2233, /* 0x08B9 */ _T("Tandy Corporation/Radio Shack")},
-    { 2235, /* 0x08BB */ _T("Burr-Brown Japan, Ltd.")},
-    { 2237, /* 0x08BD */ _T("Citizen Watch Co., Ltd.")},
-    { 2244, /* 0x08C4 */ _T("Proxim, Inc.")},
-    { 2247, /* 0x08C7 */ _T("Key Nice Enterprise Co., Ltd.")},
-    { 2248, /* 0x08C8 */ _T("2Wire, Inc")},
-    { 2250, /* 0x08CA */ _T("AIPTEK International Inc.")},
-    { 2254, /* 0x08CE */ _T("Long Well Electronics Corp.")},
-    { 2259, /* 0x08D3 */ _T("Virtual Ink")},
-    { 2269, /* 0x08DD */ _T("Billionton Systems, Inc.")},
-    { 2271, /* 0x08DF */ _T("Spyrus Inc.")},
-    { 2276, /* 0x08E4 */ _T("Pioneer Corporation")},
-    { 2277, /* 0x08E5 */ _T("LITRONIC")},
-    { 2278, /* 0x08E6 */ _T("GEMPLUS")},
-    { 2280, /* 0x08E8 */ _T("Integrated Memory Logic")},
-    { 2281, /* 0x08E9 */ _T("Extended Systems, Inc.")},
-    { 2282, /* 0x08EA */ _T("Ericsson Inc.")},
-    { 2286, /* 0x08EE */ _T("CCSI/HESSO")},
-    { 2288, /* 0x08F0 */ _T("Corex Technologies")},
-    { 2289, /* 0x08F1 */ _T("CTI Electronics Corporation")},
-    { 2293, /* 0x08F5 */ _T("SYSTEC Co., Ltd.")},
-    { 2294, /* 0x08F6 */ _T("Logic 3 International Limited")},
-    { 2296, /* 0x08F8 */ _T("Keen Top International Enterprise Co., Ltd.")},
-    { 2298, /* 0x08FA */ _T("CAERE")},
-    { 2299, /* 0x08FB */ _T("Socket Communications")},
-    { 2300, /* 0x08FC */ _T("Sicon International")},
-    { 2301, /* 0x08FD */ _T("Digianswer A/S")},
-    { 2303, /* 0x08FF */ _T("AuthenTec, Inc.")},
-    { 2305, /* 0x0901 */ _T("VST Technologies")},
-    { 2310, /* 0x0906 */ _T("FARADAY Technology Corp.")},
-    { 2314, /* 0x090A */ _T("Trumpion Microelectronics Inc")},
-    { 2315, /* 0x090B */ _T("Neurosmith")},
-    { 2316, /* 0x090C */ _T("Feiya Technology Corporation")},
-    { 2317, /* 0x090D */ _T("MULTIPORT Computer Vertriebs GmbH")},
-    { 2318, /* 0x090E */ _T("Shining Technology, Inc.")},
-    { 2319, /* 0x090F */ _T("Fujitsu Devices Inc.")},
-    { 2320, /* 0x0910 */ _T("Alation Systems, Inc.")},
-    { 2321, /* 0x0911 */ _T("Philips Speech Processing")},
-    { 2322, /* 0x0912 */ _T("Voquette, Inc.")},
-    { 2325, /* 0x0915 */ _T("GlobeSpan, Inc.")},
-    { 2327, /* 0x0917 */ _T("SmartDisk Corporation")},
-    { 2334, /* 0x091E */ _T("Garmin International")},
-    { 2337, /* 0x0921 */ _T("GoHubs, inc.")},
-    { 2338, /* 0x0922 */ _T("Dymo-CoStar Corporation")},
-    { 2339, /* 0x0923 */ _T("IC Media Corporation")},
-    { 2340, /* 0x0924 */ _T("Xerox")},
-    { 2343, /* 0x0927 */ _T("Summus, Ltd.")},
-    { 2344, /* 0x0928 */ _T("Oxford Semiconductor Ltd.")},
-    { 2345, /* 0x0929 */ _T("American Biometric Company")},
-    { 2347, /* 0x092B */ _T("Sena Technologies, Inc.")},
-    { 2352, /* 0x0930 */ _T("Toshiba Corporation")},
-    { 2353, /* 0x0931 */ _T("Harmonic Data Systems Ltd.")},
-    { 2354, /* 0x0932 */ _T("Crescentec Corporation")},
-    { 2355, /* 0x0933 */ _T("Quantum Corp.")},
-    { 2356, /* 0x0934 */ _T("Netcom Systems")},
-    { 2361, /* 0x0939 */ _T("Lumberg, Inc.")},
-    { 2362, /* 0x093A */ _T("Pixart Imaging, Inc.")},
-    { 2363, /* 0x093B */ _T("Plextor")},
-    { 2366, /* 0x093E */ _T("J.S.T. Mfg. Co., Ltd.")},
-    { 2367, /* 0x093F */ _T("OLYMPIA Telecom Vertriebs GmbH")},
-    { 2368, /* 0x0940 */ _T("Japan Storage Battery Co., Ltd.")},
-    { 2369, /* 0x0941 */ _T("Photobit Corporation")},
-    { 2370, /* 0x0942 */ _T("i2Go.com, LLC")},
-    { 2371, /* 0x0943 */ _T("HCL Technologies India Private Limited")},
-    { 2373, /* 0x0945 */ _T("PASCO Scientific")},
-    { 2381, /* 0x094D */ _T("Cable Television Laboratories")},
-    { 2385, /* 0x0951 */ _T("Kingston Technology Company")},
-    { 2388, /* 0x0954 */ _T("RPM Systems Corporation")},
-    { 2389, /* 0x0955 */ _T("NVIDIA")},
-    { 2390, /* 0x0956 */ _T("Bsquare")},
-    { 2391, /* 0x0957 */ _T("Agilent Technologies, Inc.")},
-    { 2392, /* 0x0958 */ _T("BioLink Technologies International, Inc.")},
-    { 2393, /* 0x0959 */ _T("Cologne Chip AG")},
-    { 2394, /* 0x095A */ _T("Portsmith")},
-    { 2395, /* 0x095B */ _T("Medialogic Corporation")},
-    { 2396, /* 0x095C */ _T("K-Tec Electronics")},
-    { 2397, /* 0x095D */ _T("Polycom, Inc.")},
-    { 2408, /* 0x0968 */ _T("Catalyst Enterprises, Inc.")},
-    { 2417, /* 0x0971 */ _T("Gretag-Macbeth AG")},
-    { 2419, /* 0x0973 */ _T("Schlumberger")},
-    { 2420, /* 0x0974 */ _T("Eye Communication Systems, Inc")},
-    { 2421, /* 0x0975 */ _T("OL'E Communications, Inc.")},
-    { 2422, /* 0x0976 */ _T("Adirondack Wire & Cable")},
-    { 2423, /* 0x0977 */ _T("Lightsurf Technologies")},
-    { 2424, /* 0x0978 */ _T("Beckhoff Gmbh")},
-    { 2425, /* 0x0979 */ _T("Jeilin Technology Corp., Ltd.")},
-    { 2426, /* 0x097A */ _T("Minds At Work LLC")},
-    { 2427, /* 0x097B */ _T("Knudsen Engineering Limited")},
-    { 2428, /* 0x097C */ _T("Marunix Co., Ltd.")},
-    { 2429, /* 0x097D */ _T("Rosun Technologies, Inc.")},
-    { 2431, /* 0x097F */ _T("Barun Electronics Co. Ltd.")},
-    { 2444, /* 0x098C */ _T("Vitana Corporation")},
-    { 2445, /* 0x098D */ _T("INDesign")},
-    { 2446, /* 0x098E */ _T("Integrated Intellectual Property Inc.")},
-    { 2447, /* 0x098F */ _T("Kenwood TMI Corporation")},
-    { 2454, /* 0x0996 */ _T("Integrated Telecom Express, Inc.")},
-    { 2467, /* 0x09A3 */ _T("PairGain Technologies")},
-    { 2468, /* 0x09A4 */ _T("Contech Research, Inc.")},
-    { 2469, /* 0x09A5 */ _T("VCON Telecommunications")},
-    { 2470, /* 0x09A6 */ _T("Poinchips")},
-    { 2471, /* 0x09A7 */ _T("Data Transmission Network Corp.")},
-    { 2472, /* 0x09A8 */ _T("Shinestar Enterprise Co., Ltd.")},
-    { 2473, /* 0x09A9 */ _T("Smart Card Technologies Co., Ltd.")},
-    { 2474, /* 0x09AA */ _T("Intersil Corporation")},
-    { 2483, /* 0x09B3 */ _T("Altius Solutions, Inc.")},
-    { 2484, /* 0x09B4 */ _T("MDS Telephone Systems")},
-    { 2485, /* 0x09B5 */ _T("Celltrix Technology Co., Ltd.")},
-    { 2497, /* 0x09C1 */ _T("Arris Interactive LLC")},
-    { 2498, /* 0x09C2 */ _T("NISCA Corporation")},
-    { 2499, /* 0x09C3 */ _T("ACTIVCARD, INC.")},
-    { 2500, /* 0x09C4 */ _T("ACTiSYS Corporation")},
-    { 2501, /* 0x09C5 */ _T("Memory Corporation")},
-    { 2508, /* 0x09CC */ _T("Workbit Corporation")},
-    { 2509, /* 0x09CD */ _T("Psion Connect Ltd.")},
-    { 2510, /* 0x09CE */ _T("City Electronics Ltd.")},
-    { 2511, /* 0x09CF */ _T("Electronics Testing Center, Taiwan")},
-    { 2513, /* 0x09D1 */ _T("NeoMagic Inc.")},
-    { 2514, /* 0x09D2 */ _T("Vreelin Engineering Inc.")},
-    { 2515, /* 0x09D3 */ _T("COM ONE")},
-    { 2521, /* 0x09D9 */ _T("Jungo")},
-    { 2522, /* 0x09DA */ _T("A-FOUR TECH CO., LTD.")},
-    { 2523, /* 0x09DB */ _T("ComputerBoards Inc.")},
-    { 2524, /* 0x09DC */ _T("AIMEX Corporation")},
-    { 2525, /* 0x09DD */ _T("Fellowes Manufacturing Co.")},
-    { 2527, /* 0x09DF */ _T("Addonics Technologies Corp.")},
-    { 2533, /* 0x09E5 */ _T("Jo-Dan International, Inc.")},
-    { 2534, /* 0x09E6 */ _T("Silutia, Inc.")},
-    { 2535, /* 0x09E7 */ _T("Real 3D, Inc.")},
-    { 2536, /* 0x09E8 */ _T("AKAI  professional M.I. Corp.")},
-    { 2537, /* 0x09E9 */ _T("CHEN-SOURCE INC.")},
-    { 2549, /* 0x09F5 */ _T("ARESCOM")},
-    { 2550, /* 0x09F6 */ _T("RocketChips, Inc.")},
-    { 2551, /* 0x09F7 */ _T("EDU-SCIENCE (H.K.) LIMITED")},
-    { 2552, /* 0x09F8 */ _T("SoftConnex")},
-    { 2553, /* 0x09F9 */ _T("Bay Associates")},
-    { 2554, /* 0x09FA */ _T("Mtek Vision")},
-    { 2555, /* 0x09FB */ _T("Altera")},
-    { 2559, /* 0x09FF */ _T("Gain Technology Corp.")},
-    { 2560, /* 0x0A00 */ _T("Liquid Audio")},
-    { 2561, /* 0x0A01 */ _T("ViA, Inc.")},
-    { 2571, /* 0x0A0B */ _T("Cybex Computer Products Corporation")},
-    { 2577, /* 0x0A11 */ _T("Xentec Incorporated")},
-    { 2578, /* 0x0A12 */ _T("Cambridge Silicon Radio Ltd.")},
-    { 2579, /* 0x0A13 */ _T("Telebyte Inc.")},
-    { 2580, /* 0x0A14 */ _T("Spacelabs Medical Inc.")},
-    { 2581, /* 0x0A15 */ _T("Scalar Corporation")},
-    { 2582, /* 0x0A16 */ _T("Trek Technology (S) Pte Ltd")},
-    { 2583, /* 0x0A17 */ _T("Asahi Optical Co., Ltd.")},
-    { 2584, /* 0x0A18 */ _T("Heidelberger Druckmaschinen AG")},
-    { 2585, /* 0x0A19 */ _T("Hua Geng Technologies Inc.")},
-    { 2593, /* 0x0A21 */ _T("Medtronic Physio Control Corp.")},
-    { 2594, /* 0x0A22 */ _T("Century Semiconductor USA, Inc.")},
-    { 2595, /* 0x0A23 */ _T("NDS Technologies Israel Ltd.")},
-    { 2617, /* 0x0A39 */ _T("Gilat Satellite Networks Ltd.")},
-    { 2618, /* 0x0A3A */ _T("PentaMedia Co., Ltd.")},
-    { 2620, /* 0x0A3C */ _T("NTT DoCoMo,Inc.")},
-    { 2621, /* 0x0A3D */ _T("Varo Vision")},
-    { 2627, /* 0x0A43 */ _T("Boca Systems Inc.")},
-    { 2628, /* 0x0A44 */ _T("TurboLinux")},
-    { 2629, /* 0x0A45 */ _T("Look&Say co., Ltd.")},
-    { 2630, /* 0x0A46 */ _T("Davicom Semiconductor, Inc.")},
-    { 2631, /* 0x0A47 */ _T("Hirose Electric")},
-    { 2632, /* 0x0A48 */ _T("I/O Interconnect")},
-    { 2635, /* 0x0A4B */ _T("Fujitsu Media Devices Limited")},
-    { 2636, /* 0x0A4C */ _T("COMPUTEX Co., Ltd.")},
-    { 2637, /* 0x0A4D */ _T("Evolution Electronics Ltd.")},
-    { 2638, /* 0x0A4E */ _T("Steinberg Soft-und Hardware GmbH")},
-    { 2639, /* 0x0A4F */ _T("Litton Systems Inc.")},
-    { 2640, /* 0x0A50 */ _T("Mimaki Engineering Co, Ltd.")},
-    { 2641, /* 0x0A51 */ _T("Sony Electronics Inc.")},
-    { 2642, /* 0x0A52 */ _T("JEBSEE ELECTRONICS CO., LTD.")},
-    { 2643, /* 0x0A53 */ _T("Portable Peripheral Co., Ltd.")},
-    { 2650, /* 0x0A5A */ _T("Electronics For Imaging, Inc.")},
-    { 2651, /* 0x0A5B */ _T("EASICS NV")},
-    { 2652, /* 0x0A5C */ _T("Broadcom Corp.")},
-    { 2653, /* 0x0A5D */ _T("Diatrend Corporation")},
-    { 2654, /* 0x0A5E */ _T("Spinnaker Systems Inc.")},
-    { 2655, /* 0x0A5F */ _T("Eltron Card Printer Products")},
-    { 2661, /* 0x0A65 */ _T("FullAudio, Inc.")},
-    { 2662, /* 0x0A66 */ _T("ClearCube Technology")},
-    { 2663, /* 0x0A67 */ _T("Medeli Electronics Co, Ltd.")},
-    { 2664, /* 0x0A68 */ _T("COMAIDE Corporation")},
-    { 2665, /* 0x0A69 */ _T("Chroma ate Inc.")},
-    { 2666, /* 0x0A6A */ _T("Newcom Inc.")},
-    { 2667, /* 0x0A6B */ _T("Green House Co., Ltd.")},
-    { 2668, /* 0x0A6C */ _T("Integrated Circuit Systems Inc.")},
-    { 2669, /* 0x0A6D */ _T("UPS Manufacturing")},
-    { 2670, /* 0x0A6E */ _T("Benwin")},
-    { 2671, /* 0x0A6F */ _T("Core Technology, Inc.")},
-    { 2672, /* 0x0A70 */ _T("International Game Technology")},
-    { 2673, /* 0x0A71 */ _T("VIPColor Technologies USA, Inc.")},
-    { 2674, /* 0x0A72 */ _T("Sanwa Denshi")},
-    { 2685, /* 0x0A7D */ _T("NSTL, Inc.")},
-    { 2686, /* 0x0A7E */ _T("Octagon Systems Corporation")},
-    { 2687, /* 0x0A7F */ _T("AVerMedia MicroSystems")},
-    { 2688, /* 0x0A80 */ _T("Rexon Technology Corp., Ltd")},
-    { 2689, /* 0x0A81 */ _T("CHESEN ELECTRONICS CORP.")},
-    { 2690, /* 0x0A82 */ _T("SYSCAN")},
-    { 2691, /* 0x0A83 */ _T("NextComm, Inc.")},
-    { 2692, /* 0x0A84 */ _T("Maui Innovative Peripherals")},
-    { 2693, /* 0x0A85 */ _T("IDEXX LABS")},
-    { 2694, /* 0x0A86 */ _T("NITGen Co., Ltd.")},
-    { 2700, /* 0x0A8C */ _T("Tecmar")},
-    { 2701, /* 0x0A8D */ _T("Picturetel")},
-    { 2702, /* 0x0A8E */ _T("Japan Aviation Electronics Industry Ltd. (JAE)")},
-    { 2703, /* 0x0A8F */ _T("Young Chang Co. Ltd.")},
-    { 2704, /* 0x0A90 */ _T("Candy Technology Co., Ltd.")},
-    { 2705, /* 0x0A91 */ _T("Globlink Technology Inc.")},
-    { 2706, /* 0x0A92 */ _T("EGO SYStems Inc.")},
-    { 2707, /* 0x0A93 */ _T("C Technologies AB (publ)")},
-    { 2708, /* 0x0A94 */ _T("Intersense")},
-    { 2723, /* 0x0AA3 */ _T("Lava Computer Mfg. Inc.")},
-    { 2724, /* 0x0AA4 */ _T("Develco Elektronik")},
-    { 2725, /* 0x0AA5 */ _T("First International Digital")},
-    { 2726, /* 0x0AA6 */ _T("Perception Digital Limited")},
-    { 2727, /* 0x0AA7 */ _T("Wincor Nixdorf GmbH &Co KG")},
-    { 2728, /* 0x0AA8 */ _T("TriGem Computer, Inc.")},
-    { 2729, /* 0x0AA9 */ _T("Baromtec Co.")},
-    { 2730, /* 0x0AAA */ _T("Japan CBM Corporation")},
-    { 2731, /* 0x0AAB */ _T("Vision Shape Europe SA.")},
-    { 2732, /* 0x0AAC */ _T("iCompression Inc.")},
-    { 2733, /* 0x0AAD */ _T("Rohde & Schwarz GmbH & Co. KG")},
-    { 2734, /* 0x0AAE */ _T("Nitsuko Corporation")},
-    { 2735, /* 0x0AAF */ _T("digitalway co., ltd.")},
-    { 2736, /* 0x0AB0 */ _T("Arrow Strong Electronics CO. LTD")},
-    { 2755, /* 0x0AC3 */ _T("SANYO Semiconductor Company Micro")},
-    { 2756, /* 0x0AC4 */ _T("LECO CORPORATION")},
-    { 2757, /* 0x0AC5 */ _T("I & C Corporation")},
-    { 2758, /* 0x0AC6 */ _T("Singing Electrons, Inc.")},
-    { 2759, /* 0x0AC7 */ _T("Panwest Corporation")},
-    { 2764, /* 0x0ACC */ _T("Koga Electronics Co.")},
-    { 2765, /* 0x0ACD */ _T("ID Tech")},
-    { 2766, /* 0x0ACE */ _T("ZyDAS Technology Corporation")},
-    { 2767, /* 0x0ACF */ _T("Intoto, Inc.")},
-    { 2768, /* 0x0AD0 */ _T("Intellix Corp.")},
-    { 2769, /* 0x0AD1 */ _T("Remotec Technology Ltd.")},
-    { 2770, /* 0x0AD2 */ _T("Service & Quality Technology Co., Ltd.")},
-    { 2787, /* 0x0AE3 */ _T("Allion Computer Inc.")},
-    { 2788, /* 0x0AE4 */ _T("Taito Corporation")},
-    { 2789, /* 0x0AE5 */ _T("MacroSystem Digital Video AG")},
-    { 2790, /* 0x0AE6 */ _T("EVI, Inc.")},
-    { 2791, /* 0x0AE7 */ _T("Neodym Systems Inc.")},
-    { 2792, /* 0x0AE8 */ _T("System Support Co., Ltd.")},
-    { 2793, /* 0x0AE9 */ _T("North Shore Circuit Design L.L.P.")},
-    { 2794, /* 0x0AEA */ _T("SciEssence, LLC")},
-    { 2795, /* 0x0AEB */ _T("TTP Communications Ltd.")},
-    { 2796, /* 0x0AEC */ _T("Neodio Technologies Corporation")},
-    { 2806, /* 0x0AF6 */ _T("SILVER I CO., LTD.")},
-    { 2807, /* 0x0AF7 */ _T("B2C2, Inc.")},
-    { 2812, /* 0x0AFC */ _T("Zaptronix Ltd")},
-    { 2813, /* 0x0AFD */ _T("Tateno Dennou, Inc.")},
-    { 2814, /* 0x0AFE */ _T("Cummins Engine Company")},
-    { 2815, /* 0x0AFF */ _T("Jump Zone Network Products, Inc.")},
-    { 2816, /* 0x0B00 */ _T("INGENICO")},
-    { 2830, /* 0x0B0E */ _T("GN Netcom")},
-    { 2831, /* 0x0B0F */ _T("AVID Technology")},
-    { 2832, /* 0x0B10 */ _T("Pcally")},
-    { 2833, /* 0x0B11 */ _T("I Tech Solutions Co., Ltd.")},
-    { 2846, /* 0x0B1E */ _T("Electronic Warfare Assoc., Inc. (EWA)")},
-    { 2847, /* 0x0B1F */ _T("Insyde Software Corp.")},
-    { 2848, /* 0x0B20 */ _T("TransDimension Inc.")},
-    { 2849, /* 0x0B21 */ _T("Yokogawa Electric Corporation")},
-    { 2850, /* 0x0B22 */ _T("Japan System Development Co. Ltd.")},
-    { 2851, /* 0x0B23 */ _T("Pan-Asia Electronics Co., Ltd.")},
-    { 2852, /* 0x0B24 */ _T("Link Evolution Corp.")},
-    { 2855, /* 0x0B27 */ _T("Ritek Corporation")},
-    { 2856, /* 0x0B28 */ _T("Kenwood Corporation")},
-    { 2860, /* 0x0B2C */ _T("Village Center, Inc.")},
-    { 2864, /* 0x0B30 */ _T("NewHeights Software")},
-    { 2867, /* 0x0B33 */ _T("Contour Design, Inc.")},
-    { 2871, /* 0x0B37 */ _T("Hitachi ULSI Systems Co., Ltd.")},
-    { 2873, /* 0x0B39 */ _T("Omnidirectional Control Technology Inc.")},
-    { 2874, /* 0x0B3A */ _T("IPaxess")},
-    { 2875, /* 0x0B3B */ _T("Bromax Communications, Inc.")},
-    { 2876, /* 0x0B3C */ _T("Olivetti Techcenter")},
-    { 2881, /* 0x0B41 */ _T("Hal Corporation")},
-    { 2887, /* 0x0B47 */ _T("Sportbug.com, Inc")},
-    { 2888, /* 0x0B48 */ _T("TechnoTrend AG")},
-    { 2889, /* 0x0B49 */ _T("ASCII Corporation")},
-    { 2894, /* 0x0B4E */ _T("Musical Electronics Ltd.")},
-    { 2896, /* 0x0B50 */ _T("Dumpries Company Limited")},
-    { 2898, /* 0x0B52 */ _T("Colorado MicroDisplay, Inc")},
-    { 2900, /* 0x0B54 */ _T("Sinbon Electronics Co., Ltd.")},
-    { 2902, /* 0x0B56 */ _T("TYI Systems Ltd.")},
-    { 2903, /* 0x0B57 */ _T("Beijing HanwangTechnology Co. Ltd.")},
-    { 2905, /* 0x0B59 */ _T("Lake Communications Ltd.")},
-    { 2906, /* 0x0B5A */ _T("Corel Corporation")},
-    { 2911, /* 0x0B5F */ _T("Green Electronics Co., Ltd.")},
-    { 2912, /* 0x0B60 */ _T("Nsine Limited")},
-    { 2913, /* 0x0B61 */ _T("NEC Viewtechnology, Ltd.")},
-    { 2914, /* 0x0B62 */ _T("Orange Micro, Inc.")},
-    { 2915, /* 0x0B63 */ _T("ADLink Technology Inc.")},
-    { 2916, /* 0x0B64 */ _T("Wonderful Wire Cable Co., Ltd")},
-    { 2917, /* 0x0B65 */ _T("Expert Magnetics Corp.")},
-    { 2921, /* 0x0B69 */ _T("CasheVision")},
-    { 2922, /* 0x0B6A */ _T("Maxim Integrated Products")},
-    { 2927, /* 0x0B6F */ _T("Nagano Japan Radio Co., Ltd")},
-    { 2928, /* 0x0B70 */ _T("PortalPlayer, Inc")},
-    { 2929, /* 0x0B71 */ _T("SHIN-EI Sangyo Co., Ltd.")},
-    { 2930, /* 0x0B72 */ _T("Embedded Wireless Technology Co. Ltd.")},
-    { 2931, /* 0x0B73 */ _T("Computone Corp.")},
-    { 2937, /* 0x0B79 */ _T("Sunrise Telecom, Inc.")},
-    { 2938, /* 0x0B7A */ _T("Telencomm")},
-    { 2939, /* 0x0B7B */ _T("Taiko Denki Co., Ltd.")},
-    { 2940, /* 0x0B7C */ _T("ITRAN Communications Ltd.")},
-    { 2941, /* 0x0B7D */ _T("Astrodesign, Inc.")},
-    { 2948, /* 0x0B84 */ _T("Rextron Technology, Inc.")},
-    { 2949, /* 0x0B85 */ _T("Elkat Electronics (M) SDN. BHD.")},
-    { 2950, /* 0x0B86 */ _T("Exputer Systems, Inc.")},
-    { 2951, /* 0x0B87 */ _T("Plus-One I & T Inc.")},
-    { 2952, /* 0x0B88 */ _T("Sigma Koki Co., Ltd. Technology Center")},
-    { 2953, /* 0x0B89 */ _T("Advanced Digital Broadcast Ltd.")},
-    { 2965, /* 0x0B95 */ _T("ASIX Electronics Corp.")},
-    { 2966, /* 0x0B96 */ _T("SEWON TELECOM")},
-    { 2967, /* 0x0B97 */ _T("02 Micro, Inc.")},
-    { 2968, /* 0x0B98 */ _T("Playmates Toys Inc.")},
-    { 2969, /* 0x0B99 */ _T("Audio International, Inc.")},
-    { 2973, /* 0x0B9D */ _T("Softprotec Co.")},
-    { 2975, /* 0x0B9F */ _T("Chippo Technologies")},
-    { 2991, /* 0x0BAF */ _T("U.S. Robotics")},
-    { 2992, /* 0x0BB0 */ _T("Concord Camera Corp.")},
-    { 2993, /* 0x0BB1 */ _T("Infinilink Corporation")},
-    { 2994, /* 0x0BB2 */ _T("Ambit Microsystems Corporation")},
-    { 2995, /* 0x0BB3 */ _T("Ofuji Technology")},
-    { 2996, /* 0x0BB4 */ _T("High Tech Computer, Corp. (HTC)")},
-    { 2997, /* 0x0BB5 */ _T("Murata Manufacturing Co., Ltd.")},
-    { 2998, /* 0x0BB6 */ _T("Network Alchemy")},
-    { 2999, /* 0x0BB7 */ _T("Joytech Computer Company Limited")},
-    { 3000, /* 0x0BB8 */ _T("Hitachi Semiconductor and Devices Sales Co., Ltd.")},
-    { 3001, /* 0x0BB9 */ _T("Eiger M & C CO., LTD.")},
-    { 3002, /* 0x0BBA */ _T("ZACCESS Systems")},
-    { 3003, /* 0x0BBB */ _T("General Meters Corporation")},
-    { 3004, /* 0x0BBC */ _T("Assistive Technology, Inc.")},
-    { 3005, /* 0x0BBD */ _T("System Connection, Inc")},
-    { 3008, /* 0x0BC0 */ _T("Knilink Technology Inc.")},
-    { 3009, /* 0x0BC1 */ _T("FUW YNG ELECTRONICS COMPANY LTD")},
-    { 3010, /* 0x0BC2 */ _T("Seagate RSS LLC")},
-    { 3011, /* 0x0BC3 */ _T("IPWireless, Inc.")},
-    { 3012, /* 0x0BC4 */ _T("Microcube Corp.")},
-    { 3013, /* 0x0BC5 */ _T("JCN Co., Ltd.")},
-    { 3014, /* 0x0BC6 */ _T("ExWAY Inc.")},
-    { 3015, /* 0x0BC7 */ _T("X10 Wireless Technology, Inc.")},
-    { 3016, /* 0x0BC8 */ _T("Telmax Communications")},
-    { 3017, /* 0x0BC9 */ _T("ECI Telecom Ltd")},
-    { 3018, /* 0x0BCA */ _T("Startek Engineering Incorporated")},
-    { 3019, /* 0x0BCB */ _T("Perfect Technic Enterprise Co. LTD")},
-    { 3034, /* 0x0BDA */ _T("Realtek Semiconductor Corp.")},
-    { 3035, /* 0x0BDB */ _T("Ericsson Business Mobile Networks BV")},
-    { 3036, /* 0x0BDC */ _T("Y Media Corporation")},
-    { 3037, /* 0x0BDD */ _T("Orange PCS")},
-    { 3042, /* 0x0BE2 */ _T("Kanda Tsushin Kogyo Co., LTD")},
-    { 3043, /* 0x0BE3 */ _T("TOYO Corporation")},
-    { 3044, /* 0x0BE4 */ _T("Elka Taiwan LTD")},
-    { 3045, /* 0x0BE5 */ _T("DOME imaging systems, inc")},
-    { 3046, /* 0x0BE6 */ _T("Dong Guan Humen Wonderful Wire Cable Factory")},
-    { 3054, /* 0x0BEE */ _T("LTK Industries Ltd.")},
-    { 3055, /* 0x0BEF */ _T("Way2Call Communications")},
-    { 3056, /* 0x0BF0 */ _T("Pace Micro Technology PLC")},
-    { 3057, /* 0x0BF1 */ _T("Intracom S.A.")},
-    { 3058, /* 0x0BF2 */ _T("Konexx")},
-    { 3063, /* 0x0BF7 */ _T("Sunny Giken inc.")},
-    { 3064, /* 0x0BF8 */ _T("Fujitsu-Siemens-Computers")},
-    { 3076, /* 0x0C04 */ _T("MOTO Development Group, Inc.")},
-    { 3077, /* 0x0C05 */ _T("Appian Graphics")},
-    { 3078, /* 0x0C06 */ _T("Hasbro Games Inc.")},
-    { 3079, /* 0x0C07 */ _T("Infinite Data Storage LTD")},
-    { 3080, /* 0x0C08 */ _T("ei Corporation")},
-    { 3081, /* 0x0C09 */ _T("Comjet Information System")},
-    { 3082, /* 0x0C0A */ _T("Highpoint Technologies, Inc.")},
-    { 3083, /* 0x0C0B */ _T("Dura Micro, Inc.")},
-    { 3093, /* 0x0C15 */ _T("Iris Graphics")},
-    { 3094, /* 0x0C16 */ _T("Gyration, Inc.")},
-    { 3095, /* 0x0C17 */ _T("Cyberboard A/S")},
-    { 3096, /* 0x0C18 */ _T("SynerTek Korea, Inc.")},
-    { 3097, /* 0x0C19 */ _T("cyberPIXIE, Inc.")},
-    { 3098, /* 0x0C1A */ _T("Silicon Motion, Inc.")},
-    { 3099, /* 0x0C1B */ _T("MIPS TECHNOLOGIES")},
-    { 3100, /* 0x0C1C */ _T("Hang Zhou Silan Electronics Co. Ltd")},
-    { 3106, /* 0x0C22 */ _T("Tally Printer Corporation")},
-    { 3107, /* 0x0C23 */ _T("Lernout + Hauspie (L + H)")},
-    { 3109, /* 0x0C25 */ _T("SAMPO CORPORATION")},
-    { 3125, /* 0x0C35 */ _T("Eagletron Inc.")},
-    { 3126, /* 0x0C36 */ _T("E INK CORPORATION")},
-    { 3127, /* 0x0C37 */ _T("e.Digital")},
-    { 3128, /* 0x0C38 */ _T("Der An Electric Wire & Cable Co. Ltd.")},
-    { 3129, /* 0x0C39 */ _T("IFR")},
-    { 3130, /* 0x0C3A */ _T("Furui Precise Component (Kunshan) Co., Ltd")},
-    { 3131, /* 0x0C3B */ _T("Komatsu Ltd.")},
-    { 3132, /* 0x0C3C */ _T("Radius Co., Ltd.")},
-    { 3133, /* 0x0C3D */ _T("Innocom, Inc.")},
-    { 3134, /* 0x0C3E */ _T("NEXTCELL INC.")},
-    { 3140, /* 0x0C44 */ _T("Motorola iDEN")},
-    { 3141, /* 0x0C45 */ _T("Sonix Technology Co., Ltd.")},
-    { 3154, /* 0x0C52 */ _T("Sealevel Systems, Inc.")},
-    { 3155, /* 0x0C53 */ _T("ViewPLUS Inc.")},
-    { 3156, /* 0x0C54 */ _T("GLORY LTD.")},
-    { 3157, /* 0x0C55 */ _T("Spectrum Digital Inc.")},
-    { 3158, /* 0x0C56 */ _T("Billion Bright Limited")},
-    { 3159, /* 0x0C57 */ _T("Imaginative Design Operation Co. Ltd.")},
-    { 3160, /* 0x0C58 */ _T("Vidar Systems Corporation")},
-    { 3162, /* 0x0C5A */ _T("TRS International Mfg., Inc.")},
-    { 4268, /* 0x10AC */ _T("Honeywell, Inc.")},
-    { 4496, /* 0x1190 */ _T("Tripace")},
-    { 4622, /* 0x120E */ _T("HUDSON SOFT CO., LTD.")},
-    { 5480, /* 0x1568 */ _T("Sunf Pu Technology Co., Ltd")},
-    { 5638, /* 0x1606 */ _T("UMAX Data Systems Inc.")},
-    { 5640, /* 0x1608 */ _T("Inside Out Networks")},
-    { 5736, /* 0x1668 */ _T("Actiontec Electronics, Inc.")},
-    { 5782, /* 0x1696 */ _T("Hitachi Video and Information System, Inc.")},
-    { 7867, /* 0x1EBB */ _T("NuCORE Technology, Inc.")},
-    { 8888, /* 0x22B8 */ _T("Motorola PCS")},
-    { 8890, /* 0x22BA */ _T("Technology Innovation International Co., Ltd.")},
-    { 8964, /* 0x2304 */ _T("Pinnacle Systems, Inc.")},
-    {10393, /* 0x2899 */ _T("Toptronic Industrial Co., Ltd.")},
-    {13878, /* 0x3636 */ _T("INVIBRO")},
-    {14627, /* 0x3923 */ _T("National Instruments")},
-    {16700, /* 0x413C */ _T("Dell Computer Corp.")},
-    {21827, /* 0x5543 */ _T("UC-Logic Technology Corp.")},
-    {21930, /* 0x55AA */ _T("OnSpec Electronic Inc.")},
-    {25452, /* 0x636C */ _T("CoreLogic, Inc.")},
-    {27253, /* 0x6A75 */ _T("Shanghai Jujo Electronics Co., Ltd.")},
-    {32902, /* 0x8086 */ _T("Intel Corporation")},
-    { 0x00, _T("End")}
-};
-
-#endif /* __VNDRLIST_H__ */
-
+USB_VENDOR(0x03E8, "EndPoints Inc.")
+USB_VENDOR(0x03E9, "Thesys Microelectronics")
+USB_VENDOR(0x03EB, "Atmel Corporation")
+USB_VENDOR(0x03EE, "Mitsumi")
+USB_VENDOR(0x03F0, "Hewlett Packard")
+USB_VENDOR(0x03F2, "Oak Technology, Inc")
+USB_VENDOR(0x03F3, "Adaptec, Inc.")
+USB_VENDOR(0x03F4, "Diebold, Inc.")
+USB_VENDOR(0x03F9, "KeyTronic Corp.")
+USB_VENDOR(0x03FB, "OPTi Inc.")
+USB_VENDOR(0x03FE, "Farallon Comunications")
+USB_VENDOR(0x0400, "National Semiconductor")
+USB_VENDOR(0x0402, "Acer Labs Inc.")
+USB_VENDOR(0x0403, "Future Technology Devices International Limited")
+USB_VENDOR(0x0404, "NCR Corporation")
+USB_VENDOR(0x0405, "inSilicon")
+USB_VENDOR(0x0409, "NEC Corporation")
+USB_VENDOR(0x040A, "Kodak Co.")
+USB_VENDOR(0x040B, "Weltrend Semiconductor")
+USB_VENDOR(0x040D, "VIA Technologies, Inc.")
+USB_VENDOR(0x040E, "MCCI")
+USB_VENDOR(0x0411, "Melco, Inc.")
+USB_VENDOR(0x0416, "Winbond Electronics Corp.")
+USB_VENDOR(0x041A, "Phoenix Technologies Ltd.")
+USB_VENDOR(0x041E, "Creative Labs")
+USB_VENDOR(0x0421, "Nokia Mobile Phones")
+USB_VENDOR(0x0422, "ADI Systems Inc.")
+USB_VENDOR(0x0423, "CATC")
+USB_VENDOR(0x0424, "Standard Microsystems Corp.")
+USB_VENDOR(0x0425, "Motorola Semiconductors HK, Ltd.")
+USB_VENDOR(0x0429, "Cirrus Logic Inc.")
+USB_VENDOR(0x042C, "Innovative Semiconductors, Inc.")
+USB_VENDOR(0x0430, "Fujitsu Takamisawa America")
+USB_VENDOR(0x0432, "Unisys Corp.")
+USB_VENDOR(0x0436, "Taugagreining HF")
+USB_VENDOR(0x0438, "Advanced Micro Devices")
+USB_VENDOR(0x043D, "Lexmark International Inc.")
+USB_VENDOR(0x043E, "LG Electronics USA Inc.")
+USB_VENDOR(0x0440, "EIZO NANAO CORPORATION")
+USB_VENDOR(0x0443, "Gateway 2000")
+USB_VENDOR(0x0445, "Lucent Technologies")
+USB_VENDOR(0x0446, "NMB Technologies, Inc.")
+USB_VENDOR(0x044E, "Alps Electric Co., Ltd.")
+USB_VENDOR(0x044F, "ThrustMaster, Inc.")
+USB_VENDOR(0x0451, "Texas Instruments")
+USB_VENDOR(0x0452, "Mitsubishi Electric & Electronics US, Inc.")
+USB_VENDOR(0x0456, "Analog Devices, Inc.")
+USB_VENDOR(0x0457, "Silicon Integrated Systems Corp.")
+USB_VENDOR(0x045A, "Diamond Multimedia Systems")
+USB_VENDOR(0x045B, "Hitachi, Ltd (2)")
+USB_VENDOR(0x045E, "Microsoft Corporation")
+USB_VENDOR(0x0461, "Primax Electronics")
+USB_VENDOR(0x0463, "MGE UPS Systems")
+USB_VENDOR(0x0464, "AMP/Tycoelectronics")
+USB_VENDOR(0x0468, "Wieson Electronic Co., Ltd.")
+USB_VENDOR(0x046A, "Cherry GMBH")
+USB_VENDOR(0x046C, "Toshiba Corporation, Digital Media Equipment")
+USB_VENDOR(0x046D, "Logitech Inc.")
+USB_VENDOR(0x046E, "Behavior Tech. Computer Corporation")
+USB_VENDOR(0x0471, "Philips")
+USB_VENDOR(0x0472, "Sun Microsystems")
+USB_VENDOR(0x0474, "Sanyo Electric Co. Ltd.")
+USB_VENDOR(0x0475, "TECO Electric & Machinery Co., Ltd.")
+USB_VENDOR(0x047A, "USAR Systems Incorporated")
+USB_VENDOR(0x047B, "Silitek Corp.")
+USB_VENDOR(0x047D, "Kensington")
+USB_VENDOR(0x047E, "Lucent Microelectronics Technologies")
+USB_VENDOR(0x047F, "Plantronics, Inc.")
+USB_VENDOR(0x0482, "Kyocera Tech. Development, Inc.")
+USB_VENDOR(0x0483, "STMicroelectronics")
+USB_VENDOR(0x0488, "Cirque Corporation")
+USB_VENDOR(0x0489, "Foxconn / Hon Hai")
+USB_VENDOR(0x048D, "Integrated Technology Express")
+USB_VENDOR(0x0491, "Capetronic Kaohsiung Corp.")
+USB_VENDOR(0x0492, "Samsung SemiConductor, Inc.")
+USB_VENDOR(0x0496, "Micron Electronics")
+USB_VENDOR(0x0497, "Smile International, Inc.")
+USB_VENDOR(0x0499, "Yamaha Corporation")
+USB_VENDOR(0x049B, "Curtis Computer Products")
+USB_VENDOR(0x049F, "Compaq Computer Corporation")
+USB_VENDOR(0x04A4, "Hitachi, Ltd.")
+USB_VENDOR(0x04A5, "Acer Communications & Multimedia Inc.")
+USB_VENDOR(0x04A8, "Multivideo Labs, Inc.")
+USB_VENDOR(0x04A9, "Canon Inc. (Kosugi Office)")
+USB_VENDOR(0x04B1, "Pan International")
+USB_VENDOR(0x04B3, "IBM Corporation")
+USB_VENDOR(0x04B4, "Cypress Semiconductor")
+USB_VENDOR(0x04B5, "ROHM LSI Systems USA, LLC")
+USB_VENDOR(0x04B7, "Compal Electronics, Inc.")
+USB_VENDOR(0x04B8, "Seiko Epson Corp.")
+USB_VENDOR(0x04B9, "Rainbow Technologies, Inc.")
+USB_VENDOR(0x04BB, "I-O Data Device, Inc.")
+USB_VENDOR(0x04BF, "TDK Corporation")
+USB_VENDOR(0x04C5, "Fujitsu Ltd.")
+USB_VENDOR(0x04C8, "Konica Corporation")
+USB_VENDOR(0x04CB, "Fuji Photo Film Co., Ltd.")
+USB_VENDOR(0x04CC, "Philips Semiconductors")
+USB_VENDOR(0x04CE, "ScanLogic Corporation")
+USB_VENDOR(0x04CF, "Myson Technology Inc.")
+USB_VENDOR(0x04D4, "LSI Logic Corporation")
+USB_VENDOR(0x04D6, "Mentor Graphics")
+USB_VENDOR(0x04D7, "Oki Semiconductor")
+USB_VENDOR(0x04D8, "Microchip Technology Inc.")
+USB_VENDOR(0x04D9, "Holtek Semiconductor, Inc.")
+USB_VENDOR(0x04DA, "Panasonic (Matsushita)")
+USB_VENDOR(0x04DD, "Sharp Corporation")
+USB_VENDOR(0x04DE, "MindShare, Inc.")
+USB_VENDOR(0x04E6, "SCM Microsystems")
+USB_VENDOR(0x04E7, "Elo TouchSystems")
+USB_VENDOR(0x04E9, "PC-Tel,  Inc.")
+USB_VENDOR(0x04EA, "Sipex Corporation")
+USB_VENDOR(0x04EB, "Northstar Systems, Inc.")
+USB_VENDOR(0x04EC, "Tokyo Electron Device Limited")
+USB_VENDOR(0x04ED, "Annabooks")
+USB_VENDOR(0x04F1, "Victor Company of Japan, Limited")
+USB_VENDOR(0x04F2, "Chicony Electronics Co., Ltd.")
+USB_VENDOR(0x04F3, "Elan Microelectronics Corportation")
+USB_VENDOR(0x04F7, "Newnex Technology Corp.")
+USB_VENDOR(0x04F8, "FuturePlus Systems")
+USB_VENDOR(0x04FA, "Dallas Semiconductor")
+USB_VENDOR(0x04FC, "SUNPLUS TECHNOLOGY CO., LTD.")
+USB_VENDOR(0x04FD, "Soliton Systems K.K.")
+USB_VENDOR(0x04FF, "E-CMOS Corp.")
+USB_VENDOR(0x0501, "FAI/DDK Connector Division")
+USB_VENDOR(0x0502, "Acer, Inc.")
+USB_VENDOR(0x0506, "3Com Corporation")
+USB_VENDOR(0x0507, "Hosiden Corporation")
+USB_VENDOR(0x0509, "Aztech Systems Ltd")
+USB_VENDOR(0x050D, "Belkin Components")
+USB_VENDOR(0x050F, "KC Technology Inc.")
+USB_VENDOR(0x0510, "Sejin Electron Inc.")
+USB_VENDOR(0x0514, "FCI Electronics")
+USB_VENDOR(0x0516, "Longwell Electronics/Longwell Company")
+USB_VENDOR(0x051C, "Shuttle Inc.")
+USB_VENDOR(0x051D, "American Power Conversion")
+USB_VENDOR(0x051F, "IO Systems Inc. fomerly Elite Electronics, Inc.")
+USB_VENDOR(0x0522, "Advanced Connectek USA Inc.")
+USB_VENDOR(0x0525, "Netchip Technology Inc.")
+USB_VENDOR(0x0526, "Temic MHS S.A.")
+USB_VENDOR(0x0528, "ATI Technologies, Inc.")
+USB_VENDOR(0x0529, "Aladdin Knowledge Systems")
+USB_VENDOR(0x052A, "Crescent Heart Software")
+USB_VENDOR(0x052B, "Tekom Technologies, Inc")
+USB_VENDOR(0x052C, "Canon Information Systems, Inc.")
+USB_VENDOR(0x0531, "Wacom Technology Corp.")
+USB_VENDOR(0x0537, "Inventec Corporation")
+USB_VENDOR(0x0539, "Shyh Shiun Terminals Co. LTD")
+USB_VENDOR(0x053A, "Preh Werke Gmbh & Co. KG")
+USB_VENDOR(0x053E, "Mobility Electronics")
+USB_VENDOR(0x053F, "Synopsys, Inc.")
+USB_VENDOR(0x0543, "ViewSonic Corporation")
+USB_VENDOR(0x0545, "Xirlink, Inc.")
+USB_VENDOR(0x0546, "Polaroid Corporation")
+USB_VENDOR(0x054A, "Fujitsu Microelectronics, Inc.")
+USB_VENDOR(0x054C, "Sony Corporation")
+USB_VENDOR(0x0550, "Fuji Xerox Co., Ltd.")
+USB_VENDOR(0x0553, "STMicroelectronics Imaging Division")
+USB_VENDOR(0x0556, "Asahi Kasei Microsystems Co., Ltd")
+USB_VENDOR(0x0557, "ATEN International Co. Ltd.")
+USB_VENDOR(0x0559, "Cadence Design Systems, Inc.")
+USB_VENDOR(0x055D, "Samsung Electro-Mechanics Co.")
+USB_VENDOR(0x055E, "Optoma Corporation")
+USB_VENDOR(0x0562, "Telex Communications Inc.")
+USB_VENDOR(0x0563, "Immersion Corporation")
+USB_VENDOR(0x0564, "Chinon Industries, Inc.")
+USB_VENDOR(0x056A, "WACOM Co., Ltd.")
+USB_VENDOR(0x056C, "e-TEK Labs")
+USB_VENDOR(0x056E, "Elecom Co., Ltd.")
+USB_VENDOR(0x056F, "Korea Data Systems Co., Ltd.")
+USB_VENDOR(0x0571, "XLR8, Inc.")
+USB_VENDOR(0x0572, "Conexant Systems, Inc.")
+USB_VENDOR(0x0573, "Nogatech Ltd.")
+USB_VENDOR(0x0575, "Philips Creative Display Solutions")
+USB_VENDOR(0x0576, "BAFO/Quality Computer Accessories")
+USB_VENDOR(0x057B, "Y-E Data, Inc.")
+USB_VENDOR(0x057C, "AVM GmbH")
+USB_VENDOR(0x057D, "Shark Multimedia Inc.")
+USB_VENDOR(0x057E, "Nintendo Co., Ltd.")
+USB_VENDOR(0x0582, "Roland Corporation")
+USB_VENDOR(0x0583, "Padix Co., Ltd.")
+USB_VENDOR(0x0584, "RATOC System Inc.")
+USB_VENDOR(0x0585, "FlashPoint Technology, Inc.")
+USB_VENDOR(0x058B, "Infineon Technologies")
+USB_VENDOR(0x058C, "In Focus Systems")
+USB_VENDOR(0x058D, "Micrel Semiconductor")
+USB_VENDOR(0x058F, "Alcor Micro, Inc.")
+USB_VENDOR(0x0590, "OMRON Corporation")
+USB_VENDOR(0x0592, "Powerware Corporation")
+USB_VENDOR(0x0595, "Zoran Microelectronics Ltd.")
+USB_VENDOR(0x0596, "MicroTouch Systems Inc.")
+USB_VENDOR(0x0598, "Niigata Canotec Co., Inc.")
+USB_VENDOR(0x059B, "Iomega Corporation")
+USB_VENDOR(0x059D, "Advanced Input Devices")
+USB_VENDOR(0x059E, "Intelligent Instrumentation")
+USB_VENDOR(0x059F, "LaCie")
+USB_VENDOR(0x05A2, "Fuji Film Microdevices Co. Ltd.")
+USB_VENDOR(0x05A3, "V Automation Inc.")
+USB_VENDOR(0x05A4, "Ortek Technology, Inc.")
+USB_VENDOR(0x05A6, "Cisco Systems, Inc.")
+USB_VENDOR(0x05A9, "OmniVision Technologies, Inc.")
+USB_VENDOR(0x05AB, "In-System Design")
+USB_VENDOR(0x05AC, "Apple Computer")
+USB_VENDOR(0x05AD, "Y.C.Cable U.S.A., Inc")
+USB_VENDOR(0x05B0, "Fountain Technologies, Inc")
+USB_VENDOR(0x05B4, "HYUNDAI Electronics Industries Co., Ltd.")
+USB_VENDOR(0x05BA, "DigitalPersona, Inc.")
+USB_VENDOR(0x05BD, "RAFI GmbH & Co. KG")
+USB_VENDOR(0x05BE, "Raychem Corporation")
+USB_VENDOR(0x05C0, "Keil Software")
+USB_VENDOR(0x05C1, "Kawasaki Steel")
+USB_VENDOR(0x05C5, "Digi International Inc.")
+USB_VENDOR(0x05C6, "Qualcomm, Inc")
+USB_VENDOR(0x05C7, "Qtronix Corp")
+USB_VENDOR(0x05C8, "Cheng Uei Precision Industry Co., Ltd")
+USB_VENDOR(0x05CA, "Ricoh Company Ltd.")
+USB_VENDOR(0x05CB, "PowerVision Technologies Inc.")
+USB_VENDOR(0x05CD, "Silicom LTD.")
+USB_VENDOR(0x05CE, "Sican GmbH")
+USB_VENDOR(0x05CF, "Sung Forn Co. LTD.")
+USB_VENDOR(0x05D0, "Lunar Corporation")
+USB_VENDOR(0x05D1, "Brainboxes Limited")
+USB_VENDOR(0x05D8, "Ultima Electronics Corp.")
+USB_VENDOR(0x05D9, "Axiohm Transaction Solutions")
+USB_VENDOR(0x05DA, "Microtek International Inc.")
+USB_VENDOR(0x05DB, "Sun Corporation")
+USB_VENDOR(0x05DC, "Lexar Media, Inc.")
+USB_VENDOR(0x05DD, "Delta Electronics Inc.")
+USB_VENDOR(0x05E0, "Symbol Technologies")
+USB_VENDOR(0x05E3, "Genesys Logic, Inc.")
+USB_VENDOR(0x05E5, "Fuji Electric Co., Ltd.")
+USB_VENDOR(0x05E6, "Keithley Instruments")
+USB_VENDOR(0x05E9, "Kawasaki LSI")
+USB_VENDOR(0x05EF, "Anko Electronic Co., Ltd.")
+USB_VENDOR(0x05F0, "Canopus Co., Ltd.")
+USB_VENDOR(0x05F3, "PI Engineering, Inc")
+USB_VENDOR(0x05F5, "Unixtar Technology Inc.")
+USB_VENDOR(0x05F7, "Silicon Portals Inc.")
+USB_VENDOR(0x05F9, "PSC Scanning, Inc.")
+USB_VENDOR(0x05FD, "STD Manufacturing Ltd.")
+USB_VENDOR(0x05FE, "CHIC TECHNOLOGY CORP")
+USB_VENDOR(0x05FF, "LeCroy Corporation")
+USB_VENDOR(0x0601, "Jazz Hipster Corporation")
+USB_VENDOR(0x0602, "Vista Imaging Inc.")
+USB_VENDOR(0x0603, "Novatek Microelectronics Corp.")
+USB_VENDOR(0x0604, "Jean Co, Ltd.")
+USB_VENDOR(0x0607, "Bridge Information Co., Ltd.")
+USB_VENDOR(0x0609, "SMK Manufacturing Inc.")
+USB_VENDOR(0x060A, "Worth Data, Inc.")
+USB_VENDOR(0x060F, "Joinsoon Electronics Mfg. Co., Ltd.")
+USB_VENDOR(0x0611, "Totoku Electric Co., LTD.")
+USB_VENDOR(0x0613, "TransAct Technologies Incorporated")
+USB_VENDOR(0x0614, "Bio-Rad Laboratories")
+USB_VENDOR(0x0616, "Future Techno Designs PVT. LTD.")
+USB_VENDOR(0x0619, "Seiko Instruments Inc.")
+USB_VENDOR(0x061C, "Act Labs, Ltd.")
+USB_VENDOR(0x061D, "Quatech, Inc.")
+USB_VENDOR(0x061E, "Nissei Electric Co.")
+USB_VENDOR(0x0620, "Alaris, Inc.")
+USB_VENDOR(0x0621, "ODU-Steckverbindungssysteme GmbH & Co. KG")
+USB_VENDOR(0x0623, "Littelfuse, Inc.")
+USB_VENDOR(0x0624, "Avocent Corporation")
+USB_VENDOR(0x0626, "Nippon Systems Development Co., Ltd.")
+USB_VENDOR(0x0629, "Zida Technologies Limited")
+USB_VENDOR(0x062B, "Greatlink Electronics Taiwan  Ltd.")
+USB_VENDOR(0x062D, "Taiwan Tai-Hao Enterprises Co. Ltd.")
+USB_VENDOR(0x062E, "Mainsuper Enterprises Co., Ltd.")
+USB_VENDOR(0x062F, "Sin Sheng Terminal & Machine Inc.")
+USB_VENDOR(0x0634, "Micron Technology, Inc.")
+USB_VENDOR(0x0636, "Sierra Imaging, Inc.")
+USB_VENDOR(0x0638, "Avision, Inc.")
+USB_VENDOR(0x0640, "Hitex Development Tools")
+USB_VENDOR(0x0641, "Woods Industries, Inc.")
+USB_VENDOR(0x0644, "TEAC Corporation")
+USB_VENDOR(0x0645, "Ethentica Inc.")
+USB_VENDOR(0x064B, "White Mountain DSP, Inc.")
+USB_VENDOR(0x064C, "Ji-Haw Industrial Co., Ltd")
+USB_VENDOR(0x064F, "WIBU-Systems AG")
+USB_VENDOR(0x0651, "Likom Technology Sdn. Bhd.")
+USB_VENDOR(0x0652, "Stargate Solutions, Inc.")
+USB_VENDOR(0x0654, "Granite Microsystems, Inc.")
+USB_VENDOR(0x0655, "Space Shuttle Hi-Tech Co.,Ltd.")
+USB_VENDOR(0x0656, "Glory Mark Electronic Ltd.")
+USB_VENDOR(0x0657, "Tekcon American Corp.")
+USB_VENDOR(0x065A, "Optoelectronics Co., Ltd.")
+USB_VENDOR(0x065F, "Good Way Industrial Co, Ltd & GWC Technology Inc.")
+USB_VENDOR(0x0660, "TSAY-E (BVI) International Inc.")
+USB_VENDOR(0x0661, "Hamamatsu Photonics K.K.")
+USB_VENDOR(0x0663, "Topmax Electronic Co., Ltd.")
+USB_VENDOR(0x0669, "Oce' Printing Systems GmbH")
+USB_VENDOR(0x066A, "Total Technologies, Ltd.")
+USB_VENDOR(0x066F, "SigmaTel, Inc.")
+USB_VENDOR(0x0672, "Labtec Inc.")
+USB_VENDOR(0x0674, "Key Mouse Electronic Enterprise Co., Ltd.")
+USB_VENDOR(0x0675, "DrayTek Corp.")
+USB_VENDOR(0x0676, "Teles AG")
+USB_VENDOR(0x0678, "ACARD Technology Corp.")
+USB_VENDOR(0x067B, "Prolific Technology, Inc.")
+USB_VENDOR(0x067C, "Efficient Networks, Inc.")
+USB_VENDOR(0x067E, "Intermec")
+USB_VENDOR(0x067F, "Virata Ltd.")
+USB_VENDOR(0x0680, "Avance Logic, Inc.")
+USB_VENDOR(0x0681, "Siemens Information and Communication Products")
+USB_VENDOR(0x0686, "Minolta Co., Ltd.")
+USB_VENDOR(0x068A, "Pertech Inc.")
+USB_VENDOR(0x0690, "Golden Bridge Electech Inc.")
+USB_VENDOR(0x0693, "Hagiwara Sys-Com Co., Ltd.")
+USB_VENDOR(0x0694, "The LEGO Company")
+USB_VENDOR(0x0698, "Chuntex (CTX)")
+USB_VENDOR(0x0699, "Tektronix, Inc.")
+USB_VENDOR(0x069A, "Askey Computer Corporation")
+USB_VENDOR(0x069B, "Thomson Consumer Electronics")
+USB_VENDOR(0x069D, "Hughes Network Systems (HNS)")
+USB_VENDOR(0x06A2, "Topro Technology Inc.")
+USB_VENDOR(0x06A3, "Saitek PLC")
+USB_VENDOR(0x06A5, "Divio")
+USB_VENDOR(0x06A9, "Westell")
+USB_VENDOR(0x06AA, "Sysgration Ltd.")
+USB_VENDOR(0x06AC, "Fujitsu PC Corporation")
+USB_VENDOR(0x06AE, "Professional Multimedia Testing Centre")
+USB_VENDOR(0x06B8, "Pixela Corproation")
+USB_VENDOR(0x06B9, "Alcatel Telecom")
+USB_VENDOR(0x06BA, "Smooth Cord & Connector Co., Ltd.")
+USB_VENDOR(0x06BB, "EDA Inc.")
+USB_VENDOR(0x06BC, "Oki Data Corporation")
+USB_VENDOR(0x06BD, "AGFA-Gevaert NV")
+USB_VENDOR(0x06BF, "Leoco Corporation")
+USB_VENDOR(0x06C4, "Bizlink International Corporation")
+USB_VENDOR(0x06C8, "SIIG, Inc.")
+USB_VENDOR(0x06CC, "Terayon Communication Systems")
+USB_VENDOR(0x06CD, "Keyspan")
+USB_VENDOR(0x06D3, "Mitsubishi Electric Corporation")
+USB_VENDOR(0x06DA, "Phoenixtec Power Co., Ltd.")
+USB_VENDOR(0x06DB, "Paradyne")
+USB_VENDOR(0x06DC, "Compeye Corporation")
+USB_VENDOR(0x06DE, "Heisei Electronics Co. Ltd.")
+USB_VENDOR(0x06E0, "Multi-Tech Systems, Inc.")
+USB_VENDOR(0x06E4, "Alcatel Microelectronics")
+USB_VENDOR(0x06E6, "Tiger Jet Network, Inc.")
+USB_VENDOR(0x06F2, "Machkey  International (USA)")
+USB_VENDOR(0x06FD, "Boston Acoustics")
+USB_VENDOR(0x0701, "Supercomal Wire & Cable SDN. BHD.")
+USB_VENDOR(0x0705, "NKK Corporation")
+USB_VENDOR(0x0709, "Parthus Technologies")
+USB_VENDOR(0x070A, "Oki Electric Industry Co., Ltd")
+USB_VENDOR(0x070D, "Comoss Electronic Co., Ltd.")
+USB_VENDOR(0x0710, "Connect Tech Inc.")
+USB_VENDOR(0x0711, "Magic Control Technology Corp.")
+USB_VENDOR(0x0718, "Imation Corp.")
+USB_VENDOR(0x0719, "Tremon Enterprises Co., Ltd.")
+USB_VENDOR(0x071D, "Eicon Technology Corporation")
+USB_VENDOR(0x0723, "Centillium Communications Corporation")
+USB_VENDOR(0x0726, "Vanguard International Semiconductor-America")
+USB_VENDOR(0x0731, "SusTeen, Inc.")
+USB_VENDOR(0x0733, "ViewQuest Technologies, Inc.")
+USB_VENDOR(0x0734, "LASAT Communications A/S")
+USB_VENDOR(0x0738, "Mad Catz, Inc.")
+USB_VENDOR(0x0746, "ONKYO Corporation")
+USB_VENDOR(0x0748, "Strong Man Enterprise Co., Ltd.")
+USB_VENDOR(0x074C, "C-C-C Group PLC")
+USB_VENDOR(0x074D, "Micronas GmbH")
+USB_VENDOR(0x074E, "Digital Stream Corporation")
+USB_VENDOR(0x0757, "Network Technologies, Inc.")
+USB_VENDOR(0x0764, "Cyber Power System, Inc.")
+USB_VENDOR(0x0765, "X-Rite Incorporated")
+USB_VENDOR(0x0768, "Camtel Technology Corp.")
+USB_VENDOR(0x0769, "Surecom Technology Corp.")
+USB_VENDOR(0x076A, "Conceptual Systems")
+USB_VENDOR(0x076B, "OMNIKEY AG")
+USB_VENDOR(0x076C, "Partner Tech")
+USB_VENDOR(0x076D, "Denso Corporation")
+USB_VENDOR(0x0776, "Inalways Corporation")
+USB_VENDOR(0x0777, "Comda Enterprise Corporation")
+USB_VENDOR(0x0779, "Fairchild Semiconductor")
+USB_VENDOR(0x077A, "Sankyo Seiki Mfg. Co., Ltd.")
+USB_VENDOR(0x077B, "Linksys")
+USB_VENDOR(0x077C, "Forward Electronics Co., Ltd.")
+USB_VENDOR(0x0781, "SanDisk Corporation")
+USB_VENDOR(0x0782, "Trackerball")
+USB_VENDOR(0x0789, "Logitec Corporation")
+USB_VENDOR(0x078E, "Brimax Inc.")
+USB_VENDOR(0x0790, "Pro-Image Manufacturing Co., Ltd")
+USB_VENDOR(0x0791, "Copartner Wire and Cable Mfg. Corp.")
+USB_VENDOR(0x0792, "Axis Communications AB")
+USB_VENDOR(0x0793, "Wha Yu Industrial Co., Ltd.")
+USB_VENDOR(0x0794, "ABL Electronics Corporation")
+USB_VENDOR(0x0795, "RealChip Inc.")
+USB_VENDOR(0x0796, "Certicom Corp.")
+USB_VENDOR(0x0797, "Grandtech Semiconductor Corporation")
+USB_VENDOR(0x079D, "Alfadata Computer Corp.")
+USB_VENDOR(0x07A2, "National Technical Systems")
+USB_VENDOR(0x07A3, "ONNTO Corp.")
+USB_VENDOR(0x07A4, "Be Incorporated")
+USB_VENDOR(0x07A6, "ADMtek Incorporated")
+USB_VENDOR(0x07AA, "correga K.K.")
+USB_VENDOR(0x07AB, "Freecom Technologies")
+USB_VENDOR(0x07B1, "IMP, Inc.")
+USB_VENDOR(0x07B3, "Plustek, Inc.")
+USB_VENDOR(0x07B4, "Olympus Optical Co., Ltd.")
+USB_VENDOR(0x07B5, "Mega World International Ltd.")
+USB_VENDOR(0x07B6, "Marubun Corp.")
+USB_VENDOR(0x07B7, "TIME Interconect Ltd.")
+USB_VENDOR(0x07B8, "AboCom Systems, Inc.")
+USB_VENDOR(0x07BC, "Canon Computer Sytems, Inc.")
+USB_VENDOR(0x07BE, "Veridicom")
+USB_VENDOR(0x07C4, "Datafab Systems Inc.")
+USB_VENDOR(0x07C5, "APG Cash Drawer")
+USB_VENDOR(0x07C6, "Share Wave, Inc.")
+USB_VENDOR(0x07C7, "Powertech Industrial Co., Ltd.")
+USB_VENDOR(0x07C9, "Allied Telesyn International")
+USB_VENDOR(0x07CB, "Kingmax Technology Inc.")
+USB_VENDOR(0x07CC, "Carry Computer Eng., Co., Ltd.")
+USB_VENDOR(0x07D3, "Cyberdata Corp.")
+USB_VENDOR(0x07D7, "GCC Technologies, Inc.")
+USB_VENDOR(0x07DA, "Arasan Chip Systems")
+USB_VENDOR(0x07DF, "David Electronics Company, Ltd.")
+USB_VENDOR(0x07E2, "Elmeg GmbH & Co., Ltd.")
+USB_VENDOR(0x07E3, "Planex Communications, Inc.")
+USB_VENDOR(0x07E4, "Movado Enterprise Co., Ltd.")
+USB_VENDOR(0x07E5, "QPS, Inc.")
+USB_VENDOR(0x07E6, "Allied Cable Corporation")
+USB_VENDOR(0x07E8, "Labsystems")
+USB_VENDOR(0x07EA, "Iwatsu Electric Co., Ltd.")
+USB_VENDOR(0x07EB, "Double-H Technology Co., Ltd.")
+USB_VENDOR(0x07EC, "Taiyo Electrical Wire & Cable Co., Ltd.")
+USB_VENDOR(0x07F7, "Century Corporation")
+USB_VENDOR(0x07F9, "Dotop Technology, Inc.")
+USB_VENDOR(0x0801, "Mag-Tek")
+USB_VENDOR(0x0802, "Infineer Inc.")
+USB_VENDOR(0x0803, "Zoom Telephonics, Inc.")
+USB_VENDOR(0x0809, "Genicom Corp.")
+USB_VENDOR(0x080A, "Evermuch Technology Co., Ltd.")
+USB_VENDOR(0x080D, "TECO Image Systems Co., Ltd.")
+USB_VENDOR(0x0810, "Personal Communication Systems, Inc.")
+USB_VENDOR(0x0813, "Mattel, Inc.")
+USB_VENDOR(0x081E, "AlphaSmart, Inc.")
+USB_VENDOR(0x0822, "REUDO Corporation")
+USB_VENDOR(0x0826, "Data Transit")
+USB_VENDOR(0x0827, "BroadLogic, Inc.")
+USB_VENDOR(0x0828, "Sato Corporation")
+USB_VENDOR(0x0829, "Telocity, Inc")
+USB_VENDOR(0x0830, "Palm Inc.")
+USB_VENDOR(0x0832, "Kouwell Electronics Corp.")
+USB_VENDOR(0x0833, "Sourcenext Corporation")
+USB_VENDOR(0x0835, "Action Star Enterprise Co., Ltd.")
+USB_VENDOR(0x0839, "Samsung Techwin")
+USB_VENDOR(0x083A, "Accton Technology Corporation")
+USB_VENDOR(0x0846, "NETGEAR, Inc.")
+USB_VENDOR(0x084D, "Minton Optic Industry Co., Ltd.")
+USB_VENDOR(0x0851, "Macronix International Co., Ltd.")
+USB_VENDOR(0x0852, "CSEM")
+USB_VENDOR(0x0858, "Hitachi Maxell Ltd.")
+USB_VENDOR(0x0859, "Minolta Systems Laboratory, Inc.")
+USB_VENDOR(0x085A, "Xircom")
+USB_VENDOR(0x086A, "Emagic Soft-und Hardware Gmbh")
+USB_VENDOR(0x086E, "System TALKS Inc.")
+USB_VENDOR(0x086F, "MEC IMEX INC/HPT")
+USB_VENDOR(0x0870, "Metricom")
+USB_VENDOR(0x0873, "Xpeed Inc.")
+USB_VENDOR(0x0879, "Comtrol Corporation")
+USB_VENDOR(0x087C, "ADESSO/Kbtek America Inc.")
+USB_VENDOR(0x087D, "JATON Corporation")
+USB_VENDOR(0x087E, "Fujitsu Computer Products of America")
+USB_VENDOR(0x0880, "APT Technologies Inc.")
+USB_VENDOR(0x0892, "DioGraphy Inc.")
+USB_VENDOR(0x089D, "Icron Systems Inc.")
+USB_VENDOR(0x089E, "NST Co., Ltd.")
+USB_VENDOR(0x08AE, "Mace Group, Inc.")
+USB_VENDOR(0x08B4, "Sorenson Vision, Inc.")
+USB_VENDOR(0x08B9, "Tandy Corporation/Radio Shack")
+USB_VENDOR(0x08BB, "Burr-Brown Japan, Ltd.")
+USB_VENDOR(0x08BD, "Citizen Watch Co., Ltd.")
+USB_VENDOR(0x08C4, "Proxim, Inc.")
+USB_VENDOR(0x08C7, "Key Nice Enterprise Co., Ltd.")
+USB_VENDOR(0x08C8, "2Wire, Inc")
+USB_VENDOR(0x08CA, "AIPTEK International Inc.")
+USB_VENDOR(0x08CE, "Long Well Electronics Corp.")
+USB_VENDOR(0x08D3, "Virtual Ink")
+USB_VENDOR(0x08DD, "Billionton Systems, Inc.")
+USB_VENDOR(0x08DF, "Spyrus Inc.")
+USB_VENDOR(0x08E4, "Pioneer Corporation")
+USB_VENDOR(0x08E5, "LITRONIC")
+USB_VENDOR(0x08E6, "GEMPLUS")
+USB_VENDOR(0x08E8, "Integrated Memory Logic")
+USB_VENDOR(0x08E9, "Extended Systems, Inc.")
+USB_VENDOR(0x08EA, "Ericsson Inc.")
+USB_VENDOR(0x08EE, "CCSI/HESSO")
+USB_VENDOR(0x08F0, "Corex Technologies")
+USB_VENDOR(0x08F1, "CTI Electronics Corporation")
+USB_VENDOR(0x08F5, "SYSTEC Co., Ltd.")
+USB_VENDOR(0x08F6, "Logic 3 International Limited")
+USB_VENDOR(0x08F8, "Keen Top International Enterprise Co., Ltd.")
+USB_VENDOR(0x08FA, "CAERE")
+USB_VENDOR(0x08FB, "Socket Communications")
+USB_VENDOR(0x08FC, "Sicon International")
+USB_VENDOR(0x08FD, "Digianswer A/S")
+USB_VENDOR(0x08FF, "AuthenTec, Inc.")
+USB_VENDOR(0x0901, "VST Technologies")
+USB_VENDOR(0x0906, "FARADAY Technology Corp.")
+USB_VENDOR(0x090A, "Trumpion Microelectronics Inc")
+USB_VENDOR(0x090B, "Neurosmith")
+USB_VENDOR(0x090C, "Feiya Technology Corporation")
+USB_VENDOR(0x090D, "MULTIPORT Computer Vertriebs GmbH")
+USB_VENDOR(0x090E, "Shining Technology, Inc.")
+USB_VENDOR(0x090F, "Fujitsu Devices Inc.")
+USB_VENDOR(0x0910, "Alation Systems, Inc.")
+USB_VENDOR(0x0911, "Philips Speech Processing")
+USB_VENDOR(0x0912, "Voquette, Inc.")
+USB_VENDOR(0x0915, "GlobeSpan, Inc.")
+USB_VENDOR(0x0917, "SmartDisk Corporation")
+USB_VENDOR(0x091E, "Garmin International")
+USB_VENDOR(0x0921, "GoHubs, inc.")
+USB_VENDOR(0x0922, "Dymo-CoStar Corporation")
+USB_VENDOR(0x0923, "IC Media Corporation")
+USB_VENDOR(0x0924, "Xerox")
+USB_VENDOR(0x0927, "Summus, Ltd.")
+USB_VENDOR(0x0928, "Oxford Semiconductor Ltd.")
+USB_VENDOR(0x0929, "American Biometric Company")
+USB_VENDOR(0x092B, "Sena Technologies, Inc.")
+USB_VENDOR(0x0930, "Toshiba Corporation")
+USB_VENDOR(0x0931, "Harmonic Data Systems Ltd.")
+USB_VENDOR(0x0932, "Crescentec Corporation")
+USB_VENDOR(0x0933, "Quantum Corp.")
+USB_VENDOR(0x0934, "Netcom Systems")
+USB_VENDOR(0x0939, "Lumberg, Inc.")
+USB_VENDOR(0x093A, "Pixart Imaging, Inc.")
+USB_VENDOR(0x093B, "Plextor")
+USB_VENDOR(0x093E, "J.S.T. Mfg. Co., Ltd.")
+USB_VENDOR(0x093F, "OLYMPIA Telecom Vertriebs GmbH")
+USB_VENDOR(0x0940, "Japan Storage Battery Co., Ltd.")
+USB_VENDOR(0x0941, "Photobit Corporation")
+USB_VENDOR(0x0942, "i2Go.com, LLC")
+USB_VENDOR(0x0943, "HCL Technologies India Private Limited")
+USB_VENDOR(0x0945, "PASCO Scientific")
+USB_VENDOR(0x094D, "Cable Television Laboratories")
+USB_VENDOR(0x0951, "Kingston Technology Company")
+USB_VENDOR(0x0954, "RPM Systems Corporation")
+USB_VENDOR(0x0955, "NVIDIA")
+USB_VENDOR(0x0956, "Bsquare")
+USB_VENDOR(0x0957, "Agilent Technologies, Inc.")
+USB_VENDOR(0x0958, "BioLink Technologies International, Inc.")
+USB_VENDOR(0x0959, "Cologne Chip AG")
+USB_VENDOR(0x095A, "Portsmith")
+USB_VENDOR(0x095B, "Medialogic Corporation")
+USB_VENDOR(0x095C, "K-Tec Electronics")
+USB_VENDOR(0x095D, "Polycom, Inc.")
+USB_VENDOR(0x0968, "Catalyst Enterprises, Inc.")
+USB_VENDOR(0x0971, "Gretag-Macbeth AG")
+USB_VENDOR(0x0973, "Schlumberger")
+USB_VENDOR(0x0974, "Eye Communication Systems, Inc")
+USB_VENDOR(0x0975, "OL'E Communications, Inc.")
+USB_VENDOR(0x0976, "Adirondack Wire & Cable")
+USB_VENDOR(0x0977, "Lightsurf Technologies")
+USB_VENDOR(0x0978, "Beckhoff Gmbh")
+USB_VENDOR(0x0979, "Jeilin Technology Corp., Ltd.")
+USB_VENDOR(0x097A, "Minds At Work LLC")
+USB_VENDOR(0x097B, "Knudsen Engineering Limited")
+USB_VENDOR(0x097C, "Marunix Co., Ltd.")
+USB_VENDOR(0x097D, "Rosun Technologies, Inc.")
+USB_VENDOR(0x097F, "Barun Electronics Co. Ltd.")
+USB_VENDOR(0x098C, "Vitana Corporation")
+USB_VENDOR(0x098D, "INDesign")
+USB_VENDOR(0x098E, "Integrated Intellectual Property Inc.")
+USB_VENDOR(0x098F, "Kenwood TMI Corporation")
+USB_VENDOR(0x0996, "Integrated Telecom Express, Inc.")
+USB_VENDOR(0x09A3, "PairGain Technologies")
+USB_VENDOR(0x09A4, "Contech Research, Inc.")
+USB_VENDOR(0x09A5, "VCON Telecommunications")
+USB_VENDOR(0x09A6, "Poinchips")
+USB_VENDOR(0x09A7, "Data Transmission Network Corp.")
+USB_VENDOR(0x09A8, "Shinestar Enterprise Co., Ltd.")
+USB_VENDOR(0x09A9, "Smart Card Technologies Co., Ltd.")
+USB_VENDOR(0x09AA, "Intersil Corporation")
+USB_VENDOR(0x09B3, "Altius Solutions, Inc.")
+USB_VENDOR(0x09B4, "MDS Telephone Systems")
+USB_VENDOR(0x09B5, "Celltrix Technology Co., Ltd.")
+USB_VENDOR(0x09C1, "Arris Interactive LLC")
+USB_VENDOR(0x09C2, "NISCA Corporation")
+USB_VENDOR(0x09C3, "ACTIVCARD, INC.")
+USB_VENDOR(0x09C4, "ACTiSYS Corporation")
+USB_VENDOR(0x09C5, "Memory Corporation")
+USB_VENDOR(0x09CC, "Workbit Corporation")
+USB_VENDOR(0x09CD, "Psion Connect Ltd.")
+USB_VENDOR(0x09CE, "City Electronics Ltd.")
+USB_VENDOR(0x09CF, "Electronics Testing Center, Taiwan")
+USB_VENDOR(0x09D1, "NeoMagic Inc.")
+USB_VENDOR(0x09D2, "Vreelin Engineering Inc.")
+USB_VENDOR(0x09D3, "COM ONE")
+USB_VENDOR(0x09D9, "Jungo")
+USB_VENDOR(0x09DA, "A-FOUR TECH CO., LTD.")
+USB_VENDOR(0x09DB, "ComputerBoards Inc.")
+USB_VENDOR(0x09DC, "AIMEX Corporation")
+USB_VENDOR(0x09DD, "Fellowes Manufacturing Co.")
+USB_VENDOR(0x09DF, "Addonics Technologies Corp.")
+USB_VENDOR(0x09E5, "Jo-Dan International, Inc.")
+USB_VENDOR(0x09E6, "Silutia, Inc.")
+USB_VENDOR(0x09E7, "Real 3D, Inc.")
+USB_VENDOR(0x09E8, "AKAI  professional M.I. Corp.")
+USB_VENDOR(0x09E9, "CHEN-SOURCE INC.")
+USB_VENDOR(0x09F5, "ARESCOM")
+USB_VENDOR(0x09F6, "RocketChips, Inc.")
+USB_VENDOR(0x09F7, "EDU-SCIENCE (H.K.) LIMITED")
+USB_VENDOR(0x09F8, "SoftConnex")
+USB_VENDOR(0x09F9, "Bay Associates")
+USB_VENDOR(0x09FA, "Mtek Vision")
+USB_VENDOR(0x09FB, "Altera")
+USB_VENDOR(0x09FF, "Gain Technology Corp.")
+USB_VENDOR(0x0A00, "Liquid Audio")
+USB_VENDOR(0x0A01, "ViA, Inc.")
+USB_VENDOR(0x0A0B, "Cybex Computer Products Corporation")
+USB_VENDOR(0x0A11, "Xentec Incorporated")
+USB_VENDOR(0x0A12, "Cambridge Silicon Radio Ltd.")
+USB_VENDOR(0x0A13, "Telebyte Inc.")
+USB_VENDOR(0x0A14, "Spacelabs Medical Inc.")
+USB_VENDOR(0x0A15, "Scalar Corporation")
+USB_VENDOR(0x0A16, "Trek Technology (S) Pte Ltd")
+USB_VENDOR(0x0A17, "Asahi Optical Co., Ltd.")
+USB_VENDOR(0x0A18, "Heidelberger Druckmaschinen AG")
+USB_VENDOR(0x0A19, "Hua Geng Technologies Inc.")
+USB_VENDOR(0x0A21, "Medtronic Physio Control Corp.")
+USB_VENDOR(0x0A22, "Century Semiconductor USA, Inc.")
+USB_VENDOR(0x0A23, "NDS Technologies Israel Ltd.")
+USB_VENDOR(0x0A39, "Gilat Satellite Networks Ltd.")
+USB_VENDOR(0x0A3A, "PentaMedia Co., Ltd.")
+USB_VENDOR(0x0A3C, "NTT DoCoMo,Inc.")
+USB_VENDOR(0x0A3D, "Varo Vision")
+USB_VENDOR(0x0A43, "Boca Systems Inc.")
+USB_VENDOR(0x0A44, "TurboLinux")
+USB_VENDOR(0x0A45, "Look&Say co., Ltd.")
+USB_VENDOR(0x0A46, "Davicom Semiconductor, Inc.")
+USB_VENDOR(0x0A47, "Hirose Electric")
+USB_VENDOR(0x0A48, "I/O Interconnect")
+USB_VENDOR(0x0A4B, "Fujitsu Media Devices Limited")
+USB_VENDOR(0x0A4C, "COMPUTEX Co., Ltd.")
+USB_VENDOR(0x0A4D, "Evolution Electronics Ltd.")
+USB_VENDOR(0x0A4E, "Steinberg Soft-und Hardware GmbH")
+USB_VENDOR(0x0A4F, "Litton Systems Inc.")
+USB_VENDOR(0x0A50, "Mimaki Engineering Co, Ltd.")
+USB_VENDOR(0x0A51, "Sony Electronics Inc.")
+USB_VENDOR(0x0A52, "JEBSEE ELECTRONICS CO., LTD.")
+USB_VENDOR(0x0A53, "Portable Peripheral Co., Ltd.")
+USB_VENDOR(0x0A5A, "Electronics For Imaging, Inc.")
+USB_VENDOR(0x0A5B, "EASICS NV")
+USB_VENDOR(0x0A5C, "Broadcom Corp.")
+USB_VENDOR(0x0A5D, "Diatrend Corporation")
+USB_VENDOR(0x0A5E, "Spinnaker Systems Inc.")
+USB_VENDOR(0x0A5F, "Eltron Card Printer Products")
+USB_VENDOR(0x0A65, "FullAudio, Inc.")
+USB_VENDOR(0x0A66, "ClearCube Technology")
+USB_VENDOR(0x0A67, "Medeli Electronics Co, Ltd.")
+USB_VENDOR(0x0A68, "COMAIDE Corporation")
+USB_VENDOR(0x0A69, "Chroma ate Inc.")
+USB_VENDOR(0x0A6A, "Newcom Inc.")
+USB_VENDOR(0x0A6B, "Green House Co., Ltd.")
+USB_VENDOR(0x0A6C, "Integrated Circuit Systems Inc.")
+USB_VENDOR(0x0A6D, "UPS Manufacturing")
+USB_VENDOR(0x0A6E, "Benwin")
+USB_VENDOR(0x0A6F, "Core Technology, Inc.")
+USB_VENDOR(0x0A70, "International Game Technology")
+USB_VENDOR(0x0A71, "VIPColor Technologies USA, Inc.")
+USB_VENDOR(0x0A72, "Sanwa Denshi")
+USB_VENDOR(0x0A7D, "NSTL, Inc.")
+USB_VENDOR(0x0A7E, "Octagon Systems Corporation")
+USB_VENDOR(0x0A7F, "AVerMedia MicroSystems")
+USB_VENDOR(0x0A80, "Rexon Technology Corp., Ltd")
+USB_VENDOR(0x0A81, "CHESEN ELECTRONICS CORP.")
+USB_VENDOR(0x0A82, "SYSCAN")
+USB_VENDOR(0x0A83, "NextComm, Inc.")
+USB_VENDOR(0x0A84, "Maui Innovative Peripherals")
+USB_VENDOR(0x0A85, "IDEXX LABS")
+USB_VENDOR(0x0A86, "NITGen Co., Ltd.")
+USB_VENDOR(0x0A8C, "Tecmar")
+USB_VENDOR(0x0A8D, "Picturetel")
+USB_VENDOR(0x0A8E, "Japan Aviation Electronics Industry Ltd. (JAE)")
+USB_VENDOR(0x0A8F, "Young Chang Co. Ltd.")
+USB_VENDOR(0x0A90, "Candy Technology Co., Ltd.")
+USB_VENDOR(0x0A91, "Globlink Technology Inc.")
+USB_VENDOR(0x0A92, "EGO SYStems Inc.")
+USB_VENDOR(0x0A93, "C Technologies AB (publ)")
+USB_VENDOR(0x0A94, "Intersense")
+USB_VENDOR(0x0AA3, "Lava Computer Mfg. Inc.")
+USB_VENDOR(0x0AA4, "Develco Elektronik")
+USB_VENDOR(0x0AA5, "First International Digital")
+USB_VENDOR(0x0AA6, "Perception Digital Limited")
+USB_VENDOR(0x0AA7, "Wincor Nixdorf GmbH &Co KG")
+USB_VENDOR(0x0AA8, "TriGem Computer, Inc.")
+USB_VENDOR(0x0AA9, "Baromtec Co.")
+USB_VENDOR(0x0AAA, "Japan CBM Corporation")
+USB_VENDOR(0x0AAB, "Vision Shape Europe SA.")
+USB_VENDOR(0x0AAC, "iCompression Inc.")
+USB_VENDOR(0x0AAD, "Rohde & Schwarz GmbH & Co. KG")
+USB_VENDOR(0x0AAE, "Nitsuko Corporation")
+USB_VENDOR(0x0AAF, "digitalway co., ltd.")
+USB_VENDOR(0x0AB0, "Arrow Strong Electronics CO. LTD")
+USB_VENDOR(0x0AC3, "SANYO Semiconductor Company Micro")
+USB_VENDOR(0x0AC4, "LECO CORPORATION")
+USB_VENDOR(0x0AC5, "I & C Corporation")
+USB_VENDOR(0x0AC6, "Singing Electrons, Inc.")
+USB_VENDOR(0x0AC7, "Panwest Corporation")
+USB_VENDOR(0x0ACC, "Koga Electronics Co.")
+USB_VENDOR(0x0ACD, "ID Tech")
+USB_VENDOR(0x0ACE, "ZyDAS Technology Corporation")
+USB_VENDOR(0x0ACF, "Intoto, Inc.")
+USB_VENDOR(0x0AD0, "Intellix Corp.")
+USB_VENDOR(0x0AD1, "Remotec Technology Ltd.")
+USB_VENDOR(0x0AD2, "Service & Quality Technology Co., Ltd.")
+USB_VENDOR(0x0AE3, "Allion Computer Inc.")
+USB_VENDOR(0x0AE4, "Taito Corporation")
+USB_VENDOR(0x0AE5, "MacroSystem Digital Video AG")
+USB_VENDOR(0x0AE6, "EVI, Inc.")
+USB_VENDOR(0x0AE7, "Neodym Systems Inc.")
+USB_VENDOR(0x0AE8, "System Support Co., Ltd.")
+USB_VENDOR(0x0AE9, "North Shore Circuit Design L.L.P.")
+USB_VENDOR(0x0AEA, "SciEssence, LLC")
+USB_VENDOR(0x0AEB, "TTP Communications Ltd.")
+USB_VENDOR(0x0AEC, "Neodio Technologies Corporation")
+USB_VENDOR(0x0AF6, "SILVER I CO., LTD.")
+USB_VENDOR(0x0AF7, "B2C2, Inc.")
+USB_VENDOR(0x0AFC, "Zaptronix Ltd")
+USB_VENDOR(0x0AFD, "Tateno Dennou, Inc.")
+USB_VENDOR(0x0AFE, "Cummins Engine Company")
+USB_VENDOR(0x0AFF, "Jump Zone Network Products, Inc.")
+USB_VENDOR(0x0B00, "INGENICO")
+USB_VENDOR(0x0B0E, "GN Netcom")
+USB_VENDOR(0x0B0F, "AVID Technology")
+USB_VENDOR(0x0B10, "Pcally")
+USB_VENDOR(0x0B11, "I Tech Solutions Co., Ltd.")
+USB_VENDOR(0x0B1E, "Electronic Warfare Assoc., Inc. (EWA)")
+USB_VENDOR(0x0B1F, "Insyde Software Corp.")
+USB_VENDOR(0x0B20, "TransDimension Inc.")
+USB_VENDOR(0x0B21, "Yokogawa Electric Corporation")
+USB_VENDOR(0x0B22, "Japan System Development Co. Ltd.")
+USB_VENDOR(0x0B23, "Pan-Asia Electronics Co., Ltd.")
+USB_VENDOR(0x0B24, "Link Evolution Corp.")
+USB_VENDOR(0x0B27, "Ritek Corporation")
+USB_VENDOR(0x0B28, "Kenwood Corporation")
+USB_VENDOR(0x0B2C, "Village Center, Inc.")
+USB_VENDOR(0x0B30, "NewHeights Software")
+USB_VENDOR(0x0B33, "Contour Design, Inc.")
+USB_VENDOR(0x0B37, "Hitachi ULSI Systems Co., Ltd.")
+USB_VENDOR(0x0B39, "Omnidirectional Control Technology Inc.")
+USB_VENDOR(0x0B3A, "IPaxess")
+USB_VENDOR(0x0B3B, "Bromax Communications, Inc.")
+USB_VENDOR(0x0B3C, "Olivetti Techcenter")
+USB_VENDOR(0x0B41, "Hal Corporation")
+USB_VENDOR(0x0B47, "Sportbug.com, Inc")
+USB_VENDOR(0x0B48, "TechnoTrend AG")
+USB_VENDOR(0x0B49, "ASCII Corporation")
+USB_VENDOR(0x0B4E, "Musical Electronics Ltd.")
+USB_VENDOR(0x0B50, "Dumpries Company Limited")
+USB_VENDOR(0x0B52, "Colorado MicroDisplay, Inc")
+USB_VENDOR(0x0B54, "Sinbon Electronics Co., Ltd.")
+USB_VENDOR(0x0B56, "TYI Systems Ltd.")
+USB_VENDOR(0x0B57, "Beijing HanwangTechnology Co. Ltd.")
+USB_VENDOR(0x0B59, "Lake Communications Ltd.")
+USB_VENDOR(0x0B5A, "Corel Corporation")
+USB_VENDOR(0x0B5F, "Green Electronics Co., Ltd.")
+USB_VENDOR(0x0B60, "Nsine Limited")
+USB_VENDOR(0x0B61, "NEC Viewtechnology, Ltd.")
+USB_VENDOR(0x0B62, "Orange Micro, Inc.")
+USB_VENDOR(0x0B63, "ADLink Technology Inc.")
+USB_VENDOR(0x0B64, "Wonderful Wire Cable Co., Ltd")
+USB_VENDOR(0x0B65, "Expert Magnetics Corp.")
+USB_VENDOR(0x0B69, "CasheVision")
+USB_VENDOR(0x0B6A, "Maxim Integrated Products")
+USB_VENDOR(0x0B6F, "Nagano Japan Radio Co., Ltd")
+USB_VENDOR(0x0B70, "PortalPlayer, Inc")
+USB_VENDOR(0x0B71, "SHIN-EI Sangyo Co., Ltd.")
+USB_VENDOR(0x0B72, "Embedded Wireless Technology Co. Ltd.")
+USB_VENDOR(0x0B73, "Computone Corp.")
+USB_VENDOR(0x0B79, "Sunrise Telecom, Inc.")
+USB_VENDOR(0x0B7A, "Telencomm")
+USB_VENDOR(0x0B7B, "Taiko Denki Co., Ltd.")
+USB_VENDOR(0x0B7C, "ITRAN Communications Ltd.")
+USB_VENDOR(0x0B7D, "Astrodesign, Inc.")
+USB_VENDOR(0x0B84, "Rextron Technology, Inc.")
+USB_VENDOR(0x0B85, "Elkat Electronics (M) SDN. BHD.")
+USB_VENDOR(0x0B86, "Exputer Systems, Inc.")
+USB_VENDOR(0x0B87, "Plus-One I & T Inc.")
+USB_VENDOR(0x0B88, "Sigma Koki Co., Ltd. Technology Center")
+USB_VENDOR(0x0B89, "Advanced Digital Broadcast Ltd.")
+USB_VENDOR(0x0B95, "ASIX Electronics Corp.")
+USB_VENDOR(0x0B96, "SEWON TELECOM")
+USB_VENDOR(0x0B97, "02 Micro, Inc.")
+USB_VENDOR(0x0B98, "Playmates Toys Inc.")
+USB_VENDOR(0x0B99, "Audio International, Inc.")
+USB_VENDOR(0x0B9D, "Softprotec Co.")
+USB_VENDOR(0x0B9F, "Chippo Technologies")
+USB_VENDOR(0x0BAF, "U.S. Robotics")
+USB_VENDOR(0x0BB0, "Concord Camera Corp.")
+USB_VENDOR(0x0BB1, "Infinilink Corporation")
+USB_VENDOR(0x0BB2, "Ambit Microsystems Corporation")
+USB_VENDOR(0x0BB3, "Ofuji Technology")
+USB_VENDOR(0x0BB4, "High Tech Computer, Corp. (HTC)")
+USB_VENDOR(0x0BB5, "Murata Manufacturing Co., Ltd.")
+USB_VENDOR(0x0BB6, "Network Alchemy")
+USB_VENDOR(0x0BB7, "Joytech Computer Company Limited")
+USB_VENDOR(0x0BB8, "Hitachi Semiconductor and Devices Sales Co., Ltd.")
+USB_VENDOR(0x0BB9, "Eiger M & C CO., LTD.")
+USB_VENDOR(0x0BBA, "ZACCESS Systems")
+USB_VENDOR(0x0BBB, "General Meters Corporation")
+USB_VENDOR(0x0BBC, "Assistive Technology, Inc.")
+USB_VENDOR(0x0BBD, "System Connection, Inc")
+USB_VENDOR(0x0BC0, "Knilink Technology Inc.")
+USB_VENDOR(0x0BC1, "FUW YNG ELECTRONICS COMPANY LTD")
+USB_VENDOR(0x0BC2, "Seagate RSS LLC")
+USB_VENDOR(0x0BC3, "IPWireless, Inc.")
+USB_VENDOR(0x0BC4, "Microcube Corp.")
+USB_VENDOR(0x0BC5, "JCN Co., Ltd.")
+USB_VENDOR(0x0BC6, "ExWAY Inc.")
+USB_VENDOR(0x0BC7, "X10 Wireless Technology, Inc.")
+USB_VENDOR(0x0BC8, "Telmax Communications")
+USB_VENDOR(0x0BC9, "ECI Telecom Ltd")
+USB_VENDOR(0x0BCA, "Startek Engineering Incorporated")
+USB_VENDOR(0x0BCB, "Perfect Technic Enterprise Co. LTD")
+USB_VENDOR(0x0BDA, "Realtek Semiconductor Corp.")
+USB_VENDOR(0x0BDB, "Ericsson Business Mobile Networks BV")
+USB_VENDOR(0x0BDC, "Y Media Corporation")
+USB_VENDOR(0x0BDD, "Orange PCS")
+USB_VENDOR(0x0BE2, "Kanda Tsushin Kogyo Co., LTD")
+USB_VENDOR(0x0BE3, "TOYO Corporation")
+USB_VENDOR(0x0BE4, "Elka Taiwan LTD")
+USB_VENDOR(0x0BE5, "DOME imaging systems, inc")
+USB_VENDOR(0x0BE6, "Dong Guan Humen Wonderful Wire Cable Factory")
+USB_VENDOR(0x0BEE, "LTK Industries Ltd.")
+USB_VENDOR(0x0BEF, "Way2Call Communications")
+USB_VENDOR(0x0BF0, "Pace Micro Technology PLC")
+USB_VENDOR(0x0BF1, "Intracom S.A.")
+USB_VENDOR(0x0BF2, "Konexx")
+USB_VENDOR(0x0BF7, "Sunny Giken inc.")
+USB_VENDOR(0x0BF8, "Fujitsu-Siemens-Computers")
+USB_VENDOR(0x0C04, "MOTO Development Group, Inc.")
+USB_VENDOR(0x0C05, "Appian Graphics")
+USB_VENDOR(0x0C06, "Hasbro Games Inc.")
+USB_VENDOR(0x0C07, "Infinite Data Storage LTD")
+USB_VENDOR(0x0C08, "ei Corporation")
+USB_VENDOR(0x0C09, "Comjet Information System")
+USB_VENDOR(0x0C0A, "Highpoint Technologies, Inc.")
+USB_VENDOR(0x0C0B, "Dura Micro, Inc.")
+USB_VENDOR(0x0C15, "Iris Graphics")
+USB_VENDOR(0x0C16, "Gyration, Inc.")
+USB_VENDOR(0x0C17, "Cyberboard A/S")
+USB_VENDOR(0x0C18, "SynerTek Korea, Inc.")
+USB_VENDOR(0x0C19, "cyberPIXIE, Inc.")
+USB_VENDOR(0x0C1A, "Silicon Motion, Inc.")
+USB_VENDOR(0x0C1B, "MIPS TECHNOLOGIES")
+USB_VENDOR(0x0C1C, "Hang Zhou Silan Electronics Co. Ltd")
+USB_VENDOR(0x0C22, "Tally Printer Corporation")
+USB_VENDOR(0x0C23, "Lernout + Hauspie (L + H)")
+USB_VENDOR(0x0C25, "SAMPO CORPORATION")
+USB_VENDOR(0x0C35, "Eagletron Inc.")
+USB_VENDOR(0x0C36, "E INK CORPORATION")
+USB_VENDOR(0x0C37, "e.Digital")
+USB_VENDOR(0x0C38, "Der An Electric Wire & Cable Co. Ltd.")
+USB_VENDOR(0x0C39, "IFR")
+USB_VENDOR(0x0C3A, "Furui Precise Component (Kunshan) Co., Ltd")
+USB_VENDOR(0x0C3B, "Komatsu Ltd.")
+USB_VENDOR(0x0C3C, "Radius Co., Ltd.")
+USB_VENDOR(0x0C3D, "Innocom, Inc.")
+USB_VENDOR(0x0C3E, "NEXTCELL INC.")
+USB_VENDOR(0x0C44, "Motorola iDEN")
+USB_VENDOR(0x0C45, "Sonix Technology Co., Ltd.")
+USB_VENDOR(0x0C52, "Sealevel Systems, Inc.")
+USB_VENDOR(0x0C53, "ViewPLUS Inc.")
+USB_VENDOR(0x0C54, "GLORY LTD.")
+USB_VENDOR(0x0C55, "Spectrum Digital Inc.")
+USB_VENDOR(0x0C56, "Billion Bright Limited")
+USB_VENDOR(0x0C57, "Imaginative Design Operation Co. Ltd.")
+USB_VENDOR(0x0C58, "Vidar Systems Corporation")
+USB_VENDOR(0x0C5A, "TRS International Mfg., Inc.")
+USB_VENDOR(0x10AC, "Honeywell, Inc.")
+USB_VENDOR(0x1190, "Tripace")
+USB_VENDOR(0x120E, "HUDSON SOFT CO., LTD.")
+USB_VENDOR(0x1568, "Sunf Pu Technology Co., Ltd")
+USB_VENDOR(0x1606, "UMAX Data Systems Inc.")
+USB_VENDOR(0x1608, "Inside Out Networks")
+USB_VENDOR(0x1668, "Actiontec Electronics, Inc.")
+USB_VENDOR(0x1696, "Hitachi Video and Information System, Inc.")
+USB_VENDOR(0x1EBB, "NuCORE Technology, Inc.")
+USB_VENDOR(0x22B8, "Motorola PCS")
+USB_VENDOR(0x22BA, "Technology Innovation International Co., Ltd.")
+USB_VENDOR(0x2304, "Pinnacle Systems, Inc.")
+USB_VENDOR(0x2899, "Toptronic Industrial Co., Ltd.")
+USB_VENDOR(0x3636, "INVIBRO")
+USB_VENDOR(0x3923, "National Instruments")
+USB_VENDOR(0x413C, "Dell Computer Corp.")
+USB_VENDOR(0x5543, "UC-Logic Technology Corp.")
+USB_VENDOR(0x55AA, "OnSpec Electronic Inc.")
+USB_VENDOR(0x636C, "CoreLogic, Inc.")
+USB_VENDOR(0x6A75, "Shanghai Jujo Electronics Co., Ltd.")
+USB_VENDOR(0x8086, "Intel Corporation")
@@ -0,0 +1,578 @@
+/*++
+
+Copyright (c) 1997-1998 Microsoft Corporation
+
+Module Name:
+
+    WORKPOOL.C
+
+Abstract:
+
+    This source file contains a small work-stealing thread pool used to
+    enumerate independent hubs at the same time.
+
+    Each worker thread owns a double ended queue of work items.  A worker
+    pushes the work it generates onto the bottom of its own queue and pops
+    from the bottom as well, so a subtree tends to stay on one thread.  A
+    worker whose queue is empty steals from the top of another worker's
+    queue, which hands out the oldest (and usually largest) pieces of work.
+
+    Work submitted from a thread which is not a pool worker is spread over
+    the worker queues round robin.
+
+    A pool created with no worker threads runs every work item inline from
+    WorkPoolSubmit(), which gives the original serial depth first order.
+
+    Work is submitted as part of a WORK_BATCH, which is waited on on its
+    own, so several enumerations may share the pool at the same time.
+
+Environment:
+
+    user mode
+
+Revision History:
+
+    10-16-26 : created
+
+--*/
+
+//*****************************************************************************
+// I N C L U D E S
+//*****************************************************************************
+
+#include <windows.h>
+#include <basetyps.h>
+#include <winioctl.h>
+#include <tchar.h>
+#include "usbview.h"
+
+//*****************************************************************************
+// D E F I N E S
+//*****************************************************************************
+
+#define WORKPOOL_MAX_WORKERS        32
+
+#define WORKQUEUE_INITIAL_SIZE      16
+
+//*****************************************************************************
+// T Y P E D E F S
+//*****************************************************************************
+
+typedef struct _WORKITEM
+{
+    PWORK_BATCH     Batch;
+    LPFNWORKROUTINE Routine;
+    PVOID           Context;
+} WORKITEM, *PWORKITEM;
+
+typedef struct _WORKQUEUE
+{
+    CRITICAL_SECTION    Lock;
+    PWORKITEM           Items;
+    ULONG               Size;       // capacity, always a power of two
+    ULONG               Top;        // next item to steal
+    ULONG               Bottom;     // next free slot
+} WORKQUEUE, *PWORKQUEUE;
+
+//*****************************************************************************
+// G L O B A L S    P R I V A T E    T O    T H I S    F I L E
+//*****************************************************************************
+
+WORKQUEUE   WorkQueues[WORKPOOL_MAX_WORKERS];
+HANDLE      WorkThreads[WORKPOOL_MAX_WORKERS];
+ULONG       NumWorkers;
+
+HANDLE      WorkAvailable;      // semaphore, released once per submit
+LONG        NextQueue;
+LONG        ShutDown;
+
+DWORD       WorkerTlsIndex = TLS_OUT_OF_INDEXES;
+
+
+//*****************************************************************************
+//
+// PushWork()
+//
+// Adds a work item at the bottom of a queue, growing it if needed.
+//
+//*****************************************************************************
+
+BOOL
+PushWork (
+    PWORKQUEUE  Queue,
+    PWORKITEM   Item
+)
+{
+    BOOL success;
+
+    success = TRUE;
+
+    EnterCriticalSection(&Queue->Lock);
+
+    if (Queue->Bottom - Queue->Top == Queue->Size)
+    {
+        PWORKITEM   newItems;
+        ULONG       i;
+
+        newItems = ALLOC(Queue->Size * 2 * sizeof(WORKITEM));
+
+        if (newItems != NULL)
+        {
+            for (i = Queue->Top; i != Queue->Bottom; i++)
+            {
+                newItems[i & (Queue->Size * 2 - 1)] =
+                    Queue->Items[i & (Queue->Size - 1)];
+            }
+
+            FREE(Queue->Items);
+
+            Queue->Items = newItems;
+            Queue->Size *= 2;
+        }
+        else
+        {
+            success = FALSE;
+        }
+    }
+
+    if (success)
+    {
+        Queue->Items[Queue->Bottom & (Queue->Size - 1)] = *Item;
+        Queue->Bottom++;
+    }
+
+    LeaveCriticalSection(&Queue->Lock);
+
+    return success;
+}
+
+//*****************************************************************************
+//
+// PopWork()
+//
+// Takes the newest work item from the bottom of the owner's queue.
+//
+//*****************************************************************************
+
+BOOL
+PopWork (
+    PWORKQUEUE  Queue,
+    PWORKITEM   Item
+)
+{
+    BOOL found;
+
+    found = FALSE;
+
+    EnterCriticalSection(&Queue->Lock);
+
+    if (Queue->Bottom != Queue->Top)
+    {
+        Queue->Bottom--;
+        *Item = Queue->Items[Queue->Bottom & (Queue->Size - 1)];
+        found = TRUE;
+    }
+
+    LeaveCriticalSection(&Queue->Lock);
+
+    return found;
+}
+
+//*****************************************************************************
+//
+// StealWork()
+//
+// Takes the oldest work item from the top of another worker's queue.
+//
+//*****************************************************************************
+
+BOOL
+StealWork (
+    PWORKQUEUE  Queue,
+    PWORKITEM   Item
+)
+{
+    BOOL found;
+
+    found = FALSE;
+
+    EnterCriticalSection(&Queue->Lock);
+
+    if (Queue->Bottom != Queue->Top)
+    {
+        *Item = Queue->Items[Queue->Top & (Queue->Size - 1)];
+        Queue->Top++;
+        found = TRUE;
+    }
+
+    LeaveCriticalSection(&Queue->Lock);
+
+    return found;
+}
+
+//*****************************************************************************
+//
+// FindWork()
+//
+// Worker - Index of the calling worker.  Its own queue is tried first,
+// then every other queue in turn.
+//
+//*****************************************************************************
+
+BOOL
+FindWork (
+    ULONG       Worker,
+    PWORKITEM   Item
+)
+{
+    ULONG i;
+
+    if (PopWork(&WorkQueues[Worker], Item))
+    {
+        return TRUE;
+    }
+
+    for (i = 1; i < NumWorkers; i++)
+    {
+        if (StealWork(&WorkQueues[(Worker + i) % NumWorkers], Item))
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+//*****************************************************************************
+//
+// RunWork()
+//
+//*****************************************************************************
+
+VOID
+RunWork (
+    PWORKITEM Item
+)
+{
+    (*Item->Routine)(Item->Context);
+
+    if (InterlockedDecrement(&Item->Batch->Outstanding) == 0)
+    {
+        SetEvent(Item->Batch->Done);
+    }
+}
+
+//*****************************************************************************
+//
+// WorkerThread()
+//
+//*****************************************************************************
+
+DWORD WINAPI
+WorkerThread (
+    LPVOID Parameter
+)
+{
+    ULONG       worker;
+    WORKITEM    item;
+
+    worker = (ULONG)(ULONG_PTR)Parameter;
+
+    TlsSetValue(WorkerTlsIndex, (LPVOID)(ULONG_PTR)(worker + 1));
+
+    for (;;)
+    {
+        if (FindWork(worker, &item))
+        {
+            RunWork(&item);
+            continue;
+        }
+
+        WaitForSingleObject(WorkAvailable, INFINITE);
+
+        if (ShutDown)
+        {
+            break;
+        }
+    }
+
+    return 0;
+}
+
+//*****************************************************************************
+//
+// WorkPoolCreate()
+//
+// Workers - Number of worker threads.  Zero makes WorkPoolSubmit() run each
+// work item inline on the calling thread.
+//
+//*****************************************************************************
+
+BOOL
+WorkPoolCreate (
+    ULONG Workers
+)
+{
+    ULONG i;
+
+    if (Workers > WORKPOOL_MAX_WORKERS)
+    {
+        Workers = WORKPOOL_MAX_WORKERS;
+    }
+
+    NumWorkers  = 0;
+    NextQueue   = 0;
+    ShutDown    = FALSE;
+
+    if (Workers == 0)
+    {
+        return TRUE;
+    }
+
+    WorkerTlsIndex = TlsAlloc();
+
+    WorkAvailable = CreateSemaphore(NULL, 0, MAXLONG, NULL);
+
+    if (WorkerTlsIndex == TLS_OUT_OF_INDEXES ||
+        WorkAvailable == NULL)
+    {
+        OOPS();
+        goto WorkPoolCreateError;
+    }
+
+    for (i = 0; i < Workers; i++)
+    {
+        WorkQueues[i].Items = ALLOC(WORKQUEUE_INITIAL_SIZE * sizeof(WORKITEM));
+
+        if (WorkQueues[i].Items == NULL)
+        {
+            OOPS();
+            break;
+        }
+
+        WorkQueues[i].Size   = WORKQUEUE_INITIAL_SIZE;
+        WorkQueues[i].Top    = 0;
+        WorkQueues[i].Bottom = 0;
+
+        InitializeCriticalSection(&WorkQueues[i].Lock);
+
+        WorkThreads[i] = CreateThread(NULL,
+                                      0,
+                                      WorkerThread,
+                                      (LPVOID)(ULONG_PTR)i,
+                                      CREATE_SUSPENDED,
+                                      NULL);
+
+        if (WorkThreads[i] == NULL)
+        {
+            OOPS();
+            DeleteCriticalSection(&WorkQueues[i].Lock);
+            FREE(WorkQueues[i].Items);
+            break;
+        }
+
+        NumWorkers++;
+    }
+
+    // NumWorkers must be final before any worker starts looking at other
+    // workers' queues.
+    //
+    for (i = 0; i < NumWorkers; i++)
+    {
+        ResumeThread(WorkThreads[i]);
+    }
+
+    if (NumWorkers != 0)
+    {
+        return TRUE;
+    }
+
+WorkPoolCreateError:
+
+    WorkPoolDestroy();
+
+    return FALSE;
+}
+
+//*****************************************************************************
+//
+// WorkPoolDestroy()
+//
+// Must only be called while no batch is outstanding.
+//
+//*****************************************************************************
+
+VOID
+WorkPoolDestroy (
+    VOID
+)
+{
+    ULONG i;
+
+    if (NumWorkers != 0)
+    {
+        InterlockedExchange(&ShutDown, TRUE);
+
+        ReleaseSemaphore(WorkAvailable, NumWorkers, NULL);
+
+        WaitForMultipleObjects(NumWorkers, WorkThreads, TRUE, INFINITE);
+
+        for (i = 0; i < NumWorkers; i++)
+        {
+            CloseHandle(WorkThreads[i]);
+            DeleteCriticalSection(&WorkQueues[i].Lock);
+            FREE(WorkQueues[i].Items);
+            WorkQueues[i].Items = NULL;
+        }
+
+        NumWorkers = 0;
+    }
+
+    if (WorkAvailable != NULL)
+    {
+        CloseHandle(WorkAvailable);
+        WorkAvailable = NULL;
+    }
+
+    if (WorkerTlsIndex != TLS_OUT_OF_INDEXES)
+    {
+        TlsFree(WorkerTlsIndex);
+        WorkerTlsIndex = TLS_OUT_OF_INDEXES;
+    }
+}
+
+//*****************************************************************************
+//
+// WorkPoolBegin()
+//
+// Starts a batch of work.  Every WorkPoolBegin() must be matched by a
+// WorkPoolWait() of the same Batch from the same thread.  A batch which
+// can not get an event runs its work items inline.
+//
+//*****************************************************************************
+
+VOID
+WorkPoolBegin (
+    PWORK_BATCH Batch
+)
+{
+    Batch->Done = NULL;
+
+    // The batch itself holds one reference so the done event can not be
+    // signalled while the first work items are still being submitted.
+    //
+    Batch->Outstanding = 1;
+
+    if (NumWorkers == 0)
+    {
+        return;
+    }
+
+    Batch->Done = CreateEvent(NULL, TRUE, FALSE, NULL);
+
+    if (Batch->Done == NULL)
+    {
+        OOPS();
+    }
+}
+
+//*****************************************************************************
+//
+// WorkPoolSubmit()
+//
+// Batch - Batch started by WorkPoolBegin() the work item is part of.
+//
+// Routine - Called with Context on some pool thread.  Work items may submit
+// further work items to the same batch.
+//
+//*****************************************************************************
+
+VOID
+WorkPoolSubmit (
+    PWORK_BATCH     Batch,
+    LPFNWORKROUTINE Routine,
+    PVOID           Context
+)
+{
+    WORKITEM    item;
+    ULONG       queue;
+
+    if (Batch->Done == NULL)
+    {
+        (*Routine)(Context);
+        return;
+    }
+
+    item.Batch   = Batch;
+    item.Routine = Routine;
+    item.Context = Context;
+
+    queue = (ULONG)(ULONG_PTR)TlsGetValue(WorkerTlsIndex);
+
+    if (queue != 0)
+    {
+        queue--;
+    }
+    else
+    {
+        queue = (ULONG)InterlockedIncrement(&NextQueue) % NumWorkers;
+    }
+
+    InterlockedIncrement(&Batch->Outstanding);
+
+    if (!PushWork(&WorkQueues[queue], &item))
+    {
+        // Out of memory growing the queue, just do the work here
+        //
+        OOPS();
+        RunWork(&item);
+        return;
+    }
+
+    ReleaseSemaphore(WorkAvailable, 1, NULL);
+}
+
+//*****************************************************************************
+//
+// WorkPoolWait()
+//
+// Waits until every work item submitted to Batch, including work those
+// items submitted themselves, has completed.  Work of other batches is
+// not waited for.
+//
+//*****************************************************************************
+
+VOID
+WorkPoolWait (
+    PWORK_BATCH Batch
+)
+{
+    if (Batch->Done == NULL)
+    {
+        return;
+    }
+
+    if (InterlockedDecrement(&Batch->Outstanding) != 0)
+    {
+        WaitForSingleObject(Batch->Done, INFINITE);
+    }
+
+    CloseHandle(Batch->Done);
+    Batch->Done = NULL;
+}
+
+//*****************************************************************************
+//
+// WorkPoolWorkers()
+//
+// Returns the number of worker threads, zero for the inline pool.
+//
+//*****************************************************************************
+
+ULONG
+WorkPoolWorkers (
+    VOID
+)
+{
+    return NumWorkers;
+}